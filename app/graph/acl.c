@@ -0,0 +1,143 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmdline_parse.h>
+#include <cmdline_parse_num.h>
+#include <cmdline_parse_string.h>
+#include <cmdline_socket.h>
+#include <rte_byteorder.h>
+#include <rte_node_acl_api.h>
+#include <rte_node_pkt_cls_api.h>
+
+#include "acl_priv.h"
+#include "module_api.h"
+
+static const char
+cmd_ipv4_acl_help[] = "ipv4_acl rule add proto <proto> src <ip> <depth> dst <ip> <depth> "
+		      "sport <lo> <hi> dport <lo> <hi> action <permit/deny>";
+
+static struct acl_ipv4_rules acl4;
+
+/*
+ * Send the IPv4 packets through the ip4_acl node when rules are configured,
+ * before creating the graphs.
+ */
+int
+acl_ip4_setup(void)
+{
+	const char *next_node;
+	rte_node_t id;
+	int rc;
+
+	if (acl4.nb_rules == 0)
+		return 0;
+
+	/* Permitted packets go to the lookup node selected for IPv4 */
+	next_node = route_ip4_lookup_node_get();
+	id = rte_node_from_name("ip4_acl");
+	if (id == RTE_NODE_ID_INVALID ||
+	    rte_node_edge_update(id, RTE_NODE_IP4_ACL_NEXT_PERMIT, &next_node, 1) ==
+			RTE_EDGE_ID_INVALID)
+		return -EINVAL;
+
+	next_node = "ip4_acl";
+	id = rte_node_from_name("pkt_cls");
+	if (id == RTE_NODE_ID_INVALID ||
+	    rte_node_edge_update(id, RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP, &next_node, 1) ==
+			RTE_EDGE_ID_INVALID)
+		return -EINVAL;
+
+	rc = rte_node_ip4_acl_rules_set(acl4.rule, acl4.nb_rules,
+					RTE_NODE_IP4_ACL_NEXT_PERMIT, NULL);
+	if (rc < 0)
+		return rc;
+
+	acl4.enabled = true;
+	return 0;
+}
+
+static int
+acl_ip4_rule_add(const struct rte_node_ip4_acl_rule *rule)
+{
+	int rc;
+
+	if (acl4.nb_rules == MAX_ACL_RULES)
+		return -ENOSPC;
+
+	/* ip4_acl node is only inserted in the graphs created with rules */
+	if (graph_status_get() && !acl4.enabled)
+		return -ENOTSUP;
+
+	acl4.rule[acl4.nb_rules++] = *rule;
+	if (!graph_status_get())
+		return 0;
+
+	/* Rebuild and swap the rules while the workers are running */
+	rc = rte_node_ip4_acl_rules_set(acl4.rule, acl4.nb_rules,
+					RTE_NODE_IP4_ACL_NEXT_PERMIT, graph_rcu_qsbr_get());
+	if (rc < 0)
+		acl4.nb_rules--;
+
+	return rc;
+}
+
+void
+cmd_help_ipv4_acl_parsed(__rte_unused void *parsed_result, __rte_unused struct cmdline *cl,
+			 __rte_unused void *data)
+{
+	size_t len;
+
+	len = strlen(conn->msg_out);
+	conn->msg_out += len;
+	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n",
+		 "--------------------------- ipv4_acl command help ---------------------------",
+		 cmd_ipv4_acl_help);
+
+	len = strlen(conn->msg_out);
+	conn->msg_out_len_max -= len;
+}
+
+void
+cmd_ipv4_acl_rule_add_proto_parsed(void *parsed_result, __rte_unused struct cmdline *cl,
+				   void *data __rte_unused)
+{
+	struct cmd_ipv4_acl_rule_add_proto_result *res = parsed_result;
+	struct rte_node_ip4_acl_rule rule;
+	struct rte_acl_field *f = rule.field;
+
+	if (res->src_depth > 32 || res->dst_depth > 32) {
+		printf(MSG_ARG_INVALID, "depth");
+		return;
+	}
+
+	if (res->sport_lo > res->sport_hi || res->dport_lo > res->dport_hi) {
+		printf(MSG_ARG_INVALID, "port range");
+		return;
+	}
+
+	memset(&rule, 0, sizeof(rule));
+	rule.data.category_mask = 1;
+	/* First configured rule has the highest priority */
+	rule.data.priority = RTE_ACL_MAX_PRIORITY - acl4.nb_rules;
+	rule.data.userdata = RTE_NODE_ACL_USERDATA(strcmp(res->verdict, "permit") == 0 ?
+			RTE_NODE_IP4_ACL_NEXT_PERMIT : RTE_NODE_IP4_ACL_NEXT_DENY);
+
+	/* Protocol 0 matches any protocol */
+	f[RTE_NODE_IP4_ACL_FIELD_PROTO].value.u8 = res->proto_id;
+	f[RTE_NODE_IP4_ACL_FIELD_PROTO].mask_range.u8 = res->proto_id ? UINT8_MAX : 0;
+	f[RTE_NODE_IP4_ACL_FIELD_SRC].value.u32 = rte_be_to_cpu_32(res->src_ip.addr.ipv4.s_addr);
+	f[RTE_NODE_IP4_ACL_FIELD_SRC].mask_range.u32 = res->src_depth;
+	f[RTE_NODE_IP4_ACL_FIELD_DST].value.u32 = rte_be_to_cpu_32(res->dst_ip.addr.ipv4.s_addr);
+	f[RTE_NODE_IP4_ACL_FIELD_DST].mask_range.u32 = res->dst_depth;
+	f[RTE_NODE_IP4_ACL_FIELD_SRC_PORT].value.u16 = res->sport_lo;
+	f[RTE_NODE_IP4_ACL_FIELD_SRC_PORT].mask_range.u16 = res->sport_hi;
+	f[RTE_NODE_IP4_ACL_FIELD_DST_PORT].value.u16 = res->dport_lo;
+	f[RTE_NODE_IP4_ACL_FIELD_DST_PORT].mask_range.u16 = res->dport_hi;
+
+	if (acl_ip4_rule_add(&rule) < 0)
+		printf(MSG_CMD_FAIL, res->ipv4_acl);
+}
@@ -0,0 +1,8 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef APP_GRAPH_ACL_H
+#define APP_GRAPH_ACL_H
+
+int acl_ip4_setup(void);
+
+#endif
@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef APP_GRAPH_ACL_PRIV_H
+#define APP_GRAPH_ACL_PRIV_H
+
+#include <rte_node_acl_api.h>
+
+#define MAX_ACL_RULES 1024
+
+struct acl_ipv4_rules {
+	struct rte_node_ip4_acl_rule rule[MAX_ACL_RULES];
+	uint32_t nb_rules;
+	/* ip4_acl node inserted in the graphs */
+	bool enabled;
+};
+
+#endif
@@ -0,0 +1,227 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmdline_parse.h>
+#include <cmdline_parse_num.h>
+#include <cmdline_parse_string.h>
+#include <cmdline_socket.h>
+#include <rte_ethdev.h>
+#include <rte_graph_feature_arc.h>
+#include <rte_string_fns.h>
+
+#include "feature_priv.h"
+#include "module_api.h"
+
+static const char
+cmd_feature_enable_help[] = "feature enable <arc> <node> port <ethdev_name> [data <value>]";
+
+static const char
+cmd_feature_disable_help[] = "feature disable <arc> <node> port <ethdev_name>";
+
+static struct feature_head features = TAILQ_HEAD_INITIALIZER(features);
+static uint16_t nb_features;
+
+static struct feature_config *
+feature_config_find(const char *arc, const char *node, uint16_t port_id)
+{
+	struct feature_config *f;
+
+	TAILQ_FOREACH(f, &features, next) {
+		if (!strcmp(f->arc, arc) && !strcmp(f->node, node) &&
+		    f->port_id == port_id)
+			return f;
+	}
+
+	return NULL;
+}
+
+/* Get the distinct feature nodes, to add them to the graphs */
+uint16_t
+feature_nodes_get(const char **names)
+{
+	struct feature_config *f, *prev;
+	uint16_t count = 0;
+
+	TAILQ_FOREACH(f, &features, next) {
+		TAILQ_FOREACH(prev, &features, next) {
+			if (prev == f || !strcmp(prev->node, f->node))
+				break;
+		}
+		if (prev != f)
+			continue;
+		if (names != NULL)
+			names[count] = f->node;
+		count++;
+	}
+
+	return count;
+}
+
+/* Add the features to their arcs, before creating the graphs */
+int
+feature_add_to_arcs(void)
+{
+	struct rte_graph_feature_arc *arc;
+	struct feature_config *f;
+	int rc;
+
+	TAILQ_FOREACH(f, &features, next) {
+		arc = rte_graph_feature_arc_lookup(f->arc);
+		if (arc == NULL)
+			return -ENOENT;
+
+		rc = rte_graph_feature_add(arc, f->node);
+		if (rc < 0 && rc != -EEXIST)
+			return rc;
+	}
+
+	return 0;
+}
+
+/* Enable the configured features, once the graphs are created */
+int
+feature_enable_on_arcs(void)
+{
+	struct feature_config *f;
+	int rc;
+
+	TAILQ_FOREACH(f, &features, next) {
+		rc = rte_graph_feature_enable(rte_graph_feature_arc_lookup(f->arc),
+				f->port_id, f->node, f->data, graph_rcu_qsbr_get());
+		if (rc < 0)
+			return rc;
+	}
+
+	return 0;
+}
+
+static int
+feature_enable(const char *arc, const char *node, uint16_t port_id, uint32_t data)
+{
+	struct feature_config *f;
+	int rc;
+
+	f = feature_config_find(arc, node, port_id);
+	if (f == NULL && nb_features == MAX_FEATURE_ENTRIES)
+		return -ENOSPC;
+
+	/* Features are added to the arcs when starting the graphs */
+	if (graph_status_get()) {
+		rc = rte_graph_feature_enable(rte_graph_feature_arc_lookup(arc),
+				port_id, node, data, graph_rcu_qsbr_get());
+		if (rc < 0)
+			return rc;
+	}
+
+	/* Enabling an enabled feature updates its data */
+	if (f != NULL) {
+		f->data = data;
+		return 0;
+	}
+
+	f = calloc(1, sizeof(*f));
+	if (f == NULL)
+		return -ENOMEM;
+
+	rte_strscpy(f->arc, arc, sizeof(f->arc));
+	rte_strscpy(f->node, node, sizeof(f->node));
+	f->port_id = port_id;
+	f->data = data;
+	TAILQ_INSERT_TAIL(&features, f, next);
+	nb_features++;
+
+	return 0;
+}
+
+static int
+feature_disable(const char *arc, const char *node, uint16_t port_id)
+{
+	struct feature_config *f;
+	int rc;
+
+	f = feature_config_find(arc, node, port_id);
+	if (f == NULL)
+		return -ENOENT;
+
+	if (graph_status_get()) {
+		rc = rte_graph_feature_disable(rte_graph_feature_arc_lookup(arc),
+				port_id, node, graph_rcu_qsbr_get());
+		if (rc < 0)
+			return rc;
+	}
+
+	TAILQ_REMOVE(&features, f, next);
+	free(f);
+	nb_features--;
+
+	return 0;
+}
+
+void
+cmd_help_feature_parsed(__rte_unused void *parsed_result, __rte_unused struct cmdline *cl,
+			__rte_unused void *data)
+{
+	size_t len;
+
+	len = strlen(conn->msg_out);
+	conn->msg_out += len;
+	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n%s\n",
+		 "--------------------------- feature command help ---------------------------",
+		 cmd_feature_enable_help, cmd_feature_disable_help);
+
+	len = strlen(conn->msg_out);
+	conn->msg_out_len_max -= len;
+}
+
+void
+cmd_feature_enable_parsed(void *parsed_result, __rte_unused struct cmdline *cl,
+			  void *data __rte_unused)
+{
+	struct cmd_feature_enable_result *res = parsed_result;
+	uint16_t port_id;
+
+	if (rte_eth_dev_get_port_by_name(res->dev, &port_id)) {
+		printf(MSG_ARG_INVALID, "port");
+		return;
+	}
+
+	if (feature_enable(res->arc, res->node, port_id, 0) < 0)
+		printf(MSG_CMD_FAIL, res->feature);
+}
+
+void
+cmd_feature_enable_arc_node_port_dev_data_parsed(void *parsed_result,
+						 __rte_unused struct cmdline *cl,
+						 void *data __rte_unused)
+{
+	struct cmd_feature_enable_arc_node_port_dev_data_result *res = parsed_result;
+	uint16_t port_id;
+
+	if (rte_eth_dev_get_port_by_name(res->dev, &port_id)) {
+		printf(MSG_ARG_INVALID, "port");
+		return;
+	}
+
+	if (feature_enable(res->arc, res->node, port_id, res->value) < 0)
+		printf(MSG_CMD_FAIL, res->feature);
+}
+
+void
+cmd_feature_disable_parsed(void *parsed_result, __rte_unused struct cmdline *cl,
+			   void *data __rte_unused)
+{
+	struct cmd_feature_disable_result *res = parsed_result;
+	uint16_t port_id;
+
+	if (rte_eth_dev_get_port_by_name(res->dev, &port_id)) {
+		printf(MSG_ARG_INVALID, "port");
+		return;
+	}
+
+	if (feature_disable(res->arc, res->node, port_id) < 0)
+		printf(MSG_CMD_FAIL, res->feature);
+}
@@ -0,0 +1,12 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef APP_GRAPH_FEATURE_H
+#define APP_GRAPH_FEATURE_H
+
+#include <stdint.h>
+
+uint16_t feature_nodes_get(const char **names);
+int feature_add_to_arcs(void);
+int feature_enable_on_arcs(void);
+
+#endif
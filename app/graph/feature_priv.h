@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef APP_GRAPH_FEATURE_PRIV_H
+#define APP_GRAPH_FEATURE_PRIV_H
+
+#include <sys/queue.h>
+
+#include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
+
+#define MAX_FEATURE_ENTRIES 32
+
+struct feature_config {
+	TAILQ_ENTRY(feature_config) next;
+	char arc[RTE_GRAPH_FEATURE_ARC_NAMELEN];
+	char node[RTE_NODE_NAMESIZE];
+	uint16_t port_id;
+	uint32_t data; /* Given to the feature node for this port */
+};
+
+TAILQ_HEAD(feature_head, feature_config);
+
+#endif
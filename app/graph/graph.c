@@ -13,6 +13,8 @@
 #include <rte_ethdev.h>
 #include <rte_graph_worker.h>
 #include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 
 #include "graph_priv.h"
 #include "module_api.h"
@@ -27,6 +29,8 @@ cmd_graph_help[] = "graph <usecases> coremask <bitmask> bsz <size> tmo <ns> "
 static const char * const supported_usecases[] = {"l3fwd", "l2fwd"};
 struct graph_config graph_config;
 bool graph_started;
+/* Workers report a quiescent state after each graph walk */
+static struct rte_rcu_qsbr *graph_qsbr;
 
 /* Check the link rc of all ports in up to 9s, and print them finally */
 static void
@@ -251,12 +255,107 @@ cmd_graph_stats_show_parsed(__rte_unused void *parsed_result, __rte_unused struc
 	graph_stats_print_to_file();
 }
 
+static void
+graph_histogram_print(const char *name, const uint64_t *hist)
+{
+	char bucket[16];
+	size_t len;
+	int i;
+
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+		if (hist[i] == 0)
+			continue;
+
+		/* Bucket i counts the values in [2^(i-1), 2^i - 1] */
+		if (i == 0)
+			snprintf(bucket, sizeof(bucket), "0");
+		else if (i == RTE_GRAPH_HIST_BUCKETS - 1)
+			snprintf(bucket, sizeof(bucket), ">= 2^%d", i - 1);
+		else
+			snprintf(bucket, sizeof(bucket), "< 2^%d", i);
+
+		len = strlen(conn->msg_out);
+		conn->msg_out += len;
+		conn->msg_out_len_max -= len;
+		snprintf(conn->msg_out, conn->msg_out_len_max, "%-16s %-12s %20"PRIu64"\n",
+			 name, bucket, hist[i]);
+	}
+}
+
+void
+cmd_graph_histogram_show_parsed(__rte_unused void *parsed_result, __rte_unused struct cmdline *cl,
+		__rte_unused void *data)
+{
+	uint64_t walk_hist[RTE_GRAPH_HIST_BUCKETS];
+	struct rte_node_histogram hist;
+	struct rte_graph *graph;
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+	rte_graph_t id;
+	size_t len;
+	char *name;
+
+	if (!rte_graph_has_histogram_feature()) {
+		printf("Graph histograms are disabled, enable RTE_LIBRTE_GRAPH_HISTOGRAM\n");
+		return;
+	}
+
+	for (id = 0; id < rte_graph_max_count(); id++) {
+		name = rte_graph_id_to_name(id);
+		graph = name != NULL ? rte_graph_lookup(name) : NULL;
+		if (graph == NULL || rte_graph_walk_histogram_get(id, walk_hist) < 0)
+			continue;
+
+		len = strlen(conn->msg_out);
+		conn->msg_out += len;
+		conn->msg_out_len_max -= len;
+		snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%-16s %-12s %20s\n",
+			 name, "|Histogram", "|Bucket", "|Count");
+		graph_histogram_print("walk cycles", walk_hist);
+
+		rte_graph_foreach_node(count, off, graph, node) {
+			if (rte_graph_node_histogram_get(id, node->id, &hist) < 0)
+				continue;
+
+			len = strlen(conn->msg_out);
+			conn->msg_out += len;
+			conn->msg_out_len_max -= len;
+			snprintf(conn->msg_out, conn->msg_out_len_max, "%s\n", node->name);
+			graph_histogram_print("objs", hist.objs);
+			graph_histogram_print("cycles", hist.cycles);
+		}
+	}
+}
+
 bool
 graph_status_get(void)
 {
 	return graph_started;
 }
 
+struct rte_rcu_qsbr *
+graph_rcu_qsbr_get(void)
+{
+	return graph_qsbr;
+}
+
+static int
+graph_rcu_qsbr_create(void)
+{
+	size_t sz;
+
+	if (graph_qsbr != NULL)
+		return 0;
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	graph_qsbr = rte_zmalloc("graph_qsbr", sz, RTE_CACHE_LINE_SIZE);
+	if (graph_qsbr == NULL)
+		return -ENOMEM;
+
+	return rte_rcu_qsbr_init(graph_qsbr, RTE_MAX_LCORE);
+}
+
 void
 cmd_graph_start_parsed(__rte_unused void *parsed_result, __rte_unused struct cmdline *cl,
 		__rte_unused void *data)
@@ -265,6 +364,11 @@ cmd_graph_start_parsed(__rte_unused void *parsed_result, __rte_unused struct cmd
 	uint32_t nb_graphs = 0, nb_conf, i;
 	int rc = -EINVAL;
 
+	if (graph_rcu_qsbr_create()) {
+		printf(MSG_OUT_OF_MEMORY);
+		return;
+	}
+
 	conf = graph_rxtx_node_config_get(&nb_conf, &nb_graphs);
 	for (i = 0; i < MAX_GRAPH_USECASES; i++) {
 		if (!strcmp(graph_config.usecases[i].name, "l3fwd")) {
@@ -350,8 +454,16 @@ graph_walk_start(void *conf)
 	RTE_LOG(INFO, APP_GRAPH, "Entering main loop on lcore %u, graph %s(%p)\n", lcore_id,
 		qconf->name, graph);
 
-	while (likely(!force_quit))
+	rte_rcu_qsbr_thread_register(graph_qsbr, lcore_id);
+	rte_rcu_qsbr_thread_online(graph_qsbr, lcore_id);
+
+	while (likely(!force_quit)) {
 		rte_graph_walk(graph);
+		rte_rcu_qsbr_quiescent(graph_qsbr, lcore_id);
+	}
+
+	rte_rcu_qsbr_thread_offline(graph_qsbr, lcore_id);
+	rte_rcu_qsbr_thread_unregister(graph_qsbr, lcore_id);
 
 	return 0;
 }
@@ -438,9 +550,9 @@ cmd_help_graph_parsed(__rte_unused void *parsed_result, __rte_unused struct cmdl
 
 	len = strlen(conn->msg_out);
 	conn->msg_out += len;
-	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n%s\n%s\n",
+	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n%s\n%s\n%s\n",
 		 "----------------------------- graph command help -----------------------------",
-		 cmd_graph_help, "graph start", "graph stats show");
+		 cmd_graph_help, "graph start", "graph stats show", "graph histogram show");
 
 	len = strlen(conn->msg_out);
 	conn->msg_out_len_max -= len;
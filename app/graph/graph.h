@@ -6,11 +6,13 @@
 #define APP_GRAPH_H
 
 #include <cmdline_parse.h>
+#include <rte_rcu_qsbr.h>
 
 int graph_walk_start(void *conf);
 void graph_stats_print(void);
 void graph_pcap_config_get(uint8_t *pcap_ena, uint64_t *num_pkts, char **file);
 uint64_t graph_coremask_get(void);
 bool graph_status_get(void);
+struct rte_rcu_qsbr *graph_rcu_qsbr_get(void);
 
 #endif
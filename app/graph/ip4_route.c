@@ -10,7 +10,9 @@
 #include <cmdline_parse_num.h>
 #include <cmdline_parse_string.h>
 #include <cmdline_socket.h>
+#include <rte_lcore.h>
 #include <rte_node_ip4_api.h>
+#include <rte_node_pkt_cls_api.h>
 
 #include "module_api.h"
 #include "route_priv.h"
@@ -18,8 +20,13 @@
 static const char
 cmd_ipv4_lookup_help[] = "ipv4_lookup route add ipv4 <ip> netmask <mask> via <ip>";
 
+static const char
+cmd_ipv4_lookup_mode_help[] = "ipv4_lookup mode <lpm/fib>";
+
 struct ip4_route route4 = TAILQ_HEAD_INITIALIZER(route4);
 
+static enum route_lookup_mode ip4_lookup_mode = ROUTE_LOOKUP_LPM;
+
 void
 route_ip4_list_clean(void)
 {
@@ -71,6 +78,10 @@ route4_rewirte_table_update(struct route_ipv4_config *ipv4route)
 
 	depth = convert_netmask_to_depth(ipv4route->netmask);
 
+	if (ip4_lookup_mode == ROUTE_LOOKUP_FIB)
+		return rte_node_ip4_fib_route_add(ipv4route->ip, depth, portid,
+				RTE_NODE_IP4_LOOKUP_NEXT_REWRITE);
+
 	return rte_node_ip4_route_add(ipv4route->ip, depth, portid,
 			RTE_NODE_IP4_LOOKUP_NEXT_REWRITE);
 }
@@ -111,6 +122,48 @@ route_ip4_add(struct route_ipv4_config *route)
 	return rc;
 }
 
+int
+route_ip4_lookup_setup(void)
+{
+	struct rte_fib_conf conf = {
+		.type = RTE_FIB_DIR24_8,
+		.max_routes = ROUTE_FIB_MAX_ROUTES,
+		.dir24_8 = {
+			.nh_sz = RTE_FIB_DIR24_8_4B,
+			.num_tbl8 = ROUTE_FIB_NUM_TBL8,
+		},
+	};
+	const char *next_node = "ip4_lookup_fib";
+	unsigned int lcore_id;
+	rte_node_t id;
+	int rc;
+
+	if (ip4_lookup_mode == ROUTE_LOOKUP_LPM)
+		return 0;
+
+	/* One FIB per socket, to be created before the graphs */
+	RTE_LCORE_FOREACH(lcore_id) {
+		rc = rte_node_ip4_fib_create(rte_lcore_to_socket_id(lcore_id), &conf);
+		if (rc < 0)
+			return rc;
+	}
+
+	/* Send IPv4 packets to the FIB lookup node */
+	id = rte_node_from_name("pkt_cls");
+	if (id == RTE_NODE_ID_INVALID ||
+	    rte_node_edge_update(id, RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP, &next_node, 1) == 0)
+		return -EINVAL;
+
+	return 0;
+}
+
+/* Name of the node doing the IPv4 lookups */
+const char *
+route_ip4_lookup_node_get(void)
+{
+	return ip4_lookup_mode == ROUTE_LOOKUP_FIB ? "ip4_lookup_fib" : "ip4_lookup";
+}
+
 int
 route_ip4_add_to_lookup(void)
 {
@@ -134,14 +187,32 @@ cmd_help_ipv4_lookup_parsed(__rte_unused void *parsed_result, __rte_unused struc
 
 	len = strlen(conn->msg_out);
 	conn->msg_out += len;
-	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n",
+	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n%s\n",
 		 "--------------------------- ipv4_lookup command help ---------------------------",
-		 cmd_ipv4_lookup_help);
+		 cmd_ipv4_lookup_help, cmd_ipv4_lookup_mode_help);
 
 	len = strlen(conn->msg_out);
 	conn->msg_out_len_max -= len;
 }
 
+void
+cmd_ipv4_lookup_mode_parsed(void *parsed_result, __rte_unused struct cmdline *cl,
+			    void *data __rte_unused)
+{
+	struct cmd_ipv4_lookup_mode_result *res = parsed_result;
+
+	/* The lookup node is chosen when creating the graphs */
+	if (graph_status_get()) {
+		printf(MSG_CMD_FAIL, res->ipv4_lookup);
+		return;
+	}
+
+	if (strcmp(res->lkup_mode, "fib") == 0)
+		ip4_lookup_mode = ROUTE_LOOKUP_FIB;
+	else
+		ip4_lookup_mode = ROUTE_LOOKUP_LPM;
+}
+
 void
 cmd_ipv4_lookup_route_add_ipv4_parsed(void *parsed_result, __rte_unused struct cmdline *cl,
 				      void *data __rte_unused)
@@ -10,7 +10,9 @@
 #include <cmdline_parse_string.h>
 #include <cmdline_socket.h>
 
+#include <rte_lcore.h>
 #include <rte_node_ip6_api.h>
+#include <rte_node_pkt_cls_api.h>
 #include <rte_ip6.h>
 
 #include "module_api.h"
@@ -19,8 +21,13 @@
 static const char
 cmd_ipv6_lookup_help[] = "ipv6_lookup route add ipv6 <ip> netmask <mask> via <ip>";
 
+static const char
+cmd_ipv6_lookup_mode_help[] = "ipv6_lookup mode <lpm/fib>";
+
 struct ip6_route route6 = TAILQ_HEAD_INITIALIZER(route6);
 
+static enum route_lookup_mode ip6_lookup_mode = ROUTE_LOOKUP_LPM;
+
 void
 route_ip6_list_clean(void)
 {
@@ -57,6 +64,10 @@ route6_rewirte_table_update(struct route_ipv6_config *ipv6route)
 	}
 	depth = rte_ipv6_mask_depth(&ipv6route->mask);
 
+	if (ip6_lookup_mode == ROUTE_LOOKUP_FIB)
+		return rte_node_ip6_fib_route_add(&ipv6route->ip, depth, portid,
+				RTE_NODE_IP6_LOOKUP_NEXT_REWRITE);
+
 	return rte_node_ip6_route_add(&ipv6route->ip, depth, portid,
 			RTE_NODE_IP6_LOOKUP_NEXT_REWRITE);
 
@@ -97,6 +108,41 @@ route_ip6_add(struct route_ipv6_config *route)
 	return rc;
 }
 
+int
+route_ip6_lookup_setup(void)
+{
+	struct rte_fib6_conf conf = {
+		.type = RTE_FIB6_TRIE,
+		.max_routes = ROUTE_FIB_MAX_ROUTES,
+		.trie = {
+			.nh_sz = RTE_FIB6_TRIE_4B,
+			.num_tbl8 = ROUTE_FIB_NUM_TBL8,
+		},
+	};
+	const char *next_node = "ip6_lookup_fib";
+	unsigned int lcore_id;
+	rte_node_t id;
+	int rc;
+
+	if (ip6_lookup_mode == ROUTE_LOOKUP_LPM)
+		return 0;
+
+	/* One FIB per socket, to be created before the graphs */
+	RTE_LCORE_FOREACH(lcore_id) {
+		rc = rte_node_ip6_fib_create(rte_lcore_to_socket_id(lcore_id), &conf);
+		if (rc < 0)
+			return rc;
+	}
+
+	/* Send IPv6 packets to the FIB lookup node */
+	id = rte_node_from_name("pkt_cls");
+	if (id == RTE_NODE_ID_INVALID ||
+	    rte_node_edge_update(id, RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP, &next_node, 1) == 0)
+		return -EINVAL;
+
+	return 0;
+}
+
 int
 route_ip6_add_to_lookup(void)
 {
@@ -120,14 +166,32 @@ cmd_help_ipv6_lookup_parsed(__rte_unused void *parsed_result, __rte_unused struc
 
 	len = strlen(conn->msg_out);
 	conn->msg_out += len;
-	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n",
+	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n%s\n",
 		 "--------------------------- ipv6_lookup command help ---------------------------",
-		 cmd_ipv6_lookup_help);
+		 cmd_ipv6_lookup_help, cmd_ipv6_lookup_mode_help);
 
 	len = strlen(conn->msg_out);
 	conn->msg_out_len_max -= len;
 }
 
+void
+cmd_ipv6_lookup_mode_parsed(void *parsed_result, __rte_unused struct cmdline *cl,
+			    void *data __rte_unused)
+{
+	struct cmd_ipv6_lookup_mode_result *res = parsed_result;
+
+	/* The lookup node is chosen when creating the graphs */
+	if (graph_status_get()) {
+		printf(MSG_CMD_FAIL, res->ipv6_lookup);
+		return;
+	}
+
+	if (strcmp(res->lkup_mode, "fib") == 0)
+		ip6_lookup_mode = ROUTE_LOOKUP_FIB;
+	else
+		ip6_lookup_mode = ROUTE_LOOKUP_LPM;
+}
+
 void
 cmd_ipv6_lookup_route_add_ipv6_parsed(void *parsed_result, __rte_unused struct cmdline *cl,
 				      void *data __rte_unused)
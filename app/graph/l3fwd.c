@@ -31,19 +31,26 @@ l3fwd_pattern_configure(void)
 	const char **node_patterns;
 	uint64_t pcap_pkts_count;
 	struct lcore_conf *qconf;
-	uint16_t nb_patterns;
+	uint16_t nb_patterns, nb_features;
 	uint8_t pcap_ena;
 	int rc, lcore_id;
 	char *pcap_file;
 
 	nb_patterns = RTE_DIM(default_patterns);
-	node_patterns = malloc((ETHDEV_RX_QUEUE_PER_LCORE_MAX + nb_patterns) *
-			sizeof(*node_patterns));
+	nb_features = feature_nodes_get(NULL);
+	node_patterns = malloc((ETHDEV_RX_QUEUE_PER_LCORE_MAX + nb_patterns +
+			nb_features) * sizeof(*node_patterns));
 	if (!node_patterns)
 		return -ENOMEM;
 	memcpy(node_patterns, default_patterns,
 			nb_patterns * sizeof(*node_patterns));
 
+	/* Feature nodes enabled on the arcs */
+	rc = feature_add_to_arcs();
+	if (rc < 0)
+		rte_exit(EXIT_FAILURE, "Unable to add features to arcs: err=%d\n", rc);
+	nb_patterns += feature_nodes_get(&node_patterns[nb_patterns]);
+
 	memset(&graph_conf, 0, sizeof(graph_conf));
 	graph_conf.node_patterns = node_patterns;
 
@@ -53,6 +60,18 @@ l3fwd_pattern_configure(void)
 	graph_conf.num_pkt_to_capture = pcap_pkts_count;
 	graph_conf.pcap_filename = strdup(pcap_file);
 
+	rc = route_ip4_lookup_setup();
+	if (rc < 0)
+		rte_exit(EXIT_FAILURE, "Unable to setup v4 lookup: err=%d\n", rc);
+
+	rc = route_ip6_lookup_setup();
+	if (rc < 0)
+		rte_exit(EXIT_FAILURE, "Unable to setup v6 lookup: err=%d\n", rc);
+
+	rc = acl_ip4_setup();
+	if (rc < 0)
+		rte_exit(EXIT_FAILURE, "Unable to setup v4 ACL: err=%d\n", rc);
+
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
 		rte_graph_t graph_id;
 		rte_edge_t i;
@@ -109,6 +128,10 @@ l3fwd_pattern_configure(void)
 	if (rc < 0)
 		rte_exit(EXIT_FAILURE, "Unable to add v6 to rewrite node\n");
 
+	rc = feature_enable_on_arcs();
+	if (rc < 0)
+		rte_exit(EXIT_FAILURE, "Unable to enable features: err=%d\n", rc);
+
 	/* Launch per-lcore init on every worker lcore */
 	rte_eal_mp_remote_launch(graph_walk_start, NULL, SKIP_MAIN);
 
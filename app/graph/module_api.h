@@ -8,11 +8,13 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "acl.h"
 #include "cli.h"
 #include "conn.h"
 #include "commands.h"
 #include "ethdev.h"
 #include "ethdev_rx.h"
+#include "feature.h"
 #include "graph.h"
 #include "l2fwd.h"
 #include "l3fwd.h"
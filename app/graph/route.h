@@ -29,7 +29,15 @@ struct route_ipv6_config {
 
 TAILQ_HEAD(ip6_route, route_ipv6_config);
 
+enum route_lookup_mode {
+	ROUTE_LOOKUP_LPM,
+	ROUTE_LOOKUP_FIB,
+};
+
+int route_ip4_lookup_setup(void);
+int route_ip6_lookup_setup(void);
 int route_ip4_add_to_lookup(void);
+const char *route_ip4_lookup_node_get(void);
 int route_ip6_add_to_lookup(void);
 void route_ip4_list_clean(void);
 void route_ip6_list_clean(void);
@@ -7,4 +7,8 @@
 
 #define MAX_ROUTE_ENTRIES 32
 
+/* FIB sizes when the lookup mode is fib */
+#define ROUTE_FIB_MAX_ROUTES (1 << 16)
+#define ROUTE_FIB_NUM_TBL8 (1 << 12)
+
 #endif
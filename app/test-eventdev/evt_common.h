@@ -25,6 +25,7 @@
 	fprintf(stdout, CLYEL""fmt CLNRM "\n", ## args)
 
 #define EVT_STR_FMT 20
+#define EVT_DEV_SERVICES_MAX 16
 
 #define evt_dump(str, fmt, val...) \
 	printf("\t%-*s : "fmt"\n", EVT_STR_FMT, str, ## val)
@@ -63,6 +64,7 @@ struct evt_options {
 	uint8_t timdev_cnt;
 	uint8_t nb_timer_adptrs;
 	uint8_t timdev_use_burst;
+	uint8_t timdev_use_wheel;
 	uint8_t per_port_pool;
 	uint8_t preschedule;
 	uint8_t preschedule_opted;
@@ -172,6 +174,30 @@ evt_service_setup(uint32_t service_id)
 	return 0;
 }
 
+/*
+ * Map the scheduling services of the event device to service lcores,
+ * the device scheduling being possibly split over several services.
+ */
+static inline int
+evt_dev_service_setup(uint8_t dev_id)
+{
+	uint32_t service_ids[EVT_DEV_SERVICES_MAX];
+	int i, n, ret;
+
+	n = rte_event_dev_service_ids_get(dev_id, service_ids,
+			RTE_DIM(service_ids));
+	if (n < 0)
+		return n;
+
+	for (i = 0; i < RTE_MIN(n, (int)RTE_DIM(service_ids)); i++) {
+		ret = evt_service_setup(service_ids[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 static inline int
 evt_configure_eventdev(struct evt_options *opt, uint8_t nb_queues,
 		uint8_t nb_ports)
@@ -49,6 +49,7 @@
 #define EVT_TIMER_TICK_NSEC      ("timer_tick_nsec")
 #define EVT_MAX_TMO_NSEC         ("max_tmo_nsec")
 #define EVT_EXPIRY_NSEC          ("expiry_nsec")
+#define EVT_TIMER_WHEEL          ("timer_wheel")
 #define EVT_MBUF_SZ              ("mbuf_sz")
 #define EVT_MAX_PKT_SZ           ("max_pkt_sz")
 #define EVT_PROD_ENQ_BURST_SZ    ("prod_enq_burst_sz")
@@ -297,6 +298,8 @@ evt_dump_producer_type(struct evt_options *opt)
 		evt_dump("nb_timer_adapters", "%d", opt->nb_timer_adptrs);
 		evt_dump("max_tmo_nsec", "%"PRIu64"", opt->max_tmo_nsec);
 		evt_dump("expiry_nsec", "%"PRIu64"", opt->expiry_nsec);
+		evt_dump("timer_wheel", "%s",
+			 opt->timdev_use_wheel ? "true" : "false");
 		if (opt->optm_timer_tick_nsec)
 			evt_dump("optm_timer_tick_nsec", "%"PRIu64"",
 					opt->optm_timer_tick_nsec);
@@ -1135,6 +1135,8 @@ perf_event_timer_adapter_setup(struct test_perf *t)
 
 	if (nb_producers == 1)
 		flags |= RTE_EVENT_TIMER_ADAPTER_F_SP_PUT;
+	if (t->opt->timdev_use_wheel)
+		flags |= RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
 
 	for (i = 0; i < t->opt->nb_timer_adptrs; i++) {
 		struct rte_event_timer_adapter_conf config = {
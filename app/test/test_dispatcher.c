@@ -792,19 +792,13 @@ test_app_get_errors(struct test_app *app)
 	return rte_atomic_load_explicit(&app->errors, rte_memory_order_relaxed);
 }
 
-static int
-test_basic(void)
+static void
+test_app_enqueue_events(struct test_app *app, int num_events)
 {
-	int rc;
-	int i;
-
-	rc = test_app_start(test_app);
-	if (rc != TEST_SUCCESS)
-		return rc;
-
 	uint64_t sns[NUM_FLOWS] = { 0 };
+	int i;
 
-	for (i = 0; i < NUM_EVENTS;) {
+	for (i = 0; i < num_events;) {
 		struct rte_event events[ENQUEUE_BURST_SIZE];
 		int left;
 		int batch_size;
@@ -812,7 +806,7 @@ test_basic(void)
 		uint16_t n = 0;
 
 		batch_size = 1 + rte_rand_max(ENQUEUE_BURST_SIZE);
-		left = NUM_EVENTS - i;
+		left = num_events - i;
 
 		batch_size = RTE_MIN(left, batch_size);
 
@@ -836,7 +830,7 @@ test_basic(void)
 		}
 
 		while (n < batch_size)
-			n += rte_event_enqueue_new_burst(test_app->event_dev_id,
+			n += rte_event_enqueue_new_burst(app->event_dev_id,
 							 DRIVER_PORT_ID,
 							 events + n,
 							 batch_size - n);
@@ -844,8 +838,20 @@ test_basic(void)
 		i += batch_size;
 	}
 
-	while (test_app_get_completed_events(test_app) != NUM_EVENTS)
-		rte_event_maintain(test_app->event_dev_id, DRIVER_PORT_ID, 0);
+	while (test_app_get_completed_events(app) != num_events)
+		rte_event_maintain(app->event_dev_id, DRIVER_PORT_ID, 0);
+}
+
+static int
+test_basic(void)
+{
+	int rc;
+
+	rc = test_app_start(test_app);
+	if (rc != TEST_SUCCESS)
+		return rc;
+
+	test_app_enqueue_events(test_app, NUM_EVENTS);
 
 	rc = test_app_get_errors(test_app);
 	TEST_ASSERT(rc == 0, "%d errors occurred", rc);
@@ -943,6 +949,88 @@ test_drop(void)
 	return TEST_SUCCESS;
 }
 
+#define NUM_QUEUE_HANDLER_EVENTS 100000
+#define MORE_THAN_MAX_HANDLERS_ID 1000
+
+static int
+test_queue_handlers(void)
+{
+	struct rte_dispatcher_handler_stats handler_stats;
+	struct rte_dispatcher_stats stats;
+	int rc;
+	int i;
+
+	/* Replace the match handlers of the odd queues by queue handlers */
+	for (i = 1; i < NUM_QUEUES; i += 2) {
+		struct app_queue *app_queue = &test_app->queues[i];
+		int reg_id;
+
+		rc = test_app_unregister_callback(test_app, i);
+		if (rc != TEST_SUCCESS)
+			return rc;
+
+		reg_id = rte_dispatcher_register_queue(test_app->dispatcher,
+						       app_queue->queue_id,
+						       test_app_process_queue,
+						       app_queue);
+		TEST_ASSERT(reg_id >= 0, "Unable to register queue handler "
+			    "for queue %d", i);
+
+		app_queue->dispatcher_reg_id = reg_id;
+	}
+
+	rc = rte_dispatcher_register_queue(test_app->dispatcher,
+					   test_app->queues[1].queue_id,
+					   test_app_process_queue,
+					   &test_app->queues[1]);
+	TEST_ASSERT_EQUAL(rc, -EEXIST, "Expected %d but was %d", -EEXIST, rc);
+
+	rc = test_app_start(test_app);
+	if (rc != TEST_SUCCESS)
+		return rc;
+
+	test_app_enqueue_events(test_app, NUM_QUEUE_HANDLER_EVENTS);
+
+	rc = test_app_get_errors(test_app);
+	TEST_ASSERT(rc == 0, "%d errors occurred", rc);
+
+	rc = test_app_stop(test_app);
+	if (rc != TEST_SUCCESS)
+		return rc;
+
+	rte_dispatcher_stats_get(test_app->dispatcher, &stats);
+
+	TEST_ASSERT_EQUAL(stats.ev_drop_count, 0, "Drop count is not zero");
+	TEST_ASSERT_EQUAL(stats.ev_dispatch_count,
+			  NUM_QUEUE_HANDLER_EVENTS * NUM_QUEUES,
+			  "Invalid dispatch count");
+
+	for (i = 0; i < NUM_QUEUES; i++) {
+		rc = rte_dispatcher_handler_stats_get(test_app->dispatcher,
+				test_app->queues[i].dispatcher_reg_id,
+				&handler_stats);
+		TEST_ASSERT_SUCCESS(rc, "Unable to get handler stats for "
+				    "queue %d", i);
+
+		TEST_ASSERT_EQUAL(handler_stats.ev_count,
+				  NUM_QUEUE_HANDLER_EVENTS,
+				  "Invalid event count for queue %d", i);
+		TEST_ASSERT(handler_stats.process_count > 0 &&
+			    handler_stats.process_count <=
+			    handler_stats.ev_count,
+			    "Invalid process count for queue %d", i);
+		TEST_ASSERT(handler_stats.process_cycles > 0,
+			    "Process cycles is zero for queue %d", i);
+	}
+
+	rc = rte_dispatcher_handler_stats_get(test_app->dispatcher,
+					      MORE_THAN_MAX_HANDLERS_ID,
+					      &handler_stats);
+	TEST_ASSERT_EQUAL(rc, -EINVAL, "Expected %d but was %d", -EINVAL, rc);
+
+	return TEST_SUCCESS;
+}
+
 #define MORE_THAN_MAX_HANDLERS 1000
 #define MIN_HANDLERS 32
 
@@ -1039,6 +1127,7 @@ static struct unit_test_suite test_suite = {
 	.unit_test_cases = {
 		TEST_CASE_ST(test_setup, test_teardown, test_basic),
 		TEST_CASE_ST(test_setup, test_teardown, test_drop),
+		TEST_CASE_ST(test_setup, test_teardown, test_queue_handlers),
 		TEST_CASE_ST(test_setup, test_teardown,
 			     test_many_handler_registrations),
 		TEST_CASE_ST(test_setup, test_teardown,
@@ -6,6 +6,7 @@
 #include "test.h"
 #include <string.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_malloc.h>
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
@@ -24,6 +25,7 @@ test_event_crypto_adapter(void)
 #include <rte_eventdev.h>
 #include <rte_bus_vdev.h>
 #include <rte_service.h>
+#include <rte_stdatomic.h>
 #include <rte_event_crypto_adapter.h>
 
 #define PKT_TRACE                  0
@@ -42,11 +44,15 @@ test_event_crypto_adapter(void)
 #define TEST_ADAPTER_ID            0
 #define TEST_CDEV_ID               0
 #define TEST_CDEV_QP_ID            0
+#define TEST_CDEV_QP_ID_2          1
 #define PACKET_LENGTH              64
 #define NB_TEST_PORTS              1
 #define NB_TEST_QUEUES             2
 #define NUM_CORES                  1
 #define CRYPTODEV_NAME_NULL_PMD    crypto_null
+#define NUM_ORDERED_OPS            64
+#define NUM_DEL_OPS                4
+#define EV_RECV_TIMEOUT_MS         5000
 
 #define MBUF_SIZE              (sizeof(struct rte_mbuf) + \
 				RTE_PKTMBUF_HEADROOM + PACKET_LENGTH)
@@ -180,6 +186,8 @@ static uint8_t crypto_adapter_setup_done;
 static uint32_t slcore_id;
 static int evdev;
 
+static uint8_t cdev_nb_qps;
+
 static struct rte_mbuf *
 alloc_fill_mbuf(struct rte_mempool *mpool, const uint8_t *data,
 		size_t len, uint8_t blocksize)
@@ -377,6 +385,41 @@ test_crypto_adapter_params(void)
 	TEST_ASSERT(in_params.max_nb == out_params.max_nb, "Expected %u got %u",
 		    in_params.max_nb, out_params.max_nb);
 
+	/* Case 7: Set enq_flush_timeout_ns = 10000 */
+	in_params.enq_flush_timeout_ns = 10000;
+
+	err = rte_event_crypto_adapter_runtime_params_set(TEST_ADAPTER_ID,
+							  &in_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_crypto_adapter_runtime_params_get(TEST_ADAPTER_ID,
+							  &out_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(in_params.enq_flush_timeout_ns ==
+		    out_params.enq_flush_timeout_ns, "Expected %u got %u",
+		    in_params.enq_flush_timeout_ns,
+		    out_params.enq_flush_timeout_ns);
+
+	/* Case 8: Ordered completion in OP_NEW mode */
+	in_params.flags = RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED;
+
+	err = rte_event_crypto_adapter_runtime_params_set(TEST_ADAPTER_ID,
+							  &in_params);
+	TEST_ASSERT(err == -ENOTSUP, "Expected -ENOTSUP got %d", err);
+
+	err = rte_event_crypto_adapter_runtime_params_get(TEST_ADAPTER_ID,
+							  &out_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(out_params.flags == 0, "Expected 0 got %u",
+		    out_params.flags);
+
+	/* Case 9: Set an unknown flag */
+	in_params.flags = 0x80;
+
+	err = rte_event_crypto_adapter_runtime_params_set(TEST_ADAPTER_ID,
+							  &in_params);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
 	rc = TEST_SUCCESS;
 queue_pair_del:
 	err = rte_event_crypto_adapter_queue_pair_del(TEST_ADAPTER_ID,
@@ -555,6 +598,307 @@ test_session_with_op_forward_mode(void)
 	return TEST_SUCCESS;
 }
 
+/* Session-less crypto op carrying its ingress sequence number in the
+ * first bytes of the packet, as the null cipher leaves them unchanged
+ */
+static int
+ordered_ev_alloc(struct rte_event *ev, struct rte_crypto_sym_xform *xform,
+		 uint32_t seqn, uint16_t qp_id)
+{
+	union rte_event_crypto_metadata m_data;
+	struct rte_crypto_sym_op *sym_op;
+	struct rte_crypto_op *op;
+	struct rte_mbuf *m;
+	uint32_t len;
+
+	m = alloc_fill_mbuf(params.mbuf_pool, text_64B, PACKET_LENGTH, 0);
+	TEST_ASSERT_NOT_NULL(m, "Failed to allocate mbuf!\n");
+	*rte_pktmbuf_mtod(m, uint32_t *) = seqn;
+
+	op = rte_crypto_op_alloc(params.op_mpool,
+			RTE_CRYPTO_OP_TYPE_SYMMETRIC);
+	TEST_ASSERT_NOT_NULL(op,
+		"Failed to allocate symmetric crypto operation struct\n");
+
+	rte_crypto_op_sym_xforms_alloc(op, NUM);
+	op->sess_type = RTE_CRYPTO_OP_SESSIONLESS;
+	sym_op = op->sym;
+	sym_op->xform = xform;
+	sym_op->m_src = m;
+	sym_op->cipher.data.offset = 0;
+	sym_op->cipher.data.length = PACKET_LENGTH;
+
+	memset(&m_data, 0, sizeof(m_data));
+	len = IV_OFFSET + MAXIMUM_IV_LENGTH;
+	op->private_data_offset = len;
+	m_data.request_info.cdev_id = TEST_CDEV_ID;
+	m_data.request_info.queue_pair_id = qp_id;
+	m_data.response_info.event = response_info.event;
+	rte_memcpy((uint8_t *)op + len, &m_data, sizeof(m_data));
+
+	memset(ev, 0, sizeof(*ev));
+	ev->queue_id = TEST_CRYPTO_EV_QUEUE_ID;
+	ev->sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev->flow_id = TEST_APP_EV_FLOWID;
+	ev->event_ptr = op;
+
+	return TEST_SUCCESS;
+}
+
+static int
+ordered_ev_send(struct rte_event *ev, uint16_t nb_ev)
+{
+	uint16_t n = 0;
+
+	while (n < nb_ev)
+		n += rte_event_enqueue_burst(evdev, TEST_APP_PORT_ID,
+					     &ev[n], nb_ev - n);
+
+	return TEST_SUCCESS;
+}
+
+/* Receive the crypto ops in ingress order, the sequence number of the first
+ * expected one is passed in seqn and the next one is returned.
+ * With skip set, the missing sequence numbers are accepted.
+ */
+static int
+ordered_ev_recv(uint16_t nb_ev, uint32_t *seqn, bool skip)
+{
+	uint64_t timeout = rte_get_timer_cycles() +
+		rte_get_timer_hz() * EV_RECV_TIMEOUT_MS / 1000;
+	struct rte_event ev[NUM_ORDERED_OPS];
+	struct rte_crypto_op *op;
+	uint32_t recv_seqn;
+	uint16_t n, i;
+
+	while (nb_ev) {
+		TEST_ASSERT(rte_get_timer_cycles() < timeout,
+			    "Timeout with %u crypto ops to receive", nb_ev);
+
+		n = rte_event_dequeue_burst(evdev, TEST_APP_PORT_ID, ev,
+					    RTE_MIN(nb_ev, NUM_ORDERED_OPS), 0);
+		for (i = 0; i < n; i++) {
+			op = ev[i].event_ptr;
+			TEST_ASSERT_EQUAL(op->status,
+					  RTE_CRYPTO_OP_STATUS_SUCCESS,
+					  "Crypto op failed");
+			recv_seqn = *rte_pktmbuf_mtod(op->sym->m_src,
+						      uint32_t *);
+			if (skip)
+				TEST_ASSERT(recv_seqn >= *seqn,
+					    "Expected seqn >= %u got %u",
+					    *seqn, recv_seqn);
+			else
+				TEST_ASSERT_EQUAL(recv_seqn, *seqn,
+						  "Expected seqn %u got %u",
+						  *seqn, recv_seqn);
+			*seqn = recv_seqn + 1;
+			rte_pktmbuf_free(op->sym->m_src);
+			rte_crypto_op_free(op);
+		}
+		nb_ev -= n;
+	}
+
+	return TEST_SUCCESS;
+}
+
+/* Crypto ops held by the dequeue callback, as if still in the cryptodev */
+static struct rte_crypto_op *ordered_held_ops[NUM_DEL_OPS];
+static RTE_ATOMIC(uint16_t) ordered_nb_held;
+
+static uint16_t
+ordered_hold_cb(uint16_t dev_id __rte_unused, uint16_t qp_id __rte_unused,
+		struct rte_crypto_op **ops, uint16_t nb_ops,
+		void *user_param __rte_unused)
+{
+	uint16_t nb_held, i;
+
+	nb_held = rte_atomic_load_explicit(&ordered_nb_held,
+					   rte_memory_order_relaxed);
+	for (i = 0; i < nb_ops && nb_held < NUM_DEL_OPS; i++)
+		ordered_held_ops[nb_held++] = ops[i];
+	rte_atomic_store_explicit(&ordered_nb_held, nb_held,
+				  rte_memory_order_release);
+
+	/* More than expected, let the adapter get them */
+	memmove(ops, &ops[i], (nb_ops - i) * sizeof(*ops));
+	return nb_ops - i;
+}
+
+static int
+test_ordered_with_op_forward_mode(void)
+{
+	struct rte_event_crypto_adapter_runtime_params rt_params;
+	struct rte_crypto_sym_xform cipher_xform;
+	struct rte_event ev[NUM_ORDERED_OPS];
+	struct rte_cryptodev_cb *deq_cb;
+	uint32_t seqn, recv_seqn;
+	uint64_t timeout;
+	uint32_t cap;
+	uint16_t i, n;
+	int ret;
+
+	ret = rte_event_crypto_adapter_caps_get(evdev, TEST_CDEV_ID, &cap);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get adapter capabilities\n");
+
+	/* Ordered completion is done by the service function */
+	if ((cap & (RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_FWD |
+		    RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_NEW)) ||
+	    cdev_nb_qps < 2)
+		return TEST_SKIPPED;
+
+	map_adapter_service_core();
+
+	ret = rte_event_crypto_adapter_queue_pair_add(TEST_ADAPTER_ID,
+			TEST_CDEV_ID, TEST_CDEV_QP_ID_2, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to add queue pair\n");
+
+	ret = rte_event_crypto_adapter_runtime_params_get(TEST_ADAPTER_ID,
+							  &rt_params);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get runtime params\n");
+	rt_params.flags = RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED;
+	ret = rte_event_crypto_adapter_runtime_params_set(TEST_ADAPTER_ID,
+							  &rt_params);
+	TEST_ASSERT_SUCCESS(ret, "Failed to set ordered completion\n");
+
+	TEST_ASSERT_SUCCESS(rte_event_crypto_adapter_start(TEST_ADAPTER_ID),
+				"Failed to start event crypto adapter");
+
+	cipher_xform.type = RTE_CRYPTO_SYM_XFORM_CIPHER;
+	cipher_xform.next = NULL;
+	cipher_xform.cipher.algo = RTE_CRYPTO_CIPHER_NULL;
+	cipher_xform.cipher.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT;
+
+	/* Case 1: Spread a flow over two queue pairs, each queue pair
+	 * completes its crypto ops in a single batch.
+	 */
+	for (i = 0; i < NUM_ORDERED_OPS; i++) {
+		ret = ordered_ev_alloc(&ev[i], &cipher_xform, i,
+				       (i & 1) ? TEST_CDEV_QP_ID_2 :
+				       TEST_CDEV_QP_ID);
+		TEST_ASSERT_SUCCESS(ret, "Failed to allocate crypto op\n");
+	}
+
+	TEST_ASSERT_SUCCESS(ordered_ev_send(ev, NUM_ORDERED_OPS),
+			    "Failed to send events");
+	seqn = 0;
+	TEST_ASSERT_SUCCESS(ordered_ev_recv(NUM_ORDERED_OPS, &seqn, false),
+			    "Crypto ops not received in ingress order");
+
+	/* Case 2: Delete a queue pair with buffered crypto ops, the crypto
+	 * ops of the other queue pair must not be held back.
+	 */
+	for (i = 0; i < NUM_DEL_OPS + NUM_ORDERED_OPS / 2; i++) {
+		ret = ordered_ev_alloc(&ev[i], &cipher_xform, seqn + i,
+				       i < NUM_DEL_OPS ?
+				       TEST_CDEV_QP_ID_2 : TEST_CDEV_QP_ID);
+		TEST_ASSERT_SUCCESS(ret, "Failed to allocate crypto op\n");
+	}
+	TEST_ASSERT_SUCCESS(ordered_ev_send(ev, NUM_DEL_OPS),
+			    "Failed to send events");
+
+	ret = rte_event_crypto_adapter_queue_pair_del(TEST_ADAPTER_ID,
+			TEST_CDEV_ID, TEST_CDEV_QP_ID_2);
+	TEST_ASSERT_SUCCESS(ret, "Failed to delete queue pair\n");
+
+	TEST_ASSERT_SUCCESS(ordered_ev_send(&ev[NUM_DEL_OPS],
+					    NUM_ORDERED_OPS / 2),
+			    "Failed to send events");
+
+	/* The crypto ops of the deleted queue pair may have completed */
+	recv_seqn = seqn;
+	i = 0;
+	while (recv_seqn < seqn + NUM_DEL_OPS + NUM_ORDERED_OPS / 2) {
+		TEST_ASSERT(i++ < NUM_DEL_OPS + NUM_ORDERED_OPS / 2,
+			    "Unexpected crypto op received");
+		TEST_ASSERT_SUCCESS(ordered_ev_recv(1, &recv_seqn, true),
+				    "Crypto ops held back by deleted queue pair");
+	}
+	seqn += NUM_DEL_OPS + NUM_ORDERED_OPS / 2;
+
+	/* Case 3: Delete a queue pair with crypto ops in flight in the
+	 * cryptodev, the dequeue callback holds them back from the adapter.
+	 * The crypto ops of the other queue pair must not be held back and
+	 * the ones in flight must be dropped when they complete later.
+	 */
+	ret = rte_event_crypto_adapter_queue_pair_add(TEST_ADAPTER_ID,
+			TEST_CDEV_ID, TEST_CDEV_QP_ID_2, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to add queue pair\n");
+
+	rte_atomic_store_explicit(&ordered_nb_held, 0,
+				  rte_memory_order_relaxed);
+	deq_cb = rte_cryptodev_add_deq_callback(TEST_CDEV_ID,
+			TEST_CDEV_QP_ID_2, ordered_hold_cb, NULL);
+	if (deq_cb == NULL) {
+		TEST_ASSERT_EQUAL(rte_errno, ENOTSUP,
+				  "Failed to add dequeue callback\n");
+		goto stop;
+	}
+
+	for (i = 0; i < NUM_DEL_OPS + NUM_ORDERED_OPS / 2; i++) {
+		ret = ordered_ev_alloc(&ev[i], &cipher_xform, seqn + i,
+				       i < NUM_DEL_OPS ?
+				       TEST_CDEV_QP_ID_2 : TEST_CDEV_QP_ID);
+		TEST_ASSERT_SUCCESS(ret, "Failed to allocate crypto op\n");
+	}
+	TEST_ASSERT_SUCCESS(ordered_ev_send(ev, NUM_DEL_OPS),
+			    "Failed to send events");
+
+	timeout = rte_get_timer_cycles() +
+		rte_get_timer_hz() * EV_RECV_TIMEOUT_MS / 1000;
+	while (rte_atomic_load_explicit(&ordered_nb_held,
+					rte_memory_order_acquire) < NUM_DEL_OPS)
+		TEST_ASSERT(rte_get_timer_cycles() < timeout,
+			    "Crypto ops not enqueued to the cryptodev");
+
+	ret = rte_event_crypto_adapter_queue_pair_del(TEST_ADAPTER_ID,
+			TEST_CDEV_ID, TEST_CDEV_QP_ID_2);
+	TEST_ASSERT_SUCCESS(ret, "Failed to delete queue pair\n");
+	TEST_ASSERT_SUCCESS(rte_cryptodev_remove_deq_callback(TEST_CDEV_ID,
+				TEST_CDEV_QP_ID_2, deq_cb),
+			    "Failed to remove dequeue callback\n");
+
+	TEST_ASSERT_SUCCESS(ordered_ev_send(&ev[NUM_DEL_OPS],
+					    NUM_ORDERED_OPS / 2),
+			    "Failed to send events");
+	recv_seqn = seqn + NUM_DEL_OPS;
+	TEST_ASSERT_SUCCESS(ordered_ev_recv(NUM_ORDERED_OPS / 2, &recv_seqn,
+					    false),
+			    "Crypto ops held back by crypto ops in flight");
+	seqn = recv_seqn;
+
+	/* The crypto ops in flight complete once the queue pair is added
+	 * back, before the new ones of the same queue pair
+	 */
+	ret = rte_event_crypto_adapter_queue_pair_add(TEST_ADAPTER_ID,
+			TEST_CDEV_ID, TEST_CDEV_QP_ID_2, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to add queue pair\n");
+	for (n = 0; n < NUM_DEL_OPS;)
+		n += rte_cryptodev_enqueue_burst(TEST_CDEV_ID,
+				TEST_CDEV_QP_ID_2, &ordered_held_ops[n],
+				NUM_DEL_OPS - n);
+
+	for (i = 0; i < NUM_ORDERED_OPS; i++) {
+		ret = ordered_ev_alloc(&ev[i], &cipher_xform, seqn + i,
+				       (i & 1) ? TEST_CDEV_QP_ID_2 :
+				       TEST_CDEV_QP_ID);
+		TEST_ASSERT_SUCCESS(ret, "Failed to allocate crypto op\n");
+	}
+	TEST_ASSERT_SUCCESS(ordered_ev_send(ev, NUM_ORDERED_OPS),
+			    "Failed to send events");
+	TEST_ASSERT_SUCCESS(ordered_ev_recv(NUM_ORDERED_OPS, &seqn, false),
+			    "Crypto ops in flight not dropped");
+
+stop:
+	rte_event_crypto_adapter_stop(TEST_ADAPTER_ID);
+	rt_params.flags = 0;
+	ret = rte_event_crypto_adapter_runtime_params_set(TEST_ADAPTER_ID,
+							  &rt_params);
+	TEST_ASSERT_SUCCESS(ret, "Failed to reset ordered completion\n");
+
+	return TEST_SUCCESS;
+}
+
 static int
 test_asym_op_forward_mode(uint8_t session_less)
 {
@@ -1148,6 +1492,17 @@ configure_cryptodev(void)
 			rte_cryptodev_socket_id(TEST_CDEV_ID)),
 			"Failed to setup queue pair %u on cryptodev %u\n",
 			TEST_CDEV_QP_ID, TEST_CDEV_ID);
+	cdev_nb_qps = 1;
+
+	/* Second queue pair for the ordered completion test */
+	if (conf.nb_queue_pairs > TEST_CDEV_QP_ID_2) {
+		TEST_ASSERT_SUCCESS(rte_cryptodev_queue_pair_setup(
+				TEST_CDEV_ID, TEST_CDEV_QP_ID_2, &qp_conf,
+				rte_cryptodev_socket_id(TEST_CDEV_ID)),
+				"Failed to setup queue pair %u on cryptodev %u\n",
+				TEST_CDEV_QP_ID_2, TEST_CDEV_ID);
+		cdev_nb_qps = 2;
+	}
 
 	return TEST_SUCCESS;
 }
@@ -1589,6 +1944,10 @@ static struct unit_test_suite functional_testsuite = {
 				test_crypto_adapter_stop,
 				test_sessionless_with_op_forward_mode),
 
+		TEST_CASE_ST(test_crypto_adapter_conf_op_forward_mode,
+				test_crypto_adapter_stop,
+				test_ordered_with_op_forward_mode),
+
 		TEST_CASE_ST(test_crypto_adapter_conf_op_new_mode,
 				test_crypto_adapter_stop,
 				test_session_with_op_new_mode),
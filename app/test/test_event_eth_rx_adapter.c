@@ -31,6 +31,8 @@ test_event_eth_rx_intr_adapter_common(void)
 #include <rte_bus_vdev.h>
 
 #include <rte_event_eth_rx_adapter.h>
+#include <rte_eth_ring.h>
+#include <rte_service.h>
 
 #define MAX_NUM_RX_QUEUE	64
 #define NB_MBUFS		(8192 * num_ports * MAX_NUM_RX_QUEUE)
@@ -654,6 +656,175 @@ adapter_queue_stats_test(void)
 	return TEST_SUCCESS;
 }
 
+#define TEST_FLOW_VEC_INST_ID	1
+#define TEST_FLOW_VEC_BUCKETS	4
+#define TEST_FLOW_VEC_SZ	4
+
+/* Push mbufs with distinct RSS hashes through a software adapter using flow
+ * vectors, each vector must hold a single bucket and carry its flow ID.
+ */
+static int
+adapter_flow_vector_buckets(void)
+{
+	struct rte_mbuf *mbufs[TEST_FLOW_VEC_BUCKETS * TEST_FLOW_VEC_SZ];
+	struct rte_event_eth_rx_adapter_queue_conf queue_config = {0};
+	uint16_t nb_vectors[TEST_FLOW_VEC_BUCKETS] = {0};
+	struct rte_event_dev_config config = {0};
+	struct rte_event_port_conf port_conf;
+	struct rte_event_dev_info dev_info;
+	struct rte_mempool *vector_mp;
+	uint32_t rxa_sid, sched_sid;
+	uint32_t flow_id, bucket;
+	struct rte_event ev;
+	struct rte_ring *r;
+	uint16_t i, j, n;
+	int eth_port;
+	int dev_id;
+	int err;
+
+	err = rte_vdev_init("event_sw_flow_vec", NULL);
+	TEST_ASSERT(err == 0, "Failed to create event_sw. err=%d", err);
+	dev_id = rte_event_dev_get_dev_id("event_sw_flow_vec");
+	TEST_ASSERT(dev_id >= 0, "Failed to get event_sw id");
+
+	err = rte_event_dev_info_get(dev_id, &dev_info);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	config.nb_event_queues = 1;
+	config.nb_event_ports = 1;
+	config.nb_event_queue_flows = dev_info.max_event_queue_flows;
+	config.nb_event_port_dequeue_depth =
+			dev_info.max_event_port_dequeue_depth;
+	config.nb_event_port_enqueue_depth =
+			dev_info.max_event_port_enqueue_depth;
+	config.nb_events_limit = dev_info.max_num_events;
+	err = rte_event_dev_configure(dev_id, &config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_queue_setup(dev_id, 0, NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_port_setup(dev_id, 0, NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_port_link(dev_id, 0, NULL, NULL, 0);
+	TEST_ASSERT(err == 1, "Expected 1 got %d", err);
+
+	r = rte_ring_create("test_flow_vec_ring", RTE_DIM(mbufs) * 2,
+			    rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT(r != NULL, "Failed to create ring");
+	eth_port = rte_eth_from_ring(r);
+	TEST_ASSERT(eth_port >= 0, "Failed to create ring port");
+
+	vector_mp = rte_event_vector_pool_create("test_flow_vec_mp",
+						 4 * TEST_FLOW_VEC_BUCKETS, 0,
+						 TEST_FLOW_VEC_SZ,
+						 rte_socket_id());
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+
+	err = rte_event_port_default_conf_get(dev_id, 0, &port_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_create(TEST_FLOW_VEC_INST_ID, dev_id,
+					      &port_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.servicing_weight = 1;
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR |
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW;
+	queue_config.vector_sz = TEST_FLOW_VEC_SZ;
+	queue_config.vector_timeout_ns = 1E8;
+	queue_config.vector_mp = vector_mp;
+	queue_config.vector_flow_buckets = TEST_FLOW_VEC_BUCKETS;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_FLOW_VEC_INST_ID,
+						 eth_port, 0, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_FLOW_VEC_INST_ID,
+						      &rxa_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_dev_service_id_get(dev_id, &sched_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	rte_service_runstate_set(rxa_sid, 1);
+	rte_service_set_runstate_mapped_check(rxa_sid, 0);
+	rte_service_runstate_set(sched_sid, 1);
+	rte_service_set_runstate_mapped_check(sched_sid, 0);
+
+	err = rte_event_dev_start(dev_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_start(TEST_FLOW_VEC_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* The mbufs of all the buckets share the low RSS hash bits, as the
+	 * mbufs of an Rx queue do.
+	 */
+	err = rte_pktmbuf_alloc_bulk(default_params.mp, mbufs, RTE_DIM(mbufs));
+	TEST_ASSERT(err == 0, "Failed to allocate mbufs");
+	for (i = 0; i < RTE_DIM(mbufs); i++) {
+		bucket = i % TEST_FLOW_VEC_BUCKETS;
+		mbufs[i]->ol_flags |= RTE_MBUF_F_RX_RSS_HASH;
+		mbufs[i]->hash.rss = bucket << 30 | (uint32_t)i << 16 | 0x5a;
+	}
+	n = rte_ring_enqueue_burst(r, (void **)mbufs, RTE_DIM(mbufs), NULL);
+	TEST_ASSERT(n == RTE_DIM(mbufs), "Expected %u got %u",
+		    (unsigned int)RTE_DIM(mbufs), n);
+
+	for (i = 0, n = 0; i < 64 && n < TEST_FLOW_VEC_BUCKETS; i++) {
+		rte_service_run_iter_on_app_lcore(rxa_sid, 1);
+		rte_service_run_iter_on_app_lcore(sched_sid, 1);
+		if (!rte_event_dequeue_burst(dev_id, 0, &ev, 1, 0))
+			continue;
+
+		TEST_ASSERT(ev.event_type ==
+			    RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR,
+			    "Expected a vector event got type %u",
+			    ev.event_type);
+		TEST_ASSERT(ev.vec->nb_elem == TEST_FLOW_VEC_SZ,
+			    "Expected %u mbufs got %u", TEST_FLOW_VEC_SZ,
+			    ev.vec->nb_elem);
+
+		bucket = ev.vec->mbufs[0]->hash.rss >> 30;
+		for (j = 1; j < ev.vec->nb_elem; j++)
+			TEST_ASSERT(ev.vec->mbufs[j]->hash.rss >> 30 == bucket,
+				    "Vector holds the buckets %u and %u",
+				    bucket, ev.vec->mbufs[j]->hash.rss >> 30);
+
+		/* Default flow ID of the queue, with the bucket index in the
+		 * high flow ID bits.
+		 */
+		flow_id = (eth_port & 0xFF) << 12;
+		flow_id ^= bucket << (20 - rte_log2_u32(TEST_FLOW_VEC_BUCKETS));
+		TEST_ASSERT(ev.flow_id == flow_id,
+			    "Expected flow ID 0x%x got 0x%x", flow_id,
+			    ev.flow_id);
+
+		nb_vectors[bucket]++;
+		n++;
+		rte_pktmbuf_free_bulk(ev.vec->mbufs, ev.vec->nb_elem);
+		rte_mempool_put(rte_mempool_from_obj(ev.vec), ev.vec);
+	}
+
+	for (i = 0; i < TEST_FLOW_VEC_BUCKETS; i++)
+		TEST_ASSERT(nb_vectors[i] == 1, "Bucket %u: expected 1 vector got %u",
+			    i, nb_vectors[i]);
+
+	rte_event_eth_rx_adapter_stop(TEST_FLOW_VEC_INST_ID);
+	err = rte_event_eth_rx_adapter_queue_del(TEST_FLOW_VEC_INST_ID,
+						 eth_port, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_free(TEST_FLOW_VEC_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_service_runstate_set(rxa_sid, 0);
+	rte_service_runstate_set(sched_sid, 0);
+	rte_event_dev_stop(dev_id);
+	rte_event_dev_close(dev_id);
+	rte_vdev_uninit("event_sw_flow_vec");
+	rte_eth_dev_close(eth_port);
+	rte_ring_free(r);
+	rte_mempool_free(vector_mp);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_create_free(void)
 {
@@ -819,6 +990,84 @@ adapter_queue_add_del(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_queue_flow_vector(void)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config = {0};
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_mempool *vector_mp;
+	struct rte_event ev = {0};
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	/* Flow vectors without event vectors */
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW;
+	queue_config.vector_flow_buckets = 4;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						 -1, &queue_config);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) ||
+	    (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT))
+		return TEST_SKIPPED;
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+							 TEST_ETHDEV_ID,
+							 &limits);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vector_mp = rte_event_vector_pool_create("test_flow_vec_pool", 512, 0,
+						 limits.min_sz, rte_socket_id());
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR |
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW;
+	queue_config.vector_sz = limits.min_sz;
+	queue_config.vector_timeout_ns = limits.min_timeout_ns;
+	queue_config.vector_mp = vector_mp;
+
+	/* Bucket count not a power of 2 */
+	queue_config.vector_flow_buckets = 3;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						 -1, &queue_config);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	queue_config.vector_flow_buckets = 4;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						 -1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	memset(&queue_config, 0, sizeof(queue_config));
+	err = rte_event_eth_rx_adapter_queue_conf_get(TEST_INST_ID,
+						      TEST_ETHDEV_ID, 0,
+						      &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(queue_config.rx_queue_flags &
+		    RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW,
+		    "Flow vector flag not set");
+	TEST_ASSERT(queue_config.vector_flow_buckets == 4,
+		    "Expected 4 got %u", queue_config.vector_flow_buckets);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						 -1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(vector_mp);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_multi_eth_add_del(void)
 {
@@ -1197,6 +1446,100 @@ adapter_pollq_instance_get(void)
 	return TEST_SUCCESS;
 }
 
+/* Move an adaptive queue to interrupt mode and back to adaptive polling */
+static int
+adapter_adaptive_queue_add_del(void)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config = {0};
+	struct rte_event_eth_rx_adapter_queue_conf conf;
+	uint32_t cap;
+	int err;
+
+	if (!default_params.rx_intr_port_inited)
+		return TEST_SKIPPED;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+						&cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)
+		return TEST_SKIPPED;
+
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.ev.priority = 0;
+
+	/* poll -> adaptive */
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR;
+	queue_config.servicing_weight = 1;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						 0, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_conf_get(TEST_INST_ID,
+						      TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	if (!(conf.rx_queue_flags &
+	      RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR)) {
+		/* The queue shares its interrupt vector */
+		rte_event_eth_rx_adapter_queue_del(TEST_INST_ID,
+						   TEST_ETHDEV_ID, -1);
+		return TEST_SKIPPED;
+	}
+
+	/* adaptive -> intr, the adaptive Rx interrupt is released */
+	queue_config.rx_queue_flags = 0;
+	queue_config.servicing_weight = 0;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						 0, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_conf_get(TEST_INST_ID,
+						      TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(!(conf.rx_queue_flags &
+		      RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR),
+		    "Interrupt mode queue still adaptive");
+	TEST_ASSERT(conf.servicing_weight == 0, "Expected 0 got %u",
+		    conf.servicing_weight);
+
+	/* intr -> adaptive, the Rx interrupt is registered again */
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR;
+	queue_config.servicing_weight = 1;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						 0, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_conf_get(TEST_INST_ID,
+						      TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(conf.rx_queue_flags &
+		    RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR,
+		    "Polled queue not adaptive");
+	TEST_ASSERT(conf.servicing_weight == 1, "Expected 1 got %u",
+		    conf.servicing_weight);
+
+	/* adaptive -> poll */
+	queue_config.rx_queue_flags = 0;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						 0, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_conf_get(TEST_INST_ID,
+						      TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(!(conf.rx_queue_flags &
+		      RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR),
+		    "Polled queue still adaptive");
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						 -1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_intrq_instance_get(void)
 {
@@ -1405,6 +1748,36 @@ adapter_get_set_params(void)
 		    "Expected %u got %u",
 		    in_params.max_nb_rx, out_params.max_nb_rx);
 
+	/* Case 7: Set adaptive_idle_polls = 64 */
+	in_params.adaptive_idle_polls = 64;
+
+	err = rte_event_eth_rx_adapter_runtime_params_set(TEST_INST_ID,
+							  &in_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_runtime_params_get(TEST_INST_ID,
+							  &out_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(in_params.adaptive_idle_polls ==
+		    out_params.adaptive_idle_polls,
+		    "Expected %u got %u",
+		    in_params.adaptive_idle_polls,
+		    out_params.adaptive_idle_polls);
+
+	/* Case 8: Set adaptive_idle_polls = 0, the default is restored */
+	in_params.adaptive_idle_polls = 0;
+
+	err = rte_event_eth_rx_adapter_runtime_params_set(TEST_INST_ID,
+							  &in_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_runtime_params_get(TEST_INST_ID,
+							  &out_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(out_params.adaptive_idle_polls != 0,
+		    "Expected non zero got %u",
+		    out_params.adaptive_idle_polls);
+
 	rc = TEST_SUCCESS;
 skip:
 	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID,
@@ -1423,6 +1796,9 @@ static struct unit_test_suite event_eth_rx_tests = {
 		TEST_CASE_ST(NULL, NULL, adapter_create_free_with_params),
 		TEST_CASE_ST(adapter_create, adapter_free,
 					adapter_queue_add_del),
+		TEST_CASE_ST(adapter_create, adapter_free,
+					adapter_queue_flow_vector),
+		TEST_CASE_ST(NULL, NULL, adapter_flow_vector_buckets),
 		TEST_CASE_ST(adapter_create, adapter_free,
 					adapter_multi_eth_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_start_stop),
@@ -1451,6 +1827,8 @@ static struct unit_test_suite event_eth_rx_intr_tests = {
 			     adapter_intr_queue_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free,
 			     adapter_intrq_instance_get),
+		TEST_CASE_ST(adapter_create, adapter_free,
+			     adapter_adaptive_queue_add_del),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
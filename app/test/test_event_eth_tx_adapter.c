@@ -44,6 +44,8 @@ test_event_eth_tx_adapter_common(void)
 #define TXA_NB_TX_WORK_DEFAULT  128
 
 #define EDEV_RETRY		0xffff
+#define NB_CONGESTED_PKTS	100
+#define CONGESTED_ITER		1000
 
 struct event_eth_tx_adapter_test_params {
 	struct rte_mempool *mp;
@@ -467,10 +469,159 @@ tx_adapter_single(uint16_t port, uint16_t tx_queue_id,
 	return -1;
 }
 
+static void
+tx_adapter_service_run(void)
+{
+	if (eid != ~0ULL)
+		rte_service_run_iter_on_app_lcore(eid, 0);
+	rte_service_run_iter_on_app_lcore(tid, 0);
+}
+
+static int
+tx_adapter_ev_enqueue(struct rte_event *ev)
+{
+	unsigned int l = 0;
+
+	while (rte_event_enqueue_burst(TEST_DEV_ID, 0, ev, 1) != 1) {
+		l++;
+		if (l > EDEV_RETRY)
+			break;
+	}
+	TEST_ASSERT(l < EDEV_RETRY, "Unable to enqueue to eventdev");
+
+	return 0;
+}
+
+/* Transmit to a Tx queue whose ring is full in back-pressure mode, the
+ * packets must be kept until the ring is drained, then sent in order.
+ * With vec_pool set, the packets are sent in a single event vector
+ * larger than the room for the kept packets.
+ */
+static int
+tx_adapter_congested(uint8_t ev_qid, struct rte_mbuf *bufs,
+		     struct rte_mempool *vec_pool)
+{
+	struct rte_event_eth_tx_adapter_runtime_params rt_params;
+	struct rte_event_eth_tx_adapter_stats stats;
+	struct rte_mbuf *pbufs[RING_SIZE];
+	struct rte_event_vector *vec = NULL;
+	struct rte_event ev;
+	struct rte_ring *r;
+	unsigned int l;
+	uint16_t j, n;
+	uint32_t i;
+	int err;
+
+	err = rte_event_eth_tx_adapter_runtime_params_get(TEST_INST_ID,
+							  &rt_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	rt_params.flags = RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_BACKPRESSURE;
+	err = rte_event_eth_tx_adapter_runtime_params_set(TEST_INST_ID,
+							  &rt_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Fill the ring behind the Tx queue */
+	r = default_params.r[PAIR_PORT_INDEX(0)][TEST_ETH_QUEUE_ID];
+	while (rte_ring_enqueue(r, &bufs[0]) == 0)
+		;
+
+	if (vec_pool != NULL) {
+		err = rte_mempool_get(vec_pool, (void **)&vec);
+		TEST_ASSERT(err == 0, "Failed to allocate event vector");
+		memset(vec, 0, sizeof(*vec));
+		vec->nb_elem = NB_CONGESTED_PKTS;
+		vec->attr_valid = 1;
+		vec->port = TEST_ETHDEV_ID;
+		vec->queue = TEST_ETH_QUEUE_ID;
+	}
+
+	for (i = 0; i < NB_CONGESTED_PKTS; i++) {
+		rte_pktmbuf_reset(&bufs[i]);
+		bufs[i].port = TEST_ETHDEV_ID;
+		rte_event_eth_tx_adapter_txq_set(&bufs[i], TEST_ETH_QUEUE_ID);
+		if (vec != NULL) {
+			vec->mbufs[i] = &bufs[i];
+			continue;
+		}
+
+		memset(&ev, 0, sizeof(ev));
+		ev.queue_id = ev_qid;
+		ev.op = RTE_EVENT_OP_NEW;
+		ev.event_type = RTE_EVENT_TYPE_CPU;
+		ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+		ev.mbuf = &bufs[i];
+		err = tx_adapter_ev_enqueue(&ev);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	}
+
+	if (vec != NULL) {
+		memset(&ev, 0, sizeof(ev));
+		ev.queue_id = ev_qid;
+		ev.op = RTE_EVENT_OP_NEW;
+		ev.event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+		ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+		ev.vec = vec;
+		err = tx_adapter_ev_enqueue(&ev);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	}
+
+	for (l = 0; l < CONGESTED_ITER; l++)
+		tx_adapter_service_run();
+
+	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(stats.tx_packets, 0,
+			"stats.tx_packets expected 0 got %"PRIu64,
+			stats.tx_packets);
+	TEST_ASSERT_EQUAL(stats.tx_dropped, 0,
+			"stats.tx_dropped expected 0 got %"PRIu64,
+			stats.tx_dropped);
+
+	/* Drain the ring, the kept packets go first */
+	while (rte_ring_dequeue_burst(r, (void **)pbufs, RING_SIZE, NULL))
+		;
+
+	i = 0;
+	l = 0;
+	while (i < NB_CONGESTED_PKTS && l++ < EDEV_RETRY) {
+		tx_adapter_service_run();
+
+		n = rte_eth_rx_burst(TEST_ETHDEV_PAIR_ID, TEST_ETH_QUEUE_ID,
+				     pbufs, RING_SIZE);
+		for (j = 0; j < n; j++, i++) {
+			TEST_ASSERT(i < NB_CONGESTED_PKTS,
+				    "Unexpected packet received");
+			TEST_ASSERT_EQUAL(pbufs[j], &bufs[i], "mbuf comparison"
+					  " failed expected %p received %p",
+					  &bufs[i], pbufs[j]);
+		}
+	}
+	TEST_ASSERT_EQUAL(i, NB_CONGESTED_PKTS,
+			"Expected %u packets received %u",
+			NB_CONGESTED_PKTS, i);
+
+	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(stats.tx_packets, NB_CONGESTED_PKTS,
+			"stats.tx_packets expected %u got %"PRIu64,
+			NB_CONGESTED_PKTS, stats.tx_packets);
+	TEST_ASSERT_EQUAL(stats.tx_dropped, 0,
+			"stats.tx_dropped expected 0 got %"PRIu64,
+			stats.tx_dropped);
+
+	rt_params.flags = 0;
+	err = rte_event_eth_tx_adapter_runtime_params_set(TEST_INST_ID,
+							  &rt_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return rte_event_eth_tx_adapter_stats_reset(TEST_INST_ID);
+}
+
 static int
 tx_adapter_service(void)
 {
 	struct rte_event_eth_tx_adapter_stats stats;
+	struct rte_mempool *vec_pool;
 	uint32_t i;
 	int err;
 	uint8_t ev_port, ev_qid;
@@ -630,6 +781,18 @@ tx_adapter_service(void)
 			0,
 			stats.tx_packets);
 
+	err = tx_adapter_congested(ev_qid, bufs, NULL);
+	TEST_ASSERT(err == 0, "Congested Tx queue test failed %d", err);
+
+	vec_pool = rte_event_vector_pool_create("tx_adapter_vec_pool", 1, 0,
+						NB_CONGESTED_PKTS, SOCKET0);
+	TEST_ASSERT_NOT_NULL(vec_pool, "Failed to create event vector pool");
+	err = tx_adapter_congested(ev_qid, bufs, vec_pool);
+	TEST_ASSERT(err == 0, "Congested Tx queue vector test failed %d", err);
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vec_pool), 1,
+			  "Event vector not freed");
+	rte_mempool_free(vec_pool);
+
 	err = rte_event_eth_tx_adapter_stats_get(1, &stats);
 	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
 
@@ -807,6 +970,7 @@ tx_adapter_set_get_params(void)
 	int err, rc;
 	struct rte_event_eth_tx_adapter_runtime_params in_params;
 	struct rte_event_eth_tx_adapter_runtime_params out_params;
+	uint64_t hist[RTE_EVENT_ETH_TX_ADAPTER_HIST_BUCKETS];
 
 	err = rte_event_eth_tx_adapter_queue_add(TEST_INST_ID,
 						 TEST_ETHDEV_ID,
@@ -924,6 +1088,37 @@ tx_adapter_set_get_params(void)
 	TEST_ASSERT(in_params.flush_threshold == out_params.flush_threshold,
 		    "Expected %u got %u",
 		    in_params.flush_threshold, out_params.flush_threshold);
+
+	/* Case 8: Set back-pressure, latency histogram and timed flush */
+	in_params.flags = RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_BACKPRESSURE |
+			  RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST;
+	in_params.flush_timeout_ns = 100000;
+
+	err = rte_event_eth_tx_adapter_runtime_params_set(TEST_INST_ID,
+							  &in_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_tx_adapter_runtime_params_get(TEST_INST_ID,
+							  &out_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(in_params.flags == out_params.flags,
+		    "Expected %u got %u",
+		    in_params.flags, out_params.flags);
+	TEST_ASSERT(in_params.flush_timeout_ns == out_params.flush_timeout_ns,
+		    "Expected %u got %u",
+		    in_params.flush_timeout_ns, out_params.flush_timeout_ns);
+
+	err = rte_event_eth_tx_adapter_latency_histogram_get(TEST_INST_ID,
+							     TEST_ETHDEV_ID,
+							     hist);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Case 9: Set an unknown flag */
+	in_params.flags = 0x80;
+
+	err = rte_event_eth_tx_adapter_runtime_params_set(TEST_INST_ID,
+							  &in_params);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
 	rc = TEST_SUCCESS;
 skip:
 	err = rte_event_eth_tx_adapter_queue_del(TEST_INST_ID,
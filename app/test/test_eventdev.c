@@ -20,6 +20,8 @@ test_eventdev_common(void)
 
 #else
 
+#include <rte_bitops.h>
+#include <rte_cycles.h>
 #include <rte_eventdev.h>
 #include <rte_dev.h>
 #include <rte_bus_vdev.h>
@@ -906,6 +908,49 @@ test_eventdev_timeout_ticks(void)
 	return ret;
 }
 
+#define TEST_SERVICE_IDS_MAX 16
+
+static int
+test_eventdev_service_ids_get(void)
+{
+	uint32_t service_ids[TEST_SERVICE_IDS_MAX];
+	uint32_t service_id;
+	int count, ret, i, j;
+
+	ret = rte_event_dev_service_ids_get(RTE_EVENT_MAX_DEVS, service_ids,
+					    RTE_DIM(service_ids));
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "Expected -EINVAL for invalid dev ret=%d", ret);
+	ret = rte_event_dev_service_ids_get(TEST_DEV_ID, NULL, 1);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "Expected -EINVAL for NULL array ret=%d", ret);
+
+	ret = rte_event_dev_service_id_get(TEST_DEV_ID, &service_id);
+	count = rte_event_dev_service_ids_get(TEST_DEV_ID, NULL, 0);
+	if (ret == -ESRCH) {
+		TEST_ASSERT_EQUAL(count, -ESRCH,
+				  "Expected -ESRCH without service ret=%d", count);
+		return TEST_SUCCESS;
+	}
+	TEST_ASSERT_SUCCESS(ret, "Failed to get service id");
+	TEST_ASSERT(count > 0, "Invalid service count %d", count);
+
+	/* A short array only gets the first service IDs */
+	memset(service_ids, 0xff, sizeof(service_ids));
+	ret = rte_event_dev_service_ids_get(TEST_DEV_ID, service_ids, 1);
+	TEST_ASSERT_EQUAL(ret, count, "Service count changed %d/%d", ret, count);
+	TEST_ASSERT_EQUAL(service_ids[0], service_id,
+			  "First service id %u differs from %u", service_ids[0], service_id);
+	TEST_ASSERT_EQUAL(service_ids[1], UINT32_MAX, "Service id written past the array");
+
+	count = RTE_MIN(count, TEST_SERVICE_IDS_MAX);
+	ret = rte_event_dev_service_ids_get(TEST_DEV_ID, service_ids, count);
+	TEST_ASSERT(ret >= count, "Service count changed %d/%d", ret, count);
+	for (i = 0; i < count; i++)
+		for (j = i + 1; j < count; j++)
+			TEST_ASSERT(service_ids[i] != service_ids[j],
+				    "Service id %u returned twice", service_ids[i]);
+
+	return TEST_SUCCESS;
+}
 
 static int
 test_eventdev_start_stop(void)
@@ -1446,6 +1491,8 @@ static struct unit_test_suite eventdev_common_testsuite  = {
 			test_eventdev_port_count),
 		TEST_CASE_ST(eventdev_configure_setup, NULL,
 			test_eventdev_timeout_ticks),
+		TEST_CASE_ST(NULL, NULL,
+			test_eventdev_service_ids_get),
 		TEST_CASE_ST(NULL, NULL,
 			test_eventdev_start_stop),
 		TEST_CASE_ST(eventdev_configure_setup, eventdev_stop_device,
@@ -1527,12 +1574,262 @@ test_eventdev_selftest_cn20k(void)
 	return test_eventdev_selftest_impl("event_cn20k", "");
 }
 
+#define DSW_TEST_VDEV "event_dsw_devargs"
+#define DSW_TEST_NUM_EVENTS 64
+
+static int
+test_eventdev_dsw_xstat_check(int dev_id, const char *name)
+{
+	uint64_t id, value;
+
+	value = rte_event_dev_xstats_by_name_get(dev_id, name, &id);
+	TEST_ASSERT(id != (unsigned int)-1, "Missing xstat %s", name);
+	TEST_ASSERT_EQUAL(value, 0, "Unexpected value of xstat %s", name);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_eventdev_dsw_devargs_run(int dev_id)
+{
+	struct rte_event_dev_config config = {0};
+	struct rte_event_dev_info info;
+	struct rte_event ev[DSW_TEST_NUM_EVENTS];
+	uint8_t port_id = 0;
+	int i, n, ret;
+
+	ret = rte_event_dev_info_get(dev_id, &info);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get event dev info");
+	TEST_ASSERT_EQUAL(info.max_event_ports, 4, "Wrong max ports");
+	TEST_ASSERT_EQUAL(info.max_event_queues, 2, "Wrong max queues");
+	TEST_ASSERT_EQUAL(info.max_event_queue_flows, 1 << 10,
+			"Wrong max queue flows");
+
+	config.nb_event_queues = 2;
+	config.nb_event_ports = 1;
+	config.nb_event_queue_flows = info.max_event_queue_flows * 2;
+	config.nb_events_limit = info.max_num_events;
+	config.nb_event_port_dequeue_depth = info.max_event_port_dequeue_depth;
+	config.nb_event_port_enqueue_depth = info.max_event_port_enqueue_depth;
+	config.dequeue_timeout_ns = info.min_dequeue_timeout_ns;
+	ret = rte_event_dev_configure(dev_id, &config);
+	TEST_ASSERT(ret < 0, "Configured more flows than the flow_bits devarg");
+
+	config.nb_event_queues = 3;
+	config.nb_event_queue_flows = info.max_event_queue_flows;
+	ret = rte_event_dev_configure(dev_id, &config);
+	TEST_ASSERT(ret < 0, "Configured more queues than the queues devarg");
+
+	config.nb_event_queues = 2;
+	ret = rte_event_dev_configure(dev_id, &config);
+	TEST_ASSERT_SUCCESS(ret, "Failed to configure event dev");
+
+	for (i = 0; i < 2; i++) {
+		ret = rte_event_queue_setup(dev_id, i, NULL);
+		TEST_ASSERT_SUCCESS(ret, "Failed to setup queue %d", i);
+	}
+	ret = rte_event_port_setup(dev_id, port_id, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to setup port");
+	ret = rte_event_port_link(dev_id, port_id, NULL, NULL, 0);
+	TEST_ASSERT_EQUAL(ret, 2, "Failed to link port");
+	ret = rte_event_dev_start(dev_id);
+	TEST_ASSERT_SUCCESS(ret, "Failed to start event dev");
+
+	for (i = 0; i < DSW_TEST_NUM_EVENTS; i++)
+		ev[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = i % 2,
+			.flow_id = i,
+			.sched_type = RTE_SCHED_TYPE_ATOMIC,
+			.event_type = RTE_EVENT_TYPE_CPU,
+			.u64 = i,
+		};
+	n = rte_event_enqueue_burst(dev_id, port_id, ev, DSW_TEST_NUM_EVENTS);
+	TEST_ASSERT_EQUAL(n, DSW_TEST_NUM_EVENTS, "Failed to enqueue events");
+
+	/* the events are implicitly released by the next dequeue */
+	for (n = 0, i = 0; n < DSW_TEST_NUM_EVENTS && i < 1000; i++)
+		n += rte_event_dequeue_burst(dev_id, port_id, ev,
+				DSW_TEST_NUM_EVENTS, 0);
+	TEST_ASSERT_EQUAL(n, DSW_TEST_NUM_EVENTS, "Failed to dequeue events");
+
+	/* A single port has no flow to migrate, nor to be paused for */
+	if (test_eventdev_dsw_xstat_check(dev_id,
+			"port_0_migration_latency_max") ||
+	    test_eventdev_dsw_xstat_check(dev_id, "port_0_migration_aborts") ||
+	    test_eventdev_dsw_xstat_check(dev_id, "port_0_flows_paused") ||
+	    test_eventdev_dsw_xstat_check(dev_id, "port_0_events_paused"))
+		return TEST_FAILED;
+
+	rte_event_dev_stop(dev_id);
+
+	return TEST_SUCCESS;
+}
+
+/* The events stay 1 ms in the device, their residency is counted in the
+ * histogram bucket of the delay or in a later one
+ */
+static int
+test_eventdev_dsw_latency_run(int dev_id, struct rte_mempool *mp)
+{
+	const uint64_t delay = rte_get_timer_hz() / 1000;
+	const unsigned int min_bucket = rte_fls_u64(delay);
+	char name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
+	struct rte_event ev[DSW_TEST_NUM_EVENTS];
+	struct rte_event_dev_config config = {0};
+	struct rte_event_dev_info info;
+	uint64_t id, value, total = 0;
+	unsigned int bucket;
+	uint8_t port_id = 0;
+	uint64_t start;
+	int i, j, n, ret;
+
+	ret = rte_event_dev_info_get(dev_id, &info);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get event dev info");
+
+	config.nb_event_queues = 1;
+	config.nb_event_ports = 1;
+	config.nb_event_queue_flows = info.max_event_queue_flows;
+	config.nb_events_limit = info.max_num_events;
+	config.nb_event_port_dequeue_depth = info.max_event_port_dequeue_depth;
+	config.nb_event_port_enqueue_depth = info.max_event_port_enqueue_depth;
+	config.dequeue_timeout_ns = info.min_dequeue_timeout_ns;
+	ret = rte_event_dev_configure(dev_id, &config);
+	TEST_ASSERT_SUCCESS(ret, "Failed to configure event dev");
+	ret = rte_event_queue_setup(dev_id, 0, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to setup queue");
+	ret = rte_event_port_setup(dev_id, port_id, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to setup port");
+	ret = rte_event_port_link(dev_id, port_id, NULL, NULL, 0);
+	TEST_ASSERT_EQUAL(ret, 1, "Failed to link port");
+	ret = rte_event_dev_start(dev_id);
+	TEST_ASSERT_SUCCESS(ret, "Failed to start event dev");
+
+	for (i = 0; i < DSW_TEST_NUM_EVENTS; i++) {
+		ev[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = 0,
+			.flow_id = i,
+			.sched_type = RTE_SCHED_TYPE_ATOMIC,
+			.event_type = RTE_EVENT_TYPE_ETHDEV,
+			.mbuf = rte_pktmbuf_alloc(mp),
+		};
+		TEST_ASSERT_NOT_NULL(ev[i].mbuf, "Failed to allocate mbuf");
+	}
+	n = rte_event_enqueue_burst(dev_id, port_id, ev, DSW_TEST_NUM_EVENTS);
+	TEST_ASSERT_EQUAL(n, DSW_TEST_NUM_EVENTS, "Failed to enqueue events");
+
+	start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() - start < delay)
+		;
+
+	for (n = 0, i = 0; n < DSW_TEST_NUM_EVENTS && i < 1000; i++) {
+		ret = rte_event_dequeue_burst(dev_id, port_id, ev,
+				DSW_TEST_NUM_EVENTS, 0);
+		for (j = 0; j < ret; j++)
+			rte_pktmbuf_free(ev[j].mbuf);
+		n += ret;
+	}
+	TEST_ASSERT_EQUAL(n, DSW_TEST_NUM_EVENTS, "Failed to dequeue events");
+
+	for (bucket = 0; ; bucket++) {
+		snprintf(name, sizeof(name), "queue_0_residency_hist_%u",
+			 bucket);
+		value = rte_event_dev_xstats_by_name_get(dev_id, name, &id);
+		if (id == (unsigned int)-1)
+			break;
+		TEST_ASSERT(bucket >= min_bucket || value == 0,
+			    "%" PRIu64 " events in bucket %u below %u",
+			    value, bucket, min_bucket);
+		total += value;
+	}
+	TEST_ASSERT(bucket > min_bucket, "Missing residency xstats");
+	TEST_ASSERT_EQUAL(total, DSW_TEST_NUM_EVENTS,
+			  "Expected %d events in the histogram, got %" PRIu64,
+			  DSW_TEST_NUM_EVENTS, total);
+
+	snprintf(name, sizeof(name), "port_%u_residency_hist_%u", port_id,
+		 min_bucket);
+	rte_event_dev_xstats_by_name_get(dev_id, name, &id);
+	TEST_ASSERT(id != (unsigned int)-1, "Missing xstat %s", name);
+
+	rte_event_dev_stop(dev_id);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_eventdev_dsw_latency(void)
+{
+	struct rte_mempool *mp;
+	int dev_id, ret;
+
+	if (rte_vdev_init(DSW_TEST_VDEV, "latency=1"))
+		return TEST_FAILED;
+
+	mp = rte_pktmbuf_pool_create("dsw_latency_pool", 2 * DSW_TEST_NUM_EVENTS,
+			0, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	dev_id = rte_event_dev_get_dev_id(DSW_TEST_VDEV);
+	if (mp == NULL || dev_id < 0)
+		ret = TEST_FAILED;
+	else
+		ret = test_eventdev_dsw_latency_run(dev_id, mp);
+
+	if (dev_id >= 0)
+		rte_event_dev_close(dev_id);
+	rte_vdev_uninit(DSW_TEST_VDEV);
+	rte_mempool_free(mp);
+
+	return ret;
+}
+
+static int
+test_eventdev_dsw_devargs(void)
+{
+	static const char * const invalid_args[] = {
+		"ports=0",
+		"ports=65",
+		"queues=65",
+		"flow_bits=0",
+		"flow_bits=16",
+		"migration_policy=unknown",
+		"migration_interval=1",
+		"min_source_load=101",
+	};
+	unsigned int i;
+	int dev_id, ret;
+
+	if (rte_vdev_init(DSW_TEST_VDEV,
+			"ports=4,queues=2,flow_bits=10,migration_policy=cost"))
+		return TEST_SKIPPED;
+
+	dev_id = rte_event_dev_get_dev_id(DSW_TEST_VDEV);
+	ret = dev_id < 0 ? TEST_FAILED : test_eventdev_dsw_devargs_run(dev_id);
+
+	if (dev_id >= 0)
+		rte_event_dev_close(dev_id);
+	rte_vdev_uninit(DSW_TEST_VDEV);
+	if (ret != TEST_SUCCESS)
+		return ret;
+
+	for (i = 0; i < RTE_DIM(invalid_args); i++) {
+		if (rte_vdev_init(DSW_TEST_VDEV, invalid_args[i]) == 0) {
+			rte_vdev_uninit(DSW_TEST_VDEV);
+			printf("Accepted invalid devarg %s\n", invalid_args[i]);
+			return TEST_FAILED;
+		}
+	}
+
+	return test_eventdev_dsw_latency();
+}
+
 #endif /* !RTE_EXEC_ENV_WINDOWS */
 
 REGISTER_FAST_TEST(eventdev_common_autotest, true, true, test_eventdev_common);
 
 #ifndef RTE_EXEC_ENV_WINDOWS
 REGISTER_FAST_TEST(eventdev_selftest_sw, true, true, test_eventdev_selftest_sw);
+REGISTER_FAST_TEST(eventdev_dsw_devargs_autotest, true, true, test_eventdev_dsw_devargs);
 REGISTER_DRIVER_TEST(eventdev_selftest_octeontx, test_eventdev_selftest_octeontx);
 REGISTER_DRIVER_TEST(eventdev_selftest_dpaa2, test_eventdev_selftest_dpaa2);
 REGISTER_DRIVER_TEST(eventdev_selftest_dlb2, test_eventdev_selftest_dlb2);
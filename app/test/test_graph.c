@@ -886,6 +886,125 @@ test_graph_walk(void)
 	return 0;
 }
 
+/* Check the histograms of a node against its statistics since the reset */
+static int
+test_graph_node_histogram_check(rte_node_t id, uint64_t calls, uint64_t objs)
+{
+	struct rte_node_histogram hist;
+	uint64_t nb_objs = 0, nb_cycles = 0, min = 0, max = 0;
+	int i;
+
+	if (rte_graph_node_histogram_get(graph_id, id, &hist) < 0) {
+		printf("Histogram get failed\n");
+		return -1;
+	}
+
+	/* Bucket i > 0 counts the calls with [2^(i-1), 2^i - 1] objects */
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+		nb_objs += hist.objs[i];
+		nb_cycles += hist.cycles[i];
+		if (i == 0)
+			continue;
+		min += hist.objs[i] << (i - 1);
+		max += hist.objs[i] * ((UINT64_C(1) << i) - 1);
+	}
+	/* The last bucket has no upper bound */
+	if (hist.objs[RTE_GRAPH_HIST_BUCKETS - 1] != 0)
+		max = UINT64_MAX;
+
+	if (nb_objs != calls || nb_cycles != calls || objs < min || objs > max) {
+		printf("Node %u histogram calls = %" PRIu64 "/%" PRIu64
+		       ", objs = %" PRIu64 " not in [%" PRIu64 ", %" PRIu64 "]\n",
+		       id, nb_objs, nb_cycles, objs, min, max);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_graph_histogram(void)
+{
+	uint64_t walk_hist[RTE_GRAPH_HIST_BUCKETS];
+	uint64_t calls[MAX_NODES], objs[MAX_NODES];
+	struct rte_graph *graph = rte_graph_lookup("worker0");
+	test_main_t *tm = &test_main;
+	struct rte_node_histogram hist;
+	uint64_t walks = 0, nb_calls = 0;
+	struct rte_node *node;
+	int i;
+
+	if (!rte_graph_has_histogram_feature()) {
+		if (rte_graph_walk_histogram_get(graph_id, walk_hist) != -ENOTSUP) {
+			printf("Histogram available while disabled\n");
+			return -1;
+		}
+		return 0;
+	}
+
+	if (rte_graph_walk_histogram_get(graph_id, walk_hist) < 0 ||
+	    rte_graph_node_histogram_get(graph_id, tm->test_node[0].idx, &hist) < 0) {
+		printf("Histogram get failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+		walks += walk_hist[i];
+		nb_calls += hist.objs[i];
+	}
+
+	/* test_graph_walk walked the graph 5 times */
+	if (walks < 5 || nb_calls == 0) {
+		printf("Histogram walks = %" PRIu64 ", calls = %" PRIu64 "\n",
+		       walks, nb_calls);
+		return -1;
+	}
+
+	if (rte_graph_histogram_reset(graph_id) < 0 ||
+	    rte_graph_walk_histogram_get(graph_id, walk_hist) < 0) {
+		printf("Histogram reset failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+		if (walk_hist[i] != 0) {
+			printf("Histogram not cleared\n");
+			return -1;
+		}
+	}
+
+	/* Count the buckets of known walks */
+	for (i = 0; i < MAX_NODES; i++) {
+		node = rte_graph_node_get(graph_id, tm->test_node[i].idx);
+		calls[i] = node->total_calls;
+		objs[i] = node->total_objs;
+	}
+	for (i = 0; i < 8; i++)
+		rte_graph_walk(graph);
+
+	if (rte_graph_walk_histogram_get(graph_id, walk_hist) < 0) {
+		printf("Histogram get failed\n");
+		return -1;
+	}
+	walks = 0;
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++)
+		walks += walk_hist[i];
+	if (walks != 8) {
+		printf("Histogram walks = %" PRIu64 ", expected 8\n", walks);
+		return -1;
+	}
+
+	for (i = 0; i < MAX_NODES; i++) {
+		node = rte_graph_node_get(graph_id, tm->test_node[i].idx);
+		if (test_graph_node_histogram_check(tm->test_node[i].idx,
+						    node->total_calls - calls[i],
+						    node->total_objs - objs[i]) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_graph_lookup_functions(void)
 {
@@ -1054,6 +1173,7 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_graph_worker_model_set_get),
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
+		TEST_CASE(test_graph_histogram),
 		TEST_CASE(test_print_stats),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
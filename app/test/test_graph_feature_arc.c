@@ -0,0 +1,304 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include "test.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_errno.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_graph_feature_arc(void)
+{
+	printf("graph_feature_arc not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
+#include <rte_graph_worker.h>
+
+#define TEST_ARC_NAME "test_feature_arc"
+#define TEST_NB_INDEXES 2
+#define TEST_NB_OBJS 8
+#define TEST_MAX_PATH 4
+
+/* Object walking through the graph, recording the features it went through */
+struct test_obj {
+	uint16_t index;
+	uint16_t nb_path;
+	rte_node_t path[TEST_MAX_PATH];
+	uint32_t user_data;
+	bool at_end;
+};
+
+static struct test_obj test_objs[TEST_NB_OBJS];
+static struct rte_graph_feature_arc *test_arc;
+
+static uint16_t
+test_fa_source(struct rte_graph *graph, struct rte_node *node, void **objs,
+	       uint16_t nb_objs)
+{
+	void **next_stream;
+	uint16_t i;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	next_stream = rte_node_next_stream_get(graph, node, 0, TEST_NB_OBJS);
+	for (i = 0; i < TEST_NB_OBJS; i++) {
+		memset(&test_objs[i], 0, sizeof(test_objs[i]));
+		test_objs[i].index = i % TEST_NB_INDEXES;
+		next_stream[i] = &test_objs[i];
+	}
+	rte_node_next_stream_put(graph, node, 0, TEST_NB_OBJS);
+
+	return TEST_NB_OBJS;
+}
+
+static uint16_t
+test_fa_start(struct rte_graph *graph, struct rte_node *node, void **objs,
+	      uint16_t nb_objs)
+{
+	const struct rte_graph_feature_arc_fp *fp;
+	struct test_obj *obj;
+	rte_edge_t next;
+	uint16_t i;
+
+	fp = rte_graph_feature_arc_active_get(test_arc);
+	for (i = 0; i < nb_objs; i++) {
+		obj = objs[i];
+		/* Edge 0 is the end node */
+		next = 0;
+		if (fp != NULL)
+			rte_graph_feature_arc_first(fp, obj->index, &next);
+		rte_node_enqueue_x1(graph, node, next, obj);
+	}
+
+	return nb_objs;
+}
+
+static int
+test_fa_feature_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	int pos;
+
+	RTE_SET_USED(graph);
+
+	pos = rte_graph_feature_lookup(test_arc, node->name);
+	if (pos < 0)
+		return pos;
+	*(rte_graph_feature_t *)node->ctx = pos;
+
+	return 0;
+}
+
+static uint16_t
+test_fa_feature(struct rte_graph *graph, struct rte_node *node, void **objs,
+		uint16_t nb_objs)
+{
+	rte_graph_feature_t feature = *(rte_graph_feature_t *)node->ctx;
+	const struct rte_graph_feature_arc_fp *fp;
+	struct test_obj *obj;
+	uint16_t i;
+
+	fp = rte_graph_feature_arc_fp_get(test_arc);
+	for (i = 0; i < nb_objs; i++) {
+		obj = objs[i];
+		if (obj->nb_path < TEST_MAX_PATH)
+			obj->path[obj->nb_path++] = node->id;
+		obj->user_data += rte_graph_feature_data_get(fp, obj->index, feature);
+		rte_node_enqueue_x1(graph, node,
+				    rte_graph_feature_arc_next(fp, obj->index, feature), obj);
+	}
+
+	return nb_objs;
+}
+
+static uint16_t
+test_fa_end(struct rte_graph *graph, struct rte_node *node, void **objs,
+	    uint16_t nb_objs)
+{
+	uint16_t i;
+
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	for (i = 0; i < nb_objs; i++)
+		((struct test_obj *)objs[i])->at_end = true;
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_fa_source_node = {
+	.name = "test_fa_source",
+	.process = test_fa_source,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_fa_start"},
+};
+RTE_NODE_REGISTER(test_fa_source_node);
+
+static struct rte_node_register test_fa_start_node = {
+	.name = "test_fa_start",
+	.process = test_fa_start,
+	.nb_edges = 1,
+	.next_nodes = {"test_fa_end"},
+};
+RTE_NODE_REGISTER(test_fa_start_node);
+
+static struct rte_node_register test_fa_feature1_node = {
+	.name = "test_fa_feature1",
+	.process = test_fa_feature,
+	.init = test_fa_feature_init,
+};
+RTE_NODE_REGISTER(test_fa_feature1_node);
+
+static struct rte_node_register test_fa_feature2_node = {
+	.name = "test_fa_feature2",
+	.process = test_fa_feature,
+	.init = test_fa_feature_init,
+};
+RTE_NODE_REGISTER(test_fa_feature2_node);
+
+static struct rte_node_register test_fa_end_node = {
+	.name = "test_fa_end",
+	.process = test_fa_end,
+};
+RTE_NODE_REGISTER(test_fa_end_node);
+
+/* Walk the graph once and check the path of the objects of each index */
+static int
+check_walk(struct rte_graph *graph, const char * const path[TEST_NB_INDEXES][2],
+	   const uint32_t user_data[TEST_NB_INDEXES])
+{
+	struct test_obj *obj;
+	uint16_t i, j, len;
+
+	rte_graph_walk(graph);
+
+	for (i = 0; i < TEST_NB_OBJS; i++) {
+		obj = &test_objs[i];
+		TEST_ASSERT(obj->at_end, "Object %u did not reach the end node", i);
+
+		for (len = 0; len < 2 && path[obj->index][len] != NULL; len++)
+			;
+		TEST_ASSERT_EQUAL(obj->nb_path, len,
+				  "Object %u went through %u features, expected %u",
+				  i, obj->nb_path, len);
+		for (j = 0; j < len; j++)
+			TEST_ASSERT_EQUAL(obj->path[j],
+					  rte_node_from_name(path[obj->index][j]),
+					  "Object %u unexpected feature %u", i, j);
+		TEST_ASSERT_EQUAL(obj->user_data, user_data[obj->index],
+				  "Object %u unexpected user data", i);
+	}
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_graph_feature_arc(void)
+{
+	static const char *node_patterns[] = {"test_fa_*"};
+	const char * const no_path[TEST_NB_INDEXES][2] = {{NULL}, {NULL}};
+	const char * const path2[TEST_NB_INDEXES][2] = {
+		{NULL}, {"test_fa_feature2", NULL}};
+	const char * const path12[TEST_NB_INDEXES][2] = {
+		{NULL}, {"test_fa_feature1", "test_fa_feature2"}};
+	const char * const path1[TEST_NB_INDEXES][2] = {
+		{"test_fa_feature1", NULL}, {"test_fa_feature1", NULL}};
+	const uint32_t no_data[TEST_NB_INDEXES] = {0, 0};
+	struct rte_graph_param gconf;
+	struct rte_graph *graph;
+	rte_graph_t graph_id;
+	int ret = TEST_FAILED;
+
+	TEST_ASSERT_NULL(rte_graph_feature_arc_create(TEST_ARC_NAME, "unknown_node",
+			 "test_fa_end", TEST_NB_INDEXES), "Arc with unknown start node");
+	TEST_ASSERT_NULL(rte_graph_feature_arc_create(TEST_ARC_NAME, "test_fa_start",
+			 "test_fa_end", 0), "Arc without index");
+
+	test_arc = rte_graph_feature_arc_create(TEST_ARC_NAME, "test_fa_start",
+						"test_fa_end", TEST_NB_INDEXES);
+	TEST_ASSERT_NOT_NULL(test_arc, "Failed to create feature arc");
+	TEST_ASSERT_NULL(rte_graph_feature_arc_create(TEST_ARC_NAME, "test_fa_start",
+			 "test_fa_end", TEST_NB_INDEXES), "Duplicate arc created");
+	TEST_ASSERT_EQUAL(rte_graph_feature_arc_lookup(TEST_ARC_NAME), test_arc,
+			  "Arc lookup failed");
+
+	if (rte_graph_feature_add(test_arc, "test_fa_feature1") != 0 ||
+	    rte_graph_feature_add(test_arc, "test_fa_feature2") != 1) {
+		printf("Failed to add features\n");
+		goto destroy_arc;
+	}
+	if (rte_graph_feature_add(test_arc, "test_fa_feature1") != -EEXIST ||
+	    rte_graph_feature_lookup(test_arc, "test_fa_feature2") != 1 ||
+	    rte_graph_feature_lookup(test_arc, "test_fa_end") != -ENOENT) {
+		printf("Unexpected feature add or lookup result\n");
+		goto destroy_arc;
+	}
+	/* Nothing enabled yet */
+	if (rte_graph_feature_arc_active_get(test_arc) != NULL)
+		goto destroy_arc;
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = SOCKET_ID_ANY;
+	gconf.nb_node_patterns = RTE_DIM(node_patterns);
+	gconf.node_patterns = node_patterns;
+	graph_id = rte_graph_create("test_feature_arc_graph", &gconf);
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create graph: %s\n", rte_strerror(rte_errno));
+		goto destroy_arc;
+	}
+	graph = rte_graph_lookup("test_feature_arc_graph");
+
+	if (rte_graph_feature_add(test_arc, "test_fa_source") != -EBUSY) {
+		printf("Feature added after graph creation\n");
+		goto destroy_graph;
+	}
+	if (rte_graph_feature_enable(test_arc, TEST_NB_INDEXES, "test_fa_feature1",
+				     0, NULL) != -EINVAL) {
+		printf("Feature enabled on invalid index\n");
+		goto destroy_graph;
+	}
+
+	if (check_walk(graph, no_path, no_data) != TEST_SUCCESS)
+		goto destroy_graph;
+
+	if (rte_graph_feature_enable(test_arc, 1, "test_fa_feature2", 10, NULL) ||
+	    check_walk(graph, path2, (const uint32_t[]){0, 10}) != TEST_SUCCESS)
+		goto destroy_graph;
+
+	if (rte_graph_feature_enable(test_arc, 1, "test_fa_feature1", 5, NULL) ||
+	    check_walk(graph, path12, (const uint32_t[]){0, 15}) != TEST_SUCCESS)
+		goto destroy_graph;
+
+	if (rte_graph_feature_disable(test_arc, 1, "test_fa_feature2", NULL) ||
+	    rte_graph_feature_enable(test_arc, 0, "test_fa_feature1", 1, NULL) ||
+	    check_walk(graph, path1, (const uint32_t[]){1, 5}) != TEST_SUCCESS)
+		goto destroy_graph;
+
+	if (rte_graph_feature_disable(test_arc, 0, "test_fa_feature1", NULL) ||
+	    rte_graph_feature_disable(test_arc, 1, "test_fa_feature1", NULL) ||
+	    rte_graph_feature_arc_active_get(test_arc) != NULL ||
+	    check_walk(graph, no_path, no_data) != TEST_SUCCESS)
+		goto destroy_graph;
+
+	ret = TEST_SUCCESS;
+destroy_graph:
+	rte_graph_destroy(graph_id);
+destroy_arc:
+	rte_graph_feature_arc_destroy(test_arc);
+	test_arc = NULL;
+
+	return ret;
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_FAST_TEST(graph_feature_arc_autotest, true, true, test_graph_feature_arc);
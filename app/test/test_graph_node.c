@@ -0,0 +1,1126 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include "test.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_graph_node(void)
+{
+	printf("graph_node not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <rte_bus_vdev.h>
+#include <rte_cryptodev.h>
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_fib.h>
+#include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_ipsec.h>
+#include <rte_ipsec_group.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_node_acl_api.h>
+#include <rte_node_eth_api.h>
+#include <rte_node_ip4_api.h>
+#include <rte_node_ip6_api.h>
+#include <rte_node_ipsec_api.h>
+
+#define TEST_NODE_SRC_NAME "test_node_src"
+#define TEST_NODE_CLONE "test"
+#define TEST_NODE_NB_SINKS 4
+#define TEST_NODE_MAX_PKTS 64
+
+/* Objects received by a sink node on the last walk */
+struct test_node_sink {
+	uint16_t nb;
+	struct rte_mbuf *pkts[TEST_NODE_MAX_PKTS];
+};
+
+static struct test_node_sink test_sinks[TEST_NODE_NB_SINKS];
+static struct rte_mbuf *test_src_pkts[TEST_NODE_MAX_PKTS];
+static uint16_t test_src_nb;
+static struct rte_mempool *test_pool;
+static struct rte_mempool *test_indirect_pool;
+
+/* Source node sending the packets given to test_node_walk() once */
+static uint16_t
+test_node_src(struct rte_graph *graph, struct rte_node *node, void **objs,
+	      uint16_t nb_objs)
+{
+	uint16_t nb = test_src_nb;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	if (nb == 0)
+		return 0;
+
+	rte_node_enqueue(graph, node, 0, (void **)test_src_pkts, nb);
+	test_src_nb = 0;
+
+	return nb;
+}
+
+static int
+test_node_sink_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	RTE_SET_USED(graph);
+
+	/* Index of the sink is the last character of its name */
+	*(uint16_t *)node->ctx = node->name[strlen(node->name) - 1] - '0';
+
+	return 0;
+}
+
+static uint16_t
+test_node_sink(struct rte_graph *graph, struct rte_node *node, void **objs,
+	       uint16_t nb_objs)
+{
+	struct test_node_sink *sink = &test_sinks[*(uint16_t *)node->ctx];
+	uint16_t i;
+
+	RTE_SET_USED(graph);
+
+	for (i = 0; i < nb_objs && sink->nb < TEST_NODE_MAX_PKTS; i++)
+		sink->pkts[sink->nb++] = objs[i];
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_node_src_node = {
+	.name = TEST_NODE_SRC_NAME,
+	.process = test_node_src,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_node_sink0"},
+};
+RTE_NODE_REGISTER(test_node_src_node);
+
+#define TEST_NODE_SINK_REGISTER(n)					\
+	static struct rte_node_register test_node_sink##n##_node = {	\
+		.name = "test_node_sink" RTE_STR(n),			\
+		.process = test_node_sink,				\
+		.init = test_node_sink_init,				\
+	};								\
+	RTE_NODE_REGISTER(test_node_sink##n##_node)
+
+TEST_NODE_SINK_REGISTER(0);
+TEST_NODE_SINK_REGISTER(1);
+TEST_NODE_SINK_REGISTER(2);
+TEST_NODE_SINK_REGISTER(3);
+
+/* Get the clone of the tested node, creating it if needed */
+static rte_node_t
+test_node_clone(const char *node, char *clone, size_t size)
+{
+	rte_node_t id;
+
+	snprintf(clone, size, "%s-%s", node, TEST_NODE_CLONE);
+	id = rte_node_from_name(clone);
+	if (id == RTE_NODE_ID_INVALID)
+		id = rte_node_clone(rte_node_from_name(node), TEST_NODE_CLONE);
+
+	return id;
+}
+
+/*
+ * Create a graph sending the packets of the source node to a clone
+ * of the tested node, whose first edges go to the sink nodes.
+ */
+static rte_graph_t
+test_node_graph_create(const char *node, const char **sinks, uint16_t nb_sinks)
+{
+	char clone[RTE_NODE_NAMESIZE];
+	const char *node_patterns[] = {TEST_NODE_SRC_NAME, clone};
+	const char *next = clone;
+	struct rte_graph_param gconf;
+	rte_node_t id;
+
+	id = test_node_clone(node, clone, sizeof(clone));
+	if (id == RTE_NODE_ID_INVALID ||
+	    rte_node_edge_update(id, 0, sinks, nb_sinks) == RTE_EDGE_ID_INVALID ||
+	    rte_node_edge_update(rte_node_from_name(TEST_NODE_SRC_NAME), 0,
+				 &next, 1) == RTE_EDGE_ID_INVALID) {
+		printf("Failed to link %s to the test nodes\n", node);
+		return RTE_GRAPH_ID_INVALID;
+	}
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = rte_socket_id();
+	gconf.nb_node_patterns = RTE_DIM(node_patterns);
+	gconf.node_patterns = node_patterns;
+
+	return rte_graph_create("test_graph_node", &gconf);
+}
+
+/* Send packets through the graph, and collect them in the sinks */
+static void
+test_node_walk(rte_graph_t graph_id, struct rte_mbuf **pkts, uint16_t nb)
+{
+	memcpy(test_src_pkts, pkts, nb * sizeof(pkts[0]));
+	test_src_nb = nb;
+	memset(test_sinks, 0, sizeof(test_sinks));
+
+	rte_graph_walk(rte_graph_lookup(rte_graph_id_to_name(graph_id)));
+}
+
+static bool
+test_node_sink_has(uint16_t sink, struct rte_mbuf *m)
+{
+	uint16_t i;
+
+	for (i = 0; i < test_sinks[sink].nb; i++)
+		if (test_sinks[sink].pkts[i] == m)
+			return true;
+
+	return false;
+}
+
+/* Build an Ethernet IPv4 packet received on a port */
+static struct rte_mbuf *
+test_node_ip4_pkt(uint32_t dst, uint16_t port)
+{
+	struct rte_ipv4_hdr *ip;
+	struct rte_ether_hdr *eth;
+	struct rte_mbuf *m;
+
+	m = rte_pktmbuf_alloc(test_pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m, sizeof(*eth) + sizeof(*ip));
+	memset(eth, 0, sizeof(*eth) + sizeof(*ip));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip));
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(dst);
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+
+	m->port = port;
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+
+	return m;
+}
+
+/* Build an Ethernet IPv6 packet received on a port */
+static struct rte_mbuf *
+test_node_ip6_pkt(uint16_t port)
+{
+	struct rte_ipv6_hdr *ip;
+	struct rte_ether_hdr *eth;
+	struct rte_mbuf *m;
+
+	m = rte_pktmbuf_alloc(test_pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m, sizeof(*eth) + sizeof(*ip));
+	memset(eth, 0, sizeof(*eth) + sizeof(*ip));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+
+	ip = (struct rte_ipv6_hdr *)(eth + 1);
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->proto = IPPROTO_UDP;
+	ip->hop_limits = 64;
+	ip->src_addr = (struct rte_ipv6_addr)RTE_IPV6(0x2001, 0xdb8, 0, 0, 0, 0, 0, 1);
+	ip->dst_addr = (struct rte_ipv6_addr)RTE_IPV6(0x2001, 0xdb8, 0, 1, 0, 0, 0, 1);
+
+	m->port = port;
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+
+	return m;
+}
+
+/* Add a payload with a byte pattern to an IPv4 or IPv6 packet */
+static struct rte_mbuf *
+test_node_payload_add(struct rte_mbuf *m, uint16_t len)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	uint8_t *data;
+	uint16_t i;
+
+	if (m == NULL)
+		return NULL;
+
+	data = (uint8_t *)rte_pktmbuf_append(m, len);
+	if (data == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	for (i = 0; i < len; i++)
+		data[i] = i;
+
+	eth = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
+	if (eth->ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+		ip4 = (struct rte_ipv4_hdr *)(eth + 1);
+		ip4->total_length = rte_cpu_to_be_16(sizeof(*ip4) + len);
+		ip4->hdr_checksum = 0;
+		ip4->hdr_checksum = rte_ipv4_cksum(ip4);
+	} else {
+		ip6 = (struct rte_ipv6_hdr *)(eth + 1);
+		ip6->payload_len = rte_cpu_to_be_16(len);
+	}
+
+	return m;
+}
+
+/* Check the payload added by test_node_payload_add() after the headers */
+static bool
+test_node_payload_check(const struct rte_mbuf *m, uint32_t hdr_len, uint16_t len)
+{
+	const uint8_t *data;
+	uint8_t byte;
+	uint16_t i;
+
+	if (rte_pktmbuf_pkt_len(m) != hdr_len + len)
+		return false;
+
+	for (i = 0; i < len; i++) {
+		data = rte_pktmbuf_read(m, hdr_len + i, 1, &byte);
+		if (data == NULL || *data != (uint8_t)i)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * ip4_lookup_fib: longest prefix match to the next nodes, misses dropped,
+ * and routed packets sent to the ip4_forward features of their Rx port.
+ */
+static int
+test_ip4_lookup_fib(void)
+{
+	const char *sinks[] = {"test_node_sink0", "test_node_sink1", "test_node_sink2"};
+	struct rte_fib_conf conf = {
+		.type = RTE_FIB_DIR24_8,
+		.max_routes = 16,
+		.dir24_8 = {
+			.nh_sz = RTE_FIB_DIR24_8_2B,
+			.num_tbl8 = 16,
+		},
+	};
+	struct rte_graph_feature_arc *arc = NULL;
+	struct rte_mbuf *pkts[5] = {NULL};
+	rte_graph_t graph_id;
+	int ret = TEST_FAILED;
+	unsigned int i;
+
+	/* Next hops hold the next node above the 16 bits of next hop id */
+	TEST_ASSERT_EQUAL(rte_node_ip4_fib_create(rte_socket_id(), &conf), -EINVAL,
+			  "FIB with 2 bytes next hops accepted");
+	conf.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	TEST_ASSERT_SUCCESS(rte_node_ip4_fib_create(rte_socket_id(), &conf),
+			    "Failed to create FIB");
+	TEST_ASSERT_SUCCESS(rte_node_ip4_fib_route_add(RTE_IPV4(10, 0, 0, 0), 8, 1,
+			    RTE_NODE_IP4_LOOKUP_NEXT_REWRITE), "Failed to add route");
+	TEST_ASSERT_SUCCESS(rte_node_ip4_fib_route_add(RTE_IPV4(10, 1, 0, 0), 16, 2,
+			    RTE_NODE_IP4_LOOKUP_NEXT_IP4_LOCAL), "Failed to add route");
+
+	/* Packets of port 1 go to a feature between lookup and rewrite */
+	if (rte_graph_feature_arc_lookup(RTE_NODE_IP4_FORWARD_FEATURE_ARC) == NULL) {
+		arc = rte_graph_feature_arc_create(RTE_NODE_IP4_FORWARD_FEATURE_ARC,
+						   "ip4_lookup", "test_node_sink1", 2);
+		TEST_ASSERT_NOT_NULL(arc, "Failed to create feature arc");
+		if (rte_graph_feature_arc_start_add(arc, "ip4_lookup_fib") != 0 ||
+		    rte_graph_feature_add(arc, "test_node_sink3") != 0) {
+			printf("Failed to set up feature arc\n");
+			goto destroy_arc;
+		}
+	}
+
+	graph_id = test_node_graph_create("ip4_lookup_fib", sinks, RTE_DIM(sinks));
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create graph: %s\n", rte_strerror(rte_errno));
+		goto destroy_arc;
+	}
+
+	pkts[0] = test_node_ip4_pkt(RTE_IPV4(10, 2, 3, 4), 0);
+	pkts[1] = test_node_ip4_pkt(RTE_IPV4(10, 1, 2, 3), 0);
+	pkts[2] = test_node_ip4_pkt(RTE_IPV4(20, 1, 1, 1), 0);
+	pkts[3] = test_node_ip4_pkt(RTE_IPV4(10, 2, 3, 5), 1);
+	pkts[4] = test_node_ip4_pkt(RTE_IPV4(10, 1, 2, 4), 1);
+	for (i = 0; i < RTE_DIM(pkts); i++) {
+		if (pkts[i] == NULL) {
+			printf("Failed to allocate packets\n");
+			goto free_pkts;
+		}
+	}
+
+	test_node_walk(graph_id, pkts, RTE_DIM(pkts));
+	if (!test_node_sink_has(1, pkts[0]) || !test_node_sink_has(0, pkts[1]) ||
+	    !test_node_sink_has(2, pkts[2]) || !test_node_sink_has(1, pkts[3]) ||
+	    !test_node_sink_has(0, pkts[4])) {
+		printf("Unexpected lookup result without feature\n");
+		goto free_pkts;
+	}
+
+	if (arc != NULL) {
+		if (rte_graph_feature_enable(arc, 1, "test_node_sink3", 0, NULL) != 0)
+			goto free_pkts;
+		test_node_walk(graph_id, pkts, RTE_DIM(pkts));
+		/* Only the packet routed to rewrite on port 1 goes to the feature */
+		if (!test_node_sink_has(1, pkts[0]) || !test_node_sink_has(0, pkts[1]) ||
+		    !test_node_sink_has(2, pkts[2]) || !test_node_sink_has(3, pkts[3]) ||
+		    !test_node_sink_has(0, pkts[4]) || test_sinks[3].nb != 1) {
+			printf("Unexpected lookup result with feature\n");
+			goto free_pkts;
+		}
+	}
+
+	ret = TEST_SUCCESS;
+free_pkts:
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		rte_pktmbuf_free(pkts[i]);
+	rte_graph_destroy(graph_id);
+destroy_arc:
+	if (arc != NULL)
+		rte_graph_feature_arc_destroy(arc);
+
+	return ret;
+}
+
+/* ip4_acl: default next and rule next edges checked against the edge count */
+static int
+test_ip4_acl_rules_set(void)
+{
+	struct rte_node_ip4_acl_rule rule;
+	rte_edge_t nb_edges;
+
+	nb_edges = rte_node_edge_count(rte_node_from_name("ip4_acl"));
+	TEST_ASSERT(nb_edges >= RTE_NODE_IP4_ACL_NEXT_MAX, "Missing ip4_acl edges");
+
+	memset(&rule, 0, sizeof(rule));
+	rule.data.category_mask = 1;
+	rule.data.priority = 1;
+	rule.data.userdata = RTE_NODE_ACL_USERDATA(nb_edges);
+
+	TEST_ASSERT_EQUAL(rte_node_ip4_acl_rules_set(NULL, 0, nb_edges, NULL), -EINVAL,
+			  "Default next out of range accepted");
+	TEST_ASSERT_EQUAL(rte_node_ip4_acl_rules_set(&rule, 1, RTE_NODE_IP4_ACL_NEXT_PERMIT,
+						     NULL), -EINVAL,
+			  "Rule next out of range accepted");
+	rule.data.userdata = RTE_NODE_ACL_USERDATA(nb_edges - 1);
+	TEST_ASSERT_SUCCESS(rte_node_ip4_acl_rules_set(&rule, 1, RTE_NODE_IP4_ACL_NEXT_PERMIT,
+						       NULL), "Failed to set rule to last edge");
+	TEST_ASSERT_SUCCESS(rte_node_ip4_acl_rules_set(NULL, 0, RTE_NODE_IP4_ACL_NEXT_PERMIT,
+						       NULL), "Failed to remove rules");
+
+	return TEST_SUCCESS;
+}
+
+#define TEST_NODE_FRAG_MTU 576
+#define TEST_NODE_FRAG_PAYLOAD 1400
+
+/* Reassembly tables of the ip4_reassembly and ip6_reassembly clones */
+static struct rte_ip_frag_tbl *test_frag_tbl[2];
+static struct rte_ip_frag_death_row test_frag_dr[2];
+
+/* Configure the reassembly clone of the IPv4 or IPv6 test once */
+static int
+test_node_reassembly_configure(bool ip6, rte_node_t id)
+{
+	struct rte_node_ip4_reassembly_cfg cfg4;
+	struct rte_node_ip6_reassembly_cfg cfg6;
+
+	if (test_frag_tbl[ip6] != NULL)
+		return 0;
+
+	test_frag_tbl[ip6] = rte_ip_frag_table_create(16, 4, 64, rte_get_tsc_hz(),
+						      rte_socket_id());
+	if (test_frag_tbl[ip6] == NULL)
+		return -ENOMEM;
+
+	if (ip6) {
+		cfg6.tbl = test_frag_tbl[ip6];
+		cfg6.dr = &test_frag_dr[ip6];
+		cfg6.node_id = id;
+		return rte_node_ip6_reassembly_configure(&cfg6, 1);
+	}
+
+	cfg4.tbl = test_frag_tbl[ip6];
+	cfg4.dr = &test_frag_dr[ip6];
+	cfg4.node_id = id;
+	return rte_node_ip4_reassembly_configure(&cfg4, 1);
+}
+
+/*
+ * ip4_fragment or ip6_fragment: packets longer than the MTU of the port
+ * fragmented, all the packets passing through without MTU, and packets
+ * with the don't fragment flag dropped. The fragments are then given to
+ * ip4_reassembly or ip6_reassembly, giving back the packet.
+ */
+static int
+test_node_fragment_reassembly(bool ip6)
+{
+	const char *frag_sinks[] = {"test_node_sink0"};
+	const char *reass_sinks[] = {"test_node_sink0", "test_node_sink1"};
+	const char *frag_node = ip6 ? "ip6_fragment" : "ip4_fragment";
+	const char *reass_node = ip6 ? "ip6_reassembly" : "ip4_reassembly";
+	const uint32_t hdr_len = sizeof(struct rte_ether_hdr) +
+		(ip6 ? sizeof(struct rte_ipv6_hdr) : sizeof(struct rte_ipv4_hdr));
+	struct rte_node_ip4_fragment_cfg cfg4 = {
+		.direct_pool = test_pool,
+		.indirect_pool = test_indirect_pool,
+		.socket_id = rte_socket_id(),
+	};
+	struct rte_node_ip6_fragment_cfg cfg6 = {
+		.direct_pool = test_pool,
+		.indirect_pool = test_indirect_pool,
+		.socket_id = rte_socket_id(),
+	};
+	struct rte_mbuf *frags[TEST_NODE_MAX_PKTS];
+	struct rte_mbuf *pkts[4] = {NULL};
+	struct rte_mbuf *out = NULL;
+	struct rte_graph_feature_arc *arc;
+	char clone[RTE_NODE_NAMESIZE];
+	struct rte_ipv4_hdr *ip4;
+	rte_graph_t graph_id;
+	uint16_t nb_pkts, nb_frags = 0, i;
+	int ret = TEST_FAILED;
+	rte_node_t id;
+
+	TEST_ASSERT_SUCCESS(ip6 ? rte_node_ip6_fragment_configure(&cfg6, 1) :
+			    rte_node_ip4_fragment_configure(&cfg4, 1),
+			    "Failed to configure fragment pools");
+
+	/* The clone is the feature, the end node of the ports is a sink */
+	arc = rte_graph_feature_arc_create(ip6 ? RTE_NODE_IP6_OUTPUT_FEATURE_ARC :
+					   RTE_NODE_IP4_OUTPUT_FEATURE_ARC,
+					   ip6 ? "ip6_rewrite" : "ip4_rewrite",
+					   "test_node_sink1", 2);
+	TEST_ASSERT_NOT_NULL(arc, "Failed to create feature arc");
+	if (test_node_clone(frag_node, clone, sizeof(clone)) == RTE_NODE_ID_INVALID ||
+	    rte_graph_feature_add(arc, clone) < 0) {
+		printf("Failed to set up feature arc\n");
+		goto destroy_arc;
+	}
+
+	graph_id = test_node_graph_create(frag_node, frag_sinks, RTE_DIM(frag_sinks));
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create graph: %s\n", rte_strerror(rte_errno));
+		goto destroy_arc;
+	}
+
+	/* No MTU on port 0 */
+	if (rte_graph_feature_enable(arc, 0, clone, 0, NULL) != 0 ||
+	    rte_graph_feature_enable(arc, 1, clone, TEST_NODE_FRAG_MTU, NULL) != 0) {
+		printf("Failed to enable feature\n");
+		goto destroy_graph;
+	}
+
+	/* Long packet on port 0, short and long ones on port 1 */
+	nb_pkts = ip6 ? 3 : 4;
+	for (i = 0; i < nb_pkts; i++) {
+		pkts[i] = ip6 ? test_node_ip6_pkt(i == 0 ? 0 : 1) :
+			  test_node_ip4_pkt(RTE_IPV4(10, 0, 0, i), i == 0 ? 0 : 1);
+		if (i != 1)
+			pkts[i] = test_node_payload_add(pkts[i], TEST_NODE_FRAG_PAYLOAD);
+		if (pkts[i] == NULL) {
+			printf("Failed to allocate packets\n");
+			goto free_pkts;
+		}
+	}
+	/* IPv6 packets have no don't fragment flag */
+	if (!ip6) {
+		ip4 = rte_pktmbuf_mtod_offset(pkts[3], struct rte_ipv4_hdr *,
+					      sizeof(struct rte_ether_hdr));
+		ip4->fragment_offset = rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG);
+		ip4->hdr_checksum = 0;
+		ip4->hdr_checksum = rte_ipv4_cksum(ip4);
+	}
+
+	test_node_walk(graph_id, pkts, nb_pkts);
+	for (i = 0; i < test_sinks[1].nb; i++) {
+		if (test_sinks[1].pkts[i] != pkts[0] && test_sinks[1].pkts[i] != pkts[1])
+			frags[nb_frags++] = test_sinks[1].pkts[i];
+	}
+	/* The fragmented packet is released with its fragments */
+	if (!test_node_sink_has(0, pkts[2]) && !test_node_sink_has(1, pkts[2]))
+		pkts[2] = NULL;
+
+	if (!test_node_sink_has(1, pkts[0]) || !test_node_sink_has(1, pkts[1]) ||
+	    pkts[2] != NULL || nb_frags != 3 ||
+	    test_sinks[0].nb != (ip6 ? 0 : 1) || (!ip6 && !test_node_sink_has(0, pkts[3]))) {
+		printf("Unexpected fragmentation result\n");
+		goto free_pkts;
+	}
+	for (i = 0; i < nb_frags; i++) {
+		if (rte_pktmbuf_pkt_len(frags[i]) >
+		    TEST_NODE_FRAG_MTU + sizeof(struct rte_ether_hdr)) {
+			printf("Fragment longer than the MTU\n");
+			goto free_pkts;
+		}
+	}
+
+	rte_graph_destroy(graph_id);
+
+	id = test_node_clone(reass_node, clone, sizeof(clone));
+	if (id == RTE_NODE_ID_INVALID || test_node_reassembly_configure(ip6, id) != 0) {
+		printf("Failed to configure reassembly\n");
+		goto free_pkts;
+	}
+	graph_id = test_node_graph_create(reass_node, reass_sinks, RTE_DIM(reass_sinks));
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create graph: %s\n", rte_strerror(rte_errno));
+		goto free_pkts;
+	}
+
+	/* Fragments are chained to the reassembled packet, or kept in the table */
+	test_node_walk(graph_id, frags, nb_frags);
+	nb_frags = 0;
+	if (test_sinks[1].nb == 1 && test_sinks[0].nb == 0)
+		out = test_sinks[1].pkts[0];
+	if (out == NULL || !test_node_payload_check(out, hdr_len, TEST_NODE_FRAG_PAYLOAD)) {
+		printf("Unexpected reassembly result\n");
+		goto free_pkts;
+	}
+
+	ret = TEST_SUCCESS;
+free_pkts:
+	rte_pktmbuf_free(out);
+	for (i = 0; i < nb_frags; i++)
+		rte_pktmbuf_free(frags[i]);
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		rte_pktmbuf_free(pkts[i]);
+destroy_graph:
+	rte_graph_destroy(graph_id);
+destroy_arc:
+	rte_graph_feature_arc_destroy(arc);
+
+	return ret;
+}
+
+static int
+test_ip4_fragment_reassembly(void)
+{
+	return test_node_fragment_reassembly(false);
+}
+
+static int
+test_ip6_fragment_reassembly(void)
+{
+	return test_node_fragment_reassembly(true);
+}
+
+#define TEST_NODE_CRYPTODEV "crypto_null_graph_node"
+#define TEST_NODE_IPSEC_SA_ID 1
+
+/* SA of the esp_outbound test, kept by the IPsec nodes */
+static struct rte_ipsec_session test_ipsec_ss;
+/* SA of the esp_inbound test, decrypting the packets of test_ipsec_ss */
+static struct rte_ipsec_session test_ipsec_in_ss;
+/* Crypto device of the IPsec nodes, configured by the esp_outbound test */
+static int test_ipsec_dev_id = -1;
+static struct rte_mempool *test_ipsec_sess_pool;
+
+/* Tunnel SA with null algorithms, IPv4 outer header */
+static int
+test_ipsec_sa_create(struct rte_ipsec_session *ss, uint8_t dev_id,
+		     struct rte_mempool *sess_pool, bool inbound)
+{
+	static uint8_t tun_hdr[sizeof(struct rte_ether_hdr) + sizeof(struct rte_ipv4_hdr)];
+	struct rte_crypto_sym_xform auth = {
+		.type = RTE_CRYPTO_SYM_XFORM_AUTH,
+		.auth = {
+			.algo = RTE_CRYPTO_AUTH_NULL,
+			.op = RTE_CRYPTO_AUTH_OP_GENERATE,
+		},
+	};
+	struct rte_crypto_sym_xform cipher = {
+		.type = RTE_CRYPTO_SYM_XFORM_CIPHER,
+		.next = &auth,
+		.cipher = {
+			.algo = RTE_CRYPTO_CIPHER_NULL,
+			.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT,
+			.iv.offset = RTE_NODE_IPSEC_IV_OFFSET,
+		},
+	};
+	struct rte_ipsec_sa_prm prm = {
+		.ipsec_xform = {
+			.spi = TEST_NODE_IPSEC_SA_ID,
+			.direction = RTE_SECURITY_IPSEC_SA_DIR_EGRESS,
+			.proto = RTE_SECURITY_IPSEC_SA_PROTO_ESP,
+			.mode = RTE_SECURITY_IPSEC_SA_MODE_TUNNEL,
+			.tunnel.type = RTE_SECURITY_IPSEC_TUNNEL_IPV4,
+		},
+		.tun = {
+			.hdr_len = sizeof(tun_hdr),
+			.hdr_l3_off = sizeof(struct rte_ether_hdr),
+			.next_proto = IPPROTO_IPIP,
+			.hdr = tun_hdr,
+		},
+		.crypto_xform = &cipher,
+	};
+	struct rte_ether_hdr *eth = (struct rte_ether_hdr *)tun_hdr;
+	struct rte_ipv4_hdr *ip = (struct rte_ipv4_hdr *)(eth + 1);
+	int sz;
+
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_ESP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(172, 16, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(172, 16, 0, 2));
+
+	/* Inbound SAs verify then decrypt */
+	if (inbound) {
+		prm.ipsec_xform.direction = RTE_SECURITY_IPSEC_SA_DIR_INGRESS;
+		prm.crypto_xform = &auth;
+		auth.next = &cipher;
+		auth.auth.op = RTE_CRYPTO_AUTH_OP_VERIFY;
+		cipher.next = NULL;
+		cipher.cipher.op = RTE_CRYPTO_CIPHER_OP_DECRYPT;
+	}
+
+	sz = rte_ipsec_sa_size(&prm);
+	if (sz <= 0)
+		return -EINVAL;
+
+	memset(ss, 0, sizeof(*ss));
+	ss->sa = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (ss->sa == NULL)
+		return -ENOMEM;
+
+	ss->type = RTE_SECURITY_ACTION_TYPE_NONE;
+	ss->crypto.dev_id = dev_id;
+	ss->crypto.ses = rte_cryptodev_sym_session_create(dev_id, prm.crypto_xform,
+							 sess_pool);
+	if (ss->crypto.ses == NULL)
+		return -rte_errno;
+
+	if (rte_ipsec_sa_init(ss->sa, &prm, sz) != sz)
+		return -EINVAL;
+
+	return rte_ipsec_session_prepare(ss);
+}
+
+/*
+ * esp_outbound: IPv4 and IPv6 packets of the port submitted to the crypto
+ * device with the SA of the feature user data, the other packets dropped,
+ * and the packets processed after the crypto device sent to the next feature.
+ */
+static int
+test_esp_outbound(void)
+{
+	const char *sinks[] = {"test_node_sink0"};
+	struct rte_node_ipsec_conf ipsec_conf = {
+		.cdev_id = UINT8_MAX,
+		.nb_ops = 64,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct rte_cryptodev_config dev_conf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_queue_pairs = 1,
+	};
+	struct rte_cryptodev_qp_conf qp_conf = {
+		.nb_descriptors = 64,
+	};
+	struct rte_graph_feature_arc *arc = NULL;
+	struct rte_crypto_op *cop[2];
+	struct rte_ipsec_group grp[2];
+	struct rte_mbuf *done[2];
+	struct rte_mbuf *pkts[3] = {NULL};
+	char clone[RTE_NODE_NAMESIZE];
+	struct rte_mempool *sess_pool;
+	const struct rte_ipv4_hdr *ip;
+	rte_graph_t graph_id;
+	int ret = TEST_FAILED;
+	uint16_t nb, nb_grp;
+	unsigned int i;
+	int dev_id, bit;
+
+	rte_vdev_init(TEST_NODE_CRYPTODEV, NULL);
+	dev_id = rte_cryptodev_get_dev_id(TEST_NODE_CRYPTODEV);
+	if (dev_id < 0) {
+		printf("Crypto device %s not available, skipping\n", TEST_NODE_CRYPTODEV);
+		return TEST_SKIPPED;
+	}
+
+	TEST_ASSERT_SUCCESS(rte_cryptodev_configure(dev_id, &dev_conf),
+			    "Failed to configure crypto device");
+	sess_pool = rte_cryptodev_sym_session_pool_create("test_graph_node_sess", 4,
+			rte_cryptodev_sym_get_private_session_size(dev_id), 0, 0,
+			SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(sess_pool, "Failed to create session pool");
+	qp_conf.mp_session = sess_pool;
+	TEST_ASSERT_SUCCESS(rte_cryptodev_queue_pair_setup(dev_id, 0, &qp_conf,
+			    SOCKET_ID_ANY), "Failed to set up queue pair");
+	TEST_ASSERT_SUCCESS(rte_cryptodev_start(dev_id), "Failed to start crypto device");
+
+	/* SAs are added once the nodes are configured, with the device */
+	TEST_ASSERT_SUCCESS(test_ipsec_sa_create(&test_ipsec_ss, dev_id, sess_pool, false),
+			    "Failed to create SA");
+	TEST_ASSERT_EQUAL(rte_node_ipsec_sa_add(TEST_NODE_IPSEC_SA_ID, &test_ipsec_ss),
+			  -EINVAL, "SA added before configuration");
+	TEST_ASSERT_EQUAL(rte_node_ipsec_config(NULL), -EINVAL, "NULL configuration accepted");
+	TEST_ASSERT_EQUAL(rte_node_ipsec_config(&ipsec_conf), -ENODEV,
+			  "Invalid crypto device accepted");
+	ipsec_conf.cdev_id = dev_id;
+	TEST_ASSERT_SUCCESS(rte_node_ipsec_config(&ipsec_conf), "Failed to configure nodes");
+	test_ipsec_dev_id = dev_id;
+	test_ipsec_sess_pool = sess_pool;
+	TEST_ASSERT_EQUAL(rte_node_ipsec_config(&ipsec_conf), -EBUSY,
+			  "Nodes configured twice");
+	TEST_ASSERT_SUCCESS(rte_node_ipsec_sa_add(TEST_NODE_IPSEC_SA_ID, &test_ipsec_ss),
+			    "Failed to add SA");
+	TEST_ASSERT_EQUAL(rte_node_ipsec_sa_add(TEST_NODE_IPSEC_SA_ID, &test_ipsec_ss),
+			  -EEXIST, "SA added twice");
+	TEST_ASSERT_EQUAL(rte_node_ipsec_sa_add(RTE_NODE_IPSEC_MAX_SA, &test_ipsec_ss),
+			  -EINVAL, "Outbound SA id out of range accepted");
+
+	/* The clone is the feature, the end node of the port is a sink */
+	arc = rte_graph_feature_arc_create(RTE_NODE_IP4_OUTPUT_FEATURE_ARC, "ip4_rewrite",
+					   "test_node_sink1", 1);
+	TEST_ASSERT_NOT_NULL(arc, "Failed to create feature arc");
+	if (test_node_clone("esp_outbound", clone, sizeof(clone)) == RTE_NODE_ID_INVALID ||
+	    rte_graph_feature_add(arc, clone) < 0) {
+		printf("Failed to set up feature arc\n");
+		goto destroy_arc;
+	}
+
+	graph_id = test_node_graph_create("esp_outbound", sinks, RTE_DIM(sinks));
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create graph: %s\n", rte_strerror(rte_errno));
+		goto destroy_arc;
+	}
+	if (rte_graph_feature_enable(arc, 0, clone, TEST_NODE_IPSEC_SA_ID, NULL) != 0) {
+		printf("Failed to enable feature\n");
+		goto destroy_graph;
+	}
+
+	pkts[0] = test_node_ip4_pkt(RTE_IPV4(10, 0, 0, 1), 0);
+	pkts[1] = test_node_ip6_pkt(0);
+	pkts[2] = test_node_ip4_pkt(RTE_IPV4(10, 0, 0, 2), 0);
+	for (i = 0; i < RTE_DIM(pkts); i++) {
+		if (pkts[i] == NULL) {
+			printf("Failed to allocate packets\n");
+			goto free_pkts;
+		}
+	}
+	rte_pktmbuf_mtod(pkts[2], struct rte_ether_hdr *)->ether_type =
+		rte_cpu_to_be_16(RTE_ETHER_TYPE_ARP);
+
+	/* IP packets are enqueued to the crypto device, others dropped */
+	test_node_walk(graph_id, pkts, RTE_DIM(pkts));
+	if (test_sinks[0].nb != 1 || !test_node_sink_has(0, pkts[2]) ||
+	    test_sinks[1].nb != 0) {
+		printf("Unexpected esp_outbound result\n");
+		goto free_pkts;
+	}
+
+	/* Finalize the packets like ipsec_crypto_poll */
+	nb = 0;
+	for (i = 0; i < 100 && nb < RTE_DIM(cop); i++)
+		nb += rte_cryptodev_dequeue_burst(dev_id, 0, &cop[nb], RTE_DIM(cop) - nb);
+	if (nb != RTE_DIM(cop)) {
+		printf("Crypto operations not completed\n");
+		goto free_pkts;
+	}
+	nb_grp = rte_ipsec_pkt_crypto_group((const struct rte_crypto_op **)(uintptr_t)cop,
+					    done, grp, nb);
+	for (i = 0; i < nb; i++)
+		rte_crypto_op_free(cop[i]);
+	if (nb_grp != 1 || grp[0].id.ptr != &test_ipsec_ss || grp[0].cnt != nb ||
+	    rte_ipsec_pkt_process(&test_ipsec_ss, grp[0].m, nb) != nb) {
+		printf("Failed to process packets\n");
+		goto free_pkts;
+	}
+
+	bit = rte_mbuf_dynflag_lookup("rte_node_dynflag_ipsec_done", NULL);
+	for (i = 0; i < nb; i++) {
+		ip = rte_pktmbuf_mtod_offset(done[i], const struct rte_ipv4_hdr *,
+					     sizeof(struct rte_ether_hdr));
+		if (ip->next_proto_id != IPPROTO_ESP) {
+			printf("Packet not encapsulated\n");
+			goto free_pkts;
+		}
+		done[i]->ol_flags |= RTE_BIT64(bit);
+	}
+
+	/* Processed packets go to the next feature, the end node */
+	test_node_walk(graph_id, done, nb);
+	if (test_sinks[1].nb != 2 || !test_node_sink_has(1, pkts[0]) ||
+	    !test_node_sink_has(1, pkts[1]) || test_sinks[0].nb != 0) {
+		printf("Unexpected esp_outbound result after crypto\n");
+		goto free_pkts;
+	}
+
+	ret = TEST_SUCCESS;
+free_pkts:
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		rte_pktmbuf_free(pkts[i]);
+destroy_graph:
+	rte_graph_destroy(graph_id);
+destroy_arc:
+	rte_graph_feature_arc_destroy(arc);
+	rte_cryptodev_stop(dev_id);
+
+	return ret;
+}
+
+/* Encrypt a packet with the SA of the esp_outbound test */
+static int
+test_ipsec_encrypt(uint8_t dev_id, struct rte_mempool *cop_pool, struct rte_mbuf *m)
+{
+	struct rte_ipsec_group grp;
+	struct rte_crypto_op *cop;
+	unsigned int i;
+
+	if (rte_crypto_op_bulk_alloc(cop_pool, RTE_CRYPTO_OP_TYPE_SYMMETRIC, &cop, 1) == 0)
+		return -ENOMEM;
+
+	if (rte_ipsec_pkt_crypto_prepare(&test_ipsec_ss, &m, &cop, 1) != 1 ||
+	    rte_cryptodev_enqueue_burst(dev_id, 0, &cop, 1) != 1) {
+		rte_crypto_op_free(cop);
+		return -EIO;
+	}
+	for (i = 0; i < 100 && rte_cryptodev_dequeue_burst(dev_id, 0, &cop, 1) == 0; i++)
+		rte_delay_us(10);
+	if (i == 100)
+		return -ETIMEDOUT;
+
+	if (rte_ipsec_pkt_crypto_group((const struct rte_crypto_op **)(uintptr_t)&cop,
+				       &m, &grp, 1) != 1 ||
+	    rte_ipsec_pkt_process(&test_ipsec_ss, &m, 1) != 1) {
+		rte_crypto_op_free(cop);
+		return -EIO;
+	}
+	rte_crypto_op_free(cop);
+
+	return 0;
+}
+
+/*
+ * esp_inbound and ipsec_crypto_poll: ESP packets of a port submitted to the
+ * crypto device with the SA of their SPI, the other packets sent to the next
+ * feature, and the decrypted packets sent to the next feature once
+ * ipsec_crypto_poll dequeued them.
+ */
+static int
+test_esp_inbound(void)
+{
+	const char *node_patterns[] = {TEST_NODE_SRC_NAME, "esp_inbound", "ipsec_crypto_poll"};
+	const char *next = "esp_inbound";
+	struct rte_graph_feature_arc *arc = NULL;
+	struct rte_mempool *cop_pool = NULL;
+	struct rte_mbuf *pkts[2] = {NULL};
+	const struct rte_ether_hdr *eth;
+	const struct rte_ipv4_hdr *ip;
+	struct rte_graph_param gconf;
+	struct rte_mbuf *dropped;
+	struct rte_graph *graph;
+	rte_graph_t graph_id;
+	int ret = TEST_FAILED;
+	unsigned int i;
+	uint8_t dev_id;
+
+	if (test_ipsec_dev_id < 0) {
+		printf("IPsec nodes not configured, skipping\n");
+		return TEST_SKIPPED;
+	}
+	dev_id = test_ipsec_dev_id;
+
+	TEST_ASSERT_SUCCESS(rte_cryptodev_start(dev_id), "Failed to start crypto device");
+	cop_pool = rte_crypto_op_pool_create("test_graph_node_cop",
+			RTE_CRYPTO_OP_TYPE_SYMMETRIC, 8, 0, RTE_NODE_IPSEC_IV_SIZE,
+			SOCKET_ID_ANY);
+	if (cop_pool == NULL) {
+		printf("Failed to create crypto operation pool\n");
+		goto stop;
+	}
+
+	if (test_ipsec_sa_create(&test_ipsec_in_ss, dev_id, test_ipsec_sess_pool,
+				 true) != 0) {
+		printf("Failed to create inbound SA\n");
+		goto stop;
+	}
+	if (rte_node_ipsec_sa_add(TEST_NODE_IPSEC_SA_ID, &test_ipsec_in_ss) != 0 ||
+	    rte_node_ipsec_sa_add(TEST_NODE_IPSEC_SA_ID + RTE_NODE_IPSEC_MAX_SA,
+				  &test_ipsec_in_ss) != -ENOSPC ||
+	    rte_node_ipsec_sa_del(TEST_NODE_IPSEC_SA_ID + RTE_NODE_IPSEC_MAX_SA,
+				  &test_ipsec_in_ss, NULL) != -ENOENT) {
+		printf("Unexpected inbound SA add or delete result\n");
+		goto stop;
+	}
+
+	/* The node is the feature, the end node of the port is a sink */
+	arc = rte_graph_feature_arc_create(RTE_NODE_ETHDEV_RX_FEATURE_ARC, "ethdev_rx",
+					   "test_node_sink1", 1);
+	if (arc == NULL || rte_graph_feature_add(arc, "esp_inbound") < 0 ||
+	    rte_node_edge_update(rte_node_from_name(TEST_NODE_SRC_NAME), 0,
+				 &next, 1) == RTE_EDGE_ID_INVALID) {
+		printf("Failed to set up feature arc\n");
+		goto destroy_arc;
+	}
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = rte_socket_id();
+	gconf.nb_node_patterns = RTE_DIM(node_patterns);
+	gconf.node_patterns = node_patterns;
+	graph_id = rte_graph_create("test_graph_node", &gconf);
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create graph: %s\n", rte_strerror(rte_errno));
+		goto destroy_arc;
+	}
+	graph = rte_graph_lookup(rte_graph_id_to_name(graph_id));
+	if (rte_graph_feature_enable(arc, 0, "esp_inbound", 0, NULL) != 0) {
+		printf("Failed to enable feature\n");
+		goto destroy_graph;
+	}
+
+	pkts[0] = test_node_ip4_pkt(RTE_IPV4(10, 0, 0, 1), 0);
+	pkts[1] = test_node_ip4_pkt(RTE_IPV4(10, 0, 0, 2), 0);
+	if (pkts[0] == NULL || pkts[1] == NULL ||
+	    test_ipsec_encrypt(dev_id, cop_pool, pkts[0]) != 0) {
+		printf("Failed to build packets\n");
+		goto free_pkts;
+	}
+
+	/* The plain packet goes to the next feature right away */
+	test_node_walk(graph_id, pkts, RTE_DIM(pkts));
+	if (!test_node_sink_has(1, pkts[1])) {
+		printf("Plain packet not sent to the next feature\n");
+		goto free_pkts;
+	}
+
+	/* The ESP packet comes back from ipsec_crypto_poll, decrypted */
+	for (i = 0; i < 100 && !test_node_sink_has(1, pkts[0]); i++) {
+		rte_delay_us(10);
+		rte_graph_walk(graph);
+	}
+	if (test_sinks[1].nb != 2 || !test_node_sink_has(1, pkts[0])) {
+		printf("ESP packet not sent to the next feature after crypto\n");
+		goto free_pkts;
+	}
+	eth = rte_pktmbuf_mtod(pkts[0], const struct rte_ether_hdr *);
+	ip = (const struct rte_ipv4_hdr *)(eth + 1);
+	if (eth->ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) ||
+	    ip->next_proto_id != IPPROTO_UDP ||
+	    ip->dst_addr != rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1))) {
+		printf("ESP packet not decrypted\n");
+		goto free_pkts;
+	}
+
+	/* The ESP packets of a deleted SA are dropped */
+	if (rte_node_ipsec_sa_del(TEST_NODE_IPSEC_SA_ID, &test_ipsec_in_ss, NULL) != 0 ||
+	    rte_node_ipsec_sa_del(TEST_NODE_IPSEC_SA_ID, &test_ipsec_in_ss, NULL) != -ENOENT) {
+		printf("Unexpected inbound SA delete result\n");
+		goto free_pkts;
+	}
+	dropped = test_node_ip4_pkt(RTE_IPV4(10, 0, 0, 3), 0);
+	if (dropped == NULL || test_ipsec_encrypt(dev_id, cop_pool, dropped) != 0) {
+		printf("Failed to build packets\n");
+		rte_pktmbuf_free(dropped);
+		goto free_pkts;
+	}
+	/* Freed by the packet drop node */
+	test_node_walk(graph_id, &dropped, 1);
+	for (i = 0; i < 10; i++)
+		rte_graph_walk(graph);
+	if (test_sinks[1].nb != 0) {
+		printf("ESP packet of a deleted SA not dropped\n");
+		goto free_pkts;
+	}
+
+	ret = TEST_SUCCESS;
+free_pkts:
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		rte_pktmbuf_free(pkts[i]);
+destroy_graph:
+	rte_graph_destroy(graph_id);
+destroy_arc:
+	rte_graph_feature_arc_destroy(arc);
+stop:
+	rte_node_ipsec_sa_del(TEST_NODE_IPSEC_SA_ID, &test_ipsec_in_ss, NULL);
+	rte_cryptodev_stop(dev_id);
+	rte_mempool_free(cop_pool);
+
+	return ret;
+}
+
+static int
+test_graph_node_setup(void)
+{
+	test_pool = rte_pktmbuf_pool_create("test_graph_node_pool", 512, 0, 0,
+					    RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (test_pool == NULL) {
+		printf("Failed to create mbuf pool\n");
+		return TEST_FAILED;
+	}
+
+	test_indirect_pool = rte_pktmbuf_pool_create("test_graph_node_indirect", 512, 0, 0,
+						     0, SOCKET_ID_ANY);
+	if (test_indirect_pool == NULL) {
+		printf("Failed to create indirect mbuf pool\n");
+		rte_mempool_free(test_pool);
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+test_graph_node_teardown(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(test_frag_tbl); i++) {
+		rte_ip_frag_table_destroy(test_frag_tbl[i]);
+		test_frag_tbl[i] = NULL;
+	}
+	rte_mempool_free(test_indirect_pool);
+	test_indirect_pool = NULL;
+	rte_mempool_free(test_pool);
+	test_pool = NULL;
+}
+
+static struct unit_test_suite graph_node_testsuite = {
+	.suite_name = "Graph inbuilt nodes test suite",
+	.setup = test_graph_node_setup,
+	.teardown = test_graph_node_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_ip4_lookup_fib),
+		TEST_CASE(test_ip4_acl_rules_set),
+		TEST_CASE(test_ip4_fragment_reassembly),
+		TEST_CASE(test_ip6_fragment_reassembly),
+		TEST_CASE(test_esp_outbound),
+		TEST_CASE(test_esp_inbound),
+		TEST_CASES_END(), /**< NULL terminate unit test array */
+	},
+};
+
+static int
+test_graph_node(void)
+{
+	return unit_test_suite_runner(&graph_node_testsuite);
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_FAST_TEST(graph_node_autotest, true, true, test_graph_node);
@@ -22,11 +22,15 @@ test_graph_perf_func(void)
 
 #else
 
+#include <rte_ether.h>
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
+#include <rte_ip.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_mbuf.h>
+#include <rte_node_acl_api.h>
+#include <rte_udp.h>
 
 #define TEST_GRAPH_PERF_MZ	     "graph_perf_data"
 #define TEST_GRAPH_SRC_NAME	     "test_graph_perf_source"
@@ -979,6 +983,498 @@ graph_init_parallel_tree(void)
 			  snk_map, edge_map, 0);
 }
 
+#define TEST_GRAPH_ACL_SRC_NAME "test_graph_perf_acl_source"
+#define TEST_GRAPH_ACL_SNK_NAME "test_graph_perf_acl_sink"
+#define TEST_GRAPH_ACL_CLONE	"acl_perf"
+#define TEST_GRAPH_ACL_NB_RULES 1024
+
+static struct rte_mbuf *acl_pkts[RTE_GRAPH_BURST_SIZE];
+static struct rte_mempool *acl_pool;
+static rte_graph_t acl_graph_id = RTE_GRAPH_ID_INVALID;
+
+/* Source node sending the same burst of IPv4 UDP packets on every walk */
+static uint16_t
+test_perf_node_acl_source(struct rte_graph *graph, struct rte_node *node,
+			  void **objs, uint16_t nb_objs)
+{
+	void **to_next;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	to_next = rte_node_next_stream_get(graph, node, 0, RTE_GRAPH_BURST_SIZE);
+	memcpy(to_next, acl_pkts, sizeof(acl_pkts));
+	rte_node_next_stream_put(graph, node, 0, RTE_GRAPH_BURST_SIZE);
+
+	return RTE_GRAPH_BURST_SIZE;
+}
+
+static struct rte_node_register test_graph_perf_acl_source = {
+	.name = TEST_GRAPH_ACL_SRC_NAME,
+	.process = test_perf_node_acl_source,
+	.flags = RTE_NODE_SOURCE_F,
+};
+
+RTE_NODE_REGISTER(test_graph_perf_acl_source);
+
+static struct rte_node_register test_graph_perf_acl_sink = {
+	.name = TEST_GRAPH_ACL_SNK_NAME,
+	.process = test_perf_node_sink,
+};
+
+RTE_NODE_REGISTER(test_graph_perf_acl_sink);
+
+static int
+graph_acl_pkts_create(void)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	struct rte_udp_hdr *udp;
+	unsigned int i;
+
+	acl_pool = rte_pktmbuf_pool_create("graph_perf_acl_pool",
+			RTE_GRAPH_BURST_SIZE, 0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			SOCKET_ID_ANY);
+	if (acl_pool == NULL)
+		return -ENOMEM;
+
+	if (rte_pktmbuf_alloc_bulk(acl_pool, acl_pkts, RTE_GRAPH_BURST_SIZE) < 0)
+		return -ENOMEM;
+
+	for (i = 0; i < RTE_GRAPH_BURST_SIZE; i++) {
+		eth = (struct rte_ether_hdr *)rte_pktmbuf_append(acl_pkts[i],
+				sizeof(*eth) + sizeof(*ip) + sizeof(*udp));
+		memset(eth, 0, sizeof(*eth) + sizeof(*ip) + sizeof(*udp));
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+		ip = (struct rte_ipv4_hdr *)(eth + 1);
+		ip->version_ihl = RTE_IPV4_VHL_DEF;
+		ip->next_proto_id = IPPROTO_UDP;
+		ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, i % 8, i));
+		ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(20, 0, 0, i));
+
+		udp = (struct rte_udp_hdr *)(ip + 1);
+		udp->src_port = rte_cpu_to_be_16(1024 + i);
+		udp->dst_port = rte_cpu_to_be_16(i % 2 ? 53 : 80);
+	}
+
+	return 0;
+}
+
+/* Rules mostly missing the packets, denying the UDP port 80 ones */
+static int
+graph_acl_rules_set(void)
+{
+	struct rte_node_ip4_acl_rule *rules, *r;
+	struct rte_acl_field *f;
+	uint32_t i;
+	int rc;
+
+	rules = calloc(TEST_GRAPH_ACL_NB_RULES, sizeof(*rules));
+	if (rules == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i < TEST_GRAPH_ACL_NB_RULES; i++) {
+		r = &rules[i];
+		f = r->field;
+		r->data.category_mask = 1;
+		r->data.priority = TEST_GRAPH_ACL_NB_RULES - i;
+		r->data.userdata = RTE_NODE_ACL_USERDATA(RTE_NODE_IP4_ACL_NEXT_DENY);
+
+		f[RTE_NODE_IP4_ACL_FIELD_PROTO].value.u8 = IPPROTO_UDP;
+		f[RTE_NODE_IP4_ACL_FIELD_PROTO].mask_range.u8 = UINT8_MAX;
+		f[RTE_NODE_IP4_ACL_FIELD_SRC_PORT].mask_range.u16 = UINT16_MAX;
+		f[RTE_NODE_IP4_ACL_FIELD_DST_PORT].mask_range.u16 = UINT16_MAX;
+		if (i == TEST_GRAPH_ACL_NB_RULES - 1) {
+			/* Lowest priority rule matching half of the packets */
+			f[RTE_NODE_IP4_ACL_FIELD_DST_PORT].value.u16 = 80;
+			f[RTE_NODE_IP4_ACL_FIELD_DST_PORT].mask_range.u16 = 80;
+			continue;
+		}
+		f[RTE_NODE_IP4_ACL_FIELD_SRC].value.u32 = RTE_IPV4(192, 168, i >> 8, i & 0xff);
+		f[RTE_NODE_IP4_ACL_FIELD_SRC].mask_range.u32 = 32;
+		f[RTE_NODE_IP4_ACL_FIELD_DST].value.u32 = RTE_IPV4(172, 16, 0, 0);
+		f[RTE_NODE_IP4_ACL_FIELD_DST].mask_range.u32 = 16;
+	}
+
+	rc = rte_node_ip4_acl_rules_set(rules, TEST_GRAPH_ACL_NB_RULES,
+					RTE_NODE_IP4_ACL_NEXT_PERMIT, NULL);
+	free(rules);
+
+	return rc;
+}
+
+/* Graph Topology
+ * source -> ip4_acl -> sink, permitted and denied packets both to the sink
+ */
+static int
+graph_init_acl(void)
+{
+	static const char *node_patterns[] = {
+		TEST_GRAPH_ACL_SRC_NAME,
+		"ip4_acl-" TEST_GRAPH_ACL_CLONE,
+		TEST_GRAPH_ACL_SNK_NAME,
+	};
+	const char *next = "ip4_acl-" TEST_GRAPH_ACL_CLONE;
+	const char *sink[] = {TEST_GRAPH_ACL_SNK_NAME, TEST_GRAPH_ACL_SNK_NAME};
+	struct rte_graph_param gconf;
+	rte_node_t acl_id;
+
+	if (graph_acl_pkts_create() < 0) {
+		printf("Failed to create ACL packets\n");
+		return TEST_FAILED;
+	}
+
+	if (graph_acl_rules_set() < 0) {
+		printf("Failed to set ACL rules\n");
+		return TEST_FAILED;
+	}
+
+	acl_id = rte_node_from_name("ip4_acl-" TEST_GRAPH_ACL_CLONE);
+	if (acl_id == RTE_NODE_ID_INVALID)
+		acl_id = rte_node_clone(rte_node_from_name("ip4_acl"), TEST_GRAPH_ACL_CLONE);
+	if (acl_id == RTE_NODE_ID_INVALID ||
+	    rte_node_edge_update(acl_id, RTE_NODE_IP4_ACL_NEXT_PERMIT, sink,
+				 RTE_DIM(sink)) == RTE_EDGE_ID_INVALID ||
+	    rte_node_edge_update(rte_node_from_name(TEST_GRAPH_ACL_SRC_NAME), 0,
+				 &next, 1) == RTE_EDGE_ID_INVALID) {
+		printf("Failed to link ACL nodes\n");
+		return TEST_FAILED;
+	}
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = SOCKET_ID_ANY;
+	gconf.nb_node_patterns = RTE_DIM(node_patterns);
+	gconf.node_patterns = node_patterns;
+	acl_graph_id = rte_graph_create("graph_acl", &gconf);
+	if (acl_graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create ACL graph: %s\n", rte_strerror(rte_errno));
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+graph_fini_acl(void)
+{
+	if (acl_graph_id != RTE_GRAPH_ID_INVALID)
+		rte_graph_destroy(acl_graph_id);
+	acl_graph_id = RTE_GRAPH_ID_INVALID;
+
+	rte_node_ip4_acl_rules_set(NULL, 0, RTE_NODE_IP4_ACL_NEXT_PERMIT, NULL);
+
+	if (acl_pkts[0] != NULL)
+		rte_pktmbuf_free_bulk(acl_pkts, RTE_GRAPH_BURST_SIZE);
+	memset(acl_pkts, 0, sizeof(acl_pkts));
+	rte_mempool_free(acl_pool);
+	acl_pool = NULL;
+}
+
+static inline int
+graph_acl_ip4_1src_1snk(void)
+{
+	return measure_perf_get(acl_graph_id);
+}
+
+#define TEST_GRAPH_WS_SRC_NAME	 "test_graph_perf_ws_source"
+#define TEST_GRAPH_WS_LIGHT_NAME "test_graph_perf_ws_light"
+#define TEST_GRAPH_WS_HEAVY_NAME "test_graph_perf_ws_heavy"
+#define TEST_GRAPH_WS_SNK_NAME	 "test_graph_perf_ws_sink"
+#define TEST_GRAPH_WS_LIGHT_COST 10   /* Cycles per object */
+#define TEST_GRAPH_WS_HEAVY_COST 1000 /* Cycles per object */
+#define TEST_GRAPH_WS_MAX_LCORES 8
+
+struct __rte_cache_aligned graph_ws_lcore_data {
+	rte_graph_t graph_id;
+	volatile uint8_t done;
+	uint64_t objs;
+};
+
+static struct graph_ws_lcore_data ws_lcore_data[RTE_MAX_LCORE];
+static rte_graph_t ws_graph_id = RTE_GRAPH_ID_INVALID;
+
+static __rte_always_inline void
+test_perf_node_ws_spin(uint64_t cycles)
+{
+	const uint64_t end = rte_get_tsc_cycles() + cycles;
+
+	while (rte_get_tsc_cycles() < end)
+		rte_pause();
+}
+
+static uint16_t
+test_perf_node_ws_source(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	rte_node_next_stream_get(graph, node, 0, RTE_GRAPH_BURST_SIZE);
+	rte_node_next_stream_put(graph, node, 0, RTE_GRAPH_BURST_SIZE);
+
+	return RTE_GRAPH_BURST_SIZE;
+}
+
+static struct rte_node_register test_graph_perf_ws_source = {
+	.name = TEST_GRAPH_WS_SRC_NAME,
+	.process = test_perf_node_ws_source,
+	.flags = RTE_NODE_SOURCE_F,
+};
+
+RTE_NODE_REGISTER(test_graph_perf_ws_source);
+
+static uint16_t
+test_perf_node_ws_light(struct rte_graph *graph, struct rte_node *node,
+			void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+
+	test_perf_node_ws_spin(TEST_GRAPH_WS_LIGHT_COST * nb_objs);
+	rte_node_next_stream_move(graph, node, 0);
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_graph_perf_ws_light = {
+	.name = TEST_GRAPH_WS_LIGHT_NAME,
+	.process = test_perf_node_ws_light,
+};
+
+RTE_NODE_REGISTER(test_graph_perf_ws_light);
+
+static uint16_t
+test_perf_node_ws_heavy(struct rte_graph *graph, struct rte_node *node,
+			void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+
+	test_perf_node_ws_spin(TEST_GRAPH_WS_HEAVY_COST * nb_objs);
+	rte_node_next_stream_move(graph, node, 0);
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_graph_perf_ws_heavy = {
+	.name = TEST_GRAPH_WS_HEAVY_NAME,
+	.process = test_perf_node_ws_heavy,
+};
+
+RTE_NODE_REGISTER(test_graph_perf_ws_heavy);
+
+static uint16_t
+test_perf_node_ws_sink(struct rte_graph *graph, struct rte_node *node,
+		       void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+
+	ws_lcore_data[rte_lcore_id()].objs += nb_objs;
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_graph_perf_ws_sink = {
+	.name = TEST_GRAPH_WS_SNK_NAME,
+	.process = test_perf_node_ws_sink,
+};
+
+RTE_NODE_REGISTER(test_graph_perf_ws_sink);
+
+/* Graph Topology
+ * source -> light -> heavy -> sink, the heavy node costing 100 times the light one
+ */
+static int
+graph_init_work_steal(void)
+{
+	static const char *node_patterns[] = {
+		TEST_GRAPH_WS_SRC_NAME,
+		TEST_GRAPH_WS_LIGHT_NAME,
+		TEST_GRAPH_WS_HEAVY_NAME,
+		TEST_GRAPH_WS_SNK_NAME,
+	};
+	const char *light = TEST_GRAPH_WS_LIGHT_NAME;
+	const char *heavy = TEST_GRAPH_WS_HEAVY_NAME;
+	const char *sink = TEST_GRAPH_WS_SNK_NAME;
+	struct rte_graph_param gconf;
+
+	/* The source lcore and at least one lcore to steal its work */
+	if (rte_lcore_count() < 3) {
+		printf("Work stealing needs 2 worker lcores, skipping\n");
+		return TEST_SKIPPED;
+	}
+
+	if (rte_node_edge_update(rte_node_from_name(TEST_GRAPH_WS_SRC_NAME), 0,
+				 &light, 1) == RTE_EDGE_ID_INVALID ||
+	    rte_node_edge_update(rte_node_from_name(TEST_GRAPH_WS_LIGHT_NAME), 0,
+				 &heavy, 1) == RTE_EDGE_ID_INVALID ||
+	    rte_node_edge_update(rte_node_from_name(TEST_GRAPH_WS_HEAVY_NAME), 0,
+				 &sink, 1) == RTE_EDGE_ID_INVALID) {
+		printf("Failed to link work stealing nodes\n");
+		return TEST_FAILED;
+	}
+
+	/* All the objects enter the graph on the first worker */
+	if (rte_graph_model_mcore_dispatch_node_lcore_affinity_set(TEST_GRAPH_WS_SRC_NAME,
+			rte_get_next_lcore(-1, 1, 0)) < 0) {
+		printf("Failed to set source node lcore\n");
+		return TEST_FAILED;
+	}
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = SOCKET_ID_ANY;
+	gconf.nb_node_patterns = RTE_DIM(node_patterns);
+	gconf.node_patterns = node_patterns;
+	ws_graph_id = rte_graph_create("graph_ws", &gconf);
+	if (ws_graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create work stealing graph: %s\n", rte_strerror(rte_errno));
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+graph_fini_work_steal(void)
+{
+	if (ws_graph_id != RTE_GRAPH_ID_INVALID)
+		rte_graph_destroy(ws_graph_id);
+	ws_graph_id = RTE_GRAPH_ID_INVALID;
+
+	rte_graph_worker_model_set(RTE_GRAPH_MODEL_RTC);
+}
+
+static int
+_graph_ws_wrapper(void *args)
+{
+	struct graph_ws_lcore_data *data = args;
+	struct rte_graph *graph;
+
+	graph = rte_graph_lookup(rte_graph_id_to_name(data->graph_id));
+
+	while (!data->done)
+		rte_graph_walk(graph);
+
+	return 0;
+}
+
+/* Run the graphs of the lcores for a second, return the objects per second */
+static double
+graph_ws_measure(const unsigned int *lcores, unsigned int nb_lcores)
+{
+	uint64_t start, objs = 0;
+	unsigned int i;
+
+	for (i = 0; i < nb_lcores; i++) {
+		ws_lcore_data[lcores[i]].done = 0;
+		ws_lcore_data[lcores[i]].objs = 0;
+	}
+
+	start = rte_get_timer_cycles();
+	for (i = 0; i < nb_lcores; i++)
+		rte_eal_remote_launch(_graph_ws_wrapper, &ws_lcore_data[lcores[i]], lcores[i]);
+
+	rte_delay_ms(1E3);
+
+	for (i = 0; i < nb_lcores; i++)
+		ws_lcore_data[lcores[i]].done = 1;
+	for (i = 0; i < nb_lcores; i++) {
+		rte_eal_wait_lcore(lcores[i]);
+		objs += ws_lcore_data[lcores[i]].objs;
+		printf("  lcore %u: %" PRIu64 " objs\n", lcores[i],
+		       ws_lcore_data[lcores[i]].objs);
+	}
+
+	return (double)objs * rte_get_timer_hz() / (rte_get_timer_cycles() - start);
+}
+
+static inline int
+graph_ws_skew_1src_1snk(void)
+{
+	static const char *nodes[] = {
+		TEST_GRAPH_WS_LIGHT_NAME,
+		TEST_GRAPH_WS_HEAVY_NAME,
+		TEST_GRAPH_WS_SNK_NAME,
+	};
+	rte_graph_t clones[TEST_GRAPH_WS_MAX_LCORES];
+	unsigned int lcores[TEST_GRAPH_WS_MAX_LCORES];
+	struct rte_graph_param gconf;
+	unsigned int nb_lcores = 0;
+	double rtc_rate, ws_rate;
+	char name[RTE_GRAPH_NAMESIZE];
+	uint64_t pushed, stolen;
+	unsigned int lcore, i, j;
+	struct rte_node *node;
+	int rc = TEST_SUCCESS;
+
+	/* Run to completion on the lcore of the source */
+	lcores[0] = rte_get_next_lcore(-1, 1, 0);
+	ws_lcore_data[lcores[0]].graph_id = ws_graph_id;
+	printf("RTC model, 1 lcore:\n");
+	rtc_rate = graph_ws_measure(lcores, 1);
+
+	/* Work stealing between a clone of the graph per lcore */
+	if (rte_graph_worker_model_set(RTE_GRAPH_MODEL_WORK_STEAL) < 0)
+		return TEST_FAILED;
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = SOCKET_ID_ANY;
+	RTE_LCORE_FOREACH_WORKER(lcore) {
+		if (nb_lcores == TEST_GRAPH_WS_MAX_LCORES)
+			break;
+
+		snprintf(name, sizeof(name), "w%u", lcore);
+		clones[nb_lcores] = rte_graph_clone(ws_graph_id, name, &gconf);
+		if (clones[nb_lcores] == RTE_GRAPH_ID_INVALID) {
+			printf("Failed to clone graph: %s\n", rte_strerror(rte_errno));
+			rc = TEST_FAILED;
+			goto destroy;
+		}
+		lcores[nb_lcores] = lcore;
+		ws_lcore_data[lcore].graph_id = clones[nb_lcores++];
+
+		if (rte_graph_model_mcore_dispatch_core_bind(clones[nb_lcores - 1], lcore) < 0) {
+			printf("Failed to bind graph to lcore %u\n", lcore);
+			rc = TEST_FAILED;
+			goto destroy;
+		}
+	}
+
+	printf("Work stealing model, %u lcores:\n", nb_lcores);
+	ws_rate = graph_ws_measure(lcores, nb_lcores);
+
+	printf("Objects/sec (10E6): RTC %.3f, work stealing %.3f (x%.2f)\n",
+	       rtc_rate / 1E6, ws_rate / 1E6, rtc_rate ? ws_rate / rtc_rate : 0);
+
+	/* Streams are pushed to the deques, and run by the other lcores */
+	pushed = 0;
+	stolen = 0;
+	for (i = 0; i < nb_lcores; i++) {
+		for (j = 0; j < RTE_DIM(nodes); j++) {
+			node = rte_graph_node_get_by_name(rte_graph_id_to_name(clones[i]),
+							  nodes[j]);
+			if (node != NULL)
+				pushed += node->work_steal.total_sched_objs;
+		}
+		if (lcores[i] != lcores[0])
+			stolen += ws_lcore_data[lcores[i]].objs;
+	}
+	printf("Objects pushed %" PRIu64 ", run by other lcores %" PRIu64 "\n",
+	       pushed, stolen);
+	if (pushed == 0 || stolen == 0) {
+		printf("No work stolen\n");
+		rc = TEST_FAILED;
+	}
+
+destroy:
+	/* The graphs stealing from each other are destroyed together */
+	for (i = 0; i < nb_lcores; i++)
+		rte_graph_destroy(clones[i]);
+
+	return rc;
+}
+
 /** Graph Creation cheat sheet
  *  edge_map -> dictates graph flow from worker stage 0 to worker stage n-1.
  *  src_map  -> dictates source nodes enqueue percentage to worker stage 0.
@@ -1061,6 +1557,10 @@ static struct unit_test_suite graph_perf_testsuite = {
 			     graph_reverse_tree_3s_4n_1src_1snk),
 		TEST_CASE_ST(graph_init_parallel_tree, graph_fini,
 			     graph_parallel_tree_5s_4n_4src_4snk),
+		TEST_CASE_ST(graph_init_acl, graph_fini_acl,
+			     graph_acl_ip4_1src_1snk),
+		TEST_CASE_ST(graph_init_work_steal, graph_fini_work_steal,
+			     graph_ws_skew_1src_1snk),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
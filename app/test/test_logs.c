@@ -2,11 +2,14 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <errno.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdarg.h>
 #include <sys/queue.h>
 
+#include <rte_cycles.h>
 #include <rte_log.h>
 #include <rte_memory.h>
 #include <rte_launch.h>
@@ -60,6 +63,82 @@ test_legacy_logs(void)
 	return 0;
 }
 
+#ifndef RTE_EXEC_ENV_WINDOWS
+/* Wait for the logging thread to process all queued messages */
+static int
+wait_async_logs(struct rte_log_async_stats *stats)
+{
+	unsigned int i;
+
+	for (i = 0; i < 100; i++) {
+		if (rte_log_async_stats_get(stats) != 0)
+			return -1;
+		if (stats->emitted + stats->suppressed == stats->queued)
+			return 0;
+		rte_delay_ms(10);
+	}
+
+	return -1;
+}
+#endif
+
+/*
+ * Rate limit
+ * ==========
+ *
+ * - Check the rate limit parameters.
+ * - With asynchronous logging, send a burst of logs and check that only
+ *   the allowed number of messages is written.
+ */
+static int
+test_rate_limit_logs(int logtype)
+{
+	struct rte_log_async_stats before, after;
+	unsigned int i;
+	int ret;
+
+	printf("== rate limit\n");
+
+	ret = rte_log_set_rate_limit(UINT32_MAX, 1, 1000);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "invalid logtype accepted");
+	ret = rte_log_set_rate_limit(logtype, 1, 0);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "invalid period accepted");
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+	RTE_SET_USED(before);
+	RTE_SET_USED(after);
+	RTE_SET_USED(i);
+	return 0;
+#else
+	ret = rte_log_async_stats_get(&before);
+	if (ret == -ENOTSUP) {
+		printf("asynchronous logging not enabled, skipping\n");
+		return 0;
+	}
+	TEST_ASSERT_SUCCESS(wait_async_logs(&before),
+		"cannot get async log stats");
+
+	TEST_ASSERT_SUCCESS(rte_log_set_rate_limit(logtype, 4, 60 * 1000),
+		"cannot set rate limit");
+	for (i = 0; i < 16; i++)
+		rte_log(RTE_LOG_ERR, logtype, "rate limited message %u\n", i);
+
+	TEST_ASSERT_SUCCESS(wait_async_logs(&after),
+		"cannot get async log stats");
+	TEST_ASSERT_SUCCESS(rte_log_set_rate_limit(logtype, 0, 0),
+		"cannot disable rate limit");
+
+	TEST_ASSERT_EQUAL(after.queued - before.queued, 16,
+		"unexpected number of queued messages");
+	TEST_ASSERT_EQUAL(after.emitted - before.emitted, 4,
+		"unexpected number of emitted messages");
+	TEST_ASSERT_EQUAL(after.suppressed - before.suppressed, 12,
+		"unexpected number of suppressed messages");
+
+	return 0;
+#endif
+}
+
 static int
 test_logs(void)
 {
@@ -153,6 +232,10 @@ test_logs(void)
 	if (ret < 0)
 		return ret;
 
+	ret = test_rate_limit_logs(logtype1);
+	if (ret < 0)
+		return ret;
+
 #undef CHECK_LEVELS
 
 	return 0;
@@ -1055,6 +1055,357 @@ service_active_two_cores(void)
 	return unregister_all();
 }
 
+/* service reporting work until its budget of calls is used up */
+static uint32_t weighted_budget;
+static uint32_t weighted_calls;
+
+static int32_t
+weighted_cb(void *args)
+{
+	RTE_SET_USED(args);
+
+	weighted_calls++;
+	if (weighted_budget == 0)
+		return -EAGAIN;
+
+	weighted_budget--;
+	return 0;
+}
+
+/* verify run policy weight, deadline and cycles histogram */
+static int
+service_run_policy(void)
+{
+	struct rte_service_run_policy policy;
+	uint64_t hist[RTE_SERVICE_CYCLES_HIST_BUCKETS];
+	uint64_t calls, idle_calls, sum;
+	uint32_t id, i;
+	int32_t n;
+
+	unregister_all();
+
+	struct rte_service_spec service;
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = weighted_cb;
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of service failed");
+	rte_service_component_runstate_set(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Error: Service start returned non-zero");
+
+	/* check error return values and defaults */
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_run_policy_get(UINT32_MAX, &policy),
+			"Invalid service id didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_run_policy_get(id, NULL),
+			"NULL policy didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_run_policy_set(id, NULL),
+			"NULL policy didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(0, rte_service_run_policy_get(id, &policy),
+			"Valid run_policy_get() call didn't return success");
+	TEST_ASSERT_EQUAL(1, policy.weight, "Default weight is not one");
+	TEST_ASSERT_EQUAL(0, policy.deadline_ns, "Default deadline is not zero");
+
+	/* a weighted service runs back-to-back until idle or out of weight */
+	policy.weight = 4;
+	policy.deadline_ns = 0;
+	TEST_ASSERT_EQUAL(0, rte_service_run_policy_set(id, &policy),
+			"Valid run_policy_set() call didn't return success");
+
+	weighted_budget = 100;
+	weighted_calls = 0;
+	TEST_ASSERT_EQUAL(0, rte_service_run_iter_on_app_lcore(id, 1),
+			"Failed to run service on app lcore");
+	TEST_ASSERT_EQUAL(4, weighted_calls, "Weight not applied");
+
+	weighted_budget = 2;
+	weighted_calls = 0;
+	TEST_ASSERT_EQUAL(0, rte_service_run_iter_on_app_lcore(id, 1),
+			"Failed to run service on app lcore");
+	TEST_ASSERT_EQUAL(3, weighted_calls, "Idle service not left early");
+
+	/* a zero weight is treated as one */
+	policy.weight = 0;
+	policy.deadline_ns = 1000 * 1000;
+	TEST_ASSERT_EQUAL(0, rte_service_run_policy_set(id, &policy),
+			"Valid run_policy_set() call didn't return success");
+	TEST_ASSERT_EQUAL(0, rte_service_run_policy_get(id, &policy),
+			"Valid run_policy_get() call didn't return success");
+	TEST_ASSERT_EQUAL(1, policy.weight, "Zero weight not adjusted");
+	TEST_ASSERT_EQUAL(1000 * 1000, policy.deadline_ns, "Deadline not set");
+
+	/* run the deadline service on a service lcore with statistics */
+	rte_service_set_stats_enable(id, 1);
+	rte_service_attr_reset_all(id);
+	weighted_budget = UINT32_MAX;
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(-EINVAL,
+			rte_service_lcore_cycles_hist_get(slcore_id, id, NULL, 0),
+			"NULL histogram didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+
+	rte_delay_ms(100);
+
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 0),
+			"Disabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+
+	n = rte_service_lcore_cycles_hist_get(slcore_id, id, hist, RTE_DIM(hist));
+	TEST_ASSERT_EQUAL(RTE_SERVICE_CYCLES_HIST_BUCKETS, n,
+			"Unexpected number of histogram buckets");
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id, RTE_SERVICE_ATTR_CALL_COUNT,
+			&calls), "Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id,
+			RTE_SERVICE_ATTR_IDLE_CALL_COUNT, &idle_calls),
+			"Valid attr_get() call didn't return success");
+	for (sum = 0, i = 0; i < RTE_SERVICE_CYCLES_HIST_BUCKETS; i++)
+		sum += hist[i];
+	TEST_ASSERT(calls > 0, "Service was not run");
+	TEST_ASSERT_EQUAL(calls - idle_calls, sum,
+			"Histogram does not account for all non-idle calls");
+
+	return unregister_all();
+}
+
+/* services logging the order of their first invocations */
+#define EDF_LOG_SIZE 2
+static RTE_ATOMIC(uint32_t) edf_log_idx;
+static uint32_t edf_log[EDF_LOG_SIZE];
+static const uint32_t edf_tag[] = { 0, 1 };
+
+static int32_t
+edf_cb(void *args)
+{
+	uint32_t idx = rte_atomic_fetch_add_explicit(&edf_log_idx, 1,
+			rte_memory_order_relaxed);
+
+	if (idx < EDF_LOG_SIZE)
+		edf_log[idx] = *(const uint32_t *)args;
+
+	return 0;
+}
+
+/* verify due deadline services run earliest deadline first, and the
+ * deadline misses are accounted to the late service only
+ */
+static int
+service_run_policy_edf(void)
+{
+	struct rte_service_run_policy policy = { .weight = 1 };
+	struct rte_service_spec service;
+	uint64_t misses[RTE_DIM(edf_tag)];
+	uint32_t ids[RTE_DIM(edf_tag)];
+	uint64_t lcore_misses;
+	uint32_t i;
+
+	unregister_all();
+
+	/* service 0 has the lower id, it runs first in the round-robin */
+	for (i = 0; i < RTE_DIM(edf_tag); i++) {
+		memset(&service, 0, sizeof(struct rte_service_spec));
+		service.callback = edf_cb;
+		service.callback_userdata = (void *)(uintptr_t)&edf_tag[i];
+		snprintf(service.name, sizeof(service.name), "edf_service_%u", i);
+		TEST_ASSERT_EQUAL(0, rte_service_component_register(&service,
+				&ids[i]), "Register of service failed");
+		rte_service_component_runstate_set(ids[i], 1);
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(ids[i], 1),
+				"Error: Service start returned non-zero");
+		TEST_ASSERT_EQUAL(0, rte_service_attr_reset_all(ids[i]),
+				"Valid attr_reset_all() return success");
+	}
+	TEST_ASSERT(ids[0] < ids[1], "Unexpected service id order");
+
+	/* service 0 is due after 10 ms, service 1 after 1 ms */
+	policy.deadline_ns = 20 * 1000 * 1000;
+	TEST_ASSERT_EQUAL(0, rte_service_run_policy_set(ids[0], &policy),
+			"Valid run_policy_set() call didn't return success");
+	policy.deadline_ns = 2 * 1000 * 1000;
+	TEST_ASSERT_EQUAL(0, rte_service_run_policy_set(ids[1], &policy),
+			"Valid run_policy_set() call didn't return success");
+
+	rte_atomic_store_explicit(&edf_log_idx, 0, rte_memory_order_relaxed);
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	for (i = 0; i < RTE_DIM(edf_tag); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(ids[i],
+				slcore_id, 1),
+				"Enabling valid service and core failed");
+
+	/* both services are due, service 1 misses its deadline */
+	rte_delay_ms(15);
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+	rte_delay_ms(10);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+
+	TEST_ASSERT(rte_atomic_load_explicit(&edf_log_idx,
+			rte_memory_order_relaxed) >= EDF_LOG_SIZE,
+			"Services were not run");
+	TEST_ASSERT_EQUAL(1, edf_log[0],
+			"Earliest deadline service did not run first");
+	TEST_ASSERT_EQUAL(0, edf_log[1],
+			"Latest deadline service did not run second");
+
+	for (i = 0; i < RTE_DIM(edf_tag); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_attr_get(ids[i],
+				RTE_SERVICE_ATTR_DEADLINE_MISS_COUNT, &misses[i]),
+				"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(0, misses[0],
+			"Deadline miss counted for a service run in time");
+	TEST_ASSERT(misses[1] > 0, "Deadline miss not counted");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_get(slcore_id,
+			RTE_SERVICE_LCORE_ATTR_DEADLINE_MISSES, &lcore_misses),
+			"Valid lcore_attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(misses[0] + misses[1], lcore_misses,
+			"Lcore deadline misses do not add up");
+
+	for (i = 0; i < RTE_DIM(edf_tag); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(ids[i],
+				slcore_id, 0),
+				"Disabling valid service and core failed");
+
+	return unregister_all();
+}
+
+/* service doing work only when woken up with some */
+static RTE_ATOMIC(uint64_t) wakeup_work_tsc;
+static RTE_ATOMIC(uint64_t) wakeup_done_tsc;
+
+static int32_t
+wakeup_cb(void *args)
+{
+	RTE_SET_USED(args);
+
+	if (rte_atomic_load_explicit(&wakeup_work_tsc,
+			rte_memory_order_acquire) == 0)
+		return -EAGAIN;
+
+	rte_atomic_store_explicit(&wakeup_done_tsc, rte_rdtsc(),
+			rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&wakeup_work_tsc, 0,
+			rte_memory_order_release);
+	return 0;
+}
+
+static int
+wakeup_register(uint32_t *id)
+{
+	struct rte_service_spec service;
+
+	unregister_all();
+
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = wakeup_cb;
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, id),
+			"Register of service failed");
+	rte_service_component_runstate_set(*id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(*id, 1),
+			"Error: Service start returned non-zero");
+
+	rte_atomic_store_explicit(&wakeup_work_tsc, 0, rte_memory_order_relaxed);
+
+	return TEST_SUCCESS;
+}
+
+/* hand one work item to the service and wait for it to be processed */
+static int
+wakeup_submit(uint32_t id, uint64_t *latency)
+{
+	uint64_t start = rte_rdtsc();
+	int i;
+
+	rte_atomic_store_explicit(&wakeup_work_tsc, start,
+			rte_memory_order_release);
+	TEST_ASSERT_EQUAL(0, rte_service_wakeup(id), "Wakeup failed");
+
+	for (i = 0; rte_atomic_load_explicit(&wakeup_work_tsc,
+			rte_memory_order_acquire) != 0; i++) {
+		if (i == TIMEOUT_MS * 1000)
+			return TEST_FAILED;
+		rte_delay_us(1);
+	}
+
+	*latency = rte_atomic_load_explicit(&wakeup_done_tsc,
+			rte_memory_order_relaxed) - start;
+
+	return TEST_SUCCESS;
+}
+
+/* verify an idle service lcore sleeps, and is woken up on demand */
+static int
+service_lcore_idle_sleep(void)
+{
+	struct rte_service_lcore_idle_policy policy = {
+		.pause_loops = 16,
+		.sleep_loops = 64,
+		.max_sleep_us = 100 * 1000,
+	};
+	uint64_t sleeps, latency;
+	uint32_t id;
+
+	TEST_ASSERT_EQUAL(TEST_SUCCESS, wakeup_register(&id),
+			"Failed to register service");
+
+	TEST_ASSERT_EQUAL(-ENOTSUP,
+			rte_service_lcore_idle_policy_set(slcore_id, &policy),
+			"Idle policy set on non service core");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(-EINVAL,
+			rte_service_lcore_idle_policy_set(slcore_id, NULL),
+			"NULL idle policy didn't return -EINVAL");
+	policy.max_sleep_us = 0;
+	TEST_ASSERT_EQUAL(-EINVAL,
+			rte_service_lcore_idle_policy_set(slcore_id, &policy),
+			"Zero max sleep time didn't return -EINVAL");
+	policy.max_sleep_us = 100 * 1000;
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_idle_policy_set(slcore_id, &policy),
+			"Valid idle_policy_set() call didn't return success");
+	memset(&policy, 0, sizeof(policy));
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_idle_policy_get(slcore_id, &policy),
+			"Valid idle_policy_get() call didn't return success");
+	TEST_ASSERT_EQUAL(64, policy.sleep_loops, "Idle policy not applied");
+
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+
+	/* with no work to do, the lcore should go to sleep */
+	rte_delay_ms(50);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_get(slcore_id,
+			RTE_SERVICE_LCORE_ATTR_SLEEPS, &sleeps),
+			"Valid lcore_attr_get() call didn't return success");
+	TEST_ASSERT(sleeps > 0, "Idle service lcore did not sleep");
+
+	/* work is processed despite the long maximum sleep time */
+	TEST_ASSERT_EQUAL(TEST_SUCCESS, wakeup_submit(id, &latency),
+			"Service lcore not woken up");
+
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 0),
+			"Disabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_may_be_active(slcore_id),
+			"Service lcore not stopped after waiting.");
+
+	return unregister_all();
+}
+
 static struct unit_test_suite service_tests  = {
 	.suite_name = "service core test suite",
 	.setup = testsuite_setup,
@@ -1072,6 +1423,9 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_mt_safe_poll),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
 		TEST_CASE_ST(dummy_register, NULL, service_active_two_cores),
+		TEST_CASE_ST(dummy_register, NULL, service_run_policy),
+		TEST_CASE_ST(dummy_register, NULL, service_run_policy_edf),
+		TEST_CASE_ST(dummy_register, NULL, service_lcore_idle_sleep),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -1084,6 +1438,62 @@ test_service_common(void)
 
 REGISTER_FAST_TEST(service_autotest, true, true, test_service_common);
 
+/* measure wakeup latency and CPU time saved by an idle sleeping lcore */
+static int
+service_lcore_idle_sleep_perf(void)
+{
+	static const struct rte_service_lcore_idle_policy policies[] = {
+		{ 0, 0, 0 },
+		{ 16, 0, 0 },
+		{ 16, 64, 1000 },
+	};
+	const uint32_t iters = 200;
+	uint64_t latency, total_latency, sleep_cycles, start, elapsed;
+	uint32_t id, i, p;
+
+	TEST_ASSERT_EQUAL(TEST_SUCCESS, wakeup_register(&id),
+			"Failed to register service");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+
+	for (p = 0; p < RTE_DIM(policies); p++) {
+		TEST_ASSERT_EQUAL(0, rte_service_lcore_idle_policy_set(slcore_id,
+				&policies[p]), "Failed to set idle policy");
+		rte_service_lcore_attr_reset_all(slcore_id);
+
+		total_latency = 0;
+		start = rte_rdtsc();
+		for (i = 0; i < iters; i++) {
+			rte_delay_us_sleep(500);
+			TEST_ASSERT_EQUAL(TEST_SUCCESS,
+					wakeup_submit(id, &latency),
+					"Service lcore not woken up");
+			total_latency += latency;
+		}
+		elapsed = rte_rdtsc() - start;
+
+		rte_service_lcore_attr_get(slcore_id,
+				RTE_SERVICE_LCORE_ATTR_SLEEP_CYCLES, &sleep_cycles);
+		printf("idle policy pause %u sleep %u: wakeup latency %.2f us, "
+			"sleeping %.1f%% of the time\n",
+			policies[p].pause_loops, policies[p].sleep_loops,
+			(double)total_latency / iters * US_PER_S / rte_get_tsc_hz(),
+			100.0 * sleep_cycles / elapsed);
+	}
+
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 0),
+			"Disabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+
+	return unregister_all();
+}
+
 static struct unit_test_suite service_perf_tests  = {
 	.suite_name = "service core performance test suite",
 	.setup = testsuite_setup,
@@ -1094,6 +1504,7 @@ static struct unit_test_suite service_perf_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_start_stop),
 		TEST_CASE_ST(dummy_register, NULL, service_app_lcore_mt_safe),
 		TEST_CASE_ST(dummy_register, NULL, service_app_lcore_mt_unsafe),
+		TEST_CASE_ST(dummy_register, NULL, service_lcore_idle_sleep_perf),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
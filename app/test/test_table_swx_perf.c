@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_random.h>
+#include <rte_swx_table_em.h>
+
+#include "test.h"
+
+#define TEST_SWX_PERF_KEY_SIZE 16
+/* Lookups in flight, as the packet threads of a SWX pipeline */
+#define TEST_SWX_PERF_IN_FLIGHT 16
+#define TEST_SWX_PERF_LOOKUPS (1 << 22)
+
+/*
+ * Measure the lookup cycles of an exact match table, with several lookups
+ * interleaved like the SWX pipeline does, switching to the next lookup
+ * each time a lookup step returns without completing.
+ * The small tables complete their lookups in a single step, see
+ * RTE_SWX_TABLE_EM_LOOKUP_DIRECT_SIZE_MAX: building with this threshold
+ * set to 0 gives the cycles of the multi-step lookup for all the sizes.
+ */
+static int
+test_table_swx_em_perf_run(uint32_t n_keys)
+{
+	struct rte_swx_table_ops *ops = &rte_swx_table_exact_match_ops;
+	struct rte_swx_table_params params = {
+		.match_type = RTE_SWX_TABLE_MATCH_EXACT,
+		.key_size = TEST_SWX_PERF_KEY_SIZE,
+		.action_data_size = 8,
+		.n_keys_max = n_keys,
+	};
+	uint8_t *in_flight_keys[TEST_SWX_PERF_IN_FLIGHT];
+	void *mailbox[TEST_SWX_PERF_IN_FLIGHT] = {NULL};
+	uint8_t action_data[8] = {0};
+	struct rte_swx_table_entry entry = {
+		.action_data = action_data,
+	};
+	uint64_t n_done, n_hit, n_steps, start, cycles;
+	uint32_t *lookup_idx = NULL;
+	uint8_t *keys = NULL;
+	void *table = NULL;
+	uint8_t *data;
+	uint64_t action_id;
+	size_t entry_id;
+	uint32_t i, next;
+	int hit, ret = -1;
+
+	table = ops->create(&params, NULL, NULL, 0);
+	keys = calloc(n_keys, TEST_SWX_PERF_KEY_SIZE);
+	lookup_idx = malloc(TEST_SWX_PERF_LOOKUPS * sizeof(*lookup_idx));
+	if (table == NULL || keys == NULL || lookup_idx == NULL) {
+		printf("Failed to create the table of %u keys\n", n_keys);
+		goto free;
+	}
+	for (i = 0; i < TEST_SWX_PERF_IN_FLIGHT; i++) {
+		mailbox[i] = calloc(1, ops->mailbox_size_get());
+		if (mailbox[i] == NULL)
+			goto free;
+	}
+
+	for (i = 0; i < n_keys; i++) {
+		memcpy(&keys[i * TEST_SWX_PERF_KEY_SIZE], &i, sizeof(i));
+		entry.key = &keys[i * TEST_SWX_PERF_KEY_SIZE];
+		entry.action_id = i;
+		if (ops->add(table, &entry) != 0) {
+			printf("Failed to add key %u\n", i);
+			goto free;
+		}
+	}
+	for (i = 0; i < TEST_SWX_PERF_LOOKUPS; i++)
+		lookup_idx[i] = rte_rand_max(n_keys);
+
+	for (i = 0; i < TEST_SWX_PERF_IN_FLIGHT; i++)
+		in_flight_keys[i] = &keys[lookup_idx[i] * TEST_SWX_PERF_KEY_SIZE];
+	next = TEST_SWX_PERF_IN_FLIGHT;
+	n_done = 0;
+	n_hit = 0;
+	n_steps = 0;
+
+	start = rte_rdtsc_precise();
+	while (n_done < TEST_SWX_PERF_LOOKUPS) {
+		for (i = 0; i < TEST_SWX_PERF_IN_FLIGHT; i++) {
+			n_steps++;
+			if (ops->lkp(table, mailbox[i], &in_flight_keys[i], &action_id,
+				     &data, &entry_id, &hit) == 0)
+				continue;
+
+			n_hit += hit;
+			n_done++;
+			in_flight_keys[i] = &keys[lookup_idx[next++ %
+				TEST_SWX_PERF_LOOKUPS] * TEST_SWX_PERF_KEY_SIZE];
+		}
+	}
+	cycles = rte_rdtsc_precise() - start;
+
+	if (n_hit != n_done) {
+		printf("Missed %" PRIu64 " lookups\n", n_done - n_hit);
+		goto free;
+	}
+
+	printf("%8u keys: %6.1f cycles per lookup, %4.2f steps per lookup\n",
+	       n_keys, (double)cycles / n_done, (double)n_steps / n_done);
+	ret = 0;
+
+free:
+	for (i = 0; i < TEST_SWX_PERF_IN_FLIGHT; i++)
+		free(mailbox[i]);
+	free(lookup_idx);
+	free(keys);
+	if (table != NULL)
+		ops->free(table);
+	return ret;
+}
+
+static int
+test_table_swx_perf(void)
+{
+	static const uint32_t n_keys[] = {64, 1024, 1 << 14, 1 << 18, 1 << 20};
+	unsigned int i;
+
+	printf("SWX exact match table, %u lookups in flight\n",
+	       TEST_SWX_PERF_IN_FLIGHT);
+	for (i = 0; i < RTE_DIM(n_keys); i++)
+		if (test_table_swx_em_perf_run(n_keys[i]) != 0)
+			return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_PERF_TEST(table_swx_perf_autotest, test_table_swx_perf);
@@ -7,6 +7,14 @@
 #include <string.h>
 #include <rte_byteorder.h>
 #include <rte_table_lpm_ipv6.h>
+#include <rte_swx_ctl.h>
+#include <rte_swx_pipeline.h>
+#include <rte_swx_port_ring.h>
+#include <rte_swx_port_source_sink.h>
+#include <rte_swx_table_em.h>
+#include <rte_swx_table_learner.h>
+#include <rte_swx_table_lpm.h>
+#include <rte_ip6.h>
 #include <rte_lru.h>
 #include <rte_cycles.h>
 #include "test_table_tables.h"
@@ -20,6 +28,12 @@ table_test table_tests[] = {
 	test_table_hash_lru,
 	test_table_hash_ext,
 	test_table_hash_cuckoo,
+	test_table_swx_lpm,
+	test_table_swx_lpm_ipv6,
+	test_table_swx_em,
+	test_table_swx_learner,
+	test_table_swx_em_inplace,
+	test_table_swx_ctl_inplace,
 };
 
 #define PREPARE_PACKET(mbuf, value) do {				\
@@ -1055,4 +1069,691 @@ test_table_hash_cuckoo(void)
 	return 0;
 }
 
+/*
+ * Complete a SWX table lookup, return the action ID on hit and -1 on miss.
+ * The number of lookup steps is returned in n_steps when not NULL.
+ */
+static int64_t
+test_table_swx_lookup_steps(struct rte_swx_table_ops *ops, void *table,
+	void *mailbox, uint8_t *key, uint32_t *n_steps)
+{
+	uint8_t *action_data;
+	uint64_t action_id;
+	size_t entry_id;
+	uint32_t n = 1;
+	int hit;
+
+	while (ops->lkp(table, mailbox, &key, &action_id, &action_data,
+			&entry_id, &hit) == 0)
+		n++;
+
+	if (n_steps != NULL)
+		*n_steps = n;
+
+	return hit ? (int64_t)action_id : -1;
+}
+
+static int64_t
+test_table_swx_lookup(struct rte_swx_table_ops *ops, void *table,
+	void *mailbox, uint8_t *key)
+{
+	return test_table_swx_lookup_steps(ops, table, mailbox, key, NULL);
+}
+
+static int
+test_table_swx_add(struct rte_swx_table_ops *ops, void *table,
+	uint8_t *key, uint8_t *key_mask, uint64_t action_id)
+{
+	struct rte_swx_table_entry entry = {
+		.key = key,
+		.key_mask = key_mask,
+		.action_id = action_id,
+	};
+
+	return ops->add(table, &entry);
+}
+
+static int
+test_table_swx_del(struct rte_swx_table_ops *ops, void *table,
+	uint8_t *key, uint8_t *key_mask)
+{
+	struct rte_swx_table_entry entry = {
+		.key = key,
+		.key_mask = key_mask,
+	};
+
+	return ops->del(table, &entry);
+}
+
+int
+test_table_swx_lpm(void)
+{
+	struct rte_swx_table_ops *ops = &rte_swx_table_lpm_ops;
+	struct rte_swx_table_params params = {
+		.match_type = RTE_SWX_TABLE_MATCH_LPM,
+		.key_size = 8,
+		.n_keys_max = 4,
+	};
+	struct rte_swx_table_entry entry = { 0 };
+	uint8_t mask8[4] = {0xff, 0, 0, 0};
+	uint8_t mask12[4] = {0xff, 0xf0, 0, 0};
+	uint8_t mask16[4] = {0xff, 0xff, 0, 0};
+	uint8_t mask24[4] = {0xff, 0xff, 0xff, 0};
+	uint8_t mask_bad[4] = {0xff, 0, 0xff, 0};
+	uint8_t net8[4] = {10, 0, 0, 0};
+	uint8_t net12[4] = {172, 16, 0, 0};
+	uint8_t net16[4] = {10, 1, 0, 0};
+	uint8_t net24[4] = {10, 1, 2, 0};
+	uint8_t net_new[4] = {192, 168, 0, 0};
+	uint8_t ip_24[4] = {10, 1, 2, 3};
+	uint8_t ip_16[4] = {10, 1, 3, 3};
+	uint8_t ip_8[4] = {10, 2, 0, 1};
+	uint8_t ip_miss[4] = {11, 0, 0, 1};
+	uint8_t ip_new[4] = {192, 168, 1, 1};
+	void *table;
+
+	/* Create, the keys are IPv4 or IPv6 addresses */
+	table = ops->create(NULL, NULL, NULL, 0);
+	if (table != NULL)
+		return -1;
+
+	table = ops->create(&params, NULL, NULL, 0);
+	if (table != NULL)
+		return -2;
+
+	params.key_size = 4;
+	table = ops->create(&params, NULL, NULL, 0);
+	if (table == NULL)
+		return -3;
+
+	/* Add */
+	if (ops->add(table, NULL) == 0)
+		return -4;
+
+	if (ops->add(table, &entry) == 0)
+		return -5;
+
+	if (test_table_swx_add(ops, table, net24, mask_bad, 1) == 0)
+		return -6;
+
+	if (test_table_swx_add(ops, table, net8, mask8, 1) != 0 ||
+	    test_table_swx_add(ops, table, net16, mask16, 2) != 0 ||
+	    test_table_swx_add(ops, table, net24, mask24, 3) != 0)
+		return -7;
+
+	/* Lookup of the longest prefix */
+	if (test_table_swx_lookup(ops, table, NULL, ip_24) != 3 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_16) != 2 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_8) != 1 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_miss) != -1)
+		return -8;
+
+	/* Existing prefix updated */
+	if (test_table_swx_add(ops, table, net16, mask16, 4) != 0 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_16) != 4)
+		return -9;
+
+	/* Full table */
+	if (test_table_swx_add(ops, table, net12, mask12, 5) != 0)
+		return -10;
+
+	if (test_table_swx_add(ops, table, net_new, mask16, 6) != -ENOSPC)
+		return -11;
+
+	/* Delete, the shorter prefix matches */
+	if (test_table_swx_del(ops, table, net24, mask24) != 0 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_24) != 4)
+		return -12;
+
+	if (test_table_swx_del(ops, table, net24, mask24) != 0)
+		return -13;
+
+	/* Entry of the deleted prefix reused */
+	if (test_table_swx_add(ops, table, net_new, mask16, 6) != 0 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_new) != 6 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_8) != 1)
+		return -14;
+
+	ops->free(table);
+
+	return 0;
+}
+
+int
+test_table_swx_lpm_ipv6(void)
+{
+	struct rte_swx_table_ops *ops = &rte_swx_table_lpm_ops;
+	struct rte_swx_table_params params = {
+		.match_type = RTE_SWX_TABLE_MATCH_LPM,
+		.key_size = 16,
+		.n_keys_max = 16,
+	};
+	struct rte_ipv6_addr mask32 = RTE_IPV6(0xffff, 0xffff, 0, 0, 0, 0, 0, 0);
+	struct rte_ipv6_addr mask48 = RTE_IPV6(0xffff, 0xffff, 0xffff, 0, 0, 0, 0, 0);
+	struct rte_ipv6_addr net32 = RTE_IPV6(0x2001, 0xdb8, 0, 0, 0, 0, 0, 0);
+	struct rte_ipv6_addr net48 = RTE_IPV6(0x2001, 0xdb8, 1, 0, 0, 0, 0, 0);
+	struct rte_ipv6_addr ip_48 = RTE_IPV6(0x2001, 0xdb8, 1, 0, 0, 0, 0, 1);
+	struct rte_ipv6_addr ip_32 = RTE_IPV6(0x2001, 0xdb8, 2, 0, 0, 0, 0, 1);
+	struct rte_ipv6_addr ip_miss = RTE_IPV6(0x2001, 0xdb9, 1, 0, 0, 0, 0, 1);
+	void *table;
+
+	table = ops->create(&params, NULL, NULL, 0);
+	if (table == NULL)
+		return -1;
+
+	/* Add */
+	if (test_table_swx_add(ops, table, net32.a, mask32.a, 1) != 0 ||
+	    test_table_swx_add(ops, table, net48.a, mask48.a, 2) != 0)
+		return -2;
+
+	/* Lookup of the longest prefix */
+	if (test_table_swx_lookup(ops, table, NULL, ip_48.a) != 2 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_32.a) != 1 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_miss.a) != -1)
+		return -3;
+
+	/* Delete, the shorter prefix matches */
+	if (test_table_swx_del(ops, table, net48.a, mask48.a) != 0 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_48.a) != 1)
+		return -4;
+
+	if (test_table_swx_del(ops, table, net32.a, mask32.a) != 0 ||
+	    test_table_swx_lookup(ops, table, NULL, ip_32.a) != -1)
+		return -5;
+
+	ops->free(table);
+
+	return 0;
+}
+
+/*
+ * The lookup of the small exact match tables is completed in one step,
+ * the one of the large tables is split into steps prefetching the data.
+ */
+static int
+test_table_swx_em_steps(uint32_t n_keys_max, int single_step)
+{
+	struct rte_swx_table_ops *ops = &rte_swx_table_exact_match_ops;
+	struct rte_swx_table_params params = {
+		.match_type = RTE_SWX_TABLE_MATCH_EXACT,
+		.key_size = 16,
+		.action_data_size = 8,
+		.n_keys_max = n_keys_max,
+	};
+	uint8_t key[16] = {1}, key_miss[16] = {2};
+	uint32_t n_hit, n_miss;
+	void *table, *mailbox;
+	int status = 0;
+
+	table = ops->create(&params, NULL, NULL, 0);
+	if (table == NULL)
+		return -1;
+
+	mailbox = calloc(1, ops->mailbox_size_get());
+	if (mailbox == NULL) {
+		ops->free(table);
+		return -2;
+	}
+
+	if (test_table_swx_add(ops, table, key, NULL, 7) != 0)
+		status = -3;
+	else if (test_table_swx_lookup_steps(ops, table, mailbox, key, &n_hit) != 7 ||
+		 test_table_swx_lookup_steps(ops, table, mailbox, key_miss, &n_miss) != -1)
+		status = -4;
+	else if (single_step ? (n_hit != 1 || n_miss != 1) : (n_hit == 1 || n_miss == 1))
+		status = -5;
+
+	free(mailbox);
+	ops->free(table);
+
+	return status;
+}
+
+int
+test_table_swx_em(void)
+{
+	int status;
+
+	status = test_table_swx_em_steps(64, 1);
+	if (status < 0)
+		return status;
+
+	status = test_table_swx_em_steps(1 << 16, 0);
+	if (status < 0)
+		return status - 10;
+
+	return 0;
+}
+
+/* Learner table lookup, return the action ID on hit and -1 on miss */
+static int64_t
+test_table_swx_learner_lookup(void *table, void *mailbox, uint64_t time,
+	uint8_t *key, uint32_t *n_steps)
+{
+	uint8_t *action_data;
+	uint64_t action_id;
+	size_t entry_id;
+	uint32_t n = 1;
+	int hit;
+
+	while (rte_swx_table_learner_lookup(table, mailbox, time, &key, &action_id,
+			&action_data, &entry_id, &hit) == 0)
+		n++;
+
+	*n_steps = n;
+
+	return hit ? (int64_t)action_id : -1;
+}
+
+/* Same as test_table_swx_em_steps() for the learner tables */
+static int
+test_table_swx_learner_steps(uint32_t n_keys_max, int single_step)
+{
+	uint32_t key_timeout[] = {60};
+	struct rte_swx_table_learner_params params = {
+		.key_size = 16,
+		.action_data_size = 8,
+		.n_keys_max = n_keys_max,
+		.key_timeout = key_timeout,
+		.n_key_timeouts = RTE_DIM(key_timeout),
+	};
+	uint8_t key[16] = {1}, key_miss[16] = {2};
+	uint8_t action_data[8] = {0};
+	uint32_t n_hit, n_miss, n_add;
+	void *table, *mailbox;
+	uint64_t time;
+	int status = 0;
+
+	table = rte_swx_table_learner_create(&params, 0);
+	if (table == NULL)
+		return -1;
+
+	mailbox = calloc(1, rte_swx_table_learner_mailbox_size_get());
+	if (mailbox == NULL) {
+		rte_swx_table_learner_free(table);
+		return -2;
+	}
+
+	/* The key missed by the latest lookup is learned */
+	time = rte_get_tsc_cycles();
+	if (test_table_swx_learner_lookup(table, mailbox, time, key, &n_add) != -1 ||
+	    rte_swx_table_learner_add(table, mailbox, time, 7, action_data, 0) != 0)
+		status = -3;
+	else if (test_table_swx_learner_lookup(table, mailbox, time, key, &n_hit) != 7 ||
+		 test_table_swx_learner_lookup(table, mailbox, time, key_miss,
+						&n_miss) != -1)
+		status = -4;
+	else if (single_step ? (n_hit != 1 || n_miss != 1) : (n_hit == 1 || n_miss == 1))
+		status = -5;
+
+	free(mailbox);
+	rte_swx_table_learner_free(table);
+
+	return status;
+}
+
+int
+test_table_swx_learner(void)
+{
+	int status;
+
+	status = test_table_swx_learner_steps(64, 1);
+	if (status < 0)
+		return status;
+
+	status = test_table_swx_learner_steps(1 << 16, 0);
+	if (status < 0)
+		return status - 10;
+
+	return 0;
+}
+
+/* Exact match table in place update: the released keys are only reused after reclaim */
+int
+test_table_swx_em_inplace(void)
+{
+	struct rte_swx_table_ops *ops = &rte_swx_table_exact_match_ops;
+	struct rte_swx_table_params params = {
+		.match_type = RTE_SWX_TABLE_MATCH_EXACT,
+		.key_size = 16,
+		.action_data_size = 8,
+		.n_keys_max = 4,
+	};
+	uint8_t keys[5][16] = {{1}, {2}, {3}, {4}, {5}};
+	void *table, *mailbox;
+	int status = 0;
+	uint32_t i;
+
+	table = ops->create(&params, NULL, NULL, 0);
+	if (table == NULL)
+		return -1;
+
+	mailbox = calloc(1, ops->mailbox_size_get());
+	if (mailbox == NULL) {
+		ops->free(table);
+		return -2;
+	}
+
+	if (rte_swx_table_exact_match_inplace_update_set(NULL, 1) != -EINVAL ||
+	    rte_swx_table_exact_match_inplace_update_set(table, 1) != 0) {
+		status = -3;
+		goto end;
+	}
+
+	/* Full table. */
+	for (i = 0; i < 4; i++)
+		if (test_table_swx_add(ops, table, keys[i], NULL, i) != 0) {
+			status = -4;
+			goto end;
+		}
+
+	/* No free key to update an existing entry. */
+	if (test_table_swx_add(ops, table, keys[0], NULL, 10) != -ENOSPC ||
+	    test_table_swx_lookup(ops, table, mailbox, keys[0]) != 0) {
+		status = -5;
+		goto end;
+	}
+
+	/* The deleted key is not reused before reclaim. */
+	if (test_table_swx_del(ops, table, keys[3], NULL) != 0 ||
+	    test_table_swx_lookup(ops, table, mailbox, keys[3]) != -1 ||
+	    test_table_swx_add(ops, table, keys[4], NULL, 4) != -ENOSPC ||
+	    rte_swx_table_exact_match_inplace_update_set(table, 0) != -EBUSY) {
+		status = -6;
+		goto end;
+	}
+
+	rte_swx_table_exact_match_reclaim(table);
+
+	if (test_table_swx_add(ops, table, keys[4], NULL, 4) != 0 ||
+	    test_table_swx_lookup(ops, table, mailbox, keys[4]) != 4) {
+		status = -7;
+		goto end;
+	}
+
+	/* Entry update through a new key, the old key is released. */
+	if (test_table_swx_del(ops, table, keys[4], NULL) != 0)  {
+		status = -8;
+		goto end;
+	}
+
+	rte_swx_table_exact_match_reclaim(table);
+
+	if (test_table_swx_add(ops, table, keys[0], NULL, 10) != 0 ||
+	    test_table_swx_lookup(ops, table, mailbox, keys[0]) != 10 ||
+	    test_table_swx_add(ops, table, keys[4], NULL, 4) != -ENOSPC) {
+		status = -9;
+		goto end;
+	}
+
+	rte_swx_table_exact_match_reclaim(table);
+
+	if (test_table_swx_add(ops, table, keys[4], NULL, 4) != 0) {
+		status = -10;
+		goto end;
+	}
+
+	/* Back to the immediate reuse of the released keys. */
+	if (rte_swx_table_exact_match_inplace_update_set(table, 0) != 0 ||
+	    test_table_swx_add(ops, table, keys[1], NULL, 11) != 0 ||
+	    test_table_swx_lookup(ops, table, mailbox, keys[1]) != 11 ||
+	    test_table_swx_del(ops, table, keys[4], NULL) != 0 ||
+	    test_table_swx_add(ops, table, keys[3], NULL, 3) != 0)
+		status = -11;
+
+end:
+	free(mailbox);
+	ops->free(table);
+
+	return status;
+}
+
+#define TEST_SWX_CTL_NAME "test_swx_ctl"
+#define TEST_SWX_CTL_TABLE "t"
+
+static struct rte_swx_pipeline *
+test_table_swx_ctl_pipeline_create(uint32_t table_size)
+{
+	struct rte_swx_field_params meta_fields[] = {
+		{"key", 32},
+		{"port", 32},
+		{"value", 32},
+	};
+	struct rte_swx_field_params fwd_args_fields[] = {
+		{"value", 32},
+	};
+	struct rte_swx_match_field_params match_fields[] = {
+		{"m.key", RTE_SWX_TABLE_MATCH_EXACT},
+	};
+	const char *fwd_instructions[] = {"mov m.value t.value", "return"};
+	const char *nop_instructions[] = {"return"};
+	const char *action_names[] = {"fwd", "nop"};
+	const char *instructions[] = {"rx m.port", "table " TEST_SWX_CTL_TABLE, "tx m.port"};
+	struct rte_swx_port_ring_reader_params port_in_params = {
+		.name = TEST_SWX_CTL_NAME,
+		.burst_size = 32,
+	};
+	struct rte_swx_port_sink_params port_out_params = {
+		.file_name = NULL,
+	};
+	struct rte_swx_pipeline_table_params table_params = {
+		.fields = match_fields,
+		.n_fields = RTE_DIM(match_fields),
+		.action_names = action_names,
+		.n_actions = RTE_DIM(action_names),
+		.default_action_name = "nop",
+	};
+	struct rte_swx_pipeline *p;
+
+	if (rte_swx_pipeline_config(&p, TEST_SWX_CTL_NAME, 0))
+		return NULL;
+
+	if (rte_swx_pipeline_port_in_config(p, 0, "ring", &port_in_params) ||
+	    rte_swx_pipeline_port_out_config(p, 0, "sink", &port_out_params) ||
+	    rte_swx_pipeline_struct_type_register(p, "meta_t", meta_fields,
+						  RTE_DIM(meta_fields), 0) ||
+	    rte_swx_pipeline_packet_metadata_register(p, "meta_t") ||
+	    rte_swx_pipeline_struct_type_register(p, "fwd_args_t", fwd_args_fields,
+						  RTE_DIM(fwd_args_fields), 0) ||
+	    rte_swx_pipeline_action_config(p, "fwd", "fwd_args_t", fwd_instructions,
+					   RTE_DIM(fwd_instructions)) ||
+	    rte_swx_pipeline_action_config(p, "nop", NULL, nop_instructions,
+					   RTE_DIM(nop_instructions)) ||
+	    rte_swx_pipeline_table_config(p, TEST_SWX_CTL_TABLE, &table_params, "exact",
+					  NULL, table_size) ||
+	    rte_swx_pipeline_instructions_config(p, instructions, RTE_DIM(instructions)) ||
+	    rte_swx_pipeline_build(p)) {
+		rte_swx_pipeline_free(p);
+		return NULL;
+	}
+
+	return p;
+}
+
+static void
+test_table_swx_ctl_entry_free(struct rte_swx_table_entry *entry)
+{
+	free(entry->key);
+	free(entry->key_mask);
+	free(entry->action_data);
+	free(entry);
+}
+
+/* Schedule the table entry add (when add is non-zero) or delete described by line */
+static int
+test_table_swx_ctl_entry_set(struct rte_swx_ctl_pipeline *ctl, const char *line, int add)
+{
+	struct rte_swx_table_entry *entry;
+	int status;
+
+	entry = rte_swx_ctl_pipeline_table_entry_read(ctl, TEST_SWX_CTL_TABLE, line, NULL);
+	if (entry == NULL)
+		return -EINVAL;
+
+	if (add)
+		status = rte_swx_ctl_pipeline_table_entry_add(ctl, TEST_SWX_CTL_TABLE, entry);
+	else
+		status = rte_swx_ctl_pipeline_table_entry_delete(ctl, TEST_SWX_CTL_TABLE, entry);
+
+	test_table_swx_ctl_entry_free(entry);
+	return status;
+}
+
+/*
+ * Look up the key of the table entry described by line in the table in use by the
+ * pipeline. Return 1 on hit with the action of this entry, 0 on miss and -1 otherwise.
+ */
+static int
+test_table_swx_ctl_entry_check(struct rte_swx_pipeline *p, struct rte_swx_ctl_pipeline *ctl,
+	void *mailbox, const char *line)
+{
+	struct rte_swx_table_ops *ops = &rte_swx_table_exact_match_ops;
+	struct rte_swx_table_entry *entry;
+	struct rte_swx_table_state *ts;
+	uint8_t *key, *action_data;
+	uint64_t action_id;
+	size_t entry_id;
+	int hit, status;
+
+	if (rte_swx_pipeline_table_state_get(p, &ts))
+		return -1;
+
+	entry = rte_swx_ctl_pipeline_table_entry_read(ctl, TEST_SWX_CTL_TABLE, line, NULL);
+	if (entry == NULL)
+		return -1;
+
+	key = entry->key;
+	while (ops->lkp(ts[0].obj, mailbox, &key, &action_id, &action_data,
+			&entry_id, &hit) == 0)
+		;
+
+	if (!hit)
+		status = 0;
+	else if (entry->action_data != NULL && action_id == entry->action_id &&
+		 !memcmp(action_data, entry->action_data, sizeof(uint32_t)))
+		status = 1;
+	else
+		status = -1;
+
+	test_table_swx_ctl_entry_free(entry);
+	return status;
+}
+
+/* Pipeline commit with the table updated in place */
+int
+test_table_swx_ctl_inplace(void)
+{
+	struct rte_swx_ctl_table_commit_stats stats;
+	struct rte_swx_ctl_pipeline *ctl = NULL;
+	struct rte_swx_pipeline *p = NULL;
+	struct rte_ring *r;
+	void *mailbox = NULL;
+	int status = 0;
+
+	r = rte_ring_create(TEST_SWX_CTL_NAME, 64, SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (r == NULL)
+		return -1;
+
+	p = test_table_swx_ctl_pipeline_create(4);
+	if (p == NULL) {
+		status = -2;
+		goto end;
+	}
+
+	ctl = rte_swx_ctl_pipeline_create(p);
+	mailbox = calloc(1, rte_swx_table_exact_match_ops.mailbox_size_get());
+	if (ctl == NULL || mailbox == NULL) {
+		status = -3;
+		goto end;
+	}
+
+	if (rte_swx_ctl_pipeline_table_inplace_update_set(ctl, "unknown", 1) != -EINVAL ||
+	    rte_swx_ctl_pipeline_table_inplace_update_set(ctl, TEST_SWX_CTL_TABLE, 1) != 0) {
+		status = -4;
+		goto end;
+	}
+
+	/* Full table. */
+	if (test_table_swx_ctl_entry_set(ctl, "match 1 action fwd value 1", 1) ||
+	    test_table_swx_ctl_entry_set(ctl, "match 2 action fwd value 2", 1) ||
+	    test_table_swx_ctl_entry_set(ctl, "match 3 action fwd value 3", 1) ||
+	    test_table_swx_ctl_entry_set(ctl, "match 4 action fwd value 4", 1) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != 0 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 1 action fwd value 1") != 1 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 4 action fwd value 4") != 1) {
+		status = -5;
+		goto end;
+	}
+
+	/* Commit on a full table: no free entry for the update of an existing entry. */
+	if (test_table_swx_ctl_entry_set(ctl, "match 1 action fwd value 11", 1) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != -ENOSPC ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 1 action fwd value 1") != 1) {
+		status = -6;
+		goto end;
+	}
+
+	/* The deleted entry is reclaimed at the end of the commit. */
+	if (test_table_swx_ctl_entry_set(ctl, "match 4", 0) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != 0 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 4 action fwd value 4") != 0 ||
+	    test_table_swx_ctl_entry_set(ctl, "match 5 action fwd value 5", 1) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != 0 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 5 action fwd value 5") != 1) {
+		status = -7;
+		goto end;
+	}
+
+	/* Rollback: the entry added before the failed update is deleted and reclaimed. */
+	if (test_table_swx_ctl_entry_set(ctl, "match 5", 0) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != 0 ||
+	    test_table_swx_ctl_entry_set(ctl, "match 6 action fwd value 6", 1) ||
+	    test_table_swx_ctl_entry_set(ctl, "match 1 action fwd value 11", 1) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != -ENOSPC ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 6 action fwd value 6") != 0 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 1 action fwd value 1") != 1) {
+		status = -8;
+		goto end;
+	}
+
+	if (test_table_swx_ctl_entry_set(ctl, "match 1 action fwd value 11", 1) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != 0 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 1 action fwd value 11") != 1 ||
+	    test_table_swx_ctl_entry_set(ctl, "match 6 action fwd value 6", 1) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != 0 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 6 action fwd value 6") != 1) {
+		status = -9;
+		goto end;
+	}
+
+	if (rte_swx_ctl_pipeline_table_commit_stats_read(ctl, TEST_SWX_CTL_TABLE, &stats) ||
+	    stats.n_commits != 6) {
+		status = -10;
+		goto end;
+	}
+
+	/* Shadow copy: the update of an existing entry does not need a free entry. */
+	if (rte_swx_ctl_pipeline_table_inplace_update_set(ctl, TEST_SWX_CTL_TABLE, 0) ||
+	    test_table_swx_ctl_entry_set(ctl, "match 2 action fwd value 12", 1) ||
+	    rte_swx_ctl_pipeline_commit(ctl, 1) != 0 ||
+	    test_table_swx_ctl_entry_check(p, ctl, mailbox, "match 2 action fwd value 12") != 1) {
+		status = -11;
+		goto end;
+	}
+
+	/* Grace period: no packet is in progress, whether the pipeline was run or not. */
+	rte_swx_pipeline_run(p, 64);
+	if (rte_swx_pipeline_grace_period_wait(NULL) != -EINVAL ||
+	    rte_swx_pipeline_grace_period_wait(p) != 0)
+		status = -12;
+
+end:
+	free(mailbox);
+	rte_swx_ctl_pipeline_free(ctl);
+	rte_swx_pipeline_free(p);
+	rte_ring_free(r);
+
+	return status;
+}
+
 #endif /* !RTE_EXEC_ENV_WINDOWS */
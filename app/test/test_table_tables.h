@@ -14,6 +14,12 @@ int test_table_hash_unoptimized(void);
 int test_table_hash_lru(void);
 int test_table_hash_ext(void);
 int test_table_stub(void);
+int test_table_swx_lpm(void);
+int test_table_swx_lpm_ipv6(void);
+int test_table_swx_em(void);
+int test_table_swx_learner(void);
+int test_table_swx_em_inplace(void);
+int test_table_swx_ctl_inplace(void);
 
 /* Extern variables */
 typedef int (*table_test)(void);
@@ -0,0 +1,296 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+#include "test.h"
+
+static int
+telemetry_shm_autotest(void)
+{
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_eth_ring.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_ring.h>
+#include <rte_telemetry.h>
+
+#include "test.h"
+#include "telemetry_shm.h"
+
+static const char * const test_names[] = { "packets", "bytes", "errors" };
+
+/* Read the values of a block as an external reader would */
+static int
+read_block(const void *base, const char *name, uint64_t *values,
+		unsigned int num)
+{
+	const struct tel_shm_header *hdr = base;
+	const struct tel_shm_block *b;
+	const uint64_t *src;
+	uint32_t i, sn;
+
+	for (i = 0; i < hdr->num_blocks; i++) {
+		b = RTE_PTR_ADD(base, hdr->blocks_offset + i * sizeof(*b));
+		if (strcmp(b->name, name) != 0)
+			continue;
+		if (b->num != num)
+			return -1;
+		src = RTE_PTR_ADD(base, hdr->values_offset +
+				b->first * sizeof(uint64_t));
+		do {
+			sn = rte_seqcount_read_begin(&b->seqcount);
+			memcpy(values, src, num * sizeof(*values));
+		} while (rte_seqcount_read_retry(&b->seqcount, sn));
+		return 0;
+	}
+
+	return -1;
+}
+
+/* Map the shared memory file as an external reader would */
+static void *
+map_shm(size_t *size)
+{
+	char path[PATH_MAX];
+	struct stat st;
+	void *base;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/dpdk_telemetry_shm",
+			rte_eal_get_runtime_dir());
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("cannot open %s, telemetry disabled?\n", path);
+		return NULL;
+	}
+	if (fstat(fd, &st) < 0) {
+		close(fd);
+		return NULL;
+	}
+	base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return NULL;
+
+	*size = st.st_size;
+	return base;
+}
+
+/* Extended statistics of a port exported by ethdev */
+static int
+test_ethdev_xstats_shm(void)
+{
+	struct rte_mbuf mbuf, *pkts[] = { &mbuf, &mbuf };
+	struct rte_eth_xstat_name *names;
+	struct rte_eth_xstat *xstats;
+	struct rte_ring *ring;
+	uint64_t *read;
+	size_t size;
+	void *base;
+	int i, num, port, ret;
+
+	ring = rte_ring_create("tel_shm", 16, SOCKET_ID_ANY,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(ring, "cannot create ring");
+	port = rte_eth_from_rings("net_ring_tel_shm", &ring, 1, &ring, 1,
+			SOCKET_ID_ANY);
+	if (port < 0) {
+		rte_ring_free(ring);
+		TEST_ASSERT(false, "cannot create ring port");
+	}
+
+	TEST_ASSERT_EQUAL(rte_eth_xstats_shm_update(RTE_MAX_ETHPORTS), -ENODEV,
+			"invalid port accepted");
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(port, 0, pkts, RTE_DIM(pkts)),
+			RTE_DIM(pkts), "cannot send packets");
+	TEST_ASSERT_SUCCESS(rte_eth_xstats_shm_update(port),
+			"cannot export xstats");
+
+	num = rte_eth_xstats_get(port, NULL, 0);
+	TEST_ASSERT(num > 0, "no xstats");
+	xstats = calloc(num, sizeof(*xstats));
+	names = calloc(num, sizeof(*names));
+	read = calloc(num, sizeof(*read));
+	TEST_ASSERT(xstats != NULL && names != NULL && read != NULL,
+			"cannot allocate xstats");
+	TEST_ASSERT_EQUAL(rte_eth_xstats_get(port, xstats, num), num,
+			"cannot get xstats");
+	TEST_ASSERT_EQUAL(rte_eth_xstats_get_names(port, names, num), num,
+			"cannot get xstats names");
+
+	base = map_shm(&size);
+	if (base == NULL) {
+		ret = TEST_SKIPPED;
+		goto out;
+	}
+	ret = read_block(base, "net_ring_tel_shm", read, num);
+	munmap(base, size);
+	TEST_ASSERT_SUCCESS(ret, "port block not found");
+	for (i = 0; i < num; i++) {
+		TEST_ASSERT_EQUAL(read[i], xstats[i].value, "unexpected %s",
+				names[i].name);
+		if (strcmp(names[i].name, "tx_good_packets") == 0)
+			TEST_ASSERT_EQUAL(read[i], RTE_DIM(pkts),
+					"unexpected tx_good_packets");
+	}
+	ret = TEST_SUCCESS;
+
+out:
+	free(read);
+	free(names);
+	free(xstats);
+	rte_eth_dev_close(port);
+	rte_ring_free(ring);
+	return ret;
+}
+
+/* The block of a port follows the device which got the port */
+static int
+test_ethdev_xstats_shm_rename(void)
+{
+	struct rte_ring *ring;
+	uint64_t *read;
+	int num, port, port2, found_old, found_new;
+	size_t size;
+	void *base;
+
+	ring = rte_ring_create("tel_shm_rename", 16, SOCKET_ID_ANY,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(ring, "cannot create ring");
+	port = rte_eth_from_rings("net_ring_tel_shm_old", &ring, 1, &ring, 1,
+			SOCKET_ID_ANY);
+	if (port < 0) {
+		rte_ring_free(ring);
+		TEST_ASSERT(false, "cannot create ring port");
+	}
+	TEST_ASSERT_SUCCESS(rte_eth_xstats_shm_update(port),
+			"cannot export xstats");
+	rte_eth_dev_close(port);
+
+	/* the port identifier is given to another device */
+	port2 = rte_eth_from_rings("net_ring_tel_shm_new", &ring, 1, &ring, 1,
+			SOCKET_ID_ANY);
+	if (port2 < 0) {
+		rte_ring_free(ring);
+		TEST_ASSERT(false, "cannot create ring port");
+	}
+	if (port2 != port) {
+		printf("port %d not reused\n", port);
+		rte_eth_dev_close(port2);
+		rte_ring_free(ring);
+		return TEST_SKIPPED;
+	}
+	TEST_ASSERT_SUCCESS(rte_eth_xstats_shm_update(port),
+			"cannot export xstats of the new device");
+
+	num = rte_eth_xstats_get(port, NULL, 0);
+	read = num > 0 ? calloc(num, sizeof(*read)) : NULL;
+	base = map_shm(&size);
+	if (read == NULL || base == NULL) {
+		if (base != NULL)
+			munmap(base, size);
+		free(read);
+		rte_eth_dev_close(port);
+		rte_ring_free(ring);
+		return base == NULL ? TEST_SKIPPED : TEST_FAILED;
+	}
+	found_old = read_block(base, "net_ring_tel_shm_old", read, num) == 0;
+	found_new = read_block(base, "net_ring_tel_shm_new", read, num) == 0;
+	munmap(base, size);
+	free(read);
+	rte_eth_dev_close(port);
+	rte_ring_free(ring);
+
+	TEST_ASSERT(!found_old, "block of the previous device not removed");
+	TEST_ASSERT(found_new, "block of the new device not found");
+
+	return TEST_SUCCESS;
+}
+
+static int
+telemetry_shm_autotest(void)
+{
+	uint64_t values[RTE_DIM(test_names)] = { 1, 2, 3 };
+	uint64_t read[RTE_DIM(test_names)];
+	const char *bad_names[] = { "" };
+	size_t size;
+	void *base;
+	int block, block2, ret;
+
+	TEST_ASSERT_EQUAL(rte_telemetry_shm_register("test", bad_names, 1),
+			-EINVAL, "empty name accepted");
+	TEST_ASSERT_EQUAL(rte_telemetry_shm_register(NULL, test_names,
+			RTE_DIM(test_names)), -EINVAL, "NULL block name accepted");
+
+	block = rte_telemetry_shm_register("test_shm", test_names,
+			RTE_DIM(test_names));
+	TEST_ASSERT(block >= 0, "cannot register block: %d", block);
+
+	TEST_ASSERT_EQUAL(rte_telemetry_shm_update(block, values,
+			RTE_DIM(values) + 1), -EINVAL, "too many values accepted");
+	TEST_ASSERT_EQUAL(rte_telemetry_shm_update(block + 1, values, 1),
+			-EINVAL, "invalid block accepted");
+	TEST_ASSERT_SUCCESS(rte_telemetry_shm_update(block, values,
+			RTE_DIM(values)), "cannot update block");
+
+	base = map_shm(&size);
+	if (base == NULL)
+		return TEST_SKIPPED;
+
+	TEST_ASSERT_SUCCESS(memcmp(base, TEL_SHM_MAGIC, 8), "bad magic");
+	TEST_ASSERT_SUCCESS(read_block(base, "test_shm", read, RTE_DIM(read)),
+			"block not found");
+	TEST_ASSERT_BUFFERS_ARE_EQUAL(read, values, sizeof(values),
+			"unexpected values");
+
+	values[0] = 10;
+	TEST_ASSERT_SUCCESS(rte_telemetry_shm_update(block, values, 1),
+			"cannot update first value");
+	TEST_ASSERT_SUCCESS(read_block(base, "test_shm", read, RTE_DIM(read)),
+			"block not found");
+	TEST_ASSERT_BUFFERS_ARE_EQUAL(read, values, sizeof(values),
+			"unexpected values after partial update");
+
+	/* a removed block is hidden, and reused by the next block */
+	TEST_ASSERT_SUCCESS(rte_telemetry_shm_unregister(block),
+			"cannot remove block");
+	TEST_ASSERT_EQUAL(rte_telemetry_shm_unregister(block), -EINVAL,
+			"block removed twice");
+	TEST_ASSERT_EQUAL(rte_telemetry_shm_update(block, values, 1), -EINVAL,
+			"removed block updated");
+	TEST_ASSERT_FAIL(read_block(base, "test_shm", read, RTE_DIM(read)),
+			"removed block found");
+	block2 = rte_telemetry_shm_register("test_shm2", test_names,
+			RTE_DIM(test_names) - 1);
+	TEST_ASSERT_EQUAL(block2, block, "removed block not reused");
+	TEST_ASSERT_SUCCESS(read_block(base, "test_shm2", read,
+			RTE_DIM(read) - 1), "reused block not found");
+	TEST_ASSERT(read[0] == 0 && read[1] == 0,
+			"values of the removed block kept");
+	TEST_ASSERT_SUCCESS(rte_telemetry_shm_unregister(block2),
+			"cannot remove reused block");
+
+	munmap(base, size);
+
+	ret = test_ethdev_xstats_shm();
+	if (ret != TEST_SUCCESS)
+		return ret;
+	return test_ethdev_xstats_shm_rename();
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_FAST_TEST(telemetry_shm_autotest, true, true, telemetry_shm_autotest);
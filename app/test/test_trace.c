@@ -2,6 +2,8 @@
  * Copyright(C) 2020 Marvell International Ltd.
  */
 
+#include <inttypes.h>
+
 #include <rte_eal_trace.h>
 #include <rte_lcore.h>
 #include <rte_random.h>
@@ -133,6 +135,18 @@ test_trace_mode(void)
 
 	current = rte_trace_mode_get();
 
+	/* Stream mode cannot be left at runtime */
+	if (current == RTE_TRACE_MODE_STREAM) {
+		rte_trace_mode_set(RTE_TRACE_MODE_DISCARD);
+		if (rte_trace_mode_get() != RTE_TRACE_MODE_STREAM)
+			goto failed;
+		return TEST_SUCCESS;
+	}
+
+	rte_trace_mode_set(RTE_TRACE_MODE_STREAM);
+	if (rte_trace_mode_get() != current)
+		goto failed;
+
 	rte_trace_mode_set(RTE_TRACE_MODE_DISCARD);
 	if (rte_trace_mode_get() != RTE_TRACE_MODE_DISCARD)
 		goto failed;
@@ -211,6 +225,43 @@ test_generic_trace_points(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_trace_stream(void)
+{
+	struct rte_trace_stream_stats stats;
+	uint64_t bytes;
+	unsigned int i;
+
+	if (rte_trace_mode_get() != RTE_TRACE_MODE_STREAM) {
+		TEST_ASSERT_EQUAL(rte_trace_stream_stats_get(&stats), -ENOTSUP,
+			"Stream stats available out of stream mode");
+		return TEST_SKIPPED;
+	}
+
+	TEST_ASSERT_EQUAL(rte_trace_stream_stats_get(NULL), -EINVAL,
+		"Invalid stats pointer accepted");
+	TEST_ASSERT_SUCCESS(rte_trace_stream_stats_get(&stats),
+		"Failed to get stream stats");
+	bytes = stats.bytes;
+
+	if (!rte_trace_point_is_enabled(&__rte_eal_trace_generic_u64))
+		return TEST_SKIPPED;
+
+	/* Record more than the trace buffer can hold */
+	for (i = 0; i < 1024 * 1024; i++)
+		rte_eal_trace_generic_u64(i);
+
+	/* The full parts of the buffer are written, not the current one */
+	TEST_ASSERT_SUCCESS(rte_trace_save(), "Failed to save trace");
+	TEST_ASSERT_SUCCESS(rte_trace_stream_stats_get(&stats),
+		"Failed to get stream stats");
+	TEST_ASSERT(stats.bytes > bytes, "No trace streamed");
+	printf("Streamed %" PRIu64 " bytes, dropped %" PRIu64 " events\n",
+		stats.bytes - bytes, stats.drops);
+
+	return TEST_SUCCESS;
+}
+
 static int
 test_trace_dump(void)
 {
@@ -236,6 +287,7 @@ static struct unit_test_suite trace_tests = {
 		TEST_CASE(test_trace_point_globbing),
 		TEST_CASE(test_trace_point_regex),
 		TEST_CASE(test_trace_points_lookup),
+		TEST_CASE(test_trace_stream),
 		TEST_CASE(test_trace_dump),
 		TEST_CASE(test_trace_metadata_dump),
 		TEST_CASES_END()
@@ -107,6 +107,7 @@
 /* rte_graph defines */
 #define RTE_GRAPH_BURST_SIZE 256
 #define RTE_LIBRTE_GRAPH_STATS 1
+// RTE_LIBRTE_GRAPH_HISTOGRAM is not set
 
 /****** driver defines ********/
 
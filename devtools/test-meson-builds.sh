@@ -241,6 +241,10 @@ done
 build build-mini cc skipABI $use_shared -Ddisable_libs=* \
 	-Denable_drivers=net/null
 
+# test compilation of the graph histograms, disabled by default
+build build-graph-histogram cc skipABI $use_shared \
+	-Dc_args=-DRTE_LIBRTE_GRAPH_HISTOGRAM=1 -Denable_drivers=net/null
+
 # test compilation with minimal x86 instruction set
 # Set the install path for libraries to "lib" explicitly to prevent problems
 # with pkg-config prefixes if installed in "lib/x86_64-linux-gnu" later.
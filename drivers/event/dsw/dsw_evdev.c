@@ -2,11 +2,18 @@
  * Copyright(c) 2018 Ericsson AB
  */
 
+#include <errno.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <rte_cycles.h>
 #include <eventdev_pmd.h>
 #include <eventdev_pmd_vdev.h>
+#include <rte_errno.h>
+#include <rte_kvargs.h>
+#include <rte_malloc.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_random.h>
 #include <rte_ring_elem.h>
 
@@ -14,6 +21,15 @@
 
 #define EVENTDEV_NAME_DSW_PMD event_dsw
 
+#define PORTS_ARG "ports"
+#define QUEUES_ARG "queues"
+#define FLOW_BITS_ARG "flow_bits"
+#define MIGRATION_POLICY_ARG "migration_policy"
+#define MIGRATION_INTERVAL_ARG "migration_interval"
+#define MIN_SOURCE_LOAD_ARG "min_source_load"
+#define MAX_TARGET_LOAD_ARG "max_target_load"
+#define LATENCY_ARG "latency"
+
 static int
 dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	       const struct rte_event_port_conf *conf)
@@ -67,10 +83,11 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	port->ctl_in_ring = ctl_in_ring;
 
 	port->load_update_interval =
-		(DSW_LOAD_UPDATE_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(DSW_LOAD_UPDATE_INTERVAL(dsw->migration_interval) *
+		 rte_get_timer_hz()) / US_PER_S;
 
 	port->migration_interval =
-		(DSW_MIGRATION_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(dsw->migration_interval * rte_get_timer_hz()) / US_PER_S;
 
 	dev->data->ports[port_id] = port;
 
@@ -206,16 +223,18 @@ dsw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 }
 
 static void
-dsw_info_get(struct rte_eventdev *dev __rte_unused,
+dsw_info_get(struct rte_eventdev *dev,
 	     struct rte_event_dev_info *info)
 {
+	struct dsw_evdev *dsw = dsw_pmd_priv(dev);
+
 	*info = (struct rte_event_dev_info) {
 		.driver_name = DSW_PMD_NAME,
-		.max_event_queues = DSW_MAX_QUEUES,
-		.max_event_queue_flows = DSW_MAX_FLOWS,
+		.max_event_queues = dsw->max_queues,
+		.max_event_queue_flows = dsw->num_flows,
 		.max_event_queue_priority_levels = 1,
 		.max_event_priority_levels = 1,
-		.max_event_ports = DSW_MAX_PORTS,
+		.max_event_ports = dsw->max_ports,
 		.max_event_port_dequeue_depth = DSW_MAX_PORT_DEQUEUE_DEPTH,
 		.max_event_port_enqueue_depth = DSW_MAX_PORT_ENQUEUE_DEPTH,
 		.max_num_events = DSW_MAX_EVENTS,
@@ -260,7 +279,7 @@ initial_flow_to_port_assignment(struct dsw_evdev *dsw)
 	for (queue_id = 0; queue_id < dsw->num_queues; queue_id++) {
 		struct dsw_queue *queue = &dsw->queues[queue_id];
 		uint16_t flow_hash;
-		for (flow_hash = 0; flow_hash < DSW_MAX_FLOWS; flow_hash++) {
+		for (flow_hash = 0; flow_hash < dsw->num_flows; flow_hash++) {
 			uint8_t skip = rte_rand_max(queue->num_serving_ports);
 			uint8_t port_id;
 
@@ -438,15 +457,192 @@ static struct eventdev_ops dsw_evdev_ops = {
 	.xstats_get_by_name = dsw_xstats_get_by_name
 };
 
+static int
+set_int_range(const char *value, int min, int max, int *res)
+{
+	char *end;
+	long v;
+
+	errno = 0;
+	v = strtol(value, &end, 0);
+	if (errno != 0 || end == value || *end != '\0' || v < min || v > max)
+		return -EINVAL;
+
+	*res = v;
+	return 0;
+}
+
+static int
+set_ports(const char *key __rte_unused, const char *value, void *opaque)
+{
+	return set_int_range(value, 1, DSW_MAX_PORTS, opaque);
+}
+
+static int
+set_queues(const char *key __rte_unused, const char *value, void *opaque)
+{
+	return set_int_range(value, 1, DSW_MAX_QUEUES, opaque);
+}
+
+static int
+set_flow_bits(const char *key __rte_unused, const char *value, void *opaque)
+{
+	return set_int_range(value, 1, DSW_MAX_FLOWS_BITS, opaque);
+}
+
+static int
+set_migration_policy(const char *key __rte_unused, const char *value,
+		     void *opaque)
+{
+	int *policy = opaque;
+
+	if (strcmp(value, "events") == 0)
+		*policy = DSW_MIGRATION_POLICY_EVENTS;
+	else if (strcmp(value, "cost") == 0)
+		*policy = DSW_MIGRATION_POLICY_COST;
+	else
+		return -EINVAL;
+
+	return 0;
+}
+
+static int
+set_migration_interval(const char *key __rte_unused, const char *value,
+		       void *opaque)
+{
+	/* The load update interval is a fourth of the migration interval */
+	return set_int_range(value, 4, US_PER_S, opaque);
+}
+
+static int
+set_load_percent(const char *key __rte_unused, const char *value,
+		 void *opaque)
+{
+	return set_int_range(value, 0, 100, opaque);
+}
+
+static int
+set_latency(const char *key __rte_unused, const char *value, void *opaque)
+{
+	return set_int_range(value, 0, 1, opaque);
+}
+
+struct dsw_args {
+	int ports;
+	int queues;
+	int flow_bits;
+	int migration_policy;
+	int migration_interval;
+	int min_source_load;
+	int max_target_load;
+	int latency;
+};
+
+static int
+dsw_parse_args(const char *name, const char *params, struct dsw_args *args)
+{
+	static const char *const valid_args[] = {
+		PORTS_ARG,
+		QUEUES_ARG,
+		FLOW_BITS_ARG,
+		MIGRATION_POLICY_ARG,
+		MIGRATION_INTERVAL_ARG,
+		MIN_SOURCE_LOAD_ARG,
+		MAX_TARGET_LOAD_ARG,
+		LATENCY_ARG,
+		NULL
+	};
+	const struct {
+		const char *key;
+		arg_handler_t handler;
+		int *value;
+	} handlers[] = {
+		{ PORTS_ARG, set_ports, &args->ports },
+		{ QUEUES_ARG, set_queues, &args->queues },
+		{ FLOW_BITS_ARG, set_flow_bits, &args->flow_bits },
+		{ MIGRATION_POLICY_ARG, set_migration_policy,
+		  &args->migration_policy },
+		{ MIGRATION_INTERVAL_ARG, set_migration_interval,
+		  &args->migration_interval },
+		{ MIN_SOURCE_LOAD_ARG, set_load_percent,
+		  &args->min_source_load },
+		{ MAX_TARGET_LOAD_ARG, set_load_percent,
+		  &args->max_target_load },
+		{ LATENCY_ARG, set_latency, &args->latency }
+	};
+	struct rte_kvargs *kvlist;
+	unsigned int i;
+	int ret = 0;
+
+	if (params == NULL || params[0] == '\0')
+		return 0;
+
+	kvlist = rte_kvargs_parse(params, valid_args);
+	if (kvlist == NULL) {
+		RTE_LOG_LINE(INFO, EVENT_DSW,
+			"Ignoring unsupported parameters when creating device '%s'",
+			name);
+		return 0;
+	}
+
+	for (i = 0; i < RTE_DIM(handlers); i++) {
+		ret = rte_kvargs_process(kvlist, handlers[i].key,
+					 handlers[i].handler, handlers[i].value);
+		if (ret != 0) {
+			RTE_LOG_LINE(ERR, EVENT_DSW,
+				"%s: Error parsing %s parameter", name,
+				handlers[i].key);
+			break;
+		}
+	}
+
+	rte_kvargs_free(kvlist);
+
+	return ret;
+}
+
 static int
 dsw_probe(struct rte_vdev_device *vdev)
 {
 	const char *name;
 	struct rte_eventdev *dev;
 	struct dsw_evdev *dsw;
+	struct dsw_args args = {
+		.ports = DSW_MAX_PORTS,
+		.queues = DSW_DEFAULT_QUEUES,
+		.flow_bits = DSW_DEFAULT_FLOWS_BITS,
+		.migration_policy = DSW_MIGRATION_POLICY_EVENTS,
+		.migration_interval = DSW_MIGRATION_INTERVAL,
+		.min_source_load = DSW_MIN_SOURCE_LOAD_PERCENT,
+		.max_target_load = DSW_MAX_TARGET_LOAD_PERCENT,
+		.latency = 0
+	};
+	int lat_ts_offset = -1;
+	int ret;
 
 	name = rte_vdev_device_name(vdev);
 
+	ret = dsw_parse_args(name, rte_vdev_device_args(vdev), &args);
+	if (ret != 0)
+		return ret;
+
+	if (args.latency) {
+		static const struct rte_mbuf_dynfield lat_ts_dynfield_desc = {
+			.name = "dsw_enq_ts_dynfield",
+			.size = sizeof(uint64_t),
+			.align = alignof(uint64_t)
+		};
+
+		lat_ts_offset =
+			rte_mbuf_dynfield_register(&lat_ts_dynfield_desc);
+		if (lat_ts_offset < 0) {
+			RTE_LOG_LINE(ERR, EVENT_DSW,
+				"%s: Error registering timestamp mbuf field",
+				name);
+			return -rte_errno;
+		}
+	}
+
 	dev = rte_event_pmd_vdev_init(name, sizeof(struct dsw_evdev),
 				      rte_socket_id(), vdev);
 	if (dev == NULL)
@@ -465,6 +661,31 @@ dsw_probe(struct rte_vdev_device *vdev)
 	dsw = dev->data->dev_private;
 	dsw->data = dev->data;
 
+	dsw->max_ports = args.ports;
+	dsw->max_queues = args.queues;
+	dsw->flows_bits = args.flow_bits;
+	dsw->num_flows = 1 << args.flow_bits;
+	dsw->flows_mask = dsw->num_flows - 1;
+	dsw->migration_policy = args.migration_policy;
+	dsw->migration_interval = args.migration_interval;
+	dsw->min_source_load = DSW_LOAD_FROM_PERCENT(args.min_source_load);
+	dsw->max_target_load = DSW_LOAD_FROM_PERCENT(args.max_target_load);
+	dsw->latency = args.latency;
+	dsw->lat_ts_offset = lat_ts_offset;
+
+	dsw->ports = rte_zmalloc_socket(name,
+					sizeof(struct dsw_port) * dsw->max_ports,
+					RTE_CACHE_LINE_SIZE, rte_socket_id());
+	dsw->queues = rte_zmalloc_socket(name,
+					 sizeof(struct dsw_queue) * dsw->max_queues,
+					 RTE_CACHE_LINE_SIZE, rte_socket_id());
+	if (dsw->ports == NULL || dsw->queues == NULL) {
+		rte_free(dsw->ports);
+		rte_free(dsw->queues);
+		rte_event_pmd_release(dev);
+		return -ENOMEM;
+	}
+
 	event_dev_probing_finish(dev);
 	return 0;
 }
@@ -472,13 +693,31 @@ dsw_probe(struct rte_vdev_device *vdev)
 static int
 dsw_remove(struct rte_vdev_device *vdev)
 {
+	struct dsw_port *ports = NULL;
+	struct dsw_queue *queues = NULL;
+	struct rte_eventdev *dev;
 	const char *name;
+	int ret;
 
 	name = rte_vdev_device_name(vdev);
 	if (name == NULL)
 		return -EINVAL;
 
-	return rte_event_pmd_vdev_uninit(name);
+	dev = rte_event_pmd_get_named_dev(name);
+	if (dev != NULL && rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		struct dsw_evdev *dsw = dsw_pmd_priv(dev);
+
+		ports = dsw->ports;
+		queues = dsw->queues;
+	}
+
+	ret = rte_event_pmd_vdev_uninit(name);
+	if (ret == 0) {
+		rte_free(ports);
+		rte_free(queues);
+	}
+
+	return ret;
 }
 
 static struct rte_vdev_driver evdev_dsw_pmd_drv = {
@@ -487,4 +726,9 @@ static struct rte_vdev_driver evdev_dsw_pmd_drv = {
 };
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_DSW_PMD, evdev_dsw_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(EVENTDEV_NAME_DSW_PMD, PORTS_ARG "=<int> "
+		QUEUES_ARG "=<int> " FLOW_BITS_ARG "=<int> "
+		MIGRATION_POLICY_ARG "=events|cost "
+		MIGRATION_INTERVAL_ARG "=<int> " MIN_SOURCE_LOAD_ARG "=<int> "
+		MAX_TARGET_LOAD_ARG "=<int> " LATENCY_ARG "=<int>");
 RTE_LOG_REGISTER_DEFAULT(event_dsw_logtype, NOTICE);
@@ -13,15 +13,25 @@
 
 #define DSW_PMD_NAME RTE_STR(event_dsw)
 
+/* Upper limits of the "ports" and "queues" devargs. The port and
+ * queue arrays are allocated for the configured limits only.
+ */
 #define DSW_MAX_PORTS (64)
 #define DSW_MAX_PORT_DEQUEUE_DEPTH (128)
 #define DSW_MAX_PORT_ENQUEUE_DEPTH (128)
 #define DSW_MAX_PORT_OUT_BUFFER (32)
 
-#define DSW_MAX_QUEUES (16)
+#define DSW_MAX_QUEUES (64)
+#define DSW_DEFAULT_QUEUES (16)
 
 #define DSW_MAX_EVENTS (16384)
 
+/* Buckets of the event residency histograms, kept when the "latency"
+ * devarg is set. Bucket N counts the events which resided
+ * [2^(N-1), 2^N) timer cycles in the event device.
+ */
+#define DSW_LAT_HIST_BUCKETS (32)
+
 /* Multiple 24-bit flow ids will map to the same DSW-level flow. The
  * number of DSW flows should be high enough make it unlikely that
  * flow ids of several large flows hash to the same DSW-level flow.
@@ -32,12 +42,13 @@
  * being very small. The effect of migrating such flows will be small,
  * in terms amount of processing load redistributed. This will in turn
  * reduce the load balancing speed, since flow migration rate has an
- * upper limit. Code changes are required to allow > 32k DSW-level
- * flows.
+ * upper limit. The number of DSW-level flows is set with the
+ * "flow_bits" devarg. Code changes are required to allow > 32k
+ * DSW-level flows.
  */
-#define DSW_MAX_FLOWS_BITS (13)
+#define DSW_MAX_FLOWS_BITS (15)
 #define DSW_MAX_FLOWS (1<<(DSW_MAX_FLOWS_BITS))
-#define DSW_MAX_FLOWS_MASK (DSW_MAX_FLOWS-1)
+#define DSW_DEFAULT_FLOWS_BITS (13)
 
 /* Eventdev RTE_SCHED_TYPE_PARALLEL doesn't have a concept of flows,
  * but the 'dsw' scheduler (more or less) randomly assign flow id to
@@ -84,18 +95,22 @@
  * source ports, to be migrated too quickly to a lightly loaded port -
  * in particular since this might cause the system to oscillate.
  */
-#define DSW_LOAD_UPDATE_INTERVAL (DSW_MIGRATION_INTERVAL/4)
+#define DSW_LOAD_UPDATE_INTERVAL(migration_interval) ((migration_interval)/4)
 #define DSW_OLD_LOAD_WEIGHT (1)
 
-/* The minimum time (in us) between two flow migrations. What puts an
- * upper limit on the actual migration rate is primarily the pace in
- * which the ports send and receive control messages, which in turn is
- * largely a function of how much cycles are spent the processing of
- * an event burst.
+/* The default minimum time (in us) between two flow migrations. What
+ * puts an upper limit on the actual migration rate is primarily the
+ * pace in which the ports send and receive control messages, which in
+ * turn is largely a function of how much cycles are spent the
+ * processing of an event burst.
+ *
+ * The interval and the load thresholds may be changed with the
+ * "migration_interval", "min_source_load" and "max_target_load"
+ * devargs.
  */
 #define DSW_MIGRATION_INTERVAL (1000)
-#define DSW_MIN_SOURCE_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(70))
-#define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(95))
+#define DSW_MIN_SOURCE_LOAD_PERCENT (70)
+#define DSW_MAX_TARGET_LOAD_PERCENT (95)
 #define DSW_REBALANCE_THRESHOLD (DSW_LOAD_FROM_PERCENT(3))
 
 #define DSW_MAX_EVENTS_RECORDED (128)
@@ -126,6 +141,29 @@ struct dsw_queue_flow {
 	uint16_t flow_hash;
 };
 
+/* How the load of a flow is estimated, when selecting the flows to
+ * migrate.
+ */
+enum dsw_migration_policy {
+	/* In proportion to the number of events of the flow among
+	 * the recently dequeued events.
+	 */
+	DSW_MIGRATION_POLICY_EVENTS,
+	/* In proportion to the cycles spent processing the recently
+	 * dequeued events of the flow. A flow with expensive events
+	 * is then not mistaken for a light one.
+	 */
+	DSW_MIGRATION_POLICY_COST
+};
+
+struct dsw_seen_event {
+	struct dsw_queue_flow queue_flow;
+	/* Processing cost of the event in TSC cycles, or zero if not
+	 * yet known.
+	 */
+	uint32_t cost;
+};
+
 enum dsw_migration_state {
 	DSW_MIGRATION_STATE_IDLE,
 	DSW_MIGRATION_STATE_FINISH_PENDING,
@@ -177,6 +215,8 @@ struct __rte_cache_aligned dsw_port {
 	uint64_t emigration_start;
 	uint64_t emigrations;
 	uint64_t emigration_latency;
+	uint64_t emigration_latency_max;
+	uint64_t emigration_aborts;
 
 	uint8_t emigration_target_port_ids[DSW_MAX_FLOWS_PER_MIGRATION];
 	struct dsw_queue_flow
@@ -186,6 +226,9 @@ struct __rte_cache_aligned dsw_port {
 
 	uint64_t immigrations;
 
+	uint64_t flows_paused;
+	uint64_t events_paused;
+
 	uint16_t paused_flows_len;
 	struct dsw_queue_flow paused_flows[DSW_MAX_PAUSED_FLOWS];
 
@@ -204,7 +247,14 @@ struct __rte_cache_aligned dsw_port {
 
 	uint16_t seen_events_len;
 	uint16_t seen_events_idx;
-	struct dsw_queue_flow seen_events[DSW_MAX_EVENTS_RECORDED];
+	struct dsw_seen_event seen_events[DSW_MAX_EVENTS_RECORDED];
+
+	/* The cost of the last dequeued burst is known at the next
+	 * dequeue, when the cost migration policy is used.
+	 */
+	uint64_t cost_burst_start;
+	uint16_t cost_burst_idx;
+	uint16_t cost_burst_len;
 
 	uint64_t enqueue_calls;
 	uint64_t new_enqueued;
@@ -215,6 +265,7 @@ struct __rte_cache_aligned dsw_port {
 	uint64_t dequeue_calls;
 	uint64_t dequeued;
 	uint64_t queue_dequeued[DSW_MAX_QUEUES];
+	uint64_t queue_residency[DSW_MAX_QUEUES][DSW_LAT_HIST_BUCKETS];
 
 	uint16_t out_buffer_len[DSW_MAX_PORTS];
 	struct rte_event out_buffer[DSW_MAX_PORTS][DSW_MAX_PORT_OUT_BUFFER];
@@ -250,12 +301,26 @@ static_assert(DSW_MAX_PORTS <= 64, "Max compile-time port count exceeded");
 struct dsw_evdev {
 	struct rte_eventdev_data *data;
 
-	struct dsw_port ports[DSW_MAX_PORTS];
+	struct dsw_port *ports;
 	uint16_t num_ports;
-	struct dsw_queue queues[DSW_MAX_QUEUES];
+	struct dsw_queue *queues;
 	uint8_t num_queues;
 	int32_t max_inflight;
 
+	/* Set by the devargs at probe time. */
+	uint16_t max_ports;
+	uint8_t max_queues;
+	uint8_t flows_bits;
+	uint16_t num_flows;
+	uint16_t flows_mask;
+	enum dsw_migration_policy migration_policy;
+	uint32_t migration_interval;
+	int16_t min_source_load;
+	int16_t max_target_load;
+	bool latency;
+	/* mbuf dynfield holding the enqueue timestamp, with "latency" */
+	int lat_ts_offset;
+
 	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(int32_t) credits_on_loan;
 };
 
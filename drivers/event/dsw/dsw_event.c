@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include <rte_cycles.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_memcpy.h>
 #include <rte_random.h>
 
@@ -118,6 +119,57 @@ dsw_port_queue_dequeued_stats(struct dsw_port *source_port, uint8_t queue_id)
 	source_port->queue_dequeued[queue_id]++;
 }
 
+/* Only events carrying an mbuf have their residency measured. */
+static __rte_always_inline bool
+dsw_event_has_mbuf(const struct rte_event *event)
+{
+	return (event->event_type == RTE_EVENT_TYPE_ETHDEV ||
+		event->event_type == RTE_EVENT_TYPE_ETH_RX_ADAPTER) &&
+		event->mbuf != NULL;
+}
+
+static void
+dsw_port_stamp_events(struct dsw_evdev *dsw, const struct rte_event *events,
+		      uint16_t num)
+{
+	uint64_t now = rte_get_timer_cycles();
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+		const struct rte_event *event = &events[i];
+
+		if (event->op != RTE_EVENT_OP_RELEASE &&
+		    dsw_event_has_mbuf(event))
+			*RTE_MBUF_DYNFIELD(event->mbuf, dsw->lat_ts_offset,
+					   uint64_t *) = now;
+	}
+}
+
+static void
+dsw_port_record_residency(struct dsw_port *port,
+			  const struct rte_event *events, uint16_t num)
+{
+	uint64_t now = rte_get_timer_cycles();
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+		const struct rte_event *event = &events[i];
+		uint64_t enqueued_at;
+		uint32_t bucket;
+
+		if (!dsw_event_has_mbuf(event))
+			continue;
+
+		enqueued_at = *RTE_MBUF_DYNFIELD(event->mbuf,
+						 port->dsw->lat_ts_offset,
+						 uint64_t *);
+		bucket = RTE_MIN(rte_fls_u64(now - enqueued_at),
+				 (uint32_t)DSW_LAT_HIST_BUCKETS - 1);
+
+		port->queue_residency[event->queue_id][bucket]++;
+	}
+}
+
 static void
 dsw_port_load_record(struct dsw_port *port, unsigned int dequeued)
 {
@@ -329,6 +381,8 @@ dsw_port_handle_pause_flows(struct dsw_evdev *dsw, struct dsw_port *port,
 		.originating_port_id = port->id
 	};
 
+	port->flows_paused += qfs_len;
+
 	/* There might be already-scheduled events belonging to the
 	 * paused flow in the output buffers.
 	 */
@@ -347,6 +401,7 @@ dsw_port_handle_pause_flows(struct dsw_evdev *dsw, struct dsw_port *port,
 struct dsw_queue_flow_burst {
 	struct dsw_queue_flow queue_flow;
 	uint16_t count;
+	uint64_t cost;
 };
 
 #define DSW_QF_TO_INT(_qf)					\
@@ -361,30 +416,84 @@ dsw_cmp_qf(const void *v_qf_a, const void *v_qf_b)
 	return DSW_QF_TO_INT(qf_a) - DSW_QF_TO_INT(qf_b);
 }
 
-static uint16_t
-dsw_sort_qfs_to_bursts(struct dsw_queue_flow *qfs, uint16_t qfs_len,
-		       struct dsw_queue_flow_burst *bursts)
+static inline int
+dsw_cmp_seen(const void *v_seen_a, const void *v_seen_b)
 {
+	const struct dsw_seen_event *seen_a = v_seen_a;
+	const struct dsw_seen_event *seen_b = v_seen_b;
+
+	return dsw_cmp_qf(&seen_a->queue_flow, &seen_b->queue_flow);
+}
+
+/* The events of the last dequeued burst have no known cost yet, and
+ * are given the average cost of the other events.
+ */
+static void
+dsw_fill_unknown_costs(struct dsw_seen_event *seen, uint16_t seen_len)
+{
+	uint64_t known_cost = 0;
+	uint16_t num_known = 0;
+	uint32_t avg_cost;
 	uint16_t i;
+
+	for (i = 0; i < seen_len; i++)
+		if (seen[i].cost > 0) {
+			known_cost += seen[i].cost;
+			num_known++;
+		}
+
+	if (num_known == 0 || num_known == seen_len)
+		return;
+
+	avg_cost = known_cost / num_known;
+
+	for (i = 0; i < seen_len; i++)
+		if (seen[i].cost == 0)
+			seen[i].cost = avg_cost;
+}
+
+static uint16_t
+dsw_sort_seen_to_bursts(struct dsw_evdev *dsw,
+			const struct dsw_seen_event *seen_events,
+			uint16_t seen_len,
+			struct dsw_queue_flow_burst *bursts,
+			uint64_t *total_cost)
+{
+	struct dsw_seen_event seen[DSW_MAX_EVENTS_RECORDED];
 	struct dsw_queue_flow_burst *current_burst = NULL;
 	uint16_t num_bursts = 0;
+	uint16_t i;
+
+	/* The port's record is left untouched, since the costs of
+	 * the last dequeued burst are yet to be filled in.
+	 */
+	rte_memcpy(seen, seen_events, seen_len * sizeof(seen[0]));
+
+	if (dsw->migration_policy == DSW_MIGRATION_POLICY_COST)
+		dsw_fill_unknown_costs(seen, seen_len);
 
 	/* We don't need the stable property, and the list is likely
 	 * large enough for qsort() to outperform dsw_stable_sort(),
 	 * so we use qsort() here.
 	 */
-	qsort(qfs, qfs_len, sizeof(qfs[0]), dsw_cmp_qf);
+	qsort(seen, seen_len, sizeof(seen[0]), dsw_cmp_seen);
+
+	*total_cost = 0;
 
 	/* arrange the (now-consecutive) events into bursts */
-	for (i = 0; i < qfs_len; i++) {
+	for (i = 0; i < seen_len; i++) {
 		if (i == 0 ||
-		    dsw_cmp_qf(&qfs[i], &current_burst->queue_flow) != 0) {
+		    dsw_cmp_qf(&seen[i].queue_flow,
+			       &current_burst->queue_flow) != 0) {
 			current_burst = &bursts[num_bursts];
-			current_burst->queue_flow = qfs[i];
+			current_burst->queue_flow = seen[i].queue_flow;
 			current_burst->count = 0;
+			current_burst->cost = 0;
 			num_bursts++;
 		}
 		current_burst->count++;
+		current_burst->cost += seen[i].cost;
+		*total_cost += seen[i].cost;
 	}
 
 	return num_bursts;
@@ -416,20 +525,26 @@ dsw_retrieve_port_loads(struct dsw_evdev *dsw, int16_t *port_loads,
 }
 
 static int16_t
-dsw_flow_load(uint16_t num_events, int16_t port_load)
+dsw_flow_load(struct dsw_evdev *dsw, const struct dsw_queue_flow_burst *burst,
+	      uint64_t total_cost, int16_t port_load)
 {
-	return ((int32_t)port_load * (int32_t)num_events) /
+	/* Without any measured cost, fall back to the event count */
+	if (dsw->migration_policy == DSW_MIGRATION_POLICY_COST &&
+	    total_cost > 0)
+		return ((uint64_t)port_load * burst->cost) / total_cost;
+
+	return ((int32_t)port_load * (int32_t)burst->count) /
 		DSW_MAX_EVENTS_RECORDED;
 }
 
 static int16_t
-dsw_evaluate_migration(int16_t source_load, int16_t target_load,
-		       int16_t flow_load)
+dsw_evaluate_migration(struct dsw_evdev *dsw, int16_t source_load,
+		       int16_t target_load, int16_t flow_load)
 {
 	int32_t res_target_load;
 	int32_t imbalance;
 
-	if (target_load > DSW_MAX_TARGET_LOAD_FOR_MIGRATION)
+	if (target_load > dsw->max_target_load)
 		return -1;
 
 	imbalance = source_load - target_load;
@@ -465,7 +580,7 @@ static bool
 dsw_select_emigration_target(struct dsw_evdev *dsw,
 			     struct dsw_port *source_port,
 			     struct dsw_queue_flow_burst *bursts,
-			     uint16_t num_bursts,
+			     uint16_t num_bursts, uint64_t total_cost,
 			     int16_t *port_loads, uint16_t num_ports,
 			     uint8_t *target_port_ids,
 			     struct dsw_queue_flow *target_qfs,
@@ -478,7 +593,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 	int16_t candidate_flow_load = -1;
 	uint16_t i;
 
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION)
+	if (source_port_load < dsw->min_source_load)
 		return false;
 
 	for (i = 0; i < num_bursts; i++) {
@@ -491,7 +606,8 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 					     qf->queue_id, qf->flow_hash))
 			continue;
 
-		flow_load = dsw_flow_load(burst->count, source_port_load);
+		flow_load = dsw_flow_load(dsw, burst, total_cost,
+					  source_port_load);
 
 		for (port_id = 0; port_id < num_ports; port_id++) {
 			int16_t weight;
@@ -502,7 +618,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 			if (!dsw_is_serving_port(dsw, port_id, qf->queue_id))
 				continue;
 
-			weight = dsw_evaluate_migration(source_port_load,
+			weight = dsw_evaluate_migration(dsw, source_port_load,
 							port_loads[port_id],
 							flow_load);
 
@@ -544,7 +660,8 @@ static void
 dsw_select_emigration_targets(struct dsw_evdev *dsw,
 			      struct dsw_port *source_port,
 			      struct dsw_queue_flow_burst *bursts,
-			      uint16_t num_bursts, int16_t *port_loads)
+			      uint16_t num_bursts, uint64_t total_cost,
+			      int16_t *port_loads)
 {
 	struct dsw_queue_flow *target_qfs = source_port->emigration_target_qfs;
 	uint8_t *target_port_ids = source_port->emigration_target_port_ids;
@@ -556,7 +673,8 @@ dsw_select_emigration_targets(struct dsw_evdev *dsw,
 
 		found = dsw_select_emigration_target(dsw, source_port,
 						     bursts, num_bursts,
-						     port_loads, dsw->num_ports,
+						     total_cost, port_loads,
+						     dsw->num_ports,
 						     target_port_ids,
 						     target_qfs,
 						     targets_len);
@@ -649,14 +767,14 @@ dsw_port_buffer_non_paused(struct dsw_evdev *dsw, struct dsw_port *source_port,
 
 #define DSW_FLOW_ID_BITS (24)
 static uint16_t
-dsw_flow_id_hash(uint32_t flow_id)
+dsw_flow_id_hash(struct dsw_evdev *dsw, uint32_t flow_id)
 {
 	uint16_t hash = 0;
 	uint16_t offset = 0;
 
 	do {
-		hash ^= ((flow_id >> offset) & DSW_MAX_FLOWS_MASK);
-		offset += DSW_MAX_FLOWS_BITS;
+		hash ^= ((flow_id >> offset) & dsw->flows_mask);
+		offset += dsw->flows_bits;
 	} while (offset < DSW_FLOW_ID_BITS);
 
 	return hash;
@@ -671,7 +789,7 @@ dsw_port_buffer_parallel(struct dsw_evdev *dsw, struct dsw_port *source_port,
 	event.flow_id = dsw_port_get_parallel_flow_id(source_port);
 
 	dest_port_id = dsw_schedule(dsw, event.queue_id,
-				    dsw_flow_id_hash(event.flow_id));
+				    dsw_flow_id_hash(dsw, event.flow_id));
 
 	dsw_port_buffer_non_paused(dsw, source_port, dest_port_id, &event);
 }
@@ -689,11 +807,12 @@ dsw_port_buffer_event(struct dsw_evdev *dsw, struct dsw_port *source_port,
 		return;
 	}
 
-	flow_hash = dsw_flow_id_hash(event->flow_id);
+	flow_hash = dsw_flow_id_hash(dsw, event->flow_id);
 
 	if (unlikely(dsw_port_is_flow_paused(source_port, event->queue_id,
 					     flow_hash))) {
 		dsw_port_buffer_paused(source_port, event);
+		source_port->events_paused++;
 		return;
 	}
 
@@ -722,7 +841,7 @@ dsw_port_flush_no_longer_paused_events(struct dsw_evdev *dsw,
 		struct rte_event *event = &paused_events[i];
 		uint16_t flow_hash;
 
-		flow_hash = dsw_flow_id_hash(event->flow_id);
+		flow_hash = dsw_flow_id_hash(dsw, event->flow_id);
 
 		if (dsw_port_is_flow_paused(source_port, event->queue_id,
 					    flow_hash))
@@ -747,6 +866,10 @@ dsw_port_emigration_stats(struct dsw_port *port, uint8_t finished)
 	flow_migration_latency =
 		(rte_get_timer_cycles() - port->emigration_start);
 	port->emigration_latency += (flow_migration_latency * finished);
+	if (finished)
+		port->emigration_latency_max =
+			RTE_MAX(port->emigration_latency_max,
+				flow_migration_latency);
 	port->emigrations += finished;
 }
 
@@ -832,9 +955,10 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 			     uint64_t now)
 {
 	bool any_port_below_limit;
-	struct dsw_queue_flow *seen_events = source_port->seen_events;
+	struct dsw_seen_event *seen_events = source_port->seen_events;
 	uint16_t seen_events_len = source_port->seen_events_len;
 	struct dsw_queue_flow_burst bursts[DSW_MAX_EVENTS_RECORDED];
+	uint64_t total_cost;
 	uint16_t num_bursts;
 	int16_t source_port_load;
 	int16_t port_loads[dsw->num_ports];
@@ -890,11 +1014,11 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	source_port_load =
 		rte_atomic_load_explicit(&source_port->load,
 					 rte_memory_order_relaxed);
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION) {
+	if (source_port_load < dsw->min_source_load) {
 		DSW_LOG_DP_PORT_LINE(DEBUG, source_port->id,
 		      "Load %d is below threshold level %d.",
 		      DSW_LOAD_TO_PERCENT(source_port_load),
-		      DSW_LOAD_TO_PERCENT(DSW_MIN_SOURCE_LOAD_FOR_MIGRATION));
+		      DSW_LOAD_TO_PERCENT(dsw->min_source_load));
 		return;
 	}
 
@@ -903,7 +1027,7 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	 */
 	any_port_below_limit =
 		dsw_retrieve_port_loads(dsw, port_loads,
-					DSW_MAX_TARGET_LOAD_FOR_MIGRATION);
+					dsw->max_target_load);
 	if (!any_port_below_limit) {
 		DSW_LOG_DP_PORT_LINE(DEBUG, source_port->id,
 				"Candidate target ports are all too highly "
@@ -911,8 +1035,8 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 		return;
 	}
 
-	num_bursts = dsw_sort_qfs_to_bursts(seen_events, seen_events_len,
-					    bursts);
+	num_bursts = dsw_sort_seen_to_bursts(dsw, seen_events, seen_events_len,
+					     bursts, &total_cost);
 
 	/* For non-big-little systems, there's no point in moving the
 	 * only (known) flow.
@@ -926,7 +1050,7 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	}
 
 	dsw_select_emigration_targets(dsw, source_port, bursts, num_bursts,
-				      port_loads);
+				      total_cost, port_loads);
 
 	if (source_port->emigration_targets_len == 0)
 		return;
@@ -959,6 +1083,8 @@ dsw_port_abort_migration(struct dsw_port *source_port)
 	source_port->emigration_targets_len = 0;
 
 	source_port->migration_state = DSW_MIGRATION_STATE_IDLE;
+
+	source_port->emigration_aborts++;
 }
 
 static void
@@ -1069,7 +1195,7 @@ dsw_port_stash_any_migrating_events(struct dsw_port *port,
 		uint16_t flow_hash;
 		struct rte_event *in_event = &events[i];
 
-		flow_hash = dsw_flow_id_hash(in_event->flow_id);
+		flow_hash = dsw_flow_id_hash(port->dsw, in_event->flow_id);
 
 		if (unlikely(dsw_port_is_flow_migrating(port,
 							in_event->queue_id,
@@ -1109,7 +1235,8 @@ dsw_port_drain_in_ring(struct dsw_port *source_port)
 			struct rte_event *event = &events[i];
 			uint16_t flow_hash;
 
-			flow_hash = dsw_flow_id_hash(event->flow_id);
+			flow_hash = dsw_flow_id_hash(source_port->dsw,
+						     event->flow_id);
 
 			if (unlikely(dsw_port_is_flow_migrating(source_port,
 								event->queue_id,
@@ -1137,7 +1264,7 @@ dsw_port_forward_emigrated_event(struct dsw_evdev *dsw,
 		struct dsw_port *dest_port = &dsw->ports[dest_port_id];
 
 		if (event->queue_id == qf->queue_id &&
-		    dsw_flow_id_hash(event->flow_id) == qf->flow_hash) {
+		    dsw_flow_id_hash(dsw, event->flow_id) == qf->flow_hash) {
 			/* No need to care about bursting forwarded
 			 * events (to the destination port's in_ring),
 			 * since migration doesn't happen very often,
@@ -1400,6 +1527,12 @@ dsw_event_enqueue_burst_generic(struct dsw_port *source_port,
 
 	dsw_port_enqueue_stats(source_port, num_new, num_forward, num_release);
 
+	/* The whole burst is accepted from here on, so only accepted
+	 * events are stamped.
+	 */
+	if (unlikely(dsw->latency))
+		dsw_port_stamp_events(dsw, events, events_len);
+
 	for (i = 0; i < events_len; i++) {
 		const struct rte_event *event = &events[i];
 
@@ -1466,10 +1599,12 @@ dsw_port_record_seen_events(struct dsw_port *port, struct rte_event *events,
 
 	for (i = 0; i < num; i++) {
 		uint16_t l_idx = port->seen_events_idx;
-		struct dsw_queue_flow *qf = &port->seen_events[l_idx];
+		struct dsw_seen_event *seen = &port->seen_events[l_idx];
 		struct rte_event *event = &events[i];
-		qf->queue_id = event->queue_id;
-		qf->flow_hash = dsw_flow_id_hash(event->flow_id);
+		seen->queue_flow.queue_id = event->queue_id;
+		seen->queue_flow.flow_hash =
+			dsw_flow_id_hash(port->dsw, event->flow_id);
+		seen->cost = 0;
 
 		port->seen_events_idx = (l_idx+1) % DSW_MAX_EVENTS_RECORDED;
 
@@ -1541,13 +1676,57 @@ dsw_port_dequeue_burst(struct dsw_port *port, struct rte_event *events,
 	return dequeued;
 }
 
+/* The cycles spent since the previous dequeue are the cost of
+ * processing the events of the previous burst.
+ */
+static void
+dsw_port_record_burst_cost(struct dsw_port *port, uint64_t now)
+{
+	uint16_t idx = port->cost_burst_idx;
+	uint32_t cost;
+	uint16_t i;
+
+	if (port->cost_burst_len == 0)
+		return;
+
+	cost = RTE_MIN((now - port->cost_burst_start) / port->cost_burst_len,
+		       (uint64_t)UINT32_MAX);
+	cost = RTE_MAX(cost, 1U);
+
+	for (i = 0; i < port->cost_burst_len; i++) {
+		port->seen_events[idx].cost = cost;
+		idx = (idx + 1) % DSW_MAX_EVENTS_RECORDED;
+	}
+
+	port->cost_burst_len = 0;
+}
+
+static void
+dsw_port_start_burst_cost(struct dsw_port *port, uint16_t num, uint64_t now)
+{
+	num = RTE_MIN(num, DSW_MAX_EVENTS_RECORDED);
+
+	port->cost_burst_start = now;
+	port->cost_burst_len = num;
+	/* The burst is recorded from the current index on */
+	port->cost_burst_idx = port->seen_events_idx;
+}
+
 uint16_t
 dsw_event_dequeue_burst(void *port, struct rte_event *events, uint16_t num,
 			uint64_t wait __rte_unused)
 {
 	struct dsw_port *source_port = port;
 	struct dsw_evdev *dsw = source_port->dsw;
+	bool record_cost =
+		dsw->migration_policy == DSW_MIGRATION_POLICY_COST;
 	uint16_t dequeued;
+	uint64_t now = 0;
+
+	if (record_cost) {
+		now = rte_get_timer_cycles();
+		dsw_port_record_burst_cost(source_port, now);
+	}
 
 	if (source_port->implicit_release) {
 		dsw_port_return_credits(dsw, port,
@@ -1580,7 +1759,12 @@ dsw_event_dequeue_burst(void *port, struct rte_event *events, uint16_t num,
 		 * have been gathered). However, that schema doesn't
 		 * seem to improve performance.
 		 */
+		if (record_cost)
+			dsw_port_start_burst_cost(source_port, dequeued, now);
 		dsw_port_record_seen_events(port, events, dequeued);
+		if (unlikely(dsw->latency))
+			dsw_port_record_residency(source_port, events,
+						  dequeued);
 	} else /* Zero-size dequeue means a likely idle port, and thus
 		* we can afford trading some efficiency for a slightly
 		* reduced event wall-time latency.
@@ -43,6 +43,17 @@ struct dsw_xstats_port {
 	const char *name_fmt;
 	dsw_xstats_port_get_value_fn get_value_fn;
 	bool per_queue;
+	/* One xstat per residency histogram bucket, with "latency" only */
+	bool per_bucket;
+};
+
+typedef
+uint64_t (*dsw_xstats_queue_get_value_fn)(struct dsw_evdev *dsw,
+					  uint8_t queue_id, uint8_t bucket);
+
+struct dsw_xstats_queue {
+	const char *name_fmt;
+	dsw_xstats_queue_get_value_fn get_value_fn;
 };
 
 static uint64_t
@@ -86,6 +97,9 @@ dsw_xstats_port_get_queue_dequeued(struct dsw_evdev *dsw, uint8_t port_id,
 
 DSW_GEN_PORT_ACCESS_FN(emigrations)
 DSW_GEN_PORT_ACCESS_FN(immigrations)
+DSW_GEN_PORT_ACCESS_FN(emigration_aborts)
+DSW_GEN_PORT_ACCESS_FN(flows_paused)
+DSW_GEN_PORT_ACCESS_FN(events_paused)
 
 static uint64_t
 dsw_xstats_port_get_migration_latency(struct dsw_evdev *dsw, uint8_t port_id,
@@ -97,6 +111,14 @@ dsw_xstats_port_get_migration_latency(struct dsw_evdev *dsw, uint8_t port_id,
 	return num_emigrations > 0 ? total_latency / num_emigrations : 0;
 }
 
+static uint64_t
+dsw_xstats_port_get_migration_latency_max(struct dsw_evdev *dsw,
+					  uint8_t port_id,
+					  uint8_t queue_id __rte_unused)
+{
+	return dsw->ports[port_id].emigration_latency_max;
+}
+
 static uint64_t
 dsw_xstats_port_get_event_proc_latency(struct dsw_evdev *dsw, uint8_t port_id,
 				       uint8_t queue_id __rte_unused)
@@ -133,6 +155,19 @@ dsw_xstats_port_get_load(struct dsw_evdev *dsw, uint8_t port_id,
 
 DSW_GEN_PORT_ACCESS_FN(last_bg)
 
+static uint64_t
+dsw_xstats_port_get_residency(struct dsw_evdev *dsw, uint8_t port_id,
+			      uint8_t bucket)
+{
+	uint64_t residency = 0;
+	uint8_t queue_id;
+
+	for (queue_id = 0; queue_id < dsw->num_queues; queue_id++)
+		residency += dsw->ports[port_id].queue_residency[queue_id][bucket];
+
+	return residency;
+}
+
 static struct dsw_xstats_port dsw_port_xstats[] = {
 	{ "port_%u_new_enqueued", dsw_xstats_port_get_new_enqueued,
 	  false },
@@ -150,8 +185,16 @@ static struct dsw_xstats_port dsw_port_xstats[] = {
 	  false },
 	{ "port_%u_migration_latency", dsw_xstats_port_get_migration_latency,
 	  false },
+	{ "port_%u_migration_latency_max",
+	  dsw_xstats_port_get_migration_latency_max, false },
+	{ "port_%u_migration_aborts", dsw_xstats_port_get_emigration_aborts,
+	  false },
 	{ "port_%u_immigrations", dsw_xstats_port_get_immigrations,
 	  false },
+	{ "port_%u_flows_paused", dsw_xstats_port_get_flows_paused,
+	  false },
+	{ "port_%u_events_paused", dsw_xstats_port_get_events_paused,
+	  false },
 	{ "port_%u_event_proc_latency", dsw_xstats_port_get_event_proc_latency,
 	  false },
 	{ "port_%u_busy_cycles", dsw_xstats_port_get_busy_cycles,
@@ -163,7 +206,26 @@ static struct dsw_xstats_port dsw_port_xstats[] = {
 	{ "port_%u_load", dsw_xstats_port_get_load,
 	  false },
 	{ "port_%u_last_bg", dsw_xstats_port_get_last_bg,
-	  false }
+	  false },
+	{ "port_%u_residency_hist_%u", dsw_xstats_port_get_residency,
+	  false, true }
+};
+
+static uint64_t
+dsw_xstats_queue_get_residency(struct dsw_evdev *dsw, uint8_t queue_id,
+			       uint8_t bucket)
+{
+	uint64_t residency = 0;
+	uint16_t port_id;
+
+	for (port_id = 0; port_id < dsw->num_ports; port_id++)
+		residency += dsw->ports[port_id].queue_residency[queue_id][bucket];
+
+	return residency;
+}
+
+static struct dsw_xstats_queue dsw_queue_xstats[] = {
+	{ "queue_%u_residency_hist_%u", dsw_xstats_queue_get_residency }
 };
 
 typedef
@@ -186,21 +248,26 @@ static void
 dsw_xstats_port_foreach(struct dsw_evdev *dsw, uint8_t port_id,
 			dsw_xstats_foreach_fn fn, void *fn_data)
 {
-	uint8_t queue_id;
+	uint8_t param;
 	unsigned int stat_idx;
 
-	for (stat_idx = 0, queue_id = 0;
+	for (stat_idx = 0, param = 0;
 	     stat_idx < RTE_DIM(dsw_port_xstats);) {
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
 		char xstats_name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
 		uint64_t xstats_id;
 
-		if (xstat->per_queue) {
-			xstats_id = DSW_XSTATS_ID_CREATE(stat_idx, queue_id);
+		if (xstat->per_bucket && !dsw->latency) {
+			stat_idx++;
+			continue;
+		}
+
+		if (xstat->per_queue || xstat->per_bucket) {
+			xstats_id = DSW_XSTATS_ID_CREATE(stat_idx, param);
 			snprintf(xstats_name, sizeof(xstats_name),
 				 dsw_port_xstats[stat_idx].name_fmt, port_id,
-				 queue_id);
-			queue_id++;
+				 param);
+			param++;
 		} else {
 			xstats_id = stat_idx;
 			snprintf(xstats_name, sizeof(xstats_name),
@@ -210,13 +277,37 @@ dsw_xstats_port_foreach(struct dsw_evdev *dsw, uint8_t port_id,
 		fn(xstats_name, RTE_EVENT_DEV_XSTATS_PORT, port_id,
 		   xstats_id, fn_data);
 
-		if (!(xstat->per_queue && queue_id < dsw->num_queues)) {
+		if (!(xstat->per_queue && param < dsw->num_queues) &&
+		    !(xstat->per_bucket && param < DSW_LAT_HIST_BUCKETS)) {
 			stat_idx++;
-			queue_id = 0;
+			param = 0;
 		}
 	}
 }
 
+static void
+dsw_xstats_queue_foreach(struct dsw_evdev *dsw, uint8_t queue_id,
+			 dsw_xstats_foreach_fn fn, void *fn_data)
+{
+	unsigned int stat_idx;
+	uint8_t bucket;
+
+	if (!dsw->latency)
+		return;
+
+	for (stat_idx = 0; stat_idx < RTE_DIM(dsw_queue_xstats); stat_idx++)
+		for (bucket = 0; bucket < DSW_LAT_HIST_BUCKETS; bucket++) {
+			char xstats_name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
+
+			snprintf(xstats_name, sizeof(xstats_name),
+				 dsw_queue_xstats[stat_idx].name_fmt,
+				 queue_id, bucket);
+
+			fn(xstats_name, RTE_EVENT_DEV_XSTATS_QUEUE, queue_id,
+			   DSW_XSTATS_ID_CREATE(stat_idx, bucket), fn_data);
+		}
+}
+
 struct store_ctx {
 	struct rte_event_dev_xstats_name *names;
 	uint64_t *ids;
@@ -267,7 +358,9 @@ dsw_xstats_get_names(const struct rte_eventdev *dev,
 					dsw_xstats_store_stat, &ctx);
 		return ctx.count;
 	case RTE_EVENT_DEV_XSTATS_QUEUE:
-		return 0;
+		dsw_xstats_queue_foreach(dsw, queue_port_id,
+					 dsw_xstats_store_stat, &ctx);
+		return ctx.count;
 	default:
 		RTE_ASSERT(false);
 		return -1;
@@ -300,12 +393,30 @@ dsw_xstats_port_get(const struct rte_eventdev *dev, uint8_t port_id,
 		uint64_t id = ids[i];
 		unsigned int stat_idx = DSW_XSTATS_ID_GET_STAT(id);
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
-		uint8_t queue_id = 0;
+		uint8_t param = 0;
 
-		if (xstat->per_queue)
-			queue_id = DSW_XSTATS_ID_GET_PARAM(id);
+		if (xstat->per_queue || xstat->per_bucket)
+			param = DSW_XSTATS_ID_GET_PARAM(id);
 
-		values[i] = xstat->get_value_fn(dsw, port_id, queue_id);
+		values[i] = xstat->get_value_fn(dsw, port_id, param);
+	}
+	return n;
+}
+
+static int
+dsw_xstats_queue_get(const struct rte_eventdev *dev, uint8_t queue_id,
+		     const uint64_t ids[], uint64_t values[], unsigned int n)
+{
+	struct dsw_evdev *dsw = dsw_pmd_priv(dev);
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		uint64_t id = ids[i];
+		unsigned int stat_idx = DSW_XSTATS_ID_GET_STAT(id);
+		struct dsw_xstats_queue *xstat = &dsw_queue_xstats[stat_idx];
+		uint8_t bucket = DSW_XSTATS_ID_GET_PARAM(id);
+
+		values[i] = xstat->get_value_fn(dsw, queue_id, bucket);
 	}
 	return n;
 }
@@ -321,7 +432,7 @@ dsw_xstats_get(const struct rte_eventdev *dev,
 	case RTE_EVENT_DEV_XSTATS_PORT:
 		return dsw_xstats_port_get(dev, queue_port_id, ids, values, n);
 	case RTE_EVENT_DEV_XSTATS_QUEUE:
-		return 0;
+		return dsw_xstats_queue_get(dev, queue_port_id, ids, values, n);
 	default:
 		RTE_ASSERT(false);
 		return -1;
@@ -358,6 +469,7 @@ dsw_xstats_get_by_name(const struct rte_eventdev *dev, const char *name,
 {
 	struct dsw_evdev *dsw = dsw_pmd_priv(dev);
 	uint16_t port_id;
+	uint8_t queue_id;
 
 	struct find_ctx ctx = {
 		.dev = dev,
@@ -372,5 +484,9 @@ dsw_xstats_get_by_name(const struct rte_eventdev *dev, const char *name,
 		dsw_xstats_port_foreach(dsw, port_id, dsw_xstats_find_stat,
 					&ctx);
 
+	for (queue_id = 0; queue_id < dsw->num_queues; queue_id++)
+		dsw_xstats_queue_foreach(dsw, queue_id, dsw_xstats_find_stat,
+					 &ctx);
+
 	return ctx.value;
 }
@@ -8,6 +8,8 @@
 
 #include <bus_vdev_driver.h>
 #include <rte_kvargs.h>
+#include <rte_malloc.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_ring.h>
 #include <rte_errno.h>
 #include <rte_event_ring.h>
@@ -24,10 +26,35 @@
 #define MIN_BURST_SIZE_ARG "min_burst"
 #define DEQ_BURST_SIZE_ARG "deq_burst"
 #define REFIL_ONCE_ARG "refill_once"
+#define SHARDS_ARG "shards"
+#define PIPELINE_ARG "pipeline"
+#define LATENCY_ARG "latency"
+
+/* Pipelines given in the devargs */
+struct sw_pipeline_args {
+	uint32_t nb_pipelines;
+	uint8_t first_qid[SW_PIPELINES_MAX];
+	uint8_t nb_stages[SW_PIPELINES_MAX];
+};
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
 
+/* Mirror the link state of a port to its view in the other shards */
+static void
+sw_port_shards_sync(struct sw_evdev *sw, struct sw_port *p)
+{
+	uint32_t s;
+
+	for (s = 1; s < sw->nb_shards; s++) {
+		struct sw_port *sp = sw_shard_port(sw, s, p->id);
+
+		sp->is_directed = p->is_directed;
+		sp->num_ordered_qids = p->num_ordered_qids;
+		sp->num_qids_mapped = p->num_qids_mapped;
+	}
+}
+
 static int
 sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 		const uint8_t priorities[], uint16_t num)
@@ -47,7 +74,8 @@ sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 			break;
 		}
 
-		if (p->is_directed && p->num_qids_mapped > 0) {
+		if ((p->is_directed || p->pipeline != NULL) &&
+				p->num_qids_mapped > 0) {
 			rte_errno = EDQUOT;
 			break;
 		}
@@ -75,6 +103,17 @@ sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 
 			p->is_directed = 1;
 			p->num_qids_mapped = 1;
+		} else if (q->type == SW_SCHED_TYPE_PIPELINE) {
+			/* check port only takes from one pipeline stage */
+			if (p->num_qids_mapped > 0 || num > 1) {
+				rte_errno = EDQUOT;
+				break;
+			}
+
+			p->pipeline = q->pipeline;
+			p->pl_stage = q->pipeline_stage;
+			p->pl_qid = q->id;
+			p->num_qids_mapped = 1;
 		} else if (q->type == RTE_SCHED_TYPE_ORDERED) {
 			p->num_ordered_qids++;
 			p->num_qids_mapped++;
@@ -83,6 +122,8 @@ sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 			p->num_qids_mapped++;
 		}
 
+		sw_port_shards_sync(sw, p);
+
 		q->cq_map[q->cq_num_mapped_cqs] = p->id;
 		rte_smp_wmb();
 		q->cq_num_mapped_cqs++;
@@ -101,6 +142,17 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 	int unlinked = 0;
 	for (i = 0; i < nb_unlinks; i++) {
 		struct sw_qid *q = &sw->qids[queues[i]];
+
+		/* the range of the pipeline ring claimed by a stage port
+		 * must be released first, or the stage would stall
+		 */
+		if (q->type == SW_SCHED_TYPE_PIPELINE && p->pipeline != NULL &&
+				p->pl_qid == q->id && (p->pl_claim_count != 0 ||
+				p->pl_next_slot != p->pl_nb_slots)) {
+			rte_errno = EBUSY;
+			break;
+		}
+
 		for (j = 0; j < q->cq_num_mapped_cqs; j++) {
 			if (q->cq_map[j] == p->id) {
 				q->cq_map[j] =
@@ -113,13 +165,20 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 
 				if (q->type == RTE_SCHED_TYPE_ORDERED)
 					p->num_ordered_qids--;
+				else if (q->type == SW_SCHED_TYPE_PIPELINE)
+					p->pipeline = NULL;
+
+				sw_port_shards_sync(sw, p);
+
+				/* acked by the shard scheduling the QID */
+				sw_shard_port(sw, q->shard, p->id)->
+					unlinks_in_progress++;
 
 				continue;
 			}
 		}
 	}
 
-	p->unlinks_in_progress += unlinked;
 	rte_smp_mb();
 
 	return unlinked;
@@ -128,9 +187,70 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 static int
 sw_port_unlinks_in_progress(struct rte_eventdev *dev, void *port)
 {
-	RTE_SET_USED(dev);
+	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = port;
-	return p->unlinks_in_progress;
+	int unlinks = 0;
+	uint32_t s;
+
+	for (s = 0; s < sw->nb_shards; s++)
+		unlinks += sw_shard_port(sw, s, p->id)->unlinks_in_progress;
+
+	return unlinks;
+}
+
+/* Create the rings of the port view in a shard other than shard 0 */
+static int
+sw_port_shard_setup(struct rte_eventdev *dev, uint32_t shard, uint8_t port_id,
+		const struct rte_event_port_conf *conf)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_port *sp = sw_shard_port(sw, shard, port_id);
+	char buf[RTE_RING_NAMESIZE];
+	unsigned int i;
+
+	*sp = (struct sw_port){0};
+	sp->id = port_id;
+	sp->sw = sw;
+
+	snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_rx_worker_ring",
+			dev->data->dev_id, port_id, shard);
+	rte_event_ring_free(rte_event_ring_lookup(buf));
+
+	sp->rx_worker_ring = rte_event_ring_create(buf, MAX_SW_PROD_Q_DEPTH,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (sp->rx_worker_ring == NULL)
+		return -1;
+
+	snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_cq_worker_ring",
+			dev->data->dev_id, port_id, shard);
+	rte_event_ring_free(rte_event_ring_lookup(buf));
+
+	sp->cq_worker_ring = rte_event_ring_create(buf, conf->dequeue_depth,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (sp->cq_worker_ring == NULL) {
+		rte_event_ring_free(sp->rx_worker_ring);
+		sp->rx_worker_ring = NULL;
+		return -1;
+	}
+	sw->shards[shard].cq_ring_space[port_id] = conf->dequeue_depth;
+
+	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
+		sp->hist_list[i].fid = -1;
+		sp->hist_list[i].qid = -1;
+	}
+
+	sp->initialized = 1;
+	return 0;
+}
+
+static void
+sw_port_shard_release(struct sw_port *sp)
+{
+	rte_event_ring_free(sp->rx_worker_ring);
+	rte_event_ring_free(sp->cq_worker_ring);
+	memset(sp, 0, sizeof(*sp));
 }
 
 static int
@@ -140,7 +260,7 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = &sw->ports[port_id];
 	char buf[RTE_RING_NAMESIZE];
-	unsigned int i;
+	unsigned int i, s;
 
 	struct rte_event_dev_info info;
 	sw_info_get(dev, &info);
@@ -153,9 +273,14 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		 * the sum to no leak credits
 		 */
 		int possible_inflights = p->inflight_credits + p->inflights;
+
+		for (s = 1; s < sw->nb_shards; s++)
+			possible_inflights +=
+				sw_shard_port(sw, s, port_id)->inflights;
 		rte_atomic32_sub(&sw->inflights, possible_inflights);
 	}
 
+	rte_free(p->lat_hist);
 	*p = (struct sw_port){0}; /* zero entire structure */
 	p->id = port_id;
 	p->sw = sw;
@@ -197,13 +322,33 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 				port_id);
 		return -1;
 	}
-	sw->cq_ring_space[port_id] = conf->dequeue_depth;
+	sw->shards[0].cq_ring_space[port_id] = conf->dequeue_depth;
 
 	/* set hist list contents to empty */
 	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
 		p->hist_list[i].fid = -1;
 		p->hist_list[i].qid = -1;
 	}
+
+	/* the port view in the other shards */
+	p->shard_rx_ring[0] = p->rx_worker_ring;
+	p->shard_cq_ring[0] = p->cq_worker_ring;
+	for (s = 1; s < sw->nb_shards; s++) {
+		struct sw_port *sp = sw_shard_port(sw, s, port_id);
+
+		if (sw_port_shard_setup(dev, s, port_id, conf) < 0) {
+			SW_LOG_ERR("Error creating rings for port %d shard %u",
+					port_id, s);
+			while (--s > 0)
+				sw_port_shard_release(
+					sw_shard_port(sw, s, port_id));
+			rte_event_ring_free(p->rx_worker_ring);
+			rte_event_ring_free(p->cq_worker_ring);
+			return -1;
+		}
+		p->shard_rx_ring[s] = sp->rx_worker_ring;
+		p->shard_cq_ring[s] = sp->cq_worker_ring;
+	}
 	dev->data->ports[port_id] = p;
 
 	rte_smp_wmb();
@@ -215,14 +360,40 @@ static void
 sw_port_release(void *port)
 {
 	struct sw_port *p = (void *)port;
+	uint32_t s;
+
 	if (p == NULL)
 		return;
 
+	if (p->sw != NULL)
+		for (s = 1; s < p->sw->nb_shards; s++)
+			if (p->sw->shards[s].ports != NULL)
+				sw_port_shard_release(
+					sw_shard_port(p->sw, s, p->id));
+
 	rte_event_ring_free(p->rx_worker_ring);
 	rte_event_ring_free(p->cq_worker_ring);
+	rte_free(p->lat_hist);
 	memset(p, 0, sizeof(*p));
 }
 
+/* The pipeline a QID is a stage of, if any */
+static struct sw_pipeline *
+sw_qid_pipeline(struct sw_evdev *sw, unsigned int idx)
+{
+	uint32_t i;
+
+	for (i = 0; i < sw->nb_pipelines; i++) {
+		struct sw_pipeline *pl = &sw->pipelines[i];
+
+		if (idx >= pl->first_qid &&
+				idx < (unsigned int)pl->first_qid + pl->nb_stages)
+			return pl;
+	}
+
+	return NULL;
+}
+
 static int32_t
 qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 		const struct rte_event_queue_conf *queue_conf)
@@ -239,6 +410,13 @@ qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 	qid->id = idx;
 	qid->type = type;
 	qid->priority = queue_conf->priority;
+	/* the QIDs are spread over the shards in a round robin way */
+	qid->shard = idx % sw->nb_shards;
+
+	if (qid->type == SW_SCHED_TYPE_PIPELINE) {
+		qid->pipeline = sw_qid_pipeline(sw, idx);
+		qid->pipeline_stage = idx - qid->pipeline->first_qid;
+	}
 
 	if (qid->type == RTE_SCHED_TYPE_ORDERED) {
 		uint32_t window_size;
@@ -326,11 +504,22 @@ static int
 sw_queue_setup(struct rte_eventdev *dev, uint8_t queue_id,
 		const struct rte_event_queue_conf *conf)
 {
+	struct sw_evdev *sw = sw_pmd_priv(dev);
 	int type;
 
 	type = conf->schedule_type;
 
-	if (RTE_EVENT_QUEUE_CFG_SINGLE_LINK & conf->event_queue_cfg) {
+	if (sw_qid_pipeline(sw, queue_id) != NULL) {
+		/* the stages of a pipeline keep the events in order but
+		 * don't provide atomicity nor restore the order
+		 */
+		if (type != RTE_SCHED_TYPE_PARALLEL || conf->event_queue_cfg) {
+			SW_LOG_ERR("pipeline qid %u must be of parallel type",
+					queue_id);
+			return -EINVAL;
+		}
+		type = SW_SCHED_TYPE_PIPELINE;
+	} else if (RTE_EVENT_QUEUE_CFG_SINGLE_LINK & conf->event_queue_cfg) {
 		type = SW_SCHED_TYPE_DIRECT;
 	} else if (RTE_EVENT_QUEUE_CFG_ALL_TYPES
 			& conf->event_queue_cfg) {
@@ -338,8 +527,6 @@ sw_queue_setup(struct rte_eventdev *dev, uint8_t queue_id,
 		return -ENOTSUP;
 	}
 
-	struct sw_evdev *sw = sw_pmd_priv(dev);
-
 	if (sw->qids[queue_id].initialized)
 		sw_queue_release(dev, queue_id);
 
@@ -359,7 +546,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(&sw->shards[qid->shard], &qid->iq[j]);
 	}
 }
 
@@ -381,11 +568,37 @@ sw_qids_empty(struct sw_evdev *sw)
 static int
 sw_ports_empty(struct sw_evdev *sw)
 {
-	unsigned int i;
+	unsigned int i, s;
 
-	for (i = 0; i < sw->port_count; i++) {
-		if ((rte_event_ring_count(sw->ports[i].rx_worker_ring)) ||
-		     rte_event_ring_count(sw->ports[i].cq_worker_ring))
+	for (s = 0; s < sw->nb_shards; s++) {
+		struct sw_shard *sh = &sw->shards[s];
+
+		if (sh->fwd_ring && rte_event_ring_count(sh->fwd_ring))
+			return 0;
+
+		for (i = 0; i < sw->port_count; i++) {
+			if ((rte_event_ring_count(sh->ports[i].rx_worker_ring)) ||
+			     rte_event_ring_count(sh->ports[i].cq_worker_ring))
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int
+sw_pipelines_empty(struct sw_evdev *sw)
+{
+	uint32_t i;
+
+	for (i = 0; i < sw->nb_pipelines; i++) {
+		struct sw_pipeline *pl = &sw->pipelines[i];
+		uint32_t last = pl->nb_stages - 1;
+
+		if (rte_atomic_load_explicit(&pl->prod_tail,
+				rte_memory_order_relaxed) !=
+				rte_atomic_load_explicit(&pl->stages[last].tail,
+				rte_memory_order_relaxed))
 			return 0;
 	}
 
@@ -408,6 +621,12 @@ sw_drain_ports(struct rte_eventdev *dev)
 	for (i = 0; i < sw->port_count; i++) {
 		struct rte_event ev;
 
+		/* the events held by a pipeline stage port block its stage */
+		ev.op = RTE_EVENT_OP_RELEASE;
+		while (sw->ports[i].pipeline != NULL &&
+				sw->ports[i].outstanding_releases > 0)
+			rte_event_enqueue_burst(dev_id, i, &ev, 1);
+
 		while (rte_event_dequeue_burst(dev_id, i, &ev, 1, 0)) {
 			if (flush)
 				flush(dev_id, ev, arg);
@@ -419,9 +638,8 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_shard *sh, struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -433,7 +651,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(sh, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -448,7 +666,8 @@ sw_drain_queues(struct rte_eventdev *dev)
 
 	for (i = 0; i < sw->qid_count; i++) {
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, &sw->shards[sw->qids[i].shard],
+					&sw->qids[i].iq[j]);
 	}
 }
 
@@ -465,7 +684,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(&sw->shards[qid->shard],
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -475,9 +695,6 @@ static void
 sw_queue_def_conf(struct rte_eventdev *dev, uint8_t queue_id,
 				 struct rte_event_queue_conf *conf)
 {
-	RTE_SET_USED(dev);
-	RTE_SET_USED(queue_id);
-
 	static const struct rte_event_queue_conf default_conf = {
 		.nb_atomic_flows = 4096,
 		.nb_atomic_order_sequences = 1,
@@ -486,6 +703,8 @@ sw_queue_def_conf(struct rte_eventdev *dev, uint8_t queue_id,
 	};
 
 	*conf = default_conf;
+	if (sw_qid_pipeline(sw_pmd_priv(dev), queue_id) != NULL)
+		conf->schedule_type = RTE_SCHED_TYPE_PARALLEL;
 }
 
 static void
@@ -501,6 +720,37 @@ sw_port_def_conf(struct rte_eventdev *dev, uint8_t port_id,
 	port_conf->event_port_cfg = 0;
 }
 
+/* Allocate the port views and the forward ring of a shard other than shard 0 */
+static int
+sw_shard_configure(const struct rte_eventdev *dev, struct sw_shard *sh)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	char buf[RTE_RING_NAMESIZE];
+
+	if (sh->ports == NULL) {
+		sh->ports = rte_zmalloc_socket(NULL,
+				sizeof(struct sw_port) * SW_PORTS_MAX,
+				RTE_CACHE_LINE_SIZE, sw->data->socket_id);
+		if (sh->ports == NULL)
+			return -ENOMEM;
+	}
+
+	if (sh->fwd_ring == NULL) {
+		snprintf(buf, sizeof(buf), "sw%d_s%u_fwd_ring",
+				dev->data->dev_id, sh->id);
+		rte_event_ring_free(rte_event_ring_lookup(buf));
+
+		/* room for all the inflight events, so it never fills up */
+		sh->fwd_ring = rte_event_ring_create(buf,
+				SW_INFLIGHT_EVENTS_TOTAL, sw->data->socket_id,
+				RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (sh->fwd_ring == NULL)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
 static int
 sw_dev_configure(const struct rte_eventdev *dev)
 {
@@ -508,33 +758,45 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	const struct rte_eventdev_data *data = dev->data;
 	const struct rte_event_dev_config *conf = &data->dev_conf;
 	int num_chunks, i;
+	uint32_t s;
 
 	sw->qid_count = conf->nb_event_queues;
 	sw->port_count = conf->nb_event_ports;
 	sw->nb_events_limit = conf->nb_events_limit;
 	rte_atomic32_set(&sw->inflights, 0);
 
-	/* Number of chunks sized for worst-case spread of events across IQs */
-	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
-			sw->qid_count*SW_IQS_MAX*2;
+	for (s = 0; s < sw->nb_shards; s++) {
+		struct sw_shard *sh = &sw->shards[s];
+		uint32_t nb_qids = (sw->qid_count + sw->nb_shards - 1 - s) /
+				sw->nb_shards;
 
-	/* If this is a reconfiguration, free the previous IQ allocation. All
-	 * IQ chunk references were cleaned out of the QIDs in sw_stop(), and
-	 * will be reinitialized in sw_start().
-	 */
-	rte_free(sw->chunks);
-
-	sw->chunks = rte_malloc_socket(NULL,
-				       sizeof(struct sw_queue_chunk) *
-				       num_chunks,
-				       0,
-				       sw->data->socket_id);
-	if (!sw->chunks)
-		return -ENOMEM;
+		/* Number of chunks sized for worst-case spread of events
+		 * across IQs, as all the events may end up in one shard.
+		 */
+		num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
+				nb_qids*SW_IQS_MAX*2;
 
-	sw->chunk_list_head = NULL;
-	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+		/* If this is a reconfiguration, free the previous IQ
+		 * allocation. All IQ chunk references were cleaned out of the
+		 * QIDs in sw_stop(), and will be reinitialized in sw_start().
+		 */
+		rte_free(sh->chunks);
+
+		sh->chunks = rte_malloc_socket(NULL,
+					       sizeof(struct sw_queue_chunk) *
+					       num_chunks,
+					       0,
+					       sw->data->socket_id);
+		if (!sh->chunks)
+			return -ENOMEM;
+
+		sh->chunk_list_head = NULL;
+		for (i = 0; i < num_chunks; i++)
+			iq_free_chunk(sh, &sh->chunks[i]);
+
+		if (sw->nb_shards > 1 && sw_shard_configure(dev, sh) < 0)
+			return -ENOMEM;
+	}
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
@@ -621,18 +883,28 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	const struct sw_evdev *sw = sw_pmd_priv(dev);
 
 	static const char * const q_type_strings[] = {
-			"Ordered", "Atomic", "Parallel", "Directed"
+			"Ordered", "Atomic", "Parallel", "Directed", "Pipeline"
 	};
 	uint32_t i;
-	fprintf(f, "EventDev %s: ports %d, qids %d\n",
-		dev->data->name, sw->port_count, sw->qid_count);
-
-	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+	fprintf(f, "EventDev %s: ports %d, qids %d, shards %d\n",
+		dev->data->name, sw->port_count, sw->qid_count, sw->nb_shards);
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		const struct sw_shard *sh = &sw->shards[i];
+
+		if (sw->nb_shards > 1)
+			fprintf(f, "  Shard %d\n", i);
+		fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
+			sh->stats.rx_pkts, sh->stats.rx_dropped,
+			sh->stats.tx_pkts);
+		fprintf(f, "\tsched calls: %"PRIu64"\n", sh->sched_called);
+		fprintf(f, "\tsched cq/qid call: %"PRIu64"\n",
+			sh->sched_cq_qid_called);
+		fprintf(f, "\tsched no IQ enq: %"PRIu64"\n",
+			sh->sched_no_iq_enqueues);
+		fprintf(f, "\tsched no CQ enq: %"PRIu64"\n",
+			sh->sched_no_cq_enqueues);
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -648,8 +920,12 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 				COL_RED, i, COL_RESET);
 			continue;
 		}
-		fprintf(f, "  Port %d %s\n", i,
-			p->is_directed ? " (SingleCons)" : "");
+		if (p->pipeline != NULL)
+			fprintf(f, "  Port %d  (Pipeline stage %u)\n", i,
+				p->pl_stage);
+		else
+			fprintf(f, "  Port %d %s\n", i,
+				p->is_directed ? " (SingleCons)" : "");
 		fprintf(f, "\trx   %"PRIu64"\tdrop %"PRIu64"\ttx   %"PRIu64
 			"\t%sinflight %d%s\n", sw->ports[i].stats.rx_pkts,
 			sw->ports[i].stats.rx_dropped,
@@ -716,6 +992,21 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 		fprintf(f, "\trx   %"PRIu64"\tdrop %"PRIu64"\ttx   %"PRIu64"\n",
 			qid->stats.rx_pkts, qid->stats.rx_dropped,
 			qid->stats.tx_pkts);
+		if (qid->type == SW_SCHED_TYPE_PIPELINE) {
+			const struct sw_pipeline *pl = qid->pipeline;
+			uint32_t tail = qid->pipeline_stage == 0 ?
+				rte_atomic_load_explicit(&pl->prod_tail,
+					rte_memory_order_relaxed) :
+				rte_atomic_load_explicit(
+					&pl->stages[qid->pipeline_stage - 1].tail,
+					rte_memory_order_relaxed);
+			uint32_t head = rte_atomic_load_explicit(
+					&pl->stages[qid->pipeline_stage].head,
+					rte_memory_order_relaxed);
+
+			fprintf(f, "\tPipeline stage %u, ring slots waiting: %u\n",
+				qid->pipeline_stage, tail - head);
+		}
 		if (qid->type == RTE_SCHED_TYPE_ORDERED) {
 			struct rob_ring *rob_buf_free =
 				qid->reorder_buffer_freelist;
@@ -768,13 +1059,17 @@ sw_start(struct rte_eventdev *dev)
 	unsigned int i, j;
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 
-	rte_service_component_runstate_set(sw->service_id, 1);
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		rte_service_component_runstate_set(sh->service_id, 1);
 
-	/* check a service core is mapped to this service */
-	if (!rte_service_runstate_get(sw->service_id)) {
-		SW_LOG_ERR("Warning: No Service core enabled on service %s",
-				sw->service_name);
-		return -ENOENT;
+		/* check a service core is mapped to this service */
+		if (!rte_service_runstate_get(sh->service_id)) {
+			SW_LOG_ERR("Warning: No Service core enabled on service %s",
+					sh->service_name);
+			return -ENOENT;
+		}
 	}
 
 	/* check all ports are set up */
@@ -792,18 +1087,72 @@ sw_start(struct rte_eventdev *dev)
 			return -ENOLINK;
 		}
 
+	/* check the stages of the pipelines are configured, and reset the
+	 * pipeline rings
+	 */
+	for (i = 0; i < sw->nb_pipelines; i++) {
+		struct sw_pipeline *pl = &sw->pipelines[i];
+
+		if (pl->first_qid + pl->nb_stages > sw->qid_count) {
+			SW_LOG_ERR("Pipeline %d queues not configured", i);
+			return -ENOLINK;
+		}
+
+		if (pl->ring == NULL) {
+			pl->ring = rte_zmalloc_socket(NULL,
+					SW_PIPELINE_RING_SIZE *
+					sizeof(pl->ring[0]),
+					RTE_CACHE_LINE_SIZE,
+					sw->data->socket_id);
+			if (pl->ring == NULL)
+				return -ENOMEM;
+		}
+
+		rte_atomic_store_explicit(&pl->prod_tail, 0,
+				rte_memory_order_relaxed);
+		for (j = 0; j < pl->nb_stages; j++) {
+			rte_atomic_store_explicit(&pl->stages[j].head, 0,
+					rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&pl->stages[j].tail, 0,
+					rte_memory_order_relaxed);
+		}
+	}
+	for (i = 0; i < sw->port_count; i++) {
+		struct sw_port *p = &sw->ports[i];
+
+		p->pl_claim_count = 0;
+		p->pl_nb_slots = 0;
+		p->pl_next_slot = 0;
+	}
+
+	/* residency histograms, sized for the current number of QIDs */
+	for (i = 0; sw->latency && i < sw->port_count; i++) {
+		struct sw_port *p = &sw->ports[i];
+
+		rte_free(p->lat_hist);
+		p->lat_hist = rte_zmalloc_socket(NULL, sw->qid_count *
+				SW_LAT_HIST_BUCKETS * sizeof(p->lat_hist[0]),
+				RTE_CACHE_LINE_SIZE, sw->data->socket_id);
+		if (p->lat_hist == NULL)
+			return -ENOMEM;
+	}
+
 	/* build up our prioritized array of qids */
 	/* We don't use qsort here, as if all/multiple entries have the same
 	 * priority, the result is non-deterministic. From "man 3 qsort":
 	 * "If two members compare as equal, their order in the sorted
 	 * array is undefined."
 	 */
-	uint32_t qidx = 0;
+	for (i = 0; i < sw->nb_shards; i++)
+		sw->shards[i].qid_count = 0;
 	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
 		for (i = 0; i < sw->qid_count; i++) {
 			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
+				struct sw_shard *sh =
+					&sw->shards[sw->qids[i].shard];
+
+				sh->qids_prioritized[sh->qid_count++] =
+					&sw->qids[i];
 			}
 		}
 	}
@@ -823,19 +1172,25 @@ static void
 sw_stop(struct rte_eventdev *dev)
 {
 	struct sw_evdev *sw = sw_pmd_priv(dev);
-	int32_t runstate;
+	int32_t runstate[SW_SHARDS_MAX];
+	uint32_t i;
 
-	/* Stop the scheduler if it's running */
-	runstate = rte_service_runstate_get(sw->service_id);
-	if (runstate == 1)
-		rte_service_runstate_set(sw->service_id, 0);
+	/* Stop the schedulers if they are running */
+	for (i = 0; i < sw->nb_shards; i++) {
+		runstate[i] = rte_service_runstate_get(sw->shards[i].service_id);
+		if (runstate[i] == 1)
+			rte_service_runstate_set(sw->shards[i].service_id, 0);
+	}
 
-	while (rte_service_may_be_active(sw->service_id))
-		rte_pause();
+	for (i = 0; i < sw->nb_shards; i++)
+		while (rte_service_may_be_active(sw->shards[i].service_id))
+			rte_pause();
 
 	/* Flush all events out of the device */
-	while (!(sw_qids_empty(sw) && sw_ports_empty(sw))) {
-		sw_event_schedule(dev);
+	while (!(sw_qids_empty(sw) && sw_ports_empty(sw) &&
+			sw_pipelines_empty(sw))) {
+		for (i = 0; i < sw->nb_shards; i++)
+			sw_event_schedule(&sw->shards[i]);
 		sw_drain_ports(dev);
 		sw_drain_queues(dev);
 	}
@@ -845,8 +1200,22 @@ sw_stop(struct rte_eventdev *dev)
 	sw->started = 0;
 	rte_smp_wmb();
 
-	if (runstate == 1)
-		rte_service_runstate_set(sw->service_id, 1);
+	for (i = 0; i < sw->nb_shards; i++)
+		if (runstate[i] == 1)
+			rte_service_runstate_set(sw->shards[i].service_id, 1);
+}
+
+static int
+sw_service_ids_get(const struct rte_eventdev *dev, uint32_t service_ids[],
+		uint32_t n)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	uint32_t i;
+
+	for (i = 0; i < sw->nb_shards && i < n; i++)
+		service_ids[i] = sw->shards[i].service_id;
+
+	return sw->nb_shards;
 }
 
 static int
@@ -863,11 +1232,27 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->nb_pipelines; i++) {
+		rte_free(sw->pipelines[i].ring);
+		sw->pipelines[i].ring = NULL;
+	}
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		if (i > 0) {
+			rte_free(sh->ports);
+			sh->ports = NULL;
+		}
+		rte_event_ring_free(sh->fwd_ring);
+		sh->fwd_ring = NULL;
+
+		memset(&sh->stats, 0, sizeof(sh->stats));
+		sh->sched_called = 0;
+		sh->sched_no_iq_enqueues = 0;
+		sh->sched_no_cq_enqueues = 0;
+		sh->sched_cq_qid_called = 0;
+	}
 
 	return 0;
 }
@@ -932,10 +1317,66 @@ set_refill_once(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_shards(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *shards = opaque;
+	*shards = atoi(value);
+	if (*shards < 1 || *shards > SW_SHARDS_MAX)
+		return -1;
+	return 0;
+}
+
+static int
+set_pipeline(const char *key __rte_unused, const char *value, void *opaque)
+{
+	struct sw_pipeline_args *pipelines = opaque;
+	unsigned long first_qid, nb_stages;
+	char *end;
+	uint32_t i;
+
+	if (pipelines->nb_pipelines == SW_PIPELINES_MAX)
+		return -1;
+
+	/* <first_qid>:<nb_stages> */
+	first_qid = strtoul(value, &end, 10);
+	if (end == value || *end != ':')
+		return -1;
+	nb_stages = strtoul(end + 1, &end, 10);
+	if (*end != '\0')
+		return -1;
+
+	if (nb_stages < 1 || nb_stages > SW_PIPELINE_STAGES_MAX ||
+			first_qid + nb_stages > RTE_EVENT_MAX_QUEUES_PER_DEV)
+		return -1;
+
+	/* a QID is a stage of one pipeline only */
+	for (i = 0; i < pipelines->nb_pipelines; i++)
+		if (first_qid < (unsigned long)pipelines->first_qid[i] +
+				pipelines->nb_stages[i] &&
+				pipelines->first_qid[i] < first_qid + nb_stages)
+			return -1;
+
+	pipelines->first_qid[i] = first_qid;
+	pipelines->nb_stages[i] = nb_stages;
+	pipelines->nb_pipelines++;
+	return 0;
+}
+
+static int
+set_latency(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *latency = opaque;
+	*latency = atoi(value);
+	if (*latency < 0 || *latency > 1)
+		return -1;
+	return 0;
+}
+
 static int32_t sw_sched_service_func(void *args)
 {
-	struct rte_eventdev *dev = args;
-	return sw_event_schedule(dev);
+	struct sw_shard *sh = args;
+	return sw_event_schedule(sh);
 }
 
 static int
@@ -971,6 +1412,8 @@ sw_probe(struct rte_vdev_device *vdev)
 			.xstats_reset = sw_xstats_reset,
 
 			.dev_selftest = test_sw_eventdev,
+
+			.service_ids_get = sw_service_ids_get,
 	};
 
 	static const char *const args[] = {
@@ -980,6 +1423,9 @@ sw_probe(struct rte_vdev_device *vdev)
 		MIN_BURST_SIZE_ARG,
 		DEQ_BURST_SIZE_ARG,
 		REFIL_ONCE_ARG,
+		SHARDS_ARG,
+		PIPELINE_ARG,
+		LATENCY_ARG,
 		NULL
 	};
 	const char *name;
@@ -992,6 +1438,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	int min_burst_size = 1;
 	int deq_burst_size = SCHED_DEQUEUE_DEFAULT_BURST_SIZE;
 	int refill_once = 0;
+	int shards = 1;
+	struct sw_pipeline_args pipelines = {0};
+	int latency = 0;
+	int lat_ts_offset = -1;
+	uint32_t i;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1063,16 +1514,68 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SHARDS_ARG,
+					set_shards, &shards);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing shards parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
+			ret = rte_kvargs_process(kvlist, PIPELINE_ARG,
+					set_pipeline, &pipelines);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing pipeline parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
+			ret = rte_kvargs_process(kvlist, LATENCY_ARG,
+					set_latency, &latency);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing latency switch",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
 
+	if (pipelines.nb_pipelines > 0 && shards > 1) {
+		SW_LOG_ERR("%s: pipelines require a single shard", name);
+		return -EINVAL;
+	}
+
+	if (latency) {
+		static const struct rte_mbuf_dynfield lat_ts_dynfield_desc = {
+			.name = "sw_evdev_enq_ts_dynfield",
+			.size = sizeof(uint64_t),
+			.align = alignof(uint64_t),
+		};
+
+		lat_ts_offset = rte_mbuf_dynfield_register(&lat_ts_dynfield_desc);
+		if (lat_ts_offset < 0) {
+			SW_LOG_ERR("%s: Failed to register timestamp mbuf field",
+					name);
+			return -rte_errno;
+		}
+	}
+
 	SW_LOG_INFO(
 			"Creating eventdev sw device %s, numa_node=%d, "
 			"sched_quanta=%d, credit_quanta=%d "
-			"min_burst=%d, deq_burst=%d, refill_once=%d",
+			"min_burst=%d, deq_burst=%d, refill_once=%d, shards=%d, "
+			"pipelines=%u, latency=%d",
 			name, socket_id, sched_quanta, credit_quanta,
-			min_burst_size, deq_burst_size, refill_once);
+			min_burst_size, deq_burst_size, refill_once, shards,
+			pipelines.nb_pipelines, latency);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id, vdev);
@@ -1081,10 +1584,17 @@ sw_probe(struct rte_vdev_device *vdev)
 		return -EFAULT;
 	}
 	dev->dev_ops = &evdev_sw_ops;
-	dev->enqueue_burst = sw_event_enqueue_burst;
-	dev->enqueue_new_burst = sw_event_enqueue_burst;
-	dev->enqueue_forward_burst = sw_event_enqueue_burst;
-	dev->dequeue_burst = sw_event_dequeue_burst;
+	if (shards > 1) {
+		dev->enqueue_burst = sw_event_enqueue_burst_sharded;
+		dev->enqueue_new_burst = sw_event_enqueue_burst_sharded;
+		dev->enqueue_forward_burst = sw_event_enqueue_burst_sharded;
+		dev->dequeue_burst = sw_event_dequeue_burst_sharded;
+	} else {
+		dev->enqueue_burst = sw_event_enqueue_burst;
+		dev->enqueue_new_burst = sw_event_enqueue_burst;
+		dev->enqueue_forward_burst = sw_event_enqueue_burst;
+		dev->dequeue_burst = sw_event_dequeue_burst;
+	}
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
 		return 0;
@@ -1098,25 +1608,49 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->sched_min_burst_size = min_burst_size;
 	sw->sched_deq_burst_size = deq_burst_size;
 	sw->refill_once_per_iter = refill_once;
+	sw->nb_shards = shards;
+	sw->latency = latency;
+	sw->lat_ts_offset = lat_ts_offset;
+	sw->nb_pipelines = pipelines.nb_pipelines;
+	for (i = 0; i < pipelines.nb_pipelines; i++) {
+		sw->pipelines[i].first_qid = pipelines.first_qid[i];
+		sw->pipelines[i].nb_stages = pipelines.nb_stages[i];
+	}
 
-	/* register service with EAL */
-	struct rte_service_spec service;
-	memset(&service, 0, sizeof(struct rte_service_spec));
-	snprintf(service.name, sizeof(service.name), "%s_service", name);
-	snprintf(sw->service_name, sizeof(sw->service_name), "%s_service",
-			name);
-	service.socket_id = socket_id;
-	service.callback = sw_sched_service_func;
-	service.callback_userdata = (void *)dev;
-
-	int32_t ret = rte_service_component_register(&service, &sw->service_id);
-	if (ret) {
-		SW_LOG_ERR("service register() failed");
-		return -ENOEXEC;
+	/* register one service per shard with EAL, the device service being
+	 * the one of shard 0
+	 */
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+		struct rte_service_spec service;
+
+		sh->sw = sw;
+		sh->id = i;
+
+		memset(&service, 0, sizeof(struct rte_service_spec));
+		if (i == 0)
+			snprintf(sh->service_name, sizeof(sh->service_name),
+					"%s_service", name);
+		else
+			snprintf(sh->service_name, sizeof(sh->service_name),
+					"%s_service_%u", name, i);
+		snprintf(service.name, sizeof(service.name), "%s",
+				sh->service_name);
+		service.socket_id = socket_id;
+		service.callback = sw_sched_service_func;
+		service.callback_userdata = (void *)sh;
+
+		int32_t ret = rte_service_component_register(&service,
+				&sh->service_id);
+		if (ret) {
+			SW_LOG_ERR("service register() failed");
+			return -ENOEXEC;
+		}
 	}
+	sw->shards[0].ports = sw->ports;
 
 	dev->data->service_inited = 1;
-	dev->data->service_id = sw->service_id;
+	dev->data->service_id = sw->shards[0].service_id;
 
 	event_dev_probing_finish(dev);
 
@@ -1146,5 +1680,6 @@ RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
 		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
 		MIN_BURST_SIZE_ARG "=<int>" DEQ_BURST_SIZE_ARG "=<int>"
-		REFIL_ONCE_ARG "=<int>");
+		REFIL_ONCE_ARG "=<int> " SHARDS_ARG "=<int> "
+		PIPELINE_ARG "=<first_qid>:<nb_stages> " LATENCY_ARG "=<int>");
 RTE_LOG_REGISTER_DEFAULT(eventdev_sw_log_level, NOTICE);
@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_stdatomic.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,17 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+/* max scheduler instances, each owning a subset of the QIDs */
+#define SW_SHARDS_MAX 8
+/* how many events forwarded to another scheduler instance at once */
+#define SW_SHARD_FWD_BURST_SIZE 32
+/* max pipelines, and stages (consecutive QIDs) of a pipeline */
+#define SW_PIPELINES_MAX 4
+#define SW_PIPELINE_STAGES_MAX 8
+/* events in the ring shared by the stages of a pipeline, power of two */
+#define SW_PIPELINE_RING_SIZE 1024
+/* residency latency histogram buckets, log2 of the timer cycles */
+#define SW_LAT_HIST_BUCKETS 32
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -45,6 +57,10 @@
 #define SW_PMD_NAME_MAX 64
 
 #define SW_SCHED_TYPE_DIRECT (RTE_SCHED_TYPE_PARALLEL + 1)
+#define SW_SCHED_TYPE_PIPELINE (SW_SCHED_TYPE_DIRECT + 1)
+
+/* impl_opaque of a pipeline ring slot no stage has to process anymore */
+#define SW_PIPELINE_SLOT_DONE 0xff
 
 #define SW_NUM_POLL_BUCKETS (MAX_SW_CONS_Q_DEPTH >> SW_DEQ_STAT_BUCKET_SHIFT)
 
@@ -101,11 +117,37 @@ struct sw_iq {
 	uint16_t count;
 };
 
+/* The slots of the pipeline ring claimed and released by a stage */
+struct sw_pipeline_stage {
+	/* next slot to be claimed by a port of the stage */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) head;
+	/* the slots before this one have been released by the stage */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) tail;
+};
+
+/*
+ * A linear pipeline of consecutive QIDs sharing one ring, opdl style. The
+ * scheduler writes the events of the first QID to the ring, then the ports
+ * of each stage claim ranges of the slots released by the previous stage,
+ * and release them in order. An event forwarded to the next stage is
+ * updated in its slot, so it is never copied by the scheduler again.
+ */
+struct sw_pipeline {
+	uint8_t first_qid;
+	uint8_t nb_stages;
+	/* the slots before this one have been written by the scheduler */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) prod_tail;
+	struct sw_pipeline_stage stages[SW_PIPELINE_STAGES_MAX];
+	struct rte_event *ring;
+};
+
 struct sw_qid {
 	/* set when the QID has been initialized */
 	uint8_t initialized;
 	/* The type of this QID */
 	int8_t type;
+	/* The scheduler shard owning this QID */
+	uint8_t shard;
 	/* Integer ID representing the queue. This is used in history lists,
 	 * to identify the stage of processing.
 	 */
@@ -133,6 +175,10 @@ struct sw_qid {
 	uint32_t window_size;          /* Used to wrap reorder_buffer_index */
 
 	uint8_t priority;
+
+	/* Pipeline and stage of a SW_SCHED_TYPE_PIPELINE QID */
+	struct sw_pipeline *pipeline;
+	uint8_t pipeline_stage;
 };
 
 struct sw_hist_list_entry {
@@ -207,6 +253,83 @@ struct sw_port {
 	struct rte_event cq_buf[MAX_SW_CONS_Q_DEPTH];
 
 	uint8_t num_qids_mapped;
+
+	/* Sharded scheduling only, used by the worker: the rings of the
+	 * port in each shard, and the shard each outstanding event was
+	 * dequeued from, so that the release goes back to that shard.
+	 */
+	struct rte_event_ring *shard_rx_ring[SW_SHARDS_MAX];
+	struct rte_event_ring *shard_cq_ring[SW_SHARDS_MAX];
+	uint8_t deq_shard_next;
+	uint16_t deq_shard_head;
+	uint16_t deq_shard_tail;
+	uint8_t deq_shard[SW_INFLIGHT_EVENTS_TOTAL];
+
+	/* Pipeline stage ports only: the range of the pipeline ring claimed
+	 * by the port, and the slot of each dequeued event, in order.
+	 */
+	struct sw_pipeline *pipeline;
+	uint8_t pl_stage;
+	uint8_t pl_qid;
+	uint32_t pl_claim_start;
+	uint32_t pl_claim_count;
+	uint16_t pl_nb_slots;
+	uint16_t pl_next_slot;
+	uint32_t pl_slot[MAX_SW_CONS_Q_DEPTH];
+
+	/* Residency latency only: histogram of the events dequeued by the
+	 * port, SW_LAT_HIST_BUCKETS per QID.
+	 */
+	uint64_t *lat_hist;
+};
+
+/*
+ * A scheduler instance. Each shard is run by its own service and owns a
+ * subset of the QIDs, with their IQs, atomic flow tables and reorder
+ * buffers. Each shard has its own view of the ports: the rings, history
+ * lists and buffers used to exchange events with the workers. Shard 0 view
+ * of the ports is the sw->ports array itself. The events enqueued to a QID
+ * owned by another shard are forwarded through the fwd_ring of that shard.
+ */
+struct sw_shard {
+	struct sw_evdev *sw;
+	uint8_t id;
+
+	/* This shard's view of the ports */
+	struct sw_port *ports;
+
+	/* Events forwarded by the other shards to the QIDs of this shard */
+	struct rte_event_ring *fwd_ring;
+	/* Events to forward to the QIDs of each shard */
+	uint16_t fwd_buf_count[SW_SHARDS_MAX];
+	struct rte_event fwd_buf[SW_SHARDS_MAX][SW_SHARD_FWD_BURST_SIZE];
+
+	/* IQ chunks of the QIDs of this shard */
+	struct sw_queue_chunk *chunk_list_head;
+	struct sw_queue_chunk *chunks;
+
+	/* Current values */
+	uint32_t sched_flush_count;
+	uint32_t sched_min_burst;
+
+	/* Cache how many packets are in each cq */
+	alignas(RTE_CACHE_LINE_SIZE) uint16_t cq_ring_space[SW_PORTS_MAX];
+
+	/* Array of pointers to load-balanced QIDs sorted by priority level */
+	uint32_t qid_count;
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Stats */
+	alignas(RTE_CACHE_LINE_SIZE) struct sw_point_stats stats;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+	uint64_t sched_last_iter_bitmask;
+	uint8_t sched_progress_last_iter;
+
+	uint32_t service_id;
+	char service_name[SW_PMD_NAME_MAX];
 };
 
 struct sw_evdev {
@@ -226,9 +349,6 @@ struct sw_evdev {
 	uint32_t sched_deq_burst_size;
 	/* Refill pp buffers only once per scheduler call*/
 	uint32_t refill_once_per_iter;
-	/* Current values */
-	uint32_t sched_flush_count;
-	uint32_t sched_min_burst;
 
 	/* Contains all ports - load balanced and directed */
 	alignas(RTE_CACHE_LINE_SIZE) struct sw_port ports[SW_PORTS_MAX];
@@ -243,24 +363,20 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	alignas(RTE_CACHE_LINE_SIZE) struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV];
-	struct sw_queue_chunk *chunk_list_head;
-	struct sw_queue_chunk *chunks;
 
-	/* Cache how many packets are in each cq */
-	alignas(RTE_CACHE_LINE_SIZE) uint16_t cq_ring_space[SW_PORTS_MAX];
+	/* Scheduler instances */
+	uint32_t nb_shards;
+	struct sw_shard shards[SW_SHARDS_MAX];
 
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	/* Pipelines of QIDs, set from the devargs */
+	uint32_t nb_pipelines;
+	struct sw_pipeline pipelines[SW_PIPELINES_MAX];
 
-	/* Stats */
-	alignas(RTE_CACHE_LINE_SIZE) struct sw_point_stats stats;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
-	uint64_t sched_last_iter_bitmask;
-	uint8_t sched_progress_last_iter;
+
+	/* Residency latency, mbuf dynfield holding the enqueue timestamp */
+	uint8_t latency;
+	int lat_ts_offset;
 
 	uint8_t started;
 	uint32_t credit_update_quanta;
@@ -271,9 +387,6 @@ struct sw_evdev {
 	/* store num stats and offset of the stats for each queue */
 	uint16_t xstats_count_per_qid[RTE_EVENT_MAX_QUEUES_PER_DEV];
 	uint16_t xstats_offset_for_qid[RTE_EVENT_MAX_QUEUES_PER_DEV];
-
-	uint32_t service_id;
-	char service_name[SW_PMD_NAME_MAX];
 };
 
 static inline struct sw_evdev *
@@ -288,12 +401,22 @@ sw_pmd_priv_const(const struct rte_eventdev *eventdev)
 	return eventdev->data->dev_private;
 }
 
+static inline struct sw_port *
+sw_shard_port(const struct sw_evdev *sw, uint32_t shard, uint32_t port_id)
+{
+	return &sw->shards[shard].ports[port_id];
+}
+
 uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 		uint16_t num);
 
 uint16_t sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 			uint64_t wait);
-int32_t sw_event_schedule(struct rte_eventdev *dev);
+uint16_t sw_event_enqueue_burst_sharded(void *port, const struct rte_event ev[],
+		uint16_t num);
+uint16_t sw_event_dequeue_burst_sharded(void *port, struct rte_event *ev,
+		uint16_t num, uint64_t wait);
+int32_t sw_event_schedule(struct sw_shard *sh);
 int sw_xstats_init(struct sw_evdev *dev);
 int sw_xstats_uninit(struct sw_evdev *dev);
 int sw_xstats_get_names(const struct rte_eventdev *dev,
@@ -29,7 +29,7 @@
 
 
 static inline uint32_t
-sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_atomic_to_cq(struct sw_shard *sh, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count)
 {
 	struct rte_event qes[MAX_PER_IQ_DEQUEUE]; /* count <= MAX */
@@ -45,7 +45,7 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	 */
 	uint32_t qid_id = qid->id;
 
-	iq_dequeue_burst(sw, &qid->iq[iq_num], qes, count);
+	iq_dequeue_burst(sh, &qid->iq[iq_num], qes, count);
 	for (i = 0; i < count; i++) {
 		const struct rte_event *qe = &qes[i];
 		const uint16_t flow_id = SW_HASH_FLOWID(qes[i].flow_id);
@@ -61,11 +61,11 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			cq = qid->cq_map[cq_idx];
 
 			/* find least used */
-			int cq_free_cnt = sw->cq_ring_space[cq];
+			int cq_free_cnt = sh->cq_ring_space[cq];
 			for (cq_idx = 0; cq_idx < qid->cq_num_mapped_cqs;
 					cq_idx++) {
 				int test_cq = qid->cq_map[cq_idx];
-				int test_cq_free = sw->cq_ring_space[test_cq];
+				int test_cq_free = sh->cq_ring_space[test_cq];
 				if (test_cq_free > cq_free_cnt) {
 					cq = test_cq;
 					cq_free_cnt = test_cq_free;
@@ -75,19 +75,19 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			fid->cq = cq; /* this pins early */
 		}
 
-		if (sw->cq_ring_space[cq] == 0 ||
-				sw->ports[cq].inflights == SW_PORT_HIST_LIST) {
+		if (sh->cq_ring_space[cq] == 0 ||
+				sh->ports[cq].inflights == SW_PORT_HIST_LIST) {
 			blocked_qes[nb_blocked++] = *qe;
 			continue;
 		}
 
-		struct sw_port *p = &sw->ports[cq];
+		struct sw_port *p = &sh->ports[cq];
 
 		/* at this point we can queue up the packet on the cq_buf */
 		fid->pcount++;
 		p->cq_buf[p->cq_buf_count++] = *qe;
 		p->inflights++;
-		sw->cq_ring_space[cq]--;
+		sh->cq_ring_space[cq]--;
 
 		int head = (p->hist_head++ & (SW_PORT_HIST_LIST-1));
 		p->hist_list[head] = (struct sw_hist_list_entry) {
@@ -100,21 +100,21 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 		qid->to_port[cq]++;
 
 		/* if we just filled in the last slot, flush the buffer */
-		if (sw->cq_ring_space[cq] == 0) {
+		if (sh->cq_ring_space[cq] == 0) {
 			struct rte_event_ring *worker = p->cq_worker_ring;
 			rte_event_ring_enqueue_burst(worker, p->cq_buf,
 					p->cq_buf_count,
-					&sw->cq_ring_space[cq]);
+					&sh->cq_ring_space[cq]);
 			p->cq_buf_count = 0;
 		}
 	}
-	iq_put_back(sw, &qid->iq[iq_num], blocked_qes, nb_blocked);
+	iq_put_back(sh, &qid->iq[iq_num], blocked_qes, nb_blocked);
 
 	return count - nb_blocked;
 }
 
 static inline uint32_t
-sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_parallel_to_cq(struct sw_shard *sh, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count, int keep_order)
 {
 	uint32_t i;
@@ -150,16 +150,16 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 				cq_idx = 0;
 			cq = qid->cq_map[cq_idx++];
 
-		} while (sw->ports[cq].inflights == SW_PORT_HIST_LIST ||
+		} while (sh->ports[cq].inflights == SW_PORT_HIST_LIST ||
 				rte_event_ring_free_count(
-					sw->ports[cq].cq_worker_ring) == 0);
+					sh->ports[cq].cq_worker_ring) == 0);
 
-		struct sw_port *p = &sw->ports[cq];
-		if (sw->cq_ring_space[cq] == 0 ||
+		struct sw_port *p = &sh->ports[cq];
+		if (sh->cq_ring_space[cq] == 0 ||
 				p->inflights == SW_PORT_HIST_LIST)
 			break;
 
-		sw->cq_ring_space[cq]--;
+		sh->cq_ring_space[cq]--;
 
 		qid->stats.tx_pkts++;
 
@@ -173,8 +173,8 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			rob_ring_dequeue(qid->reorder_buffer_freelist,
 					(void *)&p->hist_list[head].rob_entry);
 
-		sw->ports[cq].cq_buf[sw->ports[cq].cq_buf_count++] = *qe;
-		iq_pop(sw, &qid->iq[iq_num]);
+		sh->ports[cq].cq_buf[sh->ports[cq].cq_buf_count++] = *qe;
+		iq_pop(sh, &qid->iq[iq_num]);
 
 		rte_compiler_barrier();
 		p->inflights++;
@@ -187,20 +187,20 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 }
 
 static uint32_t
-sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_dir_to_cq(struct sw_shard *sh, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count __rte_unused)
 {
 	uint32_t cq_id = qid->cq_map[0];
-	struct sw_port *port = &sw->ports[cq_id];
+	struct sw_port *port = &sh->ports[cq_id];
 
 	/* get max burst enq size for cq_ring */
-	uint32_t count_free = sw->cq_ring_space[cq_id];
+	uint32_t count_free = sh->cq_ring_space[cq_id];
 	if (count_free == 0)
 		return 0;
 
 	/* burst dequeue from the QID IQ ring */
 	struct sw_iq *iq = &qid->iq[iq_num];
-	uint32_t ret = iq_dequeue_burst(sw, iq,
+	uint32_t ret = iq_dequeue_burst(sh, iq,
 			&port->cq_buf[port->cq_buf_count], count_free);
 	port->cq_buf_count += ret;
 
@@ -209,21 +209,64 @@ sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	port->stats.tx_pkts += ret;
 
 	/* Subtract credits from cached value */
-	sw->cq_ring_space[cq_id] -= ret;
+	sh->cq_ring_space[cq_id] -= ret;
 
 	return ret;
 }
 
+/*
+ * Write the events of the first QID of a pipeline to the pipeline ring,
+ * which is the only copy made by the scheduler: the stages hand the events
+ * over to each other in the ring. The events for the other QIDs of the
+ * pipeline are rejected on port enqueue.
+ */
 static uint32_t
-sw_schedule_qid_to_cq(struct sw_evdev *sw)
+sw_schedule_pipeline_to_ring(struct sw_shard *sh, struct sw_qid * const qid,
+		uint32_t iq_num, unsigned int count)
+{
+	struct sw_pipeline *pl = qid->pipeline;
+	struct sw_iq *iq = &qid->iq[iq_num];
+	uint32_t prod, used, idx, n, i, j;
+
+	RTE_ASSERT(qid->pipeline_stage == 0);
+
+	/* the scheduler is the only producer of the ring */
+	prod = rte_atomic_load_explicit(&pl->prod_tail,
+			rte_memory_order_relaxed);
+	used = prod - rte_atomic_load_explicit(
+			&pl->stages[pl->nb_stages - 1].tail,
+			rte_memory_order_acquire);
+	count = RTE_MIN(count, SW_PIPELINE_RING_SIZE - used);
+	if (count == 0)
+		return 0;
+
+	/* at most two bursts, when wrapping around the end of the ring */
+	for (i = 0; i < count; i += n) {
+		idx = (prod + i) & (SW_PIPELINE_RING_SIZE - 1);
+		n = iq_dequeue_burst(sh, iq, &pl->ring[idx],
+				RTE_MIN(count - i, SW_PIPELINE_RING_SIZE - idx));
+		/* the events are for the first stage */
+		for (j = 0; j < n; j++)
+			pl->ring[idx + j].impl_opaque = 0;
+	}
+
+	rte_atomic_store_explicit(&pl->prod_tail, prod + count,
+			rte_memory_order_release);
+	qid->stats.tx_pkts += count;
+
+	return count;
+}
+
+static uint32_t
+sw_schedule_qid_to_cq(struct sw_shard *sh)
 {
 	uint32_t pkts = 0;
 	uint32_t qid_idx;
 
-	sw->sched_cq_qid_called++;
+	sh->sched_cq_qid_called++;
 
-	for (qid_idx = 0; qid_idx < sw->qid_count; qid_idx++) {
-		struct sw_qid *qid = sw->qids_prioritized[qid_idx];
+	for (qid_idx = 0; qid_idx < sh->qid_count; qid_idx++) {
+		struct sw_qid *qid = sh->qids_prioritized[qid_idx];
 
 		int type = qid->type;
 		int iq_num = PKT_MASK_TO_IQ(qid->iq_pkt_mask);
@@ -235,15 +278,18 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 		uint32_t pkts_done = 0;
 		uint32_t count = iq_count(&qid->iq[iq_num]);
 
-		if (count >= sw->sched_min_burst) {
+		if (count >= sh->sched_min_burst) {
 			if (type == SW_SCHED_TYPE_DIRECT)
-				pkts_done += sw_schedule_dir_to_cq(sw, qid,
+				pkts_done += sw_schedule_dir_to_cq(sh, qid,
 						iq_num, count);
 			else if (type == RTE_SCHED_TYPE_ATOMIC)
-				pkts_done += sw_schedule_atomic_to_cq(sw, qid,
+				pkts_done += sw_schedule_atomic_to_cq(sh, qid,
 						iq_num, count);
+			else if (type == SW_SCHED_TYPE_PIPELINE)
+				pkts_done += sw_schedule_pipeline_to_ring(sh,
+						qid, iq_num, count);
 			else
-				pkts_done += sw_schedule_parallel_to_cq(sw, qid,
+				pkts_done += sw_schedule_parallel_to_cq(sh, qid,
 						iq_num, count,
 						type == RTE_SCHED_TYPE_ORDERED);
 		}
@@ -260,14 +306,77 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 	return pkts;
 }
 
+/* Buffer an event enqueued to a QID owned by another shard. The forward ring
+ * of each shard is sized for all the inflight events, so the enqueue fails
+ * only when the application does not respect the device limits.
+ */
+static __rte_always_inline void
+sw_shard_fwd_flush(struct sw_shard *sh, uint32_t dst)
+{
+	struct sw_shard *dst_sh = &sh->sw->shards[dst];
+	uint32_t n;
+
+	n = rte_event_ring_enqueue_burst(dst_sh->fwd_ring, sh->fwd_buf[dst],
+			sh->fwd_buf_count[dst], NULL);
+	sh->stats.rx_dropped += sh->fwd_buf_count[dst] - n;
+	sh->fwd_buf_count[dst] = 0;
+}
+
+static __rte_always_inline void
+sw_shard_fwd(struct sw_shard *sh, const struct sw_qid *qid,
+		const struct rte_event *qe)
+{
+	uint32_t dst = qid->shard;
+
+	sh->fwd_buf[dst][sh->fwd_buf_count[dst]++] = *qe;
+	if (sh->fwd_buf_count[dst] == SW_SHARD_FWD_BURST_SIZE)
+		sw_shard_fwd_flush(sh, dst);
+}
+
+static void
+sw_shard_fwd_flush_all(struct sw_shard *sh)
+{
+	uint32_t i;
+
+	for (i = 0; i < sh->sw->nb_shards; i++)
+		if (sh->fwd_buf_count[i])
+			sw_shard_fwd_flush(sh, i);
+}
+
+/* Pull the events forwarded by the other shards to the QIDs of this shard */
+static uint32_t
+sw_schedule_pull_fwd(struct sw_shard *sh)
+{
+	struct rte_event qes[SCHED_DEQUEUE_MAX_BURST_SIZE];
+	struct sw_evdev *sw = sh->sw;
+	uint32_t i, n;
+
+	n = rte_event_ring_dequeue_burst(sh->fwd_ring, qes,
+			sw->sched_deq_burst_size, NULL);
+
+	for (i = 0; i < n; i++) {
+		const struct rte_event *qe = &qes[i];
+		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
+		struct sw_qid *qid = &sw->qids[qe->queue_id];
+
+		qid->iq_pkt_mask |= (1 << (iq_num));
+		iq_enqueue(sh, &qid->iq[iq_num], qe);
+		qid->iq_pkt_count[iq_num]++;
+		qid->stats.rx_pkts++;
+	}
+
+	return n;
+}
+
 /* This function will perform re-ordering of packets, and injecting into
  * the appropriate QID IQ. As LB and DIR QIDs are in the same array, but *NOT*
  * contiguous in that array, this function accepts a "range" of QIDs to scan.
  */
 static uint16_t
-sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
+sw_schedule_reorder(struct sw_shard *sh, int qid_start, int qid_end)
 {
 	/* Perform egress reordering */
+	struct sw_evdev *sw = sh->sw;
 	struct rte_event *qe;
 	uint32_t pkts_iter = 0;
 
@@ -275,13 +384,14 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 		struct sw_qid *qid = &sw->qids[qid_start];
 		unsigned int i, num_entries_in_use;
 
-		if (qid->type != RTE_SCHED_TYPE_ORDERED)
+		if (qid->type != RTE_SCHED_TYPE_ORDERED ||
+				qid->shard != sh->id)
 			continue;
 
 		num_entries_in_use = rob_ring_free_count(
 					qid->reorder_buffer_freelist);
 
-		if (num_entries_in_use < sw->sched_min_burst)
+		if (num_entries_in_use < sh->sched_min_burst)
 			num_entries_in_use = 0;
 
 		for (i = 0; i < num_entries_in_use; i++) {
@@ -304,19 +414,24 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 				dest_iq  = PRIO_TO_IQ(qe->priority);
 
 				if (dest_qid >= sw->qid_count) {
-					sw->stats.rx_dropped++;
+					sh->stats.rx_dropped++;
 					continue;
 				}
 
-				pkts_iter++;
-
 				struct sw_qid *q = &sw->qids[dest_qid];
 				struct sw_iq *iq = &q->iq[dest_iq];
 
+				if (q->shard != sh->id) {
+					sw_shard_fwd(sh, q, qe);
+					continue;
+				}
+
+				pkts_iter++;
+
 				/* we checked for space above, so enqueue must
 				 * succeed
 				 */
-				iq_enqueue(sw, iq, qe);
+				iq_enqueue(sh, iq, qe);
 				q->iq_pkt_mask |= (1 << (dest_iq));
 				q->iq_pkt_count[dest_iq]++;
 				q->stats.rx_pkts++;
@@ -352,11 +467,12 @@ sw_refill_pp_buf(struct sw_evdev *sw, struct sw_port *port)
 }
 
 static __rte_always_inline uint32_t
-__pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
+__pull_port_lb(struct sw_shard *sh, uint32_t port_id, int allow_reorder)
 {
 	static struct reorder_buffer_entry dummy_rob;
+	struct sw_evdev *sw = sh->sw;
 	uint32_t pkts_iter = 0;
-	struct sw_port *port = &sw->ports[port_id];
+	struct sw_port *port = &sh->ports[port_id];
 
 	/* If shadow ring has 0 pkts, pull from worker ring */
 	if (!sw->refill_once_per_iter && port->pp_buf_count == 0)
@@ -424,7 +540,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				 */
 				int num_frag = rob_entry->num_fragments;
 				if (num_frag == SW_FRAGMENTS_MAX)
-					sw->stats.rx_dropped++;
+					sh->stats.rx_dropped++;
 				else {
 					int idx = rob_entry->num_fragments++;
 					rob_entry->fragments[idx] = *qe;
@@ -432,12 +548,17 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				goto end_qe;
 			}
 
+			if (qid->shard != sh->id) {
+				sw_shard_fwd(sh, qid, qe);
+				goto end_qe;
+			}
+
 			/* Use the iq_num from above to push the QE
 			 * into the qid at the right priority
 			 */
 
 			qid->iq_pkt_mask |= (1 << (iq_num));
-			iq_enqueue(sw, &qid->iq[iq_num], qe);
+			iq_enqueue(sh, &qid->iq[iq_num], qe);
 			qid->iq_pkt_count[iq_num]++;
 			qid->stats.rx_pkts++;
 			pkts_iter++;
@@ -452,22 +573,23 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 }
 
 static uint32_t
-sw_schedule_pull_port_lb(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_lb(struct sw_shard *sh, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 1);
+	return __pull_port_lb(sh, port_id, 1);
 }
 
 static uint32_t
-sw_schedule_pull_port_no_reorder(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_no_reorder(struct sw_shard *sh, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 0);
+	return __pull_port_lb(sh, port_id, 0);
 }
 
 static uint32_t
-sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_dir(struct sw_shard *sh, uint32_t port_id)
 {
+	struct sw_evdev *sw = sh->sw;
 	uint32_t pkts_iter = 0;
-	struct sw_port *port = &sw->ports[port_id];
+	struct sw_port *port = &sh->ports[port_id];
 
 	/* If shadow ring has 0 pkts, pull from worker ring */
 	if (!sw->refill_once_per_iter && port->pp_buf_count == 0)
@@ -486,11 +608,16 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 
 		port->stats.rx_pkts++;
 
+		if (qid->shard != sh->id) {
+			sw_shard_fwd(sh, qid, qe);
+			goto end_qe;
+		}
+
 		/* Use the iq_num from above to push the QE
 		 * into the qid at the right priority
 		 */
 		qid->iq_pkt_mask |= (1 << (iq_num));
-		iq_enqueue(sw, iq, qe);
+		iq_enqueue(sh, iq, qe);
 		qid->iq_pkt_count[iq_num]++;
 		qid->stats.rx_pkts++;
 		pkts_iter++;
@@ -504,15 +631,15 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 }
 
 int32_t
-sw_event_schedule(struct rte_eventdev *dev)
+sw_event_schedule(struct sw_shard *sh)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_evdev *sw = sh->sw;
 	uint32_t in_pkts, out_pkts;
 	uint32_t out_pkts_total = 0, in_pkts_total = 0;
 	int32_t sched_quanta = sw->sched_quanta;
 	uint32_t i;
 
-	sw->sched_called++;
+	sh->sched_called++;
 	if (unlikely(!sw->started))
 		return -EAGAIN;
 
@@ -524,25 +651,31 @@ sw_event_schedule(struct rte_eventdev *dev)
 			in_pkts = 0;
 			for (i = 0; i < sw->port_count; i++) {
 				/* ack the unlinks in progress as done */
-				if (sw->ports[i].unlinks_in_progress)
-					sw->ports[i].unlinks_in_progress = 0;
+				if (sh->ports[i].unlinks_in_progress)
+					sh->ports[i].unlinks_in_progress = 0;
 
-				if (sw->ports[i].is_directed)
-					in_pkts += sw_schedule_pull_port_dir(sw, i);
-				else if (sw->ports[i].num_ordered_qids > 0)
-					in_pkts += sw_schedule_pull_port_lb(sw, i);
+				if (sh->ports[i].is_directed)
+					in_pkts += sw_schedule_pull_port_dir(sh, i);
+				else if (sh->ports[i].num_ordered_qids > 0)
+					in_pkts += sw_schedule_pull_port_lb(sh, i);
 				else
-					in_pkts += sw_schedule_pull_port_no_reorder(sw, i);
+					in_pkts += sw_schedule_pull_port_no_reorder(sh, i);
 			}
 
 			/* QID scan for re-ordered */
-			in_pkts += sw_schedule_reorder(sw, 0,
+			in_pkts += sw_schedule_reorder(sh, 0,
 					sw->qid_count);
+
+			/* Exchange the events with the other shards */
+			if (sw->nb_shards > 1) {
+				sw_shard_fwd_flush_all(sh);
+				in_pkts += sw_schedule_pull_fwd(sh);
+			}
 			in_pkts_this_iteration += in_pkts;
 		} while (in_pkts > 4 &&
 				(int)in_pkts_this_iteration < sched_quanta);
 
-		out_pkts = sw_schedule_qid_to_cq(sw);
+		out_pkts = sw_schedule_qid_to_cq(sh);
 		out_pkts_total += out_pkts;
 		in_pkts_total += in_pkts_this_iteration;
 
@@ -550,14 +683,14 @@ sw_event_schedule(struct rte_eventdev *dev)
 			break;
 	} while ((int)out_pkts_total < sched_quanta);
 
-	sw->stats.tx_pkts += out_pkts_total;
-	sw->stats.rx_pkts += in_pkts_total;
+	sh->stats.tx_pkts += out_pkts_total;
+	sh->stats.rx_pkts += in_pkts_total;
 
-	sw->sched_no_iq_enqueues += (in_pkts_total == 0);
-	sw->sched_no_cq_enqueues += (out_pkts_total == 0);
+	sh->sched_no_iq_enqueues += (in_pkts_total == 0);
+	sh->sched_no_cq_enqueues += (out_pkts_total == 0);
 
 	uint64_t work_done = (in_pkts_total + out_pkts_total) != 0;
-	sw->sched_progress_last_iter = work_done;
+	sh->sched_progress_last_iter = work_done;
 
 	uint64_t cqs_scheds_last_iter = 0;
 
@@ -566,47 +699,47 @@ sw_event_schedule(struct rte_eventdev *dev)
 	 */
 	int no_enq = 1;
 	for (i = 0; i < sw->port_count; i++) {
-		struct sw_port *port = &sw->ports[i];
+		struct sw_port *port = &sh->ports[i];
 		struct rte_event_ring *worker = port->cq_worker_ring;
 
 		/* If shadow ring has 0 pkts, pull from worker ring */
 		if (sw->refill_once_per_iter && port->pp_buf_count == 0)
 			sw_refill_pp_buf(sw, port);
 
-		if (port->cq_buf_count >= sw->sched_min_burst) {
+		if (port->cq_buf_count >= sh->sched_min_burst) {
 			rte_event_ring_enqueue_burst(worker,
 					port->cq_buf,
 					port->cq_buf_count,
-					&sw->cq_ring_space[i]);
+					&sh->cq_ring_space[i]);
 			port->cq_buf_count = 0;
 			no_enq = 0;
 			cqs_scheds_last_iter |= (1ULL << i);
 		} else {
-			sw->cq_ring_space[i] =
+			sh->cq_ring_space[i] =
 					rte_event_ring_free_count(worker) -
 					port->cq_buf_count;
 		}
 	}
 
 	if (no_enq) {
-		if (unlikely(sw->sched_flush_count > SCHED_NO_ENQ_CYCLE_FLUSH))
-			sw->sched_min_burst = 1;
+		if (unlikely(sh->sched_flush_count > SCHED_NO_ENQ_CYCLE_FLUSH))
+			sh->sched_min_burst = 1;
 		else
-			sw->sched_flush_count++;
+			sh->sched_flush_count++;
 	} else {
-		if (sw->sched_flush_count)
-			sw->sched_flush_count--;
+		if (sh->sched_flush_count)
+			sh->sched_flush_count--;
 		else
-			sw->sched_min_burst = sw->sched_min_burst_size;
+			sh->sched_min_burst = sw->sched_min_burst_size;
 	}
 
 	/* Provide stats on what eventdev ports were scheduled to this
 	 * iteration. If more than 64 ports are active, always report that
 	 * all Eventdev ports have been scheduled events.
 	 */
-	sw->sched_last_iter_bitmask = cqs_scheds_last_iter;
+	sh->sched_last_iter_bitmask = cqs_scheds_last_iter;
 	if (unlikely(sw->port_count >= 64))
-		sw->sched_last_iter_bitmask = UINT64_MAX;
+		sh->sched_last_iter_bitmask = UINT64_MAX;
 
 	return work_done ? 0 : -EAGAIN;
 }
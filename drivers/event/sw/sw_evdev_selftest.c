@@ -17,6 +17,7 @@
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
 #include <rte_debug.h>
+#include <rte_bitops.h>
 #include <rte_ethdev.h>
 #include <rte_cycles.h>
 #include <rte_eventdev.h>
@@ -31,6 +32,7 @@
 #define MAX_QIDS 16
 #define NUM_PACKETS (1 << 17)
 #define DEQUEUE_DEPTH 128
+#define NUM_SHARDED_EVENTS 16
 
 static int evdev;
 
@@ -3086,6 +3088,669 @@ ordered_atomic_hist_completion(struct test *t)
 	return 0;
 }
 
+static int
+sharded_forward(struct test *t)
+{
+	/* Two shards: QID 0 is scheduled by shard 0 and QID 1 by shard 1 */
+	const char *eventdev_name = "event_sw_sharded";
+	const int saved_evdev = evdev;
+	struct test_event_dev_stats stats;
+	struct rte_event ev[NUM_SHARDED_EVENTS];
+	uint32_t service_id[2];
+	int i, ret = -1;
+	uint32_t deq;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "shards=2") < 0) {
+			printf("%d: Error creating sharded eventdev\n", __LINE__);
+			goto restore;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+		if (evdev < 0) {
+			printf("%d: Error finding sharded eventdev\n", __LINE__);
+			goto restore;
+		}
+	}
+
+	if (rte_event_dev_service_ids_get(evdev, service_id, 2) != 2) {
+		printf("%d: Failed to get the shard service IDs\n", __LINE__);
+		goto restore;
+	}
+	for (i = 0; i < 2; i++) {
+		rte_service_runstate_set(service_id[i], 1);
+		rte_service_set_runstate_mapped_check(service_id[i], 0);
+	}
+
+	if (init(t, 2, 1) < 0 ||
+			create_ports(t, 1) < 0 ||
+			create_atomic_qids(t, 2) < 0)
+		goto restore;
+
+	if (rte_event_port_link(evdev, t->port[0], NULL, NULL, 0) != 2) {
+		printf("%d: error mapping port 0 to qids\n", __LINE__);
+		goto out;
+	}
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto out;
+	}
+
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		ev[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[0],
+			.event_type = RTE_EVENT_TYPE_CPU,
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.flow_id = i % 4,
+			.u64 = i,
+		};
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS) != NUM_SHARDED_EVENTS) {
+		printf("%d: Failed to enqueue\n", __LINE__);
+		goto out;
+	}
+
+	/* shard 0 schedules the new events of QID 0 */
+	for (i = 0; i < 2; i++) {
+		rte_service_run_iter_on_app_lcore(service_id[0], 1);
+		rte_service_run_iter_on_app_lcore(service_id[1], 1);
+	}
+
+	deq = rte_event_dequeue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS, 0);
+	if (deq != NUM_SHARDED_EVENTS) {
+		printf("%d: expected %d events from qid 0, got %u\n",
+				__LINE__, NUM_SHARDED_EVENTS, deq);
+		goto out;
+	}
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		if (ev[i].queue_id != t->qid[0] || ev[i].u64 != (uint64_t)i) {
+			printf("%d: event %d out of order\n", __LINE__, i);
+			goto out;
+		}
+		ev[i].op = RTE_EVENT_OP_FORWARD;
+		ev[i].queue_id = t->qid[1];
+	}
+
+	/* shard 0 completes the events and hands them over to shard 1 */
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS) != NUM_SHARDED_EVENTS) {
+		printf("%d: Failed to forward\n", __LINE__);
+		goto out;
+	}
+	for (i = 0; i < 2; i++) {
+		rte_service_run_iter_on_app_lcore(service_id[0], 1);
+		rte_service_run_iter_on_app_lcore(service_id[1], 1);
+	}
+
+	deq = rte_event_dequeue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS, 0);
+	if (deq != NUM_SHARDED_EVENTS) {
+		printf("%d: expected %d events from qid 1, got %u\n",
+				__LINE__, NUM_SHARDED_EVENTS, deq);
+		goto out;
+	}
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		if (ev[i].queue_id != t->qid[1] || ev[i].u64 != (uint64_t)i) {
+			printf("%d: forwarded event %d out of order\n",
+					__LINE__, i);
+			goto out;
+		}
+		ev[i].op = RTE_EVENT_OP_RELEASE;
+	}
+
+	/* the releases go back to shard 1, which scheduled the events */
+	rte_event_enqueue_burst(evdev, t->port[0], ev, NUM_SHARDED_EVENTS);
+	for (i = 0; i < 2; i++) {
+		rte_service_run_iter_on_app_lcore(service_id[0], 1);
+		rte_service_run_iter_on_app_lcore(service_id[1], 1);
+	}
+
+	test_event_dev_stats_get(evdev, &stats);
+	if (stats.port_inflight[0] != 0 ||
+			stats.tx_pkts != 2 * NUM_SHARDED_EVENTS) {
+		printf("%d: unexpected stats after release\n", __LINE__);
+		rte_event_dev_dump(evdev, stdout);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	cleanup(t);
+restore:
+	evdev = saved_evdev;
+	return ret;
+}
+
+static int
+pipeline_forward(struct test *t)
+{
+	/* QID 0 and 1 are the two stages of a pipeline, QID 2 is after it */
+	const char *eventdev_name = "event_sw_pipeline";
+	const int saved_evdev = evdev;
+	static const struct rte_event_queue_conf atomic_conf = {
+			.schedule_type = RTE_SCHED_TYPE_ATOMIC,
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.nb_atomic_flows = 1024,
+			.nb_atomic_order_sequences = 1024,
+	};
+	struct test_event_dev_stats stats;
+	struct rte_event ev[NUM_SHARDED_EVENTS];
+	uint32_t service_id;
+	int i, ret = -1;
+	uint32_t deq;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "pipeline=0:2") < 0) {
+			printf("%d: Error creating pipeline eventdev\n",
+					__LINE__);
+			goto restore;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+		if (evdev < 0) {
+			printf("%d: Error finding pipeline eventdev\n",
+					__LINE__);
+			goto restore;
+		}
+	}
+
+	if (rte_event_dev_service_id_get(evdev, &service_id) < 0) {
+		printf("%d: Failed to get service ID\n", __LINE__);
+		goto restore;
+	}
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+
+	if (init(t, 3, 3) < 0 ||
+			create_ports(t, 3) < 0)
+		goto restore;
+
+	/* the stages of a pipeline don't provide atomicity */
+	if (rte_event_queue_setup(evdev, 0, &atomic_conf) != -EINVAL) {
+		printf("%d: atomic pipeline qid created\n", __LINE__);
+		goto out;
+	}
+
+	if (create_unordered_qids(t, 2) < 0 ||
+			create_atomic_qids(t, 1) < 0)
+		goto out;
+
+	for (i = 0; i < 3; i++) {
+		/* port 0 is the producer, port 1 and 2 the stages */
+		uint8_t port = t->port[(i + 1) % 3];
+
+		if (rte_event_port_link(evdev, port, &t->qid[i], NULL, 1) != 1) {
+			printf("%d: error mapping port %u to qid %d\n",
+					__LINE__, port, i);
+			goto out;
+		}
+	}
+	/* a stage port takes from its stage only */
+	if (rte_event_port_link(evdev, t->port[1], &t->qid[2], NULL, 1) != 0) {
+		printf("%d: stage port linked to a second qid\n", __LINE__);
+		goto out;
+	}
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto out;
+	}
+
+	/* the second stage is only fed by the first one */
+	ev[0] = (struct rte_event){
+		.op = RTE_EVENT_OP_NEW,
+		.queue_id = t->qid[1],
+		.event_type = RTE_EVENT_TYPE_CPU,
+		.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+	};
+	rte_errno = 0;
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev, 1) != 0 ||
+			rte_errno != EINVAL) {
+		printf("%d: event enqueued to the second stage\n", __LINE__);
+		goto out;
+	}
+
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		ev[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[0],
+			.event_type = RTE_EVENT_TYPE_CPU,
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.flow_id = i % 4,
+			.u64 = i,
+		};
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS) != NUM_SHARDED_EVENTS) {
+		printf("%d: Failed to enqueue\n", __LINE__);
+		goto out;
+	}
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	deq = rte_event_dequeue_burst(evdev, t->port[1], ev,
+			NUM_SHARDED_EVENTS, 0);
+	if (deq != NUM_SHARDED_EVENTS) {
+		printf("%d: expected %d events from stage 0, got %u\n",
+				__LINE__, NUM_SHARDED_EVENTS, deq);
+		goto out;
+	}
+
+	/* the events are not released by stage 0 yet */
+	if (rte_event_dequeue_burst(evdev, t->port[2], &ev[0], 1, 0) != 0) {
+		printf("%d: stage 1 dequeued an unreleased event\n", __LINE__);
+		goto out;
+	}
+
+	/* forward the even events to stage 1, release the others */
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		if (ev[i].queue_id != t->qid[0] || ev[i].u64 != (uint64_t)i) {
+			printf("%d: event %d out of order\n", __LINE__, i);
+			goto out;
+		}
+		ev[i].op = (i & 1) ? RTE_EVENT_OP_RELEASE :
+				RTE_EVENT_OP_FORWARD;
+		ev[i].queue_id = t->qid[1];
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[1], ev,
+			NUM_SHARDED_EVENTS) != NUM_SHARDED_EVENTS) {
+		printf("%d: Failed to forward\n", __LINE__);
+		goto out;
+	}
+
+	/* stage 1 gets the forwarded events without the scheduler */
+	deq = rte_event_dequeue_burst(evdev, t->port[2], ev,
+			NUM_SHARDED_EVENTS, 0);
+	if (deq != NUM_SHARDED_EVENTS / 2) {
+		printf("%d: expected %d events from stage 1, got %u\n",
+				__LINE__, NUM_SHARDED_EVENTS / 2, deq);
+		goto out;
+	}
+	for (i = 0; i < NUM_SHARDED_EVENTS / 2; i++) {
+		if (ev[i].queue_id != t->qid[1] ||
+				ev[i].u64 != (uint64_t)(2 * i)) {
+			printf("%d: forwarded event %d out of order\n",
+					__LINE__, i);
+			goto out;
+		}
+		ev[i].op = RTE_EVENT_OP_FORWARD;
+		ev[i].queue_id = t->qid[2];
+	}
+
+	/* the events leave the pipeline through the scheduler */
+	if (rte_event_enqueue_burst(evdev, t->port[2], ev,
+			NUM_SHARDED_EVENTS / 2) != NUM_SHARDED_EVENTS / 2) {
+		printf("%d: Failed to forward out of the pipeline\n", __LINE__);
+		goto out;
+	}
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	deq = rte_event_dequeue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS, 0);
+	if (deq != NUM_SHARDED_EVENTS / 2) {
+		printf("%d: expected %d events from qid 2, got %u\n",
+				__LINE__, NUM_SHARDED_EVENTS / 2, deq);
+		goto out;
+	}
+	for (i = 0; i < NUM_SHARDED_EVENTS / 2; i++) {
+		if (ev[i].queue_id != t->qid[2] ||
+				ev[i].u64 != (uint64_t)(2 * i)) {
+			printf("%d: event %d out of order after the pipeline\n",
+					__LINE__, i);
+			goto out;
+		}
+		ev[i].op = RTE_EVENT_OP_RELEASE;
+	}
+	rte_event_enqueue_burst(evdev, t->port[0], ev, NUM_SHARDED_EVENTS / 2);
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	test_event_dev_stats_get(evdev, &stats);
+	if (stats.port_inflight[0] != 0 ||
+			stats.qid_rx_pkts[0] != NUM_SHARDED_EVENTS ||
+			stats.qid_rx_pkts[2] != NUM_SHARDED_EVENTS / 2) {
+		printf("%d: unexpected stats after release\n", __LINE__);
+		rte_event_dev_dump(evdev, stdout);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	cleanup(t);
+restore:
+	evdev = saved_evdev;
+	return ret;
+}
+
+/* dequeue the events u64 first to first + num - 1 from a port */
+static int
+pipeline_port_deq(uint8_t port, struct rte_event *ev, uint32_t first,
+		uint32_t num)
+{
+	uint32_t deq, i;
+
+	deq = rte_event_dequeue_burst(evdev, port, ev, num, 0);
+	if (deq != num) {
+		printf("%d: expected %u events from port %u, got %u\n",
+				__LINE__, num, port, deq);
+		return -1;
+	}
+	for (i = 0; i < num; i++) {
+		if (ev[i].u64 != first + i) {
+			printf("%d: port %u event %u out of order\n",
+					__LINE__, port, i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+pipeline_ports(struct test *t)
+{
+	/* QID 0 and 1 are the two stages of a pipeline, with two ports each
+	 * releasing their ranges out of order, QID 2 is after it
+	 */
+	const char *eventdev_name = "event_sw_pipeline";
+	const int saved_evdev = evdev;
+	const uint32_t half = NUM_SHARDED_EVENTS / 2;
+	struct rte_event ev[2][NUM_SHARDED_EVENTS];
+	struct test_event_dev_stats stats;
+	uint32_t service_id;
+	int i, ret = -1;
+	uint8_t qid;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "pipeline=0:2") < 0) {
+			printf("%d: Error creating pipeline eventdev\n",
+					__LINE__);
+			goto restore;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+		if (evdev < 0) {
+			printf("%d: Error finding pipeline eventdev\n",
+					__LINE__);
+			goto restore;
+		}
+	}
+
+	if (rte_event_dev_service_id_get(evdev, &service_id) < 0) {
+		printf("%d: Failed to get service ID\n", __LINE__);
+		goto restore;
+	}
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+
+	if (init(t, 3, 5) < 0 ||
+			create_ports(t, 5) < 0)
+		goto restore;
+
+	if (create_unordered_qids(t, 2) < 0 ||
+			create_atomic_qids(t, 1) < 0)
+		goto out;
+
+	/* port 0 is the producer, port 1 and 2 take from stage 0, port 3
+	 * and 4 from stage 1
+	 */
+	for (i = 0; i < 5; i++) {
+		qid = t->qid[i == 0 ? 2 : (i - 1) / 2];
+		if (rte_event_port_link(evdev, t->port[i], &qid, NULL, 1) != 1) {
+			printf("%d: error mapping port %d to qid %u\n",
+					__LINE__, i, qid);
+			goto out;
+		}
+	}
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto out;
+	}
+
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		ev[0][i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[0],
+			.event_type = RTE_EVENT_TYPE_CPU,
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.u64 = i,
+		};
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev[0],
+			NUM_SHARDED_EVENTS) != NUM_SHARDED_EVENTS) {
+		printf("%d: Failed to enqueue\n", __LINE__);
+		goto out;
+	}
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	/* the two ports of stage 0 claim consecutive ranges */
+	if (pipeline_port_deq(t->port[1], ev[0], 0, half) < 0 ||
+			pipeline_port_deq(t->port[2], ev[1], half, half) < 0)
+		goto out;
+
+	/* a port can't leave its stage with a claimed range */
+	qid = t->qid[0];
+	rte_errno = 0;
+	if (rte_event_port_unlink(evdev, t->port[2], &qid, 1) != 0 ||
+			rte_errno != EBUSY) {
+		printf("%d: port unlinked with a claimed range\n", __LINE__);
+		goto out;
+	}
+
+	/* the second range is released first, stage 1 must wait for the
+	 * first one
+	 */
+	for (i = 0; i < (int)half; i++) {
+		ev[0][i].op = RTE_EVENT_OP_FORWARD;
+		ev[0][i].queue_id = t->qid[1];
+		ev[1][i].op = RTE_EVENT_OP_FORWARD;
+		ev[1][i].queue_id = t->qid[1];
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[2], ev[1], half) != half) {
+		printf("%d: Failed to forward\n", __LINE__);
+		goto out;
+	}
+	if (rte_event_dequeue_burst(evdev, t->port[3], ev[1],
+			NUM_SHARDED_EVENTS, 0) != 0) {
+		printf("%d: stage 1 dequeued out of order\n", __LINE__);
+		goto out;
+	}
+
+	/* releasing the first range only releases it */
+	if (rte_event_enqueue_burst(evdev, t->port[1], ev[0], half) != half) {
+		printf("%d: Failed to forward\n", __LINE__);
+		goto out;
+	}
+	if (pipeline_port_deq(t->port[3], ev[0], 0, half) < 0)
+		goto out;
+
+	/* the second range is released by the next dequeue of its port */
+	if (rte_event_dequeue_burst(evdev, t->port[2], ev[1],
+			NUM_SHARDED_EVENTS, 0) != 0) {
+		printf("%d: stage 0 dequeued an event twice\n", __LINE__);
+		goto out;
+	}
+	if (pipeline_port_deq(t->port[4], ev[1], half, half) < 0)
+		goto out;
+
+	/* the range is released, the port can leave its stage */
+	if (rte_event_port_unlink(evdev, t->port[2], &qid, 1) != 1) {
+		printf("%d: Failed to unlink port\n", __LINE__);
+		goto out;
+	}
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	/* stage 1 releases out of order, the events leave the pipeline */
+	for (i = 0; i < (int)half; i++) {
+		ev[0][i].op = RTE_EVENT_OP_FORWARD;
+		ev[0][i].queue_id = t->qid[2];
+		ev[1][i].op = RTE_EVENT_OP_RELEASE;
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[4], ev[1], half) != half ||
+			rte_event_enqueue_burst(evdev, t->port[3], ev[0],
+				half) != half) {
+		printf("%d: Failed to forward out of the pipeline\n", __LINE__);
+		goto out;
+	}
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	if (pipeline_port_deq(t->port[0], ev[0], 0, half) < 0)
+		goto out;
+	for (i = 0; i < (int)half; i++)
+		ev[0][i].op = RTE_EVENT_OP_RELEASE;
+	rte_event_enqueue_burst(evdev, t->port[0], ev[0], half);
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	test_event_dev_stats_get(evdev, &stats);
+	if (stats.port_inflight[0] != 0 ||
+			stats.qid_rx_pkts[0] != NUM_SHARDED_EVENTS ||
+			stats.qid_rx_pkts[2] != half) {
+		printf("%d: unexpected stats after release\n", __LINE__);
+		rte_event_dev_dump(evdev, stdout);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	cleanup(t);
+restore:
+	evdev = saved_evdev;
+	return ret;
+}
+
+static int
+residency_hist(struct test *t)
+{
+	const char *eventdev_name = "event_sw_latency";
+	const int saved_evdev = evdev;
+	struct rte_event ev[NUM_SHARDED_EVENTS];
+	char name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
+	uint64_t port_total = 0, qid_total = 0;
+	uint64_t port_hist, qid_hist, start;
+	/* the events stay 1 ms in the device, or a bit more */
+	const uint64_t delay = rte_get_timer_hz() / 1000;
+	const int min_bucket = rte_fls_u64(delay);
+	const int max_bucket = RTE_MIN(rte_fls_u64(rte_get_timer_hz()),
+			(uint32_t)SW_LAT_HIST_BUCKETS - 1);
+	uint32_t service_id;
+	int i, ret = -1;
+	uint32_t deq = 0;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "latency=1") < 0) {
+			printf("%d: Error creating latency eventdev\n",
+					__LINE__);
+			goto restore;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+		if (evdev < 0) {
+			printf("%d: Error finding latency eventdev\n",
+					__LINE__);
+			goto restore;
+		}
+	}
+
+	if (rte_event_dev_service_id_get(evdev, &service_id) < 0) {
+		printf("%d: Failed to get service ID\n", __LINE__);
+		goto restore;
+	}
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+
+	if (init(t, 1, 1) < 0 ||
+			create_ports(t, 1) < 0 ||
+			create_atomic_qids(t, 1) < 0)
+		goto restore;
+
+	if (rte_event_port_link(evdev, t->port[0], NULL, NULL, 0) != 1) {
+		printf("%d: error mapping qid to port\n", __LINE__);
+		goto out;
+	}
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto out;
+	}
+
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		struct rte_mbuf *arp = rte_gen_arp(0, t->mbuf_pool);
+
+		if (!arp) {
+			printf("%d: gen of pkt failed\n", __LINE__);
+			goto out;
+		}
+		ev[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[0],
+			.event_type = RTE_EVENT_TYPE_ETHDEV,
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.flow_id = i % 4,
+			.mbuf = arp,
+		};
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS) != NUM_SHARDED_EVENTS) {
+		printf("%d: Failed to enqueue\n", __LINE__);
+		goto free;
+	}
+	start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() - start < delay)
+		rte_pause();
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+
+	deq = rte_event_dequeue_burst(evdev, t->port[0], ev,
+			NUM_SHARDED_EVENTS, 0);
+	if (deq != NUM_SHARDED_EVENTS) {
+		printf("%d: expected %d events, got %u\n",
+				__LINE__, NUM_SHARDED_EVENTS, deq);
+		goto free;
+	}
+
+	/* each dequeued event is in one bucket of the port and qid, no
+	 * lower than the bucket of the delay, and below one second
+	 */
+	for (i = 0; i < SW_LAT_HIST_BUCKETS; i++) {
+		snprintf(name, sizeof(name), "port_%u_residency_hist_%d",
+				t->port[0], i);
+		port_hist = rte_event_dev_xstats_by_name_get(evdev, name,
+				NULL);
+		snprintf(name, sizeof(name), "qid_%u_residency_hist_%d",
+				t->qid[0], i);
+		qid_hist = rte_event_dev_xstats_by_name_get(evdev, name,
+				NULL);
+		if ((i < min_bucket || i > max_bucket) &&
+				(port_hist != 0 || qid_hist != 0)) {
+			printf("%d: events in bucket %d, expected %d to %d\n",
+					__LINE__, i, min_bucket, max_bucket);
+			goto free;
+		}
+		port_total += port_hist;
+		qid_total += qid_hist;
+	}
+	if (port_total != NUM_SHARDED_EVENTS ||
+			qid_total != NUM_SHARDED_EVENTS) {
+		printf("%d: expected %d events in the histograms, got port %"
+				PRIu64 " qid %" PRIu64 "\n", __LINE__,
+				NUM_SHARDED_EVENTS, port_total, qid_total);
+		goto free;
+	}
+
+	ret = 0;
+free:
+	for (i = 0; i < NUM_SHARDED_EVENTS; i++) {
+		if ((uint32_t)i < deq)
+			ev[i].op = RTE_EVENT_OP_RELEASE;
+		rte_pktmbuf_free(ev[i].mbuf);
+	}
+	rte_event_enqueue_burst(evdev, t->port[0], ev, deq);
+	rte_service_run_iter_on_app_lcore(service_id, 1);
+out:
+	cleanup(t);
+restore:
+	evdev = saved_evdev;
+	return ret;
+}
+
 static int
 worker_loopback_worker_fn(void *arg)
 {
@@ -3521,6 +4186,30 @@ test_sw_eventdev(void)
 		printf("ERROR - Ordered & Atomic hist-list test FAILED.\n");
 		goto test_fail;
 	}
+	printf("*** Running Sharded forward test...\n");
+	ret = sharded_forward(t);
+	if (ret != 0) {
+		printf("ERROR - Sharded forward test FAILED.\n");
+		goto test_fail;
+	}
+	printf("*** Running Pipeline forward test...\n");
+	ret = pipeline_forward(t);
+	if (ret != 0) {
+		printf("ERROR - Pipeline forward test FAILED.\n");
+		goto test_fail;
+	}
+	printf("*** Running Pipeline ports test...\n");
+	ret = pipeline_ports(t);
+	if (ret != 0) {
+		printf("ERROR - Pipeline ports test FAILED.\n");
+		goto test_fail;
+	}
+	printf("*** Running Residency histogram test...\n");
+	ret = residency_hist(t);
+	if (ret != 0) {
+		printf("ERROR - Residency histogram test FAILED.\n");
+		goto test_fail;
+	}
 	if (rte_lcore_count() >= 3) {
 		printf("*** Running Worker loopback test...\n");
 		ret = worker_loopback(t, 0);
@@ -4,14 +4,32 @@
 
 #include <rte_atomic.h>
 #include <rte_cycles.h>
+#include <rte_errno.h>
 #include <rte_event_ring.h>
+#include <rte_mbuf_dyn.h>
 
 #include "sw_evdev.h"
 
 #define PORT_ENQUEUE_MAX_BURST_SIZE 64
+#define DEQ_SHARD_MASK (SW_INFLIGHT_EVENTS_TOTAL - 1)
+#define PIPELINE_RING_MASK (SW_PIPELINE_RING_SIZE - 1)
+
+/* Sharded scheduling: the shard the oldest outstanding event came from */
+static __rte_always_inline uint8_t
+sw_event_deq_shard_pop(struct sw_port *p)
+{
+	return p->deq_shard[p->deq_shard_tail++ & DEQ_SHARD_MASK];
+}
+
+/* Same as sw_event_deq_shard_pop() for the n-th oldest outstanding event */
+static __rte_always_inline uint8_t
+sw_event_deq_shard_peek(const struct sw_port *p, uint16_t n)
+{
+	return p->deq_shard[(uint16_t)(p->deq_shard_tail + n) & DEQ_SHARD_MASK];
+}
 
 static inline void
-sw_event_release(struct sw_port *p, uint8_t index)
+sw_event_release(struct sw_port *p, uint8_t index, const int sharded)
 {
 	/*
 	 * Drops the next outstanding event in our history. Used on dequeue
@@ -24,7 +42,16 @@ sw_event_release(struct sw_port *p, uint8_t index)
 	ev.op = sw_qe_flag_map[RTE_EVENT_OP_RELEASE];
 
 	uint16_t free_count;
-	rte_event_ring_enqueue_burst(p->rx_worker_ring, &ev, 1, &free_count);
+	if (unlikely(p->pipeline != NULL)) {
+		/* no later stage processes the event */
+		p->pipeline->ring[p->pl_slot[p->pl_next_slot++]].impl_opaque =
+				SW_PIPELINE_SLOT_DONE;
+	} else {
+		struct rte_event_ring *ring = sharded ?
+			p->shard_rx_ring[sw_event_deq_shard_pop(p)] :
+			p->rx_worker_ring;
+		rte_event_ring_enqueue_burst(ring, &ev, 1, &free_count);
+	}
 
 	/* each release returns one credit */
 	p->outstanding_releases--;
@@ -49,20 +76,372 @@ enqueue_burst_with_ops(struct rte_event_ring *r, const struct rte_event *events,
 	return rte_event_ring_enqueue_burst(r, tmp_evs, n, NULL);
 }
 
-uint16_t
-sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
+/*
+ * Sharded scheduling: enqueue the events to the rings of the port in the
+ * shards given by the shards array, stopping at the first full ring so that
+ * the enqueued events are the first ones of the burst.
+ */
+static inline unsigned int
+enqueue_burst_sharded(struct sw_port *p, const struct rte_event *events,
+		unsigned int n, uint8_t *ops, const uint8_t *shards)
+{
+	struct rte_event tmp_evs[PORT_ENQUEUE_MAX_BURST_SIZE];
+	unsigned int i, start = 0;
+
+	memcpy(tmp_evs, events, n * sizeof(events[0]));
+	for (i = 0; i < n; i++)
+		tmp_evs[i].op = ops[i];
+
+	/* one ring enqueue per run of events going to the same shard */
+	for (i = 1; i <= n; i++) {
+		unsigned int enq;
+
+		if (i < n && shards[i] == shards[start])
+			continue;
+
+		enq = rte_event_ring_enqueue_burst(
+				p->shard_rx_ring[shards[start]],
+				&tmp_evs[start], i - start, NULL);
+		if (enq != i - start)
+			return start + enq;
+
+		start = i;
+	}
+
+	return n;
+}
+
+/*
+ * Pipeline stage ports: release the range of the pipeline ring claimed by
+ * the port, once all its events have been forwarded or released. The ranges
+ * are released in the order they were claimed by the ports of the stage, so
+ * this fails until the ports which claimed the earlier ranges released them.
+ */
+static inline int
+sw_pipeline_claim_release(struct sw_port *p)
+{
+	struct sw_pipeline_stage *st = &p->pipeline->stages[p->pl_stage];
+
+	if (p->pl_next_slot != p->pl_nb_slots)
+		return 0;
+
+	if (p->pl_claim_count != 0) {
+		if (rte_atomic_load_explicit(&st->tail,
+				rte_memory_order_acquire) != p->pl_claim_start)
+			return 0;
+
+		/* makes the slots updated in place visible to the next stage */
+		rte_atomic_store_explicit(&st->tail,
+				p->pl_claim_start + p->pl_claim_count,
+				rte_memory_order_release);
+		p->pl_claim_count = 0;
+	}
+
+	return 1;
+}
+
+/*
+ * The events of the pipeline stages after the first one can only be
+ * forwarded in the pipeline ring by the ports of the previous stage, they
+ * cannot go through the scheduler.
+ */
+static __rte_always_inline int
+sw_pipeline_qid_invalid(const struct sw_evdev *sw, const struct rte_event *ev)
+{
+	return ev->op != RTE_EVENT_OP_RELEASE && ev->queue_id < sw->qid_count &&
+			sw->qids[ev->queue_id].pipeline_stage != 0;
+}
+
+/* Check if an event completing a pipeline event stays in the pipeline ring */
+static __rte_always_inline int
+sw_pipeline_to_next_stage(const struct sw_port *p, const struct rte_event *ev)
+{
+	const struct sw_pipeline *pl = p->pipeline;
+	const uint32_t next = p->pl_stage + 1;
+
+	return ev->op == RTE_EVENT_OP_FORWARD && next < pl->nb_stages &&
+			ev->queue_id == pl->first_qid + next;
+}
+
+/*
+ * Pipeline stage ports: the events forwarded to the next stage are updated
+ * in their slot of the pipeline ring, the other completions mark the slot
+ * as done. Only the events leaving the pipeline and the new events go
+ * through the scheduler, as new events on the port ring.
+ */
+static uint16_t
+sw_pipeline_enqueue_burst(struct sw_port *p, const struct rte_event ev[],
+		uint16_t num)
+{
+	struct rte_event sched_evs[PORT_ENQUEUE_MAX_BURST_SIZE];
+	struct sw_evdev *sw = p->sw;
+	struct sw_pipeline *pl = p->pipeline;
+	uint32_t credit_update_quanta = sw->credit_update_quanta;
+	uint32_t free_count, nb_sched = 0;
+	uint16_t i;
+
+	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
+		num = PORT_ENQUEUE_MAX_BURST_SIZE;
+
+	/* the port is the only producer of its ring */
+	free_count = rte_event_ring_free_count(p->rx_worker_ring);
+
+	for (i = 0; i < num; i++) {
+		const struct rte_event *e = &ev[i];
+		const int outstanding = p->outstanding_releases > 0;
+		int to_sched;
+
+		if (e->op == RTE_EVENT_OP_RELEASE)
+			to_sched = 0;
+		else if (outstanding && sw_pipeline_to_next_stage(p, e))
+			to_sched = 0;
+		else
+			to_sched = 1;
+
+		if (unlikely(to_sched && sw_pipeline_qid_invalid(sw, e))) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		if (to_sched && nb_sched == free_count)
+			break;
+
+		if (e->op == RTE_EVENT_OP_NEW) {
+			if (p->inflight_credits == 0) {
+				uint32_t sw_inflights =
+					rte_atomic32_read(&sw->inflights);
+
+				if (p->inflight_max < sw_inflights ||
+						sw_inflights + credit_update_quanta >
+						sw->nb_events_limit)
+					break;
+
+				rte_atomic32_add(&sw->inflights,
+						credit_update_quanta);
+				p->inflight_credits += credit_update_quanta;
+			}
+			p->inflight_credits--;
+		} else if (outstanding) {
+			struct rte_event *slot =
+				&pl->ring[p->pl_slot[p->pl_next_slot++]];
+
+			p->outstanding_releases--;
+			if (to_sched || e->op == RTE_EVENT_OP_RELEASE) {
+				slot->impl_opaque = SW_PIPELINE_SLOT_DONE;
+				p->inflight_credits +=
+					(e->op == RTE_EVENT_OP_RELEASE);
+			} else {
+				/* hand the event over to the next stage */
+				*slot = *e;
+				slot->impl_opaque = p->pl_stage + 1;
+			}
+		}
+
+		if (!to_sched)
+			continue;
+
+		/* error case: branch to avoid touching p->stats */
+		if (unlikely(e->queue_id >= sw->qid_count)) {
+			p->stats.rx_dropped++;
+			p->inflight_credits++;
+			continue;
+		}
+
+		sched_evs[nb_sched] = *e;
+		sched_evs[nb_sched++].op = QE_FLAG_VALID;
+	}
+
+	if (nb_sched)
+		rte_event_ring_enqueue_burst(p->rx_worker_ring, sched_evs,
+				nb_sched, NULL);
+
+	if (p->outstanding_releases == 0) {
+		sw_pipeline_claim_release(p);
+
+		if (p->last_dequeue_burst_sz != 0) {
+			uint64_t burst_ticks = rte_get_timer_cycles() -
+					p->last_dequeue_ticks;
+			uint64_t burst_pkt_ticks =
+				burst_ticks / p->last_dequeue_burst_sz;
+			p->avg_pkt_ticks -= p->avg_pkt_ticks / NUM_SAMPLES;
+			p->avg_pkt_ticks += burst_pkt_ticks / NUM_SAMPLES;
+			p->last_dequeue_ticks = 0;
+		}
+	}
+
+	/* Replenish credits if enough releases are performed */
+	if (p->inflight_credits >= credit_update_quanta * 2) {
+		rte_atomic32_sub(&sw->inflights, credit_update_quanta);
+		p->inflight_credits -= credit_update_quanta;
+	}
+
+	return i;
+}
+
+/*
+ * Pipeline stage ports: claim a range of the slots released by the previous
+ * stage, and dequeue the events of the range which are for this stage. The
+ * range is released once all these events are forwarded or released, so
+ * nothing is dequeued until then.
+ */
+static uint16_t
+sw_pipeline_dequeue_burst(struct sw_port *p, struct rte_event *ev,
+		uint16_t num)
+{
+	struct sw_pipeline *pl = p->pipeline;
+	struct sw_pipeline_stage *st = &pl->stages[p->pl_stage];
+	RTE_ATOMIC(uint32_t) *prev_tail = p->pl_stage == 0 ? &pl->prod_tail :
+			&pl->stages[p->pl_stage - 1].tail;
+	uint32_t head, n, i;
+	uint16_t ndeq = 0;
+
+	if (!sw_pipeline_claim_release(p))
+		return 0;
+
+	if (num > MAX_SW_CONS_Q_DEPTH)
+		num = MAX_SW_CONS_Q_DEPTH;
+
+	head = rte_atomic_load_explicit(&st->head, rte_memory_order_relaxed);
+	do {
+		int32_t avail = rte_atomic_load_explicit(prev_tail,
+				rte_memory_order_acquire) - head;
+
+		if (avail <= 0)
+			return 0;
+		n = RTE_MIN((uint32_t)avail, num);
+	} while (!rte_atomic_compare_exchange_weak_explicit(&st->head, &head,
+			head + n, rte_memory_order_relaxed,
+			rte_memory_order_relaxed));
+
+	for (i = 0; i < n; i++) {
+		const uint32_t slot = (head + i) & PIPELINE_RING_MASK;
+
+		/* skip the events released or forwarded out of the pipeline
+		 * by a previous stage
+		 */
+		if (pl->ring[slot].impl_opaque != p->pl_stage)
+			continue;
+
+		ev[ndeq] = pl->ring[slot];
+		p->pl_slot[ndeq++] = slot;
+	}
+
+	p->pl_claim_start = head;
+	p->pl_claim_count = n;
+	p->pl_nb_slots = ndeq;
+	p->pl_next_slot = 0;
+
+	/* nothing for this stage, pass the range on */
+	if (ndeq == 0)
+		sw_pipeline_claim_release(p);
+
+	return ndeq;
+}
+
+/* Residency latency: only the events carrying an mbuf are timestamped */
+static __rte_always_inline int
+sw_event_has_mbuf(const struct rte_event *ev)
+{
+	return ev->event_type == RTE_EVENT_TYPE_ETHDEV ||
+		ev->event_type == RTE_EVENT_TYPE_ETH_RX_ADAPTER;
+}
+
+static __rte_always_inline int
+sw_event_lat_stamped(const struct rte_event *ev)
+{
+	return ev->op != RTE_EVENT_OP_RELEASE && sw_event_has_mbuf(ev) &&
+			ev->mbuf != NULL;
+}
+
+/* the previous timestamps are saved, to revert those of the events the
+ * port doesn't accept
+ */
+static inline void
+sw_event_lat_stamp(const struct sw_evdev *sw, const struct rte_event ev[],
+		uint16_t num, uint64_t prev_ts[])
+{
+	uint64_t now = rte_get_timer_cycles();
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+		uint64_t *ts;
+
+		if (!sw_event_lat_stamped(&ev[i]))
+			continue;
+
+		ts = RTE_MBUF_DYNFIELD(ev[i].mbuf, sw->lat_ts_offset,
+				uint64_t *);
+		prev_ts[i] = *ts;
+		*ts = now;
+	}
+}
+
+static inline void
+sw_event_lat_unstamp(const struct sw_evdev *sw, const struct rte_event ev[],
+		uint16_t first, uint16_t num, const uint64_t prev_ts[])
+{
+	uint16_t i;
+
+	for (i = first; i < num; i++)
+		if (sw_event_lat_stamped(&ev[i]))
+			*RTE_MBUF_DYNFIELD(ev[i].mbuf, sw->lat_ts_offset,
+					uint64_t *) = prev_ts[i];
+}
+
+static inline void
+sw_event_lat_record(struct sw_port *p, const struct rte_event *ev,
+		uint16_t num)
+{
+	const struct sw_evdev *sw = p->sw;
+	uint64_t now = rte_get_timer_cycles();
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+		uint64_t ts;
+		uint32_t bucket;
+
+		if (!sw_event_has_mbuf(&ev[i]) || ev[i].mbuf == NULL)
+			continue;
+
+		ts = *RTE_MBUF_DYNFIELD(ev[i].mbuf, sw->lat_ts_offset,
+				uint64_t *);
+		bucket = RTE_MIN(rte_fls_u64(now - ts),
+				(uint32_t)SW_LAT_HIST_BUCKETS - 1);
+		p->lat_hist[ev[i].queue_id * SW_LAT_HIST_BUCKETS + bucket]++;
+	}
+}
+
+static __rte_always_inline uint16_t
+__sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num,
+		const int sharded)
 {
 	int32_t i;
 	uint8_t new_ops[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t shards[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t completes[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint16_t nb_completes = 0;
 	struct sw_port *p = port;
 	struct sw_evdev *sw = (void *)p->sw;
 	uint32_t sw_inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credit_update_quanta = sw->credit_update_quanta;
 	int new = 0;
 
+	if (unlikely(p->pipeline != NULL))
+		return sw_pipeline_enqueue_burst(p, ev, num);
+
 	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
 		num = PORT_ENQUEUE_MAX_BURST_SIZE;
 
+	if (unlikely(sw->nb_pipelines != 0)) {
+		for (i = 0; i < num; i++) {
+			if (unlikely(sw_pipeline_qid_invalid(sw, &ev[i]))) {
+				rte_errno = EINVAL;
+				num = i;
+				break;
+			}
+		}
+	}
+
 	for (i = 0; i < num; i++)
 		new += (ev[i].op == RTE_EVENT_OP_NEW);
 
@@ -99,9 +478,24 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		 * correct usage of the API), providing very high correct
 		 * prediction rate.
 		 */
-		if ((new_ops[i] & QE_FLAG_COMPLETE) && outstanding)
+		if ((new_ops[i] & QE_FLAG_COMPLETE) && outstanding) {
 			p->outstanding_releases--;
 
+			/* completions go back to the shard which scheduled
+			 * the event, which forwards the new event if needed;
+			 * the shard is consumed once the event is enqueued
+			 */
+			if (sharded) {
+				shards[i] = sw_event_deq_shard_peek(p,
+						nb_completes++);
+				completes[i] = 1;
+			}
+		} else if (sharded) {
+			shards[i] = invalid_qid ? 0 :
+					sw->qids[ev[i].queue_id].shard;
+			completes[i] = 0;
+		}
+
 		/* error case: branch to avoid touching p->stats */
 		if (unlikely(invalid_qid && op != RTE_EVENT_OP_RELEASE)) {
 			p->stats.rx_dropped++;
@@ -110,8 +504,32 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 	}
 
 	/* returns number of events actually enqueued */
-	uint32_t enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
-					     new_ops);
+	uint32_t enq = sharded ?
+		enqueue_burst_sharded(p, ev, i, new_ops, shards) :
+		enqueue_burst_with_ops(p->rx_worker_ring, ev, i, new_ops);
+
+	/* sharded: the events not enqueued, to be enqueued again by the
+	 * application, stay outstanding and keep their dequeue shard
+	 */
+	if (sharded) {
+		for (i = enq; i < num; i++) {
+			int op = ev[i].op;
+
+			p->inflight_credits += (op == RTE_EVENT_OP_NEW);
+			p->inflight_credits -= (op == RTE_EVENT_OP_RELEASE) *
+						completes[i];
+			p->outstanding_releases += completes[i];
+			nb_completes -= completes[i];
+
+			if (unlikely(ev[i].queue_id >= sw->qid_count &&
+					op != RTE_EVENT_OP_RELEASE)) {
+				p->stats.rx_dropped--;
+				p->inflight_credits--;
+			}
+		}
+
+		p->deq_shard_tail += nb_completes;
+	}
 	if (p->outstanding_releases == 0 && p->last_dequeue_burst_sz != 0) {
 		uint64_t burst_ticks = rte_get_timer_cycles() -
 				p->last_dequeue_ticks;
@@ -131,11 +549,86 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 	return enq;
 }
 
+/*
+ * Residency latency: the events are stamped before the scheduler can see
+ * them, the stamps of the events the port doesn't accept are reverted.
+ */
+static __rte_always_inline uint16_t
+sw_event_enqueue_burst_lat(void *port, const struct rte_event ev[],
+		uint16_t num, const int sharded)
+{
+	struct sw_port *p = port;
+	uint64_t prev_ts[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint16_t enq;
+
+	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
+		num = PORT_ENQUEUE_MAX_BURST_SIZE;
+
+	sw_event_lat_stamp(p->sw, ev, num, prev_ts);
+	enq = __sw_event_enqueue_burst(port, ev, num, sharded);
+	sw_event_lat_unstamp(p->sw, ev, enq, num, prev_ts);
+
+	return enq;
+}
+
 uint16_t
-sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
-		uint64_t wait)
+sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
+{
+	struct sw_port *p = port;
+
+	if (unlikely(p->sw->latency))
+		return sw_event_enqueue_burst_lat(port, ev, num, 0);
+	return __sw_event_enqueue_burst(port, ev, num, 0);
+}
+
+uint16_t
+sw_event_enqueue_burst_sharded(void *port, const struct rte_event ev[],
+		uint16_t num)
+{
+	struct sw_port *p = port;
+
+	if (unlikely(p->sw->latency))
+		return sw_event_enqueue_burst_lat(port, ev, num, 1);
+	return __sw_event_enqueue_burst(port, ev, num, 1);
+}
+
+/*
+ * Sharded scheduling: dequeue from the rings of the port in each shard,
+ * starting with a different shard on each call, and record the shard of
+ * each dequeued event.
+ */
+static inline uint16_t
+dequeue_burst_sharded(struct sw_port *p, struct rte_event *ev, uint16_t num)
+{
+	const uint32_t nb_shards = p->sw->nb_shards;
+	uint32_t shard = p->deq_shard_next;
+	uint16_t ndeq = 0;
+	uint32_t i;
+
+	for (i = 0; i < nb_shards && ndeq < num; i++) {
+		uint16_t n, j;
+
+		n = rte_event_ring_dequeue_burst(p->shard_cq_ring[shard],
+				&ev[ndeq], num - ndeq, NULL);
+		for (j = 0; j < n; j++)
+			p->deq_shard[p->deq_shard_head++ & DEQ_SHARD_MASK] =
+					shard;
+		ndeq += n;
+
+		if (++shard == nb_shards)
+			shard = 0;
+	}
+
+	if (++p->deq_shard_next == nb_shards)
+		p->deq_shard_next = 0;
+
+	return ndeq;
+}
+
+static __rte_always_inline uint16_t
+__sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
+		const int sharded)
 {
-	RTE_SET_USED(wait);
 	struct sw_port *p = (void *)port;
 	struct rte_event_ring *ring = p->cq_worker_ring;
 
@@ -146,7 +639,7 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 		uint16_t out_rels = p->outstanding_releases;
 		uint16_t i;
 		for (i = 0; i < out_rels; i++)
-			sw_event_release(p, i);
+			sw_event_release(p, i, sharded);
 
 		/* Replenish credits if enough releases are performed */
 		if (p->inflight_credits >= credit_update_quanta * 2) {
@@ -156,7 +649,13 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 	}
 
 	/* returns number of events actually dequeued */
-	uint16_t ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	uint16_t ndeq;
+	if (unlikely(p->pipeline != NULL))
+		ndeq = sw_pipeline_dequeue_burst(p, ev, num);
+	else if (sharded)
+		ndeq = dequeue_burst_sharded(p, ev, num);
+	else
+		ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
 	if (unlikely(ndeq == 0)) {
 		p->zero_polls++;
 		p->total_polls++;
@@ -169,6 +668,25 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 	p->poll_buckets[(ndeq - 1) >> SW_DEQ_STAT_BUCKET_SHIFT]++;
 	p->total_polls++;
 
+	if (unlikely(p->lat_hist != NULL))
+		sw_event_lat_record(p, ev, ndeq);
+
 end:
 	return ndeq;
 }
+
+uint16_t
+sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
+		uint64_t wait)
+{
+	RTE_SET_USED(wait);
+	return __sw_event_dequeue_burst(port, ev, num, 0);
+}
+
+uint16_t
+sw_event_dequeue_burst_sharded(void *port, struct rte_event *ev, uint16_t num,
+		uint64_t wait)
+{
+	RTE_SET_USED(wait);
+	return __sw_event_dequeue_burst(port, ev, num, 1);
+}
@@ -31,6 +31,8 @@ enum xstats_type {
 	/* qid port mapping specific */
 	pinned,
 	pkts, /* note: qid-to-port pkts */
+	/* residency latency histogram, port or qid */
+	residency,
 };
 
 typedef uint64_t (*xstats_fn)(const struct sw_evdev *dev,
@@ -48,20 +50,55 @@ struct sw_xstats_entry {
 	uint64_t reset_value; /* an offset to be taken away to emulate resets */
 };
 
+static uint64_t
+get_shard_stat(const struct sw_shard *sh, enum xstats_type type)
+{
+	switch (type) {
+	case rx: return sh->stats.rx_pkts;
+	case tx: return sh->stats.tx_pkts;
+	case dropped: return sh->stats.rx_dropped;
+	case calls: return sh->sched_called;
+	case no_iq_enq: return sh->sched_no_iq_enqueues;
+	case no_cq_enq: return sh->sched_no_cq_enqueues;
+	case sched_last_iter_bitmask: return sh->sched_last_iter_bitmask;
+	case sched_progress_last_iter: return sh->sched_progress_last_iter;
+
+	default: return -1;
+	}
+}
+
 static uint64_t
 get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
 		enum xstats_type type, int extra_arg __rte_unused)
 {
-	switch (type) {
-	case rx: return sw->stats.rx_pkts;
-	case tx: return sw->stats.tx_pkts;
-	case dropped: return sw->stats.rx_dropped;
-	case calls: return sw->sched_called;
-	case no_iq_enq: return sw->sched_no_iq_enqueues;
-	case no_cq_enq: return sw->sched_no_cq_enqueues;
-	case sched_last_iter_bitmask: return sw->sched_last_iter_bitmask;
-	case sched_progress_last_iter: return sw->sched_progress_last_iter;
+	uint64_t val = 0;
+	uint32_t i;
+
+	/* the scheduler stats are kept per shard */
+	for (i = 0; i < sw->nb_shards; i++) {
+		uint64_t shard_val = get_shard_stat(&sw->shards[i], type);
+
+		if (type == sched_last_iter_bitmask ||
+				type == sched_progress_last_iter)
+			val |= shard_val;
+		else
+			val += shard_val;
+	}
+
+	return val;
+}
 
+static uint64_t
+get_port_shard_stat(const struct sw_port *p, enum xstats_type type)
+{
+	switch (type) {
+	case rx: return p->stats.rx_pkts;
+	case tx: return p->stats.tx_pkts;
+	case inflight: return p->inflights;
+	case rx_used: return rte_event_ring_count(p->rx_worker_ring);
+	case rx_free: return rte_event_ring_free_count(p->rx_worker_ring);
+	case tx_used: return rte_event_ring_count(p->cq_worker_ring);
+	case tx_free: return rte_event_ring_free_count(p->cq_worker_ring);
 	default: return -1;
 	}
 }
@@ -71,20 +108,27 @@ get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 		enum xstats_type type, int extra_arg __rte_unused)
 {
 	const struct sw_port *p = &sw->ports[obj_idx];
+	uint64_t val = 0;
+	uint32_t i;
 
 	switch (type) {
-	case rx: return p->stats.rx_pkts;
-	case tx: return p->stats.tx_pkts;
+	case rx:
+	case tx:
+	case inflight:
+	case rx_used:
+	case rx_free:
+	case tx_used:
+	case tx_free:
+		/* scheduler side, kept in the port view of each shard */
+		for (i = 0; i < sw->nb_shards; i++)
+			val += get_port_shard_stat(
+					sw_shard_port(sw, i, obj_idx), type);
+		return val;
 	case dropped: return p->stats.rx_dropped;
-	case inflight: return p->inflights;
 	case pkt_cycles: return p->avg_pkt_ticks;
 	case calls: return p->total_polls;
 	case credits: return p->inflight_credits;
 	case poll_return: return p->zero_polls;
-	case rx_used: return rte_event_ring_count(p->rx_worker_ring);
-	case rx_free: return rte_event_ring_free_count(p->rx_worker_ring);
-	case tx_used: return rte_event_ring_count(p->cq_worker_ring);
-	case tx_free: return rte_event_ring_free_count(p->cq_worker_ring);
 	default: return -1;
 	}
 }
@@ -101,6 +145,24 @@ get_port_bucket_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 	}
 }
 
+/* residency of the events dequeued by the port, from all the QIDs */
+static uint64_t
+get_port_residency_stat(const struct sw_evdev *sw, uint16_t obj_idx,
+		enum xstats_type type, int extra_arg)
+{
+	const struct sw_port *p = &sw->ports[obj_idx];
+	uint64_t val = 0;
+	uint32_t qid;
+
+	if (type != residency)
+		return -1;
+
+	for (qid = 0; qid < sw->qid_count; qid++)
+		val += p->lat_hist[qid * SW_LAT_HIST_BUCKETS + extra_arg];
+
+	return val;
+}
+
 static uint64_t
 get_qid_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 		enum xstats_type type, int extra_arg __rte_unused)
@@ -137,6 +199,24 @@ get_qid_iq_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 	}
 }
 
+/* residency of the events of the QID, dequeued by all the ports */
+static uint64_t
+get_qid_residency_stat(const struct sw_evdev *sw, uint16_t obj_idx,
+		enum xstats_type type, int extra_arg)
+{
+	uint64_t val = 0;
+	uint32_t port;
+
+	if (type != residency)
+		return -1;
+
+	for (port = 0; port < sw->port_count; port++)
+		val += sw->ports[port].lat_hist[obj_idx * SW_LAT_HIST_BUCKETS +
+				extra_arg];
+
+	return val;
+}
+
 static uint64_t
 get_qid_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 		enum xstats_type type, int extra_arg)
@@ -174,6 +254,7 @@ sw_xstats_init(struct sw_evdev *sw)
 	 *   - per-qid,
 	 *   - per-iq
 	 *   - per-port-per-qid
+	 *   - per-port and per-qid residency buckets, when enabled
 	 *
 	 * For each of these sets, we have three parallel arrays, one for the
 	 * names, the other for the stat type parameter to be passed in the fn
@@ -251,6 +332,7 @@ sw_xstats_init(struct sw_evdev *sw)
 	/* other vars */
 	const uint32_t cons_bkt_shift =
 		(MAX_SW_CONS_Q_DEPTH >> SW_DEQ_STAT_BUCKET_SHIFT);
+	const uint32_t lat_bkts = sw->latency ? SW_LAT_HIST_BUCKETS : 0;
 	const unsigned int count = RTE_DIM(dev_stats) +
 			sw->port_count * RTE_DIM(port_stats) +
 			sw->port_count * RTE_DIM(port_bucket_stats) *
@@ -258,7 +340,8 @@ sw_xstats_init(struct sw_evdev *sw)
 			sw->qid_count * RTE_DIM(qid_stats) +
 			sw->qid_count * SW_IQS_MAX * RTE_DIM(qid_iq_stats) +
 			sw->qid_count * sw->port_count *
-				RTE_DIM(qid_port_stats);
+				RTE_DIM(qid_port_stats) +
+			(sw->port_count + sw->qid_count) * lat_bkts;
 	unsigned int i, port, qid, iq, bkt, stat = 0;
 
 	sw->xstats = rte_zmalloc_socket(NULL, sizeof(sw->xstats[0]) * count, 0,
@@ -316,6 +399,20 @@ sw_xstats_init(struct sw_evdev *sw)
 			}
 		}
 
+		for (bkt = 0; bkt < lat_bkts; bkt++, stat++) {
+			sw->xstats[stat] = (struct sw_xstats_entry){
+				.fn = get_port_residency_stat,
+				.obj_idx = port,
+				.stat = residency,
+				.mode = RTE_EVENT_DEV_XSTATS_PORT,
+				.extra_arg = bkt,
+				.reset_allowed = 1,
+			};
+			snprintf(sname, sizeof(sname),
+					"port_%u_residency_hist_%u",
+					port, bkt);
+		}
+
 		sw->xstats_count_per_port[port] = stat - count_offset;
 	}
 
@@ -369,6 +466,20 @@ sw_xstats_init(struct sw_evdev *sw)
 						qid_port_stats[i]);
 			}
 
+		for (bkt = 0; bkt < lat_bkts; bkt++, stat++) {
+			sw->xstats[stat] = (struct sw_xstats_entry){
+				.fn = get_qid_residency_stat,
+				.obj_idx = qid,
+				.stat = residency,
+				.mode = RTE_EVENT_DEV_XSTATS_QUEUE,
+				.extra_arg = bkt,
+				.reset_allowed = 1,
+			};
+			snprintf(sname, sizeof(sname),
+					"qid_%u_residency_hist_%u",
+					qid, bkt);
+		}
+
 		sw->xstats_count_per_qid[qid] = stat - count_offset;
 	}
 
@@ -7,6 +7,7 @@
 
 #include <rte_branch_prediction.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_lcore.h>
 #include <rte_random.h>
 #include <rte_service_component.h>
@@ -17,6 +18,8 @@
 
 #define EVD_MAX_PORTS_PER_LCORE 4
 #define EVD_MAX_HANDLERS 32
+#define EVD_NO_HANDLER UINT8_MAX
+#define EVD_NUM_QUEUE_IDS (UINT8_MAX + 1)
 #define EVD_MAX_FINALIZERS 16
 #define EVD_AVG_PRIO_INTERVAL 2000
 #define EVD_SERVICE_NAME "dispatcher"
@@ -29,6 +32,8 @@ struct rte_dispatcher_lcore_port {
 
 struct rte_dispatcher_handler {
 	int id;
+	/* Event queue id of a queue handler, -1 for a match handler */
+	int16_t queue_id;
 	rte_dispatcher_match_t match_fun;
 	void *match_data;
 	rte_dispatcher_process_t process_fun;
@@ -48,6 +53,8 @@ struct __rte_cache_aligned rte_dispatcher_lcore {
 	struct rte_dispatcher_lcore_port ports[EVD_MAX_PORTS_PER_LCORE];
 	struct rte_dispatcher_handler handlers[EVD_MAX_HANDLERS];
 	struct rte_dispatcher_stats stats;
+	/* Indexed by handler id */
+	struct rte_dispatcher_handler_stats handler_stats[EVD_MAX_HANDLERS];
 	RTE_CACHE_GUARD;
 };
 
@@ -58,6 +65,8 @@ struct rte_dispatcher {
 	struct rte_dispatcher_lcore lcores[RTE_MAX_LCORE];
 	uint16_t num_finalizers;
 	struct rte_dispatcher_finalizer finalizers[EVD_MAX_FINALIZERS];
+	/* Queue handler id per event queue id, or EVD_NO_HANDLER */
+	uint8_t queue_handlers[EVD_NUM_QUEUE_IDS];
 };
 
 static int
@@ -70,6 +79,10 @@ evd_lookup_handler_idx(struct rte_dispatcher_lcore *lcore,
 		struct rte_dispatcher_handler *handler =
 			&lcore->handlers[i];
 
+		/* Queue handlers are found by the queue id lookup */
+		if (handler->match_fun == NULL)
+			continue;
+
 		if (handler->match_fun(event, handler->match_data))
 			return i;
 	}
@@ -77,6 +90,24 @@ evd_lookup_handler_idx(struct rte_dispatcher_lcore *lcore,
 	return -1;
 }
 
+static __rte_always_inline uint8_t
+evd_lookup_handler_id(const struct rte_dispatcher *dispatcher,
+	struct rte_dispatcher_lcore *lcore, const struct rte_event *event)
+{
+	uint8_t handler_id = dispatcher->queue_handlers[event->queue_id];
+	int handler_idx;
+
+	if (handler_id != EVD_NO_HANDLER)
+		return handler_id;
+
+	handler_idx = evd_lookup_handler_idx(lcore, event);
+
+	if (unlikely(handler_idx < 0))
+		return EVD_NO_HANDLER;
+
+	return lcore->handlers[handler_idx].id;
+}
+
 static void
 evd_prioritize_handler(struct rte_dispatcher_lcore *lcore,
 	int handler_idx)
@@ -119,40 +150,86 @@ evd_dispatch_events(struct rte_dispatcher *dispatcher,
 	struct rte_event *events, uint16_t num_events)
 {
 	int i;
-	struct rte_event bursts[EVD_MAX_HANDLERS][num_events];
+	uint8_t handler_ids[num_events];
+	struct rte_event sorted[num_events];
+	struct rte_event *bursts = events;
 	uint16_t burst_lens[EVD_MAX_HANDLERS] = { 0 };
+	uint16_t burst_ends[EVD_MAX_HANDLERS];
 	uint16_t drop_count = 0;
 	uint16_t dispatch_count;
 	uint16_t dispatched = 0;
+	uint64_t prev_tsc;
 
 	for (i = 0; i < num_events; i++) {
-		struct rte_event *event = &events[i];
-		int handler_idx;
+		uint8_t handler_id;
 
-		handler_idx = evd_lookup_handler_idx(lcore, event);
+		handler_id = evd_lookup_handler_id(dispatcher, lcore,
+						   &events[i]);
+		handler_ids[i] = handler_id;
 
-		if (unlikely(handler_idx < 0)) {
+		if (unlikely(handler_id == EVD_NO_HANDLER)) {
 			drop_count++;
 			continue;
 		}
 
-		bursts[handler_idx][burst_lens[handler_idx]] = *event;
-		burst_lens[handler_idx]++;
+		burst_lens[handler_id]++;
 	}
 
 	dispatch_count = num_events - drop_count;
 
+	/*
+	 * Unless the whole batch goes to the same handler, sort the
+	 * events by handler, keeping the order of the events of a
+	 * handler.
+	 */
+	if (drop_count != 0 || burst_lens[handler_ids[0]] != num_events) {
+		uint16_t offset = 0;
+
+		for (i = 0; i < lcore->num_handlers; i++) {
+			int handler_id = lcore->handlers[i].id;
+
+			burst_ends[handler_id] = offset;
+			offset += burst_lens[handler_id];
+		}
+
+		for (i = 0; i < num_events; i++) {
+			uint8_t handler_id = handler_ids[i];
+
+			if (unlikely(handler_id == EVD_NO_HANDLER))
+				continue;
+
+			sorted[burst_ends[handler_id]++] = events[i];
+		}
+
+		bursts = sorted;
+	} else
+		burst_ends[handler_ids[0]] = num_events;
+
+	prev_tsc = rte_rdtsc();
+
 	for (i = 0; i < lcore->num_handlers &&
 		 dispatched < dispatch_count; i++) {
 		struct rte_dispatcher_handler *handler =
 			&lcore->handlers[i];
-		uint16_t len = burst_lens[i];
+		struct rte_dispatcher_handler_stats *handler_stats;
+		uint16_t len = burst_lens[handler->id];
+		uint64_t tsc;
 
 		if (len == 0)
 			continue;
 
 		handler->process_fun(dispatcher->event_dev_id, port->port_id,
-				     bursts[i], len, handler->process_data);
+				     &bursts[burst_ends[handler->id] - len],
+				     len, handler->process_data);
+
+		tsc = rte_rdtsc();
+
+		handler_stats = &lcore->handler_stats[handler->id];
+		handler_stats->ev_count += len;
+		handler_stats->process_count++;
+		handler_stats->process_cycles += tsc - prev_tsc;
+
+		prev_tsc = tsc;
 
 		dispatched += len;
 
@@ -290,6 +367,9 @@ rte_dispatcher_create(uint8_t event_dev_id)
 		.socket_id = socket_id
 	};
 
+	memset(dispatcher->queue_handlers, EVD_NO_HANDLER,
+	       sizeof(dispatcher->queue_handlers));
+
 	rc = evd_service_register(dispatcher);
 	if (rc < 0) {
 		rte_free(dispatcher);
@@ -436,6 +516,9 @@ evd_lcore_install_handler(struct rte_dispatcher_lcore *lcore,
 
 	lcore->handlers[handler_idx] = *handler;
 	lcore->num_handlers++;
+
+	lcore->handler_stats[handler->id] =
+		(struct rte_dispatcher_handler_stats) {};
 }
 
 static void
@@ -457,6 +540,7 @@ rte_dispatcher_register(struct rte_dispatcher *dispatcher,
 	rte_dispatcher_process_t process_fun, void *process_data)
 {
 	struct rte_dispatcher_handler handler = {
+		.queue_id = -1,
 		.match_fun = match_fun,
 		.match_data = match_data,
 		.process_fun = process_fun,
@@ -473,6 +557,32 @@ rte_dispatcher_register(struct rte_dispatcher *dispatcher,
 	return handler.id;
 }
 
+int
+rte_dispatcher_register_queue(struct rte_dispatcher *dispatcher,
+	uint8_t queue_id, rte_dispatcher_process_t process_fun,
+	void *process_data)
+{
+	struct rte_dispatcher_handler handler = {
+		.queue_id = queue_id,
+		.process_fun = process_fun,
+		.process_data = process_data
+	};
+
+	if (dispatcher->queue_handlers[queue_id] != EVD_NO_HANDLER)
+		return -EEXIST;
+
+	handler.id = evd_alloc_handler_id(dispatcher);
+
+	if (handler.id < 0)
+		return -ENOMEM;
+
+	evd_install_handler(dispatcher, &handler);
+
+	dispatcher->queue_handlers[queue_id] = handler.id;
+
+	return handler.id;
+}
+
 static int
 evd_lcore_uninstall_handler(struct rte_dispatcher_lcore *lcore,
 	int handler_id)
@@ -525,7 +635,23 @@ evd_uninstall_handler(struct rte_dispatcher *dispatcher, int handler_id)
 int
 rte_dispatcher_unregister(struct rte_dispatcher *dispatcher, int handler_id)
 {
-	return evd_uninstall_handler(dispatcher, handler_id);
+	struct rte_dispatcher_handler *handler;
+	int16_t queue_id = -1;
+	int rc;
+
+	handler = evd_lcore_get_handler_by_id(&dispatcher->lcores[0],
+					      handler_id);
+	if (handler != NULL)
+		queue_id = handler->queue_id;
+
+	rc = evd_uninstall_handler(dispatcher, handler_id);
+	if (rc < 0)
+		return rc;
+
+	if (queue_id >= 0)
+		dispatcher->queue_handlers[queue_id] = EVD_NO_HANDLER;
+
+	return 0;
 }
 
 static struct rte_dispatcher_finalizer *
@@ -691,5 +817,36 @@ rte_dispatcher_stats_reset(struct rte_dispatcher *dispatcher)
 			&dispatcher->lcores[lcore_id];
 
 		lcore->stats = (struct rte_dispatcher_stats) {};
+		memset(lcore->handler_stats, 0, sizeof(lcore->handler_stats));
 	}
 }
+
+int
+rte_dispatcher_handler_stats_get(const struct rte_dispatcher *dispatcher,
+	int handler_id, struct rte_dispatcher_handler_stats *stats)
+{
+	const struct rte_dispatcher_lcore *reference_lcore =
+		&dispatcher->lcores[0];
+	unsigned int lcore_id;
+	uint16_t i;
+
+	for (i = 0; i < reference_lcore->num_handlers; i++)
+		if (reference_lcore->handlers[i].id == handler_id)
+			break;
+
+	if (i == reference_lcore->num_handlers)
+		return -EINVAL;
+
+	*stats = (struct rte_dispatcher_handler_stats) {};
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct rte_dispatcher_handler_stats *part =
+			&dispatcher->lcores[lcore_id].handler_stats[handler_id];
+
+		stats->ev_count += part->ev_count;
+		stats->process_count += part->process_count;
+		stats->process_cycles += part->process_cycles;
+	}
+
+	return 0;
+}
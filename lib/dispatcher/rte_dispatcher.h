@@ -116,6 +116,18 @@ struct rte_dispatcher_stats {
 	uint64_t ev_drop_count;
 };
 
+/**
+ * Dispatcher per-handler statistics
+ */
+struct rte_dispatcher_handler_stats {
+	/** Number of events delivered to the handler. */
+	uint64_t ev_count;
+	/** Number of process callback invocations. */
+	uint64_t process_count;
+	/** TSC cycles spent in the process callback. */
+	uint64_t process_cycles;
+};
+
 /**
  * Create a dispatcher with the specified id.
  *
@@ -295,6 +307,49 @@ rte_dispatcher_register(struct rte_dispatcher *dispatcher,
 	rte_dispatcher_match_t match_fun, void *match_cb_data,
 	rte_dispatcher_process_t process_fun, void *process_cb_data);
 
+/**
+ * Register an event handler for an event queue.
+ *
+ * All events dequeued from the event queue @p queue_id are delivered
+ * to the handler, using its process callback function. The handler is
+ * found with a table lookup on the event queue id, without calling any
+ * match callback function. Events from @p queue_id are not presented
+ * to the match callbacks of the handlers registered with
+ * rte_dispatcher_register().
+ *
+ * Queue handlers share the handler identifier space and the maximum
+ * number of handlers with the match-based handlers, and are
+ * unregistered using rte_dispatcher_unregister().
+ *
+ * rte_dispatcher_register_queue() may be called by any thread
+ * (including unregistered non-EAL threads), but not while the event
+ * dispatcher is running on any service lcore.
+ *
+ * @param dispatcher
+ *  The dispatcher instance.
+ *
+ * @param queue_id
+ *  The event queue identifier.
+ *
+ * @param process_fun
+ *  The process callback function.
+ *
+ * @param process_cb_data
+ *  A pointer to some application-specific opaque data (or NULL),
+ *  which is supplied back to the application when process_fun is
+ *  called.
+ *
+ * @return
+ *  - >= 0: The identifier for this registration.
+ *  - -EEXIST: A handler is already registered for @p queue_id.
+ *  - -ENOMEM: Unable to allocate sufficient resources.
+ */
+__rte_experimental
+int
+rte_dispatcher_register_queue(struct rte_dispatcher *dispatcher,
+	uint8_t queue_id, rte_dispatcher_process_t process_fun,
+	void *process_cb_data);
+
 /**
  * Unregister an event handler.
  *
@@ -449,6 +504,34 @@ __rte_experimental
 void
 rte_dispatcher_stats_reset(struct rte_dispatcher *dispatcher);
 
+/**
+ * Retrieve statistics for an event handler.
+ *
+ * The handler statistics are reset when the handler is registered,
+ * and by rte_dispatcher_stats_reset().
+ *
+ * This function may be called by any thread (including unregistered
+ * non-EAL threads).
+ *
+ * @param dispatcher
+ *  The dispatcher instance.
+ *
+ * @param handler_id
+ *  The handler registration id returned by rte_dispatcher_register()
+ *  or rte_dispatcher_register_queue().
+ *
+ * @param[out] stats
+ *   A pointer to a structure to fill with statistics.
+ *
+ * @return
+ *  - 0: Success
+ *  - -EINVAL: The @c handler_id parameter was invalid.
+ */
+__rte_experimental
+int
+rte_dispatcher_handler_stats_get(const struct rte_dispatcher *dispatcher,
+	int handler_id, struct rte_dispatcher_handler_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -73,6 +73,7 @@ eal_long_options[] = {
 	{OPT_HUGE_UNLINK,       2, NULL, OPT_HUGE_UNLINK_NUM      },
 	{OPT_IOVA_MODE,	        1, NULL, OPT_IOVA_MODE_NUM        },
 	{OPT_LCORES,            1, NULL, OPT_LCORES_NUM           },
+	{OPT_LOG_ASYNC,         2, NULL, OPT_LOG_ASYNC_NUM        },
 	{OPT_LOG_COLOR,		2, NULL, OPT_LOG_COLOR_NUM	  },
 	{OPT_LOG_LEVEL,         1, NULL, OPT_LOG_LEVEL_NUM        },
 	{OPT_LOG_TIMESTAMP,     2, NULL, OPT_LOG_TIMESTAMP_NUM    },
@@ -1600,6 +1601,7 @@ bool
 eal_option_is_log(int opt)
 {
 	switch (opt) {
+	case OPT_LOG_ASYNC_NUM:
 	case OPT_LOG_COLOR_NUM:
 	case OPT_LOG_LEVEL_NUM:
 	case OPT_LOG_TIMESTAMP_NUM:
@@ -1879,6 +1881,16 @@ eal_parse_common_option(int opt, const char *optarg,
 		}
 		break;
 
+#ifndef RTE_EXEC_ENV_WINDOWS
+	case OPT_LOG_ASYNC_NUM:
+		if (eal_log_async(optarg) < 0) {
+			EAL_LOG(ERR, "invalid parameters for --"
+				OPT_LOG_ASYNC);
+			return -1;
+		}
+		break;
+#endif
+
 #ifndef RTE_EXEC_ENV_WINDOWS
 	case OPT_TRACE_NUM: {
 		if (eal_trace_args_save(optarg) < 0) {
@@ -2246,6 +2258,10 @@ eal_common_usage(void)
 	       "  --"OPT_LOG_LEVEL"=help    Show log types and levels\n"
 	       "  --"OPT_LOG_TIMESTAMP"[=<format>]  Timestamp log output\n"
 	       "  --"OPT_LOG_COLOR"[=<when>] Colorize log messages\n"
+#ifndef RTE_EXEC_ENV_WINDOWS
+	       "  --"OPT_LOG_ASYNC"[=<size>] Write log messages from a separate thread\n"
+	       "                      (and optionally set per-thread buffer size)\n"
+#endif
 #ifndef RTE_EXEC_ENV_WINDOWS
 	       "  --"OPT_TRACE"=<regex-match>\n"
 	       "                      Enable trace based on regular expression trace name.\n"
@@ -2263,11 +2279,12 @@ eal_common_usage(void)
 	       "                      'KBytes' and 'MBytes' respectively.\n"
 	       "                      Default is 1MB and parameter must be\n"
 	       "                      specified once only.\n"
-	       "  --"OPT_TRACE_MODE"=<o[verwrite] | d[iscard]>\n"
+	       "  --"OPT_TRACE_MODE"=<o[verwrite] | d[iscard] | s[tream]>\n"
 	       "                      Specify the mode of update of trace\n"
 	       "                      output file. Either update on a file can\n"
 	       "                      be wrapped or discarded when file size\n"
-	       "                      reaches its maximum limit.\n"
+	       "                      reaches its maximum limit, or the trace\n"
+	       "                      is continuously streamed to the file.\n"
 	       "                      Default mode is 'overwrite' and parameter\n"
 	       "                      must be specified once only.\n"
 #endif /* !RTE_EXEC_ENV_WINDOWS */
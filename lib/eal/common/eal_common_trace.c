@@ -2,6 +2,7 @@
  * Copyright(C) 2020 Marvell International Ltd.
  */
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <fnmatch.h>
 #include <pthread.h>
@@ -77,6 +78,10 @@ eal_trace_init(void)
 
 	rte_trace_mode_set(trace.mode);
 
+	/* Start draining the trace buffers in STREAM mode */
+	if (trace.mode == RTE_TRACE_MODE_STREAM && trace_stream_start() < 0)
+		goto free_meta;
+
 	return 0;
 
 free_meta:
@@ -89,6 +94,7 @@ eal_trace_init(void)
 void
 eal_trace_fini(void)
 {
+	trace_stream_stop();
 	trace_mem_free();
 	trace_metadata_destroy();
 	eal_trace_args_free();
@@ -104,11 +110,19 @@ static void
 trace_mode_set(rte_trace_point_t *t, enum rte_trace_mode mode)
 {
 	if (mode == RTE_TRACE_MODE_OVERWRITE)
-		rte_atomic_fetch_and_explicit(t, ~__RTE_TRACE_FIELD_ENABLE_DISCARD,
+		rte_atomic_fetch_and_explicit(t, ~(__RTE_TRACE_FIELD_ENABLE_DISCARD |
+			__RTE_TRACE_FIELD_ENABLE_STREAM), rte_memory_order_release);
+	else if (mode == RTE_TRACE_MODE_DISCARD) {
+		rte_atomic_fetch_and_explicit(t, ~__RTE_TRACE_FIELD_ENABLE_STREAM,
 			rte_memory_order_release);
-	else
 		rte_atomic_fetch_or_explicit(t, __RTE_TRACE_FIELD_ENABLE_DISCARD,
 			rte_memory_order_release);
+	} else {
+		rte_atomic_fetch_and_explicit(t, ~__RTE_TRACE_FIELD_ENABLE_DISCARD,
+			rte_memory_order_release);
+		rte_atomic_fetch_or_explicit(t, __RTE_TRACE_FIELD_ENABLE_STREAM,
+			rte_memory_order_release);
+	}
 }
 
 void
@@ -116,6 +130,13 @@ rte_trace_mode_set(enum rte_trace_mode mode)
 {
 	struct trace_point *tp;
 
+	/* The trace buffers layout differs in STREAM mode */
+	if ((mode == RTE_TRACE_MODE_STREAM) !=
+			(trace.mode == RTE_TRACE_MODE_STREAM)) {
+		trace_err("stream mode can only be set with --trace-mode");
+		return;
+	}
+
 	STAILQ_FOREACH(tp, &tp_list, next)
 		trace_mode_set(tp->handle, mode);
 
@@ -255,11 +276,39 @@ trace_point_dump(FILE *f, struct trace_point *tp)
 		rte_trace_point_is_enabled(handle) ? "enabled" : "disabled");
 }
 
+int
+rte_trace_stream_stats_get(struct rte_trace_stream_stats *stats)
+{
+	struct trace_stream *stream;
+	uint32_t count;
+
+	if (stats == NULL)
+		return -EINVAL;
+
+	if (trace.mode != RTE_TRACE_MODE_STREAM)
+		return -ENOTSUP;
+
+	rte_spinlock_lock(&trace.lock);
+	stats->bytes = trace.stream_bytes;
+	stats->drops = trace.stream_drops;
+	for (count = 0; count < trace.nb_trace_mem_list; count++) {
+		stream = trace_stream_get(trace.lcore_meta[count].mem,
+			trace.buff_len);
+		stats->bytes += stream->bytes;
+		stats->drops += rte_atomic_load_explicit(&stream->drops,
+			rte_memory_order_relaxed);
+	}
+	rte_spinlock_unlock(&trace.lock);
+
+	return 0;
+}
+
 static void
 trace_lcore_mem_dump(FILE *f)
 {
 	struct trace *trace = trace_obj_get();
 	struct __rte_trace_header *header;
+	struct trace_stream *stream;
 	uint32_t count;
 
 	rte_spinlock_lock(&trace->lock);
@@ -274,6 +323,12 @@ trace_lcore_mem_dump(FILE *f)
 		trace_area_to_string(trace->lcore_meta[count].area),
 		header->stream_header.lcore_id,
 		header->stream_header.thread_name);
+		if (trace->mode != RTE_TRACE_MODE_STREAM)
+			continue;
+		stream = trace_stream_get(header, trace->buff_len);
+		fprintf(f, "\t\tstream bytes=%" PRIu64 ", drops=%" PRIu64 "\n",
+		stream->bytes,
+		rte_atomic_load_explicit(&stream->drops, rte_memory_order_relaxed));
 	}
 out:
 	rte_spinlock_unlock(&trace->lock);
@@ -319,7 +374,9 @@ __rte_trace_mem_per_thread_alloc(void)
 {
 	struct trace *trace = trace_obj_get();
 	struct __rte_trace_header *header;
+	struct trace_stream *stream;
 	uint32_t count;
+	size_t sz;
 
 	if (!rte_trace_is_enabled())
 		return;
@@ -342,15 +399,20 @@ __rte_trace_mem_per_thread_alloc(void)
 		goto fail;
 	}
 
+	if (trace->mode == RTE_TRACE_MODE_STREAM)
+		sz = trace_stream_mem_sz(trace->buff_len);
+	else
+		sz = trace_mem_sz(trace->buff_len);
+
 	/* First attempt from huge page */
-	header = eal_malloc_no_trace(NULL, trace_mem_sz(trace->buff_len), 8);
+	header = eal_malloc_no_trace(NULL, sz, 8);
 	if (header) {
 		trace->lcore_meta[count].area = TRACE_AREA_HUGEPAGE;
 		goto found;
 	}
 
 	/* Second attempt from heap */
-	header = malloc(trace_mem_sz(trace->buff_len));
+	header = malloc(sz);
 	if (header == NULL) {
 		trace_crit("trace mem malloc attempt failed");
 		header = NULL;
@@ -375,6 +437,16 @@ __rte_trace_mem_per_thread_alloc(void)
 	thread_get_name(rte_thread_self(), name,
 		__RTE_TRACE_EMIT_STRING_LEN_MAX);
 
+	/* Record in the first sub-buffer in STREAM mode */
+	if (trace->mode == RTE_TRACE_MODE_STREAM) {
+		stream = trace_stream_get(header, trace->buff_len);
+		memset(stream, 0, sizeof(*stream));
+		stream->fd = -1;
+		stream->id = trace->stream_nb_ids++;
+		header->len = trace->stream_subbuf_len -
+			__RTE_TRACE_EVENT_HEADER_SZ;
+	}
+
 	trace->lcore_meta[count].mem = header;
 	trace->nb_trace_mem_list++;
 fail:
@@ -391,6 +463,40 @@ trace_mem_per_thread_free_unlocked(struct thread_mem_meta *meta)
 		free(meta->mem);
 }
 
+int
+__rte_trace_mem_stream_next(struct __rte_trace_header *header, uint32_t sz)
+{
+	struct trace_stream *stream = trace_stream_get(header, trace.buff_len);
+	uint32_t len = trace.stream_subbuf_len;
+	uint32_t start = stream->head * len;
+	uint32_t next;
+
+	/* Event does not fit even in an empty sub-buffer */
+	if (sz >= len - __RTE_TRACE_EVENT_HEADER_SZ)
+		goto drop;
+
+	/* Streaming thread did not write the next sub-buffer yet */
+	next = (stream->head + 1) % TRACE_STREAM_NB_SUBBUF;
+	if (rte_atomic_load_explicit(&stream->ready[next],
+			rte_memory_order_acquire) != 0)
+		goto drop;
+
+	/* Hand the current sub-buffer over, keeping events 8B aligned */
+	rte_atomic_store_explicit(&stream->ready[stream->head],
+		RTE_ALIGN_CEIL(header->offset - start, __RTE_TRACE_EVENT_HEADER_SZ),
+		rte_memory_order_release);
+
+	stream->head = next;
+	header->offset = next * len;
+	header->len = header->offset + len - __RTE_TRACE_EVENT_HEADER_SZ;
+	return 0;
+
+drop:
+	rte_atomic_fetch_add_explicit(&stream->drops, 1,
+		rte_memory_order_relaxed);
+	return -ENOSPC;
+}
+
 void
 trace_mem_per_thread_free(void)
 {
@@ -410,6 +516,16 @@ trace_mem_per_thread_free(void)
 	if (count != trace->nb_trace_mem_list) {
 		struct thread_mem_meta *meta = &trace->lcore_meta[count];
 
+		/* Write out the remaining events of the exiting thread */
+		if (trace->mode == RTE_TRACE_MODE_STREAM) {
+			struct trace_stream *stream =
+				trace_stream_get(header, trace->buff_len);
+
+			trace_stream_drain(meta, true);
+			trace->stream_bytes += stream->bytes;
+			trace->stream_drops += rte_atomic_load_explicit(
+				&stream->drops, rte_memory_order_relaxed);
+		}
 		trace_mem_per_thread_free_unlocked(meta);
 		if (count != trace->nb_trace_mem_list - 1) {
 			memmove(meta, meta + 1,
@@ -2,14 +2,18 @@
  * Copyright(C) 2020 Marvell International Ltd.
  */
 
+#include <fcntl.h>
 #include <fnmatch.h>
 #include <pwd.h>
 #include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_string_fns.h>
+#include <rte_thread.h>
 
 #include "eal_filesystem.h"
 #include "eal_private.h"
@@ -21,6 +25,7 @@ trace_mode_to_string(enum rte_trace_mode mode)
 	switch (mode) {
 	case RTE_TRACE_MODE_OVERWRITE: return "overwrite";
 	case RTE_TRACE_MODE_DISCARD: return "discard";
+	case RTE_TRACE_MODE_STREAM: return "stream";
 	default: return "unknown";
 	}
 }
@@ -228,6 +233,8 @@ eal_trace_mode_args_save(const char *val)
 		tmp = RTE_TRACE_MODE_OVERWRITE;
 	else if (fnmatch(pattern, "discard", 0) == 0)
 		tmp = RTE_TRACE_MODE_DISCARD;
+	else if (fnmatch(pattern, "stream", 0) == 0)
+		tmp = RTE_TRACE_MODE_STREAM;
 	else {
 		free(pattern);
 		return -EINVAL;
@@ -409,6 +416,22 @@ trace_mem_save(struct trace *trace, struct __rte_trace_header *hdr,
 	return rc;
 }
 
+static int
+trace_stream_meta_save(struct trace *trace)
+{
+	int rc;
+
+	rte_spinlock_lock(&trace->lock);
+	rc = trace_mkdir();
+	if (rc == 0)
+		rc = trace_meta_save(trace);
+	if (rc == 0)
+		trace->stream_meta_saved = true;
+	rte_spinlock_unlock(&trace->lock);
+
+	return rc;
+}
+
 int
 rte_trace_save(void)
 {
@@ -420,6 +443,16 @@ rte_trace_save(void)
 	if (trace->nb_trace_mem_list == 0)
 		return rc;
 
+	/* Trace buffers are written out as they fill up in STREAM mode, the
+	 * parts the threads are recording in are left to them.
+	 */
+	if (trace->mode == RTE_TRACE_MODE_STREAM) {
+		rc = trace_stream_meta_save(trace);
+		if (rc)
+			return rc;
+		return trace_stream_flush(false);
+	}
+
 	rc = trace_mkdir();
 	if (rc < 0)
 		return rc;
@@ -438,3 +471,180 @@ rte_trace_save(void)
 	rte_spinlock_unlock(&trace->lock);
 	return rc;
 }
+
+static int
+trace_stream_write(struct trace *trace, struct __rte_trace_header *hdr,
+		struct trace_stream *stream, const void *buf, uint32_t len)
+{
+	char file_name[PATH_MAX];
+	ssize_t rc;
+
+	/* Create the thread trace file on first use */
+	if (stream->fd < 0) {
+		rc = trace_mkdir();
+		if (rc < 0)
+			return rc;
+
+		rc = snprintf(file_name, PATH_MAX, "%s/channel0_%u",
+			trace->dir, stream->id);
+		if (rc < 0)
+			return rc;
+
+		stream->fd = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+		if (stream->fd < 0)
+			return -errno;
+
+		rc = write(stream->fd, &hdr->stream_header,
+			sizeof(hdr->stream_header));
+		if (rc != (ssize_t)sizeof(hdr->stream_header))
+			return -EACCES;
+	}
+
+	while (len > 0) {
+		rc = write(stream->fd, buf, len);
+		if (rc < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		buf = RTE_PTR_ADD(buf, rc);
+		len -= rc;
+		stream->bytes += rc;
+	}
+
+	return 0;
+}
+
+/* Must be called with the trace lock held. */
+int
+trace_stream_drain(struct thread_mem_meta *meta, bool all)
+{
+	struct trace *trace = trace_obj_get();
+	struct __rte_trace_header *hdr = meta->mem;
+	struct trace_stream *stream = trace_stream_get(hdr, trace->buff_len);
+	uint32_t len = trace->stream_subbuf_len;
+	uint32_t start, size;
+	int rc = 0;
+
+	/* Write the sub-buffers handed over by the thread, in order */
+	while ((size = rte_atomic_load_explicit(&stream->ready[stream->tail],
+			rte_memory_order_acquire)) != 0) {
+		rc = trace_stream_write(trace, hdr, stream,
+			RTE_PTR_ADD(hdr->mem, stream->tail * len), size);
+
+		/* Give the sub-buffer back, even if the write failed */
+		rte_atomic_store_explicit(&stream->ready[stream->tail], 0,
+			rte_memory_order_release);
+		stream->tail = (stream->tail + 1) % TRACE_STREAM_NB_SUBBUF;
+		if (rc < 0)
+			goto out;
+	}
+
+	if (!all)
+		goto out;
+
+	/* The thread is not recording anymore, take the partial sub-buffer */
+	start = stream->head * len;
+	if (hdr->offset != start) {
+		rc = trace_stream_write(trace, hdr, stream,
+			RTE_PTR_ADD(hdr->mem, start), hdr->offset - start);
+		hdr->offset = start;
+	}
+
+	if (stream->fd >= 0) {
+		close(stream->fd);
+		stream->fd = -1;
+	}
+out:
+	/* Report write errors once, not on every streaming period */
+	if (rc < 0 && rc != stream->error)
+		trace_err("failed to write trace file for thread %s [%s]",
+			hdr->stream_header.thread_name, strerror(-rc));
+	stream->error = rc;
+	return rc;
+}
+
+int
+trace_stream_flush(bool all)
+{
+	struct trace *trace = trace_obj_get();
+	uint32_t count;
+	int rc = 0;
+
+	rte_spinlock_lock(&trace->lock);
+	for (count = 0; count < trace->nb_trace_mem_list; count++) {
+		if (trace_stream_drain(&trace->lcore_meta[count], all) < 0)
+			rc = -EIO;
+	}
+	rte_spinlock_unlock(&trace->lock);
+
+	return rc;
+}
+
+static uint32_t
+trace_stream_thread(void *arg)
+{
+	struct trace *trace = arg;
+
+	while (rte_atomic_load_explicit(&trace->stream_run,
+			rte_memory_order_acquire)) {
+		/* Metadata embeds the TSC frequency, known once EAL is up */
+		if (!trace->stream_meta_saved && trace->nb_trace_mem_list != 0 &&
+				rte_get_tsc_hz() != 0)
+			trace_stream_meta_save(trace);
+
+		trace_stream_flush(false);
+		rte_delay_us_sleep(TRACE_STREAM_PERIOD_US);
+	}
+
+	return 0;
+}
+
+int
+trace_stream_start(void)
+{
+	struct trace *trace = trace_obj_get();
+	int rc;
+
+	trace->stream_subbuf_len = RTE_ALIGN_FLOOR(
+		trace->buff_len / TRACE_STREAM_NB_SUBBUF,
+		__RTE_TRACE_EVENT_HEADER_SZ);
+	if (trace->stream_subbuf_len <= 2 * __RTE_TRACE_EVENT_HEADER_SZ) {
+		trace_err("buffer size too small for stream mode");
+		rte_errno = EINVAL;
+		return -rte_errno;
+	}
+
+	rte_atomic_store_explicit(&trace->stream_run, true,
+		rte_memory_order_release);
+	rc = rte_thread_create_internal_control(&trace->stream_thread, "trace",
+		trace_stream_thread, trace);
+	if (rc != 0) {
+		trace_err("failed to create stream thread");
+		rte_errno = -rc;
+		return rc;
+	}
+
+	trace->stream_started = true;
+	return 0;
+}
+
+void
+trace_stream_stop(void)
+{
+	struct trace *trace = trace_obj_get();
+
+	if (!trace->stream_started)
+		return;
+
+	rte_atomic_store_explicit(&trace->stream_run, false,
+		rte_memory_order_release);
+	rte_thread_join(trace->stream_thread, NULL);
+	trace->stream_started = false;
+
+	if (trace->nb_trace_mem_list == 0)
+		return;
+
+	trace_stream_meta_save(trace);
+	trace_stream_flush(true);
+}
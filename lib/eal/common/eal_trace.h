@@ -24,6 +24,8 @@
 
 #define TRACE_CTF_MAGIC 0xC1FC1FC1
 #define TRACE_MAX_ARGS	32
+#define TRACE_STREAM_NB_SUBBUF 4
+#define TRACE_STREAM_PERIOD_US 1000
 
 struct trace_point {
 	STAILQ_ENTRY(trace_point) next;
@@ -42,6 +44,25 @@ struct thread_mem_meta {
 	enum trace_area_e area;
 };
 
+/* Streaming state of a thread trace memory, stored after the events area.
+ * The events area is split in TRACE_STREAM_NB_SUBBUF sub-buffers, which
+ * are handed over from the recording thread to the streaming thread and
+ * back through the ready array: a sub-buffer is owned by the streaming
+ * thread while its ready size is not zero.
+ */
+struct trace_stream {
+	/* Recording thread side */
+	uint32_t head;
+	RTE_ATOMIC(uint64_t) drops;
+	/* Streaming thread side */
+	uint32_t tail;
+	uint32_t id;
+	int fd;
+	int error;
+	uint64_t bytes;
+	RTE_ATOMIC(uint32_t) ready[TRACE_STREAM_NB_SUBBUF];
+};
+
 struct trace_arg {
 	STAILQ_ENTRY(trace_arg) next;
 	char *val;
@@ -66,6 +87,14 @@ struct trace {
 	uint32_t ctf_meta_offset_freq_off_s;
 	uint32_t ctf_meta_offset_freq_off;
 	RTE_ATOMIC(uint16_t) ctf_fixup_done;
+	uint32_t stream_subbuf_len;
+	uint32_t stream_nb_ids;
+	uint64_t stream_bytes;
+	uint64_t stream_drops;
+	bool stream_meta_saved;
+	bool stream_started;
+	RTE_ATOMIC(bool) stream_run;
+	rte_thread_t stream_thread;
 	rte_spinlock_t lock;
 };
 
@@ -83,6 +112,18 @@ trace_mem_sz(uint32_t len)
 	return len + sizeof(struct __rte_trace_header);
 }
 
+static inline size_t
+trace_stream_mem_sz(uint32_t len)
+{
+	return trace_mem_sz(RTE_ALIGN_CEIL(len, 8)) + sizeof(struct trace_stream);
+}
+
+static inline struct trace_stream *
+trace_stream_get(struct __rte_trace_header *hdr, uint32_t len)
+{
+	return RTE_PTR_ADD(hdr->mem, RTE_ALIGN_CEIL(len, 8));
+}
+
 /* Trace object functions */
 struct trace *trace_obj_get(void);
 
@@ -103,6 +144,10 @@ char *trace_metadata_fixup_field(const char *field);
 int trace_epoch_time_save(void);
 void trace_mem_free(void);
 void trace_mem_per_thread_free(void);
+int trace_stream_start(void);
+void trace_stream_stop(void);
+int trace_stream_drain(struct thread_mem_meta *meta, bool all);
+int trace_stream_flush(bool all);
 
 /* EAL interface */
 int eal_trace_init(void);
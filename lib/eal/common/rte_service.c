@@ -2,7 +2,9 @@
  * Copyright(c) 2017 Intel Corporation
  */
 
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <inttypes.h>
 #include <string.h>
 
@@ -18,7 +20,12 @@
 #include <rte_cycles.h>
 #include <rte_atomic.h>
 #include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_power_intrinsics.h>
 #include <rte_spinlock.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <rte_telemetry.h>
+#endif
 #include <rte_trace_point.h>
 
 #include "eal_private.h"
@@ -55,6 +62,15 @@ struct __rte_cache_aligned rte_service_spec_impl {
 	 * on currently.
 	 */
 	RTE_ATOMIC(uint32_t) num_mapped_cores;
+
+	/* run policy: back-to-back invocations per service loop, and
+	 * maximum interval between invocations (0 if no deadline).
+	 */
+	RTE_ATOMIC(uint32_t) weight;
+	RTE_ATOMIC(uint64_t) deadline_cycles;
+	uint64_t deadline_ns;
+	/* TSC of the last invocation, shared by all cores running it */
+	RTE_ATOMIC(uint64_t) last_run;
 };
 
 struct service_stats {
@@ -62,6 +78,8 @@ struct service_stats {
 	RTE_ATOMIC(uint64_t) idle_calls;
 	RTE_ATOMIC(uint64_t) error_calls;
 	RTE_ATOMIC(uint64_t) cycles;
+	RTE_ATOMIC(uint64_t) deadline_misses;
+	RTE_ATOMIC(uint64_t) cycles_hist[RTE_SERVICE_CYCLES_HIST_BUCKETS];
 };
 
 /* the internal values of a service core */
@@ -75,10 +93,30 @@ struct __rte_cache_aligned core_state {
 	RTE_ATOMIC(uint64_t) loops;
 	RTE_ATOMIC(uint64_t) cycles;
 	struct service_stats service_stats[RTE_SERVICE_NUM_MAX];
+
+	/* idle back-off policy */
+	RTE_ATOMIC(uint32_t) pause_loops;
+	RTE_ATOMIC(uint32_t) sleep_loops;
+	RTE_ATOMIC(uint32_t) max_sleep_us;
+	/* idle back-off state, only touched by the service lcore itself */
+	uint32_t idle_loops; /* consecutive loops where no service did work */
+	uint64_t idle_seq; /* wakeup_seq value when the sleep was announced */
+	uint8_t loop_busy; /* set when a service did work in the current loop */
+	/* set while the lcore is about to sleep, or sleeping */
+	RTE_ATOMIC(uint8_t) sleeping;
+	/* bumped to wake the lcore up, monitored while sleeping */
+	RTE_ATOMIC(uint64_t) wakeup_seq;
+	RTE_ATOMIC(uint64_t) sleeps;
+	RTE_ATOMIC(uint64_t) sleep_cycles;
 };
 
 static uint32_t rte_service_count;
 static struct rte_service_spec_impl *rte_services;
+/* services with a deadline, scheduled ahead of the regular round-robin */
+static RTE_BITSET_DECLARE(deadline_services, RTE_SERVICE_NUM_MAX);
+static RTE_ATOMIC(uint32_t) deadline_services_count;
+/* number of service lcores which are sleeping, or about to */
+static RTE_ATOMIC(uint32_t) sleeping_lcores;
 static RTE_LCORE_VAR_HANDLE(struct core_state, lcore_states);
 static uint32_t rte_service_library_initialized;
 
@@ -131,6 +169,10 @@ rte_service_finalize(void)
 
 	rte_free(rte_services);
 
+	rte_bitset_clear_all(deadline_services, RTE_SERVICE_NUM_MAX);
+	rte_atomic_store_explicit(&deadline_services_count, 0,
+		rte_memory_order_relaxed);
+
 	rte_service_library_initialized = 0;
 }
 
@@ -152,6 +194,14 @@ service_get(uint32_t id)
 	return &rte_services[id];
 }
 
+/* wake up a service lcore which may be sleeping */
+static inline void
+service_lcore_wakeup(struct core_state *cs)
+{
+	rte_atomic_fetch_add_explicit(&cs->wakeup_seq, 1,
+		rte_memory_order_release);
+}
+
 /* validate ID and retrieve service pointer, or return error value */
 #define SERVICE_VALID_GET_OR_ERR_RET(id, service, retval) do {          \
 	if (!service_valid(id))                                         \
@@ -265,6 +315,7 @@ rte_service_component_register(const struct rte_service_spec *spec,
 	struct rte_service_spec_impl *s = &rte_services[free_slot];
 	s->spec = *spec;
 	s->internal_flags |= SERVICE_F_REGISTERED | SERVICE_F_START_CHECK;
+	rte_atomic_store_explicit(&s->weight, 1, rte_memory_order_relaxed);
 
 	rte_service_count++;
 
@@ -276,6 +327,26 @@ rte_service_component_register(const struct rte_service_spec *spec,
 	return 0;
 }
 
+/* Add or remove a service to the deadline services on a change of its
+ * deadline, only the caller which changed it from or to zero does it.
+ */
+static void
+service_deadline_set_update(uint32_t id, uint64_t old_deadline_cycles,
+			    uint64_t deadline_cycles)
+{
+	if (old_deadline_cycles == 0 && deadline_cycles != 0) {
+		rte_bitset_atomic_set(deadline_services, id,
+			rte_memory_order_release);
+		rte_atomic_fetch_add_explicit(&deadline_services_count, 1,
+			rte_memory_order_release);
+	} else if (old_deadline_cycles != 0 && deadline_cycles == 0) {
+		rte_bitset_atomic_clear(deadline_services, id,
+			rte_memory_order_release);
+		rte_atomic_fetch_sub_explicit(&deadline_services_count, 1,
+			rte_memory_order_release);
+	}
+}
+
 int32_t
 rte_service_component_unregister(uint32_t id)
 {
@@ -292,6 +363,10 @@ rte_service_component_unregister(uint32_t id)
 	RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states)
 		rte_bitset_clear(cs->mapped_services, id);
 
+	service_deadline_set_update(id,
+		rte_atomic_exchange_explicit(&s->deadline_cycles, 0,
+			rte_memory_order_acq_rel), 0);
+
 	memset(&rte_services[id], 0, sizeof(struct rte_service_spec_impl));
 
 	return 0;
@@ -314,6 +389,7 @@ rte_service_component_runstate_set(uint32_t id, uint32_t runstate)
 		rte_atomic_store_explicit(&s->comp_runstate, RUNSTATE_STOPPED,
 			rte_memory_order_release);
 
+	rte_service_wakeup(id);
 	return 0;
 }
 
@@ -334,6 +410,7 @@ rte_service_runstate_set(uint32_t id, uint32_t runstate)
 		rte_atomic_store_explicit(&s->app_runstate, RUNSTATE_STOPPED,
 			rte_memory_order_release);
 
+	rte_service_wakeup(id);
 	rte_eal_trace_service_runstate_set(id, runstate);
 	return 0;
 }
@@ -378,19 +455,53 @@ service_counter_add(RTE_ATOMIC(uint64_t) *counter, uint64_t operand)
 				  rte_memory_order_relaxed);
 }
 
+static inline uint32_t
+service_cycles_hist_bucket(uint64_t cycles)
+{
+	uint32_t bucket = rte_fls_u64(cycles);
+
+	/* bucket i holds [2^i, 2^(i+1)), with 0 and 1 both in bucket 0 */
+	if (bucket > 0)
+		bucket--;
+
+	return RTE_MIN(bucket, (uint32_t)RTE_SERVICE_CYCLES_HIST_BUCKETS - 1);
+}
+
 static inline void
+service_deadline_update(struct rte_service_spec_impl *s,
+			struct service_stats *service_stats)
+{
+	uint64_t deadline = rte_atomic_load_explicit(&s->deadline_cycles,
+		rte_memory_order_relaxed);
+	uint64_t last, now;
+
+	if (likely(deadline == 0))
+		return;
+
+	now = rte_rdtsc();
+	last = rte_atomic_load_explicit(&s->last_run, rte_memory_order_relaxed);
+	if (last != 0 && now - last > deadline)
+		service_counter_add(&service_stats->deadline_misses, 1);
+
+	rte_atomic_store_explicit(&s->last_run, now, rte_memory_order_relaxed);
+}
+
+static inline int32_t
 service_runner_do_callback(struct rte_service_spec_impl *s,
 			   struct core_state *cs, uint32_t service_idx)
 {
-	rte_eal_trace_service_run_begin(service_idx, rte_lcore_id());
+	struct service_stats *service_stats = &cs->service_stats[service_idx];
 	void *userdata = s->spec.callback_userdata;
+	int rc;
+
+	rte_eal_trace_service_run_begin(service_idx, rte_lcore_id());
+
+	service_deadline_update(s, service_stats);
 
 	if (service_stats_enabled(s)) {
 		uint64_t start = rte_rdtsc();
-		int rc = s->spec.callback(userdata);
 
-		struct service_stats *service_stats =
-			&cs->service_stats[service_idx];
+		rc = s->spec.callback(userdata);
 
 		service_counter_add(&service_stats->calls, 1);
 
@@ -405,11 +516,33 @@ service_runner_do_callback(struct rte_service_spec_impl *s,
 
 			service_counter_add(&cs->cycles, cycles);
 			service_counter_add(&service_stats->cycles, cycles);
+			service_counter_add(&service_stats->cycles_hist[
+				service_cycles_hist_bucket(cycles)], 1);
 		}
 	} else {
-		s->spec.callback(userdata);
+		rc = s->spec.callback(userdata);
 	}
 	rte_eal_trace_service_run_end(service_idx, rte_lcore_id());
+
+	return rc;
+}
+
+/* Invoke the service up to its weight times, stopping early once it
+ * reports having no more work to do.
+ */
+static inline void
+service_runner_do_weighted(struct rte_service_spec_impl *s,
+			   struct core_state *cs, uint32_t service_idx)
+{
+	uint32_t weight = rte_atomic_load_explicit(&s->weight,
+		rte_memory_order_relaxed);
+	uint32_t i;
+
+	for (i = 0; i < weight; i++) {
+		if (service_runner_do_callback(s, cs, service_idx) == -EAGAIN)
+			break;
+		cs->loop_busy = 1;
+	}
 }
 
 
@@ -440,14 +573,58 @@ service_run(uint32_t i, struct core_state *cs, const uint64_t *mapped_services,
 		if (!rte_spinlock_trylock(&s->execute_lock))
 			return -EBUSY;
 
-		service_runner_do_callback(s, cs, i);
+		service_runner_do_weighted(s, cs, i);
 		rte_spinlock_unlock(&s->execute_lock);
 	} else
-		service_runner_do_callback(s, cs, i);
+		service_runner_do_weighted(s, cs, i);
 
 	return 0;
 }
 
+/* Run the services of this core whose deadline is approaching, earliest
+ * deadline first. A service is due once half of its deadline has passed
+ * since it last ran. Each service is attempted at most once per call, so
+ * a service which cannot run (e.g. it is stopped or run by another core)
+ * does not starve the others.
+ */
+static void
+service_run_deadlines(struct core_state *cs)
+{
+	RTE_BITSET_DECLARE(pending, RTE_SERVICE_NUM_MAX);
+	uint64_t now = rte_rdtsc();
+
+	rte_bitset_and(pending, cs->mapped_services, deadline_services,
+		RTE_SERVICE_NUM_MAX);
+
+	for (;;) {
+		uint64_t earliest = UINT64_MAX;
+		ssize_t selected = -1;
+		ssize_t id;
+
+		RTE_BITSET_FOREACH_SET(id, pending, RTE_SERVICE_NUM_MAX) {
+			struct rte_service_spec_impl *s = service_get(id);
+			uint64_t due = rte_atomic_load_explicit(&s->last_run,
+				rte_memory_order_relaxed) +
+				rte_atomic_load_explicit(&s->deadline_cycles,
+				rte_memory_order_relaxed) / 2;
+
+			if (due <= now && due < earliest) {
+				earliest = due;
+				selected = id;
+			}
+		}
+
+		if (selected < 0)
+			break;
+
+		rte_bitset_clear(pending, selected);
+		/* return value ignored as no change to code flow */
+		service_run(selected, cs, cs->mapped_services,
+			service_get(selected), 1);
+		now = rte_rdtsc();
+	}
+}
+
 int32_t
 rte_service_may_be_active(uint32_t id)
 {
@@ -491,6 +668,144 @@ rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 	return ret;
 }
 
+static int
+service_wakeup_cond(const uint64_t val,
+		    const uint64_t opaque[RTE_POWER_MONITOR_OPAQUE_SZ])
+{
+	/* abort going to sleep if a wakeup came in meanwhile */
+	return val != opaque[0] ? -1 : 0;
+}
+
+/* Return the TSC at which the next deadline service of the lcore is due,
+ * or UINT64_MAX if there is none.
+ */
+static uint64_t
+service_next_deadline(struct core_state *cs)
+{
+	RTE_BITSET_DECLARE(pending, RTE_SERVICE_NUM_MAX);
+	uint64_t earliest = UINT64_MAX;
+	ssize_t id;
+
+	if (rte_atomic_load_explicit(&deadline_services_count,
+			rte_memory_order_relaxed) == 0)
+		return earliest;
+
+	rte_bitset_and(pending, cs->mapped_services, deadline_services,
+		RTE_SERVICE_NUM_MAX);
+
+	RTE_BITSET_FOREACH_SET(id, pending, RTE_SERVICE_NUM_MAX) {
+		struct rte_service_spec_impl *s = service_get(id);
+		uint64_t due = rte_atomic_load_explicit(&s->last_run,
+			rte_memory_order_relaxed) +
+			rte_atomic_load_explicit(&s->deadline_cycles,
+			rte_memory_order_relaxed) / 2;
+
+		earliest = RTE_MIN(earliest, due);
+	}
+
+	return earliest;
+}
+
+static void
+service_sleep_set(struct core_state *cs, uint8_t sleeping)
+{
+	if (rte_atomic_load_explicit(&cs->sleeping,
+			rte_memory_order_relaxed) == sleeping)
+		return;
+
+	/* Pairs with the fence in rte_service_wakeup(): either the waker
+	 * sees the lcore as sleeping, or the lcore polls its services once
+	 * more after this store and finds the new work.
+	 */
+	rte_atomic_store_explicit(&cs->sleeping, sleeping,
+		rte_memory_order_seq_cst);
+	if (sleeping)
+		rte_atomic_fetch_add_explicit(&sleeping_lcores, 1,
+			rte_memory_order_seq_cst);
+	else
+		rte_atomic_fetch_sub_explicit(&sleeping_lcores, 1,
+			rte_memory_order_relaxed);
+}
+
+static void
+service_sleep(struct core_state *cs, uint64_t seq)
+{
+	uint32_t max_sleep_us = rte_atomic_load_explicit(&cs->max_sleep_us,
+		rte_memory_order_relaxed);
+	struct rte_cpu_intrinsics intrinsics;
+	uint64_t start = rte_rdtsc();
+	uint64_t until = start + (rte_get_tsc_hz() / US_PER_S) * max_sleep_us;
+
+	until = RTE_MIN(until, service_next_deadline(cs));
+	if (until <= start)
+		return;
+
+	service_counter_add(&cs->sleeps, 1);
+
+	rte_cpu_get_intrinsics_support(&intrinsics);
+	if (intrinsics.power_monitor) {
+		struct rte_power_monitor_cond pmc = {
+			.addr = &cs->wakeup_seq,
+			.size = sizeof(uint64_t),
+			.fn = service_wakeup_cond,
+			.opaque = { seq },
+		};
+
+		/* wakes up early on write to wakeup_seq, e.g. by
+		 * rte_service_wakeup(), or on spurious interrupts
+		 */
+		while (rte_atomic_load_explicit(&cs->wakeup_seq,
+				rte_memory_order_acquire) == seq &&
+				rte_rdtsc() < until)
+			rte_power_monitor(&pmc, until);
+	} else {
+		rte_delay_us_sleep((until - start) * US_PER_S /
+			rte_get_tsc_hz());
+	}
+
+	service_counter_add(&cs->sleep_cycles, rte_rdtsc() - start);
+}
+
+/* Back off after a loop in which none of the services did any work:
+ * first pause between loops, then sleep until woken up or a timeout.
+ */
+static void
+service_runner_idle(struct core_state *cs, uint32_t pause_loops,
+		    uint32_t sleep_loops)
+{
+	uint64_t seq;
+
+	if (cs->loop_busy) {
+		cs->loop_busy = 0;
+		cs->idle_loops = 0;
+		service_sleep_set(cs, 0);
+		return;
+	}
+
+	cs->idle_loops++;
+
+	if (sleep_loops != 0 && cs->idle_loops >= sleep_loops) {
+		seq = rte_atomic_load_explicit(&cs->wakeup_seq,
+			rte_memory_order_acquire);
+		if (!rte_atomic_load_explicit(&cs->sleeping,
+				rte_memory_order_relaxed)) {
+			/* announce the sleep, and poll once more before
+			 * actually sleeping to not miss a wakeup
+			 */
+			cs->idle_seq = seq;
+			service_sleep_set(cs, 1);
+			return;
+		}
+		if (seq == cs->idle_seq)
+			service_sleep(cs, seq);
+		service_sleep_set(cs, 0);
+		/* poll the services again, and keep pausing in between */
+		cs->idle_loops = pause_loops;
+	} else if (pause_loops != 0 && cs->idle_loops >= pause_loops) {
+		rte_pause();
+	}
+}
+
 static int32_t
 service_runner_func(void *arg)
 {
@@ -505,16 +820,33 @@ service_runner_func(void *arg)
 	 */
 	while (rte_atomic_load_explicit(&cs->runstate, rte_memory_order_acquire) ==
 			RUNSTATE_RUNNING) {
+		uint32_t pause_loops, sleep_loops;
 		ssize_t id;
 
 		RTE_BITSET_FOREACH_SET(id, cs->mapped_services, RTE_SERVICE_NUM_MAX) {
+			/* give latency-critical services precedence */
+			if (unlikely(rte_atomic_load_explicit(&deadline_services_count,
+					rte_memory_order_relaxed) > 0))
+				service_run_deadlines(cs);
+
 			/* return value ignored as no change to code flow */
 			service_run(id, cs, cs->mapped_services, service_get(id), 1);
 		}
 
 		rte_atomic_store_explicit(&cs->loops, cs->loops + 1, rte_memory_order_relaxed);
+
+		pause_loops = rte_atomic_load_explicit(&cs->pause_loops,
+			rte_memory_order_relaxed);
+		sleep_loops = rte_atomic_load_explicit(&cs->sleep_loops,
+			rte_memory_order_relaxed);
+		if (pause_loops != 0 || sleep_loops != 0)
+			service_runner_idle(cs, pause_loops, sleep_loops);
 	}
 
+	service_sleep_set(cs, 0);
+	cs->idle_loops = 0;
+	cs->loop_busy = 0;
+
 	/* Switch off this core for all services, to ensure that future
 	 * calls to may_be_active() know this core is switched off.
 	 */
@@ -652,6 +984,7 @@ service_update(uint32_t sid, uint32_t lcore, uint32_t *set, uint32_t *enabled)
 			rte_bitset_set(cs->mapped_services, sid);
 			rte_atomic_fetch_add_explicit(&rte_services[sid].num_mapped_cores,
 				1, rte_memory_order_relaxed);
+			service_lcore_wakeup(cs);
 		}
 		if (!*set && lcore_mapped) {
 			rte_bitset_clear(cs->mapped_services, sid);
@@ -718,6 +1051,7 @@ rte_service_lcore_reset_all(void)
 			 */
 			rte_atomic_store_explicit(&cs->runstate,
 				RUNSTATE_STOPPED, rte_memory_order_release);
+			service_lcore_wakeup(cs);
 		}
 	}
 	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++)
@@ -741,6 +1075,9 @@ rte_service_lcore_add(uint32_t lcore)
 
 	/* ensure that after adding a core the mask and state are defaults */
 	rte_bitset_clear_all(cs->mapped_services, RTE_SERVICE_NUM_MAX);
+	rte_atomic_store_explicit(&cs->pause_loops, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&cs->sleep_loops, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&cs->max_sleep_us, 0, rte_memory_order_relaxed);
 	/* Use store-release memory order here to synchronize with
 	 * load-acquire in runstate read functions.
 	 */
@@ -845,6 +1182,7 @@ rte_service_lcore_stop(uint32_t lcore)
 	 */
 	rte_atomic_store_explicit(&cs->runstate, RUNSTATE_STOPPED,
 		rte_memory_order_release);
+	service_lcore_wakeup(cs);
 
 	rte_eal_trace_service_lcore_stop(lcore);
 
@@ -867,6 +1205,44 @@ lcore_attr_get_cycles(unsigned int lcore)
 	return rte_atomic_load_explicit(&cs->cycles, rte_memory_order_relaxed);
 }
 
+static uint64_t
+lcore_attr_get_sleeps(unsigned int lcore)
+{
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+
+	return rte_atomic_load_explicit(&cs->sleeps, rte_memory_order_relaxed);
+}
+
+static uint64_t
+lcore_attr_get_sleep_cycles(unsigned int lcore)
+{
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+
+	return rte_atomic_load_explicit(&cs->sleep_cycles,
+		rte_memory_order_relaxed);
+}
+
+static uint64_t
+lcore_attr_get_service_deadline_misses(uint32_t service_id, unsigned int lcore)
+{
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+
+	return rte_atomic_load_explicit(&cs->service_stats[service_id].deadline_misses,
+		rte_memory_order_relaxed);
+}
+
+static uint64_t
+lcore_attr_get_deadline_misses(unsigned int lcore)
+{
+	uint64_t sum = 0;
+	uint32_t i;
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++)
+		sum += lcore_attr_get_service_deadline_misses(i, lcore);
+
+	return sum;
+}
+
 static uint64_t
 lcore_attr_get_service_calls(uint32_t service_id, unsigned int lcore)
 {
@@ -879,7 +1255,7 @@ lcore_attr_get_service_calls(uint32_t service_id, unsigned int lcore)
 static uint64_t
 lcore_attr_get_service_idle_calls(uint32_t service_id, unsigned int lcore)
 {
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 
 	return rte_atomic_load_explicit(&cs->service_stats[service_id].idle_calls,
 		rte_memory_order_relaxed);
@@ -888,7 +1264,7 @@ lcore_attr_get_service_idle_calls(uint32_t service_id, unsigned int lcore)
 static uint64_t
 lcore_attr_get_service_error_calls(uint32_t service_id, unsigned int lcore)
 {
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs =	RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 
 	return rte_atomic_load_explicit(&cs->service_stats[service_id].error_calls,
 		rte_memory_order_relaxed);
@@ -947,6 +1323,12 @@ attr_get_service_cycles(uint32_t service_id)
 	return attr_get(service_id, lcore_attr_get_service_cycles);
 }
 
+static uint64_t
+attr_get_service_deadline_misses(uint32_t service_id)
+{
+	return attr_get(service_id, lcore_attr_get_service_deadline_misses);
+}
+
 int32_t
 rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 {
@@ -969,6 +1351,9 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CYCLES:
 		*attr_value = attr_get_service_cycles(id);
 		return 0;
+	case RTE_SERVICE_ATTR_DEADLINE_MISS_COUNT:
+		*attr_value = attr_get_service_deadline_misses(id);
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -993,11 +1378,175 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 	case RTE_SERVICE_LCORE_ATTR_CYCLES:
 		*attr_value = lcore_attr_get_cycles(lcore);
 		return 0;
+	case RTE_SERVICE_LCORE_ATTR_DEADLINE_MISSES:
+		*attr_value = lcore_attr_get_deadline_misses(lcore);
+		return 0;
+	case RTE_SERVICE_LCORE_ATTR_SLEEPS:
+		*attr_value = lcore_attr_get_sleeps(lcore);
+		return 0;
+	case RTE_SERVICE_LCORE_ATTR_SLEEP_CYCLES:
+		*attr_value = lcore_attr_get_sleep_cycles(lcore);
+		return 0;
 	default:
 		return -EINVAL;
 	}
 }
 
+int32_t
+rte_service_lcore_cycles_hist_get(uint32_t lcore, uint32_t id,
+				  uint64_t hist[], uint32_t n)
+{
+	struct core_state *cs;
+	uint32_t i;
+
+	if (lcore >= RTE_MAX_LCORE || !service_valid(id) || hist == NULL)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
+		return -ENOTSUP;
+
+	n = RTE_MIN(n, (uint32_t)RTE_SERVICE_CYCLES_HIST_BUCKETS);
+	for (i = 0; i < n; i++)
+		hist[i] = rte_atomic_load_explicit(
+			&cs->service_stats[id].cycles_hist[i],
+			rte_memory_order_relaxed);
+
+	return n;
+}
+
+int32_t
+rte_service_run_policy_set(uint32_t id,
+			   const struct rte_service_run_policy *policy)
+{
+	struct rte_service_spec_impl *s;
+	uint64_t old_deadline_cycles;
+	uint64_t deadline_cycles;
+
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (policy == NULL)
+		return -EINVAL;
+
+	deadline_cycles = (policy->deadline_ns / NS_PER_S) * rte_get_tsc_hz() +
+		(policy->deadline_ns % NS_PER_S) * rte_get_tsc_hz() / NS_PER_S;
+	if (policy->deadline_ns != 0 && deadline_cycles == 0)
+		deadline_cycles = 1;
+
+	rte_atomic_store_explicit(&s->weight, RTE_MAX(policy->weight, 1U),
+		rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&s->last_run, rte_rdtsc(),
+		rte_memory_order_relaxed);
+	s->deadline_ns = policy->deadline_ns;
+
+	/* the deadline exchange decides which of concurrent callers
+	 * updates the deadline services set and count
+	 */
+	old_deadline_cycles = rte_atomic_exchange_explicit(&s->deadline_cycles,
+		deadline_cycles, rte_memory_order_acq_rel);
+	service_deadline_set_update(id, old_deadline_cycles, deadline_cycles);
+
+	return 0;
+}
+
+int32_t
+rte_service_lcore_idle_policy_set(uint32_t lcore,
+		const struct rte_service_lcore_idle_policy *policy)
+{
+	struct core_state *cs;
+
+	if (lcore >= RTE_MAX_LCORE || policy == NULL)
+		return -EINVAL;
+
+	if (policy->sleep_loops != 0 && policy->max_sleep_us == 0)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
+		return -ENOTSUP;
+
+	rte_atomic_store_explicit(&cs->pause_loops, policy->pause_loops,
+		rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&cs->sleep_loops, policy->sleep_loops,
+		rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&cs->max_sleep_us, policy->max_sleep_us,
+		rte_memory_order_relaxed);
+
+	/* apply the new policy right away if the lcore is sleeping */
+	service_lcore_wakeup(cs);
+
+	return 0;
+}
+
+int32_t
+rte_service_lcore_idle_policy_get(uint32_t lcore,
+		struct rte_service_lcore_idle_policy *policy)
+{
+	struct core_state *cs;
+
+	if (lcore >= RTE_MAX_LCORE || policy == NULL)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
+		return -ENOTSUP;
+
+	policy->pause_loops = rte_atomic_load_explicit(&cs->pause_loops,
+		rte_memory_order_relaxed);
+	policy->sleep_loops = rte_atomic_load_explicit(&cs->sleep_loops,
+		rte_memory_order_relaxed);
+	policy->max_sleep_us = rte_atomic_load_explicit(&cs->max_sleep_us,
+		rte_memory_order_relaxed);
+
+	return 0;
+}
+
+int32_t
+rte_service_wakeup(uint32_t id)
+{
+	unsigned int lcore_id;
+	struct core_state *cs;
+
+	if (!service_valid(id))
+		return -EINVAL;
+
+	/* Order the caller's publication of work before the check for
+	 * sleeping lcores. Pairs with service_sleep_set().
+	 */
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+
+	if (likely(rte_atomic_load_explicit(&sleeping_lcores,
+			rte_memory_order_relaxed) == 0))
+		return 0;
+
+	RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states) {
+		if (cs->is_service_core &&
+				rte_bitset_test(cs->mapped_services, id) &&
+				rte_atomic_load_explicit(&cs->sleeping,
+					rte_memory_order_relaxed))
+			service_lcore_wakeup(cs);
+	}
+
+	return 0;
+}
+
+int32_t
+rte_service_run_policy_get(uint32_t id, struct rte_service_run_policy *policy)
+{
+	struct rte_service_spec_impl *s;
+
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (policy == NULL)
+		return -EINVAL;
+
+	policy->weight = rte_atomic_load_explicit(&s->weight,
+		rte_memory_order_relaxed);
+	policy->deadline_ns = s->deadline_ns;
+
+	return 0;
+}
+
 int32_t
 rte_service_attr_reset_all(uint32_t id)
 {
@@ -1028,6 +1577,8 @@ rte_service_lcore_attr_reset_all(uint32_t lcore)
 		return -ENOTSUP;
 
 	cs->loops = 0;
+	cs->sleeps = 0;
+	cs->sleep_cycles = 0;
 
 	return 0;
 }
@@ -1102,3 +1653,97 @@ rte_service_dump(FILE *f, uint32_t id)
 
 	return 0;
 }
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+static int
+handle_service_list(const char *cmd __rte_unused,
+		    const char *params __rte_unused, struct rte_tel_data *d)
+{
+	uint32_t i;
+
+	rte_tel_data_start_array(d, RTE_TEL_UINT_VAL);
+	if (!rte_service_library_initialized)
+		return 0;
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		if (service_registered(i))
+			rte_tel_data_add_array_uint(d, i);
+	}
+
+	return 0;
+}
+
+static int
+handle_service_info(const char *cmd __rte_unused, const char *params,
+		    struct rte_tel_data *d)
+{
+	uint64_t hist[RTE_SERVICE_CYCLES_HIST_BUCKETS] = {0};
+	struct rte_service_spec_impl *s;
+	struct rte_tel_data *cycles_hist;
+	unsigned long id;
+	unsigned int lcore;
+	char *endptr;
+	uint32_t i;
+
+	if (params == NULL || !rte_service_library_initialized)
+		return -EINVAL;
+	errno = 0;
+	id = strtoul(params, &endptr, 10);
+	if (errno)
+		return -errno;
+	if (*params == '\0' || *endptr != '\0' || !service_valid(id))
+		return -EINVAL;
+
+	s = service_get(id);
+
+	for (lcore = 0; lcore < RTE_MAX_LCORE; lcore++) {
+		struct core_state *cs =
+			RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+
+		if (!cs->is_service_core)
+			continue;
+		for (i = 0; i < RTE_SERVICE_CYCLES_HIST_BUCKETS; i++)
+			hist[i] += rte_atomic_load_explicit(
+				&cs->service_stats[id].cycles_hist[i],
+				rte_memory_order_relaxed);
+	}
+
+	cycles_hist = rte_tel_data_alloc();
+	if (cycles_hist == NULL)
+		return -ENOMEM;
+	rte_tel_data_start_array(cycles_hist, RTE_TEL_UINT_VAL);
+	for (i = 0; i < RTE_SERVICE_CYCLES_HIST_BUCKETS; i++)
+		rte_tel_data_add_array_uint(cycles_hist, hist[i]);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_uint(d, "id", id);
+	rte_tel_data_add_dict_string(d, "name", s->spec.name);
+	rte_tel_data_add_dict_int(d, "runstate", rte_service_runstate_get(id));
+	rte_tel_data_add_dict_int(d, "stats_enabled", service_stats_enabled(s));
+	rte_tel_data_add_dict_uint(d, "mapped_cores",
+		rte_atomic_load_explicit(&s->num_mapped_cores,
+			rte_memory_order_relaxed));
+	rte_tel_data_add_dict_uint(d, "weight",
+		rte_atomic_load_explicit(&s->weight, rte_memory_order_relaxed));
+	rte_tel_data_add_dict_uint(d, "deadline_ns", s->deadline_ns);
+	rte_tel_data_add_dict_uint(d, "calls", attr_get_service_calls(id));
+	rte_tel_data_add_dict_uint(d, "idle_calls",
+		attr_get_service_idle_calls(id));
+	rte_tel_data_add_dict_uint(d, "error_calls",
+		attr_get_service_error_calls(id));
+	rte_tel_data_add_dict_uint(d, "cycles", attr_get_service_cycles(id));
+	rte_tel_data_add_dict_uint(d, "deadline_misses",
+		attr_get_service_deadline_misses(id));
+	rte_tel_data_add_dict_container(d, "cycles_hist", cycles_hist, 0);
+
+	return 0;
+}
+
+RTE_INIT(service_telemetry)
+{
+	rte_telemetry_register_cmd("/eal/service/list", handle_service_list,
+		"List of service ids. Takes no parameters");
+	rte_telemetry_register_cmd("/eal/service/info", handle_service_info,
+		"Returns service info and statistics. Parameters: int service_id");
+}
+#endif /* !RTE_EXEC_ENV_WINDOWS */
@@ -26,6 +26,7 @@
 #include<stdio.h>
 #include <stdint.h>
 
+#include <rte_compat.h>
 #include <rte_config.h>
 #include <rte_lcore.h>
 
@@ -400,6 +401,14 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_ERROR_CALL_COUNT 3
 
+/**
+ * Returns the number of invocations of this service function which took
+ * place after the deadline set in the service run policy had expired.
+ *
+ * @see rte_service_run_policy_set()
+ */
+#define RTE_SERVICE_ATTR_DEADLINE_MISS_COUNT 4
+
 /**
  * Get an attribute from a service.
  *
@@ -430,6 +439,29 @@ int32_t rte_service_attr_reset_all(uint32_t id);
  */
 #define RTE_SERVICE_LCORE_ATTR_CYCLES 1
 
+/**
+ * Returns the total number of deadline misses of the services run by
+ * the lcore.
+ *
+ * @see RTE_SERVICE_ATTR_DEADLINE_MISS_COUNT
+ */
+#define RTE_SERVICE_LCORE_ATTR_DEADLINE_MISSES 2
+
+/**
+ * Returns the number of times the lcore went to sleep because none of
+ * its services had any work.
+ *
+ * @see rte_service_lcore_idle_policy_set()
+ */
+#define RTE_SERVICE_LCORE_ATTR_SLEEPS 3
+
+/**
+ * Returns the total number of cycles the lcore has spent sleeping.
+ *
+ * @see rte_service_lcore_idle_policy_set()
+ */
+#define RTE_SERVICE_LCORE_ATTR_SLEEP_CYCLES 4
+
 /**
  * Get an attribute from a service core.
  *
@@ -455,6 +487,187 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 int32_t
 rte_service_lcore_attr_reset_all(uint32_t lcore);
 
+/**
+ * Run policy of a service.
+ *
+ * The run policy controls how a service lcore shares its time between
+ * the services mapped to it. With the default policy, a service lcore
+ * invokes each of its services once per loop, in service id order.
+ *
+ * @see rte_service_run_policy_set()
+ */
+struct rte_service_run_policy {
+	/** Maximum number of back-to-back invocations of the service
+	 * function per service lcore loop. The service lcore moves on to
+	 * the next service as soon as the service reports having no work
+	 * (i.e., returns -EAGAIN), so a weight larger than one acts as a
+	 * "run until idle" budget. Zero is treated as one.
+	 */
+	uint32_t weight;
+	/** Maximum time, in nanoseconds, the service should go without
+	 * being invoked. Once half of this time has elapsed since its last
+	 * invocation, the service is run ahead of the other services of
+	 * the lcore, in earliest deadline first order. Zero disables
+	 * deadline scheduling for the service.
+	 */
+	uint64_t deadline_ns;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the run policy of a service.
+ *
+ * The policy applies to all service lcores the service is mapped to,
+ * and to rte_service_run_iter_on_app_lcore(). It may be changed while
+ * the service is running.
+ *
+ * @param id The id of the service.
+ * @param policy The run policy to apply.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id or NULL policy provided
+ */
+__rte_experimental
+int32_t
+rte_service_run_policy_set(uint32_t id,
+			   const struct rte_service_run_policy *policy);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the run policy of a service.
+ *
+ * @param id The id of the service.
+ * @param [out] policy Pointer to storage in which to write the policy.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id or NULL policy provided
+ */
+__rte_experimental
+int32_t
+rte_service_run_policy_get(uint32_t id, struct rte_service_run_policy *policy);
+
+/** Number of buckets in a service cycles histogram. */
+#define RTE_SERVICE_CYCLES_HIST_BUCKETS 32
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the histogram of cycles spent per invocation of a service on
+ * a service lcore.
+ *
+ * Bucket *i* counts the non-idle invocations which took between 2^i and
+ * 2^(i+1) - 1 cycles, except for bucket 0 which also counts invocations
+ * that took zero cycles, and the last bucket which also counts all
+ * longer invocations. Like the other cycle statistics, the histogram is
+ * only updated when statistics are enabled for the service.
+ *
+ * @param lcore Id of the service core.
+ * @param id The id of the service.
+ * @param [out] hist Array in which to write the bucket counters.
+ * @param n Number of elements in *hist*. At most
+ *          RTE_SERVICE_CYCLES_HIST_BUCKETS elements are written.
+ * @retval >=0 Number of buckets written to *hist*.
+ * @retval -EINVAL Invalid lcore, service id, or NULL *hist*.
+ * @retval -ENOTSUP lcore is not a service core.
+ */
+__rte_experimental
+int32_t
+rte_service_lcore_cycles_hist_get(uint32_t lcore, uint32_t id,
+				  uint64_t hist[], uint32_t n);
+
+/**
+ * Idle policy of a service lcore.
+ *
+ * A service lcore loop is idle when none of the services of the lcore
+ * did any work, that is when all of them returned -EAGAIN or could not
+ * be run. After a number of consecutive idle loops, the service lcore
+ * backs off: it first pauses between loops, then sleeps until it is
+ * woken up by rte_service_wakeup() or a timeout expires. The default
+ * policy never backs off.
+ *
+ * @see rte_service_lcore_idle_policy_set()
+ */
+struct rte_service_lcore_idle_policy {
+	/** Number of consecutive idle loops after which the lcore pauses
+	 * between loops. Zero disables pausing.
+	 */
+	uint32_t pause_loops;
+	/** Number of consecutive idle loops after which the lcore sleeps.
+	 * Zero disables sleeping.
+	 */
+	uint32_t sleep_loops;
+	/** Maximum duration of a sleep, in microseconds. It bounds the
+	 * latency of services which are not woken up explicitly, such as
+	 * those polling hardware. The sleep is also cut short to meet the
+	 * deadline of the services of the lcore, if any.
+	 */
+	uint32_t max_sleep_us;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the idle policy of a service lcore.
+ *
+ * Where supported by the CPU (see rte_cpu_get_intrinsics_support()),
+ * the lcore sleeps in an optimized power state using
+ * rte_power_monitor(), and rte_service_wakeup() wakes it up right away.
+ * Otherwise, the lcore sleeps in the OS for *max_sleep_us*.
+ *
+ * @param lcore Id of the service core.
+ * @param policy The idle policy to apply.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid lcore, NULL policy, or sleeping enabled with
+ *         a zero maximum sleep time.
+ * @retval -ENOTSUP lcore is not a service core.
+ */
+__rte_experimental
+int32_t
+rte_service_lcore_idle_policy_set(uint32_t lcore,
+		const struct rte_service_lcore_idle_policy *policy);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the idle policy of a service lcore.
+ *
+ * @param lcore Id of the service core.
+ * @param [out] policy Pointer to storage in which to write the policy.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid lcore or NULL policy.
+ * @retval -ENOTSUP lcore is not a service core.
+ */
+__rte_experimental
+int32_t
+rte_service_lcore_idle_policy_get(uint32_t lcore,
+		struct rte_service_lcore_idle_policy *policy);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Wake up the service lcores running a service, which may be sleeping
+ * because of their idle policy.
+ *
+ * Producers of work for a service, for example the enqueue side of a
+ * ring the service dequeues from, should call this function after
+ * making the work visible. It is cheap when no service lcore sleeps.
+ * Only the Ethernet Rx event adapter calls it in DPDK: the lcores running
+ * other services wake up when the maximum sleep time of their policy ends.
+ *
+ * @param id The id of the service.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id.
+ */
+__rte_experimental
+int32_t
+rte_service_wakeup(uint32_t id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -69,6 +69,14 @@ enum rte_trace_mode {
 	 * subsequent events shall not be recorded.
 	 */
 	RTE_TRACE_MODE_DISCARD,
+	/**
+	 * In this mode, a control thread continuously drains the trace
+	 * buffers to the trace directory, while the threads keep recording.
+	 * When the control thread is lagging and no space is left in a trace
+	 * buffer, the subsequent events are dropped and counted.
+	 * This mode can only be selected with the --trace-mode EAL parameter.
+	 */
+	RTE_TRACE_MODE_STREAM,
 };
 
 /**
@@ -89,6 +97,31 @@ void rte_trace_mode_set(enum rte_trace_mode mode);
 __rte_experimental
 enum rte_trace_mode rte_trace_mode_get(void);
 
+/**
+ * Trace streaming statistics.
+ */
+struct rte_trace_stream_stats {
+	uint64_t bytes; /**< Number of bytes written to the trace files. */
+	uint64_t drops; /**< Number of events dropped for lack of space. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Get the statistics of the trace streaming mode.
+ * The statistics cover all the threads that recorded events so far.
+ *
+ * @param[out] stats
+ *   Pointer to the structure to fill.
+ * @return
+ *   - 0: Success.
+ *   - (-EINVAL): Invalid stats pointer.
+ *   - (-ENOTSUP): Trace mode is not RTE_TRACE_MODE_STREAM.
+ */
+__rte_experimental
+int rte_trace_stream_stats_get(struct rte_trace_stream_stats *stats);
+
 /**
  * Enable/Disable a set of tracepoints based on globbing pattern.
  *
@@ -126,6 +159,10 @@ int rte_trace_regexp(const char *regex, bool enable);
  * By default, trace directory will be created at $HOME directory and this can
  * be overridden by --trace-dir EAL parameter.
  *
+ * In stream mode, only the parts of the trace buffers handed over by the
+ * threads are written, the parts being recorded are written when full, on
+ * thread exit or on rte_eal_cleanup().
+ *
  * @return
  *   - 0: Success.
  *   - <0 : Failure.
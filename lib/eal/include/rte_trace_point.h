@@ -240,6 +240,25 @@ __rte_trace_point_fp_is_enabled(void)
 __rte_experimental
 void __rte_trace_mem_per_thread_alloc(void);
 
+struct __rte_trace_header;
+
+/**
+ * @internal
+ *
+ * Hand the filled part of the trace memory buffer of the thread over to the
+ * streaming thread, and move to the next free part of the buffer.
+ *
+ * @param trace
+ *   The trace memory buffer of the thread.
+ * @param sz
+ *   The size of the trace event to record.
+ * @return
+ *   - 0: Success.
+ *   - <0: No space left, the event must be dropped.
+ */
+__rte_experimental
+int __rte_trace_mem_stream_next(struct __rte_trace_header *trace, uint32_t sz);
+
 /**
  * @internal
  *
@@ -292,6 +311,7 @@ int __rte_trace_point_register(rte_trace_point_t *trace, const char *name,
 #define __RTE_TRACE_FIELD_ID_MASK (0xffffULL << __RTE_TRACE_FIELD_ID_SHIFT)
 #define __RTE_TRACE_FIELD_ENABLE_MASK (1ULL << 63)
 #define __RTE_TRACE_FIELD_ENABLE_DISCARD (1ULL << 62)
+#define __RTE_TRACE_FIELD_ENABLE_STREAM (1ULL << 61)
 
 struct __rte_trace_stream_header {
 	uint32_t magic;
@@ -326,11 +346,18 @@ __rte_trace_mem_get(uint64_t in)
 	/* Check the wrap around case */
 	uint32_t offset = trace->offset;
 	if (unlikely((offset + sz) >= trace->len)) {
-		/* Disable the trace event if it in DISCARD mode */
-		if (unlikely(in & __RTE_TRACE_FIELD_ENABLE_DISCARD))
-			return NULL;
-
-		offset = 0;
+		/* Hand the buffer over to the streaming thread in STREAM mode */
+		if (unlikely(in & __RTE_TRACE_FIELD_ENABLE_STREAM)) {
+			if (__rte_trace_mem_stream_next(trace, sz) != 0)
+				return NULL;
+			offset = trace->offset;
+		} else {
+			/* Disable the trace event if it in DISCARD mode */
+			if (unlikely(in & __RTE_TRACE_FIELD_ENABLE_DISCARD))
+				return NULL;
+
+			offset = 0;
+		}
 	}
 	/* Align to event header size */
 	offset = RTE_ALIGN_CEIL(offset, __RTE_TRACE_EVENT_HEADER_SZ);
@@ -197,6 +197,14 @@ __rte_trace_mem_per_thread_alloc(void)
 {
 }
 
+int
+__rte_trace_mem_stream_next(struct __rte_trace_header *trace, uint32_t sz)
+{
+	RTE_SET_USED(trace);
+	RTE_SET_USED(sz);
+	return -ENOTSUP;
+}
+
 void
 trace_mem_per_thread_free(void)
 {
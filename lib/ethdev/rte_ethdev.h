@@ -3400,6 +3400,34 @@ int rte_eth_xstats_get_id_by_name(uint16_t port_id, const char *xstat_name,
  */
 int rte_eth_xstats_reset(uint16_t port_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Export the extended statistics of an Ethernet device
+ * in the telemetry shared memory.
+ *
+ * On first call, a block named after the device is registered
+ * with rte_telemetry_shm_register(), with a counter per extended statistic.
+ * Each call then copies the current values of the extended statistics
+ * to this block, where external readers get them without any request
+ * to the application.
+ * When another device got the port, the block of the previous device
+ * is removed, and a block named after the new device is registered.
+ * The application calls it periodically, from a single thread per port.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @return
+ *   - (0) if successful.
+ *   - (-ENODEV) if *port_id* invalid.
+ *   - (-ENOMEM) on memory allocation failure.
+ *   - (-ENOSPC) if the telemetry shared memory is full.
+ *   - (<0): Error code of the driver xstats functions.
+ */
+__rte_experimental
+int rte_eth_xstats_shm_update(uint16_t port_id);
+
 /**
  *  Set a mapping for the specified transmit queue to the specified per-queue
  *  statistics counter.
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 
 #include <rte_kvargs.h>
+#include <rte_string_fns.h>
 #include <rte_telemetry.h>
 
 #include "rte_ethdev.h"
@@ -192,6 +193,80 @@ eth_dev_handle_port_xstats(const char *cmd __rte_unused,
 	return 0;
 }
 
+/* Shared memory block of the extended statistics of each port */
+static struct {
+	int block; /* block identifier + 1, 0 if not registered */
+	unsigned int num;
+	char name[RTE_ETH_NAME_MAX_LEN];
+} eth_xstats_shm[RTE_MAX_ETHPORTS];
+
+int
+rte_eth_xstats_shm_update(uint16_t port_id)
+{
+	struct rte_eth_xstat_name *xstat_names;
+	struct rte_eth_xstat *eth_xstats;
+	const char **names;
+	uint64_t *values;
+	const char *dev_name;
+	int num_xstats;
+	int i, ret;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+	dev_name = rte_eth_devices[port_id].data->name;
+
+	num_xstats = rte_eth_xstats_get(port_id, NULL, 0);
+	if (num_xstats <= 0)
+		return num_xstats;
+
+	/* use one malloc for the stats, names and values */
+	eth_xstats = malloc((sizeof(struct rte_eth_xstat) +
+			sizeof(struct rte_eth_xstat_name) + sizeof(char *) +
+			sizeof(uint64_t)) * num_xstats);
+	if (eth_xstats == NULL)
+		return -ENOMEM;
+	xstat_names = (void *)&eth_xstats[num_xstats];
+	names = (void *)&xstat_names[num_xstats];
+	values = (void *)&names[num_xstats];
+
+	ret = rte_eth_xstats_get(port_id, eth_xstats, num_xstats);
+	if (ret < 0)
+		goto out;
+	num_xstats = RTE_MIN(ret, num_xstats);
+
+	/* register on first use, or when another device got the port */
+	if (eth_xstats_shm[port_id].block == 0 ||
+			strcmp(eth_xstats_shm[port_id].name, dev_name) != 0) {
+		ret = rte_eth_xstats_get_names(port_id, xstat_names, num_xstats);
+		if (ret < 0)
+			goto out;
+		num_xstats = RTE_MIN(ret, num_xstats);
+		for (i = 0; i < num_xstats; i++)
+			names[i] = xstat_names[i].name;
+
+		/* the previous device of the port is gone */
+		if (eth_xstats_shm[port_id].block != 0) {
+			rte_telemetry_shm_unregister(
+				eth_xstats_shm[port_id].block - 1);
+			eth_xstats_shm[port_id].block = 0;
+		}
+		ret = rte_telemetry_shm_register(dev_name, names, num_xstats);
+		if (ret < 0)
+			goto out;
+		eth_xstats_shm[port_id].block = ret + 1;
+		eth_xstats_shm[port_id].num = num_xstats;
+		strlcpy(eth_xstats_shm[port_id].name, dev_name,
+			sizeof(eth_xstats_shm[port_id].name));
+	}
+
+	for (i = 0; i < num_xstats; i++)
+		values[i] = eth_xstats[i].value;
+	ret = rte_telemetry_shm_update(eth_xstats_shm[port_id].block - 1, values,
+		RTE_MIN((unsigned int)num_xstats, eth_xstats_shm[port_id].num));
+out:
+	free(eth_xstats);
+	return ret;
+}
+
 #ifndef RTE_EXEC_ENV_WINDOWS
 static int
 eth_dev_handle_port_dump_priv(const char *cmd __rte_unused,
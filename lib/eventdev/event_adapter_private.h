@@ -0,0 +1,9 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef _EVENT_ADAPTER_PRIVATE_H_
+#define _EVENT_ADAPTER_PRIVATE_H_
+
+/* Convert a duration in ns to the cycles of a timer of frequency __freq */
+#define NSEC2TICK(__ns, __freq) (((__ns) * (__freq)) / 1E9)
+
+#endif /* _EVENT_ADAPTER_PRIVATE_H_ */
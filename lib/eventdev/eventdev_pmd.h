@@ -552,6 +552,22 @@ typedef int (*eventdev_dequeue_timeout_ticks_t)(struct rte_eventdev *dev,
  */
 typedef void (*eventdev_dump_t)(struct rte_eventdev *dev, FILE *f);
 
+/**
+ * Get the IDs of the services running the event device scheduler
+ *
+ * @param dev
+ *   Event device pointer
+ * @param[out] service_ids
+ *   Array to be filled in with up to *n* service IDs
+ * @param n
+ *   Number of elements in the *service_ids* array
+ *
+ * @return
+ *   The number of services of the device, possibly greater than *n*.
+ */
+typedef int (*eventdev_service_ids_get_t)(const struct rte_eventdev *dev,
+		uint32_t service_ids[], uint32_t n);
+
 /**
  * Retrieve a set of statistics from device
  *
@@ -1668,6 +1684,9 @@ struct eventdev_ops {
 
 	eventdev_stop_flush_t dev_stop_flush;
 	/**< User-provided event flush function */
+
+	eventdev_service_ids_get_t service_ids_get;
+	/**< Get the IDs of the scheduler services */
 };
 
 /**
@@ -373,6 +373,14 @@ RTE_TRACE_POINT(
 	rte_trace_point_emit_u32(service_id);
 )
 
+RTE_TRACE_POINT(
+	rte_eventdev_trace_service_ids_get,
+	RTE_TRACE_POINT_ARGS(uint8_t dev_id, uint32_t n, int count),
+	rte_trace_point_emit_u8(dev_id);
+	rte_trace_point_emit_u32(n);
+	rte_trace_point_emit_int(count);
+)
+
 RTE_TRACE_POINT(
 	rte_eventdev_trace_socket_id,
 	RTE_TRACE_POINT_ARGS(uint8_t dev_id, const void *dev, int socket_id),
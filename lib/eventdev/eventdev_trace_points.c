@@ -161,6 +161,9 @@ RTE_TRACE_POINT_REGISTER(rte_eventdev_trace_info_get,
 RTE_TRACE_POINT_REGISTER(rte_eventdev_trace_service_id_get,
 	lib.eventdev.service_id_get)
 
+RTE_TRACE_POINT_REGISTER(rte_eventdev_trace_service_ids_get,
+	lib.eventdev.service_ids_get)
+
 RTE_TRACE_POINT_REGISTER(rte_eventdev_trace_socket_id,
 	lib.eventdev.socket.id)
 
@@ -6,6 +6,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <dev_driver.h>
 #include <rte_errno.h>
 #include <rte_cryptodev.h>
@@ -17,6 +18,7 @@
 #include "rte_eventdev.h"
 #include "eventdev_pmd.h"
 #include "eventdev_trace.h"
+#include "event_adapter_private.h"
 #include "rte_event_crypto_adapter.h"
 
 #define BATCH_SIZE 32
@@ -40,6 +42,20 @@
  */
 #define CRYPTO_ENQ_FLUSH_THRESHOLD 1024
 
+/* A queue pair found empty skips up to (1 << CRYPTO_DEQ_IDLE_SHIFT_MAX) - 1
+ * dequeue polls, the number of skipped polls doubles on each empty poll
+ */
+#define CRYPTO_DEQ_IDLE_SHIFT_MAX 4
+
+/* Number of crypto ops in flight in ordered completion mode */
+#define CRYPTO_ADAPTER_ROB_SZ 4096
+
+/* Reorder buffer slot of a dropped crypto op, skipped on release */
+#define CRYPTO_ADAPTER_ROB_SKIP ((struct rte_crypto_op *)(uintptr_t)1)
+
+/* Queue pair of a reorder buffer slot */
+#define ECA_ROB_QP(cdev_id, qp_id) ((uint32_t)(cdev_id) << 16 | (qp_id))
+
 #define ECA_ADAPTER_ARRAY "crypto_adapter_array"
 
 struct __rte_cache_aligned crypto_ops_circular_buffer {
@@ -98,6 +114,22 @@ struct __rte_cache_aligned event_crypto_adapter {
 	uint16_t nb_qps;
 	/* Adapter mode */
 	enum rte_event_crypto_adapter_mode mode;
+	/* Set when crypto ops are buffered for a cryptodev */
+	bool enq_pending;
+	/* Timestamp of the first check of the buffered crypto ops */
+	uint64_t enq_pending_ts;
+	/* Latency budget of the buffered crypto ops in timer cycles */
+	uint64_t enq_flush_ticks;
+	/* Latency budget of the buffered crypto ops in ns */
+	uint32_t enq_flush_timeout_ns;
+	/* Reorder buffer, set in ordered completion mode */
+	struct rte_crypto_op **rob;
+	/* Queue pair of each reorder buffer slot, see ECA_ROB_QP */
+	uint32_t *rob_qp;
+	/* Sequence number of the next crypto op to release */
+	uint32_t rob_head;
+	/* Sequence number of the next crypto op to enqueue */
+	uint32_t rob_tail;
 };
 
 /* Per crypto device information */
@@ -126,6 +158,10 @@ struct __rte_cache_aligned crypto_queue_pair_info {
 	bool qp_enabled;
 	/* Circular buffer for batching crypto ops to cdev */
 	struct crypto_ops_circular_buffer cbuf;
+	/* log2 of the number of polls to skip after an empty poll */
+	uint8_t deq_idle_shift;
+	/* Number of dequeue polls left to skip */
+	uint8_t deq_skip;
 };
 
 static struct event_crypto_adapter **event_crypto_adapter;
@@ -160,6 +196,27 @@ eca_dynfield_register(void)
 	return eca_dynfield_offset;
 }
 
+#define ECA_SEQN_DYNFIELD_NAME "eca_seqn_dynfield"
+/* Sequence number of a crypto op in ordered completion mode */
+typedef uint32_t eca_seqn_t;
+
+static int eca_seqn_dynfield_offset = -1;
+
+static int
+eca_seqn_dynfield_register(void)
+{
+	static const struct rte_mbuf_dynfield eca_seqn_dynfield_desc = {
+		.name = ECA_SEQN_DYNFIELD_NAME,
+		.size = sizeof(eca_seqn_t),
+		.align = alignof(eca_seqn_t),
+		.flags = 0,
+	};
+
+	eca_seqn_dynfield_offset =
+		rte_mbuf_dynfield_register(&eca_seqn_dynfield_desc);
+	return eca_seqn_dynfield_offset;
+}
+
 static inline int
 eca_valid_id(uint8_t id)
 {
@@ -485,6 +542,7 @@ rte_event_crypto_adapter_free(uint8_t id)
 	rte_eventdev_trace_crypto_adapter_free(id, adapter);
 	if (adapter->default_cb_arg)
 		rte_free(adapter->conf_arg);
+	rte_free(adapter->rob);
 	rte_free(adapter->cdevs);
 	rte_free(adapter);
 	event_crypto_adapter[id] = NULL;
@@ -547,7 +605,20 @@ eca_enq_to_cryptodev(struct event_crypto_adapter *adapter, struct rte_event *ev,
 			rte_crypto_op_free(crypto_op);
 			continue;
 		}
+
+		/* The crypto op can't be dropped anymore, number it */
+		if (adapter->rob != NULL &&
+		    crypto_op->type == RTE_CRYPTO_OP_TYPE_SYMMETRIC) {
+			adapter->rob_qp[adapter->rob_tail &
+					(CRYPTO_ADAPTER_ROB_SZ - 1)] =
+				ECA_ROB_QP(cdev_id, qp_id);
+			*RTE_MBUF_DYNFIELD(crypto_op->sym->m_src,
+					eca_seqn_dynfield_offset,
+					eca_seqn_t *) = adapter->rob_tail++;
+		}
+
 		eca_circular_buffer_add(&qp_info->cbuf, crypto_op);
+		adapter->enq_pending = true;
 
 		if (eca_circular_buffer_batch_ready(&qp_info->cbuf)) {
 			ret = eca_circular_buffer_flush_to_cdev(&qp_info->cbuf,
@@ -556,6 +627,10 @@ eca_enq_to_cryptodev(struct event_crypto_adapter *adapter, struct rte_event *ev,
 								&nb_enqueued);
 			stats->crypto_enq_count += nb_enqueued;
 			n += nb_enqueued;
+			if (nb_enqueued) {
+				qp_info->deq_skip = 0;
+				qp_info->deq_idle_shift = 0;
+			}
 
 			/**
 			 * If some crypto ops failed to flush to cdev and
@@ -595,6 +670,10 @@ eca_crypto_cdev_flush(struct event_crypto_adapter *adapter,
 						  cdev_id,
 						  qp,
 						  &nb_enqueued);
+		if (nb_enqueued) {
+			curr_queue->deq_skip = 0;
+			curr_queue->deq_idle_shift = 0;
+		}
 		*nb_ops_flushed += curr_queue->cbuf.count;
 		nb += nb_enqueued;
 	}
@@ -619,8 +698,11 @@ eca_crypto_enq_flush(struct event_crypto_adapter *adapter)
 	 * Enable dequeue from eventdev if all ops from circular
 	 * buffer flushed to cdev
 	 */
-	if (!nb_ops_flushed)
+	if (!nb_ops_flushed) {
 		adapter->stop_enq_to_cryptodev = false;
+		adapter->enq_pending = false;
+		adapter->enq_pending_ts = 0;
+	}
 
 	stats->crypto_enq_count += nb_enqueued;
 
@@ -651,6 +733,12 @@ eca_crypto_adapter_enq_run(struct event_crypto_adapter *adapter,
 				break;
 		}
 
+		/* No room in the reorder buffer for another batch */
+		if (adapter->rob != NULL &&
+		    adapter->rob_tail - adapter->rob_head >
+		    CRYPTO_ADAPTER_ROB_SZ - BATCH_SIZE)
+			break;
+
 		stats->event_poll_count++;
 		n = rte_event_dequeue_burst(event_dev_id,
 					    event_port_id, ev, BATCH_SIZE, 0);
@@ -666,6 +754,20 @@ eca_crypto_adapter_enq_run(struct event_crypto_adapter *adapter,
 		nb_enqueued += eca_crypto_enq_flush(adapter);
 	}
 
+	/* Flush the partially filled batches which exceed the budget */
+	if (adapter->enq_flush_ticks && adapter->enq_pending) {
+		uint64_t now = rte_get_timer_cycles();
+
+		if (adapter->enq_pending_ts == 0) {
+			adapter->enq_pending_ts = now;
+		} else if (now - adapter->enq_pending_ts >=
+			   adapter->enq_flush_ticks) {
+			nb_enqueued += eca_crypto_enq_flush(adapter);
+			if (adapter->enq_pending)
+				adapter->enq_pending_ts = now;
+		}
+	}
+
 	return nb_enqueued;
 }
 
@@ -775,6 +877,71 @@ eca_ops_buffer_flush(struct event_crypto_adapter *adapter)
 						  &adapter->ebuf))
 		;
 }
+
+/* Move the numbered crypto ops to the reorder buffer, the others are
+ * compacted at the start of ops. Returns the number of the others.
+ * A crypto op completed after the deletion of its queue pair is freed,
+ * its sequence number has been skipped.
+ */
+static inline uint16_t
+eca_rob_insert(struct event_crypto_adapter *adapter,
+	       struct rte_crypto_op **ops, uint16_t num)
+{
+	struct rte_crypto_op **slot;
+	eca_seqn_t seqn;
+	uint16_t i, n;
+
+	for (i = 0, n = 0; i < num; i++) {
+		if (ops[i]->type != RTE_CRYPTO_OP_TYPE_SYMMETRIC) {
+			ops[n++] = ops[i];
+			continue;
+		}
+
+		seqn = *RTE_MBUF_DYNFIELD(ops[i]->sym->m_src,
+					  eca_seqn_dynfield_offset,
+					  eca_seqn_t *);
+		slot = &adapter->rob[seqn & (CRYPTO_ADAPTER_ROB_SZ - 1)];
+		if (seqn - adapter->rob_head >=
+		    adapter->rob_tail - adapter->rob_head || *slot != NULL) {
+			rte_pktmbuf_free(ops[i]->sym->m_src);
+			rte_crypto_op_free(ops[i]);
+			continue;
+		}
+		*slot = ops[i];
+	}
+
+	return n;
+}
+
+/* Enqueue the in order crypto ops at the head of the reorder buffer */
+static void
+eca_rob_release(struct event_crypto_adapter *adapter)
+{
+	struct rte_crypto_op *ops[BATCH_SIZE];
+	struct rte_crypto_op **slot;
+	uint16_t n, nb_enqueued, i;
+
+	/* Crypto ops left in the event buffer go first */
+	while (adapter->ebuf.count == 0) {
+		for (n = 0; n < BATCH_SIZE; adapter->rob_head++) {
+			slot = &adapter->rob[adapter->rob_head &
+					     (CRYPTO_ADAPTER_ROB_SZ - 1)];
+			if (*slot == NULL)
+				break;
+			if (*slot != CRYPTO_ADAPTER_ROB_SKIP)
+				ops[n++] = *slot;
+			*slot = NULL;
+		}
+
+		if (n == 0)
+			break;
+
+		nb_enqueued = eca_ops_enqueue_burst(adapter, ops, n);
+		for (i = nb_enqueued; i < n; i++)
+			eca_circular_buffer_add(&adapter->ebuf, ops[i]);
+	}
+}
+
 static inline unsigned int
 eca_crypto_adapter_deq_run(struct event_crypto_adapter *adapter,
 			   unsigned int max_deq)
@@ -783,7 +950,7 @@ eca_crypto_adapter_deq_run(struct event_crypto_adapter *adapter,
 	struct crypto_device_info *curr_dev;
 	struct crypto_queue_pair_info *curr_queue;
 	struct rte_crypto_op *ops[BATCH_SIZE];
-	uint16_t n, nb_deq, nb_enqueued, i;
+	uint16_t n, nb_deq, nb_enqueued, nb_ev, i;
 	struct rte_cryptodev *dev;
 	uint8_t cdev_id;
 	uint16_t qp, dev_qps;
@@ -792,6 +959,8 @@ eca_crypto_adapter_deq_run(struct event_crypto_adapter *adapter,
 
 	nb_deq = 0;
 	eca_ops_buffer_flush(adapter);
+	if (adapter->rob != NULL)
+		eca_rob_release(adapter);
 
 	do {
 		done = true;
@@ -816,30 +985,46 @@ eca_crypto_adapter_deq_run(struct event_crypto_adapter *adapter,
 				    !curr_queue->qp_enabled))
 					continue;
 
+				/* Back off from the idle queue pairs */
+				if (curr_queue->deq_skip) {
+					curr_queue->deq_skip--;
+					continue;
+				}
+
 				n = rte_cryptodev_dequeue_burst(cdev_id, qp,
 					ops, BATCH_SIZE);
-				if (!n)
+				if (!n) {
+					if (curr_queue->deq_idle_shift <
+					    CRYPTO_DEQ_IDLE_SHIFT_MAX)
+						curr_queue->deq_idle_shift++;
+					curr_queue->deq_skip =
+						(1 << curr_queue->deq_idle_shift) - 1;
 					continue;
+				}
 
+				curr_queue->deq_idle_shift = 0;
 				done = false;
 				nb_enqueued = 0;
 
 				stats->crypto_deq_count += n;
 
-				if (unlikely(!adapter->ebuf.count))
-					nb_enqueued = eca_ops_enqueue_burst(
-							adapter, ops, n);
+				nb_ev = n;
+				if (adapter->rob != NULL)
+					nb_ev = eca_rob_insert(adapter, ops, n);
 
-				if (likely(nb_enqueued == n))
-					goto check;
+				if (unlikely(!adapter->ebuf.count) && nb_ev)
+					nb_enqueued = eca_ops_enqueue_burst(
+							adapter, ops, nb_ev);
 
 				/* Failed to enqueue events case */
-				for (i = nb_enqueued; i < n; i++)
+				for (i = nb_enqueued; i < nb_ev; i++)
 					eca_circular_buffer_add(
 						&adapter->ebuf,
 						ops[i]);
 
-check:
+				if (adapter->rob != NULL)
+					eca_rob_release(adapter);
+
 				nb_deq += n;
 
 				if (nb_deq >= max_deq) {
@@ -997,6 +1182,99 @@ eca_update_qp_info(struct event_crypto_adapter *adapter,
 	}
 }
 
+/* Free a crypto op of a deleted queue pair */
+static void
+eca_op_drop(struct rte_crypto_op *op)
+{
+	if (op->type == RTE_CRYPTO_OP_TYPE_SYMMETRIC)
+		rte_pktmbuf_free(op->sym->m_src);
+	rte_crypto_op_free(op);
+}
+
+/* Drop the crypto ops buffered for a queue pair being deleted and the ones
+ * completed by the cryptodev, they won't be dequeued anymore.
+ * In ordered completion mode, all the outstanding sequence numbers of the
+ * queue pair are skipped, including the ones of the crypto ops still
+ * processed by the cryptodev.
+ */
+static void
+eca_qp_ops_drop(struct event_crypto_adapter *adapter,
+		struct crypto_device_info *dev_info, uint16_t qp_id)
+{
+	struct crypto_queue_pair_info *qp_info;
+	struct crypto_ops_circular_buffer *bufp;
+	struct rte_crypto_op *ops[BATCH_SIZE];
+	uint32_t owner, seqn, idx;
+	uint16_t n, i;
+
+	if (dev_info->qpairs == NULL)
+		return;
+
+	qp_info = &dev_info->qpairs[qp_id];
+	if (!qp_info->qp_enabled)
+		return;
+
+	bufp = &qp_info->cbuf;
+
+	while (bufp->count) {
+		eca_op_drop(bufp->op_buffer[bufp->head]);
+		bufp->head = (bufp->head + 1) % bufp->size;
+		bufp->count--;
+	}
+
+	do {
+		n = rte_cryptodev_dequeue_burst(dev_info->dev->data->dev_id,
+						qp_id, ops, BATCH_SIZE);
+		for (i = 0; i < n; i++)
+			eca_op_drop(ops[i]);
+	} while (n);
+
+	if (adapter->rob == NULL)
+		return;
+
+	owner = ECA_ROB_QP(dev_info->dev->data->dev_id, qp_id);
+	for (seqn = adapter->rob_head; seqn != adapter->rob_tail; seqn++) {
+		idx = seqn & (CRYPTO_ADAPTER_ROB_SZ - 1);
+		if (adapter->rob[idx] == NULL && adapter->rob_qp[idx] == owner)
+			adapter->rob[idx] = CRYPTO_ADAPTER_ROB_SKIP;
+	}
+}
+
+/* Reset the reorder buffer once the last queue pair is deleted, the crypto
+ * ops held behind a sequence number that can't complete anymore are freed.
+ * The sequence numbers keep increasing, so that the crypto ops completed
+ * later are out of the reorder buffer window.
+ */
+static void
+eca_rob_reset(struct event_crypto_adapter *adapter)
+{
+	struct rte_crypto_op **slot;
+
+	for (; adapter->rob_head != adapter->rob_tail; adapter->rob_head++) {
+		slot = &adapter->rob[adapter->rob_head &
+				     (CRYPTO_ADAPTER_ROB_SZ - 1)];
+		if (*slot != NULL && *slot != CRYPTO_ADAPTER_ROB_SKIP) {
+			rte_pktmbuf_free((*slot)->sym->m_src);
+			rte_crypto_op_free(*slot);
+		}
+		*slot = NULL;
+	}
+}
+
+static void
+eca_qpairs_free(struct crypto_device_info *dev_info)
+{
+	uint16_t i;
+
+	if (dev_info->qpairs == NULL)
+		return;
+
+	for (i = 0; i < dev_info->dev->data->nb_queue_pairs; i++)
+		eca_circular_buffer_free(&dev_info->qpairs[i].cbuf);
+	rte_free(dev_info->qpairs);
+	dev_info->qpairs = NULL;
+}
+
 static int
 eca_add_queue_pair(struct event_crypto_adapter *adapter, uint8_t cdev_id,
 		   int queue_pair_id)
@@ -1016,13 +1294,15 @@ eca_add_queue_pair(struct event_crypto_adapter *adapter, uint8_t cdev_id,
 
 		qpairs = dev_info->qpairs;
 
-		if (eca_circular_buffer_init("eca_cdev_circular_buffer",
-					     &qpairs->cbuf,
-					     CRYPTO_ADAPTER_OPS_BUFFER_SZ)) {
-			RTE_EDEV_LOG_ERR("Failed to get memory for cryptodev "
-					 "buffer");
-			rte_free(qpairs);
-			return -ENOMEM;
+		for (i = 0; i < dev_info->dev->data->nb_queue_pairs; i++) {
+			if (eca_circular_buffer_init("eca_cdev_circular_buffer",
+						     &qpairs[i].cbuf,
+						     CRYPTO_ADAPTER_OPS_BUFFER_SZ)) {
+				RTE_EDEV_LOG_ERR("Failed to get memory for "
+						 "cryptodev buffer");
+				eca_qpairs_free(dev_info);
+				return -ENOMEM;
+			}
 		}
 	}
 
@@ -1243,10 +1523,8 @@ rte_event_crypto_adapter_queue_pair_del(uint8_t id, uint8_t cdev_id,
 					&adapter->cdevs[cdev_id],
 					queue_pair_id,
 					0);
-			if (dev_info->num_qpairs == 0) {
-				rte_free(dev_info->qpairs);
-				dev_info->qpairs = NULL;
-			}
+			if (dev_info->num_qpairs == 0)
+				eca_qpairs_free(dev_info);
 		}
 	} else {
 		if (adapter->nb_qps == 0)
@@ -1255,18 +1533,22 @@ rte_event_crypto_adapter_queue_pair_del(uint8_t id, uint8_t cdev_id,
 		rte_spinlock_lock(&adapter->lock);
 		if (queue_pair_id == -1) {
 			for (i = 0; i < dev_info->dev->data->nb_queue_pairs;
-				i++)
-				eca_update_qp_info(adapter, dev_info,
-							queue_pair_id, 0);
+				i++) {
+				eca_qp_ops_drop(adapter, dev_info, i);
+				eca_update_qp_info(adapter, dev_info, i, 0);
+			}
 		} else {
+			eca_qp_ops_drop(adapter, dev_info,
+					(uint16_t)queue_pair_id);
 			eca_update_qp_info(adapter, dev_info,
 						(uint16_t)queue_pair_id, 0);
 		}
 
-		if (dev_info->num_qpairs == 0) {
-			rte_free(dev_info->qpairs);
-			dev_info->qpairs = NULL;
-		}
+		if (dev_info->num_qpairs == 0)
+			eca_qpairs_free(dev_info);
+
+		if (adapter->nb_qps == 0 && adapter->rob != NULL)
+			eca_rob_reset(adapter);
 
 		rte_spinlock_unlock(&adapter->lock);
 		rte_service_component_runstate_set(adapter->service_id,
@@ -1466,11 +1748,25 @@ crypto_adapter_cap_check(struct event_crypto_adapter *adapter)
 	return 0;
 }
 
+static bool
+eca_adapter_started(struct event_crypto_adapter *adapter)
+{
+	uint32_t i;
+
+	for (i = 0; i < rte_cryptodev_count(); i++)
+		if (adapter->cdevs[i].dev_started)
+			return true;
+
+	return false;
+}
+
 int
 rte_event_crypto_adapter_runtime_params_set(uint8_t id,
 		struct rte_event_crypto_adapter_runtime_params *params)
 {
 	struct event_crypto_adapter *adapter;
+	struct rte_crypto_op **rob;
+	bool ordered;
 	int ret;
 
 	if (eca_memzone_lookup())
@@ -1491,8 +1787,59 @@ rte_event_crypto_adapter_runtime_params_set(uint8_t id,
 	if (ret)
 		return ret;
 
+	if (params->flags & ~RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED) {
+		RTE_EDEV_LOG_ERR("Invalid runtime flags %#" PRIx32,
+				 params->flags);
+		return -EINVAL;
+	}
+
+	rob = adapter->rob;
+	ordered = params->flags & RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED;
+	if (ordered != (adapter->rob != NULL)) {
+		if (ordered &&
+		    adapter->mode != RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD) {
+			RTE_EDEV_LOG_ERR("Ordered completion needs OP_FORWARD mode");
+			return -ENOTSUP;
+		}
+
+		if (eca_adapter_started(adapter)) {
+			RTE_EDEV_LOG_ERR("Adapter %" PRIu8 " is started", id);
+			return -EBUSY;
+		}
+
+		rob = NULL;
+		if (ordered) {
+			if (eca_seqn_dynfield_register() < 0) {
+				RTE_EDEV_LOG_ERR("Failed to register eca seqn mbuf dyn field");
+				return -rte_errno;
+			}
+
+			rob = rte_zmalloc_socket(adapter->mem_name,
+						 CRYPTO_ADAPTER_ROB_SZ *
+						 (sizeof(*rob) + sizeof(uint32_t)),
+						 RTE_CACHE_LINE_SIZE,
+						 adapter->socket_id);
+			if (rob == NULL)
+				return -ENOMEM;
+		}
+	}
+
 	rte_spinlock_lock(&adapter->lock);
 	adapter->max_nb = params->max_nb;
+	adapter->enq_flush_timeout_ns = params->enq_flush_timeout_ns;
+	adapter->enq_flush_ticks = 0;
+	if (params->enq_flush_timeout_ns)
+		adapter->enq_flush_ticks = RTE_MAX(1ULL,
+			(uint64_t)NSEC2TICK((uint64_t)params->enq_flush_timeout_ns,
+					    rte_get_timer_hz()));
+	if (rob != adapter->rob) {
+		rte_free(adapter->rob);
+		adapter->rob = rob;
+		adapter->rob_qp = rob != NULL ?
+			(uint32_t *)&rob[CRYPTO_ADAPTER_ROB_SZ] : NULL;
+		adapter->rob_head = 0;
+		adapter->rob_tail = 0;
+	}
 	rte_spinlock_unlock(&adapter->lock);
 
 	return 0;
@@ -1525,6 +1872,9 @@ rte_event_crypto_adapter_runtime_params_get(uint8_t id,
 		return ret;
 
 	params->max_nb = adapter->max_nb;
+	params->enq_flush_timeout_ns = adapter->enq_flush_timeout_ns;
+	params->flags = adapter->rob != NULL ?
+		RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED : 0;
 
 	return 0;
 }
@@ -277,10 +277,39 @@ struct rte_event_crypto_adapter_runtime_params {
 	 * RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_FWD or
 	 * RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_NEW capability.
 	 */
-	uint32_t rsvd[15];
+	uint32_t enq_flush_timeout_ns;
+	/**< Latency budget of the crypto ops buffered by the adapter for a
+	 * cryptodev queue pair. The adapter coalesces the crypto ops of a
+	 * queue pair until a batch is complete; a partially filled batch is
+	 * flushed to the cryptodev once it has waited enq_flush_timeout_ns.
+	 * Zero disables the budget, partially filled batches are then only
+	 * flushed periodically. Default value is zero.
+	 *
+	 * Only used in RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD mode, with the
+	 * same device capability restrictions as max_nb.
+	 */
+	uint32_t flags;
+	/**< Adapter runtime flags.
+	 * @see RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED
+	 */
+	uint32_t rsvd[13];
 	/**< Reserved fields for future expansion */
 };
 
+#define RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED	0x1
+/**< This flag indicates that the adapter enqueues the completed symmetric
+ * crypto operations to the event device in the order it dequeued their
+ * request events, whatever the order of completion of the cryptodev queue
+ * pairs. As the order of the request events of an atomic or ordered flow
+ * is preserved by the event device, this also preserves the per flow order
+ * when the crypto operations of a flow are spread over several queue pairs.
+ *
+ * Only valid in RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD mode. The flag can only
+ * be changed while the adapter is stopped, with no crypto operation in
+ * flight.
+ * @see rte_event_crypto_adapter_runtime_params::flags
+ */
+
 #define RTE_EVENT_CRYPTO_ADAPTER_EVENT_VECTOR	0x1
 /**< This flag indicates that crypto operations processed on the crypto
  * adapter need to be vectorized
@@ -523,6 +552,12 @@ rte_event_crypto_adapter_queue_pair_add(uint8_t id,
 /**
  * Delete a queue pair from an event crypto adapter.
  *
+ * With the service function based adapter, the crypto operations buffered
+ * for the queue pair and the ones already completed by the cryptodev are
+ * freed. In RTE_EVENT_CRYPTO_ADAPTER_RUNTIME_F_ORDERED mode, the following
+ * crypto operations are not held back by the freed ones nor by the ones
+ * still processed by the cryptodev, which are freed when they complete.
+ *
  * @param id
  *  Adapter identifier.
  *
@@ -27,6 +27,7 @@
 #include "rte_eventdev.h"
 #include "eventdev_pmd.h"
 #include "eventdev_trace.h"
+#include "event_adapter_private.h"
 #include "rte_event_eth_rx_adapter.h"
 
 #define BATCH_SIZE		32
@@ -38,6 +39,7 @@
 #define MIN_VECTOR_NS		1E5
 
 #define RXA_NB_RX_WORK_DEFAULT 128
+#define RXA_ADAPTIVE_IDLE_POLLS_DEFAULT 1024
 
 #define ETH_RX_ADAPTER_SERVICE_NAME_LEN	32
 #define ETH_RX_ADAPTER_MEM_NAME_LEN	32
@@ -70,6 +72,8 @@ struct eth_rx_poll_entry {
 	uint16_t eth_dev_id;
 	/* Eth rx queue to poll */
 	uint16_t eth_rx_qid;
+	/* Switches to interrupt mode when idle */
+	uint8_t adaptive;
 };
 
 struct __rte_cache_aligned eth_rx_vector_data {
@@ -128,6 +132,14 @@ struct __rte_cache_aligned event_eth_rx_adapter {
 	uint32_t wrr_len;
 	/* Next entry in wrr[] to begin polling */
 	uint32_t wrr_pos;
+	/* Length of the WRR sequence, without the parked adaptive queues */
+	uint32_t wrr_active_len;
+	/* Set when an adaptive queue is parked or woken up */
+	uint8_t wrr_rebuild;
+	/* Num of adaptive poll/interrupt queues */
+	uint32_t num_rx_adaptive;
+	/* Empty polls after which an adaptive queue is parked */
+	uint32_t adaptive_idle_polls;
 	/* Event burst buffer */
 	struct eth_event_enqueue_buffer event_enqueue_buffer;
 	/* Vector enable flag */
@@ -245,10 +257,16 @@ struct eth_rx_queue_info {
 	int queue_enabled;	/* True if added */
 	int intr_enabled;
 	uint8_t ena_vector;
+	uint8_t adaptive;	/* Parked in interrupt mode when idle */
+	uint8_t parked;		/* Left out of the WRR sequence */
+	uint32_t idle_polls;	/* Consecutive empty polls */
 	uint16_t wt;		/* Polling weight */
+	uint16_t nb_flow_vectors; /* Vectors keyed by flow hash if non zero */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
 	struct eth_rx_vector_data vector_data;
+	/* Per flow bucket vectors, indexed by the RSS hash */
+	struct eth_rx_vector_data *flow_vector_data;
 	struct eth_event_enqueue_buffer *event_buf;
 	/* use adapter stats struct for queue level stats,
 	 * as same stats need to be updated for adapter and queue
@@ -633,8 +651,11 @@ rxa_alloc_poll_arrays(struct event_eth_rx_adapter *rx_adapter, uint32_t nb_poll,
 	return 0;
 }
 
-/* Precalculate WRR polling sequence for all queues in rx_adapter */
-static void
+/* Precalculate WRR polling sequence for all queues in rx_adapter, the
+ * adaptive queues parked in interrupt mode are left out of the sequence.
+ * Returns the length of the sequence.
+ */
+static uint32_t
 rxa_calc_wrr_sequence(struct event_eth_rx_adapter *rx_adapter,
 		      struct eth_rx_poll_entry *rx_poll, uint32_t *rx_wrr)
 {
@@ -651,7 +672,7 @@ rxa_calc_wrr_sequence(struct event_eth_rx_adapter *rx_adapter,
 	uint16_t gcd = 0;
 
 	if (rx_poll == NULL)
-		return;
+		return 0;
 
 	/* Generate array of all queues to poll, the size of this
 	 * array is poll_q
@@ -674,10 +695,13 @@ rxa_calc_wrr_sequence(struct event_eth_rx_adapter *rx_adapter,
 			if (!rxa_polled_queue(dev_info, q))
 				continue;
 			wt = queue_info->wt;
+			dev_info->wrr_len += wt;
+			if (queue_info->parked)
+				continue;
 			rx_poll[poll_q].eth_dev_id = d;
 			rx_poll[poll_q].eth_rx_qid = q;
+			rx_poll[poll_q].adaptive = queue_info->adaptive;
 			max_wrr_pos += wt;
-			dev_info->wrr_len += wt;
 			max_wt = RTE_MAX(max_wt, wt);
 			gcd = (gcd) ? rxa_gcd_u16(gcd, wt) : wt;
 			poll_q++;
@@ -692,6 +716,19 @@ rxa_calc_wrr_sequence(struct event_eth_rx_adapter *rx_adapter,
 				     rx_poll, max_wt, gcd, prev);
 		prev = rx_wrr[i];
 	}
+
+	return max_wrr_pos;
+}
+
+/* Rebuild the WRR sequence around the adaptive queues not parked */
+static void
+rxa_wrr_rebuild(struct event_eth_rx_adapter *rx_adapter)
+{
+	rx_adapter->wrr_active_len = rxa_calc_wrr_sequence(rx_adapter,
+					rx_adapter->eth_rx_poll,
+					rx_adapter->wrr_sched);
+	rx_adapter->wrr_pos = 0;
+	rx_adapter->wrr_rebuild = 0;
 }
 
 static inline void
@@ -924,6 +961,60 @@ rxa_create_event_vector(struct event_eth_rx_adapter *rx_adapter,
 	return filled;
 }
 
+/* Aggregate the mbufs into the vectors of their flow bucket, a vector holds
+ * the mbufs of the flows sharing the RSS hash bits of its bucket. The bucket
+ * is picked by the high hash bits, as the low ones select the Rx queue in the
+ * RSS redirection table and are mostly the same for the mbufs of a queue.
+ */
+static inline uint16_t
+rxa_create_flow_event_vectors(struct event_eth_rx_adapter *rx_adapter,
+			      struct eth_rx_queue_info *queue_info,
+			      struct eth_event_enqueue_buffer *buf,
+			      struct rte_mbuf **mbufs, uint16_t num)
+{
+	struct rte_event *ev = &buf->events[buf->tail];
+	uint64_t nb_flow_vectors = queue_info->nb_flow_vectors;
+	struct eth_rx_vector_data *vec;
+	struct rte_event_vector *vector_ev;
+	uint16_t filled = 0;
+	uint64_t ts = rte_rdtsc();
+	uint32_t rss;
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+		struct rte_mbuf *m = mbufs[i];
+
+		rss = (m->ol_flags & RTE_MBUF_F_RX_RSS_HASH) ? m->hash.rss :
+			rxa_do_softrss(m, rx_adapter->rss_key_be);
+		vec = &queue_info->flow_vector_data[(rss * nb_flow_vectors) >> 32];
+
+		if (vec->vector_ev == NULL) {
+			if (rte_mempool_get(vec->vector_pool,
+					    (void **)&vec->vector_ev) < 0) {
+				rte_pktmbuf_free_bulk(&mbufs[i], num - i);
+				break;
+			}
+			rxa_init_vector(rx_adapter, vec);
+		}
+
+		vector_ev = vec->vector_ev;
+		vector_ev->mbufs[vector_ev->nb_elem++] = m;
+		vec->ts = ts;
+
+		if (vector_ev->nb_elem == vec->max_vector_count) {
+			/* Event ready. */
+			ev->event = vec->event;
+			ev->vec = vector_ev;
+			ev++;
+			filled++;
+			vec->vector_ev = NULL;
+			TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+		}
+	}
+
+	return filled;
+}
+
 static inline void
 rxa_buffer_mbufs(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 		 uint16_t rx_queue_id, struct rte_mbuf **mbufs, uint16_t num,
@@ -976,6 +1067,10 @@ rxa_buffer_mbufs(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 			ev->mbuf = m;
 			new_tail++;
 		}
+	} else if (eth_rx_queue_info->nb_flow_vectors) {
+		num = rxa_create_flow_event_vectors(rx_adapter,
+						    eth_rx_queue_info,
+						    buf, mbufs, num);
 	} else {
 		num = rxa_create_event_vector(rx_adapter, eth_rx_queue_info,
 					      buf, mbufs, num);
@@ -1160,7 +1255,8 @@ rxa_intr_ring_del_entries(struct event_eth_rx_adapter *rx_adapter,
  * After receiving an Rx interrupt, it enqueues the port id and queue id of the
  * interrupting queue to the adapter's ring buffer for interrupt events.
  * These events are picked up by rxa_intr_ring_dequeue() which is invoked from
- * the adapter service function.
+ * the adapter service function, the service lcores being woken up in case
+ * they sleep while the adapter is idle.
  */
 static uint32_t
 rxa_intr_thread(void *arg)
@@ -1179,11 +1275,60 @@ rxa_intr_thread(void *arg)
 			rxa_intr_ring_enqueue(rx_adapter,
 					epoll_events[i].epdata.data);
 		}
+		if (n > 0)
+			rte_service_wakeup(rx_adapter->service_id);
 	}
 
 	return 0;
 }
 
+/* Switch an idle adaptive queue to interrupt mode, it is left out of the
+ * WRR sequence until its interrupt is received.
+ */
+static void
+rxa_adaptive_park(struct event_eth_rx_adapter *rx_adapter, uint16_t port_id,
+		  uint16_t queue_id, struct eth_rx_queue_info *queue_info)
+{
+	int err;
+
+	rte_spinlock_lock(&rx_adapter->intr_ring_lock);
+	queue_info->intr_enabled = 1;
+	err = rte_eth_dev_rx_intr_enable(port_id, queue_id);
+	/* Packets received before the interrupt is enabled don't raise it */
+	if (err == 0 && rte_eth_rx_queue_count(port_id, queue_id) > 0) {
+		rte_eth_dev_rx_intr_disable(port_id, queue_id);
+		err = -EAGAIN;
+	}
+	if (err)
+		queue_info->intr_enabled = 0;
+	rte_spinlock_unlock(&rx_adapter->intr_ring_lock);
+
+	queue_info->idle_polls = 0;
+	if (err)
+		return;
+
+	queue_info->parked = 1;
+	rx_adapter->wrr_rebuild = 1;
+}
+
+/* Count the empty polls of an adaptive queue */
+static inline void
+rxa_adaptive_poll(struct event_eth_rx_adapter *rx_adapter, uint16_t port_id,
+		  uint16_t queue_id, bool idle)
+{
+	struct eth_rx_queue_info *queue_info;
+
+	queue_info = &rx_adapter->eth_devices[port_id].rx_queue[queue_id];
+	if (!idle) {
+		queue_info->idle_polls = 0;
+		return;
+	}
+
+	if (!queue_info->parked &&
+	    ++queue_info->idle_polls >= rx_adapter->adaptive_idle_polls)
+		rxa_adaptive_park(rx_adapter, port_id, queue_id, queue_info);
+}
+
 /* Dequeue <port, q> from interrupt ring and enqueue received
  * mbufs to eventdev
  */
@@ -1199,7 +1344,7 @@ rxa_intr_ring_dequeue(struct event_eth_rx_adapter *rx_adapter)
 	uint8_t max_done = 0;
 	bool work = false;
 
-	if (rx_adapter->num_rx_intr == 0)
+	if (rx_adapter->num_rx_intr == 0 && rx_adapter->num_rx_adaptive == 0)
 		return work;
 
 	if (rte_ring_count(rx_adapter->intr_ring) == 0
@@ -1238,15 +1383,25 @@ rxa_intr_ring_dequeue(struct event_eth_rx_adapter *rx_adapter)
 
 			port = qd.port;
 			queue = qd.queue;
+			dev_info = &rx_adapter->eth_devices[port];
+			queue_info = &dev_info->rx_queue[queue];
+			if (queue_info->adaptive) {
+				/* Back to polling, the interrupt thread has
+				 * disabled the interrupt.
+				 */
+				queue_info->parked = 0;
+				queue_info->idle_polls = 0;
+				rx_adapter->wrr_rebuild = 1;
+				rte_spinlock_unlock(ring_lock);
+				continue;
+			}
+
 			rx_adapter->qd = qd;
 			rx_adapter->qd_valid = 1;
-			dev_info = &rx_adapter->eth_devices[port];
 			if (rxa_shared_intr(dev_info, queue))
 				dev_info->shared_intr_enabled = 1;
-			else {
-				queue_info = &dev_info->rx_queue[queue];
+			else
 				queue_info->intr_enabled = 1;
-			}
 			rte_eth_dev_rx_intr_enable(port, queue);
 			rte_spinlock_unlock(ring_lock);
 		} else {
@@ -1328,17 +1483,22 @@ rxa_poll(struct event_eth_rx_adapter *rx_adapter)
 	struct eth_event_enqueue_buffer *buf = NULL;
 	struct rte_event_eth_rx_adapter_stats *stats = NULL;
 	uint32_t wrr_pos;
+	uint32_t wrr_len;
 	uint32_t max_nb_rx;
+	uint32_t n;
+	int rxq_empty;
 	bool work = false;
 
 	wrr_pos = rx_adapter->wrr_pos;
+	wrr_len = rx_adapter->wrr_active_len;
 	max_nb_rx = rx_adapter->max_nb_rx;
 
 	/* Iterate through a WRR sequence */
-	for (num_queue = 0; num_queue < rx_adapter->wrr_len; num_queue++) {
+	for (num_queue = 0; num_queue < wrr_len; num_queue++) {
 		unsigned int poll_idx = rx_adapter->wrr_sched[wrr_pos];
 		uint16_t qid = rx_adapter->eth_rx_poll[poll_idx].eth_rx_qid;
 		uint16_t d = rx_adapter->eth_rx_poll[poll_idx].eth_dev_id;
+		uint8_t adaptive = rx_adapter->eth_rx_poll[poll_idx].adaptive;
 
 		buf = rxa_event_buf_get(rx_adapter, d, qid, &stats);
 
@@ -1362,16 +1522,19 @@ rxa_poll(struct event_eth_rx_adapter *rx_adapter)
 			}
 		}
 
-		nb_rx += rxa_eth_rx(rx_adapter, d, qid, nb_rx, max_nb_rx,
-				NULL, buf, stats);
+		n = rxa_eth_rx(rx_adapter, d, qid, nb_rx, max_nb_rx,
+				adaptive ? &rxq_empty : NULL, buf, stats);
+		nb_rx += n;
+		if (unlikely(adaptive))
+			rxa_adaptive_poll(rx_adapter, d, qid,
+					  n == 0 && rxq_empty);
 		if (nb_rx > max_nb_rx) {
-			rx_adapter->wrr_pos =
-				    (wrr_pos + 1) % rx_adapter->wrr_len;
+			rx_adapter->wrr_pos = (wrr_pos + 1) % wrr_len;
 			break;
 		}
 
 poll_next_entry:
-		if (++wrr_pos == rx_adapter->wrr_len)
+		if (++wrr_pos == wrr_len)
 			wrr_pos = 0;
 	}
 
@@ -1441,6 +1604,8 @@ rxa_service_func(void *args)
 
 	intr_work = rxa_intr_ring_dequeue(rx_adapter);
 	poll_work = rxa_poll(rx_adapter);
+	if (unlikely(rx_adapter->wrr_rebuild))
+		rxa_wrr_rebuild(rx_adapter);
 
 	rte_spinlock_unlock(&rx_adapter->rx_lock);
 
@@ -1663,7 +1828,8 @@ rxa_free_intr_resources(struct event_eth_rx_adapter *rx_adapter)
 {
 	int ret;
 
-	if (rx_adapter->num_rx_intr == 0)
+	/* The adaptive queues still rely on the interrupt thread */
+	if (rx_adapter->num_rx_intr == 0 || rx_adapter->num_rx_adaptive != 0)
 		return 0;
 
 	ret = rxa_destroy_intr_thread(rx_adapter);
@@ -1902,6 +2068,114 @@ rxa_add_intr_queue(struct event_eth_rx_adapter *rx_adapter,
 	return err;
 }
 
+/* Register the Rx interrupt of an adaptive queue, the interrupt is enabled
+ * once the queue is idle.
+ */
+static int
+rxa_adaptive_add(struct event_eth_rx_adapter *rx_adapter,
+		 struct eth_device_info *dev_info, uint16_t rx_queue_id)
+{
+	struct eth_rx_queue_info *queue_info = &dev_info->rx_queue[rx_queue_id];
+	uint16_t eth_dev_id = dev_info->dev->data->port_id;
+	union queue_data qd;
+	int init_fd;
+	int err;
+
+	err = rxa_intr_ring_check_avail(rx_adapter, 1);
+	if (err)
+		return err;
+
+	init_fd = rx_adapter->epd;
+	err = rxa_init_epd(rx_adapter);
+	if (err)
+		return err;
+
+	qd.port = eth_dev_id;
+	qd.queue = rx_queue_id;
+
+	err = rte_eth_dev_rx_intr_ctl_q(eth_dev_id, rx_queue_id,
+					rx_adapter->epd,
+					RTE_INTR_EVENT_ADD,
+					qd.ptr);
+	if (err) {
+		RTE_EDEV_LOG_ERR("Failed to add interrupt event for"
+			" Rx Queue %u err %d", rx_queue_id, err);
+		goto err_del_fd;
+	}
+
+	err = rxa_create_intr_thread(rx_adapter);
+	if (err) {
+		rte_eth_dev_rx_intr_ctl_q(eth_dev_id, rx_queue_id,
+					  rx_adapter->epd,
+					  RTE_INTR_EVENT_DEL,
+					  0);
+		goto err_del_fd;
+	}
+
+	queue_info->adaptive = 1;
+	queue_info->parked = 0;
+	queue_info->idle_polls = 0;
+	queue_info->intr_enabled = 0;
+	rx_adapter->num_rx_adaptive++;
+	rx_adapter->num_intr_vec++;
+	return 0;
+
+err_del_fd:
+	if (init_fd == INIT_FD) {
+		close(rx_adapter->epd);
+		rx_adapter->epd = INIT_FD;
+	}
+
+	return err;
+}
+
+static void
+rxa_adaptive_del(struct event_eth_rx_adapter *rx_adapter,
+		 struct eth_device_info *dev_info, uint16_t rx_queue_id)
+{
+	struct eth_rx_queue_info *queue_info = &dev_info->rx_queue[rx_queue_id];
+	uint16_t eth_dev_id = dev_info->dev->data->port_id;
+	int err;
+
+	if (!queue_info->adaptive)
+		return;
+
+	rte_spinlock_lock(&rx_adapter->intr_ring_lock);
+	if (queue_info->intr_enabled)
+		rte_eth_dev_rx_intr_disable(eth_dev_id, rx_queue_id);
+	queue_info->intr_enabled = 0;
+	rte_spinlock_unlock(&rx_adapter->intr_ring_lock);
+
+	err = rte_eth_dev_rx_intr_ctl_q(eth_dev_id, rx_queue_id,
+					rx_adapter->epd,
+					RTE_INTR_EVENT_DEL,
+					0);
+	if (err)
+		RTE_EDEV_LOG_ERR("Interrupt event deletion failed %d", err);
+
+	rxa_intr_ring_del_entries(rx_adapter, dev_info, rx_queue_id);
+
+	queue_info->adaptive = 0;
+	queue_info->parked = 0;
+	rx_adapter->num_rx_adaptive--;
+	rx_adapter->num_intr_vec--;
+}
+
+/* Free the interrupt thread once neither the interrupt queues nor the
+ * adaptive queues rely on it.
+ */
+static void
+rxa_adaptive_free_intr_resources(struct event_eth_rx_adapter *rx_adapter)
+{
+	if (rx_adapter->num_rx_intr != 0 || rx_adapter->num_rx_adaptive != 0 ||
+	    rx_adapter->intr_ring == NULL)
+		return;
+
+	rxa_destroy_intr_thread(rx_adapter);
+	close(rx_adapter->epd);
+	rx_adapter->epd = INIT_FD;
+}
+
 static int
 rxa_init_service(struct event_eth_rx_adapter *rx_adapter, uint8_t id)
 {
@@ -1943,6 +2217,7 @@ rxa_init_service(struct event_eth_rx_adapter *rx_adapter, uint8_t id)
 	}
 	rx_adapter->event_port_id = rx_adapter_conf.event_port_id;
 	rx_adapter->max_nb_rx = rx_adapter_conf.max_nb_rx;
+	rx_adapter->adaptive_idle_polls = RXA_ADAPTIVE_IDLE_POLLS_DEFAULT;
 	rx_adapter->service_inited = 1;
 	rx_adapter->epd = INIT_FD;
 	return 0;
@@ -1986,7 +2261,6 @@ rxa_set_vector_data(struct eth_rx_queue_info *queue_info, uint16_t vector_count,
 		    uint64_t vector_ns, struct rte_mempool *mp, uint32_t qid,
 		    uint16_t port_id)
 {
-#define NSEC2TICK(__ns, __freq) (((__ns) * (__freq)) / 1E9)
 	struct eth_rx_vector_data *vector_data;
 	uint32_t flow_id;
 
@@ -2002,6 +2276,52 @@ rxa_set_vector_data(struct eth_rx_queue_info *queue_info, uint16_t vector_count,
 	flow_id =
 		flow_id == 0 ? (qid & 0xFFF) | (port_id & 0xFF) << 12 : flow_id;
 	vector_data->event = (queue_info->event & ~0xFFFFF) | flow_id;
+
+	/* The bucket index goes in the high flow ID bits, the vectors of
+	 * a flow always carry the same flow ID.
+	 */
+	if (queue_info->nb_flow_vectors) {
+		uint32_t shift = 20 - rte_log2_u32(queue_info->nb_flow_vectors);
+		uint32_t i;
+
+		for (i = 0; i < queue_info->nb_flow_vectors; i++) {
+			struct eth_rx_vector_data *vec =
+				&queue_info->flow_vector_data[i];
+
+			*vec = *vector_data;
+			vec->vector_ev = NULL;
+			vec->event = (vector_data->event & ~0xFFFFF) |
+				     ((flow_id ^ (i << shift)) & 0xFFFFF);
+		}
+	}
+}
+
+/* Push the partial flow bucket vectors and free them */
+static void
+rxa_flow_vectors_free(struct event_eth_rx_adapter *rx_adapter,
+		      struct eth_rx_queue_info *queue_info)
+{
+	struct eth_rx_vector_data *vec;
+	uint16_t i;
+
+	if (queue_info->flow_vector_data == NULL)
+		return;
+
+	for (i = 0; i < queue_info->nb_flow_vectors; i++) {
+		vec = &queue_info->flow_vector_data[i];
+		if (vec->vector_ev == NULL)
+			continue;
+		rxa_vector_expire(vec, rx_adapter);
+		TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+		if (vec->vector_ev != NULL) {
+			rte_mempool_put(vec->vector_pool, vec->vector_ev);
+			vec->vector_ev = NULL;
+		}
+	}
+
+	rte_free(queue_info->flow_vector_data);
+	queue_info->flow_vector_data = NULL;
+	queue_info->nb_flow_vectors = 0;
 }
 
 static void
@@ -2034,6 +2354,9 @@ rxa_sw_del(struct event_eth_rx_adapter *rx_adapter,
 		TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
 	}
 
+	rxa_adaptive_del(rx_adapter, dev_info, rx_queue_id);
+	rxa_flow_vectors_free(rx_adapter, &dev_info->rx_queue[rx_queue_id]);
+
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
@@ -2090,6 +2413,41 @@ rxa_add_queue(struct event_eth_rx_adapter *rx_adapter,
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
 
 	queue_info = &dev_info->rx_queue[rx_queue_id];
+
+	rxa_flow_vectors_free(rx_adapter, queue_info);
+	if ((conf->rx_queue_flags &
+	     RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR) &&
+	    (conf->rx_queue_flags &
+	     RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW)) {
+		queue_info->flow_vector_data =
+			rte_zmalloc_socket(rx_adapter->mem_name,
+					   conf->vector_flow_buckets *
+					   sizeof(struct eth_rx_vector_data),
+					   RTE_CACHE_LINE_SIZE,
+					   rx_adapter->socket_id);
+		if (queue_info->flow_vector_data == NULL) {
+			RTE_EDEV_LOG_ERR("Failed to allocate flow vectors for "
+					 "dev_id: %d queue_id: %d",
+					 eth_dev_id, rx_queue_id);
+			return -ENOMEM;
+		}
+		queue_info->nb_flow_vectors = conf->vector_flow_buckets;
+	}
+
+	/* The adaptive queues need a dedicated Rx interrupt, the flag is
+	 * ignored otherwise.
+	 */
+	if ((conf->rx_queue_flags &
+	     RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR) &&
+	    conf->servicing_weight != 0 &&
+	    dev_info->dev->data->dev_conf.intr_conf.rxq &&
+	    dev_info->dev->intr_handle != NULL &&
+	    !rxa_shared_intr(dev_info, rx_queue_id)) {
+		ret = rxa_adaptive_add(rx_adapter, dev_info, rx_queue_id);
+		if (ret)
+			return ret;
+	}
+
 	queue_info->wt = conf->servicing_weight;
 
 	qi_ev = (struct rte_event *)&queue_info->event;
@@ -2155,7 +2513,8 @@ rxa_add_queue(struct event_eth_rx_adapter *rx_adapter,
 		RTE_EDEV_LOG_ERR("Failed to allocate event buffer meta for "
 				 "dev_id: %d queue_id: %d",
 				 eth_dev_id, rx_queue_id);
-		return -ENOMEM;
+		ret = -ENOMEM;
+		goto err_adaptive_del;
 	}
 
 	new_rx_buf->events_size = RTE_ALIGN(conf->event_buf_size, BATCH_SIZE);
@@ -2169,7 +2528,8 @@ rxa_add_queue(struct event_eth_rx_adapter *rx_adapter,
 		RTE_EDEV_LOG_ERR("Failed to allocate event buffer for "
 				 "dev_id: %d queue_id: %d",
 				 eth_dev_id, rx_queue_id);
-		return -ENOMEM;
+		ret = -ENOMEM;
+		goto err_adaptive_del;
 	}
 
 	queue_info->event_buf = new_rx_buf;
@@ -2184,12 +2544,18 @@ rxa_add_queue(struct event_eth_rx_adapter *rx_adapter,
 		RTE_EDEV_LOG_ERR("Failed to allocate stats storage for"
 				 " dev_id: %d queue_id: %d",
 				 eth_dev_id, rx_queue_id);
-		return -ENOMEM;
+		ret = -ENOMEM;
+		goto err_adaptive_del;
 	}
 
 	queue_info->stats = stats;
 
 	return 0;
+
+err_adaptive_del:
+	/* Release the Rx interrupt registered for the adaptive queue */
+	rxa_adaptive_del(rx_adapter, dev_info, rx_queue_id);
+	return ret;
 }
 
 static int
@@ -2230,6 +2596,16 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 		}
 	}
 
+	if ((queue_conf->rx_queue_flags &
+	     RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR) &&
+	    rx_adapter->use_queue_event_buf) {
+		RTE_EDEV_LOG_ERR("Use of queue level event buffer "
+				 "not supported for adaptive queues "
+				 "dev_id: %d queue_id: %d",
+				 eth_dev_id, rx_queue_id);
+		return -EINVAL;
+	}
+
 	nb_rx_queues = dev_info->dev->data->nb_rx_queues;
 	rx_queue = dev_info->rx_queue;
 	wt = queue_conf->servicing_weight;
@@ -2259,6 +2635,16 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 	if (ret)
 		goto err_free_rxqueue;
 
+	/* Release the interrupt of the adaptive queues being reconfigured */
+	if (rx_queue_id == -1) {
+		uint16_t i;
+
+		for (i = 0; i < nb_rx_queues; i++)
+			rxa_adaptive_del(rx_adapter, dev_info, i);
+	} else {
+		rxa_adaptive_del(rx_adapter, dev_info, rx_queue_id);
+	}
+
 	if (wt == 0) {
 		num_intr_vec = rxa_nb_intr_vect(dev_info, rx_queue_id, 1);
 
@@ -2310,7 +2696,9 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 	ret = rxa_add_queue(rx_adapter, dev_info, rx_queue_id, queue_conf);
 	if (ret)
 		goto err_free_rxqueue;
-	rxa_calc_wrr_sequence(rx_adapter, rx_poll, rx_wrr);
+	rx_adapter->wrr_active_len = rxa_calc_wrr_sequence(rx_adapter,
+							   rx_poll, rx_wrr);
+	rxa_adaptive_free_intr_resources(rx_adapter);
 
 	rte_free(rx_adapter->eth_rx_poll);
 	rte_free(rx_adapter->wrr_sched);
@@ -2318,14 +2706,23 @@ rxa_sw_add(struct event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
 	rx_adapter->eth_rx_poll = rx_poll;
 	rx_adapter->wrr_sched = rx_wrr;
 	rx_adapter->wrr_len = nb_wrr;
+	if (rx_adapter->wrr_pos >= rx_adapter->wrr_active_len)
+		rx_adapter->wrr_pos = 0;
+	rx_adapter->wrr_rebuild = 0;
 	rx_adapter->num_intr_vec += num_intr_vec;
 	return 0;
 
 err_free_rxqueue:
 	if (rx_queue == NULL) {
+		uint16_t i;
+
+		/* The queues are freed, release their Rx interrupt */
+		for (i = 0; i < nb_rx_queues; i++)
+			rxa_adaptive_del(rx_adapter, dev_info, i);
 		rte_free(dev_info->rx_queue);
 		dev_info->rx_queue = NULL;
 	}
+	rxa_adaptive_free_intr_resources(rx_adapter);
 
 	rte_free(rx_poll);
 	rte_free(rx_wrr);
@@ -2723,6 +3120,30 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		}
 	}
 
+	if (queue_conf->rx_queue_flags &
+	    RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW) {
+		uint16_t nb_buckets = queue_conf->vector_flow_buckets;
+
+		if ((queue_conf->rx_queue_flags &
+		     RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR) == 0 ||
+		    nb_buckets == 0 || !rte_is_power_of_2(nb_buckets) ||
+		    nb_buckets > RTE_EVENT_ETH_RX_ADAPTER_VECTOR_FLOW_BUCKETS_MAX) {
+			RTE_EDEV_LOG_ERR("Invalid flow vector configuration,"
+					 " eth port: %" PRIu16
+					 " adapter id: %" PRIu8,
+					 eth_dev_id, id);
+			return -EINVAL;
+		}
+
+		if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) {
+			RTE_EDEV_LOG_ERR("Flow vectors are not supported,"
+					 " eth port: %" PRIu16
+					 " adapter id: %" PRIu8,
+					 eth_dev_id, id);
+			return -ENOTSUP;
+		}
+	}
+
 	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) == 0 &&
 		(rx_queue_id != -1)) {
 		RTE_EDEV_LOG_ERR("Rx queues can only be connected to single "
@@ -2891,7 +3312,10 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 		}
 
 		rxa_sw_del(rx_adapter, dev_info, rx_queue_id);
-		rxa_calc_wrr_sequence(rx_adapter, rx_poll, rx_wrr);
+		rx_adapter->wrr_active_len = rxa_calc_wrr_sequence(rx_adapter,
+							rx_poll, rx_wrr);
+		rx_adapter->wrr_rebuild = 0;
+		rxa_adaptive_free_intr_resources(rx_adapter);
 
 		rte_free(rx_adapter->eth_rx_poll);
 		rte_free(rx_adapter->wrr_sched);
@@ -3379,6 +3803,13 @@ rte_event_eth_rx_adapter_queue_conf_get(uint8_t id,
 	if (queue_info->flow_id_mask != 0)
 		queue_conf->rx_queue_flags |=
 			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_FLOW_ID_VALID;
+	if (queue_info->adaptive)
+		queue_conf->rx_queue_flags |=
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR;
+	if (queue_info->nb_flow_vectors)
+		queue_conf->rx_queue_flags |=
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW;
+	queue_conf->vector_flow_buckets = queue_info->nb_flow_vectors;
 	queue_conf->servicing_weight = queue_info->wt;
 
 	queue_conf->ev.event = queue_info->event;
@@ -3518,6 +3949,7 @@ rte_event_eth_rx_adapter_runtime_params_init(
 
 	memset(params, 0, sizeof(struct rte_event_eth_rx_adapter_runtime_params));
 	params->max_nb_rx = RXA_NB_RX_WORK_DEFAULT;
+	params->adaptive_idle_polls = RXA_ADAPTIVE_IDLE_POLLS_DEFAULT;
 
 	return 0;
 }
@@ -3545,6 +3977,9 @@ rte_event_eth_rx_adapter_runtime_params_set(uint8_t id,
 
 	rte_spinlock_lock(&rxa->rx_lock);
 	rxa->max_nb_rx = params->max_nb_rx;
+	rxa->adaptive_idle_polls = params->adaptive_idle_polls ?
+			params->adaptive_idle_polls :
+			RXA_ADAPTIVE_IDLE_POLLS_DEFAULT;
 	rte_spinlock_unlock(&rxa->rx_lock);
 
 	return 0;
@@ -3572,6 +4007,7 @@ rte_event_eth_rx_adapter_runtime_params_get(uint8_t id,
 		return ret;
 
 	params->max_nb_rx = rxa->max_nb_rx;
+	params->adaptive_idle_polls = rxa->adaptive_idle_polls;
 
 	return 0;
 }
@@ -100,6 +100,9 @@ extern "C" {
 
 #define RTE_EVENT_ETH_RX_ADAPTER_MAX_INSTANCE 32
 
+/* Maximum number of flow buckets of an Rx queue vectorized per flow group */
+#define RTE_EVENT_ETH_RX_ADAPTER_VECTOR_FLOW_BUCKETS_MAX 256
+
 /* struct rte_event_eth_rx_adapter_queue_conf flags definitions */
 #define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_FLOW_ID_VALID	0x1
 /**< This flag indicates the flow identifier is valid
@@ -109,6 +112,24 @@ extern "C" {
 /**< This flag indicates that mbufs arriving on the queue need to be vectorized
  * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR	0x4
+/**< This flag indicates that the SW adapter stops polling the queue after
+ * rte_event_eth_rx_adapter_runtime_params::adaptive_idle_polls empty polls
+ * and waits for its Rx interrupt, polling resumes when the interrupt fires.
+ * The flag is ignored for interrupt mode queues (servicing_weight == 0),
+ * if Rx interrupts are disabled or if the queue shares its interrupt vector.
+ * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
+ */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW	0x8
+/**< This flag indicates that the mbufs arriving on the queue are vectorized
+ * per flow group: the mbufs are spread over
+ * rte_event_eth_rx_adapter_queue_conf::vector_flow_buckets vectors by their
+ * RSS hash, so that an event vector only holds the mbufs of the flows of one
+ * bucket and all the vectors of a flow carry the same flow ID.
+ * Valid along with RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR, for the
+ * devices without RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT capability.
+ * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
+ */
 
 /**
  * Adapter configuration structure that the adapter configuration callback
@@ -213,6 +234,15 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	 */
 	uint16_t event_buf_size;
 	/**< event buffer size for this queue */
+	uint16_t vector_flow_buckets;
+	/**<
+	 * Number of flow buckets the mbufs are vectorized in, a power of 2 up
+	 * to RTE_EVENT_ETH_RX_ADAPTER_VECTOR_FLOW_BUCKETS_MAX. Each bucket holds
+	 * a partial vector, the vector_mp mempool has to be sized accordingly.
+	 * Valid when RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR_FLOW flag is
+	 * set in
+	 * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags.
+	 */
 };
 
 /**
@@ -326,7 +356,16 @@ struct rte_event_eth_rx_adapter_runtime_params {
 	 * This is valid for the devices without
 	 * RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT capability.
 	 */
-	uint32_t rsvd[15];
+	uint32_t adaptive_idle_polls;
+	/**< Number of consecutive empty polls after which the SW adapter
+	 * switches an Rx queue added with the
+	 * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_ADAPTIVE_INTR flag to interrupt mode.
+	 * A value of 0 selects the default.
+	 *
+	 * This is valid for the devices without
+	 * RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT capability.
+	 */
+	uint32_t rsvd[14];
 	/**< Reserved fields for future use */
 };
 
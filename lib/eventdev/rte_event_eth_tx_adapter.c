@@ -1,12 +1,14 @@
 /* SPDX-License-Identifier: BSD-3-Clause
  * Copyright(c) 2018 Intel Corporation.
  */
+#include <rte_cycles.h>
 #include <rte_spinlock.h>
 #include <rte_service_component.h>
 #include <ethdev_driver.h>
 
 #include "eventdev_pmd.h"
 #include "eventdev_trace.h"
+#include "event_adapter_private.h"
 #include "rte_event_eth_tx_adapter.h"
 
 #define TXA_BATCH_SIZE		32
@@ -17,6 +19,8 @@
 #define TXA_MAX_NB_TX		128
 #define TXA_INVALID_DEV_ID	INT32_C(-1)
 #define TXA_INVALID_SERVICE_ID	INT64_C(-1)
+#define TXA_RUNTIME_FLAGS	(RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_BACKPRESSURE | \
+				 RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST)
 
 #define TXA_ADAPTER_ARRAY "txa_adapter_array"
 #define TXA_SERVICE_DATA_ARRAY "txa_service_data_array"
@@ -106,6 +110,12 @@ struct txa_service_queue_info {
 	struct txa_retry txa_retry;
 	/* Tx buffer */
 	struct rte_eth_dev_tx_buffer *tx_buf;
+	/* Timestamp of the first packet in the Tx buffer */
+	uint64_t tx_buf_ts;
+	/* Number of packets kept in back-pressure mode */
+	uint16_t nb_pending;
+	/* Packets the Tx queue failed to transmit in back-pressure mode */
+	struct rte_mbuf *pending[TXA_BATCH_SIZE];
 };
 
 /* PMD private structure */
@@ -126,6 +136,22 @@ struct __rte_cache_aligned txa_service_data {
 	int loop_cnt;
 	/* Loop count threshold to flush Tx buffers */
 	uint16_t flush_threshold;
+	/* Runtime flags */
+	uint16_t flags;
+	/* Number of Tx queues with packets kept in back-pressure mode */
+	uint32_t nb_pending_queues;
+	/* Number of events kept in back-pressure mode */
+	uint16_t nb_kept_ev;
+	/* Events dequeued for Tx queues with kept packets */
+	struct rte_event kept_ev[TXA_BATCH_SIZE];
+	/* Time threshold to flush Tx buffers in ns */
+	uint32_t flush_timeout_ns;
+	/* Time threshold to flush Tx buffers in timer cycles */
+	uint64_t flush_ticks;
+	/* Timestamp of the last flush of the Tx buffers */
+	uint64_t flush_ts;
+	/* Timestamp of the current service function call */
+	uint64_t now;
 	/* Per ethernet device structure */
 	struct txa_service_ethdev *txa_ethdev;
 	/* Statistics */
@@ -154,6 +180,8 @@ struct txa_service_ethdev {
 	uint16_t nb_queues;
 	/* PMD specific queue data */
 	void *queues;
+	/* Tx latency histogram */
+	uint64_t tx_latency_hist[RTE_EVENT_ETH_TX_ADAPTER_HIST_BUCKETS];
 };
 
 /* Array of adapter instances, initialized with event device id
@@ -539,6 +567,28 @@ txa_service_buffer_retry(struct rte_mbuf **pkts, uint16_t unsent,
 	data = txa_service_id_to_data(tr->id);
 	stats = &data->stats;
 
+	if (data->flags & RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_BACKPRESSURE) {
+		struct txa_service_queue_info *tqi;
+
+		tqi = txa_service_queue(data, tr->port_id, tr->tx_queue);
+
+		/* No packet is buffered for a Tx queue with kept packets,
+		 * the Tx buffer fits in the room for the kept packets.
+		 */
+		RTE_ASSERT(tqi->nb_pending == 0);
+		sent = rte_eth_tx_burst(tr->port_id, tr->tx_queue,
+					pkts, unsent);
+		stats->tx_packets += sent;
+		if (sent == unsent)
+			return;
+
+		n = unsent - sent;
+		memcpy(tqi->pending, &pkts[sent], n * sizeof(pkts[0]));
+		tqi->nb_pending = n;
+		data->nb_pending_queues++;
+		return;
+	}
+
 	do {
 		n = rte_eth_tx_burst(tr->port_id, tr->tx_queue,
 			       &pkts[sent], unsent - sent);
@@ -554,56 +604,125 @@ txa_service_buffer_retry(struct rte_mbuf **pkts, uint16_t unsent,
 	stats->tx_dropped += unsent - sent;
 }
 
+static inline uint32_t
+txa_hist_bucket(uint64_t val)
+{
+	return RTE_MIN(rte_fls_u64(val),
+		       (uint32_t)RTE_EVENT_ETH_TX_ADAPTER_HIST_BUCKETS - 1);
+}
+
+static inline void
+txa_service_latency_record(struct txa_service_data *txa, uint16_t port,
+			   struct txa_service_queue_info *tqi)
+{
+	txa->txa_ethdev[port].tx_latency_hist[
+		txa_hist_bucket(txa->now - tqi->tx_buf_ts)]++;
+}
+
+/* In back-pressure mode, no packet is buffered for a Tx queue with kept
+ * packets, the event carrying it is kept instead
+ */
+static inline bool
+txa_service_queue_kept(struct txa_service_data *txa,
+		       struct txa_service_queue_info *tqi)
+{
+	return (txa->flags & RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_BACKPRESSURE) &&
+		tqi->nb_pending;
+}
+
+static inline uint16_t
+txa_service_tx_buffer(struct txa_service_data *txa, uint16_t port,
+		      uint16_t queue, struct txa_service_queue_info *tqi,
+		      struct rte_mbuf *m)
+{
+	struct rte_eth_dev_tx_buffer *tb = tqi->tx_buf;
+	uint16_t nb_tx;
+
+	if (likely(!(txa->flags &
+		     RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST)))
+		return rte_eth_tx_buffer(port, queue, tb, m);
+
+	if (tb->length == 0)
+		tqi->tx_buf_ts = txa->now;
+
+	nb_tx = rte_eth_tx_buffer(port, queue, tb, m);
+
+	/* The Tx buffer has been flushed */
+	if (tb->length == 0)
+		txa_service_latency_record(txa, port, tqi);
+
+	return nb_tx;
+}
+
+/* Returns the number of packets transmitted. When the vector reaches a Tx
+ * queue with kept packets, kept is set and the vector is left with its
+ * remaining packets.
+ */
 static uint16_t
 txa_process_event_vector(struct txa_service_data *txa,
-			 struct rte_event_vector *vec)
+			 struct rte_event_vector *vec, bool *kept)
 {
 	struct txa_service_queue_info *tqi;
 	uint16_t port, queue, nb_tx = 0;
 	struct rte_mbuf **mbufs;
+	struct rte_mbuf *m;
 	int i;
 
-	mbufs = (struct rte_mbuf **)vec->mbufs;
+	mbufs = (struct rte_mbuf **)&vec->mbufs[vec->elem_offset];
 	if (vec->attr_valid) {
 		port = vec->port;
 		queue = vec->queue;
 		tqi = txa_service_queue(txa, port, queue);
 		if (unlikely(tqi == NULL || !tqi->added || tqi->stopped)) {
-			rte_pktmbuf_free_bulk(&mbufs[vec->elem_offset],
-					      vec->nb_elem);
+			rte_pktmbuf_free_bulk(mbufs, vec->nb_elem);
 			rte_mempool_put(rte_mempool_from_obj(vec), vec);
 			return 0;
 		}
 		for (i = 0; i < vec->nb_elem; i++) {
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf,
-						   mbufs[i + vec->elem_offset]);
+			if (unlikely(txa_service_queue_kept(txa, tqi)))
+				break;
+			nb_tx += txa_service_tx_buffer(txa, port, queue, tqi,
+						       mbufs[i]);
 		}
 	} else {
-		for (i = vec->elem_offset; i < vec->elem_offset + vec->nb_elem;
-		     i++) {
-			port = mbufs[i]->port;
-			queue = rte_event_eth_tx_adapter_txq_get(mbufs[i]);
+		for (i = 0; i < vec->nb_elem; i++) {
+			m = mbufs[i];
+			port = m->port;
+			queue = rte_event_eth_tx_adapter_txq_get(m);
 			tqi = txa_service_queue(txa, port, queue);
 			if (unlikely(tqi == NULL || !tqi->added ||
 				     tqi->stopped)) {
-				rte_pktmbuf_free(mbufs[i]);
+				rte_pktmbuf_free(m);
 				continue;
 			}
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf,
-						   mbufs[i]);
+			if (unlikely(txa_service_queue_kept(txa, tqi)))
+				break;
+			nb_tx += txa_service_tx_buffer(txa, port, queue, tqi,
+						       m);
 		}
 	}
+
+	if (unlikely(i < vec->nb_elem)) {
+		vec->elem_offset += i;
+		vec->nb_elem -= i;
+		*kept = true;
+		return nb_tx;
+	}
 	rte_mempool_put(rte_mempool_from_obj(vec), vec);
 
 	return nb_tx;
 }
 
-static void
+/* Returns the number of events processed, the following ones are for a Tx
+ * queue with kept packets
+ */
+static uint32_t
 txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 	uint32_t n)
 {
 	uint32_t i;
 	uint16_t nb_tx;
+	bool kept = false;
 	struct rte_event_eth_tx_adapter_stats *stats;
 
 	stats = &txa->stats;
@@ -627,14 +746,142 @@ txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 				rte_pktmbuf_free(m);
 				continue;
 			}
+			if (unlikely(txa_service_queue_kept(txa, tqi)))
+				break;
 
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
+			nb_tx += txa_service_tx_buffer(txa, port, queue, tqi, m);
 		} else {
-			nb_tx += txa_process_event_vector(txa, ev[i].vec);
+			nb_tx += txa_process_event_vector(txa, ev[i].vec,
+							  &kept);
+			if (unlikely(kept))
+				break;
 		}
 	}
 
 	stats->tx_packets += nb_tx;
+	return i;
+}
+
+/* Process the kept events, returns the number of events still kept */
+static uint16_t
+txa_service_kept_tx(struct txa_service_data *txa)
+{
+	uint32_t n;
+
+	n = txa_service_tx(txa, txa->kept_ev, txa->nb_kept_ev);
+	txa->nb_kept_ev -= n;
+	memmove(txa->kept_ev, &txa->kept_ev[n],
+		txa->nb_kept_ev * sizeof(txa->kept_ev[0]));
+
+	return txa->nb_kept_ev;
+}
+
+static void
+txa_service_kept_free(struct txa_service_data *txa)
+{
+	struct rte_event_vector *vec;
+	uint16_t i;
+
+	for (i = 0; i < txa->nb_kept_ev; i++) {
+		if (!(txa->kept_ev[i].event_type & RTE_EVENT_TYPE_VECTOR)) {
+			rte_pktmbuf_free(txa->kept_ev[i].mbuf);
+			continue;
+		}
+		vec = txa->kept_ev[i].vec;
+		rte_pktmbuf_free_bulk(&vec->mbufs[vec->elem_offset],
+				      vec->nb_elem);
+		rte_mempool_put(rte_mempool_from_obj(vec), vec);
+	}
+	txa->nb_kept_ev = 0;
+}
+
+/* Transmit the packets kept in back-pressure mode, returns the number of
+ * Tx queues which still have kept packets
+ */
+static uint32_t
+txa_service_pending_tx(struct txa_service_data *txa)
+{
+	struct txa_service_ethdev *tdi;
+	struct txa_service_queue_info *tqi;
+	struct rte_eth_dev *dev;
+	uint16_t i, n;
+
+	tdi = txa->txa_ethdev;
+
+	RTE_ETH_FOREACH_DEV(i) {
+		uint16_t q;
+
+		if (i >= txa->dev_count)
+			break;
+
+		dev = tdi[i].dev;
+		if (tdi[i].nb_queues == 0)
+			continue;
+		for (q = 0; q < dev->data->nb_tx_queues; q++) {
+
+			tqi = txa_service_queue(txa, i, q);
+			if (tqi == NULL || tqi->nb_pending == 0)
+				continue;
+
+			n = rte_eth_tx_burst(i, q, tqi->pending,
+					     tqi->nb_pending);
+			txa->stats.tx_packets += n;
+			txa->stats.tx_retry++;
+			tqi->nb_pending -= n;
+			if (tqi->nb_pending) {
+				memmove(tqi->pending, &tqi->pending[n],
+					tqi->nb_pending * sizeof(tqi->pending[0]));
+				continue;
+			}
+
+			txa->nb_pending_queues--;
+		}
+	}
+
+	return txa->nb_pending_queues;
+}
+
+static uint32_t
+txa_service_flush(struct txa_service_data *txa)
+{
+	struct txa_service_ethdev *tdi;
+	struct txa_service_queue_info *tqi;
+	struct rte_eth_dev *dev;
+	uint32_t nb_tx;
+	uint16_t i;
+
+	tdi = txa->txa_ethdev;
+	nb_tx = 0;
+
+	RTE_ETH_FOREACH_DEV(i) {
+		uint16_t q;
+
+		if (i >= txa->dev_count)
+			break;
+
+		dev = tdi[i].dev;
+		if (tdi[i].nb_queues == 0)
+			continue;
+		for (q = 0; q < dev->data->nb_tx_queues; q++) {
+
+			tqi = txa_service_queue(txa, i, q);
+			if (unlikely(tqi == NULL || !tqi->added ||
+				     tqi->stopped))
+				continue;
+
+			/* The kept packets go first */
+			if (tqi->nb_pending || tqi->tx_buf->length == 0)
+				continue;
+
+			if (txa->flags &
+			    RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST)
+				txa_service_latency_record(txa, i, tqi);
+
+			nb_tx += rte_eth_tx_buffer_flush(i, q, tqi->tx_buf);
+		}
+	}
+
+	return nb_tx;
 }
 
 static int32_t
@@ -645,7 +892,7 @@ txa_service_func(void *args)
 	uint8_t port;
 	int ret = -EAGAIN;
 	uint16_t n;
-	uint32_t nb_tx, max_nb_tx;
+	uint32_t nb_tx, nb_ev, max_nb_tx;
 	struct rte_event ev[TXA_BATCH_SIZE];
 
 	dev_id = txa->eventdev_id;
@@ -658,47 +905,47 @@ txa_service_func(void *args)
 	if (!rte_spinlock_trylock(&txa->tx_lock))
 		return ret;
 
+	if (txa->flush_ticks ||
+	    (txa->flags & RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST))
+		txa->now = rte_get_timer_cycles();
+
+	/* Stall the event port until the kept packets and events are
+	 * transmitted
+	 */
+	if (unlikely(txa->nb_pending_queues) && txa_service_pending_tx(txa))
+		max_nb_tx = 0;
+	else if (unlikely(txa->nb_kept_ev) &&
+		 (txa_service_kept_tx(txa) || txa->nb_pending_queues))
+		max_nb_tx = 0;
+
 	for (nb_tx = 0; nb_tx < max_nb_tx; nb_tx += n) {
 
 		n = rte_event_dequeue_burst(dev_id, port, ev, RTE_DIM(ev), 0);
 		if (!n)
 			break;
-		txa_service_tx(txa, ev, n);
+		nb_ev = txa_service_tx(txa, ev, n);
 		ret = 0;
-	}
 
-	if (txa->loop_cnt++ == txa->flush_threshold) {
+		/* Keep the events for a Tx queue with kept packets */
+		if (unlikely(nb_ev < n)) {
+			txa->nb_kept_ev = n - nb_ev;
+			memcpy(txa->kept_ev, &ev[nb_ev],
+			       txa->nb_kept_ev * sizeof(ev[0]));
+			break;
+		}
 
-		struct txa_service_ethdev *tdi;
-		struct txa_service_queue_info *tqi;
-		struct rte_eth_dev *dev;
-		uint16_t i;
+		/* A kept Tx queue has no room for another flush */
+		if (unlikely(txa->nb_pending_queues))
+			break;
+	}
 
+	if (txa->loop_cnt++ == txa->flush_threshold ||
+	    (txa->flush_ticks &&
+	     txa->now - txa->flush_ts >= txa->flush_ticks)) {
 		txa->loop_cnt = 0;
-		tdi = txa->txa_ethdev;
-		nb_tx = 0;
-
-		RTE_ETH_FOREACH_DEV(i) {
-			uint16_t q;
-
-			if (i >= txa->dev_count)
-				break;
-
-			dev = tdi[i].dev;
-			if (tdi[i].nb_queues == 0)
-				continue;
-			for (q = 0; q < dev->data->nb_tx_queues; q++) {
-
-				tqi = txa_service_queue(txa, i, q);
-				if (unlikely(tqi == NULL || !tqi->added ||
-					     tqi->stopped))
-					continue;
-
-				nb_tx += rte_eth_tx_buffer_flush(i, q,
-							tqi->tx_buf);
-			}
-		}
+		txa->flush_ts = txa->now;
 
+		nb_tx = txa_service_flush(txa);
 		if (likely(nb_tx > 0)) {
 			txa->stats.tx_packets += nb_tx;
 			ret = 0;
@@ -802,6 +1049,7 @@ txa_service_adapter_free(uint8_t id)
 		return -EBUSY;
 	}
 
+	txa_service_kept_free(txa);
 	if (txa->conf_free)
 		rte_free(txa->conf_arg);
 	rte_free(txa);
@@ -910,7 +1158,8 @@ txa_service_queue_add(uint8_t id,
 }
 
 static inline void
-txa_txq_buffer_drain(struct txa_service_queue_info *tqi)
+txa_txq_buffer_drain(struct txa_service_data *txa,
+		     struct txa_service_queue_info *tqi)
 {
 	struct rte_eth_dev_tx_buffer *b;
 	uint16_t i;
@@ -921,6 +1170,12 @@ txa_txq_buffer_drain(struct txa_service_queue_info *tqi)
 		rte_pktmbuf_free(b->pkts[i]);
 
 	b->length = 0;
+
+	if (tqi->nb_pending) {
+		rte_pktmbuf_free_bulk(tqi->pending, tqi->nb_pending);
+		tqi->nb_pending = 0;
+		txa->nb_pending_queues--;
+	}
 }
 
 static int
@@ -971,7 +1226,7 @@ txa_service_queue_del(uint8_t id,
 		goto ret_unlock;
 
 	/* Drain the buffered mbufs */
-	txa_txq_buffer_drain(tqi);
+	txa_txq_buffer_drain(txa, tqi);
 	tb = tqi->tx_buf;
 	tqi->added = 0;
 	tqi->tx_buf = NULL;
@@ -1025,9 +1280,15 @@ static int
 txa_service_stats_reset(uint8_t id)
 {
 	struct txa_service_data *txa;
+	uint16_t i;
 
 	txa = txa_service_id_to_data(id);
+	rte_spinlock_lock(&txa->tx_lock);
 	memset(&txa->stats, 0, sizeof(txa->stats));
+	for (i = 0; txa->txa_ethdev != NULL && i < txa->dev_count; i++)
+		memset(txa->txa_ethdev[i].tx_latency_hist, 0,
+		       sizeof(txa->txa_ethdev[i].tx_latency_hist));
+	rte_spinlock_unlock(&txa->tx_lock);
 	return 0;
 }
 
@@ -1344,9 +1605,23 @@ rte_event_eth_tx_adapter_runtime_params_set(uint8_t id,
 	if (ret)
 		return ret;
 
+	if (txa_params->flags & ~TXA_RUNTIME_FLAGS) {
+		RTE_EDEV_LOG_ERR("Invalid runtime flags %#" PRIx16,
+				 txa_params->flags);
+		return -EINVAL;
+	}
+
 	rte_spinlock_lock(&txa->tx_lock);
 	txa->flush_threshold = txa_params->flush_threshold;
 	txa->max_nb_tx = txa_params->max_nb_tx;
+	txa->flags = txa_params->flags;
+	txa->flush_timeout_ns = txa_params->flush_timeout_ns;
+	txa->flush_ticks = 0;
+	if (txa_params->flush_timeout_ns)
+		txa->flush_ticks = RTE_MAX(1ULL,
+			(uint64_t)NSEC2TICK((uint64_t)txa_params->flush_timeout_ns,
+					    rte_get_timer_hz()));
+	txa->flush_ts = rte_get_timer_cycles();
 	rte_spinlock_unlock(&txa->tx_lock);
 
 	return 0;
@@ -1378,6 +1653,44 @@ rte_event_eth_tx_adapter_runtime_params_get(uint8_t id,
 	rte_spinlock_lock(&txa->tx_lock);
 	txa_params->flush_threshold = txa->flush_threshold;
 	txa_params->max_nb_tx = txa->max_nb_tx;
+	txa_params->flags = txa->flags;
+	txa_params->flush_timeout_ns = txa->flush_timeout_ns;
+	rte_spinlock_unlock(&txa->tx_lock);
+
+	return 0;
+}
+
+int
+rte_event_eth_tx_adapter_latency_histogram_get(uint8_t id, uint16_t eth_dev_id,
+		uint64_t hist[RTE_EVENT_ETH_TX_ADAPTER_HIST_BUCKETS])
+{
+	struct txa_service_data *txa;
+	int ret;
+
+	if (txa_lookup())
+		return -ENOMEM;
+
+	TXA_CHECK_OR_ERR_RET(id);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	if (hist == NULL)
+		return -EINVAL;
+
+	txa = txa_service_id_to_data(id);
+	if (txa == NULL)
+		return -EINVAL;
+
+	ret = txa_caps_check(txa);
+	if (ret)
+		return ret;
+
+	rte_spinlock_lock(&txa->tx_lock);
+	if (eth_dev_id < txa->dev_count)
+		memcpy(hist, txa->txa_ethdev[eth_dev_id].tx_latency_hist,
+		       sizeof(txa->txa_ethdev[eth_dev_id].tx_latency_hist));
+	else
+		memset(hist, 0, sizeof(uint64_t) *
+		       RTE_EVENT_ETH_TX_ADAPTER_HIST_BUCKETS);
 	rte_spinlock_unlock(&txa->tx_lock);
 
 	return 0;
@@ -1479,7 +1792,7 @@ txa_sw_queue_start_state_set(uint16_t eth_dev_id, uint16_t tx_queue_id,
 		return -EINVAL;
 	}
 	if (start_state == false)
-		txa_txq_buffer_drain(tqi);
+		txa_txq_buffer_drain(txa, tqi);
 
 	tqi->stopped = !start_state;
 	rte_spinlock_unlock(&txa->tx_lock);
@@ -40,6 +40,7 @@
  *  - rte_event_eth_tx_adapter_runtime_params_get()
  *  - rte_event_eth_tx_adapter_runtime_params_init()
  *  - rte_event_eth_tx_adapter_runtime_params_set()
+ *  - rte_event_eth_tx_adapter_latency_histogram_get()
  *
  * The application creates the adapter using
  * rte_event_eth_tx_adapter_create() or rte_event_eth_tx_adapter_create_ext().
@@ -133,10 +134,47 @@ struct rte_event_eth_tx_adapter_runtime_params {
 	 * This is valid for the devices without
 	 * RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT capability.
 	 */
-	uint16_t rsvd[29];
+	uint16_t flags;
+	/**< Adapter runtime flags.
+	 * @see RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_BACKPRESSURE
+	 * @see RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST
+	 *
+	 * This is valid for the devices without
+	 * RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT capability.
+	 */
+	uint32_t flush_timeout_ns;
+	/**< Time after which the buffered packets are flushed, in addition to
+	 * the flush_threshold iteration count. Zero disables the timed flush.
+	 * Default value is zero.
+	 *
+	 * This is valid for the devices without
+	 * RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT capability.
+	 */
+	uint16_t rsvd[26];
 	/**< Reserved fields for future expansion */
 };
 
+#define RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_BACKPRESSURE	0x1
+/**< This flag indicates that the adapter keeps the packets an ethernet Tx
+ * queue failed to transmit, instead of dropping them after a number of
+ * retries. The adapter stops dequeuing events from its event port until
+ * these packets are transmitted, which back-pressures the event device
+ * instead of losing packets when an ethernet port is slower than the
+ * event rate. Up to one burst of packets per Tx queue is kept, the events
+ * dequeued for a Tx queue with kept packets, including the rest of an
+ * event vector, are kept by the adapter until these packets are transmitted.
+ * @see rte_event_eth_tx_adapter_runtime_params::flags
+ */
+
+#define RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST	0x2
+/**< This flag indicates that the adapter records a histogram per ethernet
+ * port of the time the packets wait in the adapter Tx buffers.
+ * @see rte_event_eth_tx_adapter_latency_histogram_get()
+ */
+
+/** Number of log2 buckets of the Tx latency histograms. */
+#define RTE_EVENT_ETH_TX_ADAPTER_HIST_BUCKETS	32
+
 /**
  * Function type used for adapter configuration callback. The callback is
  * used to fill in members of the struct rte_event_eth_tx_adapter_conf, this
@@ -602,6 +640,33 @@ int
 rte_event_eth_tx_adapter_runtime_params_get(uint8_t id,
 		struct rte_event_eth_tx_adapter_runtime_params *params);
 
+/**
+ * Get the Tx latency histogram of an ethernet port.
+ *
+ * Bucket i of the histogram counts the Tx buffer flushes of the port whose
+ * first packet waited between 2^(i-1) and 2^i timer cycles in the buffer,
+ * bucket 0 counts the flushes done in the service function call which
+ * buffered the first packet. The histogram is recorded when the
+ * RTE_EVENT_ETH_TX_ADAPTER_RUNTIME_F_LATENCY_HIST flag is set, and reset
+ * by rte_event_eth_tx_adapter_stats_reset().
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Ethernet Port Identifier.
+ * @param[out] hist
+ *  Histogram of the port.
+ *
+ * @return
+ *  -  0: Success
+ *  - -EINVAL: Invalid parameters.
+ *  - -ENOTSUP: The adapter does not use a service function.
+ */
+__rte_experimental
+int
+rte_event_eth_tx_adapter_latency_histogram_get(uint8_t id, uint16_t eth_dev_id,
+		uint64_t hist[RTE_EVENT_ETH_TX_ADAPTER_HIST_BUCKETS]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,6 +16,7 @@
 #include <rte_malloc.h>
 #include <rte_mempool.h>
 #include <rte_common.h>
+#include <rte_spinlock.h>
 #include <rte_timer.h>
 #include <rte_service_component.h>
 #include <rte_telemetry.h>
@@ -40,6 +41,7 @@ RTE_LOG_REGISTER_SUFFIX(evtim_svc_logtype, adapter.timer.svc, NOTICE);
 static struct rte_event_timer_adapter *adapters;
 
 static const struct event_timer_adapter_ops swtim_ops;
+static const struct event_timer_adapter_ops swtim_wheel_ops;
 
 #define EVTIM_LOG(level, logtype, ...) \
 	RTE_LOG_LINE_PREFIX(level, logtype, \
@@ -68,6 +70,18 @@ get_timer_type(const struct rte_event_timer_adapter *adapter)
 			PERIODICAL : SINGLE;
 }
 
+static inline bool
+swtim_use_wheel(const struct rte_event_timer_adapter *adapter)
+{
+	return adapter->data->conf.flags & RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
+}
+
+static inline const struct event_timer_adapter_ops *
+swtim_ops_get(const struct rte_event_timer_adapter *adapter)
+{
+	return swtim_use_wheel(adapter) ? &swtim_wheel_ops : &swtim_ops;
+}
+
 static int
 default_port_conf_cb(uint16_t id, uint8_t event_dev_id, uint8_t *event_port_id,
 		     void *conf_arg)
@@ -238,7 +252,7 @@ rte_event_timer_adapter_create_ext(
 	 * implementation.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = swtim_ops_get(adapter);
 
 	/* Allow driver to do some setup */
 	FUNC_PTR_OR_NULL_RET_WITH_ERRNO(adapter->ops->init, ENOTSUP);
@@ -383,7 +397,7 @@ rte_event_timer_adapter_lookup(uint16_t adapter_id)
 	 * implementation.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = swtim_ops_get(adapter);
 
 	/* Set fast-path function pointers */
 	adapter->arm_burst = adapter->ops->arm_burst;
@@ -643,6 +657,13 @@ struct swtim {
 	struct rte_timer *expired_timers[EXP_TIM_BUF_SZ];
 	/* The number of timers that can be returned to a mempool */
 	size_t n_expired_timers;
+	/* Timing wheel mode: the timing wheels of the lcores */
+	struct swtim_wheel *wheels;
+	/* Timing wheel mode: timer cycles per adapter tick */
+	uint64_t cycles_per_tick;
+	struct rte_reciprocal_u64 cycles_per_tick_inverse;
+	/* Timing wheel mode: the adapter tick of the last service run */
+	uint64_t last_tick;
 };
 
 static inline struct swtim *
@@ -876,6 +897,344 @@ swtim_service_func(void *arg)
 	return prior_enq_count == sw->stats.ev_enq_count ? -EAGAIN : 0;
 }
 
+/*
+ * Timing wheel mode
+ *
+ * The timers armed on an lcore are kept in a hierarchical timing wheel of
+ * that lcore, the slots of which are aligned to the adapter tick. Arming and
+ * canceling a timer link and unlink it from a slot list in O(1), under the
+ * lock of the wheel, which is only contended by the service and by the
+ * cancellations from other lcores. On each adapter tick, the service moves
+ * the due slot of each wheel to a list of expired timers, cascading the
+ * slots of the higher levels into the lower ones, and enqueues the events
+ * of the expired timers in bursts straight to the event device.
+ */
+#define SWTIM_WHEEL_LEVELS 4
+#define SWTIM_WHEEL_SLOT_BITS 6
+#define SWTIM_WHEEL_SLOTS (1 << SWTIM_WHEEL_SLOT_BITS)
+#define SWTIM_WHEEL_SLOT_MASK (SWTIM_WHEEL_SLOTS - 1)
+/* Number of adapter ticks covered by the wheel. The timers expiring later
+ * are parked in the top level, and placed again when their slot is cascaded.
+ */
+#define SWTIM_WHEEL_RANGE (1ULL << (SWTIM_WHEEL_LEVELS * SWTIM_WHEEL_SLOT_BITS))
+
+struct swtim_wheel_node {
+	struct swtim_wheel_node *next;
+	struct swtim_wheel_node *prev;
+};
+
+struct swtim_wheel_entry {
+	/* Must be first, the slot lists link the entries by this node */
+	struct swtim_wheel_node node;
+	struct rte_event_timer *evtim;
+	/* Adapter tick at which the timer expires */
+	uint64_t expiry;
+	/* Period in adapter ticks, 0 for a single shot timer */
+	uint64_t period;
+	/* lcore of the wheel the timer is armed in */
+	unsigned int lcore_id;
+};
+
+struct __rte_cache_aligned swtim_wheel {
+	rte_spinlock_t lock;
+	/* Last adapter tick processed */
+	uint64_t cur_tick;
+	/* Number of timers armed in the wheel */
+	uint64_t nb_timers;
+	/* Expired timers, the events of which remain to be enqueued */
+	struct swtim_wheel_node expired;
+	struct swtim_wheel_node slots[SWTIM_WHEEL_LEVELS][SWTIM_WHEEL_SLOTS];
+};
+
+static inline void
+swtim_wheel_list_init(struct swtim_wheel_node *head)
+{
+	head->next = head;
+	head->prev = head;
+}
+
+static inline bool
+swtim_wheel_list_empty(const struct swtim_wheel_node *head)
+{
+	return head->next == head;
+}
+
+static inline void
+swtim_wheel_list_append(struct swtim_wheel_node *head,
+			struct swtim_wheel_node *node)
+{
+	node->prev = head->prev;
+	node->next = head;
+	head->prev->next = node;
+	head->prev = node;
+}
+
+static inline void
+swtim_wheel_list_remove(struct swtim_wheel_node *node)
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+}
+
+/* Move all the nodes of src at the end of dst */
+static inline void
+swtim_wheel_list_splice(struct swtim_wheel_node *dst,
+			struct swtim_wheel_node *src)
+{
+	if (swtim_wheel_list_empty(src))
+		return;
+
+	src->next->prev = dst->prev;
+	dst->prev->next = src->next;
+	src->prev->next = dst;
+	dst->prev = src->prev;
+	swtim_wheel_list_init(src);
+}
+
+static int
+swtim_wheel_init(struct swtim *sw, int socket_id)
+{
+	struct swtim_wheel *w;
+	unsigned int i, j, k;
+
+	sw->wheels = rte_zmalloc_socket("swtim_wheels",
+					RTE_MAX_LCORE * sizeof(*sw->wheels),
+					RTE_CACHE_LINE_SIZE, socket_id);
+	if (sw->wheels == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		w = &sw->wheels[i];
+		rte_spinlock_init(&w->lock);
+		swtim_wheel_list_init(&w->expired);
+		for (j = 0; j < SWTIM_WHEEL_LEVELS; j++)
+			for (k = 0; k < SWTIM_WHEEL_SLOTS; k++)
+				swtim_wheel_list_init(&w->slots[j][k]);
+	}
+
+	sw->cycles_per_tick = RTE_MAX((uint64_t)(sw->timer_tick_ns *
+					(rte_get_timer_hz() / NSECPERSEC)), UINT64_C(1));
+	sw->cycles_per_tick_inverse =
+			rte_reciprocal_value_u64(sw->cycles_per_tick);
+	sw->last_tick = rte_reciprocal_divide_u64(rte_get_timer_cycles(),
+					&sw->cycles_per_tick_inverse);
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		sw->wheels[i].cur_tick = sw->last_tick;
+
+	return 0;
+}
+
+/* Number of the last adapter tick which has begun */
+static inline uint64_t
+swtim_wheel_now(const struct swtim *sw)
+{
+	return rte_reciprocal_divide_u64(rte_get_timer_cycles(),
+					 &sw->cycles_per_tick_inverse);
+}
+
+/* Number of the next adapter tick, or of the current one if it just began,
+ * so that a timer never expires before its timeout.
+ */
+static inline uint64_t
+swtim_wheel_next(const struct swtim *sw)
+{
+	uint64_t cycles = rte_get_timer_cycles();
+	uint64_t tick;
+
+	tick = rte_reciprocal_divide_u64(cycles, &sw->cycles_per_tick_inverse);
+	if (cycles != tick * sw->cycles_per_tick)
+		tick++;
+
+	return tick;
+}
+
+static void
+swtim_wheel_insert(struct swtim_wheel *w, struct swtim_wheel_entry *e)
+{
+	uint64_t expiry = e->expiry;
+	unsigned int level, slot;
+	uint64_t delta;
+
+	if (expiry <= w->cur_tick) {
+		swtim_wheel_list_append(&w->expired, &e->node);
+		return;
+	}
+
+	delta = expiry - w->cur_tick;
+	if (delta >= SWTIM_WHEEL_RANGE) {
+		expiry = w->cur_tick + SWTIM_WHEEL_RANGE - 1;
+		delta = SWTIM_WHEEL_RANGE - 1;
+	}
+
+	for (level = 0; level < SWTIM_WHEEL_LEVELS - 1; level++)
+		if (delta < (1ULL << ((level + 1) * SWTIM_WHEEL_SLOT_BITS)))
+			break;
+
+	slot = (expiry >> (level * SWTIM_WHEEL_SLOT_BITS)) &
+			SWTIM_WHEEL_SLOT_MASK;
+	swtim_wheel_list_append(&w->slots[level][slot], &e->node);
+}
+
+/* Place again the timers of the current slot of a level in the lower ones */
+static void
+swtim_wheel_cascade(struct swtim_wheel *w, unsigned int level)
+{
+	struct swtim_wheel_node *head, *node;
+	unsigned int slot;
+
+	slot = (w->cur_tick >> (level * SWTIM_WHEEL_SLOT_BITS)) &
+			SWTIM_WHEEL_SLOT_MASK;
+	head = &w->slots[level][slot];
+
+	while (!swtim_wheel_list_empty(head)) {
+		node = head->next;
+		swtim_wheel_list_remove(node);
+		swtim_wheel_insert(w, (struct swtim_wheel_entry *)node);
+	}
+}
+
+static void
+swtim_wheel_advance(struct swtim_wheel *w, uint64_t now_tick)
+{
+	unsigned int level;
+
+	/* Nothing to expire in the meantime */
+	if (w->nb_timers == 0) {
+		w->cur_tick = RTE_MAX(w->cur_tick, now_tick);
+		return;
+	}
+
+	while (w->cur_tick < now_tick) {
+		w->cur_tick++;
+
+		/* The current slot of a level begins when the lower levels
+		 * wrap around.
+		 */
+		for (level = 1; level < SWTIM_WHEEL_LEVELS; level++)
+			if (w->cur_tick &
+			    ((1ULL << (level * SWTIM_WHEEL_SLOT_BITS)) - 1))
+				break;
+		while (--level > 0)
+			swtim_wheel_cascade(w, level);
+
+		swtim_wheel_list_splice(&w->expired,
+			&w->slots[0][w->cur_tick & SWTIM_WHEEL_SLOT_MASK]);
+	}
+}
+
+static void
+swtim_wheel_expire(const struct rte_event_timer_adapter *adapter,
+		   struct swtim *sw, struct swtim_wheel *w)
+{
+	struct swtim_wheel_entry *entries[EVENT_BUFFER_BATCHSZ];
+	struct swtim_wheel_entry *done[EVENT_BUFFER_BATCHSZ];
+	struct rte_event events[EVENT_BUFFER_BATCHSZ];
+	struct swtim_wheel_entry *e;
+	struct swtim_wheel_node *node;
+	uint16_t i, n, nb_enq, nb_inv, nb_done;
+
+	while (!swtim_wheel_list_empty(&w->expired)) {
+		n = 0;
+		for (node = w->expired.next;
+		     node != &w->expired && n < EVENT_BUFFER_BATCHSZ;
+		     node = node->next) {
+			entries[n] = (struct swtim_wheel_entry *)node;
+			events[n] = entries[n]->evtim->ev;
+			/* The single shot timer can be armed again or freed
+			 * as soon as its event is dequeued, so the RELEASE
+			 * ordering makes its state visible before.
+			 */
+			if (entries[n]->period == 0)
+				rte_atomic_store_explicit(
+					&entries[n]->evtim->state,
+					RTE_EVENT_TIMER_NOT_ARMED,
+					rte_memory_order_release);
+			n++;
+		}
+
+		nb_enq = rte_event_enqueue_burst(adapter->data->event_dev_id,
+						 adapter->data->event_port_id,
+						 events, n);
+		nb_inv = 0;
+		if (nb_enq < n && rte_errno == EINVAL) {
+			/* Drop the invalid event, like the event buffer */
+			EVTIM_LOG_DBG("failed to enqueue invalid event - "
+				      "dropping it");
+			nb_inv = 1;
+		}
+
+		nb_done = 0;
+		for (i = 0; i < nb_enq + nb_inv; i++) {
+			e = entries[i];
+			swtim_wheel_list_remove(&e->node);
+			if (e->period == 0) {
+				w->nb_timers--;
+				done[nb_done++] = e;
+			} else {
+				e->expiry += e->period;
+				swtim_wheel_insert(w, e);
+			}
+		}
+
+		/* The timers the events of which were not enqueued stay
+		 * armed, to be expired again on the next run.
+		 */
+		for (; i < n; i++)
+			if (entries[i]->period == 0)
+				rte_atomic_store_explicit(
+					&entries[i]->evtim->state,
+					RTE_EVENT_TIMER_ARMED,
+					rte_memory_order_relaxed);
+
+		if (nb_done > 0)
+			rte_mempool_put_bulk(sw->tim_pool, (void **)done,
+					     nb_done);
+
+		sw->stats.evtim_exp_count += nb_enq + nb_inv;
+		sw->stats.ev_enq_count += nb_enq;
+		sw->stats.ev_inv_count += nb_inv;
+
+		/* Retry on the next run when the event device is busy */
+		if (nb_enq + nb_inv < n)
+			break;
+	}
+}
+
+static int
+swtim_wheel_service_func(void *arg)
+{
+	struct rte_event_timer_adapter *adapter = arg;
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	const uint64_t prior_enq_count = sw->stats.ev_enq_count;
+	uint64_t now_tick = swtim_wheel_now(sw);
+	struct swtim_wheel *w;
+	unsigned int lcore;
+	int i, n_lcores;
+
+	n_lcores = rte_atomic_load_explicit(&sw->n_poll_lcores,
+					    rte_memory_order_relaxed);
+	for (i = 0; i < n_lcores; i++) {
+		lcore = rte_atomic_load_explicit(&sw->poll_lcores[i],
+						 rte_memory_order_relaxed);
+		w = &sw->wheels[lcore];
+
+		rte_spinlock_lock(&w->lock);
+		swtim_wheel_advance(w, now_tick);
+		swtim_wheel_expire(adapter, sw, w);
+		rte_spinlock_unlock(&w->lock);
+	}
+
+	if (now_tick != sw->last_tick) {
+		sw->last_tick = now_tick;
+		sw->stats.adapter_tick_count++;
+	}
+
+	rte_event_maintain(adapter->data->event_dev_id,
+			   adapter->data->event_port_id, 0);
+
+	return prior_enq_count == sw->stats.ev_enq_count ? -EAGAIN : 0;
+}
+
 /* The adapter initialization function rounds the mempool size up to the next
  * power of 2, so we can take the difference between that value and what the
  * user requested, and use the space for caches.  This avoids a scenario where a
@@ -945,7 +1304,9 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 				adapter->data->conf.nb_timers, nb_timers);
 	flags = 0; /* pool is multi-producer, multi-consumer */
 	sw->tim_pool = rte_mempool_create(pool_name, pool_size,
-			sizeof(struct rte_timer), cache_size, 0, NULL, NULL,
+			swtim_use_wheel(adapter) ?
+			sizeof(struct swtim_wheel_entry) : sizeof(struct rte_timer),
+			cache_size, 0, NULL, NULL,
 			NULL, NULL, adapter->data->socket_id, flags);
 	if (sw->tim_pool == NULL) {
 		EVTIM_LOG_ERR("failed to create timer object mempool");
@@ -957,21 +1318,33 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 	for (i = 0; i < RTE_MAX_LCORE; i++)
 		sw->in_use[i].v = 0;
 
-	/* Initialize the timer subsystem and allocate timer data instance */
-	ret = rte_timer_subsystem_init();
-	if (ret < 0) {
-		if (ret != -EALREADY) {
-			EVTIM_LOG_ERR("failed to initialize timer subsystem");
+	if (swtim_use_wheel(adapter)) {
+		/* The timing wheels replace the timer subsystem */
+		ret = swtim_wheel_init(sw, adapter->data->socket_id);
+		if (ret < 0) {
+			EVTIM_LOG_ERR("failed to allocate timing wheels");
 			rte_errno = -ret;
 			goto free_mempool;
 		}
-	}
+	} else {
+		/* Initialize the timer subsystem and allocate timer data
+		 * instance
+		 */
+		ret = rte_timer_subsystem_init();
+		if (ret < 0) {
+			if (ret != -EALREADY) {
+				EVTIM_LOG_ERR("failed to initialize timer subsystem");
+				rte_errno = -ret;
+				goto free_mempool;
+			}
+		}
 
-	ret = rte_timer_data_alloc(&sw->timer_data_id);
-	if (ret < 0) {
-		EVTIM_LOG_ERR("failed to allocate timer data instance");
-		rte_errno = -ret;
-		goto free_mempool;
+		ret = rte_timer_data_alloc(&sw->timer_data_id);
+		if (ret < 0) {
+			EVTIM_LOG_ERR("failed to allocate timer data instance");
+			rte_errno = -ret;
+			goto free_mempool;
+		}
 	}
 
 	/* Initialize timer event buffer */
@@ -984,7 +1357,8 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 	snprintf(service.name, RTE_SERVICE_NAME_MAX,
 		 "swtim_svc_%"PRIu8, adapter->data->id);
 	service.socket_id = adapter->data->socket_id;
-	service.callback = swtim_service_func;
+	service.callback = swtim_use_wheel(adapter) ?
+			swtim_wheel_service_func : swtim_service_func;
 	service.callback_userdata = adapter;
 	service.capabilities &= ~(RTE_SERVICE_CAP_MT_SAFE);
 	ret = rte_service_component_register(&service, &sw->service_id);
@@ -1005,6 +1379,7 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 
 	return 0;
 free_mempool:
+	rte_free(sw->wheels);
 	rte_mempool_free(sw->tim_pool);
 free_alloc:
 	rte_free(sw);
@@ -1168,29 +1543,14 @@ swtim_remaining_ticks_get(const struct rte_event_timer_adapter *adapter,
 	return 0;
 }
 
-static uint16_t
-__swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
-		struct rte_event_timer **evtims,
-		uint16_t nb_evtims)
+/* Return the lcore the timers armed by the caller are attached to */
+static __rte_always_inline uint32_t
+swtim_arm_lcore_get(struct swtim *sw)
 {
-	int i, ret;
-	struct swtim *sw = swtim_pmd_priv(adapter);
 	uint32_t lcore_id = rte_lcore_id();
-	struct rte_timer *tim, *tims[nb_evtims];
-	uint64_t cycles;
 	int n_lcores;
 	/* Timer list for this lcore is not in use. */
 	uint16_t exp_state = 0;
-	enum rte_event_timer_state n_state;
-	enum rte_timer_type type = SINGLE;
-
-#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
-	/* Check that the service is running. */
-	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
-		rte_errno = EINVAL;
-		return 0;
-	}
-#endif
 
 	/* Adjust lcore_id if non-EAL thread. Arbitrarily pick the timer list of
 	 * the highest lcore to insert such timers into
@@ -1215,6 +1575,32 @@ __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 				rte_memory_order_relaxed);
 	}
 
+	return lcore_id;
+}
+
+static uint16_t
+__swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer **evtims,
+		uint16_t nb_evtims)
+{
+	int i, ret;
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	uint32_t lcore_id;
+	struct rte_timer *tim, *tims[nb_evtims];
+	uint64_t cycles;
+	enum rte_event_timer_state n_state;
+	enum rte_timer_type type = SINGLE;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	lcore_id = swtim_arm_lcore_get(sw);
+
 	ret = rte_mempool_get_bulk(sw->tim_pool, (void **)tims,
 				   nb_evtims);
 	if (ret < 0) {
@@ -1384,6 +1770,252 @@ static const struct event_timer_adapter_ops swtim_ops = {
 	.remaining_ticks_get = swtim_remaining_ticks_get,
 };
 
+static int
+swtim_wheel_uninit(struct rte_event_timer_adapter *adapter)
+{
+	int ret;
+	struct swtim *sw = swtim_pmd_priv(adapter);
+
+	ret = rte_service_component_unregister(sw->service_id);
+	if (ret < 0) {
+		EVTIM_LOG_ERR("failed to unregister service component");
+		return ret;
+	}
+
+	/* The outstanding timers go away with the mempool */
+	rte_free(sw->wheels);
+	rte_mempool_free(sw->tim_pool);
+	rte_free(sw);
+	adapter->data->adapter_priv = NULL;
+
+	return 0;
+}
+
+static int
+swtim_wheel_remaining_ticks_get(const struct rte_event_timer_adapter *adapter,
+				const struct rte_event_timer *evtim,
+				uint64_t *ticks_remaining)
+{
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	enum rte_event_timer_state n_state;
+	struct swtim_wheel_entry *e;
+	uint64_t now_tick;
+
+	/* Check that timer is armed */
+	n_state = rte_atomic_load_explicit(&evtim->state, rte_memory_order_acquire);
+	if (n_state != RTE_EVENT_TIMER_ARMED)
+		return -EINVAL;
+
+	e = (struct swtim_wheel_entry *)(uintptr_t)evtim->impl_opaque[0];
+	now_tick = swtim_wheel_now(sw);
+	*ticks_remaining = e->expiry > now_tick ? e->expiry - now_tick : 0;
+
+	return 0;
+}
+
+static uint16_t
+__swtim_wheel_arm_burst(const struct rte_event_timer_adapter *adapter,
+			struct rte_event_timer **evtims,
+			uint16_t nb_evtims)
+{
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	struct swtim_wheel_entry *e, *entries[nb_evtims];
+	enum rte_event_timer_state n_state;
+	uint64_t timeout_nsecs, base_tick;
+	struct swtim_wheel *w;
+	uint32_t lcore_id;
+	bool periodic;
+	int i;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	lcore_id = swtim_arm_lcore_get(sw);
+
+	if (rte_mempool_get_bulk(sw->tim_pool, (void **)entries,
+				 nb_evtims) < 0) {
+		rte_errno = ENOSPC;
+		return 0;
+	}
+
+	periodic = get_timer_type(adapter) == PERIODICAL;
+	w = &sw->wheels[lcore_id];
+
+	rte_spinlock_lock(&w->lock);
+
+	/* An empty wheel may lag behind if the service did not run yet */
+	if (w->nb_timers == 0)
+		w->cur_tick = RTE_MAX(w->cur_tick, swtim_wheel_now(sw));
+	base_tick = RTE_MAX(w->cur_tick, swtim_wheel_next(sw));
+
+	for (i = 0; i < nb_evtims; i++) {
+		n_state = rte_atomic_load_explicit(&evtims[i]->state, rte_memory_order_acquire);
+		if (n_state == RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (!(n_state == RTE_EVENT_TIMER_NOT_ARMED ||
+			     n_state == RTE_EVENT_TIMER_CANCELED)) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		if (unlikely(check_destination_event_queue(evtims[i],
+							   adapter) < 0)) {
+			rte_atomic_store_explicit(&evtims[i]->state,
+					RTE_EVENT_TIMER_ERROR,
+					rte_memory_order_relaxed);
+			rte_errno = EINVAL;
+			break;
+		}
+
+		timeout_nsecs = evtims[i]->timeout_ticks * sw->timer_tick_ns;
+		if (unlikely(timeout_nsecs > sw->max_tmo_ns)) {
+			rte_atomic_store_explicit(&evtims[i]->state,
+					RTE_EVENT_TIMER_ERROR_TOOLATE,
+					rte_memory_order_relaxed);
+			rte_errno = EINVAL;
+			break;
+		} else if (unlikely(timeout_nsecs < sw->timer_tick_ns)) {
+			rte_atomic_store_explicit(&evtims[i]->state,
+					RTE_EVENT_TIMER_ERROR_TOOEARLY,
+					rte_memory_order_relaxed);
+			rte_errno = EINVAL;
+			break;
+		}
+
+		e = entries[i];
+		e->evtim = evtims[i];
+		e->expiry = base_tick + evtims[i]->timeout_ticks;
+		e->period = periodic ? evtims[i]->timeout_ticks : 0;
+		e->lcore_id = lcore_id;
+		swtim_wheel_insert(w, e);
+		w->nb_timers++;
+
+		evtims[i]->impl_opaque[0] = (uintptr_t)e;
+		evtims[i]->impl_opaque[1] = (uintptr_t)adapter;
+
+		EVTIM_LOG_DBG("armed an event timer");
+		/* RELEASE ordering guarantees the adapter specific value
+		 * changes observed before the update of state.
+		 */
+		rte_atomic_store_explicit(&evtims[i]->state, RTE_EVENT_TIMER_ARMED,
+				rte_memory_order_release);
+	}
+
+	rte_spinlock_unlock(&w->lock);
+
+	if (i < nb_evtims)
+		rte_mempool_put_bulk(sw->tim_pool,
+				     (void **)&entries[i], nb_evtims - i);
+
+	return i;
+}
+
+static uint16_t
+swtim_wheel_arm_burst(const struct rte_event_timer_adapter *adapter,
+		      struct rte_event_timer **evtims,
+		      uint16_t nb_evtims)
+{
+	return __swtim_wheel_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static uint16_t
+swtim_wheel_arm_tmo_tick_burst(const struct rte_event_timer_adapter *adapter,
+			       struct rte_event_timer **evtims,
+			       uint64_t timeout_ticks,
+			       uint16_t nb_evtims)
+{
+	int i;
+
+	for (i = 0; i < nb_evtims; i++)
+		evtims[i]->timeout_ticks = timeout_ticks;
+
+	return __swtim_wheel_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static uint16_t
+swtim_wheel_cancel_burst(const struct rte_event_timer_adapter *adapter,
+			 struct rte_event_timer **evtims,
+			 uint16_t nb_evtims)
+{
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	enum rte_event_timer_state n_state;
+	struct swtim_wheel_entry *e;
+	struct swtim_wheel *w;
+	int i;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	for (i = 0; i < nb_evtims; i++) {
+		/* ACQUIRE ordering guarantees the access of implementation
+		 * specific opaque data under the correct state.
+		 */
+		n_state = rte_atomic_load_explicit(&evtims[i]->state, rte_memory_order_acquire);
+		if (n_state == RTE_EVENT_TIMER_CANCELED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (n_state != RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		e = (struct swtim_wheel_entry *)(uintptr_t)evtims[i]->impl_opaque[0];
+		RTE_ASSERT(e != NULL);
+		w = &sw->wheels[e->lcore_id];
+
+		rte_spinlock_lock(&w->lock);
+
+		/* The timer may have expired since its state was read */
+		if (rte_atomic_load_explicit(&evtims[i]->state,
+				rte_memory_order_relaxed) != RTE_EVENT_TIMER_ARMED) {
+			rte_spinlock_unlock(&w->lock);
+			rte_errno = EINVAL;
+			break;
+		}
+
+		swtim_wheel_list_remove(&e->node);
+		w->nb_timers--;
+
+		/* The RELEASE ordering here pairs with atomic ordering
+		 * to make sure the state update data observed between
+		 * threads.
+		 */
+		rte_atomic_store_explicit(&evtims[i]->state, RTE_EVENT_TIMER_CANCELED,
+				rte_memory_order_release);
+
+		rte_spinlock_unlock(&w->lock);
+
+		rte_mempool_put(sw->tim_pool, e);
+	}
+
+	return i;
+}
+
+static const struct event_timer_adapter_ops swtim_wheel_ops = {
+	.init = swtim_init,
+	.uninit = swtim_wheel_uninit,
+	.start = swtim_start,
+	.stop = swtim_stop,
+	.get_info = swtim_get_info,
+	.stats_get = swtim_stats_get,
+	.stats_reset = swtim_stats_reset,
+	.arm_burst = swtim_wheel_arm_burst,
+	.arm_tmo_tick_burst = swtim_wheel_arm_tmo_tick_burst,
+	.cancel_burst = swtim_wheel_cancel_burst,
+	.remaining_ticks_get = swtim_wheel_remaining_ticks_get,
+};
+
 static int
 handle_ta_info(const char *cmd __rte_unused, const char *params,
 		struct rte_tel_data *d)
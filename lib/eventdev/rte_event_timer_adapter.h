@@ -157,6 +157,17 @@ enum rte_event_timer_adapter_clk_src {
  * @see struct rte_event_timer_adapter_conf::flags
  */
 
+#define RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL	(1ULL << 3)
+/**< Flag to configure the software event timer adapter with per lcore
+ * hierarchical timing wheels aligned to the adapter tick, instead of the timer
+ * library. Arming and canceling a timer are O(1), and the events of the
+ * expired timers are enqueued in bursts. A timer expires on the first adapter
+ * tick boundary following its timeout. The flag is ignored by the adapters
+ * implemented by an event device PMD.
+ *
+ * @see struct rte_event_timer_adapter_conf::flags
+ */
+
 /**
  * Timer adapter configuration structure
  */
@@ -1298,6 +1298,34 @@ rte_event_dev_service_id_get(uint8_t dev_id, uint32_t *service_id)
 	return dev->data->service_inited ? 0 : -ESRCH;
 }
 
+int
+rte_event_dev_service_ids_get(uint8_t dev_id, uint32_t service_ids[], uint32_t n)
+{
+	struct rte_eventdev *dev;
+	int count;
+
+	RTE_EVENTDEV_VALID_DEVID_OR_ERR_RET(dev_id, -EINVAL);
+	dev = &rte_eventdevs[dev_id];
+
+	if (service_ids == NULL && n != 0)
+		return -EINVAL;
+
+	if (!dev->data->service_inited)
+		return -ESRCH;
+
+	if (dev->dev_ops->service_ids_get != NULL) {
+		count = (*dev->dev_ops->service_ids_get)(dev, service_ids, n);
+	} else {
+		if (n != 0)
+			service_ids[0] = dev->data->service_id;
+		count = 1;
+	}
+
+	rte_eventdev_trace_service_ids_get(dev_id, n, count);
+
+	return count;
+}
+
 int
 rte_event_dev_dump(uint8_t dev_id, FILE *f)
 {
@@ -2362,6 +2362,30 @@ rte_event_port_profile_links_get(uint8_t dev_id, uint8_t port_id, uint8_t queues
 int
 rte_event_dev_service_id_get(uint8_t dev_id, uint32_t *service_id);
 
+/**
+ * Retrieve the service IDs of the event dev, when its scheduling is split
+ * over several rte_service functions which all need to be run. The first
+ * service ID is the one returned by rte_event_dev_service_id_get().
+ *
+ * @param dev_id
+ *   The identifier of the device.
+ *
+ * @param [out] service_ids
+ *   An array to be filled in with up to *n* service IDs.
+ *
+ * @param n
+ *   The number of elements in the *service_ids* array.
+ *
+ * @return
+ *   - >0: The number of services of the event dev. When greater than *n*,
+ *   only the first *n* service IDs are filled in.
+ *   - <0: Error code on failure, if the event dev doesn't use a rte_service
+ *   function, this function returns -ESRCH.
+ */
+__rte_experimental
+int
+rte_event_dev_service_ids_get(uint8_t dev_id, uint32_t service_ids[], uint32_t n);
+
 /**
  * Dump internal information about *dev_id* to the FILE* provided in *f*.
  *
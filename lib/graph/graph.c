@@ -331,11 +331,14 @@ rte_graph_model_mcore_dispatch_core_bind(rte_graph_t id, int lcore)
 		if (graph->id == id)
 			break;
 
-	if (graph->graph->model != RTE_GRAPH_MODEL_MCORE_DISPATCH)
+	if (graph->graph->model == RTE_GRAPH_MODEL_MCORE_DISPATCH)
+		graph->graph->dispatch.lcore_id = lcore;
+	else if (graph->graph->model == RTE_GRAPH_MODEL_WORK_STEAL)
+		graph->graph->work_steal.lcore_id = lcore;
+	else
 		goto fail;
 
 	graph->lcore_id = lcore;
-	graph->graph->dispatch.lcore_id = graph->lcore_id;
 	graph->socket = rte_lcore_to_socket_id(lcore);
 
 	/* check the availability of source node */
@@ -360,7 +363,10 @@ rte_graph_model_mcore_dispatch_core_unbind(rte_graph_t id)
 			break;
 
 	graph->lcore_id = RTE_MAX_LCORE;
-	graph->graph->dispatch.lcore_id = RTE_MAX_LCORE;
+	if (graph->graph->model == RTE_GRAPH_MODEL_WORK_STEAL)
+		graph->graph->work_steal.lcore_id = RTE_MAX_LCORE;
+	else
+		graph->graph->dispatch.lcore_id = RTE_MAX_LCORE;
 
 fail:
 	return;
@@ -499,6 +505,9 @@ rte_graph_destroy(rte_graph_t id)
 			if (rte_graph_worker_model_get(graph->graph) ==
 			    RTE_GRAPH_MODEL_MCORE_DISPATCH)
 				graph_sched_wq_destroy(graph);
+			else if (rte_graph_worker_model_get(graph->graph) ==
+				 RTE_GRAPH_MODEL_WORK_STEAL)
+				graph_work_steal_dq_destroy(graph);
 
 			/* Call fini() of the all the nodes in the graph */
 			graph_node_fini(graph);
@@ -577,6 +586,11 @@ graph_clone(struct graph *parent_graph, const char *name, struct rte_graph_param
 	    graph_sched_wq_create(graph, parent_graph, prm))
 		goto graph_mem_destroy;
 
+	/* Create the graph work stealing deque */
+	if (rte_graph_worker_model_get(graph->graph) == RTE_GRAPH_MODEL_WORK_STEAL &&
+	    graph_work_steal_dq_create(graph, parent_graph, prm))
+		goto graph_mem_destroy;
+
 	/* Call init() of the all the nodes in the graph */
 	if (graph_node_init(graph))
 		goto graph_mem_destroy;
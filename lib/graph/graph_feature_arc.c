@@ -0,0 +1,658 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_bitops.h>
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_spinlock.h>
+
+#include "graph_private.h"
+#include "rte_graph_feature_arc.h"
+
+/* Maximum number of start nodes of an arc, not counting their clones */
+#define FEATURE_ARC_MAX_STARTS 4
+
+/* Control data of an index */
+struct feature_index {
+	rte_node_t end;    /* End node, RTE_NODE_ID_INVALID if not set */
+	uint32_t enabled;  /* Bitmap of the enabled features */
+	uint32_t user_data[RTE_GRAPH_FEATURE_MAX_PER_ARC];
+};
+
+struct feature_arc {
+	struct rte_graph_feature_arc arc; /* Fast path view */
+	STAILQ_ENTRY(feature_arc) next;
+	char name[RTE_GRAPH_FEATURE_ARC_NAMELEN];
+	rte_node_t starts[FEATURE_ARC_MAX_STARTS]; /* First one given at creation */
+	uint16_t nb_starts;
+	rte_node_t end; /* Default end node */
+	uint16_t max_indexes;
+	uint16_t nb_features;
+	rte_node_t features[RTE_GRAPH_FEATURE_MAX_PER_ARC];
+	/* Fast path copies, cur is the one published to the workers */
+	struct rte_graph_feature_arc_fp *fp[2];
+	unsigned int cur;
+	/* Grace period of the other copy, if it may still be in use */
+	struct rte_rcu_qsbr *qsbr;
+	uint64_t token;
+	struct feature_index indexes[];
+};
+
+static STAILQ_HEAD(feature_arc_head, feature_arc) feature_arc_list =
+	STAILQ_HEAD_INITIALIZER(feature_arc_list);
+/* Serialize the control path operations on the arcs */
+static rte_spinlock_t feature_arc_lock = RTE_SPINLOCK_INITIALIZER;
+
+static inline struct feature_arc *
+feature_arc_get(struct rte_graph_feature_arc *arc)
+{
+	return container_of(arc, struct feature_arc, arc);
+}
+
+static struct feature_arc *
+feature_arc_from_name(const char *name)
+{
+	struct feature_arc *fa;
+
+	STAILQ_FOREACH(fa, &feature_arc_list, next)
+		if (strncmp(fa->name, name, RTE_GRAPH_FEATURE_ARC_NAMELEN) == 0)
+			return fa;
+
+	return NULL;
+}
+
+static bool
+graph_exists(void)
+{
+	return !STAILQ_EMPTY(graph_list_head_get());
+}
+
+static rte_node_t
+node_parent_get(rte_node_t id)
+{
+	rte_node_t parent = RTE_NODE_ID_INVALID;
+	struct node *node;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(node, node_list_head_get(), next) {
+		if (node->id == id) {
+			parent = node->parent_id;
+			break;
+		}
+	}
+	graph_spinlock_unlock();
+
+	return parent;
+}
+
+/* Get the edge of a node to another node */
+static rte_edge_t
+node_edge_find(rte_node_t id, rte_node_t next_id)
+{
+	rte_edge_t i, edge = RTE_EDGE_ID_INVALID;
+	const char *name;
+	struct node *node;
+
+	name = rte_node_id_to_name(next_id);
+	if (name == NULL)
+		return RTE_EDGE_ID_INVALID;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(node, node_list_head_get(), next) {
+		if (node->id != id)
+			continue;
+		for (i = 0; i < node->nb_edges; i++) {
+			if (strncmp(node->next_nodes[i], name, RTE_NODE_NAMESIZE) == 0) {
+				edge = i;
+				break;
+			}
+		}
+		break;
+	}
+	graph_spinlock_unlock();
+
+	return edge;
+}
+
+/* Get the edge of a node to another node, adding it if needed */
+static rte_edge_t
+node_edge_add(rte_node_t id, rte_node_t next_id)
+{
+	const char *name;
+	rte_edge_t edge;
+
+	edge = node_edge_find(id, next_id);
+	if (edge != RTE_EDGE_ID_INVALID)
+		return edge;
+
+	name = rte_node_id_to_name(next_id);
+	if (rte_node_edge_update(id, RTE_EDGE_ID_INVALID, &name, 1) != 1)
+		return RTE_EDGE_ID_INVALID;
+
+	/* The edge is the last one added */
+	return rte_node_edge_count(id) - 1;
+}
+
+static bool
+feature_arc_is_start(struct feature_arc *fa, rte_node_t id)
+{
+	uint16_t i;
+
+	for (i = 0; i < fa->nb_starts; i++)
+		if (fa->starts[i] == id)
+			return true;
+
+	return false;
+}
+
+/*
+ * Add an edge from the start nodes and from their clones to a feature.
+ * The fast path data has a single edge for all of them, so it must be
+ * the same in every start node and clone.
+ */
+static int
+start_edge_add(struct feature_arc *fa, rte_node_t feature)
+{
+	rte_edge_t edge;
+	rte_node_t id;
+	uint16_t i;
+
+	edge = node_edge_add(fa->starts[0], feature);
+	if (edge == RTE_EDGE_ID_INVALID)
+		return -ENOMEM;
+
+	for (i = 1; i < fa->nb_starts; i++) {
+		if (node_edge_add(fa->starts[i], feature) != edge) {
+			graph_err("Start node %s of arc %s has different edges",
+				  rte_node_id_to_name(fa->starts[i]), fa->name);
+			return -EINVAL;
+		}
+	}
+
+	for (id = 0; id < rte_node_max_count(); id++) {
+		if (!feature_arc_is_start(fa, node_parent_get(id)))
+			continue;
+		if (node_edge_add(id, feature) != edge) {
+			graph_err("Clone %s of arc %s start node has different edges",
+				  rte_node_id_to_name(id), fa->name);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static int
+feature_find(struct feature_arc *fa, const char *feature_node)
+{
+	rte_node_t id;
+	uint16_t i;
+
+	if (feature_node == NULL)
+		return -EINVAL;
+
+	id = rte_node_from_name(feature_node);
+	for (i = 0; i < fa->nb_features; i++)
+		if (fa->features[i] == id)
+			return i;
+
+	return -ENOENT;
+}
+
+/* Fill a fast path copy from the control data */
+static void
+feature_arc_fp_build(struct feature_arc *fa, struct rte_graph_feature_arc_fp *fp)
+{
+	struct rte_graph_feature_data *data;
+	struct feature_index *idx;
+	uint16_t i, slot, next;
+	rte_node_t node;
+
+	fp->stride = fa->nb_features + 1;
+	fp->max_indexes = fa->max_indexes;
+	fp->nb_enabled = 0;
+
+	for (i = 0; i < fa->max_indexes; i++) {
+		idx = &fa->indexes[i];
+		data = &fp->data[i * fp->stride];
+		fp->nb_enabled += rte_popcount32(idx->enabled);
+
+		/* Slot 0 is the start node, slot n is the feature n - 1 */
+		for (slot = 0; slot < fp->stride; slot++) {
+			node = slot == 0 ? fa->starts[0] : fa->features[slot - 1];
+
+			/* Find the next enabled feature */
+			for (next = slot; next < fa->nb_features; next++)
+				if (idx->enabled & RTE_BIT32(next))
+					break;
+
+			if (next < fa->nb_features)
+				data[slot].next_edge = node_edge_find(node,
+						fa->features[next]);
+			else if (slot != 0 && idx->end != RTE_NODE_ID_INVALID)
+				data[slot].next_edge = node_edge_find(node, idx->end);
+			else
+				data[slot].next_edge = RTE_EDGE_ID_INVALID;
+
+			data[slot].user_data = slot == 0 ? 0 : idx->user_data[slot - 1];
+		}
+	}
+}
+
+/*
+ * Wait until the workers stopped using the copy not published, before
+ * rebuilding it. Called with the lock held, released while waiting.
+ */
+static void
+feature_arc_unused_wait(struct feature_arc *fa)
+{
+	struct rte_rcu_qsbr *qsbr;
+	uint64_t token;
+
+	while (fa->qsbr != NULL) {
+		qsbr = fa->qsbr;
+		token = fa->token;
+		if (rte_rcu_qsbr_check(qsbr, token, false) == 1) {
+			fa->qsbr = NULL;
+			break;
+		}
+
+		rte_spinlock_unlock(&feature_arc_lock);
+		rte_rcu_qsbr_check(qsbr, token, true);
+		rte_spinlock_lock(&feature_arc_lock);
+	}
+}
+
+/*
+ * Switch the workers to a new fast path copy.
+ * Returns the token of the grace period of the previous copy,
+ * to be waited for once the lock is released.
+ */
+static uint64_t
+feature_arc_publish(struct feature_arc *fa, struct rte_rcu_qsbr *qsbr)
+{
+	unsigned int next = fa->cur ^ 1;
+
+	feature_arc_fp_build(fa, fa->fp[next]);
+	rte_atomic_store_explicit(&fa->arc.fp, fa->fp[next],
+				  rte_memory_order_release);
+	fa->cur = next;
+
+	/* The previous copy is rebuilt on next update, after its readers */
+	fa->qsbr = qsbr;
+	if (qsbr != NULL)
+		fa->token = rte_rcu_qsbr_start(qsbr);
+
+	return fa->token;
+}
+
+struct rte_graph_feature_arc *
+rte_graph_feature_arc_create(const char *name, const char *start_node,
+			     const char *end_node, uint16_t max_indexes)
+{
+	struct feature_arc *fa = NULL;
+	rte_node_t start, end;
+	size_t fp_sz;
+	uint16_t i;
+
+	if (name == NULL || start_node == NULL || max_indexes == 0)
+		SET_ERR_JMP(EINVAL, fail, "Invalid feature arc parameters");
+
+	start = rte_node_from_name(start_node);
+	if (start == RTE_NODE_ID_INVALID)
+		SET_ERR_JMP(EINVAL, fail, "Start node %s not found", start_node);
+
+	end = RTE_NODE_ID_INVALID;
+	if (end_node != NULL) {
+		end = rte_node_from_name(end_node);
+		if (end == RTE_NODE_ID_INVALID)
+			SET_ERR_JMP(EINVAL, fail, "End node %s not found", end_node);
+	}
+
+	rte_spinlock_lock(&feature_arc_lock);
+
+	if (feature_arc_from_name(name) != NULL)
+		SET_ERR_JMP(EEXIST, unlock, "Feature arc %s already exists", name);
+
+	fa = rte_zmalloc("graph_feature_arc", sizeof(*fa) +
+			 max_indexes * sizeof(struct feature_index), 0);
+	if (fa == NULL)
+		SET_ERR_JMP(ENOMEM, unlock, "Failed to allocate feature arc %s", name);
+
+	if (rte_strscpy(fa->name, name, sizeof(fa->name)) < 0)
+		SET_ERR_JMP(E2BIG, free, "Feature arc name %s too long", name);
+
+	fa->starts[0] = start;
+	fa->nb_starts = 1;
+	fa->end = end;
+	fa->max_indexes = max_indexes;
+	for (i = 0; i < max_indexes; i++)
+		fa->indexes[i].end = end;
+
+	fp_sz = sizeof(struct rte_graph_feature_arc_fp) + max_indexes *
+		(RTE_GRAPH_FEATURE_MAX_PER_ARC + 1) * sizeof(struct rte_graph_feature_data);
+	for (i = 0; i < RTE_DIM(fa->fp); i++) {
+		fa->fp[i] = rte_zmalloc("graph_feature_arc_fp", fp_sz,
+					RTE_CACHE_LINE_SIZE);
+		if (fa->fp[i] == NULL)
+			SET_ERR_JMP(ENOMEM, free, "Failed to allocate feature arc %s",
+				    name);
+	}
+
+	feature_arc_fp_build(fa, fa->fp[0]);
+	rte_atomic_store_explicit(&fa->arc.fp, fa->fp[0], rte_memory_order_release);
+
+	STAILQ_INSERT_TAIL(&feature_arc_list, fa, next);
+	rte_spinlock_unlock(&feature_arc_lock);
+
+	return &fa->arc;
+free:
+	rte_free(fa->fp[0]);
+	rte_free(fa->fp[1]);
+	rte_free(fa);
+unlock:
+	rte_spinlock_unlock(&feature_arc_lock);
+fail:
+	return NULL;
+}
+
+struct rte_graph_feature_arc *
+rte_graph_feature_arc_lookup(const char *name)
+{
+	struct feature_arc *fa;
+
+	if (name == NULL)
+		return NULL;
+
+	rte_spinlock_lock(&feature_arc_lock);
+	fa = feature_arc_from_name(name);
+	rte_spinlock_unlock(&feature_arc_lock);
+
+	return fa != NULL ? &fa->arc : NULL;
+}
+
+int
+rte_graph_feature_arc_destroy(struct rte_graph_feature_arc *arc)
+{
+	struct feature_arc *fa;
+
+	if (arc == NULL)
+		return -EINVAL;
+
+	fa = feature_arc_get(arc);
+	rte_spinlock_lock(&feature_arc_lock);
+	STAILQ_REMOVE(&feature_arc_list, fa, feature_arc, next);
+	rte_spinlock_unlock(&feature_arc_lock);
+
+	rte_free(fa->fp[0]);
+	rte_free(fa->fp[1]);
+	rte_free(fa);
+
+	return 0;
+}
+
+int
+rte_graph_feature_arc_start_add(struct rte_graph_feature_arc *arc,
+				const char *start_node)
+{
+	struct feature_arc *fa;
+	rte_node_t start, id;
+	rte_edge_t edge;
+	int rc = 0;
+	uint16_t i;
+
+	if (arc == NULL || start_node == NULL)
+		return -EINVAL;
+
+	start = rte_node_from_name(start_node);
+	if (start == RTE_NODE_ID_INVALID)
+		return -ENOENT;
+
+	fa = feature_arc_get(arc);
+	rte_spinlock_lock(&feature_arc_lock);
+	if (graph_exists()) {
+		graph_err("Feature arc %s start node must be added before creating graphs",
+			  fa->name);
+		rc = -EBUSY;
+		goto unlock;
+	}
+	if (feature_arc_is_start(fa, start)) {
+		rc = -EEXIST;
+		goto unlock;
+	}
+	if (fa->nb_starts == FEATURE_ARC_MAX_STARTS) {
+		rc = -ENOSPC;
+		goto unlock;
+	}
+
+	/* Edges to the features already in the arc, matching the first start */
+	for (i = 0; i < fa->nb_features; i++) {
+		edge = node_edge_find(fa->starts[0], fa->features[i]);
+		if (node_edge_add(start, fa->features[i]) != edge) {
+			graph_err("Start node %s of arc %s has different edges",
+				  start_node, fa->name);
+			rc = -EINVAL;
+			goto unlock;
+		}
+		for (id = 0; id < rte_node_max_count(); id++) {
+			if (node_parent_get(id) == start &&
+			    node_edge_add(id, fa->features[i]) != edge) {
+				graph_err("Clone %s of arc %s start node has different edges",
+					  rte_node_id_to_name(id), fa->name);
+				rc = -EINVAL;
+				goto unlock;
+			}
+		}
+	}
+
+	fa->starts[fa->nb_starts++] = start;
+unlock:
+	rte_spinlock_unlock(&feature_arc_lock);
+	return rc;
+}
+
+int
+rte_graph_feature_arc_end_set(struct rte_graph_feature_arc *arc, uint16_t index,
+			      const char *end_node)
+{
+	struct feature_arc *fa;
+	rte_node_t end;
+	int rc = 0;
+	uint16_t i;
+
+	if (arc == NULL || end_node == NULL)
+		return -EINVAL;
+
+	fa = feature_arc_get(arc);
+	if (index >= fa->max_indexes)
+		return -EINVAL;
+
+	end = rte_node_from_name(end_node);
+	if (end == RTE_NODE_ID_INVALID)
+		return -ENOENT;
+
+	rte_spinlock_lock(&feature_arc_lock);
+	if (graph_exists()) {
+		graph_err("Feature arc %s end node must be set before creating graphs",
+			  fa->name);
+		rc = -EBUSY;
+		goto unlock;
+	}
+
+	for (i = 0; i < fa->nb_features; i++) {
+		if (node_edge_add(fa->features[i], end) == RTE_EDGE_ID_INVALID) {
+			rc = -ENOMEM;
+			goto unlock;
+		}
+	}
+	fa->indexes[index].end = end;
+unlock:
+	rte_spinlock_unlock(&feature_arc_lock);
+	return rc;
+}
+
+int
+rte_graph_feature_add(struct rte_graph_feature_arc *arc, const char *feature_node)
+{
+	struct feature_arc *fa;
+	rte_node_t feature;
+	uint16_t i;
+	int rc;
+
+	if (arc == NULL || feature_node == NULL)
+		return -EINVAL;
+
+	feature = rte_node_from_name(feature_node);
+	if (feature == RTE_NODE_ID_INVALID)
+		return -ENOENT;
+
+	fa = feature_arc_get(arc);
+	rte_spinlock_lock(&feature_arc_lock);
+
+	if (graph_exists()) {
+		graph_err("Feature %s must be added to arc %s before creating graphs",
+			  feature_node, fa->name);
+		rc = -EBUSY;
+		goto unlock;
+	}
+	if (feature_find(fa, feature_node) >= 0) {
+		rc = -EEXIST;
+		goto unlock;
+	}
+	if (fa->nb_features == RTE_GRAPH_FEATURE_MAX_PER_ARC) {
+		rc = -ENOSPC;
+		goto unlock;
+	}
+
+	/* Edges to the new feature */
+	rc = start_edge_add(fa, feature);
+	if (rc < 0)
+		goto unlock;
+	for (i = 0; i < fa->nb_features; i++) {
+		if (node_edge_add(fa->features[i], feature) == RTE_EDGE_ID_INVALID) {
+			rc = -ENOMEM;
+			goto unlock;
+		}
+	}
+
+	/* Edges from the new feature to the end nodes */
+	for (i = 0; i < fa->max_indexes; i++) {
+		if (fa->indexes[i].end == RTE_NODE_ID_INVALID)
+			continue;
+		if (node_edge_add(feature, fa->indexes[i].end) == RTE_EDGE_ID_INVALID) {
+			rc = -ENOMEM;
+			goto unlock;
+		}
+	}
+
+	fa->features[fa->nb_features] = feature;
+	rc = fa->nb_features++;
+	graph_dbg("Feature %s added to arc %s at %d", feature_node, fa->name, rc);
+unlock:
+	rte_spinlock_unlock(&feature_arc_lock);
+	return rc;
+}
+
+int
+rte_graph_feature_lookup(struct rte_graph_feature_arc *arc, const char *feature_node)
+{
+	int rc;
+
+	if (arc == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&feature_arc_lock);
+	rc = feature_find(feature_arc_get(arc), feature_node);
+	rte_spinlock_unlock(&feature_arc_lock);
+
+	return rc;
+}
+
+int
+rte_graph_feature_enable(struct rte_graph_feature_arc *arc, uint16_t index,
+			 const char *feature_node, uint32_t user_data,
+			 struct rte_rcu_qsbr *qsbr)
+{
+	struct feature_index *idx;
+	struct feature_arc *fa;
+	uint64_t token = 0;
+	bool wait = false;
+	int pos;
+
+	if (arc == NULL)
+		return -EINVAL;
+
+	fa = feature_arc_get(arc);
+	if (index >= fa->max_indexes)
+		return -EINVAL;
+
+	rte_spinlock_lock(&feature_arc_lock);
+	feature_arc_unused_wait(fa);
+	pos = feature_find(fa, feature_node);
+	if (pos < 0)
+		goto unlock;
+
+	idx = &fa->indexes[index];
+	if (idx->end == RTE_NODE_ID_INVALID) {
+		graph_err("Feature arc %s has no end node for index %u",
+			  fa->name, index);
+		pos = -ENOENT;
+		goto unlock;
+	}
+
+	idx->enabled |= RTE_BIT32(pos);
+	idx->user_data[pos] = user_data;
+	token = feature_arc_publish(fa, qsbr);
+	wait = qsbr != NULL;
+	pos = 0;
+unlock:
+	rte_spinlock_unlock(&feature_arc_lock);
+
+	/* Once returned, no worker uses the previous data */
+	if (wait)
+		rte_rcu_qsbr_check(qsbr, token, true);
+	return pos;
+}
+
+int
+rte_graph_feature_disable(struct rte_graph_feature_arc *arc, uint16_t index,
+			  const char *feature_node, struct rte_rcu_qsbr *qsbr)
+{
+	struct feature_index *idx;
+	struct feature_arc *fa;
+	uint64_t token = 0;
+	bool wait = false;
+	int pos;
+
+	if (arc == NULL)
+		return -EINVAL;
+
+	fa = feature_arc_get(arc);
+	if (index >= fa->max_indexes)
+		return -EINVAL;
+
+	rte_spinlock_lock(&feature_arc_lock);
+	feature_arc_unused_wait(fa);
+	pos = feature_find(fa, feature_node);
+	if (pos < 0)
+		goto unlock;
+
+	idx = &fa->indexes[index];
+	if (idx->enabled & RTE_BIT32(pos)) {
+		idx->enabled &= ~RTE_BIT32(pos);
+		idx->user_data[pos] = 0;
+		token = feature_arc_publish(fa, qsbr);
+		wait = qsbr != NULL;
+	}
+	pos = 0;
+unlock:
+	rte_spinlock_unlock(&feature_arc_lock);
+
+	/* Once returned, no worker uses the feature on this index */
+	if (wait)
+		rte_rcu_qsbr_check(qsbr, token, true);
+	return pos;
+}
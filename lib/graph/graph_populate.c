@@ -48,6 +48,12 @@ graph_fp_mem_calc_size(struct graph *graph)
 		sz = RTE_ALIGN(sz, RTE_CACHE_LINE_SIZE);
 		sz += sizeof(uint64_t) * graph_node->node->xstats->nb_xstats;
 	}
+	sz = RTE_ALIGN(sz, RTE_CACHE_LINE_SIZE);
+	graph->hist_start = sz;
+	/* Walk histogram followed by 0..N node objects histograms */
+	if (rte_graph_has_histogram_feature())
+		sz += sizeof(uint64_t) * RTE_GRAPH_HIST_BUCKETS +
+		      sizeof(struct rte_node_histogram) * graph->node_count;
 
 	graph->mem_sz = sz;
 	return sz;
@@ -64,6 +70,7 @@ graph_header_popluate(struct graph *_graph)
 	graph->nb_nodes = _graph->node_count;
 	graph->cir_start = RTE_PTR_ADD(graph, _graph->cir_start);
 	graph->nodes_start = _graph->nodes_start;
+	graph->hist_off = _graph->hist_start;
 	graph->socket = _graph->socket;
 	graph->id = _graph->id;
 	memcpy(graph->name, _graph->name, RTE_GRAPH_NAMESIZE);
@@ -73,6 +80,7 @@ graph_header_popluate(struct graph *_graph)
 static void
 graph_nodes_populate(struct graph *_graph)
 {
+	rte_graph_off_t hist_off = _graph->hist_start + sizeof(uint64_t) * RTE_GRAPH_HIST_BUCKETS;
 	rte_graph_off_t xstat_off = _graph->xstats_start;
 	rte_graph_off_t off = _graph->nodes_start;
 	struct rte_graph *graph = _graph->graph;
@@ -115,6 +123,11 @@ graph_nodes_populate(struct graph *_graph)
 			xstat_off = RTE_ALIGN(xstat_off, RTE_CACHE_LINE_SIZE);
 		}
 
+		if (rte_graph_has_histogram_feature()) {
+			node->hist_off = hist_off - node->off;
+			hist_off += sizeof(struct rte_node_histogram);
+		}
+
 		off += sizeof(struct rte_node *) * nb_edges;
 		off = RTE_ALIGN(off, RTE_CACHE_LINE_SIZE);
 		node->next = off;
@@ -77,6 +77,18 @@ struct __rte_cache_aligned graph_mcore_dispatch_wq_node {
 	void *objs[RTE_GRAPH_BURST_SIZE];
 };
 
+/**
+ * @internal
+ *
+ * Structure that holds a work item of the graph work stealing deque.
+ * Used for work stealing model.
+ */
+struct __rte_cache_aligned graph_work_steal_item {
+	rte_graph_off_t node_off;
+	uint16_t nb_objs;
+	void *objs[];
+};
+
 /**
  * @internal
  *
@@ -105,6 +117,8 @@ struct graph {
 	/**< Node memory start offset in graph reel. */
 	rte_graph_off_t xstats_start;
 	/**< Node xstats memory start offset in graph reel. */
+	rte_graph_off_t hist_start;
+	/**< Walk and node histograms memory start offset in graph reel. */
 	rte_node_t src_node_count;
 	/**< Number of source nodes in a graph. */
 	struct rte_graph *graph;
@@ -448,4 +462,35 @@ int graph_sched_wq_create(struct graph *_graph, struct graph *_parent_graph,
  */
 void graph_sched_wq_destroy(struct graph *_graph);
 
+/**
+ * @internal
+ *
+ * Create the graph work stealing deque for work stealing model.
+ * All cloned graphs attached to the parent graph MUST be destroyed together,
+ * as they steal from each other.
+ *
+ * @param _graph
+ *   The graph object
+ * @param _parent_graph
+ *   The parent graph object which holds the list of graphs sharing the work.
+ * @param prm
+ *   Graph parameter, includes model-specific parameters in this graph.
+ *
+ * @return
+ *   - 0: Success.
+ *   - <0: Graph work stealing deque related error.
+ */
+int graph_work_steal_dq_create(struct graph *_graph, struct graph *_parent_graph,
+			       struct rte_graph_param *prm);
+
+/**
+ * @internal
+ *
+ * Destroy the graph work stealing deque for work stealing model.
+ *
+ * @param _graph
+ *   The graph object
+ */
+void graph_work_steal_dq_destroy(struct graph *_graph);
+
 #endif /* _RTE_GRAPH_PRIVATE_H_ */
@@ -191,7 +191,8 @@ stats_mem_init(struct cluster *cluster,
 	fn = prm->fn;
 	if (fn == NULL) {
 		const struct rte_graph *graph = cluster->graphs[0]->graph;
-		if (graph->model == RTE_GRAPH_MODEL_MCORE_DISPATCH)
+		if (graph->model == RTE_GRAPH_MODEL_MCORE_DISPATCH ||
+		    graph->model == RTE_GRAPH_MODEL_WORK_STEAL)
 			fn = graph_cluster_stats_cb_dispatch;
 		else
 			fn = graph_cluster_stats_cb_rtc;
@@ -294,6 +295,17 @@ stats_mem_populate(struct rte_graph_cluster_stats **stats_in,
 		}
 	}
 
+	if (rte_graph_has_histogram_feature()) {
+		cluster->stat.hist = rte_zmalloc_socket(NULL, sizeof(struct rte_node_histogram),
+							RTE_CACHE_LINE_SIZE, stats->socket_id);
+		if (cluster->stat.hist == NULL) {
+			rte_free(cluster->stat.xstat_count);
+			rte_free(cluster->stat.xstat_desc);
+			SET_ERR_JMP(ENOMEM, free, "Failed to allocate histograms node %s graph %s",
+				    graph_node->node->name, graph->name);
+		}
+	}
+
 	stats->sz += stats->cluster_node_size;
 	stats->max_nodes++;
 	*stats_in = stats;
@@ -418,7 +430,9 @@ rte_graph_cluster_stats_create(const struct rte_graph_cluster_stats_param *prm)
 			if (stats_mem_populate(&stats, graph_fp, graph_node))
 				goto realloc_fail;
 		}
-		if (graph->graph->model == RTE_GRAPH_MODEL_MCORE_DISPATCH)
+		/* Work stealing model shares the dispatch counters */
+		if (graph->graph->model == RTE_GRAPH_MODEL_MCORE_DISPATCH ||
+		    graph->graph->model == RTE_GRAPH_MODEL_WORK_STEAL)
 			stats->dispatch = true;
 	}
 
@@ -450,6 +464,7 @@ rte_graph_cluster_stats_destroy(struct rte_graph_cluster_stats *stat)
 			rte_free(cluster->stat.xstat_count);
 			rte_free(cluster->stat.xstat_desc);
 		}
+		rte_free(cluster->stat.hist);
 
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
@@ -462,15 +477,26 @@ cluster_node_arregate_stats(struct cluster_node *cluster, bool dispatch)
 	uint64_t calls = 0, cycles = 0, objs = 0, realloc_count = 0;
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
 	uint64_t sched_objs = 0, sched_fail = 0;
+	struct rte_node_histogram *hist;
 	struct rte_node *node;
 	rte_node_t count;
 	uint64_t *xstat;
 	uint8_t i;
 
 	memset(stat->xstat_count, 0, sizeof(uint64_t) * stat->xstat_cntrs);
+	if (stat->hist != NULL)
+		memset(stat->hist, 0, sizeof(*stat->hist));
 	for (count = 0; count < cluster->nb_nodes; count++) {
 		node = cluster->nodes[count];
 
+		if (stat->hist != NULL) {
+			hist = RTE_PTR_ADD(node, node->hist_off);
+			for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+				stat->hist->objs[i] += hist->objs[i];
+				stat->hist->cycles[i] += hist->cycles[i];
+			}
+		}
+
 		if (dispatch) {
 			sched_objs += node->dispatch.total_sched_objs;
 			sched_fail += node->dispatch.total_sched_fail;
@@ -556,6 +582,85 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->realloc_count = 0;
 		for (i = 0; i < node->xstat_cntrs; i++)
 			node->xstat_count[i] = 0;
+		if (node->hist != NULL)
+			memset(node->hist, 0, sizeof(*node->hist));
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+static struct rte_graph *
+graph_hist_graph_get(rte_graph_t id)
+{
+	struct graph *graph;
+
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		if (graph->id == id)
+			return graph->graph;
+
+	return NULL;
+}
+
+int
+rte_graph_walk_histogram_get(rte_graph_t id, uint64_t hist[RTE_GRAPH_HIST_BUCKETS])
+{
+	struct rte_graph *graph;
+
+	if (!rte_graph_has_histogram_feature())
+		return -ENOTSUP;
+
+	graph = graph_hist_graph_get(id);
+	if (graph == NULL || hist == NULL)
+		return -EINVAL;
+
+	memcpy(hist, RTE_PTR_ADD(graph, graph->hist_off),
+	       sizeof(uint64_t) * RTE_GRAPH_HIST_BUCKETS);
+
+	return 0;
+}
+
+int
+rte_graph_node_histogram_get(rte_graph_t id, rte_node_t node_id,
+			     struct rte_node_histogram *hist)
+{
+	struct rte_graph *graph;
+	struct rte_node *node;
+
+	if (!rte_graph_has_histogram_feature())
+		return -ENOTSUP;
+
+	graph = graph_hist_graph_get(id);
+	if (graph == NULL || hist == NULL)
+		return -EINVAL;
+
+	node = graph_node_id_to_ptr(graph, node_id);
+	if (node == NULL)
+		return -EINVAL;
+
+	memcpy(hist, RTE_PTR_ADD(node, node->hist_off), sizeof(*hist));
+
+	return 0;
+}
+
+int
+rte_graph_histogram_reset(rte_graph_t id)
+{
+	struct rte_graph *graph;
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+
+	if (!rte_graph_has_histogram_feature())
+		return -ENOTSUP;
+
+	graph = graph_hist_graph_get(id);
+	if (graph == NULL)
+		return -EINVAL;
+
+	memset(RTE_PTR_ADD(graph, graph->hist_off), 0,
+	       sizeof(uint64_t) * RTE_GRAPH_HIST_BUCKETS);
+	rte_graph_foreach_node(count, off, graph, node)
+		memset(RTE_PTR_ADD(node, node->hist_off), 0,
+		       sizeof(struct rte_node_histogram));
+
+	return 0;
+}
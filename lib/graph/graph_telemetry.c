@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_telemetry.h>
+
+#include "graph_private.h"
+
+static int
+graph_telemetry_hist_add(struct rte_tel_data *d, const char *name,
+			 const uint64_t *hist)
+{
+	struct rte_tel_data *array;
+	unsigned int i;
+
+	array = rte_tel_data_alloc();
+	if (array == NULL)
+		return -ENOMEM;
+
+	rte_tel_data_start_array(array, RTE_TEL_UINT_VAL);
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++)
+		rte_tel_data_add_array_uint(array, hist[i]);
+
+	return rte_tel_data_add_dict_container(d, name, array, 0);
+}
+
+static int
+handle_graph_list(const char *cmd __rte_unused, const char *params __rte_unused,
+		  struct rte_tel_data *d)
+{
+	struct graph *graph;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		rte_tel_data_add_array_string(d, graph->name);
+	graph_spinlock_unlock();
+
+	return 0;
+}
+
+static int
+handle_graph_walk_hist(const char *cmd __rte_unused, const char *params,
+		       struct rte_tel_data *d)
+{
+	uint64_t hist[RTE_GRAPH_HIST_BUCKETS];
+	rte_graph_t id;
+	int rc;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	id = rte_graph_from_name(params);
+	if (id == RTE_GRAPH_ID_INVALID)
+		return -EINVAL;
+
+	rc = rte_graph_walk_histogram_get(id, hist);
+	if (rc < 0)
+		return rc;
+
+	rte_tel_data_start_dict(d);
+	return graph_telemetry_hist_add(d, "cycles", hist);
+}
+
+static int
+handle_graph_node_hist(const char *cmd __rte_unused, const char *params,
+		       struct rte_tel_data *d)
+{
+	struct rte_node_histogram hist;
+	char *graph_name, *node_name;
+	rte_node_t node_id;
+	rte_graph_t id;
+	int rc = -EINVAL;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	/* Parameters: <graph name>,<node name> */
+	graph_name = strdup(params);
+	if (graph_name == NULL)
+		return -ENOMEM;
+	node_name = strchr(graph_name, ',');
+	if (node_name == NULL)
+		goto free;
+	*node_name++ = '\0';
+
+	id = rte_graph_from_name(graph_name);
+	node_id = rte_node_from_name(node_name);
+	if (id == RTE_GRAPH_ID_INVALID || node_id == RTE_NODE_ID_INVALID)
+		goto free;
+
+	rc = rte_graph_node_histogram_get(id, node_id, &hist);
+	if (rc < 0)
+		goto free;
+
+	rte_tel_data_start_dict(d);
+	rc = graph_telemetry_hist_add(d, "objs", hist.objs);
+	if (rc == 0)
+		rc = graph_telemetry_hist_add(d, "cycles", hist.cycles);
+
+free:
+	free(graph_name);
+	return rc;
+}
+
+RTE_INIT(graph_telemetry_init)
+{
+	rte_telemetry_register_cmd("/graph/list", handle_graph_list,
+		"Returns list of graphs.");
+	rte_telemetry_register_cmd("/graph/walk_histogram", handle_graph_walk_hist,
+		"Returns log2 histogram of cycles per graph walk. Parameters: graph name");
+	rte_telemetry_register_cmd("/graph/node_histogram", handle_graph_node_hist,
+		"Returns log2 histograms of objects and cycles per node call. "
+		"Parameters: graph name,node name");
+}
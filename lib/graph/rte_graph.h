@@ -22,6 +22,7 @@
 #include <stdio.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,6 +37,7 @@ extern "C" {
 #define RTE_EDGE_ID_INVALID UINT16_MAX   /**< Invalid edge id. */
 #define RTE_GRAPH_ID_INVALID UINT16_MAX  /**< Invalid graph id. */
 #define RTE_GRAPH_FENCE 0xdeadbeef12345678ULL /**< Graph fence data. */
+#define RTE_GRAPH_HIST_BUCKETS 32 /**< Number of log2 buckets of histograms. */
 
 typedef uint32_t rte_graph_off_t;  /**< Graph offset type. */
 typedef uint32_t rte_node_t;       /**< Node id type. */
@@ -172,6 +174,11 @@ struct rte_graph_param {
 			uint32_t wq_size_max; /**< Maximum size of workqueue for dispatch model. */
 			uint32_t mp_capacity; /**< Capacity of memory pool for dispatch model. */
 		} dispatch;
+		struct {
+			uint32_t dq_size_max; /**< Maximum size of deque for work stealing model. */
+			uint16_t split_size;
+			/**< Maximum objects of a work item, 0 for RTE_GRAPH_WORK_STEAL_SPLIT_SIZE. */
+		} work_steal;
 	};
 };
 
@@ -196,6 +203,20 @@ struct rte_graph_cluster_stats_param {
 	/**< Array of graph patterns based on shell pattern. */
 };
 
+/**
+ * Node histograms.
+ *
+ * Bucket 0 counts the calls with a value of 0, and bucket i the calls
+ * with a value in [2^(i-1), 2^i - 1]. The last bucket counts all
+ * the larger values.
+ *
+ * @see rte_graph_has_histogram_feature()
+ */
+struct rte_node_histogram {
+	uint64_t objs[RTE_GRAPH_HIST_BUCKETS];   /**< Objects processed per call. */
+	uint64_t cycles[RTE_GRAPH_HIST_BUCKETS]; /**< Cycles spent per call. */
+};
+
 /**
  * Node cluster stats data structure.
  *
@@ -230,6 +251,9 @@ struct __rte_cache_aligned rte_graph_cluster_node_stats {
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+
+	struct rte_node_histogram *hist;
+	/**< Histograms summed over the graphs, NULL if histograms are disabled. */
 };
 
 /**
@@ -318,7 +342,7 @@ char *rte_graph_id_to_name(rte_graph_t id);
 int rte_graph_export(const char *name, FILE *f);
 
 /**
- * Bind graph with specific lcore for mcore dispatch model.
+ * Bind graph with specific lcore for mcore dispatch and work stealing models.
  *
  * @param id
  *   Graph id to get the pointer of graph object
@@ -330,7 +354,7 @@ int rte_graph_export(const char *name, FILE *f);
 int rte_graph_model_mcore_dispatch_core_bind(rte_graph_t id, int lcore);
 
 /**
- * Unbind graph with lcore for mcore dispatch model
+ * Unbind graph with lcore for mcore dispatch and work stealing models.
  *
  * @param id
  * Graph id to get the pointer of graph object
@@ -465,6 +489,64 @@ void rte_graph_cluster_stats_get(struct rte_graph_cluster_stats *stat,
  */
 void rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the histogram of the cycles spent per rte_graph_walk() of a graph.
+ *
+ * The buckets are the ones of struct rte_node_histogram.
+ * The walks which found nothing to process are counted.
+ *
+ * @param id
+ *   Graph id.
+ * @param hist
+ *   Histogram to fill.
+ *
+ * @return
+ *   0 on success, -EINVAL if the graph is not found,
+ *   -ENOTSUP if the histograms are disabled.
+ */
+__rte_experimental
+int rte_graph_walk_histogram_get(rte_graph_t id, uint64_t hist[RTE_GRAPH_HIST_BUCKETS]);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the histograms of a node of a graph.
+ *
+ * @param id
+ *   Graph id.
+ * @param node_id
+ *   Node id.
+ * @param hist
+ *   Histograms to fill.
+ *
+ * @return
+ *   0 on success, -EINVAL if the graph or the node is not found,
+ *   -ENOTSUP if the histograms are disabled.
+ */
+__rte_experimental
+int rte_graph_node_histogram_get(rte_graph_t id, rte_node_t node_id,
+				 struct rte_node_histogram *hist);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Clear the walk and node histograms of a graph.
+ *
+ * @param id
+ *   Graph id.
+ *
+ * @return
+ *   0 on success, -EINVAL if the graph is not found,
+ *   -ENOTSUP if the histograms are disabled.
+ */
+__rte_experimental
+int rte_graph_histogram_reset(rte_graph_t id);
+
 /**
  * Structure defines the number of xstats a given node has and each xstat
  * description.
@@ -483,6 +565,8 @@ struct rte_node_register {
 	char name[RTE_NODE_NAMESIZE]; /**< Name of the node. */
 	uint64_t flags;		      /**< Node configuration flag. */
 #define RTE_NODE_SOURCE_F (1ULL << 0) /**< Node type is source. */
+#define RTE_NODE_ORDERED_F (1ULL << 1)
+/**< Node requires the objects of a flow in order, see work stealing model. */
 	rte_node_process_t process; /**< Node process function. */
 	rte_node_init_t init;       /**< Node init function. */
 	rte_node_fini_t fini;       /**< Node fini function. */
@@ -707,6 +791,26 @@ rte_graph_has_stats_feature(void)
 #endif
 }
 
+/**
+ * Test histogram feature support.
+ *
+ * The histograms are enabled with RTE_LIBRTE_GRAPH_HISTOGRAM config option,
+ * on top of the stats. When disabled, the fast path is the same as without
+ * histogram support.
+ *
+ * @return
+ *   1 if histograms enabled, 0 otherwise.
+ */
+static __rte_always_inline int
+rte_graph_has_histogram_feature(void)
+{
+#ifdef RTE_LIBRTE_GRAPH_HISTOGRAM
+	return RTE_LIBRTE_GRAPH_HISTOGRAM && rte_graph_has_stats_feature();
+#else
+	return 0;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,366 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef _RTE_GRAPH_FEATURE_ARC_H_
+#define _RTE_GRAPH_FEATURE_ARC_H_
+
+/**
+ * @file rte_graph_feature_arc.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * Graph feature arc API.
+ *
+ * A feature arc is an ordered list of feature nodes, inserted between
+ * a start node and an end node. Each feature is enabled or disabled
+ * per index, typically per port, while the graphs are running.
+ *
+ * The start node sends the objects of an index to the first feature enabled
+ * on this index. Each feature node sends them to the next enabled feature,
+ * and the last one to the end node of the index. The start node checks once
+ * per burst if any feature is enabled on the arc, so that disabled features
+ * have no per object cost.
+ *
+ * The edges between the start node, the features and the end nodes
+ * are added by the library: features and end nodes must be set
+ * before creating the graphs.
+ *
+ * The fast path data is double buffered. When a feature is enabled or
+ * disabled, the new data is published, and the previous copy is reused
+ * only after all the workers reported a quiescent state on the RCU QSBR
+ * variable given by the application.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_stdatomic.h>
+
+#include "rte_graph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RTE_GRAPH_FEATURE_ARC_NAMELEN RTE_NODE_NAMESIZE
+/**< Arc name size including the '\0'. */
+#define RTE_GRAPH_FEATURE_MAX_PER_ARC 16 /**< Maximum number of features in an arc. */
+
+typedef uint8_t rte_graph_feature_t; /**< Position of a feature in its arc. */
+
+/**
+ * Fast path data of a feature, or of the start node, for one index.
+ */
+struct rte_graph_feature_data {
+	rte_edge_t next_edge;
+	/**< Edge to the next enabled feature, or to the end node. */
+	uint16_t reserved;
+	uint32_t user_data; /**< Data given when enabling the feature. */
+};
+
+/**
+ * Fast path data of a feature arc.
+ */
+struct __rte_cache_aligned rte_graph_feature_arc_fp {
+	uint32_t nb_enabled; /**< Number of features enabled on all indexes. */
+	uint16_t stride;     /**< Number of data per index. */
+	uint16_t max_indexes; /**< Number of indexes. */
+	struct rte_graph_feature_data data[];
+	/**< For each index, data of the start node followed by each feature. */
+};
+
+/**
+ * @internal
+ *
+ * Fast path view of a feature arc.
+ */
+struct rte_graph_feature_arc {
+	RTE_ATOMIC(struct rte_graph_feature_arc_fp *) fp;
+	/**< Fast path data in use by the workers. */
+};
+
+/**
+ * Create a feature arc.
+ *
+ * @param name
+ *   Name of the arc.
+ * @param start_node
+ *   Name of the node sending the objects to the features of the arc.
+ * @param end_node
+ *   Name of the node receiving the objects after the last enabled feature,
+ *   NULL to set it per index with rte_graph_feature_arc_end_set().
+ * @param max_indexes
+ *   Number of indexes, for instance the number of ports.
+ *
+ * @return
+ *   Pointer to the arc, NULL on error with rte_errno set.
+ */
+__rte_experimental
+struct rte_graph_feature_arc *rte_graph_feature_arc_create(const char *name,
+		const char *start_node, const char *end_node, uint16_t max_indexes);
+
+/**
+ * Get a feature arc from its name.
+ *
+ * @param name
+ *   Name of the arc.
+ *
+ * @return
+ *   Pointer to the arc, NULL if not found.
+ */
+__rte_experimental
+struct rte_graph_feature_arc *rte_graph_feature_arc_lookup(const char *name);
+
+/**
+ * Destroy a feature arc.
+ *
+ * The graphs using the start node or the features of the arc
+ * must be destroyed before.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ *
+ * @return
+ *   0 on success, negative errno otherwise.
+ */
+__rte_experimental
+int rte_graph_feature_arc_destroy(struct rte_graph_feature_arc *arc);
+
+/**
+ * Add another start node to a feature arc.
+ *
+ * The node sends its objects to the features like the start node given
+ * at creation, for instance an alternative lookup node. The fast path data
+ * has a single edge to each feature, so the node must have the same edges
+ * as the first start node before the features: typically, the same
+ * next nodes. Must be called before creating the graphs.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ * @param start_node
+ *   Name of the node.
+ *
+ * @return
+ *   0 on success, negative errno otherwise.
+ */
+__rte_experimental
+int rte_graph_feature_arc_start_add(struct rte_graph_feature_arc *arc,
+		const char *start_node);
+
+/**
+ * Set the end node of an index.
+ *
+ * Must be called before creating the graphs.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ * @param index
+ *   Index of the end node.
+ * @param end_node
+ *   Name of the node receiving the objects of this index
+ *   after the last enabled feature.
+ *
+ * @return
+ *   0 on success, negative errno otherwise.
+ */
+__rte_experimental
+int rte_graph_feature_arc_end_set(struct rte_graph_feature_arc *arc,
+		uint16_t index, const char *end_node);
+
+/**
+ * Add a feature at the end of an arc.
+ *
+ * Edges are added from the start node and the previous features to this
+ * feature, and from this feature to the end nodes.
+ * Must be called before creating the graphs.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ * @param feature_node
+ *   Name of the feature node.
+ *
+ * @return
+ *   Position of the feature in the arc, negative errno otherwise.
+ */
+__rte_experimental
+int rte_graph_feature_add(struct rte_graph_feature_arc *arc,
+		const char *feature_node);
+
+/**
+ * Get the position of a feature in an arc.
+ *
+ * A feature node uses it in its init callback, to get its own data
+ * in the fast path.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ * @param feature_node
+ *   Name of the feature node.
+ *
+ * @return
+ *   Position of the feature in the arc, negative errno otherwise.
+ */
+__rte_experimental
+int rte_graph_feature_lookup(struct rte_graph_feature_arc *arc,
+		const char *feature_node);
+
+/**
+ * Enable a feature on an index.
+ *
+ * Enabling an enabled feature updates its user data.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ * @param index
+ *   Index on which the feature is enabled.
+ * @param feature_node
+ *   Name of the feature node.
+ * @param user_data
+ *   Data given to the feature node for this index.
+ * @param qsbr
+ *   RCU QSBR variable of the workers running the arc. When NULL, the
+ *   application must ensure that no worker uses the arc until the next
+ *   enable or disable call.
+ *
+ * @return
+ *   0 on success, negative errno otherwise.
+ */
+__rte_experimental
+int rte_graph_feature_enable(struct rte_graph_feature_arc *arc, uint16_t index,
+		const char *feature_node, uint32_t user_data, struct rte_rcu_qsbr *qsbr);
+
+/**
+ * Disable a feature on an index.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ * @param index
+ *   Index on which the feature is disabled.
+ * @param feature_node
+ *   Name of the feature node.
+ * @param qsbr
+ *   RCU QSBR variable of the workers running the arc,
+ *   see rte_graph_feature_enable().
+ *
+ * @return
+ *   0 on success, negative errno otherwise.
+ */
+__rte_experimental
+int rte_graph_feature_disable(struct rte_graph_feature_arc *arc, uint16_t index,
+		const char *feature_node, struct rte_rcu_qsbr *qsbr);
+
+/**
+ * Get the fast path data of an arc, if any feature is enabled on it.
+ *
+ * To be called by the start node once per burst.
+ *
+ * @param arc
+ *   Pointer to the arc, may be NULL.
+ *
+ * @return
+ *   Pointer to the fast path data, NULL if no feature is enabled.
+ */
+static __rte_always_inline const struct rte_graph_feature_arc_fp *
+rte_graph_feature_arc_active_get(struct rte_graph_feature_arc *arc)
+{
+	const struct rte_graph_feature_arc_fp *fp;
+
+	if (arc == NULL)
+		return NULL;
+
+	fp = rte_atomic_load_explicit(&arc->fp, rte_memory_order_acquire);
+	return likely(fp->nb_enabled == 0) ? NULL : fp;
+}
+
+/**
+ * Get the fast path data of an arc.
+ *
+ * To be called by the feature nodes once per burst.
+ *
+ * @param arc
+ *   Pointer to the arc.
+ *
+ * @return
+ *   Pointer to the fast path data.
+ */
+static __rte_always_inline const struct rte_graph_feature_arc_fp *
+rte_graph_feature_arc_fp_get(struct rte_graph_feature_arc *arc)
+{
+	return rte_atomic_load_explicit(&arc->fp, rte_memory_order_acquire);
+}
+
+/**
+ * Get the edge from the start node to the first feature enabled on an index.
+ *
+ * @param fp
+ *   Fast path data of the arc.
+ * @param index
+ *   Index of the object.
+ * @param[out] edge
+ *   Edge of the start node to the first enabled feature.
+ *
+ * @return
+ *   True if a feature is enabled on the index, false otherwise.
+ */
+static __rte_always_inline bool
+rte_graph_feature_arc_first(const struct rte_graph_feature_arc_fp *fp,
+			    uint16_t index, rte_edge_t *edge)
+{
+	rte_edge_t next = fp->data[index * fp->stride].next_edge;
+
+	if (next == RTE_EDGE_ID_INVALID)
+		return false;
+
+	*edge = next;
+	return true;
+}
+
+/**
+ * Get the edge from a feature to the next enabled feature, or to the end node.
+ *
+ * @param fp
+ *   Fast path data of the arc.
+ * @param index
+ *   Index of the object.
+ * @param feature
+ *   Position of the calling feature.
+ *
+ * @return
+ *   Edge of the feature node.
+ */
+static __rte_always_inline rte_edge_t
+rte_graph_feature_arc_next(const struct rte_graph_feature_arc_fp *fp,
+			   uint16_t index, rte_graph_feature_t feature)
+{
+	return fp->data[index * fp->stride + feature + 1].next_edge;
+}
+
+/**
+ * Get the user data of a feature for an index.
+ *
+ * @param fp
+ *   Fast path data of the arc.
+ * @param index
+ *   Index of the object.
+ * @param feature
+ *   Position of the calling feature.
+ *
+ * @return
+ *   User data given to rte_graph_feature_enable().
+ */
+static __rte_always_inline uint32_t
+rte_graph_feature_data_get(const struct rte_graph_feature_arc_fp *fp,
+			   uint16_t index, rte_graph_feature_t feature)
+{
+	return fp->data[index * fp->stride + feature + 1].user_data;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_GRAPH_FEATURE_ARC_H_ */
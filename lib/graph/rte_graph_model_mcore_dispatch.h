@@ -62,7 +62,8 @@ bool __rte_noinline __rte_graph_mcore_dispatch_sched_node_enqueue(struct rte_nod
 void __rte_graph_mcore_dispatch_sched_wq_process(struct rte_graph *graph);
 
 /**
- * Set lcore affinity with the node used for mcore dispatch model.
+ * Set lcore affinity with the node used for mcore dispatch model,
+ * and with the source node for work stealing model.
  *
  * @param name
  *   Valid node name. In the case of the cloned node, the name will be
@@ -0,0 +1,261 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+#include <rte_stdatomic.h>
+
+#include "graph_private.h"
+#include "rte_graph_model_work_steal.h"
+
+/*
+ * Bounded Chase-Lev deque. The owner graph pushes and takes the work items
+ * at the bottom, the other graphs steal them at the top.
+ */
+struct rte_graph_work_steal_dq {
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(int64_t) top;
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(int64_t) bottom;
+	uint32_t mask;
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(struct graph_work_steal_item *) items[];
+};
+
+static __rte_always_inline bool
+graph_work_steal_dq_push(struct rte_graph_work_steal_dq *dq,
+			 struct graph_work_steal_item *item)
+{
+	int64_t b, t;
+
+	b = rte_atomic_load_explicit(&dq->bottom, rte_memory_order_relaxed);
+	t = rte_atomic_load_explicit(&dq->top, rte_memory_order_acquire);
+	if (b - t > (int64_t)dq->mask)
+		return false;
+
+	rte_atomic_store_explicit(&dq->items[b & dq->mask], item, rte_memory_order_relaxed);
+	rte_atomic_thread_fence(rte_memory_order_release);
+	rte_atomic_store_explicit(&dq->bottom, b + 1, rte_memory_order_relaxed);
+
+	return true;
+}
+
+static __rte_always_inline struct graph_work_steal_item *
+graph_work_steal_dq_take(struct rte_graph_work_steal_dq *dq)
+{
+	struct graph_work_steal_item *item;
+	int64_t b, t;
+
+	b = rte_atomic_load_explicit(&dq->bottom, rte_memory_order_relaxed) - 1;
+	rte_atomic_store_explicit(&dq->bottom, b, rte_memory_order_relaxed);
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+	t = rte_atomic_load_explicit(&dq->top, rte_memory_order_relaxed);
+
+	if (t > b) {
+		/* Empty */
+		rte_atomic_store_explicit(&dq->bottom, b + 1, rte_memory_order_relaxed);
+		return NULL;
+	}
+
+	item = rte_atomic_load_explicit(&dq->items[b & dq->mask], rte_memory_order_relaxed);
+	if (t == b) {
+		/* Last item, race with the thieves */
+		if (!rte_atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+				rte_memory_order_seq_cst, rte_memory_order_relaxed))
+			item = NULL;
+		rte_atomic_store_explicit(&dq->bottom, b + 1, rte_memory_order_relaxed);
+	}
+
+	return item;
+}
+
+static __rte_always_inline struct graph_work_steal_item *
+graph_work_steal_dq_steal(struct rte_graph_work_steal_dq *dq)
+{
+	struct graph_work_steal_item *item;
+	int64_t b, t;
+
+	t = rte_atomic_load_explicit(&dq->top, rte_memory_order_acquire);
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+	b = rte_atomic_load_explicit(&dq->bottom, rte_memory_order_acquire);
+	if (t >= b)
+		return NULL;
+
+	item = rte_atomic_load_explicit(&dq->items[t & dq->mask], rte_memory_order_relaxed);
+	/* Lost the race with the owner or another thief */
+	if (!rte_atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+			rte_memory_order_seq_cst, rte_memory_order_relaxed))
+		return NULL;
+
+	return item;
+}
+
+/* Nodes with a path to an ordered node must be processed in order */
+static bool
+graph_node_is_stealable(struct graph *graph, struct graph_node *graph_node)
+{
+	struct graph_node *tmp;
+
+	if (graph_node->node->flags & RTE_NODE_SOURCE_F)
+		return false;
+
+	graph_mark_nodes_as_not_visited(graph);
+	if (graph_bfs(graph, graph_node))
+		return false;
+
+	STAILQ_FOREACH(tmp, &graph->node_list, next)
+		if (tmp->visited && (tmp->node->flags & RTE_NODE_ORDERED_F))
+			return false;
+
+	return true;
+}
+
+int
+graph_work_steal_dq_create(struct graph *_graph, struct graph *_parent_graph,
+			   struct rte_graph_param *prm)
+{
+	struct rte_graph *parent_graph = _parent_graph->graph;
+	struct rte_graph *graph = _graph->graph;
+	struct graph_node *graph_node;
+	struct rte_node *node;
+	unsigned int dq_size;
+	uint16_t split_size;
+
+	split_size = prm->work_steal.split_size;
+	if (split_size == 0)
+		split_size = RTE_GRAPH_WORK_STEAL_SPLIT_SIZE;
+	split_size = RTE_MIN(split_size, RTE_GRAPH_BURST_SIZE);
+
+	/* Room for a burst in the stream of each node */
+	dq_size = rte_align32pow2(graph->nb_nodes *
+				  ((RTE_GRAPH_BURST_SIZE + split_size - 1) / split_size));
+	if (prm->work_steal.dq_size_max > 0)
+		dq_size = RTE_MIN(dq_size, rte_align32prevpow2(prm->work_steal.dq_size_max));
+
+	graph->work_steal.dq = rte_zmalloc_socket(graph->name,
+			sizeof(struct rte_graph_work_steal_dq) +
+			dq_size * sizeof(graph->work_steal.dq->items[0]),
+			RTE_CACHE_LINE_SIZE, graph->socket);
+	if (graph->work_steal.dq == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to allocate graph work stealing deque");
+	graph->work_steal.dq->mask = dq_size - 1;
+
+	/* The work items are put back by the graph which processed them */
+	graph->work_steal.mp = rte_mempool_create(graph->name, dq_size,
+			sizeof(struct graph_work_steal_item) + split_size * sizeof(void *),
+			0, 0, NULL, NULL, NULL, NULL, graph->socket, 0);
+	if (graph->work_steal.mp == NULL)
+		SET_ERR_JMP(EIO, fail_mp, "Failed to allocate graph work items");
+
+	STAILQ_FOREACH(graph_node, &_graph->node_list, next) {
+		node = graph_node_id_to_ptr(graph, graph_node->node->id);
+		node->work_steal.stealable = graph_node_is_stealable(_graph, graph_node);
+	}
+
+	graph->work_steal.lcore_id = _graph->lcore_id;
+	graph->work_steal.split_size = split_size;
+
+	if (parent_graph->work_steal.rq == NULL) {
+		parent_graph->work_steal.rq = &parent_graph->work_steal.rq_head;
+		SLIST_INIT(parent_graph->work_steal.rq);
+	}
+
+	graph->work_steal.rq = parent_graph->work_steal.rq;
+	SLIST_INSERT_HEAD(graph->work_steal.rq, graph, next);
+
+	return 0;
+
+fail_mp:
+	rte_free(graph->work_steal.dq);
+	graph->work_steal.dq = NULL;
+fail:
+	return -rte_errno;
+}
+
+void
+graph_work_steal_dq_destroy(struct graph *_graph)
+{
+	struct rte_graph *graph = _graph->graph;
+
+	if (graph == NULL)
+		return;
+
+	rte_free(graph->work_steal.dq);
+	graph->work_steal.dq = NULL;
+
+	rte_mempool_free(graph->work_steal.mp);
+	graph->work_steal.mp = NULL;
+}
+
+bool __rte_noinline
+__rte_graph_work_steal_node_push(struct rte_graph *graph, struct rte_node *node)
+{
+	const uint16_t split_size = graph->work_steal.split_size;
+	struct graph_work_steal_item *item;
+	uint16_t off = 0;
+	uint16_t size;
+
+	while (node->idx > 0) {
+		if (rte_mempool_get(graph->work_steal.mp, (void **)&item) < 0)
+			break;
+
+		size = RTE_MIN(node->idx, split_size);
+		item->node_off = node->off;
+		item->nb_objs = size;
+		rte_memcpy(item->objs, &node->objs[off], size * sizeof(void *));
+
+		if (!graph_work_steal_dq_push(graph->work_steal.dq, item)) {
+			rte_mempool_put(graph->work_steal.mp, item);
+			break;
+		}
+
+		off += size;
+		node->idx -= size;
+		node->work_steal.total_sched_objs += size;
+	}
+
+	if (node->idx == 0)
+		return true;
+
+	/* Deque full, the caller processes the rest of the stream */
+	if (off != 0)
+		memmove(&node->objs[0], &node->objs[off], node->idx * sizeof(void *));
+	node->work_steal.total_sched_fail += node->idx;
+
+	return false;
+}
+
+bool
+__rte_graph_work_steal_run(struct rte_graph *graph)
+{
+	struct graph_work_steal_item *item;
+	struct rte_graph *victim;
+	struct rte_node *node;
+	uint16_t idx;
+
+	item = graph_work_steal_dq_take(graph->work_steal.dq);
+
+	/* Start with the next graph, so that the thieves spread over the list */
+	victim = graph;
+	while (item == NULL) {
+		victim = SLIST_NEXT(victim, next);
+		if (victim == NULL)
+			victim = SLIST_FIRST(graph->work_steal.rq);
+		if (victim == graph)
+			return false;
+
+		item = graph_work_steal_dq_steal(victim->work_steal.dq);
+	}
+
+	/* Clones have the same layout, the node is at the same offset */
+	node = RTE_PTR_ADD(graph, item->node_off);
+	RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+	idx = node->idx;
+
+	if (unlikely(node->size - idx < item->nb_objs))
+		__rte_node_stream_alloc_size(graph, node, idx + item->nb_objs);
+
+	rte_memcpy(&node->objs[idx], item->objs, item->nb_objs * sizeof(void *));
+	node->idx = idx + item->nb_objs;
+	rte_mempool_put(rte_mempool_from_obj(item), item);
+
+	__rte_node_process(graph, node);
+
+	return true;
+}
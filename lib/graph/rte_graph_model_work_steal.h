@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef _RTE_GRAPH_MODEL_WORK_STEAL_H_
+#define _RTE_GRAPH_MODEL_WORK_STEAL_H_
+
+/**
+ * @file rte_graph_model_work_steal.h
+ *
+ * Work stealing model.
+ *
+ * The graphs cloned from a parent graph run on their own lcore and process
+ * the same nodes. The streams of the nodes are split in work items which
+ * are pushed to a deque of the graph. The graph pops the last pushed item
+ * of its deque, while the graphs with nothing to process steal the oldest
+ * items from the deques of the other graphs. A node with a high processing
+ * cost is then run on all the lcores instead of saturating one of them.
+ *
+ * The source nodes run on the lcore set with
+ * rte_graph_model_mcore_dispatch_node_lcore_affinity_set().
+ *
+ * The nodes with the RTE_NODE_ORDERED_F flag, and the nodes with a path
+ * to them, are not stolen: their streams are processed in order by
+ * the graph which received them, like in the RTC model.
+ */
+
+#include "rte_graph_worker_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RTE_GRAPH_WORK_STEAL_SPLIT_SIZE 32
+/**< Default maximum number of objects of a work item. */
+
+/**
+ * @internal
+ *
+ * Push the stream of a node to the deque of the graph for work stealing model.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @return
+ *   True if the whole stream is pushed, false if the remaining objects
+ *   of the stream must be processed by the caller.
+ *
+ * @note
+ * This implementation is used by work stealing model only and user application
+ * should not call it directly.
+ */
+bool __rte_noinline __rte_graph_work_steal_node_push(struct rte_graph *graph,
+						     struct rte_node *node);
+
+/**
+ * @internal
+ *
+ * Process a work item of the graph's deque, or stolen from the deque
+ * of another graph, for work stealing model.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ *
+ * @return
+ *   True if a work item is processed, false if there was none.
+ *
+ * @note
+ * This implementation is used by work stealing model only and user application
+ * should not call it directly.
+ */
+bool __rte_graph_work_steal_run(struct rte_graph *graph);
+
+/**
+ * Perform graph walk on the circular buffer and invoke the process function
+ * of the nodes and collect the stats.
+ *
+ * The walk returns once the graph's deque is empty and no work item can be
+ * stolen from the other graphs.
+ *
+ * @param graph
+ *   Graph pointer returned from rte_graph_lookup function.
+ *
+ * @see rte_graph_lookup()
+ */
+static inline void
+rte_graph_walk_work_steal(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const rte_node_t mask = graph->cir_mask;
+	uint32_t head = graph->head;
+	struct rte_node *node;
+
+	do {
+		while (likely(head != graph->tail)) {
+			node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+
+			/* skip the src nodes which not bind with current worker */
+			if ((int32_t)head < 1 &&
+			    node->work_steal.lcore_id != graph->work_steal.lcore_id)
+				continue;
+
+			/* Leave the streams which may be stolen to the deque */
+			if (!node->work_steal.stealable || graph->work_steal.dq == NULL ||
+			    !__rte_graph_work_steal_node_push(graph, node))
+				__rte_node_process(graph, node);
+
+			head = likely((int32_t)head > 0) ? head & mask : head;
+		}
+
+		graph->tail = 0;
+		head = 0;
+	} while (graph->work_steal.dq != NULL && __rte_graph_work_steal_run(graph));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_GRAPH_MODEL_WORK_STEAL_H_ */
@@ -8,7 +8,7 @@
 bool
 rte_graph_model_is_valid(uint8_t model)
 {
-	if (model > RTE_GRAPH_MODEL_MCORE_DISPATCH)
+	if (model > RTE_GRAPH_MODEL_WORK_STEAL)
 		return false;
 
 	return true;
@@ -8,6 +8,7 @@
 
 #include "rte_graph_model_rtc.h"
 #include "rte_graph_model_mcore_dispatch.h"
+#include "rte_graph_model_work_steal.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,19 +26,34 @@ extern "C" {
 static inline void
 rte_graph_walk(struct rte_graph *graph)
 {
+	uint64_t *hist, start = 0;
+
+	if (rte_graph_has_histogram_feature())
+		start = rte_rdtsc();
+
 #if defined(RTE_GRAPH_MODEL_SELECT) && (RTE_GRAPH_MODEL_SELECT == RTE_GRAPH_MODEL_RTC)
 	rte_graph_walk_rtc(graph);
 #elif defined(RTE_GRAPH_MODEL_SELECT) && (RTE_GRAPH_MODEL_SELECT == RTE_GRAPH_MODEL_MCORE_DISPATCH)
 	rte_graph_walk_mcore_dispatch(graph);
+#elif defined(RTE_GRAPH_MODEL_SELECT) && (RTE_GRAPH_MODEL_SELECT == RTE_GRAPH_MODEL_WORK_STEAL)
+	rte_graph_walk_work_steal(graph);
 #else
 	switch (rte_graph_worker_model_no_check_get(graph)) {
 	case RTE_GRAPH_MODEL_MCORE_DISPATCH:
 		rte_graph_walk_mcore_dispatch(graph);
 		break;
+	case RTE_GRAPH_MODEL_WORK_STEAL:
+		rte_graph_walk_work_steal(graph);
+		break;
 	default:
 		rte_graph_walk_rtc(graph);
 	}
 #endif
+
+	if (rte_graph_has_histogram_feature()) {
+		hist = RTE_PTR_ADD(graph, graph->hist_off);
+		hist[__rte_graph_hist_bucket(rte_rdtsc() - start)]++;
+	}
 }
 
 #ifdef __cplusplus
@@ -16,6 +16,7 @@
 #include <stdalign.h>
 #include <stddef.h>
 
+#include <rte_bitops.h>
 #include <rte_common.h>
 #include <rte_cycles.h>
 #include <rte_prefetch.h>
@@ -33,6 +34,8 @@ extern "C" {
 #define RTE_GRAPH_MODEL_RTC 0 /**< Run-To-Completion model. It is the default model. */
 #define RTE_GRAPH_MODEL_MCORE_DISPATCH 1
 /**< Dispatch model to support cross-core dispatching within core affinity. */
+#define RTE_GRAPH_MODEL_WORK_STEAL 2
+/**< Work stealing model to balance the node streams between the cores. */
 #define RTE_GRAPH_MODEL_DEFAULT RTE_GRAPH_MODEL_RTC /**< Default graph model. */
 
 /**
@@ -42,6 +45,13 @@ extern "C" {
  */
 SLIST_HEAD(rte_graph_rq_head, rte_graph);
 
+/**
+ * @internal
+ *
+ * Work stealing deque, private to the library.
+ */
+struct rte_graph_work_steal_dq;
+
 /**
  * @internal
  *
@@ -58,6 +68,7 @@ struct __rte_cache_aligned rte_graph {
 	uint8_t model;		     /**< graph model */
 	uint8_t reserved1;	     /**< Reserved for future use. */
 	uint16_t reserved2;	     /**< Reserved for future use. */
+	rte_graph_off_t hist_off;    /**< Offset to walk histogram. */
 	union {
 		/* Fast schedule area for mcore dispatch model */
 		struct {
@@ -69,6 +80,17 @@ struct __rte_cache_aligned rte_graph {
 			struct rte_ring *wq;    /**< The work-queue for pending streams. */
 			struct rte_mempool *mp; /**< The mempool for scheduling streams. */
 		} dispatch; /** Only used by dispatch model */
+		/* Fast schedule area for work stealing model */
+		struct {
+			alignas(RTE_CACHE_LINE_SIZE) struct rte_graph_rq_head *rq;
+				/* The graphs sharing the work */
+			struct rte_graph_rq_head rq_head; /* The head for graph list */
+
+			unsigned int lcore_id;  /**< The graph running Lcore. */
+			struct rte_graph_work_steal_dq *dq; /**< The deque of work items. */
+			struct rte_mempool *mp; /**< The mempool for work items. */
+			uint16_t split_size;    /**< Maximum objects of a work item. */
+		} work_steal; /** Only used by work stealing model */
 	};
 	SLIST_ENTRY(rte_graph) next;   /* The next for rte_graph list */
 	/* End of Fast path area.*/
@@ -104,18 +126,25 @@ struct __rte_cache_aligned rte_node {
 	/** Original process function when pcap is enabled. */
 	rte_node_process_t original_process;
 
-	/** Fast schedule area for mcore dispatch model. */
+	/** Fast schedule area for mcore dispatch and work stealing models. */
 	union {
 		alignas(RTE_CACHE_LINE_MIN_SIZE) struct {
 			unsigned int lcore_id;  /**< Node running lcore. */
 			uint64_t total_sched_objs; /**< Number of objects scheduled. */
 			uint64_t total_sched_fail; /**< Number of scheduled failure. */
 		} dispatch;
+		alignas(RTE_CACHE_LINE_MIN_SIZE) struct {
+			unsigned int lcore_id;  /**< Source node running lcore. */
+			bool stealable;         /**< Stream may run on other lcores. */
+			uint64_t total_sched_objs; /**< Number of objects pushed. */
+			uint64_t total_sched_fail; /**< Number of objects not pushed. */
+		} work_steal;
 	};
 
 	/** Fast path area cache line 1. */
 	alignas(RTE_CACHE_LINE_MIN_SIZE)
 	rte_graph_off_t xstat_off; /**< Offset to xstat counters. */
+	rte_graph_off_t hist_off;  /**< Offset to histograms. */
 
 	/** Fast path area cache line 2. */
 	__extension__ struct __rte_cache_aligned {
@@ -145,6 +174,15 @@ struct __rte_cache_aligned rte_node {
 	};
 };
 
+/* The stats and the lcore affinity are common to both scheduling models */
+static_assert(offsetof(struct rte_node, work_steal.lcore_id) ==
+	offsetof(struct rte_node, dispatch.lcore_id) &&
+	offsetof(struct rte_node, work_steal.total_sched_objs) ==
+	offsetof(struct rte_node, dispatch.total_sched_objs) &&
+	offsetof(struct rte_node, work_steal.total_sched_fail) ==
+	offsetof(struct rte_node, dispatch.total_sched_fail),
+	"rte_node work stealing area must match the dispatch one");
+
 static_assert(offsetof(struct rte_node, nodes) - offsetof(struct rte_node, ctx)
 	== RTE_CACHE_LINE_MIN_SIZE, "rte_node fast path area must fit in 64 bytes");
 
@@ -181,6 +219,23 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 
 /* Fast path helper functions */
 
+/**
+ * @internal
+ *
+ * Get the log2 histogram bucket of a value.
+ *
+ * @param val
+ *   Value to count.
+ *
+ * @return
+ *   Index of the bucket.
+ */
+static __rte_always_inline unsigned int
+__rte_graph_hist_bucket(uint64_t val)
+{
+	return RTE_MIN(rte_fls_u64(val), (uint32_t)RTE_GRAPH_HIST_BUCKETS - 1);
+}
+
 /**
  * @internal
  *
@@ -194,7 +249,8 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 static __rte_always_inline void
 __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 {
-	uint64_t start;
+	struct rte_node_histogram *hist;
+	uint64_t start, cycles;
 	uint16_t rc;
 	void **objs;
 
@@ -205,9 +261,15 @@ __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 	if (rte_graph_has_stats_feature()) {
 		start = rte_rdtsc();
 		rc = node->process(graph, node, objs, node->idx);
-		node->total_cycles += rte_rdtsc() - start;
+		cycles = rte_rdtsc() - start;
+		node->total_cycles += cycles;
 		node->total_calls++;
 		node->total_objs += rc;
+		if (rte_graph_has_histogram_feature()) {
+			hist = RTE_PTR_ADD(node, node->hist_off);
+			hist->objs[__rte_graph_hist_bucket(rc)]++;
+			hist->cycles[__rte_graph_hist_bucket(cycles)]++;
+		}
 	} else {
 		node->process(graph, node, objs, node->idx);
 	}
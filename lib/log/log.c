@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <regex.h>
 #include <fnmatch.h>
 #include <sys/queue.h>
@@ -17,6 +18,7 @@
 #include <rte_common.h>
 #include <rte_log.h>
 #include <rte_per_lcore.h>
+#include <rte_stdatomic.h>
 
 #ifdef RTE_EXEC_ENV_WINDOWS
 #include <rte_os_shim.h>
@@ -28,6 +30,14 @@
 struct rte_log_dynamic_type {
 	const char *name;
 	uint32_t loglevel;
+	/* Rate limit of asynchronous logging, applied by the logging thread */
+	uint32_t rate_burst;
+	uint64_t rate_period;
+	uint64_t rate_start;
+	uint32_t rate_count;
+	uint64_t rate_suppressed;
+	RTE_ATOMIC(uint64_t) suppressed;
+	RTE_ATOMIC(uint64_t) drops;
 };
 
 /* Note: same as vfprintf() */
@@ -265,6 +275,71 @@ int rte_log_cur_msg_logtype(void)
 	return RTE_PER_LCORE(log_cur_msg).logtype;
 }
 
+int
+rte_log_set_rate_limit(uint32_t type, uint32_t burst, uint32_t period_ms)
+{
+	struct rte_log_dynamic_type *t;
+
+	if (type >= rte_logs.dynamic_types_len)
+		return -EINVAL;
+	if (burst != 0 && period_ms == 0)
+		return -EINVAL;
+
+	t = &rte_logs.dynamic_types[type];
+	t->rate_burst = burst;
+	t->rate_period = (uint64_t)period_ms * 1000 * 1000;
+	t->rate_count = 0;
+
+	return 0;
+}
+
+/* Account a message which could not be handed over to the logging thread. */
+void
+log_type_drop(uint32_t type)
+{
+	if (type < rte_logs.dynamic_types_len)
+		rte_atomic_fetch_add_explicit(&rte_logs.dynamic_types[type].drops,
+			1, rte_memory_order_relaxed);
+}
+
+/*
+ * Apply the rate limit of the log type to a message logged at time now (ns).
+ * Only called by the logging thread.
+ */
+bool
+log_type_admit(uint32_t level, uint32_t type, uint64_t now)
+{
+	struct rte_log_dynamic_type *t;
+	uint64_t suppressed;
+
+	if (type >= rte_logs.dynamic_types_len)
+		return true;
+
+	t = &rte_logs.dynamic_types[type];
+	if (t->rate_burst == 0)
+		return true;
+
+	if (now - t->rate_start >= t->rate_period) {
+		suppressed = t->rate_suppressed;
+		t->rate_start = now;
+		t->rate_count = 0;
+		t->rate_suppressed = 0;
+		if (suppressed != 0)
+			log_emit(level, type, "%s: %" PRIu64 " messages suppressed\n",
+				t->name == NULL ? "" : t->name, suppressed);
+	}
+
+	if (t->rate_count >= t->rate_burst) {
+		t->rate_suppressed++;
+		rte_atomic_fetch_add_explicit(&t->suppressed, 1,
+			rte_memory_order_relaxed);
+		return false;
+	}
+
+	t->rate_count++;
+	return true;
+}
+
 static int
 log_lookup(const char *name)
 {
@@ -451,14 +526,53 @@ rte_log_dump(FILE *f)
 		eal_log_level2str(rte_log_get_global_level()));
 
 	for (i = 0; i < rte_logs.dynamic_types_len; i++) {
-		if (rte_logs.dynamic_types[i].name == NULL)
+		struct rte_log_dynamic_type *t = &rte_logs.dynamic_types[i];
+		uint64_t drops, suppressed;
+
+		if (t->name == NULL)
 			continue;
 		fprintf(f, "id %zu: %s, level is %s\n",
-			i, rte_logs.dynamic_types[i].name,
-			eal_log_level2str(rte_logs.dynamic_types[i].loglevel));
+			i, t->name, eal_log_level2str(t->loglevel));
+
+		drops = rte_atomic_load_explicit(&t->drops,
+			rte_memory_order_relaxed);
+		suppressed = rte_atomic_load_explicit(&t->suppressed,
+			rte_memory_order_relaxed);
+		if (drops != 0 || suppressed != 0)
+			fprintf(f, "\t%" PRIu64 " dropped, %" PRIu64 " suppressed\n",
+				drops, suppressed);
 	}
 }
 
+__rte_format_printf(3, 0)
+static int
+log_print(uint32_t level, uint32_t logtype, const char *format, va_list ap)
+{
+	FILE *f = rte_log_get_stream();
+	int ret;
+
+	/* save loglevel and logtype in a global per-lcore variable */
+	RTE_PER_LCORE(log_cur_msg).loglevel = level;
+	RTE_PER_LCORE(log_cur_msg).logtype = logtype;
+
+	ret = (*rte_logs.print_func)(f, format, ap);
+	fflush(f);
+	return ret;
+}
+
+/* Write a message to the log stream, used by the logging thread. */
+int
+log_emit(uint32_t level, uint32_t logtype, const char *format, ...)
+{
+	va_list ap;
+	int ret;
+
+	va_start(ap, format);
+	ret = log_print(level, logtype, format, ap);
+	va_end(ap);
+	return ret;
+}
+
 /*
  * Generates a log message The message will be sent in the stream
  * defined by the previous call to rte_openlog_stream().
@@ -466,7 +580,6 @@ rte_log_dump(FILE *f)
 int
 rte_vlog(uint32_t level, uint32_t logtype, const char *format, va_list ap)
 {
-	FILE *f = rte_log_get_stream();
 	int ret;
 
 	if (logtype >= rte_logs.dynamic_types_len)
@@ -474,13 +587,14 @@ rte_vlog(uint32_t level, uint32_t logtype, const char *format, va_list ap)
 	if (!rte_log_can_log(logtype, level))
 		return 0;
 
-	/* save loglevel and logtype in a global per-lcore variable */
-	RTE_PER_LCORE(log_cur_msg).loglevel = level;
-	RTE_PER_LCORE(log_cur_msg).logtype = logtype;
+	/* Hand the message over to the logging thread, unless critical */
+	if (level > RTE_LOG_CRIT) {
+		ret = log_async_enqueue(level, logtype, format, ap);
+		if (ret != -ENOTSUP)
+			return ret;
+	}
 
-	ret = (*rte_logs.print_func)(f, format, ap);
-	fflush(f);
-	return ret;
+	return log_print(level, logtype, format, ap);
 }
 
 /*
@@ -542,6 +656,10 @@ eal_log_init(const char *id)
 	RTE_LOG(NOTICE, EAL,
 		"Debug dataplane logs available - lower performance\n");
 #endif
+
+	/* If --log-async option was passed */
+	if (log_async_start() < 0)
+		RTE_LOG(WARNING, EAL, "Cannot start asynchronous logging\n");
 }
 
 /*
@@ -552,6 +670,9 @@ rte_eal_log_cleanup(void)
 {
 	FILE *log_stream = rte_logs.file;
 
+	/* write out the pending messages */
+	log_async_stop();
+
 	/* don't close stderr on the application */
 	if (log_stream != NULL)
 		fclose(log_stream);
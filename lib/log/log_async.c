@@ -0,0 +1,538 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <rte_atomic.h>
+#include <rte_bitops.h>
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_per_lcore.h>
+#include <rte_stdatomic.h>
+#include <rte_time.h>
+
+#include "log_internal.h"
+#include "log_private.h"
+
+#define LOG_ASYNC_RING_SIZE_DEF (64 * 1024)
+#define LOG_ASYNC_RING_SIZE_MIN (16 * 1024)
+#define LOG_ASYNC_RING_SIZE_MAX (64 * 1024 * 1024)
+#define LOG_ASYNC_SLEEP_MIN_US 1000
+#define LOG_ASYNC_SLEEP_MAX_US 64000
+#define LOG_ASYNC_PAD UINT32_MAX
+
+/* Queued message, followed by the formatted string */
+struct log_async_rec {
+	uint64_t time;  /* CLOCK_MONOTONIC time of the message */
+	uint32_t level;
+	uint32_t type;  /* LOG_ASYNC_PAD for the padding before a wrap around */
+	uint32_t size;  /* Size of the record, including the string */
+	uint32_t reserved;
+};
+
+/*
+ * Single producer/single consumer ring of the messages of a thread.
+ * Rings are never freed while the logging thread runs: the ring of an exited
+ * thread is reused by the next thread that logs.
+ * Stopping waits for the threads writing to a ring before freeing them,
+ * and bumps the generation so that threads drop their stale ring pointer.
+ */
+struct log_async_ring {
+	struct log_async_ring *next;
+	RTE_ATOMIC(bool) used;
+	RTE_ATOMIC(uint64_t) head;
+	RTE_ATOMIC(uint64_t) tail;
+	RTE_ATOMIC(uint64_t) queued;
+	RTE_ATOMIC(uint64_t) drops;
+	uint8_t data[];
+};
+
+/*
+ * Per-thread state telling that the thread accesses the rings.
+ * Writers are never freed: the writer of an exited thread is reused by the
+ * next thread that logs. It is padded to a cache line so that the writers of
+ * two threads never share a line.
+ */
+struct log_async_writer {
+	struct log_async_writer *next;
+	RTE_ATOMIC(bool) used;
+	RTE_ATOMIC(bool) busy;
+	uint8_t pad[RTE_CACHE_LINE_MIN_SIZE];
+};
+
+static struct {
+	bool enabled;
+	uint32_t ring_size;
+	RTE_ATOMIC(bool) running;
+	uint32_t generation;
+	pthread_t thread;
+	pthread_key_t key;
+	pthread_key_t writer_key;
+	pthread_once_t writer_once;
+	int writer_key_ret;
+	RTE_ATOMIC(struct log_async_writer *) writers;
+	RTE_ATOMIC(struct log_async_ring *) rings;
+	RTE_ATOMIC(uint64_t) emitted;
+	RTE_ATOMIC(uint64_t) suppressed;
+} log_async = {
+	.ring_size = LOG_ASYNC_RING_SIZE_DEF,
+	.writer_once = PTHREAD_ONCE_INIT,
+};
+
+static RTE_DEFINE_PER_LCORE(struct log_async_writer *, log_async_writer);
+static RTE_DEFINE_PER_LCORE(struct log_async_ring *, log_async_ring);
+static RTE_DEFINE_PER_LCORE(uint32_t, log_async_generation);
+static RTE_DEFINE_PER_LCORE(bool, log_async_thread);
+
+/* Enable asynchronous logging, with an optional per-thread buffer size */
+int
+eal_log_async(const char *size)
+{
+	unsigned long sz = LOG_ASYNC_RING_SIZE_DEF;
+	char *end;
+
+	if (size != NULL) {
+		errno = 0;
+		sz = strtoul(size, &end, 0);
+		if (errno != 0 || *end != '\0' ||
+				sz < LOG_ASYNC_RING_SIZE_MIN ||
+				sz > LOG_ASYNC_RING_SIZE_MAX)
+			return -1;
+	}
+
+	log_async.ring_size = rte_align32pow2(sz);
+	log_async.enabled = true;
+	return 0;
+}
+
+/* Thread exit: leave the writer to the next thread */
+static void
+log_async_writer_release(void *arg)
+{
+	struct log_async_writer *w = arg;
+
+	RTE_PER_LCORE(log_async_writer) = NULL;
+	rte_atomic_store_explicit(&w->used, false, rte_memory_order_release);
+}
+
+static void
+log_async_writer_key_create(void)
+{
+	log_async.writer_key_ret = pthread_key_create(&log_async.writer_key,
+		log_async_writer_release);
+}
+
+static struct log_async_writer *
+log_async_writer_get(void)
+{
+	struct log_async_writer *w;
+	bool unused;
+
+	pthread_once(&log_async.writer_once, log_async_writer_key_create);
+	if (log_async.writer_key_ret != 0)
+		return NULL;
+
+	/* reuse the writer of an exited thread */
+	w = rte_atomic_load_explicit(&log_async.writers,
+		rte_memory_order_acquire);
+	for (; w != NULL; w = w->next) {
+		unused = false;
+		if (rte_atomic_compare_exchange_strong_explicit(&w->used,
+				&unused, true, rte_memory_order_acquire,
+				rte_memory_order_relaxed))
+			goto found;
+	}
+
+	w = calloc(1, sizeof(*w));
+	if (w == NULL)
+		return NULL;
+	w->used = true;
+
+	w->next = rte_atomic_load_explicit(&log_async.writers,
+		rte_memory_order_relaxed);
+	while (!rte_atomic_compare_exchange_weak_explicit(&log_async.writers,
+			&w->next, w, rte_memory_order_release,
+			rte_memory_order_relaxed))
+		;
+
+found:
+	pthread_setspecific(log_async.writer_key, w);
+	RTE_PER_LCORE(log_async_writer) = w;
+	return w;
+}
+
+/*
+ * Register the calling thread as accessing the rings.
+ * Fails once stopping started: the rings may be freed at any time.
+ *
+ * Only the calling thread writes its busy flag, so that logging threads do
+ * not contend on a shared cache line. The fence orders the store of busy
+ * before the load of running, and pairs with the fence of log_async_stop()
+ * which orders the store of running before the load of the busy flags:
+ * either the writer sees running cleared, or stopping sees the writer busy
+ * and waits for it.
+ */
+static bool
+log_async_enter(void)
+{
+	struct log_async_writer *w = RTE_PER_LCORE(log_async_writer);
+
+	if (unlikely(w == NULL)) {
+		w = log_async_writer_get();
+		if (w == NULL)
+			return false;
+	}
+
+	rte_atomic_store_explicit(&w->busy, true, rte_memory_order_relaxed);
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+	if (rte_atomic_load_explicit(&log_async.running,
+			rte_memory_order_relaxed))
+		return true;
+
+	rte_atomic_store_explicit(&w->busy, false, rte_memory_order_relaxed);
+	return false;
+}
+
+/* Release: the ring accesses are done before stopping frees the rings */
+static void
+log_async_leave(void)
+{
+	rte_atomic_store_explicit(&RTE_PER_LCORE(log_async_writer)->busy, false,
+		rte_memory_order_release);
+}
+
+/* Thread exit: leave the ring to the next thread */
+static void
+log_async_ring_release(void *arg)
+{
+	struct log_async_ring *r = arg;
+
+	if (!log_async_enter())
+		return;
+	if (RTE_PER_LCORE(log_async_generation) == log_async.generation)
+		rte_atomic_store_explicit(&r->used, false,
+			rte_memory_order_release);
+	log_async_leave();
+}
+
+static struct log_async_ring *
+log_async_ring_get(void)
+{
+	struct log_async_ring *r = RTE_PER_LCORE(log_async_ring);
+	bool unused;
+
+	if (likely(r != NULL &&
+			RTE_PER_LCORE(log_async_generation) == log_async.generation))
+		return r;
+
+	/* reuse the ring of an exited thread */
+	r = rte_atomic_load_explicit(&log_async.rings, rte_memory_order_acquire);
+	for (; r != NULL; r = r->next) {
+		unused = false;
+		if (rte_atomic_compare_exchange_strong_explicit(&r->used,
+				&unused, true, rte_memory_order_acquire,
+				rte_memory_order_relaxed))
+			goto found;
+	}
+
+	r = calloc(1, sizeof(*r) + log_async.ring_size);
+	if (r == NULL)
+		return NULL;
+	r->used = true;
+
+	r->next = rte_atomic_load_explicit(&log_async.rings,
+		rte_memory_order_relaxed);
+	while (!rte_atomic_compare_exchange_weak_explicit(&log_async.rings,
+			&r->next, r, rte_memory_order_release,
+			rte_memory_order_relaxed))
+		;
+
+found:
+	pthread_setspecific(log_async.key, r);
+	RTE_PER_LCORE(log_async_ring) = r;
+	RTE_PER_LCORE(log_async_generation) = log_async.generation;
+	return r;
+}
+
+/*
+ * Queue a message for the logging thread.
+ * Returns -ENOTSUP, without using ap, when the message must be written
+ * synchronously.
+ */
+int
+log_async_enqueue(uint32_t level, uint32_t logtype,
+		const char *format, va_list ap)
+{
+	const uint64_t size = log_async.ring_size;
+	struct log_async_rec *rec;
+	struct log_async_ring *r;
+	uint64_t head, tail, pos, contig, need, total;
+	struct timespec now;
+	char msg[LINE_MAX];
+	int len;
+
+	if (RTE_PER_LCORE(log_async_thread) || !log_async_enter())
+		return -ENOTSUP;
+
+	r = log_async_ring_get();
+	if (r == NULL) {
+		log_async_leave();
+		return -ENOTSUP;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	len = vsnprintf(msg, sizeof(msg), format, ap);
+	if (len < 0) {
+		log_async_leave();
+		return len;
+	}
+	len = RTE_MIN(len, (int)sizeof(msg) - 1);
+	need = RTE_ALIGN_CEIL(sizeof(*rec) + len + 1, sizeof(uint64_t));
+
+	head = rte_atomic_load_explicit(&r->head, rte_memory_order_relaxed);
+	tail = rte_atomic_load_explicit(&r->tail, rte_memory_order_acquire);
+	pos = head & (size - 1);
+	contig = size - pos;
+	total = need <= contig ? need : contig + need;
+	if (total > size - (head - tail)) {
+		rte_atomic_fetch_add_explicit(&r->drops, 1,
+			rte_memory_order_relaxed);
+		log_type_drop(logtype);
+		log_async_leave();
+		return -ENOBUFS;
+	}
+
+	/* not enough room until the end of the ring, wrap around */
+	if (need > contig) {
+		if (contig >= sizeof(*rec)) {
+			rec = (struct log_async_rec *)&r->data[pos];
+			rec->type = LOG_ASYNC_PAD;
+			rec->size = contig;
+		}
+		pos = 0;
+	}
+
+	rec = (struct log_async_rec *)&r->data[pos];
+	rec->time = rte_timespec_to_ns(&now);
+	rec->level = level;
+	rec->type = logtype;
+	rec->size = need;
+	memcpy(rec + 1, msg, len + 1);
+
+	rte_atomic_store_explicit(&r->head, head + total,
+		rte_memory_order_release);
+	rte_atomic_store_explicit(&r->queued,
+		rte_atomic_load_explicit(&r->queued, rte_memory_order_relaxed) + 1,
+		rte_memory_order_relaxed);
+	log_async_leave();
+
+	return len;
+}
+
+/* Get the oldest message of a ring, and the ring position after it */
+static struct log_async_rec *
+log_async_ring_peek(struct log_async_ring *r, uint64_t *next)
+{
+	const uint64_t size = log_async.ring_size;
+	struct log_async_rec *rec;
+	uint64_t head, tail, contig;
+
+	tail = rte_atomic_load_explicit(&r->tail, rte_memory_order_relaxed);
+	head = rte_atomic_load_explicit(&r->head, rte_memory_order_acquire);
+	while (tail != head) {
+		contig = size - (tail & (size - 1));
+		if (contig < sizeof(*rec)) {
+			tail += contig;
+			continue;
+		}
+
+		rec = (struct log_async_rec *)&r->data[tail & (size - 1)];
+		if (rec->type == LOG_ASYNC_PAD) {
+			tail += rec->size;
+			continue;
+		}
+
+		*next = tail + rec->size;
+		return rec;
+	}
+
+	return NULL;
+}
+
+/* Write out the queued messages of all threads, in time order */
+static unsigned int
+log_async_drain(void)
+{
+	struct log_async_ring *r, *best_ring;
+	struct log_async_rec *rec, *best;
+	uint64_t next, best_next = 0;
+	unsigned int n = 0;
+
+	for (;;) {
+		best = NULL;
+		best_ring = NULL;
+		r = rte_atomic_load_explicit(&log_async.rings,
+			rte_memory_order_acquire);
+		for (; r != NULL; r = r->next) {
+			rec = log_async_ring_peek(r, &next);
+			if (rec == NULL)
+				continue;
+			if (best == NULL || rec->time < best->time) {
+				best = rec;
+				best_ring = r;
+				best_next = next;
+			}
+		}
+		if (best == NULL)
+			break;
+
+		log_timestamp_at(best->time);
+		if (log_type_admit(best->level, best->type, best->time)) {
+			log_emit(best->level, best->type, "%s",
+				(const char *)(best + 1));
+			rte_atomic_fetch_add_explicit(&log_async.emitted, 1,
+				rte_memory_order_relaxed);
+		} else {
+			rte_atomic_fetch_add_explicit(&log_async.suppressed, 1,
+				rte_memory_order_relaxed);
+		}
+		log_timestamp_at(0);
+
+		rte_atomic_store_explicit(&best_ring->tail, best_next,
+			rte_memory_order_release);
+		n++;
+	}
+
+	return n;
+}
+
+static void *
+log_async_main(void *arg __rte_unused)
+{
+	unsigned int sleep_us = LOG_ASYNC_SLEEP_MIN_US;
+	bool running;
+
+	RTE_PER_LCORE(log_async_thread) = true;
+
+	/* back off while no message is logged */
+	do {
+		running = rte_atomic_load_explicit(&log_async.running,
+			rte_memory_order_acquire);
+		if (log_async_drain() != 0)
+			sleep_us = LOG_ASYNC_SLEEP_MIN_US;
+		else
+			sleep_us = RTE_MIN(sleep_us * 2,
+				(unsigned int)LOG_ASYNC_SLEEP_MAX_US);
+		if (running)
+			usleep(sleep_us);
+	} while (running);
+
+	return NULL;
+}
+
+int
+log_async_start(void)
+{
+	int ret;
+
+	if (!log_async.enabled ||
+			rte_atomic_load_explicit(&log_async.running,
+				rte_memory_order_relaxed))
+		return 0;
+
+	ret = pthread_key_create(&log_async.key, log_async_ring_release);
+	if (ret != 0)
+		return -ret;
+
+	rte_atomic_store_explicit(&log_async.running, true,
+		rte_memory_order_release);
+	ret = pthread_create(&log_async.thread, NULL, log_async_main, NULL);
+	if (ret != 0) {
+		rte_atomic_store_explicit(&log_async.running, false,
+			rte_memory_order_release);
+		pthread_key_delete(log_async.key);
+		return -ret;
+	}
+#ifdef RTE_EXEC_ENV_LINUX
+	pthread_setname_np(log_async.thread, "dpdk-log");
+#endif
+
+	return 0;
+}
+
+void
+log_async_stop(void)
+{
+	struct log_async_writer *w;
+	struct log_async_ring *r;
+
+	if (!rte_atomic_load_explicit(&log_async.running,
+			rte_memory_order_relaxed))
+		return;
+
+	/* new messages are written synchronously from now on */
+	rte_atomic_store_explicit(&log_async.running, false,
+		rte_memory_order_relaxed);
+	/* pairs with the fence of log_async_enter() */
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+	pthread_join(log_async.thread, NULL);
+
+	/* wait for the threads still writing, and write out their messages */
+	w = rte_atomic_load_explicit(&log_async.writers, rte_memory_order_acquire);
+	for (; w != NULL; w = w->next)
+		while (rte_atomic_load_explicit(&w->busy,
+				rte_memory_order_acquire))
+			sched_yield();
+	log_async_drain();
+	pthread_key_delete(log_async.key);
+
+	r = rte_atomic_exchange_explicit(&log_async.rings, NULL,
+		rte_memory_order_acquire);
+	while (r != NULL) {
+		struct log_async_ring *next = r->next;
+
+		free(r);
+		r = next;
+	}
+	/* ring pointers kept by threads are stale */
+	log_async.generation++;
+	RTE_PER_LCORE(log_async_ring) = NULL;
+}
+
+int
+rte_log_async_stats_get(struct rte_log_async_stats *stats)
+{
+	struct log_async_ring *r;
+
+	if (stats == NULL)
+		return -EINVAL;
+
+	if (!log_async_enter())
+		return -ENOTSUP;
+
+	memset(stats, 0, sizeof(*stats));
+	r = rte_atomic_load_explicit(&log_async.rings, rte_memory_order_acquire);
+	for (; r != NULL; r = r->next) {
+		stats->queued += rte_atomic_load_explicit(&r->queued,
+			rte_memory_order_relaxed);
+		stats->dropped += rte_atomic_load_explicit(&r->drops,
+			rte_memory_order_relaxed);
+	}
+	stats->emitted = rte_atomic_load_explicit(&log_async.emitted,
+		rte_memory_order_relaxed);
+	stats->suppressed = rte_atomic_load_explicit(&log_async.suppressed,
+		rte_memory_order_relaxed);
+	log_async_leave();
+
+	return 0;
+}
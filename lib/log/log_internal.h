@@ -50,6 +50,12 @@ void rte_eal_log_cleanup(void);
 __rte_internal
 int eal_log_timestamp(const char *fmt);
 
+/*
+ * Enable asynchronous logging
+ */
+__rte_internal
+int eal_log_async(const char *size);
+
 /*
  * Enable or disable color in log messages
  */
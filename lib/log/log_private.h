@@ -40,8 +40,39 @@ log_journal_open(const char *id __rte_unused)
 }
 #endif /* !RTE_EXEC_ENV_LINUX */
 
+#ifdef RTE_EXEC_ENV_WINDOWS
+static inline int
+log_async_start(void)
+{
+	return 0;
+}
+static inline void
+log_async_stop(void)
+{
+}
+static inline int
+log_async_enqueue(uint32_t level __rte_unused, uint32_t logtype __rte_unused,
+		const char *format __rte_unused, va_list ap __rte_unused)
+{
+	return -ENOTSUP;
+}
+#else
+int log_async_start(void);
+void log_async_stop(void);
+
+__rte_format_printf(3, 0)
+int log_async_enqueue(uint32_t level, uint32_t logtype,
+		const char *format, va_list ap);
+#endif
+
+__rte_format_printf(3, 4)
+int log_emit(uint32_t level, uint32_t logtype, const char *format, ...);
+bool log_type_admit(uint32_t level, uint32_t type, uint64_t now);
+void log_type_drop(uint32_t type);
+
 bool log_timestamp_enabled(void);
 ssize_t log_timestamp(char *tsbuf, size_t tsbuflen);
+void log_timestamp_at(uint64_t monotonic_ns);
 
 __rte_format_printf(2, 0)
 int log_print_with_timestamp(FILE *f, const char *format, va_list ap);
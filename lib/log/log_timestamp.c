@@ -10,6 +10,7 @@
 #include <time.h>
 
 #include <rte_common.h>
+#include <rte_per_lcore.h>
 #include <rte_stdatomic.h>
 #include <rte_time.h>
 
@@ -39,6 +40,9 @@ static struct {
 	RTE_ATOMIC(uint64_t) last_realtime;
 } log_time;
 
+/* Time of the message being written by the logging thread, 0 for now */
+static RTE_DEFINE_PER_LCORE(uint64_t, log_time_at);
+
 /* Set the log timestamp format */
 int
 eal_log_timestamp(const char *str)
@@ -82,6 +86,37 @@ timespec_sub(const struct timespec *t0, const struct timespec *t1)
 	return ts;
 }
 
+/* Use the monotonic time of a queued message for the next timestamps */
+void
+log_timestamp_at(uint64_t monotonic_ns)
+{
+	RTE_PER_LCORE(log_time_at) = monotonic_ns;
+}
+
+/* Get the time of the message being logged */
+static int
+log_clock_gettime(clockid_t clock, struct timespec *ts)
+{
+	uint64_t at = RTE_PER_LCORE(log_time_at);
+	struct timespec mono;
+
+	if (at == 0)
+		return clock_gettime(clock, ts);
+
+	if (clock == CLOCK_MONOTONIC) {
+		*ts = rte_ns_to_timespec(at);
+		return 0;
+	}
+
+	/* shift the clock back by the time elapsed since the message */
+	if (clock_gettime(CLOCK_MONOTONIC, &mono) < 0 ||
+			clock_gettime(clock, ts) < 0)
+		return -1;
+	*ts = rte_ns_to_timespec(rte_timespec_to_ns(ts) -
+		(rte_timespec_to_ns(&mono) - at));
+	return 0;
+}
+
 /*
  * Format current timespec into ISO8601 format.
  * Surprisingly, can't just use strftime() for this;
@@ -175,7 +210,7 @@ log_timestamp(char *tsbuf, size_t tsbuflen)
 		return 0;
 
 	case LOG_TIMESTAMP_TIME:
-		if (clock_gettime(CLOCK_MONOTONIC, &now) < 0)
+		if (log_clock_gettime(CLOCK_MONOTONIC, &now) < 0)
 			return 0;
 
 		delta = timespec_sub(&now, &log_time.started);
@@ -185,26 +220,26 @@ log_timestamp(char *tsbuf, size_t tsbuflen)
 				(unsigned long)delta.tv_nsec / 1000u);
 
 	case LOG_TIMESTAMP_DELTA:
-		if (clock_gettime(CLOCK_MONOTONIC, &now) < 0)
+		if (log_clock_gettime(CLOCK_MONOTONIC, &now) < 0)
 			return 0;
 
 		return format_delta(tsbuf, tsbuflen, &now);
 
 	case LOG_TIMESTAMP_RELTIME:
-		if (clock_gettime(CLOCK_REALTIME, &now) < 0)
+		if (log_clock_gettime(CLOCK_REALTIME, &now) < 0)
 			return 0;
 
 		return format_reltime(tsbuf, tsbuflen, &now);
 
 	case LOG_TIMESTAMP_CTIME:
-		if (clock_gettime(CLOCK_REALTIME, &now) < 0)
+		if (log_clock_gettime(CLOCK_REALTIME, &now) < 0)
 			return 0;
 
 		/* trncate to remove newline from ctime result */
 		return snprintf(tsbuf, tsbuflen, "%.24s", ctime(&now.tv_sec));
 
 	case LOG_TIMESTAMP_ISO:
-		if (clock_gettime(CLOCK_REALTIME, &now) < 0)
+		if (log_clock_gettime(CLOCK_REALTIME, &now) < 0)
 			return 0;
 
 		return format_iso8601(tsbuf, tsbuflen, &now);
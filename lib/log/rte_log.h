@@ -20,6 +20,7 @@
 #include <stdbool.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_config.h>
 
 #ifdef __cplusplus
@@ -254,6 +255,56 @@ void rte_log_list_types(FILE *out, const char *prefix);
  */
 void rte_log_dump(FILE *f);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Set the rate limit of a log type.
+ *
+ * When asynchronous logging is enabled with the --log-async EAL option,
+ * the logging thread emits at most burst messages of the log type per period,
+ * and drops the others. The number of dropped messages is logged at the
+ * beginning of the next period.
+ *
+ * @param logtype
+ *   The log type identifier.
+ * @param burst
+ *   Maximum number of messages per period, 0 to disable the rate limit.
+ * @param period_ms
+ *   Rate limit period in milliseconds.
+ * @return
+ *   - 0: Success.
+ *   - (-EINVAL): Invalid log type or period.
+ */
+__rte_experimental
+int rte_log_set_rate_limit(uint32_t logtype, uint32_t burst, uint32_t period_ms);
+
+/**
+ * Asynchronous logging statistics.
+ */
+struct rte_log_async_stats {
+	uint64_t queued;     /**< Messages handed over to the logging thread. */
+	uint64_t emitted;    /**< Messages written by the logging thread. */
+	uint64_t dropped;    /**< Messages dropped for lack of buffer space. */
+	uint64_t suppressed; /**< Messages dropped by rate limiting. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Get the asynchronous logging statistics.
+ *
+ * @param[out] stats
+ *   Pointer to the structure to fill.
+ * @return
+ *   - 0: Success.
+ *   - (-EINVAL): Invalid stats pointer.
+ *   - (-ENOTSUP): Asynchronous logging is not enabled.
+ */
+__rte_experimental
+int rte_log_async_stats_get(struct rte_log_async_stats *stats);
+
 /**
  * Generates a log message.
  *
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_acl.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+
+#include "acl_priv.h"
+#include "node_private.h"
+
+int
+node_acl_set_swap(RTE_ATOMIC(struct node_acl_set *) *active, const char *name,
+		  const struct rte_acl_field_def *defs, uint32_t nb_fields,
+		  const struct rte_acl_rule *rules, uint32_t nb_rules,
+		  rte_edge_t default_next, rte_edge_t nb_edges,
+		  struct rte_rcu_qsbr *qsbr)
+{
+	/* ACL context names must be unique, old and new ones coexist */
+	static uint32_t generation;
+	struct rte_acl_config cfg;
+	struct rte_acl_param prm;
+	char s[RTE_ACL_NAMESIZE];
+	const struct rte_acl_rule *rule;
+	struct node_acl_set *set, *old;
+	uint32_t i;
+	int rc;
+
+	if ((nb_rules != 0 && rules == NULL) || default_next >= nb_edges)
+		return -EINVAL;
+	for (i = 0; i < nb_rules; i++) {
+		rule = RTE_PTR_ADD(rules, i * RTE_ACL_RULE_SZ(nb_fields));
+		if (rule->data.userdata == 0 ||
+		    rule->data.userdata > nb_edges) {
+			node_err(name, "Rule %u next edge out of range", i);
+			return -EINVAL;
+		}
+	}
+
+	set = rte_zmalloc("node_acl_set", sizeof(*set), RTE_CACHE_LINE_SIZE);
+	if (set == NULL)
+		return -ENOMEM;
+	set->default_next = default_next;
+
+	if (nb_rules != 0) {
+		snprintf(s, sizeof(s), "%s_%u", name, generation++);
+		prm.name = s;
+		prm.socket_id = SOCKET_ID_ANY;
+		prm.rule_size = RTE_ACL_RULE_SZ(nb_fields);
+		prm.max_rule_num = nb_rules;
+
+		set->ctx = rte_acl_create(&prm);
+		if (set->ctx == NULL) {
+			rc = -rte_errno;
+			goto free;
+		}
+
+		rc = rte_acl_add_rules(set->ctx, rules, nb_rules);
+		if (rc < 0)
+			goto free;
+
+		memset(&cfg, 0, sizeof(cfg));
+		cfg.num_categories = 1;
+		cfg.num_fields = nb_fields;
+		memcpy(cfg.defs, defs, nb_fields * sizeof(defs[0]));
+		rc = rte_acl_build(set->ctx, &cfg);
+		if (rc < 0) {
+			node_err(name, "Unable to build ACL context, rc=%d", rc);
+			goto free;
+		}
+	}
+
+	/* Workers see either the old or the new rule set for a whole burst */
+	old = rte_atomic_exchange_explicit(active, set, rte_memory_order_acq_rel);
+	if (old == NULL)
+		return 0;
+
+	if (qsbr != NULL)
+		rte_rcu_qsbr_synchronize(qsbr, RTE_QSBR_THRID_INVALID);
+	rte_acl_free(old->ctx);
+	rte_free(old);
+
+	return 0;
+free:
+	rte_acl_free(set->ctx);
+	rte_free(set);
+	return rc;
+}
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef __INCLUDE_ACL_PRIV_H__
+#define __INCLUDE_ACL_PRIV_H__
+
+#include <rte_acl.h>
+#include <rte_common.h>
+#include <rte_graph.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_stdatomic.h>
+
+/**
+ * @internal
+ *
+ * Rule set in use by an ACL node, replaced as a whole when the rules change.
+ */
+struct node_acl_set {
+	struct rte_acl_ctx *ctx;  /**< ACL context, NULL without rules. */
+	rte_edge_t default_next;  /**< Next edge of packets matching no rule. */
+};
+
+/**
+ * @internal
+ *
+ * Build a rule set and swap it with the one in use by an ACL node.
+ *
+ * @param active
+ *   Rule set pointer read by the node.
+ * @param name
+ *   Name of the node, used to name the ACL contexts.
+ * @param defs
+ *   Field definitions of the rules.
+ * @param nb_fields
+ *   Number of fields of the rules.
+ * @param rules
+ *   Array of rules.
+ * @param nb_rules
+ *   Number of rules.
+ * @param default_next
+ *   Next edge of the packets matching no rule.
+ * @param nb_edges
+ *   Number of edges of the node, bounding the next edges of the rules.
+ * @param qsbr
+ *   RCU QSBR variable of the workers, NULL if none.
+ *
+ * @return
+ *   0 on success, -EINVAL for a next edge out of range,
+ *   negative otherwise.
+ */
+int node_acl_set_swap(RTE_ATOMIC(struct node_acl_set *) *active,
+		      const char *name, const struct rte_acl_field_def *defs,
+		      uint32_t nb_fields, const struct rte_acl_rule *rules,
+		      uint32_t nb_rules, rte_edge_t default_next,
+		      rte_edge_t nb_edges, struct rte_rcu_qsbr *qsbr);
+
+/**
+ * @internal
+ *
+ * Get the next edge of a packet from its classification result.
+ *
+ * @param set
+ *   Rule set in use, may be NULL.
+ * @param result
+ *   User data of the matching rule, 0 if none.
+ * @param nb_edges
+ *   Number of edges of the node.
+ * @param deny
+ *   Edge of the denied packets, used for invalid user data.
+ *
+ * @return
+ *   Next edge of the packet.
+ */
+static __rte_always_inline rte_edge_t
+node_acl_next_get(const struct node_acl_set *set, uint32_t result,
+		  rte_edge_t nb_edges, rte_edge_t deny)
+{
+	if (result == 0)
+		return set == NULL ? 0 : set->default_next;
+
+	return likely(result <= nb_edges) ? (rte_edge_t)(result - 1) : deny;
+}
+
+#endif /* __INCLUDE_ACL_PRIV_H__ */
@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <rte_byteorder.h>
+#include <rte_esp.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+
+#include "rte_node_eth_api.h"
+#include "rte_node_ipsec_api.h"
+
+#include "ipsec_priv.h"
+#include "node_private.h"
+
+/*
+ * Get the SPI of an ESP packet and set its header lengths,
+ * returns false for the other packets.
+ */
+static __rte_always_inline bool
+esp_inbound_spi_get(struct rte_mbuf *mbuf, uint32_t *spi)
+{
+	const struct rte_ether_hdr *eh;
+	const struct rte_ipv4_hdr *ip4;
+	const struct rte_ipv6_hdr *ip6;
+	const struct rte_esp_hdr *esp;
+	uint16_t l3_len;
+
+	eh = rte_pktmbuf_mtod(mbuf, const struct rte_ether_hdr *);
+	if (eh->ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+		ip4 = (const struct rte_ipv4_hdr *)(eh + 1);
+		if (ip4->next_proto_id != IPPROTO_ESP)
+			return false;
+		l3_len = rte_ipv4_hdr_len(ip4);
+	} else if (eh->ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6)) {
+		/* Extension headers are not parsed */
+		ip6 = (const struct rte_ipv6_hdr *)(eh + 1);
+		if (ip6->proto != IPPROTO_ESP)
+			return false;
+		l3_len = sizeof(struct rte_ipv6_hdr);
+	} else {
+		return false;
+	}
+
+	if (unlikely(rte_pktmbuf_data_len(mbuf) <
+		     sizeof(*eh) + l3_len + sizeof(*esp)))
+		return false;
+
+	mbuf->l2_len = sizeof(*eh);
+	mbuf->l3_len = l3_len;
+	esp = rte_pktmbuf_mtod_offset(mbuf, const struct rte_esp_hdr *,
+				      sizeof(*eh) + l3_len);
+	*spi = rte_be_to_cpu_32(esp->spi);
+
+	return true;
+}
+
+static uint16_t
+esp_inbound_node_process(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t nb_objs)
+{
+	const struct node_ipsec_ctx *ctx = (const struct node_ipsec_ctx *)node->ctx;
+	const uint64_t done_flag = node_ipsec_main.done_flag;
+	struct rte_mbuf *pkts[RTE_GRAPH_BURST_SIZE];
+	const struct rte_graph_feature_arc_fp *fp;
+	struct rte_ipsec_session *ss, *last_ss;
+	struct rte_mbuf *mbuf;
+	uint16_t i, held;
+	rte_edge_t next;
+	uint32_t spi;
+
+	if (unlikely(ctx->arc == NULL)) {
+		rte_node_enqueue(graph, node, IPSEC_NODE_NEXT_PKT_DROP, objs, nb_objs);
+		return nb_objs;
+	}
+
+	fp = rte_graph_feature_arc_fp_get(ctx->arc);
+	last_ss = NULL;
+	held = 0;
+
+	for (i = 0; i < nb_objs; i++) {
+		mbuf = (struct rte_mbuf *)objs[i];
+
+		/* Decrypted by ipsec_crypto_poll, or not ESP: next feature */
+		if ((mbuf->ol_flags & done_flag) || !esp_inbound_spi_get(mbuf, &spi)) {
+			mbuf->ol_flags &= ~done_flag;
+			next = rte_graph_feature_arc_next(fp, mbuf->port, ctx->feature);
+			rte_node_enqueue_x1(graph, node, next, mbuf);
+			continue;
+		}
+
+		ss = node_ipsec_sa_get(node_ipsec_main.in_sa, spi);
+		if (unlikely(ss == NULL)) {
+			rte_node_enqueue_x1(graph, node, IPSEC_NODE_NEXT_PKT_DROP, mbuf);
+			continue;
+		}
+
+		/* Submit the consecutive packets of an SA at once */
+		if (ss != last_ss || held == RTE_GRAPH_BURST_SIZE) {
+			if (held != 0)
+				node_ipsec_crypto_submit(graph, node, ctx, last_ss,
+							 pkts, held);
+			last_ss = ss;
+			held = 0;
+		}
+		pkts[held++] = mbuf;
+	}
+
+	if (held != 0)
+		node_ipsec_crypto_submit(graph, node, ctx, last_ss, pkts, held);
+
+	return nb_objs;
+}
+
+static int
+esp_inbound_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	return node_ipsec_ctx_init(graph, node, RTE_NODE_ETHDEV_RX_FEATURE_ARC);
+}
+
+static struct rte_node_register esp_inbound_node = {
+	.process = esp_inbound_node_process,
+	.name = "esp_inbound",
+
+	.init = esp_inbound_node_init,
+
+	/* Edges to the features are added with the node to the arc */
+	.nb_edges = 1,
+	.next_nodes = {
+		[IPSEC_NODE_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(esp_inbound_node);
@@ -7,8 +7,11 @@
 
 #include <rte_ethdev.h>
 #include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
 
 #include "rte_node_eth_api.h"
+#include "rte_node_ip4_api.h"
+#include "rte_node_ip6_api.h"
 
 #include "ethdev_rx_priv.h"
 #include "ethdev_tx_priv.h"
@@ -20,12 +23,58 @@ static struct ethdev_ctrl {
 	uint16_t nb_graphs;
 } ctrl;
 
+/* Create the feature arcs of the nodes, indexed by port */
+static int
+ethdev_feature_arcs_create(void)
+{
+	static const struct {
+		const char *name;
+		const char *start;
+		const char *end;
+		const char *alt_start; /* Alternative start node */
+	} arcs[] = {
+		{ RTE_NODE_ETHDEV_RX_FEATURE_ARC, "ethdev_rx", "pkt_cls", NULL },
+		{ RTE_NODE_IP4_FORWARD_FEATURE_ARC, "ip4_lookup", "ip4_rewrite",
+		  "ip4_lookup_fib" },
+		/* End nodes are the ethdev_tx node of each port */
+		{ RTE_NODE_IP4_OUTPUT_FEATURE_ARC, "ip4_rewrite", NULL, NULL },
+		{ RTE_NODE_IP6_OUTPUT_FEATURE_ARC, "ip6_rewrite", NULL, NULL },
+	};
+	struct rte_graph_feature_arc *arc;
+	unsigned int i;
+	int rc;
+
+	for (i = 0; i < RTE_DIM(arcs); i++) {
+		if (rte_graph_feature_arc_lookup(arcs[i].name) != NULL)
+			continue;
+		arc = rte_graph_feature_arc_create(arcs[i].name, arcs[i].start,
+						   arcs[i].end, RTE_MAX_ETHPORTS);
+		if (arc == NULL) {
+			node_err("ethdev", "Failed to create feature arc %s",
+				 arcs[i].name);
+			return -rte_errno;
+		}
+		if (arcs[i].alt_start == NULL)
+			continue;
+		rc = rte_graph_feature_arc_start_add(arc, arcs[i].alt_start);
+		if (rc < 0) {
+			node_err("ethdev", "Failed to add %s to feature arc %s",
+				 arcs[i].alt_start, arcs[i].name);
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
 int
 rte_node_eth_config(struct rte_node_ethdev_config *conf, uint16_t nb_confs,
 		    uint16_t nb_graphs)
 {
 	struct rte_node_register *ip4_rewrite_node;
 	struct rte_node_register *ip6_rewrite_node;
+	struct rte_graph_feature_arc *ip4_output_arc;
+	struct rte_graph_feature_arc *ip6_output_arc;
 	struct ethdev_tx_node_main *tx_node_data;
 	uint16_t tx_q_used, rx_q_used, port_id;
 	struct rte_node_register *tx_node;
@@ -35,6 +84,12 @@ rte_node_eth_config(struct rte_node_ethdev_config *conf, uint16_t nb_confs,
 	int i, j, rc;
 	uint32_t id;
 
+	rc = ethdev_feature_arcs_create();
+	if (rc < 0)
+		return rc;
+
+	ip4_output_arc = rte_graph_feature_arc_lookup(RTE_NODE_IP4_OUTPUT_FEATURE_ARC);
+	ip6_output_arc = rte_graph_feature_arc_lookup(RTE_NODE_IP6_OUTPUT_FEATURE_ARC);
 	ip4_rewrite_node = ip4_rewrite_node_get();
 	ip6_rewrite_node = ip6_rewrite_node_get();
 	tx_node_data = ethdev_tx_node_data_get();
@@ -116,6 +171,11 @@ rte_node_eth_config(struct rte_node_ethdev_config *conf, uint16_t nb_confs,
 		if (rc < 0)
 			return rc;
 
+		/* Features of ip4_output arc send to this tx port node */
+		rc = rte_graph_feature_arc_end_set(ip4_output_arc, port_id, name);
+		if (rc < 0)
+			return rc;
+
 		/* Add this tx port node as next to ip6_rewrite_node */
 		rte_node_edge_update(ip6_rewrite_node->id, RTE_EDGE_ID_INVALID,
 				     &next_nodes, 1);
@@ -125,6 +185,10 @@ rte_node_eth_config(struct rte_node_ethdev_config *conf, uint16_t nb_confs,
 		if (rc < 0)
 			return rc;
 
+		/* Features of ip6_output arc send to this tx port node */
+		rc = rte_graph_feature_arc_end_set(ip6_output_arc, port_id, name);
+		if (rc < 0)
+			return rc;
 	}
 
 	ctrl.nb_graphs = nb_graphs;
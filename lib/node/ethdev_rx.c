@@ -6,8 +6,11 @@
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
 #include <rte_graph_worker.h>
 
+#include "rte_node_eth_api.h"
+
 #include "ethdev_rx_priv.h"
 #include "node_private.h"
 
@@ -17,6 +20,7 @@ static __rte_always_inline uint16_t
 ethdev_rx_node_process_inline(struct rte_graph *graph, struct rte_node *node,
 			      ethdev_rx_node_ctx_t *ctx)
 {
+	const struct rte_graph_feature_arc_fp *fp;
 	uint16_t count, next_index;
 	uint16_t port, queue;
 
@@ -31,6 +35,10 @@ ethdev_rx_node_process_inline(struct rte_graph *graph, struct rte_node *node,
 	if (!count)
 		return 0;
 	node->idx = count;
+	/* Send to the first feature enabled on the port, if any */
+	fp = rte_graph_feature_arc_active_get(ctx->arc);
+	if (unlikely(fp != NULL))
+		rte_graph_feature_arc_first(fp, port, &next_index);
 	/* Enqueue to next node */
 	rte_node_next_stream_move(graph, node, next_index);
 
@@ -182,6 +190,7 @@ ethdev_rx_node_init(const struct rte_graph *graph, struct rte_node *node)
 	ethdev_rx_node_elem_t *elem = ethdev_rx_main.head;
 
 	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(ethdev_rx_node_ctx_t) > RTE_NODE_CTX_SZ);
 
 	while (elem) {
 		if (elem->nid == node->id) {
@@ -194,6 +203,8 @@ ethdev_rx_node_init(const struct rte_graph *graph, struct rte_node *node)
 
 	RTE_VERIFY(elem != NULL);
 
+	ctx->arc = rte_graph_feature_arc_lookup(RTE_NODE_ETHDEV_RX_FEATURE_ARC);
+
 	/* Check and setup ptype */
 	return ethdev_ptype_setup(ctx->port_id, ctx->queue_id);
 }
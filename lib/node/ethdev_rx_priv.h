@@ -5,6 +5,7 @@
 #define __INCLUDE_ETHDEV_RX_PRIV_H__
 
 #include <rte_common.h>
+#include <rte_graph_feature_arc.h>
 
 struct ethdev_rx_node_elem;
 struct ethdev_rx_node_ctx;
@@ -20,6 +21,8 @@ struct ethdev_rx_node_ctx {
 	uint16_t port_id;  /**< Port identifier of the Rx node. */
 	uint16_t queue_id; /**< Queue identifier of the Rx node. */
 	uint16_t cls_next;
+	struct rte_graph_feature_arc *arc;
+	/**< Feature arc of the Rx port. */
 };
 
 /**
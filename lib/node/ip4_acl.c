@@ -0,0 +1,218 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <rte_acl.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+
+#include "rte_node_acl_api.h"
+
+#include "acl_priv.h"
+#include "node_private.h"
+
+/* 5-tuple of a packet, in network order, as read by rte_acl_classify() */
+struct ip4_acl_tuple {
+	uint8_t proto;
+	uint8_t pad[3];
+	rte_be32_t src;
+	rte_be32_t dst;
+	rte_be16_t src_port;
+	rte_be16_t dst_port;
+};
+
+static const struct rte_acl_field_def ip4_acl_field_defs[] = {
+	[RTE_NODE_IP4_ACL_FIELD_PROTO] = {
+		.type = RTE_ACL_FIELD_TYPE_BITMASK,
+		.size = sizeof(uint8_t),
+		.field_index = RTE_NODE_IP4_ACL_FIELD_PROTO,
+		.input_index = 0,
+		.offset = offsetof(struct ip4_acl_tuple, proto),
+	},
+	[RTE_NODE_IP4_ACL_FIELD_SRC] = {
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = RTE_NODE_IP4_ACL_FIELD_SRC,
+		.input_index = 1,
+		.offset = offsetof(struct ip4_acl_tuple, src),
+	},
+	[RTE_NODE_IP4_ACL_FIELD_DST] = {
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = RTE_NODE_IP4_ACL_FIELD_DST,
+		.input_index = 2,
+		.offset = offsetof(struct ip4_acl_tuple, dst),
+	},
+	/* Both ports are read as one 4 bytes input */
+	[RTE_NODE_IP4_ACL_FIELD_SRC_PORT] = {
+		.type = RTE_ACL_FIELD_TYPE_RANGE,
+		.size = sizeof(uint16_t),
+		.field_index = RTE_NODE_IP4_ACL_FIELD_SRC_PORT,
+		.input_index = 3,
+		.offset = offsetof(struct ip4_acl_tuple, src_port),
+	},
+	[RTE_NODE_IP4_ACL_FIELD_DST_PORT] = {
+		.type = RTE_ACL_FIELD_TYPE_RANGE,
+		.size = sizeof(uint16_t),
+		.field_index = RTE_NODE_IP4_ACL_FIELD_DST_PORT,
+		.input_index = 3,
+		.offset = offsetof(struct ip4_acl_tuple, dst_port),
+	},
+};
+
+static RTE_ATOMIC(struct node_acl_set *) ip4_acl_set;
+
+static __rte_always_inline void
+ip4_acl_tuple_get(struct rte_mbuf *mbuf, struct ip4_acl_tuple *t)
+{
+	const struct rte_ipv4_hdr *ip;
+	const rte_be16_t *ports;
+
+	ip = rte_pktmbuf_mtod_offset(mbuf, const struct rte_ipv4_hdr *,
+				     sizeof(struct rte_ether_hdr));
+	t->proto = ip->next_proto_id;
+	t->src = ip->src_addr;
+	t->dst = ip->dst_addr;
+	t->src_port = 0;
+	t->dst_port = 0;
+
+	/* Ports are only in the first fragment */
+	if ((t->proto == IPPROTO_TCP || t->proto == IPPROTO_UDP ||
+	     t->proto == IPPROTO_SCTP) &&
+	    (ip->fragment_offset & rte_cpu_to_be_16(RTE_IPV4_HDR_OFFSET_MASK)) == 0) {
+		ports = (const rte_be16_t *)((const uint8_t *)ip + rte_ipv4_hdr_len(ip));
+		t->src_port = ports[0];
+		t->dst_port = ports[1];
+	}
+}
+
+static uint16_t
+ip4_acl_node_process(struct rte_graph *graph, struct rte_node *node,
+		     void **objs, uint16_t nb_objs)
+{
+	struct ip4_acl_tuple tuple[RTE_GRAPH_BURST_SIZE];
+	const uint8_t *data[RTE_GRAPH_BURST_SIZE];
+	uint32_t result[RTE_GRAPH_BURST_SIZE];
+	const struct node_acl_set *set;
+	struct rte_mbuf **pkts;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	uint16_t denied = 0;
+	uint16_t held = 0;
+	uint16_t base, n;
+	rte_edge_t next;
+	int i;
+
+	/* One rule set for the whole stream */
+	set = rte_atomic_load_explicit(&ip4_acl_set, rte_memory_order_acquire);
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP4_ACL_NEXT_PERMIT;
+	from = objs;
+
+	for (i = OBJS_PER_CLINE; i < RTE_GRAPH_BURST_SIZE; i += OBJS_PER_CLINE)
+		rte_prefetch0(&objs[i]);
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+
+	/* The stream may be larger than a burst, classify it burst by burst */
+	for (base = 0; base < nb_objs; base += n) {
+		n = RTE_MIN(nb_objs - base, RTE_GRAPH_BURST_SIZE);
+		pkts = (struct rte_mbuf **)&objs[base];
+
+		for (i = 0; i < 4 && i < n; i++)
+			rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+					sizeof(struct rte_ether_hdr)));
+
+		/* Extract the 5-tuples of the burst */
+		for (i = 0; i < n; i++) {
+			if (likely(i + 4 < n))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i + 4],
+						void *, sizeof(struct rte_ether_hdr)));
+
+			ip4_acl_tuple_get(pkts[i], &tuple[i]);
+			data[i] = (const uint8_t *)&tuple[i];
+		}
+
+		/* One classification of the burst, no match without rules */
+		if (unlikely(set == NULL || set->ctx == NULL ||
+			     rte_acl_classify(set->ctx, data, result, n, 1) != 0))
+			memset(result, 0, n * sizeof(result[0]));
+
+		for (i = 0; i < n; i++) {
+			next = node_acl_next_get(set, result[i], node->nb_edges,
+						 RTE_NODE_IP4_ACL_NEXT_DENY);
+			denied += (next == RTE_NODE_IP4_ACL_NEXT_DENY);
+
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	NODE_INCREMENT_XSTAT_ID(node, 0, denied != 0, denied);
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static struct rte_node_register ip4_acl_node;
+
+int
+rte_node_ip4_acl_rules_set(const struct rte_node_ip4_acl_rule *rules,
+			   uint32_t nb_rules, rte_edge_t default_next,
+			   struct rte_rcu_qsbr *qsbr)
+{
+	RTE_BUILD_BUG_ON(RTE_DIM(ip4_acl_field_defs) != RTE_NODE_IP4_ACL_FIELD_NUM);
+
+	return node_acl_set_swap(&ip4_acl_set, "ip4_acl", ip4_acl_field_defs,
+				 RTE_NODE_IP4_ACL_FIELD_NUM,
+				 (const struct rte_acl_rule *)rules, nb_rules,
+				 default_next,
+				 rte_node_edge_count(ip4_acl_node.id), qsbr);
+}
+
+static struct rte_node_xstats ip4_acl_xstats = {
+	.nb_xstats = 1,
+	.xstat_desc = {
+		[0] = "ip4_acl_deny",
+	},
+};
+
+static struct rte_node_register ip4_acl_node = {
+	.process = ip4_acl_node_process,
+	.name = "ip4_acl",
+
+	.xstats = &ip4_acl_xstats,
+
+	.nb_edges = RTE_NODE_IP4_ACL_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IP4_ACL_NEXT_PERMIT] = "ip4_lookup",
+		[RTE_NODE_IP4_ACL_NEXT_DENY] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip4_acl_node);
@@ -8,6 +8,7 @@
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
 #include <rte_graph_worker.h>
 #include <rte_ip.h>
 #include <rte_lpm.h>
@@ -22,6 +23,8 @@
 /* IP4 Lookup global data struct */
 struct ip4_lookup_node_main {
 	struct rte_lpm *lpm_tbl[RTE_MAX_NUMA_NODES];
+	/* Features between lookup and rewrite */
+	struct rte_graph_feature_arc *arc;
 };
 
 struct ip4_lookup_node_ctx {
@@ -41,6 +44,47 @@ static struct ip4_lookup_node_main ip4_lookup_nm;
 #define IP4_LOOKUP_NODE_PRIV1_OFF(ctx) \
 	(((struct ip4_lookup_node_ctx *)ctx)->mbuf_priv1_off)
 
+/* Lookup sending the routed packets to the features enabled on their Rx port */
+static uint16_t
+ip4_lookup_node_process_feature(struct rte_graph *graph, struct rte_node *node,
+				void **objs, uint16_t nb_objs,
+				const struct rte_graph_feature_arc_fp *fp)
+{
+	struct rte_lpm *lpm = IP4_LOOKUP_NODE_LPM(node->ctx);
+	const int dyn = IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_mbuf *mbuf;
+	uint32_t next_hop;
+	uint32_t drop_nh;
+	rte_edge_t next;
+	int i, rc;
+
+	drop_nh = ((uint32_t)RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP) << 16;
+
+	for (i = 0; i < nb_objs; i++) {
+		mbuf = (struct rte_mbuf *)objs[i];
+
+		ipv4_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv4_hdr *,
+				sizeof(struct rte_ether_hdr));
+		node_mbuf_priv1(mbuf, dyn)->cksum = ipv4_hdr->hdr_checksum;
+		node_mbuf_priv1(mbuf, dyn)->ttl = ipv4_hdr->time_to_live;
+
+		rc = rte_lpm_lookup(lpm, rte_be_to_cpu_32(ipv4_hdr->dst_addr),
+				    &next_hop);
+		next_hop = (rc == 0) ? next_hop : drop_nh;
+		NODE_INCREMENT_XSTAT_ID(node, 0, rc != 0, 1);
+
+		node_mbuf_priv1(mbuf, dyn)->nh = (uint16_t)next_hop;
+		next = (rte_edge_t)(next_hop >> 16);
+		if (next == RTE_NODE_IP4_LOOKUP_NEXT_REWRITE)
+			rte_graph_feature_arc_first(fp, mbuf->port, &next);
+
+		rte_node_enqueue_x1(graph, node, next, mbuf);
+	}
+
+	return nb_objs;
+}
+
 #if defined(__ARM_NEON)
 #include "ip4_lookup_neon.h"
 #elif defined(RTE_ARCH_X86)
@@ -53,6 +97,7 @@ ip4_lookup_node_process_scalar(struct rte_graph *graph, struct rte_node *node,
 {
 	struct rte_lpm *lpm = IP4_LOOKUP_NODE_LPM(node->ctx);
 	const int dyn = IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	const struct rte_graph_feature_arc_fp *fp;
 	struct rte_ipv4_hdr *ipv4_hdr;
 	void **to_next, **from;
 	uint16_t last_spec = 0;
@@ -62,6 +107,10 @@ ip4_lookup_node_process_scalar(struct rte_graph *graph, struct rte_node *node,
 	uint32_t drop_nh;
 	int i, rc;
 
+	fp = rte_graph_feature_arc_active_get(ip4_lookup_nm.arc);
+	if (unlikely(fp != NULL))
+		return ip4_lookup_node_process_feature(graph, node, objs, nb_objs, fp);
+
 	/* Speculative next */
 	next_index = RTE_NODE_IP4_LOOKUP_NEXT_REWRITE;
 	/* Drop node */
@@ -209,6 +258,7 @@ ip4_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
 	/* Update socket's LPM and mbuf dyn priv1 offset in node ctx */
 	IP4_LOOKUP_NODE_LPM(node->ctx) = ip4_lookup_nm.lpm_tbl[graph->socket];
 	IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+	ip4_lookup_nm.arc = rte_graph_feature_arc_lookup(RTE_NODE_IP4_FORWARD_FEATURE_ARC);
 
 #if defined(__ARM_NEON) || defined(RTE_ARCH_X86)
 	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128)
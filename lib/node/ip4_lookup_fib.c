@@ -0,0 +1,262 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_fib.h>
+#include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_memzone.h>
+
+#include "rte_node_ip4_api.h"
+
+#include "node_private.h"
+
+/* IP4 FIB lookup global data struct */
+struct ip4_lookup_fib_node_main {
+	struct rte_fib *fib[RTE_MAX_NUMA_NODES];
+	/* Features between lookup and rewrite, shared with ip4_lookup */
+	struct rte_graph_feature_arc *arc;
+};
+
+struct ip4_lookup_fib_node_ctx {
+	/* Socket's FIB */
+	struct rte_fib *fib;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+static struct ip4_lookup_fib_node_main ip4_lookup_fib_nm;
+
+#define IP4_LOOKUP_FIB_NODE(ctx) \
+	(((struct ip4_lookup_fib_node_ctx *)ctx)->fib)
+
+#define IP4_LOOKUP_FIB_NODE_PRIV1_OFF(ctx) \
+	(((struct ip4_lookup_fib_node_ctx *)ctx)->mbuf_priv1_off)
+
+/* Next hop returned for addresses without route */
+#define IP4_LOOKUP_FIB_DROP_NH \
+	((uint64_t)RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP << 16)
+
+static uint16_t
+ip4_lookup_fib_node_process(struct rte_graph *graph, struct rte_node *node,
+			    void **objs, uint16_t nb_objs)
+{
+	struct rte_fib *fib = IP4_LOOKUP_FIB_NODE(node->ctx);
+	const int dyn = IP4_LOOKUP_FIB_NODE_PRIV1_OFF(node->ctx);
+	const struct rte_graph_feature_arc_fp *fp;
+	uint64_t next_hop[RTE_GRAPH_BURST_SIZE];
+	uint32_t ip[RTE_GRAPH_BURST_SIZE];
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_mbuf *mbuf, **pkts;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	uint16_t lookup_err = 0;
+	uint16_t held = 0;
+	uint16_t base, n;
+	uint16_t next;
+	int i;
+
+	/* Routed packets go to the features enabled on their Rx port */
+	fp = rte_graph_feature_arc_active_get(ip4_lookup_fib_nm.arc);
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP4_LOOKUP_NEXT_REWRITE;
+	from = objs;
+
+	for (i = OBJS_PER_CLINE; i < RTE_GRAPH_BURST_SIZE; i += OBJS_PER_CLINE)
+		rte_prefetch0(&objs[i]);
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+
+	/* The stream may be larger than a burst, look it up burst by burst */
+	for (base = 0; base < nb_objs; base += n) {
+		n = RTE_MIN(nb_objs - base, RTE_GRAPH_BURST_SIZE);
+		pkts = (struct rte_mbuf **)&objs[base];
+
+		for (i = 0; i < 4 && i < n; i++)
+			rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+					sizeof(struct rte_ether_hdr)));
+
+		/* Gather the destination addresses */
+		for (i = 0; i < n; i++) {
+			if (likely(i + 4 < n))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i + 4],
+						void *, sizeof(struct rte_ether_hdr)));
+
+			mbuf = pkts[i];
+			ipv4_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv4_hdr *,
+					sizeof(struct rte_ether_hdr));
+			/* Extract cksum, ttl as ipv4 hdr is in cache */
+			node_mbuf_priv1(mbuf, dyn)->cksum = ipv4_hdr->hdr_checksum;
+			node_mbuf_priv1(mbuf, dyn)->ttl = ipv4_hdr->time_to_live;
+			ip[i] = rte_be_to_cpu_32(ipv4_hdr->dst_addr);
+		}
+
+		/* One bulk lookup, misses get the drop next hop as default */
+		if (unlikely(fib == NULL ||
+				rte_fib_lookup_bulk(fib, ip, next_hop, n) != 0))
+			for (i = 0; i < n; i++)
+				next_hop[i] = IP4_LOOKUP_FIB_DROP_NH;
+
+		for (i = 0; i < n; i++) {
+			node_mbuf_priv1(pkts[i], dyn)->nh = (uint16_t)next_hop[i];
+			next = (uint16_t)(next_hop[i] >> 16);
+			lookup_err += (next_hop[i] == IP4_LOOKUP_FIB_DROP_NH);
+			if (unlikely(fp != NULL) &&
+			    next == RTE_NODE_IP4_LOOKUP_NEXT_REWRITE)
+				rte_graph_feature_arc_first(fp, pkts[i]->port, &next);
+
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	NODE_INCREMENT_XSTAT_ID(node, 0, lookup_err != 0, lookup_err);
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip4_fib_create(int socket, struct rte_fib_conf *conf)
+{
+	struct ip4_lookup_fib_node_main *nm = &ip4_lookup_fib_nm;
+	struct rte_fib_conf fib_conf;
+	char s[RTE_MEMZONE_NAMESIZE];
+
+	if (socket < 0 || socket >= RTE_MAX_NUMA_NODES || conf == NULL)
+		return -EINVAL;
+
+	/* Next hops hold the next node id above the 16 bits of next hop id */
+	if (conf->type == RTE_FIB_DIR24_8 &&
+	    conf->dir24_8.nh_sz < RTE_FIB_DIR24_8_4B)
+		return -EINVAL;
+
+	/* One FIB per socket */
+	if (nm->fib[socket])
+		return 0;
+
+	/* Misses are sent to the drop node */
+	fib_conf = *conf;
+	fib_conf.default_nh = IP4_LOOKUP_FIB_DROP_NH;
+	snprintf(s, sizeof(s), "IPV4_LOOKUP_FIB_%d", socket);
+	nm->fib[socket] = rte_fib_create(s, socket, &fib_conf);
+	if (nm->fib[socket] == NULL)
+		return -rte_errno;
+
+	return 0;
+}
+
+int
+rte_node_ip4_fib_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
+			   enum rte_node_ip4_lookup_next next_node)
+{
+	char abuf[INET6_ADDRSTRLEN];
+	struct in_addr in;
+	uint8_t socket;
+	uint32_t val;
+	int ret;
+
+	in.s_addr = htonl(ip);
+	inet_ntop(AF_INET, &in, abuf, sizeof(abuf));
+	/* Embedded next node id into 24 bit next hop */
+	val = ((next_node << 16) | next_hop) & ((1ull << 24) - 1);
+	node_dbg("ip4_lookup_fib", "FIB: Adding route %s / %d nh (0x%x)", abuf,
+		 depth, val);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip4_lookup_fib_nm.fib[socket])
+			continue;
+
+		ret = rte_fib_add(ip4_lookup_fib_nm.fib[socket], ip, depth, val);
+		if (ret < 0) {
+			node_err("ip4_lookup_fib",
+				 "Unable to add entry %s / %d nh (%x) to FIB on sock %d, rc=%d",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int
+ip4_lookup_fib_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	static uint8_t init_once;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ip4_lookup_fib_node_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+		init_once = 1;
+	}
+
+	/*
+	 * Update socket's FIB and mbuf dyn priv1 offset in node ctx.
+	 * Without FIB, created by rte_node_ip4_fib_create(), all packets
+	 * are dropped.
+	 */
+	IP4_LOOKUP_FIB_NODE(node->ctx) = ip4_lookup_fib_nm.fib[graph->socket];
+	IP4_LOOKUP_FIB_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+	ip4_lookup_fib_nm.arc = rte_graph_feature_arc_lookup(RTE_NODE_IP4_FORWARD_FEATURE_ARC);
+	if (IP4_LOOKUP_FIB_NODE(node->ctx) == NULL)
+		node_dbg("ip4_lookup_fib", "No FIB for socket %d", graph->socket);
+
+	node_dbg("ip4_lookup_fib", "Initialized ip4_lookup_fib node");
+
+	return 0;
+}
+
+static struct rte_node_xstats ip4_lookup_fib_xstats = {
+	.nb_xstats = 1,
+	.xstat_desc = {
+		[0] = "ip4_lookup_fib_error",
+	},
+};
+
+static struct rte_node_register ip4_lookup_fib_node = {
+	.process = ip4_lookup_fib_node_process,
+	.name = "ip4_lookup_fib",
+
+	.init = ip4_lookup_fib_node_init,
+	.xstats = &ip4_lookup_fib_xstats,
+
+	.nb_edges = RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_IP4_LOOKUP_NEXT_IP4_LOCAL] = "ip4_local",
+		[RTE_NODE_IP4_LOOKUP_NEXT_REWRITE] = "ip4_rewrite",
+		[RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip4_lookup_fib_node);
@@ -13,6 +13,7 @@ ip4_lookup_node_process_vec(struct rte_graph *graph, struct rte_node *node,
 	struct rte_mbuf *mbuf0, *mbuf1, *mbuf2, *mbuf3, **pkts;
 	struct rte_lpm *lpm = IP4_LOOKUP_NODE_LPM(node->ctx);
 	const int dyn = IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	const struct rte_graph_feature_arc_fp *fp;
 	struct rte_ipv4_hdr *ipv4_hdr;
 	void **to_next, **from;
 	uint16_t last_spec = 0;
@@ -26,6 +27,10 @@ ip4_lookup_node_process_vec(struct rte_graph *graph, struct rte_node *node,
 	int32x4_t dip;
 	int rc, i;
 
+	fp = rte_graph_feature_arc_active_get(ip4_lookup_nm.arc);
+	if (unlikely(fp != NULL))
+		return ip4_lookup_node_process_feature(graph, node, objs, nb_objs, fp);
+
 	/* Speculative next */
 	next_index = RTE_NODE_IP4_LOOKUP_NEXT_REWRITE;
 	/* Drop node */
@@ -13,6 +13,7 @@ ip4_lookup_node_process_vec(struct rte_graph *graph, struct rte_node *node,
 	struct rte_mbuf *mbuf0, *mbuf1, *mbuf2, *mbuf3, **pkts;
 	struct rte_lpm *lpm = IP4_LOOKUP_NODE_LPM(node->ctx);
 	const int dyn = IP4_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	const struct rte_graph_feature_arc_fp *fp;
 	rte_edge_t next0, next1, next2, next3, next_index;
 	struct rte_ipv4_hdr *ipv4_hdr;
 	uint32_t ip0, ip1, ip2, ip3;
@@ -25,6 +26,10 @@ ip4_lookup_node_process_vec(struct rte_graph *graph, struct rte_node *node,
 	__m128i dip; /* SSE register */
 	int rc, i;
 
+	fp = rte_graph_feature_arc_active_get(ip4_lookup_nm.arc);
+	if (unlikely(fp != NULL))
+		return ip4_lookup_node_process_feature(graph, node, objs, nb_objs, fp);
+
 	/* Speculative next */
 	next_index = RTE_NODE_IP4_LOOKUP_NEXT_REWRITE;
 	/* Drop node */
@@ -5,6 +5,7 @@
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
 #include <rte_graph_worker.h>
 #include <rte_ip.h>
 #include <rte_malloc.h>
@@ -20,6 +21,8 @@ struct ip4_rewrite_node_ctx {
 	int mbuf_priv1_off;
 	/* Cached next index */
 	uint16_t next_index;
+	/* Features between rewrite and Tx */
+	struct rte_graph_feature_arc *arc;
 };
 
 static struct ip4_rewrite_node_main *ip4_rewrite_nm;
@@ -30,6 +33,52 @@ static struct ip4_rewrite_node_main *ip4_rewrite_nm;
 #define IP4_REWRITE_NODE_PRIV1_OFF(ctx) \
 	(((struct ip4_rewrite_node_ctx *)ctx)->mbuf_priv1_off)
 
+#define IP4_REWRITE_NODE_ARC(ctx) \
+	(((struct ip4_rewrite_node_ctx *)ctx)->arc)
+
+/* Rewrite sending the packets to the features enabled on their Tx port */
+static uint16_t
+ip4_rewrite_node_process_feature(struct rte_graph *graph, struct rte_node *node,
+				 void **objs, uint16_t nb_objs,
+				 const struct rte_graph_feature_arc_fp *fp)
+{
+	struct ip4_rewrite_nh_header *nh = ip4_rewrite_nm->nh;
+	const int dyn = IP4_REWRITE_NODE_PRIV1_OFF(node->ctx);
+	struct ip4_rewrite_nh_header *nh0;
+	struct rte_ipv4_hdr *ip0;
+	struct rte_mbuf *mbuf0;
+	rte_edge_t next0;
+	uint16_t chksum;
+	void *d0;
+	int i;
+
+	for (i = 0; i < nb_objs; i++) {
+		mbuf0 = (struct rte_mbuf *)objs[i];
+		nh0 = &nh[node_mbuf_priv1(mbuf0, dyn)->nh];
+
+		d0 = rte_pktmbuf_mtod(mbuf0, void *);
+		rte_memcpy(d0, nh0->rewrite_data, nh0->rewrite_len);
+
+		ip0 = (struct rte_ipv4_hdr *)((uint8_t *)d0 +
+					      sizeof(struct rte_ether_hdr));
+		chksum = node_mbuf_priv1(mbuf0, dyn)->cksum +
+			 rte_cpu_to_be_16(0x0100);
+		chksum += chksum >= 0xffff;
+		ip0->hdr_checksum = chksum;
+		ip0->time_to_live = node_mbuf_priv1(mbuf0, dyn)->ttl - 1;
+
+		next0 = nh0->tx_node;
+		if (rte_graph_feature_arc_first(fp, nh0->port, &next0)) {
+			/* Features get the Tx port from the mbuf */
+			mbuf0->port = nh0->port;
+		}
+
+		rte_node_enqueue_x1(graph, node, next0, mbuf0);
+	}
+
+	return nb_objs;
+}
+
 static uint16_t
 ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 			 void **objs, uint16_t nb_objs)
@@ -37,6 +86,7 @@ ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 	struct rte_mbuf *mbuf0, *mbuf1, *mbuf2, *mbuf3, **pkts;
 	struct ip4_rewrite_nh_header *nh = ip4_rewrite_nm->nh;
 	const int dyn = IP4_REWRITE_NODE_PRIV1_OFF(node->ctx);
+	const struct rte_graph_feature_arc_fp *fp;
 	uint16_t next0, next1, next2, next3, next_index;
 	struct rte_ipv4_hdr *ip0, *ip1, *ip2, *ip3;
 	uint16_t n_left_from, held = 0, last_spec = 0;
@@ -46,6 +96,10 @@ ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 	rte_xmm_t priv23;
 	int i;
 
+	fp = rte_graph_feature_arc_active_get(IP4_REWRITE_NODE_ARC(node->ctx));
+	if (unlikely(fp != NULL))
+		return ip4_rewrite_node_process_feature(graph, node, objs, nb_objs, fp);
+
 	/* Speculative next as last next */
 	next_index = IP4_REWRITE_NODE_LAST_NEXT(node->ctx);
 	rte_prefetch0(nh);
@@ -271,6 +325,8 @@ ip4_rewrite_node_init(const struct rte_graph *graph, struct rte_node *node)
 		init_once = true;
 	}
 	IP4_REWRITE_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+	IP4_REWRITE_NODE_ARC(node->ctx) =
+		rte_graph_feature_arc_lookup(RTE_NODE_IP4_OUTPUT_FEATURE_ARC);
 
 	node_dbg("ip4_rewrite", "Initialized ip4_rewrite node initialized");
 
@@ -322,6 +378,7 @@ rte_node_ip4_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 	memcpy(nh->rewrite_data, rewrite_data, rewrite_len);
 	nh->tx_node = ip4_rewrite_nm->next_index[dst_port];
 	nh->rewrite_len = rewrite_len;
+	nh->port = dst_port;
 	nh->enabled = true;
 
 	return 0;
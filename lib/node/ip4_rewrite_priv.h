@@ -19,7 +19,7 @@ struct ip4_rewrite_nh_header {
 	uint16_t rewrite_len; /**< Header rewrite length. */
 	uint16_t tx_node;     /**< Tx node next index identifier. */
 	uint16_t enabled;     /**< NH enable flag */
-	uint16_t rsvd;
+	uint16_t port;        /**< Tx port identifier. */
 	union {
 		struct {
 			struct rte_ether_addr dst;
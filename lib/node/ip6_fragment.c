@@ -0,0 +1,198 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
+#include <rte_graph_worker.h>
+#include <rte_ip6.h>
+#include <rte_ip_frag.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "node_private.h"
+
+/* Edge of the node to the packet drop node, the others are the features */
+#define IP6_FRAGMENT_NEXT_PKT_DROP 0
+/* Maximum number of fragments of a packet */
+#define IP6_FRAGMENT_MAX_FRAGS 16
+/* Number of mbufs prefetched when freeing the death row */
+#define IP6_FRAGMENT_FREE_PREFETCH 4
+
+struct ip6_fragment_pools {
+	struct rte_mempool *direct;
+	struct rte_mempool *indirect;
+};
+
+/* IP6 fragment global data struct */
+static struct ip6_fragment_node_main {
+	struct rte_graph_feature_arc *arc;
+	struct ip6_fragment_pools pools[RTE_MAX_NUMA_NODES];
+} ip6_fragment_nm;
+
+struct ip6_fragment_node_ctx {
+	/* Pools of the graph socket, NULL if the node is not a feature */
+	const struct ip6_fragment_pools *pools;
+	/* Position in the ip6_output arc */
+	rte_graph_feature_t feature;
+};
+
+/* Give the Ethernet header of the original packet to its fragments */
+static __rte_always_inline bool
+ip6_fragment_l2_restore(struct rte_mbuf *frag, const struct rte_ether_hdr *eh,
+			uint16_t port)
+{
+	struct rte_ether_hdr *feh;
+
+	feh = (struct rte_ether_hdr *)rte_pktmbuf_prepend(frag, sizeof(*feh));
+	if (unlikely(feh == NULL))
+		return false;
+
+	rte_ether_addr_copy(&eh->dst_addr, &feh->dst_addr);
+	rte_ether_addr_copy(&eh->src_addr, &feh->src_addr);
+	feh->ether_type = eh->ether_type;
+
+	frag->l2_len = sizeof(*feh);
+	frag->port = port;
+
+	return true;
+}
+
+static uint16_t
+ip6_fragment_node_process(struct rte_graph *graph, struct rte_node *node,
+			  void **objs, uint16_t nb_objs)
+{
+	struct ip6_fragment_node_ctx *ctx = (struct ip6_fragment_node_ctx *)node->ctx;
+	struct rte_mbuf *frags[IP6_FRAGMENT_MAX_FRAGS];
+	const struct rte_graph_feature_arc_fp *fp;
+	struct rte_ip_frag_death_row dr;
+	struct rte_ether_hdr eh;
+	struct rte_mbuf *mbuf;
+	int32_t nb_frags, j;
+	rte_edge_t next;
+	uint16_t mtu, i;
+
+	if (unlikely(ctx->pools == NULL)) {
+		rte_node_enqueue(graph, node, IP6_FRAGMENT_NEXT_PKT_DROP, objs, nb_objs);
+		return nb_objs;
+	}
+
+	fp = rte_graph_feature_arc_fp_get(ip6_fragment_nm.arc);
+	dr.cnt = 0;
+
+	for (i = 0; i < nb_objs; i++) {
+		mbuf = (struct rte_mbuf *)objs[i];
+
+		/* MTU of the Tx port given when enabling the feature, 0 if none */
+		mtu = rte_graph_feature_data_get(fp, mbuf->port, ctx->feature);
+		next = rte_graph_feature_arc_next(fp, mbuf->port, ctx->feature);
+		if (likely(mtu == 0 ||
+			   mbuf->pkt_len <= mtu + sizeof(struct rte_ether_hdr))) {
+			rte_node_enqueue_x1(graph, node, next, mbuf);
+			continue;
+		}
+
+		/* Fragmentation expects the packet to start with the IP header */
+		rte_memcpy(&eh, rte_pktmbuf_mtod(mbuf, void *), sizeof(eh));
+		rte_pktmbuf_adj(mbuf, sizeof(eh));
+		nb_frags = rte_ipv6_fragment_packet(mbuf, frags, RTE_DIM(frags), mtu,
+						    ctx->pools->direct,
+						    ctx->pools->indirect);
+		if (unlikely(nb_frags < 0)) {
+			/* Too many fragments, or no more buffers */
+			NODE_INCREMENT_XSTAT_ID(node, 0, 1, 1);
+			rte_node_enqueue_x1(graph, node, IP6_FRAGMENT_NEXT_PKT_DROP, mbuf);
+			continue;
+		}
+
+		for (j = 0; j < nb_frags; j++) {
+			if (likely(ip6_fragment_l2_restore(frags[j], &eh, mbuf->port)))
+				rte_node_enqueue_x1(graph, node, next, frags[j]);
+			else
+				rte_node_enqueue_x1(graph, node, IP6_FRAGMENT_NEXT_PKT_DROP,
+						    frags[j]);
+		}
+
+		/* Fragments hold references on the packet, release it in batch */
+		dr.row[dr.cnt++] = mbuf;
+		if (unlikely(dr.cnt == RTE_DIM(dr.row)))
+			rte_ip_frag_free_death_row(&dr, IP6_FRAGMENT_FREE_PREFETCH);
+	}
+
+	if (dr.cnt != 0)
+		rte_ip_frag_free_death_row(&dr, IP6_FRAGMENT_FREE_PREFETCH);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip6_fragment_configure(struct rte_node_ip6_fragment_cfg *cfg, uint16_t cnt)
+{
+	struct ip6_fragment_pools *pools;
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		if (cfg[i].socket_id < 0 || cfg[i].socket_id >= RTE_MAX_NUMA_NODES ||
+		    cfg[i].direct_pool == NULL || cfg[i].indirect_pool == NULL)
+			return -EINVAL;
+
+		pools = &ip6_fragment_nm.pools[cfg[i].socket_id];
+		pools->direct = cfg[i].direct_pool;
+		pools->indirect = cfg[i].indirect_pool;
+	}
+
+	return 0;
+}
+
+static int
+ip6_fragment_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ip6_fragment_node_ctx *ctx = (struct ip6_fragment_node_ctx *)node->ctx;
+	int pos;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ip6_fragment_node_ctx) > RTE_NODE_CTX_SZ);
+
+	ctx->pools = NULL;
+	ip6_fragment_nm.arc = rte_graph_feature_arc_lookup(RTE_NODE_IP6_OUTPUT_FEATURE_ARC);
+	if (ip6_fragment_nm.arc == NULL)
+		return 0;
+	pos = rte_graph_feature_lookup(ip6_fragment_nm.arc, node->name);
+	if (pos < 0)
+		return 0;
+
+	if (graph->socket < 0 || graph->socket >= RTE_MAX_NUMA_NODES ||
+	    ip6_fragment_nm.pools[graph->socket].direct == NULL) {
+		node_err("ip6_fragment", "No fragment pools for socket %d", graph->socket);
+		return -EINVAL;
+	}
+
+	ctx->pools = &ip6_fragment_nm.pools[graph->socket];
+	ctx->feature = pos;
+
+	return 0;
+}
+
+static struct rte_node_xstats ip6_fragment_xstats = {
+	.nb_xstats = 1,
+	.xstat_desc = {
+		[0] = "ip6_fragment_error",
+	},
+};
+
+static struct rte_node_register ip6_fragment_node = {
+	.process = ip6_fragment_node_process,
+	.name = "ip6_fragment",
+
+	.init = ip6_fragment_node_init,
+	.xstats = &ip6_fragment_xstats,
+
+	/* Edges to the features are added with the node to the arc */
+	.nb_edges = IP6_FRAGMENT_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[IP6_FRAGMENT_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip6_fragment_node);
@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <stdlib.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip6.h>
+#include <rte_ip_frag.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "ip6_reassembly_priv.h"
+#include "node_private.h"
+
+struct ip6_reassembly_elem {
+	struct ip6_reassembly_elem *next;
+	struct ip6_reassembly_ctx ctx;
+	rte_node_t node_id;
+};
+
+/* IP6 reassembly global data struct */
+struct ip6_reassembly_node_main {
+	struct ip6_reassembly_elem *head;
+};
+
+typedef struct ip6_reassembly_ctx ip6_reassembly_ctx_t;
+typedef struct ip6_reassembly_elem ip6_reassembly_elem_t;
+
+static struct ip6_reassembly_node_main ip6_reassembly_main;
+
+static __rte_always_inline struct rte_mbuf *
+ip6_reassembly_one(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+		   struct rte_mbuf *mbuf, uint64_t tms)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+
+	ipv6_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv6_hdr *,
+					   sizeof(struct rte_ether_hdr));
+	frag_hdr = rte_ipv6_frag_get_ipv6_fragment_header(ipv6_hdr);
+	if (frag_hdr == NULL)
+		return mbuf;
+
+	/* prepare mbuf: setup l2_len/l3_len. */
+	mbuf->l2_len = sizeof(struct rte_ether_hdr);
+	mbuf->l3_len = sizeof(struct rte_ipv6_hdr) + sizeof(*frag_hdr);
+
+	return rte_ipv6_frag_reassemble_packet(tbl, dr, mbuf, tms, ipv6_hdr, frag_hdr);
+}
+
+static uint16_t
+ip6_reassembly_node_process(struct rte_graph *graph, struct rte_node *node, void **objs,
+			    uint16_t nb_objs)
+{
+#define PREFETCH_OFFSET 4
+	struct rte_ip_frag_death_row *dr;
+	struct ip6_reassembly_ctx *ctx;
+	struct rte_ip_frag_tbl *tbl;
+	void **to_next, **to_free;
+	struct rte_mbuf *mbuf_out;
+	uint16_t idx = 0;
+	uint64_t tms;
+	int i;
+
+	ctx = (struct ip6_reassembly_ctx *)node->ctx;
+
+	/* Get graph specific reassembly tbl */
+	tbl = ctx->tbl;
+	dr = ctx->dr;
+	tms = rte_rdtsc();
+
+	for (i = 0; i < PREFETCH_OFFSET && i < nb_objs; i++) {
+		rte_prefetch0(rte_pktmbuf_mtod_offset((struct rte_mbuf *)objs[i], void *,
+						      sizeof(struct rte_ether_hdr)));
+	}
+
+	to_next = node->objs;
+	for (i = 0; i < nb_objs; i++) {
+		if (likely(i + PREFETCH_OFFSET < nb_objs))
+			rte_prefetch0(rte_pktmbuf_mtod_offset(
+				(struct rte_mbuf *)objs[i + PREFETCH_OFFSET], void *,
+				sizeof(struct rte_ether_hdr)));
+
+		mbuf_out = ip6_reassembly_one(tbl, dr, (struct rte_mbuf *)objs[i], tms);
+		if (mbuf_out)
+			to_next[idx++] = (void *)mbuf_out;
+	}
+	node->idx = idx;
+	rte_node_next_stream_move(graph, node, 1);
+
+	/* Free the fragments of the failed reassemblies in one batch */
+	if (dr->cnt) {
+		to_free = rte_node_next_stream_get(graph, node,
+						   RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP, dr->cnt);
+		rte_memcpy(to_free, dr->row, dr->cnt * sizeof(to_free[0]));
+		rte_node_next_stream_put(graph, node, RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP,
+					 dr->cnt);
+		idx += dr->cnt;
+		NODE_INCREMENT_XSTAT_ID(node, 0, dr->cnt, dr->cnt);
+		dr->cnt = 0;
+	}
+
+	return idx;
+}
+
+int
+rte_node_ip6_reassembly_configure(struct rte_node_ip6_reassembly_cfg *cfg, uint16_t cnt)
+{
+	ip6_reassembly_elem_t *elem;
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		elem = malloc(sizeof(ip6_reassembly_elem_t));
+		if (elem == NULL)
+			return -ENOMEM;
+		elem->ctx.dr = cfg[i].dr;
+		elem->ctx.tbl = cfg[i].tbl;
+		elem->node_id = cfg[i].node_id;
+		elem->next = ip6_reassembly_main.head;
+		ip6_reassembly_main.head = elem;
+	}
+
+	return 0;
+}
+
+static int
+ip6_reassembly_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	ip6_reassembly_ctx_t *ctx = (ip6_reassembly_ctx_t *)node->ctx;
+	ip6_reassembly_elem_t *elem = ip6_reassembly_main.head;
+
+	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(ip6_reassembly_ctx_t) > RTE_NODE_CTX_SZ);
+
+	while (elem) {
+		if (elem->node_id == node->id) {
+			/* Update node specific context */
+			memcpy(ctx, &elem->ctx, sizeof(ip6_reassembly_ctx_t));
+			return 0;
+		}
+		elem = elem->next;
+	}
+
+	node_err("ip6_reassembly", "No fragmentation table for node %s", node->name);
+	return -EINVAL;
+}
+
+static struct rte_node_xstats ip6_reassembly_xstats = {
+	.nb_xstats = 1,
+	.xstat_desc = {
+		[0] = "ip6_reassembly_error",
+	},
+};
+
+static struct rte_node_register ip6_reassembly_node = {
+	.process = ip6_reassembly_node_process,
+	.name = "ip6_reassembly",
+
+	.init = ip6_reassembly_node_init,
+	.xstats = &ip6_reassembly_xstats,
+
+	.nb_edges = RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip6_reassembly_node);
@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef __INCLUDE_IP6_REASSEMBLY_PRIV_H__
+#define __INCLUDE_IP6_REASSEMBLY_PRIV_H__
+
+/**
+ * @internal
+ *
+ * Ip6_reassembly context structure.
+ */
+struct ip6_reassembly_ctx {
+	struct rte_ip_frag_tbl *tbl;
+	struct rte_ip_frag_death_row *dr;
+};
+
+#endif /* __INCLUDE_IP6_REASSEMBLY_PRIV_H__ */
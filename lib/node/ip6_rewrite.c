@@ -5,6 +5,7 @@
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
 #include <rte_graph_worker.h>
 #include <rte_ip.h>
 #include <rte_malloc.h>
@@ -20,6 +21,8 @@ struct ip6_rewrite_node_ctx {
 	int mbuf_priv1_off;
 	/* Cached next index */
 	uint16_t next_index;
+	/* Features between rewrite and Tx */
+	struct rte_graph_feature_arc *arc;
 };
 
 static struct ip6_rewrite_node_main *ip6_rewrite_nm;
@@ -30,6 +33,47 @@ static struct ip6_rewrite_node_main *ip6_rewrite_nm;
 #define IP6_REWRITE_NODE_PRIV1_OFF(ctx) \
 	(((struct ip6_rewrite_node_ctx *)ctx)->mbuf_priv1_off)
 
+#define IP6_REWRITE_NODE_ARC(ctx) \
+	(((struct ip6_rewrite_node_ctx *)ctx)->arc)
+
+/* Rewrite sending the packets to the features enabled on their Tx port */
+static uint16_t
+ip6_rewrite_node_process_feature(struct rte_graph *graph, struct rte_node *node,
+				 void **objs, uint16_t nb_objs,
+				 const struct rte_graph_feature_arc_fp *fp)
+{
+	struct ip6_rewrite_nh_header *nh = ip6_rewrite_nm->nh;
+	const int dyn = IP6_REWRITE_NODE_PRIV1_OFF(node->ctx);
+	struct ip6_rewrite_nh_header *nh0;
+	struct rte_ipv6_hdr *ip0;
+	struct rte_mbuf *mbuf0;
+	rte_edge_t next0;
+	void *d0;
+	int i;
+
+	for (i = 0; i < nb_objs; i++) {
+		mbuf0 = (struct rte_mbuf *)objs[i];
+		nh0 = &nh[node_mbuf_priv1(mbuf0, dyn)->nh];
+
+		d0 = rte_pktmbuf_mtod(mbuf0, void *);
+		rte_memcpy(d0, nh0->rewrite_data, nh0->rewrite_len);
+
+		ip0 = (struct rte_ipv6_hdr *)((uint8_t *)d0 +
+					      sizeof(struct rte_ether_hdr));
+		ip0->hop_limits = node_mbuf_priv1(mbuf0, dyn)->ttl - 1;
+
+		next0 = nh0->tx_node;
+		if (rte_graph_feature_arc_first(fp, nh0->port, &next0)) {
+			/* Features get the Tx port from the mbuf */
+			mbuf0->port = nh0->port;
+		}
+
+		rte_node_enqueue_x1(graph, node, next0, mbuf0);
+	}
+
+	return nb_objs;
+}
+
 static uint16_t
 ip6_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 			 void **objs, uint16_t nb_objs)
@@ -37,6 +81,7 @@ ip6_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 	struct rte_mbuf *mbuf0, *mbuf1, *mbuf2, *mbuf3, **pkts;
 	struct ip6_rewrite_nh_header *nh = ip6_rewrite_nm->nh;
 	const int dyn = IP6_REWRITE_NODE_PRIV1_OFF(node->ctx);
+	const struct rte_graph_feature_arc_fp *fp;
 	uint16_t next0, next1, next2, next3, next_index;
 	uint16_t n_left_from, held = 0, last_spec = 0;
 	struct rte_ipv6_hdr *ip0, *ip1, *ip2, *ip3;
@@ -46,6 +91,10 @@ ip6_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 	rte_xmm_t priv23;
 	int i;
 
+	fp = rte_graph_feature_arc_active_get(IP6_REWRITE_NODE_ARC(node->ctx));
+	if (unlikely(fp != NULL))
+		return ip6_rewrite_node_process_feature(graph, node, objs, nb_objs, fp);
+
 	/* Speculative next as last next */
 	next_index = IP6_REWRITE_NODE_LAST_NEXT(node->ctx);
 	rte_prefetch0(nh);
@@ -255,6 +304,8 @@ ip6_rewrite_node_init(const struct rte_graph *graph, struct rte_node *node)
 		init_once = true;
 	}
 	IP6_REWRITE_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+	IP6_REWRITE_NODE_ARC(node->ctx) =
+		rte_graph_feature_arc_lookup(RTE_NODE_IP6_OUTPUT_FEATURE_ARC);
 
 	node_dbg("ip6_rewrite", "Initialized ip6_rewrite node");
 
@@ -307,6 +358,7 @@ rte_node_ip6_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 	nh->tx_node = ip6_rewrite_nm->next_index[dst_port];
 	nh->rewrite_len = rewrite_len;
 	nh->enabled = true;
+	nh->port = dst_port;
 
 	return 0;
 }
@@ -0,0 +1,174 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <string.h>
+
+#include <rte_byteorder.h>
+#include <rte_cryptodev.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ipsec.h>
+#include <rte_ipsec_group.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ipsec_api.h"
+
+#include "ipsec_priv.h"
+#include "node_private.h"
+
+struct ipsec_crypto_poll_node_ctx {
+	uint16_t qp_id;
+	uint8_t dev_id;
+};
+
+/*
+ * Decrypted tunnel packets start with the inner IP header, give them
+ * an Ethernet header for the classification.
+ */
+static __rte_always_inline bool
+ipsec_crypto_poll_inbound_fixup(struct rte_mbuf *mbuf, bool tunnel)
+{
+	struct rte_ether_hdr *eh;
+	bool ip4;
+
+	if (!tunnel)
+		return true;
+
+	ip4 = (*rte_pktmbuf_mtod(mbuf, uint8_t *) >> 4) == 4;
+	eh = (struct rte_ether_hdr *)rte_pktmbuf_prepend(mbuf, sizeof(*eh));
+	if (unlikely(eh == NULL))
+		return false;
+
+	memset(eh, 0, 2 * sizeof(struct rte_ether_addr));
+	eh->ether_type = rte_cpu_to_be_16(ip4 ? RTE_ETHER_TYPE_IPV4 :
+					  RTE_ETHER_TYPE_IPV6);
+	mbuf->l2_len = sizeof(*eh);
+	mbuf->packet_type = RTE_PTYPE_L2_ETHER |
+			    (ip4 ? RTE_PTYPE_L3_IPV4 : RTE_PTYPE_L3_IPV6);
+
+	return true;
+}
+
+static uint16_t
+ipsec_crypto_poll_node_process(struct rte_graph *graph, struct rte_node *node,
+			       void **objs, uint16_t cnt)
+{
+	struct ipsec_crypto_poll_node_ctx *ctx =
+		(struct ipsec_crypto_poll_node_ctx *)node->ctx;
+	const uint64_t done_flag = node_ipsec_main.done_flag;
+	struct rte_ipsec_group grp[RTE_GRAPH_BURST_SIZE];
+	struct rte_crypto_op *cop[RTE_GRAPH_BURST_SIZE];
+	struct rte_mbuf *pkts[RTE_GRAPH_BURST_SIZE];
+	struct rte_ipsec_session *ss;
+	uint16_t nb_ops, nb_grp, i, j;
+	uint32_t nb_grouped, k;
+	struct rte_mbuf *mbuf;
+	rte_edge_t next;
+	uint64_t type;
+	bool tunnel;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(cnt);
+
+	nb_ops = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id, cop,
+					     RTE_GRAPH_BURST_SIZE);
+	if (nb_ops == 0)
+		return 0;
+
+	/* Packets with an unknown session are moved after the groups */
+	nb_grp = rte_ipsec_pkt_crypto_group(
+			(const struct rte_crypto_op **)(uintptr_t)cop,
+			pkts, grp, nb_ops);
+	if (unlikely(nb_grp == 0)) {
+		/* Packets are not copied when no operation has a session */
+		for (i = 0; i < nb_ops; i++)
+			pkts[i] = cop[i]->sym->m_src;
+	}
+	rte_mempool_put_bulk(node_ipsec_main.cop_pool, (void **)cop, nb_ops);
+
+	nb_grouped = 0;
+	for (i = 0; i < nb_grp; i++) {
+		ss = grp[i].id.ptr;
+		nb_grouped += grp[i].cnt;
+
+		/* Failed packets are moved after the processed ones */
+		k = rte_ipsec_pkt_process(ss, grp[i].m, grp[i].cnt);
+
+		/* The ESP nodes pass the processed packets to the next feature */
+		for (j = 0; j < k; j++) {
+			mbuf = grp[i].m[j];
+			mbuf->ol_flags &= ~RTE_MBUF_F_RX_SEC_OFFLOAD;
+			mbuf->ol_flags |= done_flag;
+		}
+
+		type = rte_ipsec_sa_type(ss->sa);
+		if ((type & RTE_IPSEC_SATP_DIR_MASK) == RTE_IPSEC_SATP_DIR_IB) {
+			tunnel = (type & RTE_IPSEC_SATP_MODE_MASK) !=
+				 RTE_IPSEC_SATP_MODE_TRANS;
+			for (j = 0; j < k; j++) {
+				mbuf = grp[i].m[j];
+				next = ipsec_crypto_poll_inbound_fixup(mbuf, tunnel) ?
+				       RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_ESP_INBOUND :
+				       RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_PKT_DROP;
+				rte_node_enqueue_x1(graph, node, next, mbuf);
+			}
+		} else {
+			rte_node_enqueue(graph, node,
+					 RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_ESP_OUTBOUND,
+					 (void **)grp[i].m, k);
+		}
+
+		if (k != grp[i].cnt)
+			rte_node_enqueue(graph, node, RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_PKT_DROP,
+					 (void **)&grp[i].m[k], grp[i].cnt - k);
+	}
+
+	if (nb_grouped != nb_ops)
+		rte_node_enqueue(graph, node, RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_PKT_DROP,
+				 (void **)&pkts[nb_grouped], nb_ops - nb_grouped);
+
+	return nb_ops;
+}
+
+static int
+ipsec_crypto_poll_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ipsec_crypto_poll_node_ctx *ctx =
+		(struct ipsec_crypto_poll_node_ctx *)node->ctx;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ipsec_crypto_poll_node_ctx) > RTE_NODE_CTX_SZ);
+
+	if (node_ipsec_main.cop_pool == NULL) {
+		node_err("ipsec_crypto_poll", "IPsec nodes not configured");
+		return -EINVAL;
+	}
+
+	/* Each graph polls its own queue pair */
+	if (graph->id >= node_ipsec_main.nb_qps) {
+		node_err("ipsec_crypto_poll", "No crypto queue pair for graph %s",
+			 graph->name);
+		return -ENOSPC;
+	}
+
+	ctx->qp_id = graph->id;
+	ctx->dev_id = node_ipsec_main.cdev_id;
+
+	return 0;
+}
+
+static struct rte_node_register ipsec_crypto_poll_node = {
+	.process = ipsec_crypto_poll_node_process,
+	.flags = RTE_NODE_SOURCE_F,
+	.name = "ipsec_crypto_poll",
+
+	.init = ipsec_crypto_poll_node_init,
+
+	.nb_edges = RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_PKT_DROP] = "pkt_drop",
+		[RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_ESP_INBOUND] = "esp_inbound",
+		[RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_ESP_OUTBOUND] = "esp_outbound",
+	},
+};
+
+RTE_NODE_REGISTER(ipsec_crypto_poll_node);
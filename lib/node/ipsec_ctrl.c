@@ -0,0 +1,176 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+
+#include <rte_cryptodev.h>
+#include <rte_errno.h>
+#include <rte_ipsec.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_rcu_qsbr.h>
+
+#include "rte_node_ipsec_api.h"
+
+#include "ipsec_priv.h"
+#include "node_private.h"
+
+#define IPSEC_COP_CACHE_SIZE 256
+
+struct node_ipsec_main node_ipsec_main;
+
+static const struct rte_mbuf_dynflag node_ipsec_done_dynflag_desc = {
+	.name = "rte_node_dynflag_ipsec_done",
+};
+
+int
+node_ipsec_ctx_init(const struct rte_graph *graph, struct rte_node *node,
+		    const char *arc_name)
+{
+	struct node_ipsec_ctx *ctx = (struct node_ipsec_ctx *)node->ctx;
+	struct rte_graph_feature_arc *arc;
+	int pos;
+
+	RTE_BUILD_BUG_ON(sizeof(struct node_ipsec_ctx) > RTE_NODE_CTX_SZ);
+
+	ctx->arc = NULL;
+	arc = rte_graph_feature_arc_lookup(arc_name);
+	if (arc == NULL)
+		return 0;
+	pos = rte_graph_feature_lookup(arc, node->name);
+	if (pos < 0)
+		return 0;
+
+	if (node_ipsec_main.cop_pool == NULL) {
+		node_err(node->name, "IPsec nodes not configured");
+		return -EINVAL;
+	}
+	if (graph->id >= node_ipsec_main.nb_qps) {
+		node_err(node->name, "No crypto queue pair for graph %s",
+			 graph->name);
+		return -ENOSPC;
+	}
+
+	ctx->arc = arc;
+	ctx->qp_id = graph->id;
+	ctx->dev_id = node_ipsec_main.cdev_id;
+	ctx->feature = pos;
+
+	return 0;
+}
+
+int
+rte_node_ipsec_config(const struct rte_node_ipsec_conf *conf)
+{
+	struct node_ipsec_main *im = &node_ipsec_main;
+	uint16_t nb_qps;
+	int bit;
+
+	if (conf == NULL || conf->nb_ops == 0)
+		return -EINVAL;
+
+	if (im->cop_pool != NULL)
+		return -EBUSY;
+
+	if (!rte_cryptodev_is_valid_dev(conf->cdev_id))
+		return -ENODEV;
+
+	nb_qps = rte_cryptodev_queue_pair_count(conf->cdev_id);
+	if (nb_qps == 0)
+		return -EINVAL;
+
+	bit = rte_mbuf_dynflag_register(&node_ipsec_done_dynflag_desc);
+	if (bit < 0)
+		return -rte_errno;
+
+	/* Private data of the operations holds the IV */
+	im->cop_pool = rte_crypto_op_pool_create("node_ipsec_cop",
+			RTE_CRYPTO_OP_TYPE_SYMMETRIC, conf->nb_ops,
+			IPSEC_COP_CACHE_SIZE, RTE_NODE_IPSEC_IV_SIZE,
+			conf->socket_id);
+	if (im->cop_pool == NULL)
+		return -rte_errno;
+
+	im->done_flag = RTE_BIT64(bit);
+	im->nb_qps = nb_qps;
+	im->cdev_id = conf->cdev_id;
+
+	return 0;
+}
+
+/*
+ * Get the table entry of an SA. Inbound SAs are hashed by SPI, so SPIs
+ * may share an entry. Outbound SAs are indexed by the feature user data.
+ */
+static struct node_ipsec_sa *
+ipsec_sa_entry(struct rte_ipsec_session *ss, uint32_t id)
+{
+	struct node_ipsec_main *im = &node_ipsec_main;
+	uint64_t type;
+
+	type = rte_ipsec_sa_type(ss->sa);
+	if ((type & RTE_IPSEC_SATP_DIR_MASK) == RTE_IPSEC_SATP_DIR_IB)
+		return &im->in_sa[id % RTE_NODE_IPSEC_MAX_SA];
+
+	if (id >= RTE_NODE_IPSEC_MAX_SA)
+		return NULL;
+	return &im->out_sa[id];
+}
+
+int
+rte_node_ipsec_sa_add(uint32_t id, struct rte_ipsec_session *ss)
+{
+	struct node_ipsec_main *im = &node_ipsec_main;
+	struct rte_ipsec_session *cur;
+	struct node_ipsec_sa *sa;
+
+	if (ss == NULL || ss->sa == NULL)
+		return -EINVAL;
+
+	if (im->cop_pool == NULL)
+		return -EINVAL;
+
+	/* Only lookaside processing with the configured crypto device */
+	if (ss->type != RTE_SECURITY_ACTION_TYPE_NONE ||
+	    ss->crypto.dev_id != im->cdev_id)
+		return -ENOTSUP;
+
+	sa = ipsec_sa_entry(ss, id);
+	if (sa == NULL)
+		return -EINVAL;
+
+	/* Another SPI may use the entry */
+	cur = rte_atomic_load_explicit(&sa->ss, rte_memory_order_relaxed);
+	if (cur != NULL)
+		return sa->id == id ? -EEXIST : -ENOSPC;
+
+	/* ipsec_crypto_poll gets the session from the crypto operations */
+	rte_cryptodev_sym_session_opaque_data_set(ss->crypto.ses, (uintptr_t)ss);
+
+	sa->id = id;
+	rte_atomic_store_explicit(&sa->ss, ss, rte_memory_order_release);
+
+	return 0;
+}
+
+int
+rte_node_ipsec_sa_del(uint32_t id, struct rte_ipsec_session *ss,
+		      struct rte_rcu_qsbr *qsbr)
+{
+	struct node_ipsec_sa *sa;
+
+	if (ss == NULL || ss->sa == NULL)
+		return -EINVAL;
+
+	sa = ipsec_sa_entry(ss, id);
+	if (sa == NULL)
+		return -EINVAL;
+
+	if (rte_atomic_load_explicit(&sa->ss, rte_memory_order_relaxed) != ss ||
+	    sa->id != id)
+		return -ENOENT;
+
+	rte_atomic_store_explicit(&sa->ss, NULL, rte_memory_order_release);
+	if (qsbr != NULL)
+		rte_rcu_qsbr_synchronize(qsbr, RTE_QSBR_THRID_INVALID);
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef __INCLUDE_IPSEC_PRIV_H__
+#define __INCLUDE_IPSEC_PRIV_H__
+
+#include <rte_common.h>
+#include <rte_cryptodev.h>
+#include <rte_graph.h>
+#include <rte_graph_feature_arc.h>
+#include <rte_graph_worker.h>
+#include <rte_ipsec.h>
+#include <rte_mbuf.h>
+#include <rte_stdatomic.h>
+
+#include "rte_node_ipsec_api.h"
+
+/* Edge of the ESP nodes to the packet drop node */
+#define IPSEC_NODE_NEXT_PKT_DROP 0
+
+/**
+ * @internal
+ *
+ * SA table entry.
+ */
+struct node_ipsec_sa {
+	uint32_t id; /**< SPI of inbound SA, feature user data of outbound SA. */
+	RTE_ATOMIC(struct rte_ipsec_session *) ss; /**< Session, NULL if free. */
+};
+
+/**
+ * @internal
+ *
+ * IPsec nodes main data.
+ */
+struct node_ipsec_main {
+	struct rte_mempool *cop_pool; /**< Crypto operations pool. */
+	uint64_t done_flag;           /**< Mbuf flag of the processed packets. */
+	uint16_t nb_qps;              /**< Number of queue pairs of the device. */
+	uint8_t cdev_id;              /**< Crypto device. */
+	struct node_ipsec_sa in_sa[RTE_NODE_IPSEC_MAX_SA];  /**< By SPI. */
+	struct node_ipsec_sa out_sa[RTE_NODE_IPSEC_MAX_SA]; /**< By user data. */
+};
+
+extern struct node_ipsec_main node_ipsec_main;
+
+/**
+ * @internal
+ *
+ * ESP node context.
+ */
+struct node_ipsec_ctx {
+	struct rte_graph_feature_arc *arc; /**< Arc of the node, NULL if unused. */
+	uint16_t qp_id;                     /**< Queue pair of the graph. */
+	uint8_t dev_id;                     /**< Crypto device. */
+	rte_graph_feature_t feature;        /**< Position in the arc. */
+};
+
+/**
+ * @internal
+ *
+ * Initialize the context of an ESP node from its arc.
+ *
+ * The node is added to the graphs with the ipsec_crypto_poll node, even
+ * when it is not a feature of its arc. It then drops the packets.
+ */
+int node_ipsec_ctx_init(const struct rte_graph *graph, struct rte_node *node,
+			const char *arc_name);
+
+/**
+ * @internal
+ *
+ * Get the session of an SA.
+ *
+ * @param tbl
+ *   SA table of the direction.
+ * @param id
+ *   Id of the SA.
+ *
+ * @return
+ *   Session of the SA, NULL if not found.
+ */
+static __rte_always_inline struct rte_ipsec_session *
+node_ipsec_sa_get(struct node_ipsec_sa *tbl, uint32_t id)
+{
+	struct node_ipsec_sa *sa = &tbl[id % RTE_NODE_IPSEC_MAX_SA];
+	struct rte_ipsec_session *ss;
+
+	ss = rte_atomic_load_explicit(&sa->ss, rte_memory_order_acquire);
+	return likely(ss != NULL && sa->id == id) ? ss : NULL;
+}
+
+/**
+ * @internal
+ *
+ * Prepare the packets of an SA and enqueue them to the crypto device.
+ *
+ * The packets which cannot be enqueued are dropped.
+ *
+ * @param nb_pkts
+ *   Number of packets, at most RTE_GRAPH_BURST_SIZE.
+ */
+static __rte_always_inline void
+node_ipsec_crypto_submit(struct rte_graph *graph, struct rte_node *node,
+			 const struct node_ipsec_ctx *ctx,
+			 const struct rte_ipsec_session *ss,
+			 struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	struct rte_mempool *pool = node_ipsec_main.cop_pool;
+	struct rte_crypto_op *cop[RTE_GRAPH_BURST_SIZE];
+	uint16_t nb_prep, nb_enq;
+
+	if (unlikely(rte_crypto_op_bulk_alloc(pool, RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+					      cop, nb_pkts) == 0)) {
+		rte_node_enqueue(graph, node, IPSEC_NODE_NEXT_PKT_DROP,
+				 (void **)pkts, nb_pkts);
+		return;
+	}
+
+	/* Invalid packets are moved after the prepared ones */
+	nb_prep = rte_ipsec_pkt_crypto_prepare(ss, pkts, cop, nb_pkts);
+	nb_enq = rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id, cop, nb_prep);
+	if (unlikely(nb_enq != nb_pkts)) {
+		rte_mempool_put_bulk(pool, (void **)&cop[nb_enq], nb_pkts - nb_enq);
+		rte_node_enqueue(graph, node, IPSEC_NODE_NEXT_PKT_DROP,
+				 (void **)&pkts[nb_enq], nb_pkts - nb_enq);
+	}
+}
+
+#endif /* __INCLUDE_IPSEC_PRIV_H__ */
@@ -7,38 +7,40 @@
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
 
+#include "rte_node_pkt_cls_api.h"
+
 #include "pkt_cls_priv.h"
 #include "node_private.h"
 
 /* Next node for each ptype, default is '0' is "pkt_drop" */
 static const alignas(RTE_CACHE_LINE_SIZE) uint8_t p_nxt[256] = {
-	[RTE_PTYPE_L3_IPV4] = PKT_CLS_NEXT_IP4_LOOKUP,
+	[RTE_PTYPE_L3_IPV4] = RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP,
 
-	[RTE_PTYPE_L3_IPV4_EXT] = PKT_CLS_NEXT_IP4_LOOKUP,
+	[RTE_PTYPE_L3_IPV4_EXT] = RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP,
 
-	[RTE_PTYPE_L3_IPV4_EXT_UNKNOWN] = PKT_CLS_NEXT_IP4_LOOKUP,
+	[RTE_PTYPE_L3_IPV4_EXT_UNKNOWN] = RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP,
 
 	[RTE_PTYPE_L3_IPV4 | RTE_PTYPE_L2_ETHER] =
-		PKT_CLS_NEXT_IP4_LOOKUP,
+		RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP,
 
 	[RTE_PTYPE_L3_IPV4_EXT | RTE_PTYPE_L2_ETHER] =
-		PKT_CLS_NEXT_IP4_LOOKUP,
+		RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP,
 
 	[RTE_PTYPE_L3_IPV4_EXT_UNKNOWN | RTE_PTYPE_L2_ETHER] =
-		PKT_CLS_NEXT_IP4_LOOKUP,
+		RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP,
 
-	[RTE_PTYPE_L3_IPV6] = PKT_CLS_NEXT_IP6_LOOKUP,
+	[RTE_PTYPE_L3_IPV6] = RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP,
 
-	[RTE_PTYPE_L3_IPV6_EXT] = PKT_CLS_NEXT_IP6_LOOKUP,
+	[RTE_PTYPE_L3_IPV6_EXT] = RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP,
 
-	[RTE_PTYPE_L3_IPV6_EXT_UNKNOWN] = PKT_CLS_NEXT_IP6_LOOKUP,
+	[RTE_PTYPE_L3_IPV6_EXT_UNKNOWN] = RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP,
 
-	[RTE_PTYPE_L3_IPV6 | RTE_PTYPE_L2_ETHER] = PKT_CLS_NEXT_IP6_LOOKUP,
+	[RTE_PTYPE_L3_IPV6 | RTE_PTYPE_L2_ETHER] = RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP,
 
-	[RTE_PTYPE_L3_IPV6_EXT | RTE_PTYPE_L2_ETHER] = PKT_CLS_NEXT_IP6_LOOKUP,
+	[RTE_PTYPE_L3_IPV6_EXT | RTE_PTYPE_L2_ETHER] = RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP,
 
 	[RTE_PTYPE_L3_IPV6_EXT_UNKNOWN | RTE_PTYPE_L2_ETHER] =
-		PKT_CLS_NEXT_IP6_LOOKUP,
+		RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP,
 };
 
 static uint16_t
@@ -226,12 +228,12 @@ struct rte_node_register pkt_cls_node = {
 	.process = pkt_cls_node_process,
 	.name = "pkt_cls",
 
-	.nb_edges = PKT_CLS_NEXT_MAX,
+	.nb_edges = RTE_NODE_PKT_CLS_NEXT_MAX,
 	.next_nodes = {
 		/* Pkt drop node starts at '0' */
-		[PKT_CLS_NEXT_PKT_DROP] = "pkt_drop",
-		[PKT_CLS_NEXT_IP4_LOOKUP] = "ip4_lookup",
-		[PKT_CLS_NEXT_IP6_LOOKUP] = "ip6_lookup",
+		[RTE_NODE_PKT_CLS_NEXT_PKT_DROP] = "pkt_drop",
+		[RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP] = "ip4_lookup",
+		[RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP] = "ip6_lookup",
 	},
 };
 RTE_NODE_REGISTER(pkt_cls_node);
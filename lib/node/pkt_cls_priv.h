@@ -10,11 +10,4 @@ struct pkt_cls_node_ctx {
 	uint16_t l2l3_type;
 };
 
-enum pkt_cls_next_nodes {
-	PKT_CLS_NEXT_PKT_DROP,
-	PKT_CLS_NEXT_IP4_LOOKUP,
-	PKT_CLS_NEXT_IP6_LOOKUP,
-	PKT_CLS_NEXT_MAX,
-};
-
 #endif /* __INCLUDE_PKT_CLS_PRIV_H__ */
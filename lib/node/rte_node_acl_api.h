@@ -0,0 +1,170 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef __INCLUDE_RTE_NODE_ACL_API_H__
+#define __INCLUDE_RTE_NODE_ACL_API_H__
+
+/**
+ * @file rte_node_acl_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to do control path functions of the ip4_acl and ip6_acl
+ * nodes.
+ *
+ * These nodes classify the 5-tuple of the packets of a whole burst with one
+ * rte_acl_classify() call, using the best classify method of the CPU.
+ * The user data of the matching rule, built with RTE_NODE_ACL_USERDATA(),
+ * selects the next node of the packet: the permit edge, the deny edge,
+ * or an edge added by the application with rte_node_edge_update().
+ * The rule values are in host byte order.
+ */
+#include <rte_acl.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_graph.h>
+#include <rte_rcu_qsbr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Rule user data sending the matching packets to the given next edge.
+ */
+#define RTE_NODE_ACL_USERDATA(next) ((uint32_t)(next) + 1)
+
+/**
+ * IP4 ACL next nodes.
+ */
+enum rte_node_ip4_acl_next {
+	RTE_NODE_IP4_ACL_NEXT_PERMIT,
+	/**< Permitted packets, "ip4_lookup" node by default. */
+	RTE_NODE_IP4_ACL_NEXT_DENY,
+	/**< Denied packets, "pkt_drop" node. */
+	RTE_NODE_IP4_ACL_NEXT_MAX,
+	/**< Number of next nodes of ip4_acl node. */
+};
+
+/**
+ * IP4 ACL rule fields.
+ */
+enum rte_node_ip4_acl_field {
+	RTE_NODE_IP4_ACL_FIELD_PROTO,
+	/**< Protocol, bitmask. */
+	RTE_NODE_IP4_ACL_FIELD_SRC,
+	/**< Source address, prefix. */
+	RTE_NODE_IP4_ACL_FIELD_DST,
+	/**< Destination address, prefix. */
+	RTE_NODE_IP4_ACL_FIELD_SRC_PORT,
+	/**< TCP, UDP or SCTP source port, range. */
+	RTE_NODE_IP4_ACL_FIELD_DST_PORT,
+	/**< TCP, UDP or SCTP destination port, range. */
+	RTE_NODE_IP4_ACL_FIELD_NUM,
+	/**< Number of fields of an IP4 ACL rule. */
+};
+
+/** IP4 ACL rule. */
+RTE_ACL_RULE_DEF(rte_node_ip4_acl_rule, RTE_NODE_IP4_ACL_FIELD_NUM);
+
+/**
+ * IP6 ACL next nodes.
+ */
+enum rte_node_ip6_acl_next {
+	RTE_NODE_IP6_ACL_NEXT_PERMIT,
+	/**< Permitted packets, "ip6_lookup" node by default. */
+	RTE_NODE_IP6_ACL_NEXT_DENY,
+	/**< Denied packets, "pkt_drop" node. */
+	RTE_NODE_IP6_ACL_NEXT_MAX,
+	/**< Number of next nodes of ip6_acl node. */
+};
+
+/**
+ * IP6 ACL rule fields.
+ *
+ * The addresses are split in four 32-bit prefix fields,
+ * most significant first.
+ */
+enum rte_node_ip6_acl_field {
+	RTE_NODE_IP6_ACL_FIELD_PROTO,
+	/**< Next header, bitmask. */
+	RTE_NODE_IP6_ACL_FIELD_SRC0,
+	/**< Source address, first 32 bits. */
+	RTE_NODE_IP6_ACL_FIELD_SRC1,
+	RTE_NODE_IP6_ACL_FIELD_SRC2,
+	RTE_NODE_IP6_ACL_FIELD_SRC3,
+	RTE_NODE_IP6_ACL_FIELD_DST0,
+	/**< Destination address, first 32 bits. */
+	RTE_NODE_IP6_ACL_FIELD_DST1,
+	RTE_NODE_IP6_ACL_FIELD_DST2,
+	RTE_NODE_IP6_ACL_FIELD_DST3,
+	RTE_NODE_IP6_ACL_FIELD_SRC_PORT,
+	/**< TCP, UDP or SCTP source port, range. */
+	RTE_NODE_IP6_ACL_FIELD_DST_PORT,
+	/**< TCP, UDP or SCTP destination port, range. */
+	RTE_NODE_IP6_ACL_FIELD_NUM,
+	/**< Number of fields of an IP6 ACL rule. */
+};
+
+/** IP6 ACL rule. */
+RTE_ACL_RULE_DEF(rte_node_ip6_acl_rule, RTE_NODE_IP6_ACL_FIELD_NUM);
+
+/**
+ * Set the rules of the ip4_acl node.
+ *
+ * A new ACL context is built with the rules, then swapped with the one
+ * in use, so that the workers keep classifying the packets while the
+ * rules are updated. The previous context is freed once the workers
+ * reported a quiescent state.
+ *
+ * @param rules
+ *   Array of rules, with category mask 1. The highest priority matching
+ *   rule is applied.
+ * @param nb_rules
+ *   Number of rules, 0 to remove all the rules.
+ * @param default_next
+ *   Next edge of the packets matching no rule.
+ * @param qsbr
+ *   RCU QSBR variable of the workers running the node. When NULL, the
+ *   application must ensure that no worker runs the node during the call.
+ *
+ * @return
+ *   0 on success, -EINVAL if *default_next* or the next edge of a rule
+ *   is not an edge of the node, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_acl_rules_set(const struct rte_node_ip4_acl_rule *rules,
+			       uint32_t nb_rules, rte_edge_t default_next,
+			       struct rte_rcu_qsbr *qsbr);
+
+/**
+ * Set the rules of the ip6_acl node.
+ *
+ * @see rte_node_ip4_acl_rules_set()
+ *
+ * @param rules
+ *   Array of rules, with category mask 1. The highest priority matching
+ *   rule is applied.
+ * @param nb_rules
+ *   Number of rules, 0 to remove all the rules.
+ * @param default_next
+ *   Next edge of the packets matching no rule.
+ * @param qsbr
+ *   RCU QSBR variable of the workers running the node. When NULL, the
+ *   application must ensure that no worker runs the node during the call.
+ *
+ * @return
+ *   0 on success, -EINVAL if *default_next* or the next edge of a rule
+ *   is not an edge of the node, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_acl_rules_set(const struct rte_node_ip6_acl_rule *rules,
+			       uint32_t nb_rules, rte_edge_t default_next,
+			       struct rte_rcu_qsbr *qsbr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_ACL_API_H__ */
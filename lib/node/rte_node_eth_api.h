@@ -25,6 +25,14 @@
 extern "C" {
 #endif
 
+/**
+ * Feature arc from the ethdev_rx nodes to the pkt_cls node.
+ *
+ * Its features receive the packets of an Rx port before classification,
+ * with the Rx port as index. The arc is created by rte_node_eth_config().
+ */
+#define RTE_NODE_ETHDEV_RX_FEATURE_ARC "eth_input"
+
 /**
  * Port config for ethdev_rx and ethdev_tx node.
  */
@@ -44,6 +52,9 @@ struct rte_node_ethdev_config {
 /**
  * Initializes ethdev nodes.
  *
+ * It also creates the feature arcs of the ethdev and ip4 nodes,
+ * the ethdev_tx node of each port being an end node of the ip4_output arc.
+ *
  * @param cfg
  *   Array of ethdev config that identifies which port's
  *   ethdev_rx and ethdev_tx nodes need to be created
@@ -18,12 +18,31 @@
 #include <rte_common.h>
 #include <rte_compat.h>
 
+#include <rte_fib.h>
 #include <rte_graph.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Feature arc from the ip4_lookup and ip4_lookup_fib nodes
+ * to the ip4_rewrite node.
+ *
+ * Its features receive the packets routed to ip4_rewrite,
+ * with the Rx port as index. The arc is created by rte_node_eth_config().
+ */
+#define RTE_NODE_IP4_FORWARD_FEATURE_ARC "ip4_forward"
+
+/**
+ * Feature arc from the ip4_rewrite node to the ethdev_tx node of each port.
+ *
+ * Its features receive the rewritten packets, with the Tx port as index.
+ * ip4_rewrite stores the Tx port in the mbuf port field of the packets
+ * sent to the features. The arc is created by rte_node_eth_config().
+ */
+#define RTE_NODE_IP4_OUTPUT_FEATURE_ARC "ip4_output"
+
 /**
  * IP4 lookup next nodes.
  */
@@ -67,6 +86,19 @@ struct rte_node_ip4_reassembly_cfg {
 	/**< Node identifier to configure. */
 };
 
+/**
+ * IP4 fragmentation configure structure.
+ * @see rte_node_ip4_fragment_configure
+ */
+struct rte_node_ip4_fragment_cfg {
+	struct rte_mempool *direct_pool;
+	/**< Pool of the fragment headers. */
+	struct rte_mempool *indirect_pool;
+	/**< Pool of the fragment data, attached to the original packet. */
+	int socket_id;
+	/**< Socket of the graphs using the pools. */
+};
+
 /**
  * Add ipv4 route to lookup table.
  *
@@ -85,6 +117,44 @@ struct rte_node_ip4_reassembly_cfg {
 int rte_node_ip4_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
 			   enum rte_node_ip4_lookup_next next_node);
 
+/**
+ * Create the FIB of the ip4_lookup_fib node on a socket.
+ *
+ * Must be called before creating the graphs using the ip4_lookup_fib node
+ * on this socket. The default next hop of the configuration is ignored,
+ * addresses without route are sent to the packet drop node.
+ *
+ * @param socket
+ *   NUMA socket of the FIB.
+ * @param conf
+ *   FIB configuration. The next hop size must be at least 4 bytes.
+ *
+ * @return
+ *   0 on success, -EINVAL if the next hop size is too small,
+ *   negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_fib_create(int socket, struct rte_fib_conf *conf);
+
+/**
+ * Add ipv4 route to the FIB of ip4_lookup_fib node.
+ *
+ * @param ip
+ *   IP address of route to be added.
+ * @param depth
+ *   Depth of the rule to be added.
+ * @param next_hop
+ *   Next hop id of the rule result to be added.
+ * @param next_node
+ *   Next node to redirect traffic to.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_fib_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
+			       enum rte_node_ip4_lookup_next next_node);
+
 /**
  * Add a next hop's rewrite data.
  *
@@ -117,6 +187,26 @@ int rte_node_ip4_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 __rte_experimental
 int rte_node_ip4_reassembly_configure(struct rte_node_ip4_reassembly_cfg *cfg, uint16_t cnt);
 
+/**
+ * Add fragmentation node configuration data.
+ *
+ * The ip4_fragment node is a feature of the RTE_NODE_IP4_OUTPUT_FEATURE_ARC
+ * arc, whose user data is the IPv4 MTU of the port. The packets longer than
+ * the MTU are fragmented with the pools of the graph socket, all the packets
+ * pass through when the user data is 0.
+ * Must be called before creating the graphs.
+ *
+ * @param cfg
+ *   Pointer to the configuration structures.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_fragment_configure(struct rte_node_ip4_fragment_cfg *cfg, uint16_t cnt);
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,12 +17,23 @@
  */
 #include <rte_common.h>
 #include <rte_compat.h>
+#include <rte_fib6.h>
+#include <rte_graph.h>
 #include <rte_ip6.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Feature arc from the ip6_rewrite node to the ethdev_tx node of each port.
+ *
+ * Its features receive the rewritten packets, with the Tx port as index.
+ * ip6_rewrite stores the Tx port in the mbuf port field of the packets
+ * sent to the features. The arc is created by rte_node_eth_config().
+ */
+#define RTE_NODE_IP6_OUTPUT_FEATURE_ARC "ip6_output"
+
 /**
  * IP6 lookup next nodes.
  */
@@ -33,6 +44,40 @@ enum rte_node_ip6_lookup_next {
 	/**< Packet drop node. */
 };
 
+/**
+ * IP6 reassembly next nodes.
+ */
+enum rte_node_ip6_reassembly_next {
+	RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * IP6 reassembly configure structure.
+ * @see rte_node_ip6_reassembly_configure
+ */
+struct rte_node_ip6_reassembly_cfg {
+	struct rte_ip_frag_tbl *tbl;
+	/**< Reassembly fragmentation table. */
+	struct rte_ip_frag_death_row *dr;
+	/**< Reassembly deathrow table. */
+	rte_node_t node_id;
+	/**< Node identifier to configure. */
+};
+
+/**
+ * IP6 fragmentation configure structure.
+ * @see rte_node_ip6_fragment_configure
+ */
+struct rte_node_ip6_fragment_cfg {
+	struct rte_mempool *direct_pool;
+	/**< Pool of the fragment headers. */
+	struct rte_mempool *indirect_pool;
+	/**< Pool of the fragment data, attached to the original packet. */
+	int socket_id;
+	/**< Socket of the graphs using the pools. */
+};
+
 /**
  * Add IPv6 route to lookup table.
  *
@@ -52,6 +97,44 @@ __rte_experimental
 int rte_node_ip6_route_add(const struct rte_ipv6_addr *ip, uint8_t depth, uint16_t next_hop,
 			   enum rte_node_ip6_lookup_next next_node);
 
+/**
+ * Create the FIB of the ip6_lookup_fib node on a socket.
+ *
+ * Must be called before creating the graphs using the ip6_lookup_fib node
+ * on this socket. The default next hop of the configuration is ignored,
+ * addresses without route are sent to the packet drop node.
+ *
+ * @param socket
+ *   NUMA socket of the FIB.
+ * @param conf
+ *   FIB configuration. The next hop size must be at least 4 bytes.
+ *
+ * @return
+ *   0 on success, -EINVAL if the next hop size is too small,
+ *   negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_fib_create(int socket, struct rte_fib6_conf *conf);
+
+/**
+ * Add IPv6 route to the FIB of ip6_lookup_fib node.
+ *
+ * @param ip
+ *   IPv6 address of route to be added.
+ * @param depth
+ *   Depth of the rule to be added.
+ * @param next_hop
+ *   Next hop id of the rule result to be added.
+ * @param next_node
+ *   Next node to redirect traffic to.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_fib_route_add(const struct rte_ipv6_addr *ip, uint8_t depth,
+			       uint16_t next_hop, enum rte_node_ip6_lookup_next next_node);
+
 /**
  * Add a next hop's rewrite data.
  *
@@ -71,6 +154,43 @@ __rte_experimental
 int rte_node_ip6_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 			     uint8_t rewrite_len, uint16_t dst_port);
 
+/**
+ * Add reassembly node configuration data.
+ *
+ * Each clone of the ip6_reassembly node, typically one per graph,
+ * uses its own fragmentation table.
+ *
+ * @param cfg
+ *   Pointer to the configuration structures.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_reassembly_configure(struct rte_node_ip6_reassembly_cfg *cfg, uint16_t cnt);
+
+/**
+ * Add fragmentation node configuration data.
+ *
+ * The ip6_fragment node is a feature of the RTE_NODE_IP6_OUTPUT_FEATURE_ARC
+ * arc, whose user data is the IPv6 MTU of the port. The packets longer than
+ * the MTU are fragmented with the pools of the graph socket, all the packets
+ * pass through when the user data is 0.
+ * Must be called before creating the graphs.
+ *
+ * @param cfg
+ *   Pointer to the configuration structures.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_fragment_configure(struct rte_node_ip6_fragment_cfg *cfg, uint16_t cnt);
+
 #ifdef __cplusplus
 }
 #endif
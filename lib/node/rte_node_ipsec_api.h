@@ -0,0 +1,155 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef __INCLUDE_RTE_NODE_IPSEC_API_H__
+#define __INCLUDE_RTE_NODE_IPSEC_API_H__
+
+/**
+ * @file rte_node_ipsec_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to do control path functions of the IPsec nodes,
+ * processing ESP packets with lib/ipsec and a crypto device.
+ *
+ * - esp_inbound is a feature of the RTE_NODE_ETHDEV_RX_FEATURE_ARC arc.
+ *   It looks up the SA of the ESP packets received on the port by their SPI,
+ *   and passes the other packets to the next feature.
+ * - esp_outbound is a feature of the RTE_NODE_IP4_OUTPUT_FEATURE_ARC arc.
+ *   It encrypts the packets sent on the port with the SA whose id is the
+ *   user data given when enabling the feature. IPv6 extension headers
+ *   are not parsed, the packets which are not IP are dropped.
+ * - ipsec_crypto_poll is a source node dequeuing the completed crypto
+ *   operations. It finalizes the packets with rte_ipsec_pkt_process() and
+ *   gives them back to esp_inbound or esp_outbound, which pass them to
+ *   the next feature of their arc.
+ *
+ * The ESP nodes group consecutive packets of the same SA, prepare them with
+ * rte_ipsec_pkt_crypto_prepare() and enqueue the crypto operations on the
+ * queue pair of their graph, without waiting for their completion.
+ * Decrypted tunnel packets get a new Ethernet header, outbound tunnel SAs
+ * must include the Ethernet header of the Tx port in their header template.
+ *
+ * With the mcore dispatch model, the esp_inbound, esp_outbound and
+ * ipsec_crypto_poll nodes of a graph must run on the same lcore,
+ * the queue pair being per graph.
+ */
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_ipsec.h>
+#include <rte_rcu_qsbr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of SA entries of each direction. Inbound SAs are hashed by SPI,
+ * modulo this number. The ids of outbound SAs are below it.
+ */
+#define RTE_NODE_IPSEC_MAX_SA 1024
+
+/** IV offset to give in the crypto transforms of the SA sessions. */
+#define RTE_NODE_IPSEC_IV_OFFSET \
+	(sizeof(struct rte_crypto_op) + sizeof(struct rte_crypto_sym_op))
+
+/** Size of the IV area of the crypto operations. */
+#define RTE_NODE_IPSEC_IV_SIZE 16
+
+/**
+ * IPsec crypto poll next nodes.
+ */
+enum rte_node_ipsec_crypto_poll_next {
+	RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+	RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_ESP_INBOUND,
+	/**< Decrypted packets to esp_inbound node. */
+	RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_ESP_OUTBOUND,
+	/**< Encrypted packets to esp_outbound node. */
+	RTE_NODE_IPSEC_CRYPTO_POLL_NEXT_MAX,
+	/**< Number of next nodes of ipsec_crypto_poll node. */
+};
+
+/**
+ * IPsec nodes configuration.
+ */
+struct rte_node_ipsec_conf {
+	uint8_t cdev_id;
+	/**< Crypto device, started with one queue pair per graph. */
+	uint32_t nb_ops;
+	/**< Number of crypto operations in flight for all the graphs. */
+	int socket_id;
+	/**< Socket of the crypto operations pool. */
+};
+
+/**
+ * Configure the IPsec nodes.
+ *
+ * Must be called before creating the graphs. The queue pair used by a
+ * graph is its id, the crypto device must have enough queue pairs.
+ *
+ * @param conf
+ *   Configuration.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ipsec_config(const struct rte_node_ipsec_conf *conf);
+
+/**
+ * Add an SA to the IPsec nodes.
+ *
+ * The session must be prepared with rte_ipsec_session_prepare(),
+ * with a crypto session of the configured crypto device
+ * (action type RTE_SECURITY_ACTION_TYPE_NONE), whose transforms have
+ * their IV at RTE_NODE_IPSEC_IV_OFFSET.
+ * Its crypto session opaque data is set to the session.
+ *
+ * @param id
+ *   SPI of an inbound SA, user data of the esp_outbound feature
+ *   for an outbound SA.
+ * @param ss
+ *   IPsec session of the SA, kept until the SA is deleted.
+ *
+ * @return
+ *   0 on success, negative otherwise:
+ *   - -EINVAL: invalid session, nodes not configured, or outbound id
+ *     not below RTE_NODE_IPSEC_MAX_SA.
+ *   - -ENOTSUP: session not processed by the configured crypto device.
+ *   - -EEXIST: SA with this id already added.
+ *   - -ENOSPC: the entry of this SPI is used by the SA of another SPI.
+ */
+__rte_experimental
+int rte_node_ipsec_sa_add(uint32_t id, struct rte_ipsec_session *ss);
+
+/**
+ * Delete an SA from the IPsec nodes.
+ *
+ * The ESP nodes stop using the SA for new packets. The crypto operations
+ * already enqueued keep using the session until ipsec_crypto_poll
+ * dequeues them: the session must be kept until then.
+ *
+ * @param id
+ *   Id of the SA given to rte_node_ipsec_sa_add().
+ * @param ss
+ *   IPsec session of the SA.
+ * @param qsbr
+ *   RCU QSBR variable of the workers running the ESP nodes, to wait for
+ *   them to stop using the SA. When NULL, the application must ensure
+ *   that no worker runs the ESP nodes during the call.
+ *
+ * @return
+ *   0 on success, -EINVAL for invalid parameters,
+ *   -ENOENT if the SA is not added with this id and session.
+ */
+__rte_experimental
+int rte_node_ipsec_sa_del(uint32_t id, struct rte_ipsec_session *ss,
+			  struct rte_rcu_qsbr *qsbr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_IPSEC_API_H__ */
@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (C) 2020 Marvell.
+ */
+
+#ifndef __INCLUDE_RTE_NODE_PKT_CLS_API_H__
+#define __INCLUDE_RTE_NODE_PKT_CLS_API_H__
+
+/**
+ * @file rte_node_pkt_cls_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API exposes the next nodes of the pkt_cls node, so that applications
+ * can redirect a packet class to another node with rte_node_edge_update(),
+ * for example IPv4 packets to "ip4_lookup_fib" instead of "ip4_lookup".
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Packet classification next nodes.
+ */
+enum rte_node_pkt_cls_next {
+	RTE_NODE_PKT_CLS_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+	RTE_NODE_PKT_CLS_NEXT_IP4_LOOKUP,
+	/**< IPv4 lookup node, "ip4_lookup" by default. */
+	RTE_NODE_PKT_CLS_NEXT_IP6_LOOKUP,
+	/**< IPv6 lookup node, "ip6_lookup" by default. */
+	RTE_NODE_PKT_CLS_NEXT_MAX,
+	/**< Number of next nodes of pkt_cls node. */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_PKT_CLS_API_H__ */
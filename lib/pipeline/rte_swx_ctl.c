@@ -10,9 +10,11 @@
 
 #include <rte_common.h>
 #include <rte_byteorder.h>
+#include <rte_cycles.h>
 #include <rte_tailq.h>
 #include <rte_eal_memconfig.h>
 
+#include <rte_swx_table_em.h>
 #include <rte_swx_table_selector.h>
 
 #include "rte_swx_ctl.h"
@@ -92,6 +94,15 @@ struct table {
 	uint32_t n_add;
 	uint32_t n_modify;
 	uint32_t n_delete;
+
+	/* In place update: the current table state and the next table state share the same table
+	 * object, which is updated by the commit operation while in use by the data plane.
+	 */
+	int inplace;
+
+	/* Time spent on the table by the commit operation in progress. */
+	uint64_t commit_cycles;
+	struct rte_swx_ctl_table_commit_stats commit_stats;
 };
 
 struct selector {
@@ -1039,8 +1050,8 @@ table_state_free(struct rte_swx_ctl_pipeline *ctl)
 		/* Default action data. */
 		free(ts->default_action_data);
 
-		/* Table object. */
-		if (!table->is_stub && table->ops.free && ts->obj)
+		/* Table object. Shared with the current table state when updated in place. */
+		if (!table->is_stub && table->ops.free && ts->obj && !table->inplace)
 			table->ops.free(ts->obj);
 	}
 
@@ -1842,6 +1853,10 @@ table_rollfwd0(struct rte_swx_ctl_pipeline *ctl,
 	 * Current table supports incremental update.
 	 */
 	if (table->ops.add) {
+		/* In place update: the table object was already updated before the swap. */
+		if (table->inplace && after_swap)
+			return 0;
+
 		/* Reset counters. */
 		table->n_add = 0;
 		table->n_modify = 0;
@@ -1972,6 +1987,52 @@ table_rollfwd1(struct rte_swx_ctl_pipeline *ctl, uint32_t table_id)
 	ts_next->default_action_id = action_id;
 }
 
+/* In place update: release the resources of the entries deleted by the commit operation, once
+ * the data plane is done with them.
+ */
+static void
+table_reclaim(struct rte_swx_ctl_pipeline *ctl, uint32_t table_id)
+{
+	struct table *table = &ctl->tables[table_id];
+
+	if (table->is_stub || !table->inplace)
+		return;
+
+	rte_swx_table_exact_match_reclaim(ctl->ts[table_id].obj);
+}
+
+/* In place update: check whether any table object in use by the data plane has pending changes. */
+static int
+table_inplace_update_pending(struct rte_swx_ctl_pipeline *ctl)
+{
+	uint32_t i;
+
+	for (i = 0; i < ctl->info.n_tables; i++) {
+		struct table *table = &ctl->tables[i];
+
+		if (!table->is_stub && table->inplace && table_is_update_pending(table, 0))
+			return 1;
+	}
+
+	return 0;
+}
+
+static void
+table_commit_stats_update(struct rte_swx_ctl_pipeline *ctl, uint32_t table_id)
+{
+	struct table *table = &ctl->tables[table_id];
+	struct rte_swx_ctl_table_commit_stats *stats = &table->commit_stats;
+
+	if (!table_is_update_pending(table, 1))
+		return;
+
+	stats->n_commits++;
+	stats->n_entries += table_is_update_pending(table, 0);
+	stats->cycles_last = table->commit_cycles;
+	stats->cycles_max = RTE_MAX(stats->cycles_max, table->commit_cycles);
+	stats->cycles_total += table->commit_cycles;
+}
+
 /* This last commit stage is simply finalizing a successful commit operation.
  * This stage is only executed if all the previous stages were successful. This
  * stage cannot fail.
@@ -2007,24 +2068,48 @@ table_rollfwd2(struct rte_swx_ctl_pipeline *ctl, uint32_t table_id)
  * tables to their state before the commit started, as if the commit never
  * happened.
  */
-static void
+static int
 table_rollback(struct rte_swx_ctl_pipeline *ctl, uint32_t table_id)
 {
 	struct table *table = &ctl->tables[table_id];
 	struct rte_swx_table_state *ts_next = &ctl->ts_next[table_id];
 
 	if (table->is_stub || !table_is_update_pending(table, 0))
-		return;
+		return 0;
 
 	if (table->ops.add) {
 		struct rte_swx_table_entry *entry;
 
+		/* Delete all the entries that were just added, so that their resources are
+		 * available to the entries added back below.
+		 */
+		TAILQ_FOREACH(entry, &table->pending_add, node) {
+			if (!table->n_add)
+				break;
+
+			table->ops.del(ts_next->obj, entry);
+			table->n_add--;
+		}
+
+		/* In place update: the table object is in use by the data plane, so the resources
+		 * of the deleted entries are only released once the data plane is done with them.
+		 */
+		if (table->inplace) {
+			rte_swx_pipeline_grace_period_wait(ctl->p);
+			table_reclaim(ctl, table_id);
+		}
+
 		/* Add back all the entries that were just deleted. */
 		TAILQ_FOREACH(entry, &table->pending_delete, node) {
+			int status;
+
 			if (!table->n_delete)
 				break;
 
-			table->ops.add(ts_next->obj, entry);
+			status = table->ops.add(ts_next->obj, entry);
+			if (status)
+				return status;
+
 			table->n_delete--;
 		}
 
@@ -2032,20 +2117,22 @@ table_rollback(struct rte_swx_ctl_pipeline *ctl, uint32_t table_id)
 		 * modified.
 		 */
 		TAILQ_FOREACH(entry, &table->pending_modify0, node) {
+			int status;
+
 			if (!table->n_modify)
 				break;
 
-			table->ops.add(ts_next->obj, entry);
+			status = table->ops.add(ts_next->obj, entry);
+			if (status)
+				return status;
+
 			table->n_modify--;
 		}
 
-		/* Delete all the entries that were just added. */
-		TAILQ_FOREACH(entry, &table->pending_add, node) {
-			if (!table->n_add)
-				break;
-
-			table->ops.del(ts_next->obj, entry);
-			table->n_add--;
+		/* In place update: release the old copy of the modified entries. */
+		if (table->inplace) {
+			rte_swx_pipeline_grace_period_wait(ctl->p);
+			table_reclaim(ctl, table_id);
 		}
 	} else {
 		struct rte_swx_table_state *ts = &ctl->ts[table_id];
@@ -2057,6 +2144,8 @@ table_rollback(struct rte_swx_ctl_pipeline *ctl, uint32_t table_id)
 		/* Reinstate the old table object. */
 		ts_next->obj = ts->obj;
 	}
+
+	return 0;
 }
 
 /* This stage is conditionally executed (as instructed by the user) after a
@@ -2567,7 +2656,10 @@ rte_swx_ctl_pipeline_commit(struct rte_swx_ctl_pipeline *ctl, int abort_on_fail)
 	 * We must be able to fully revert all the changes that can fail as if they never happened.
 	 */
 	for (i = 0; i < ctl->info.n_tables; i++) {
+		uint64_t time = rte_get_tsc_cycles();
+
 		status = table_rollfwd0(ctl, i, 0);
+		ctl->tables[i].commit_cycles = rte_get_tsc_cycles() - time;
 		if (status)
 			goto rollback;
 	}
@@ -2592,6 +2684,13 @@ rte_swx_ctl_pipeline_commit(struct rte_swx_ctl_pipeline *ctl, int abort_on_fail)
 	 */
 	rte_swx_pipeline_table_state_set(ctl->p, ctl->ts_next);
 	usleep(100);
+
+	/* In place update: the deleted entries are reclaimed below, once the data plane is done
+	 * with them.
+	 */
+	if (table_inplace_update_pending(ctl))
+		rte_swx_pipeline_grace_period_wait(ctl->p);
+
 	ts = ctl->ts;
 	ctl->ts = ctl->ts_next;
 	ctl->ts_next = ts;
@@ -2602,8 +2701,14 @@ rte_swx_ctl_pipeline_commit(struct rte_swx_ctl_pipeline *ctl, int abort_on_fail)
 	 * current ts_next, hence no error checking is needed.
 	 */
 	for (i = 0; i < ctl->info.n_tables; i++) {
+		uint64_t time = rte_get_tsc_cycles();
+
 		table_rollfwd0(ctl, i, 1);
 		table_rollfwd1(ctl, i);
+		table_reclaim(ctl, i);
+		ctl->tables[i].commit_cycles += rte_get_tsc_cycles() - time;
+
+		table_commit_stats_update(ctl, i);
 		table_rollfwd2(ctl, i);
 	}
 
@@ -2621,7 +2726,13 @@ rte_swx_ctl_pipeline_commit(struct rte_swx_ctl_pipeline *ctl, int abort_on_fail)
 
 rollback:
 	for (i = 0; i < ctl->info.n_tables; i++) {
-		table_rollback(ctl, i);
+		int rollback_status;
+
+		/* A failed rollback leaves the table object out of sync with the table entries. */
+		rollback_status = table_rollback(ctl, i);
+		if (rollback_status)
+			status = rollback_status;
+
 		if (abort_on_fail)
 			table_abort(ctl, i);
 	}
@@ -2639,6 +2750,84 @@ rte_swx_ctl_pipeline_commit(struct rte_swx_ctl_pipeline *ctl, int abort_on_fail)
 	return status;
 }
 
+int
+rte_swx_ctl_pipeline_table_inplace_update_set(struct rte_swx_ctl_pipeline *ctl,
+					      const char *table_name,
+					      int enable)
+{
+	struct rte_swx_table_state *ts, *ts_next;
+	struct table *table;
+	uint32_t table_id;
+
+	CHECK(ctl, EINVAL);
+	CHECK(table_name && table_name[0], EINVAL);
+
+	table = table_find(ctl, table_name);
+	CHECK(table, EINVAL);
+	CHECK(!table->is_stub, EINVAL);
+	CHECK(table->ops.create == rte_swx_table_exact_match_ops.create, ENOTSUP);
+	CHECK(!table_is_update_pending(table, 0), EBUSY);
+
+	enable = enable ? 1 : 0;
+	if (enable == table->inplace)
+		return 0;
+
+	table_id = table - ctl->tables;
+	ts = &ctl->ts[table_id];
+	ts_next = &ctl->ts_next[table_id];
+
+	if (enable) {
+		int status;
+
+		status = rte_swx_table_exact_match_inplace_update_set(ts->obj, 1);
+		if (status)
+			return status;
+
+		/* Free the shadow copy of the table object. */
+		table->ops.free(ts_next->obj);
+		ts_next->obj = ts->obj;
+	} else {
+		void *obj;
+		int status;
+
+		/* Build a new shadow copy of the table object. */
+		obj = table->ops.create(&table->params,
+					&table->entries,
+					table->info.args,
+					ctl->numa_node);
+		CHECK(obj, ENODEV);
+
+		status = rte_swx_table_exact_match_inplace_update_set(ts->obj, 0);
+		if (status) {
+			table->ops.free(obj);
+			return status;
+		}
+
+		ts_next->obj = obj;
+	}
+
+	table->inplace = enable;
+	return 0;
+}
+
+int
+rte_swx_ctl_pipeline_table_commit_stats_read(struct rte_swx_ctl_pipeline *ctl,
+					     const char *table_name,
+					     struct rte_swx_ctl_table_commit_stats *stats)
+{
+	struct table *table;
+
+	CHECK(ctl, EINVAL);
+	CHECK(table_name && table_name[0], EINVAL);
+	CHECK(stats, EINVAL);
+
+	table = table_find(ctl, table_name);
+	CHECK(table, EINVAL);
+
+	memcpy(stats, &table->commit_stats, sizeof(*stats));
+	return 0;
+}
+
 void
 rte_swx_ctl_pipeline_abort(struct rte_swx_ctl_pipeline *ctl)
 {
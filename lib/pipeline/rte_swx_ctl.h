@@ -814,6 +814,23 @@ int
 rte_swx_pipeline_table_state_set(struct rte_swx_pipeline *p,
 				 struct rte_swx_table_state *table_state);
 
+/**
+ * Pipeline grace period wait
+ *
+ * Wait until the packets in progress when this function is called are done, so that the table
+ * entries previously removed from the tables in use by the data plane are no longer used by
+ * the data plane. This function blocks while the pipeline holds packets and is not run.
+ *
+ * @param[in] p
+ *   Pipeline handle.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument.
+ */
+__rte_experimental
+int
+rte_swx_pipeline_grace_period_wait(struct rte_swx_pipeline *p);
+
 /*
  * High Level Reference Table Update API.
  */
@@ -1058,6 +1075,78 @@ int
 rte_swx_ctl_pipeline_commit(struct rte_swx_ctl_pipeline *ctl,
 			    int abort_on_fail);
 
+/**
+ * Pipeline table in place update mode set
+ *
+ * By default, the commit operation updates a shadow copy of each table object, which is then
+ * swapped with the current table object used by the data plane, so the table memory is
+ * doubled. When the in place update mode is enabled for a table, the commit operation updates
+ * the current table object while in use by the data plane, which saves the shadow copy and
+ * halves the commit time. The table entries deleted by the commit are only reused after the
+ * data plane is done with them. As opposed to the default mode, the table changes become
+ * visible to the data plane one by one during the commit operation, and a failed commit
+ * operation reverts the changes already visible. The modification of an existing table entry
+ * requires a free table entry, so the commit operation fails with -ENOSPC when the table is
+ * full. Only the exact match tables support the in place update mode.
+ *
+ * @param[in] ctl
+ *   Pipeline control handle.
+ * @param[in] table_name
+ *   Table name.
+ * @param[in] enable
+ *   When non-zero (true), enable the in place update mode, otherwise disable it.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument;
+ *   -ENOTSUP: The table type does not support in place update;
+ *   -EBUSY: The table has pending changes;
+ *   -ENODEV: Table object creation failed.
+ */
+__rte_experimental
+int
+rte_swx_ctl_pipeline_table_inplace_update_set(struct rte_swx_ctl_pipeline *ctl,
+					      const char *table_name,
+					      int enable);
+
+/** Table commit statistics. */
+struct rte_swx_ctl_table_commit_stats {
+	/** Number of commit operations with table changes. */
+	uint64_t n_commits;
+
+	/** Number of table entries added, modified or deleted by the commit operations. */
+	uint64_t n_entries;
+
+	/** Time spent updating the table objects by the last commit operation with table
+	 * changes, in CPU cycles. The table state swap grace period is not included.
+	 */
+	uint64_t cycles_last;
+
+	/** Maximum time spent updating the table objects by a commit operation, in CPU cycles. */
+	uint64_t cycles_max;
+
+	/** Total time spent updating the table objects by the commit operations, in CPU cycles. */
+	uint64_t cycles_total;
+};
+
+/**
+ * Pipeline table commit statistics read
+ *
+ * @param[in] ctl
+ *   Pipeline control handle.
+ * @param[in] table_name
+ *   Table name.
+ * @param[out] stats
+ *   Table commit statistics. Must point to a pre-allocated structure.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument.
+ */
+__rte_experimental
+int
+rte_swx_ctl_pipeline_table_commit_stats_read(struct rte_swx_ctl_pipeline *ctl,
+					     const char *table_name,
+					     struct rte_swx_ctl_table_commit_stats *stats);
+
 /**
  * Pipeline abort
  *
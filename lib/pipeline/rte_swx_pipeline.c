@@ -10,6 +10,7 @@
 #include <rte_eal_memconfig.h>
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
+#include <rte_pause.h>
 
 #include <rte_swx_port_ethdev.h>
 #include <rte_swx_port_fd.h>
@@ -17,6 +18,7 @@
 #include "rte_swx_port_source_sink.h"
 
 #include <rte_swx_table_em.h>
+#include <rte_swx_table_lpm.h>
 #include <rte_swx_table_wm.h>
 
 #include "rte_swx_pipeline_internal.h"
@@ -8253,8 +8255,25 @@ rte_swx_pipeline_table_type_register(struct rte_swx_pipeline *p,
 }
 
 static int
-table_match_type_resolve(struct rte_swx_match_field_params *fields,
+table_match_field_lpm_check(struct rte_swx_pipeline *p,
+			    struct rte_swx_match_field_params *f,
+			    struct header *header)
+{
+	struct field *field;
+
+	field = header ? header_field_parse(p, f->name, NULL) : metadata_field_parse(p, f->name);
+	if (!field)
+		return 0;
+
+	/* The 32-bit keys are looked up in network byte order, i.e. header fields only. */
+	return (field->n_bits == 128) || (header && (field->n_bits == 32));
+}
+
+static int
+table_match_type_resolve(struct rte_swx_pipeline *p,
+			 struct rte_swx_match_field_params *fields,
 			 uint32_t n_fields,
+			 struct header *header,
 			 int contiguous_fields,
 			 enum rte_swx_table_match_type *match_type)
 {
@@ -8274,6 +8293,11 @@ table_match_type_resolve(struct rte_swx_match_field_params *fields,
 	    (n_fields_lpm && (n_fields_em != n_fields - 1)))
 		return -EINVAL;
 
+	if ((n_fields == 1) && n_fields_lpm && table_match_field_lpm_check(p, &fields[0], header)) {
+		*match_type = RTE_SWX_TABLE_MATCH_LPM;
+		return 0;
+	}
+
 	*match_type = ((n_fields_em == n_fields) && contiguous_fields) ?
 		       RTE_SWX_TABLE_MATCH_EXACT :
 		       RTE_SWX_TABLE_MATCH_WILDCARD;
@@ -8470,14 +8494,31 @@ rte_swx_pipeline_table_config(struct rte_swx_pipeline *p,
 	if (params->n_fields) {
 		enum rte_swx_table_match_type match_type;
 
-		status = table_match_type_resolve(params->fields,
+		status = table_match_type_resolve(p,
+						  params->fields,
 						  params->n_fields,
+						  header,
 						  contiguous_fields,
 						  &match_type);
 		if (status)
 			return status;
 
 		type = table_type_resolve(p, recommended_table_type_name, match_type);
+
+		/* The wildcard match table types also implement LPM: use them when
+		 * recommended or when there is no LPM table type.
+		 */
+		if (match_type == RTE_SWX_TABLE_MATCH_LPM) {
+			struct table_type *wm_type;
+
+			wm_type = table_type_resolve(p,
+						     recommended_table_type_name,
+						     RTE_SWX_TABLE_MATCH_WILDCARD);
+			if (!type || (wm_type && recommended_table_type_name &&
+				      !strcmp(wm_type->name, recommended_table_type_name)))
+				type = wm_type;
+		}
+
 		CHECK(type, EINVAL);
 	}
 
@@ -10429,6 +10470,13 @@ table_types_register(struct rte_swx_pipeline *p)
 	if (status)
 		return status;
 
+	status = rte_swx_pipeline_table_type_register(p,
+		"lpm",
+		RTE_SWX_TABLE_MATCH_LPM,
+		&rte_swx_table_lpm_ops);
+	if (status)
+		return status;
+
 	return 0;
 }
 
@@ -10669,8 +10717,14 @@ rte_swx_pipeline_run(struct rte_swx_pipeline *p, uint32_t n_instructions)
 {
 	uint32_t i;
 
+	/* Order the running flag before the table reads, see rte_swx_pipeline_grace_period_wait(). */
+	rte_atomic_store_explicit(&p->running, 1, rte_memory_order_relaxed);
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+
 	for (i = 0; i < n_instructions; i++)
 		instr_exec(p);
+
+	rte_atomic_store_explicit(&p->running, 0, rte_memory_order_release);
 }
 
 void
@@ -11113,6 +11167,50 @@ rte_swx_pipeline_table_state_set(struct rte_swx_pipeline *p,
 	return 0;
 }
 
+int
+rte_swx_pipeline_grace_period_wait(struct rte_swx_pipeline *p)
+{
+	uint64_t rx_seq[RTE_SWX_PIPELINE_THREADS_MAX];
+	uint32_t i;
+
+	if (!p || !p->build_done)
+		return -EINVAL;
+
+	/* Order the table updates of the caller before the reads of the data plane state. */
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++)
+		rx_seq[i] = rte_atomic_load_explicit(&p->threads[i].rx_seq,
+						     rte_memory_order_acquire);
+
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++)
+		for ( ; ; ) {
+			uint32_t running;
+			uint64_t seq;
+
+			running = rte_atomic_load_explicit(&p->running, rte_memory_order_acquire);
+			seq = rte_atomic_load_explicit(&p->threads[i].rx_seq,
+						       rte_memory_order_acquire);
+
+			/* The thread executed two rx instructions: the first one may not be visible
+			 * yet in the initial snapshot, so only the second one guarantees that the
+			 * packets received before the table update are done.
+			 */
+			if ((seq >> 1) >= (rx_seq[i] >> 1) + 2)
+				break;
+
+			/* The pipeline is not running and the thread holds no packet: any later
+			 * run of the pipeline sees the table updates.
+			 */
+			if (!running && !(seq & 1))
+				break;
+
+			rte_pause();
+		}
+
+	return 0;
+}
+
 int
 rte_swx_ctl_pipeline_port_in_stats_read(struct rte_swx_pipeline *p,
 					uint32_t port_id,
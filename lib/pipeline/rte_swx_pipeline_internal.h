@@ -8,6 +8,7 @@
 #include <string.h>
 #include <sys/queue.h>
 
+#include <rte_atomic.h>
 #include <rte_bitops.h>
 #include <rte_byteorder.h>
 #include <rte_common.h>
@@ -1097,6 +1098,11 @@ struct thread {
 	/* Instructions. */
 	struct instruction *ip;
 	struct instruction *ret;
+
+	/* Grace period: twice the number of rx instructions executed, plus one while the
+	 * thread holds a packet. Written by the data plane, read by the control path.
+	 */
+	RTE_ATOMIC(uint64_t) rx_seq;
 };
 
 #define MASK64_BIT_GET(mask, pos) ((mask) & (1LLU << (pos)))
@@ -1604,6 +1610,9 @@ struct rte_swx_pipeline {
 	uint32_t n_instructions;
 	int build_done;
 	int numa_node;
+
+	/* Grace period: non-zero while the data plane runs the pipeline. */
+	RTE_ATOMIC(uint32_t) running;
 };
 
 /*
@@ -1627,6 +1636,16 @@ thread_ip_reset(struct rte_swx_pipeline *p, struct thread *t)
 	t->ip = p->instructions;
 }
 
+static inline void
+thread_rx_seq_update(struct thread *t, int pkt_received)
+{
+	uint64_t rx_seq = rte_atomic_load_explicit(&t->rx_seq, rte_memory_order_relaxed);
+
+	/* Release: the previous packet of this thread is done with the table entries. */
+	rte_atomic_store_explicit(&t->rx_seq, ((rx_seq | 1) + 1) | (pkt_received ? 1 : 0),
+				  rte_memory_order_release);
+}
+
 static inline void
 thread_ip_set(struct thread *t, struct instruction *ip)
 {
@@ -1700,6 +1719,9 @@ __instr_rx_exec(struct rte_swx_pipeline *p, struct thread *t, const struct instr
 		/* Tables. */
 		t->table_state = p->table_state;
 
+		/* Thread. */
+		thread_rx_seq_update(t, 1);
+
 		return 1;
 	}
 
@@ -1727,6 +1749,7 @@ __instr_rx_exec(struct rte_swx_pipeline *p, struct thread *t, const struct instr
 	t->table_state = p->table_state;
 
 	/* Thread. */
+	thread_rx_seq_update(t, pkt_received);
 	pipeline_port_inc(p);
 
 	return pkt_received;
@@ -6,6 +6,7 @@
 #include <errno.h>
 
 #include <rte_common.h>
+#include <rte_atomic.h>
 #include <rte_prefetch.h>
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
@@ -23,6 +24,13 @@ do {                                                                           \
 #define RTE_SWX_TABLE_EM_USE_HUGE_PAGES 1
 #endif
 
+/* Tables up to this size are likely to stay in the CPU cache, their lookup is completed in a
+ * single step instead of being split into multiple steps to prefetch the table data.
+ */
+#ifndef RTE_SWX_TABLE_EM_LOOKUP_DIRECT_SIZE_MAX
+#define RTE_SWX_TABLE_EM_LOOKUP_DIRECT_SIZE_MAX (512 * 1024)
+#endif
+
 #if RTE_SWX_TABLE_EM_USE_HUGE_PAGES
 
 #include <rte_malloc.h>
@@ -82,8 +90,18 @@ struct table {
 	uint32_t n_buckets_ext;
 	uint32_t key_stack_tos;
 	uint32_t bkt_ext_stack_tos;
+
+	/* In place update: the keys and bucket extensions released by the add and delete
+	 * operations are not reused before the next reclaim operation, as they may still be used
+	 * by the lookup operations in progress. They are stored at the end of the key and bucket
+	 * extension stacks.
+	 */
+	int inplace;
+	uint32_t key_stack_n_deferred;
+	uint32_t bkt_ext_stack_n_deferred;
 	uint64_t total_size;
 	rte_swx_keycmp_func_t keycmp_func;
+	int lookup_direct;
 
 	/* Memory arrays. */
 	struct bucket_extension *buckets;
@@ -154,9 +172,6 @@ bkt_key_install(struct table *t,
 	uint8_t *bkt_key;
 	uint64_t *bkt_data;
 
-	/* Key signature. */
-	bkt->sig[bkt_pos] = (uint16_t)input_sig;
-
 	/* Key. */
 	bkt->key_id[bkt_pos] = bkt_key_id;
 	bkt_key = table_key(t, bkt_key_id);
@@ -167,25 +182,74 @@ bkt_key_install(struct table *t,
 	bkt_data[0] = input->action_id;
 	if (t->params.action_data_size && input->action_data)
 		memcpy(&bkt_data[1], input->action_data, t->params.action_data_size);
+
+	/* Key signature: written last, as it makes the key visible to the lookup operations. */
+	rte_atomic_thread_fence(rte_memory_order_release);
+	bkt->sig[bkt_pos] = (uint16_t)input_sig;
 }
 
 static inline void
+key_free(struct table *t, uint32_t key_id)
+{
+	if (t->inplace)
+		t->key_stack[t->params.n_keys_max - 1 - t->key_stack_n_deferred++] = key_id;
+	else
+		t->key_stack[t->key_stack_tos++] = key_id;
+}
+
+static inline void
+bkt_ext_free(struct table *t, uint32_t bkt_ext_id)
+{
+	if (t->inplace)
+		t->bkt_ext_stack[t->n_buckets_ext - 1 - t->bkt_ext_stack_n_deferred++] = bkt_ext_id;
+	else
+		t->bkt_ext_stack[t->bkt_ext_stack_tos++] = bkt_ext_id;
+}
+
+static inline int
 bkt_key_data_update(struct table *t,
 		    struct bucket_extension *bkt,
 		    struct rte_swx_table_entry *input,
 		    uint32_t bkt_pos)
 {
-	uint32_t bkt_key_id;
+	uint32_t bkt_key_id, new_bkt_key_id;
 	uint64_t *bkt_data;
+	uint8_t *bkt_key;
 
 	/* Key. */
 	bkt_key_id = bkt->key_id[bkt_pos];
 
 	/* Key data. */
-	bkt_data = table_key_data(t, bkt_key_id);
+	if (!t->inplace) {
+		bkt_data = table_key_data(t, bkt_key_id);
+		bkt_data[0] = input->action_id;
+		if (t->params.action_data_size && input->action_data)
+			memcpy(&bkt_data[1], input->action_data, t->params.action_data_size);
+		return 0;
+	}
+
+	/* In place update: the key data cannot be updated while in use by the lookup operations,
+	 * so a free key is required.
+	 */
+	CHECK(t->key_stack_tos, ENOSPC);
+
+	/* Copy the key with the new data to a new key, so that the lookup operations in progress
+	 * get either the old or the new key data, never a mix of both.
+	 */
+	new_bkt_key_id = t->key_stack[--t->key_stack_tos];
+	bkt_key = table_key(t, new_bkt_key_id);
+	keycpy(bkt_key, table_key(t, bkt_key_id), t->params.key_size);
+
+	bkt_data = table_key_data(t, new_bkt_key_id);
 	bkt_data[0] = input->action_id;
 	if (t->params.action_data_size && input->action_data)
 		memcpy(&bkt_data[1], input->action_data, t->params.action_data_size);
+
+	rte_atomic_thread_fence(rte_memory_order_release);
+	bkt->key_id[bkt_pos] = new_bkt_key_id;
+
+	key_free(t, bkt_key_id);
+	return 0;
 }
 
 #define CL RTE_CACHE_LINE_ROUNDUP
@@ -266,6 +330,7 @@ __table_create(struct table **table,
 	t->n_buckets_ext = n_buckets_ext;
 	t->total_size = total_size;
 	t->keycmp_func = rte_swx_keycmp_func_get(params->key_size);
+	t->lookup_direct = (total_size <= RTE_SWX_TABLE_EM_LOOKUP_DIRECT_SIZE_MAX) ? 1 : 0;
 
 	t->buckets = (struct bucket_extension *)&memory[bucket_offset];
 	t->buckets_ext = (struct bucket_extension *)&memory[bucket_ext_offset];
@@ -316,10 +381,8 @@ table_add(void *table, struct rte_swx_table_entry *entry)
 	/* Key is present in the bucket. */
 	for (bkt = bkt0; bkt; bkt = bkt->next)
 		for (i = 0; i < KEYS_PER_BUCKET; i++)
-			if (bkt_keycmp(t, bkt, entry->key, i, input_sig)) {
-				bkt_key_data_update(t, bkt, entry, i);
-				return 0;
-			}
+			if (bkt_keycmp(t, bkt, entry->key, i, input_sig))
+				return bkt_key_data_update(t, bkt, entry, i);
 
 	/* Key is not present in the bucket. Bucket not full. */
 	for (bkt = bkt0, bkt_prev = NULL; bkt; bkt_prev = bkt, bkt = bkt->next)
@@ -339,15 +402,18 @@ table_add(void *table, struct rte_swx_table_entry *entry)
 		struct bucket_extension *new_bkt;
 		uint32_t new_bkt_id, new_bkt_key_id;
 
-		/* Allocate new bucket extension & install. */
+		/* Allocate new bucket extension. */
 		new_bkt_id = t->bkt_ext_stack[--t->bkt_ext_stack_tos];
 		new_bkt = &t->buckets_ext[new_bkt_id];
 		memset(new_bkt, 0, sizeof(*new_bkt));
-		bkt_prev->next = new_bkt;
 
 		/* Allocate new key & install. */
 		new_bkt_key_id = t->key_stack[--t->key_stack_tos];
 		bkt_key_install(t, new_bkt, entry, 0, new_bkt_key_id, input_sig);
+
+		/* Bucket extension install. */
+		rte_atomic_thread_fence(rte_memory_order_release);
+		bkt_prev->next = new_bkt;
 		return 0;
 	}
 
@@ -376,13 +442,13 @@ table_del(void *table, struct rte_swx_table_entry *entry)
 			if (bkt_keycmp(t, bkt, entry->key, i, input_sig)) {
 				/* Key free. */
 				bkt->sig[i] = 0;
-				t->key_stack[t->key_stack_tos++] = bkt->key_id[i];
+				key_free(t, bkt->key_id[i]);
 
 				/* Bucket extension free if empty and not the 1st in bucket. */
 				if (bkt_prev && bkt_is_empty(bkt)) {
 					bkt_prev->next = bkt->next;
 					bkt_id = bkt - t->buckets_ext;
-					t->bkt_ext_stack[t->bkt_ext_stack_tos++] = bkt_id;
+					bkt_ext_free(t, bkt_id);
 				}
 
 				return 0;
@@ -391,6 +457,37 @@ table_del(void *table, struct rte_swx_table_entry *entry)
 	return 0;
 }
 
+int
+rte_swx_table_exact_match_inplace_update_set(void *table, int enable)
+{
+	struct table *t = table;
+
+	CHECK(t, EINVAL);
+	CHECK(!t->key_stack_n_deferred && !t->bkt_ext_stack_n_deferred, EBUSY);
+
+	t->inplace = enable ? 1 : 0;
+	return 0;
+}
+
+void
+rte_swx_table_exact_match_reclaim(void *table)
+{
+	struct table *t = table;
+	uint32_t i;
+
+	if (!t)
+		return;
+
+	/* Move the deferred elements, starting with the closest to the top of the stack. */
+	for (i = t->key_stack_n_deferred; i > 0; i--)
+		t->key_stack[t->key_stack_tos++] = t->key_stack[t->params.n_keys_max - i];
+	t->key_stack_n_deferred = 0;
+
+	for (i = t->bkt_ext_stack_n_deferred; i > 0; i--)
+		t->bkt_ext_stack[t->bkt_ext_stack_tos++] = t->bkt_ext_stack[t->n_buckets_ext - i];
+	t->bkt_ext_stack_n_deferred = 0;
+}
+
 static uint64_t
 table_mailbox_size_get_unoptimized(void)
 {
@@ -513,6 +610,16 @@ table_lookup(void *table,
 		struct bucket_extension *bkt;
 		uint32_t input_sig, bkt_id;
 
+		/* Small table: no memory latency to hide, save the thread yields. */
+		if (t->lookup_direct)
+			return table_lookup_unoptimized(t,
+							m,
+							key,
+							action_id,
+							action_data,
+							entry_id,
+							hit);
+
 		input_sig = t->params.hash_func(input_key, t->params.key_size, 0);
 		bkt_id = input_sig & (t->n_buckets - 1);
 		bkt = &t->buckets[bkt_id];
@@ -10,6 +10,8 @@
  */
 
 
+#include <rte_compat.h>
+
 #include <rte_swx_table.h>
 
 #ifdef __cplusplus
@@ -22,6 +24,43 @@ extern struct rte_swx_table_ops rte_swx_table_exact_match_unoptimized_ops;
 /** Exact match table operations. */
 extern struct rte_swx_table_ops rte_swx_table_exact_match_ops;
 
+/**
+ * Exact match table in place update enable or disable
+ *
+ * In place update is disabled by default. When enabled, the incremental table
+ * entry add and delete operations are safe while table lookup operations are in
+ * progress: the keys and bucket extensions released by these operations are not
+ * reused until the next reclaim operation, and the update of an existing entry
+ * fails with -ENOSPC when no free key is available.
+ *
+ * @param[in] table
+ *   Table handle.
+ * @param[in] enable
+ *   Non-zero to enable in place update, zero to disable it.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument;
+ *   -EBUSY: Released keys or bucket extensions are pending reclaim.
+ */
+__rte_experimental
+int
+rte_swx_table_exact_match_inplace_update_set(void *table, int enable);
+
+/**
+ * Exact match table reclaim
+ *
+ * Make the keys and bucket extensions released by the table entry add and
+ * delete operations since the previous call available again in place update
+ * mode. It must only be called once no table lookup operation started before
+ * these table entry operations is still in progress.
+ *
+ * @param[in] table
+ *   Table handle.
+ */
+__rte_experimental
+void
+rte_swx_table_exact_match_reclaim(void *table);
+
 #ifdef __cplusplus
 }
 #endif
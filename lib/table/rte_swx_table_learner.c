@@ -18,6 +18,13 @@
 #define RTE_SWX_TABLE_LEARNER_USE_HUGE_PAGES 1
 #endif
 
+/* Tables up to this size are likely to stay in the CPU cache, their lookup is completed in a
+ * single step instead of two steps with the table bucket prefetched in between.
+ */
+#ifndef RTE_SWX_TABLE_LEARNER_LOOKUP_DIRECT_SIZE_MAX
+#define RTE_SWX_TABLE_LEARNER_LOOKUP_DIRECT_SIZE_MAX (512 * 1024)
+#endif
+
 #ifndef RTE_SWX_TABLE_SELECTOR_HUGE_PAGES_DISABLE
 
 #include <rte_malloc.h>
@@ -143,6 +150,9 @@ struct table_params {
 
 	/* Total memory size. */
 	size_t total_size;
+
+	/* Lookup completed in a single step, as the table is likely to stay in the CPU cache. */
+	int lookup_direct;
 };
 
 struct __rte_cache_aligned table {
@@ -242,6 +252,9 @@ table_params_get(struct table_params *p, struct rte_swx_table_learner_params *pa
 	/* Total size. */
 	p->total_size = sizeof(struct table) + p->n_buckets * p->bucket_size;
 
+	/* Lookup. */
+	p->lookup_direct = (p->total_size <= RTE_SWX_TABLE_LEARNER_LOOKUP_DIRECT_SIZE_MAX) ? 1 : 0;
+
 	return 0;
 }
 
@@ -393,8 +406,12 @@ rte_swx_table_learner_lookup(void *table,
 		m->input_key = input_key;
 		m->input_sig = input_sig | 1;
 		m->state = 1;
-		return 0;
+
+		/* Small table: no memory latency to hide, save the thread yield. */
+		if (!t->params.lookup_direct)
+			return 0;
 	}
+	/* fall-through */
 
 	case 1: {
 		struct table_bucket *b = m->bucket;
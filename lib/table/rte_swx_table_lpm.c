@@ -0,0 +1,392 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_malloc.h>
+#include <rte_stdatomic.h>
+#include <rte_fib.h>
+#include <rte_fib6.h>
+#include <rte_rib.h>
+#include <rte_rib6.h>
+
+#include "rte_swx_table_lpm.h"
+
+#define CHECK(condition, err_code)                                             \
+do {                                                                           \
+	if (!(condition))                                                      \
+		return -(err_code);                                            \
+} while (0)
+
+#define KEY_SIZE_IPV4 4
+#define KEY_SIZE_IPV6 16
+
+/* Maximum number of tbl8 groups of the FIB. */
+#define TBL8_MAX (1 << 16)
+
+/* Number of tbl8 groups per IPv6 route, enough for prefixes up to /64. */
+#define TBL8_PER_ROUTE_IPV6 5
+
+/* The FIB next hop is the entry ID plus one, next hop 0 is the lookup miss. */
+#define NH_MISS 0
+
+#define NAME_SIZE 32
+
+struct table {
+	struct rte_fib *fib;
+	struct rte_fib6 *fib6;
+	uint8_t *data;
+	uint32_t *free_ids;
+	uint32_t n_free_ids;
+	uint32_t n_keys_max;
+	uint32_t key_offset;
+	uint32_t key_size;
+	uint32_t entry_data_size;
+	uint8_t key_mask0[KEY_SIZE_IPV6];
+};
+
+static RTE_ATOMIC(uint32_t) table_count;
+
+/* Smallest next hop size (log2 of the number of bytes) for n_keys_max. */
+static uint32_t
+nh_sz_get(uint32_t nh_sz_min, uint32_t n_keys_max)
+{
+	uint32_t nh_sz;
+
+	/* The FIB uses one bit of the next hop. */
+	for (nh_sz = nh_sz_min; nh_sz < 3; nh_sz++)
+		if (((1ULL << ((8 << nh_sz) - 1)) - 1) >= n_keys_max)
+			break;
+
+	return nh_sz;
+}
+
+static uint32_t
+tbl8_num_get(uint32_t nh_sz, uint64_t n_tbl8)
+{
+	uint64_t nh_max = (1ULL << ((8 << nh_sz) - 1)) - 1;
+
+	return RTE_MAX(RTE_MIN(RTE_MIN(n_tbl8, nh_max), (uint64_t)TBL8_MAX), 1ULL);
+}
+
+static int
+entry_prefix_get(struct table *t,
+		 struct rte_swx_table_entry *entry,
+		 uint8_t *prefix,
+		 uint8_t *depth)
+{
+	uint32_t depth_partial = 0, i;
+	int done = 0;
+
+	if (!entry->key)
+		return -EINVAL;
+
+	for (i = 0; i < t->key_size; i++) {
+		uint8_t km = t->key_mask0[i] & (entry->key_mask ? entry->key_mask[i] : 0xFF);
+
+		prefix[i] = entry->key[i] & km;
+
+		/* The mask bits have to be contiguous, starting with the most significant one. */
+		if (done) {
+			if (km)
+				return -EINVAL;
+			continue;
+		}
+
+		if (km == 0xFF) {
+			depth_partial += 8;
+			continue;
+		}
+
+		if ((uint8_t)(km | (km - 1)) != 0xFF)
+			return -EINVAL;
+
+		depth_partial += km ? rte_clz32(~((uint32_t)km << 24)) : 0;
+		done = 1;
+	}
+
+	*depth = depth_partial;
+	return 0;
+}
+
+static int
+entry_id_get(struct table *t, uint8_t *prefix, uint8_t depth, uint64_t *nh)
+{
+	if (t->fib) {
+		struct rte_rib_node *node;
+		uint32_t ip;
+
+		memcpy(&ip, prefix, sizeof(ip));
+		node = rte_rib_lookup_exact(rte_fib_get_rib(t->fib), rte_be_to_cpu_32(ip), depth);
+		if (!node)
+			return -ENOENT;
+
+		return rte_rib_get_nh(node, nh);
+	} else {
+		struct rte_rib6_node *node;
+
+		node = rte_rib6_lookup_exact(rte_fib6_get_rib(t->fib6),
+					     (const struct rte_ipv6_addr *)prefix, depth);
+		if (!node)
+			return -ENOENT;
+
+		return rte_rib6_get_nh(node, nh);
+	}
+}
+
+static int
+fib_add(struct table *t, uint8_t *prefix, uint8_t depth, uint64_t nh)
+{
+	uint32_t ip;
+
+	if (t->fib6)
+		return rte_fib6_add(t->fib6, (const struct rte_ipv6_addr *)prefix, depth, nh);
+
+	memcpy(&ip, prefix, sizeof(ip));
+	return rte_fib_add(t->fib, rte_be_to_cpu_32(ip), depth, nh);
+}
+
+static int
+fib_delete(struct table *t, uint8_t *prefix, uint8_t depth)
+{
+	uint32_t ip;
+
+	if (t->fib6)
+		return rte_fib6_delete(t->fib6, (const struct rte_ipv6_addr *)prefix, depth);
+
+	memcpy(&ip, prefix, sizeof(ip));
+	return rte_fib_delete(t->fib, rte_be_to_cpu_32(ip), depth);
+}
+
+static void
+entry_data_set(struct table *t, uint32_t entry_id, struct rte_swx_table_entry *entry)
+{
+	uint64_t *d = (uint64_t *)&t->data[entry_id * t->entry_data_size];
+
+	d[0] = entry->action_id;
+	if (entry->action_data)
+		memcpy(&d[1], entry->action_data, t->entry_data_size - 8);
+	else
+		memset(&d[1], 0, t->entry_data_size - 8);
+}
+
+static int
+table_add(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	uint8_t prefix[KEY_SIZE_IPV6];
+	uint32_t entry_id;
+	uint8_t depth;
+	uint64_t nh;
+	int status;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+
+	status = entry_prefix_get(t, entry, prefix, &depth);
+	if (status)
+		return status;
+
+	/* Existing prefix: update the entry data. */
+	if (!entry_id_get(t, prefix, depth, &nh)) {
+		entry_data_set(t, nh - 1, entry);
+		return 0;
+	}
+
+	/* New prefix. */
+	CHECK(t->n_free_ids, ENOSPC);
+	entry_id = t->free_ids[t->n_free_ids - 1];
+	entry_data_set(t, entry_id, entry);
+
+	status = fib_add(t, prefix, depth, entry_id + 1);
+	if (status)
+		return (status == -ENOSPC) ? -ENOSPC : -EINVAL;
+
+	t->n_free_ids--;
+	return 0;
+}
+
+static int
+table_delete(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	uint8_t prefix[KEY_SIZE_IPV6];
+	uint8_t depth;
+	uint64_t nh;
+	int status;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+
+	status = entry_prefix_get(t, entry, prefix, &depth);
+	if (status)
+		return status;
+
+	/* Prefix not found: nothing to do. */
+	if (entry_id_get(t, prefix, depth, &nh))
+		return 0;
+
+	status = fib_delete(t, prefix, depth);
+	if (status)
+		return -EINVAL;
+
+	t->free_ids[t->n_free_ids++] = nh - 1;
+	return 0;
+}
+
+static void
+table_free(void *table)
+{
+	struct table *t = table;
+
+	if (!t)
+		return;
+
+	rte_fib_free(t->fib);
+	rte_fib6_free(t->fib6);
+	rte_free(t);
+}
+
+static void *
+table_create(struct rte_swx_table_params *params,
+	     struct rte_swx_table_entry_list *entries,
+	     const char *args __rte_unused,
+	     int numa_node)
+{
+	struct rte_swx_table_entry *entry;
+	struct table *t = NULL;
+	char name[NAME_SIZE];
+	size_t data_sz, ids_sz;
+	uint32_t entry_data_size, n_keys_max, i;
+
+	/* Check input arguments. */
+	if (!params ||
+	    ((params->key_size != KEY_SIZE_IPV4) && (params->key_size != KEY_SIZE_IPV6)))
+		return NULL;
+
+	/* Memory allocation and initialization. */
+	n_keys_max = RTE_MAX(params->n_keys_max, 1U);
+	entry_data_size = 8 + params->action_data_size;
+	data_sz = (size_t)n_keys_max * entry_data_size;
+	ids_sz = (size_t)n_keys_max * sizeof(uint32_t);
+
+	t = rte_zmalloc_socket(NULL, sizeof(struct table) + data_sz + ids_sz,
+			       RTE_CACHE_LINE_SIZE, numa_node);
+	if (!t)
+		return NULL;
+
+	t->data = (uint8_t *)&t[1];
+	t->free_ids = (uint32_t *)&t->data[data_sz];
+	t->n_keys_max = n_keys_max;
+	t->key_offset = params->key_offset;
+	t->key_size = params->key_size;
+	t->entry_data_size = entry_data_size;
+
+	for (i = 0; i < t->key_size; i++)
+		t->key_mask0[i] = params->key_mask0 ? params->key_mask0[i] : 0xFF;
+
+	/* Pop the lowest entry IDs first. */
+	for (i = 0; i < n_keys_max; i++)
+		t->free_ids[i] = n_keys_max - 1 - i;
+	t->n_free_ids = n_keys_max;
+
+	/* FIB. */
+	snprintf(name, sizeof(name), "swx_lpm_%u",
+		 rte_atomic_fetch_add_explicit(&table_count, 1, rte_memory_order_relaxed));
+
+	if (t->key_size == KEY_SIZE_IPV4) {
+		struct rte_fib_conf conf = {
+			.type = RTE_FIB_DIR24_8,
+			.default_nh = NH_MISS,
+			.max_routes = n_keys_max,
+			.flags = RTE_FIB_F_LOOKUP_NETWORK_ORDER,
+		};
+
+		conf.dir24_8.nh_sz = nh_sz_get(RTE_FIB_DIR24_8_1B, n_keys_max);
+		conf.dir24_8.num_tbl8 = tbl8_num_get(conf.dir24_8.nh_sz, n_keys_max);
+
+		t->fib = rte_fib_create(name, numa_node, &conf);
+		if (!t->fib)
+			goto error;
+	} else {
+		struct rte_fib6_conf conf = {
+			.type = RTE_FIB6_TRIE,
+			.default_nh = NH_MISS,
+			.max_routes = n_keys_max,
+		};
+
+		conf.trie.nh_sz = nh_sz_get(RTE_FIB6_TRIE_2B, n_keys_max);
+		conf.trie.num_tbl8 = tbl8_num_get(conf.trie.nh_sz,
+						  (uint64_t)n_keys_max * TBL8_PER_ROUTE_IPV6);
+
+		t->fib6 = rte_fib6_create(name, numa_node, &conf);
+		if (!t->fib6)
+			goto error;
+	}
+
+	/* Initial entries. */
+	if (entries)
+		TAILQ_FOREACH(entry, entries, node)
+			if (table_add(t, entry))
+				goto error;
+
+	return t;
+
+error:
+	table_free(t);
+	return NULL;
+}
+
+static uint64_t
+table_mailbox_size_get(void)
+{
+	return 0;
+}
+
+static int
+table_lookup(void *table,
+	     void *mailbox __rte_unused,
+	     uint8_t **key,
+	     uint64_t *action_id,
+	     uint8_t **action_data,
+	     size_t *entry_id,
+	     int *hit)
+{
+	struct table *t = table;
+	uint8_t *k = &(*key)[t->key_offset];
+	uint64_t nh;
+	uint8_t *data;
+
+	if (t->fib) {
+		uint32_t ip;
+
+		memcpy(&ip, k, sizeof(ip));
+		rte_fib_lookup_bulk(t->fib, &ip, &nh, 1);
+	} else {
+		rte_fib6_lookup_bulk(t->fib6, (const struct rte_ipv6_addr *)k, &nh, 1);
+	}
+
+	if (nh == NH_MISS) {
+		*hit = 0;
+		return 1;
+	}
+
+	data = &t->data[(nh - 1) * t->entry_data_size];
+	*action_id = ((uint64_t *)data)[0];
+	*action_data = &data[8];
+	*entry_id = nh - 1;
+	*hit = 1;
+	return 1;
+}
+
+struct rte_swx_table_ops rte_swx_table_lpm_ops = {
+	.footprint_get = NULL,
+	.mailbox_size_get = table_mailbox_size_get,
+	.create = table_create,
+	.add = table_add,
+	.del = table_delete,
+	.lkp = table_lookup,
+	.free = table_free,
+};
@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+#ifndef __INCLUDE_RTE_SWX_TABLE_LPM_H__
+#define __INCLUDE_RTE_SWX_TABLE_LPM_H__
+
+/**
+ * @file
+ * RTE SWX Longest Prefix Match Table
+ *
+ * The key is a single field of either 4 bytes (IPv4 address in network byte
+ * order) or 16 bytes (IPv6 address). The key mask of each table entry has to
+ * be a prefix mask. The table is backed by the FIB library and supports
+ * incremental entry add and delete.
+ */
+
+
+#include <rte_swx_table.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest prefix match table operations. */
+extern struct rte_swx_table_ops rte_swx_table_lpm_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_SWX_TABLE_LPM_H__ */
@@ -30,6 +30,9 @@ extern "C" {
  * The telemetry library provides a method to retrieve statistics from
  * DPDK by sending a request message over a socket. DPDK will send
  * a JSON encoded response containing telemetry data.
+ *
+ * Counters may also be exported in a shared memory file, to be read
+ * by another process without calling into DPDK.
  */
 
 /** opaque structure used internally for managing data from callbacks */
@@ -414,6 +417,88 @@ __rte_experimental
 int
 rte_telemetry_register_cmd_arg(const char *cmd, telemetry_arg_cb fn, void *arg, const char *help);
 
+/** Maximum length of a shared memory block or metric name, including NUL. */
+#define RTE_TEL_SHM_NAME_LEN 64
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Register a block of counters in the telemetry shared memory.
+ *
+ * The counters of the shared memory can be read by another process,
+ * such as usertools/dpdk-telemetry-shm.py, without any request
+ * to the application. Their values are set with rte_telemetry_shm_update().
+ *
+ * @param name
+ *   Name of the block, for example the name of the device owning the counters.
+ *   Blocks may share counter names, and are told apart by their name.
+ * @param names
+ *   Array of the counter names.
+ * @param num
+ *   Number of counters in the block.
+ *
+ * @return
+ *   Non-negative block identifier on success.
+ * @return
+ *   -EINVAL for invalid parameters failure.
+ * @return
+ *   -ENOSPC if the shared memory is full.
+ * @return
+ *   -ENOMEM for mem allocation failure.
+ */
+__rte_experimental
+int
+rte_telemetry_shm_register(const char *name, const char * const names[],
+		unsigned int num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Update the counters of a shared memory block.
+ *
+ * The values are written under a sequence counter, so that a reader
+ * always sees a consistent snapshot of the block.
+ * A block must be updated by a single thread at a time.
+ *
+ * @param block
+ *   Block identifier returned by rte_telemetry_shm_register().
+ * @param values
+ *   New values of the first num counters of the block.
+ * @param num
+ *   Number of values, at most the number of counters of the block.
+ *
+ * @return
+ *   0 on success.
+ * @return
+ *   -EINVAL for invalid parameters failure.
+ */
+__rte_experimental
+int
+rte_telemetry_shm_update(int block, const uint64_t values[], unsigned int num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Remove a block of counters from the telemetry shared memory.
+ *
+ * Readers stop seeing the block, and its counters may be reused
+ * by a block registered later. The block must not be updated anymore.
+ *
+ * @param block
+ *   Block identifier returned by rte_telemetry_shm_register().
+ *
+ * @return
+ *   0 on success.
+ * @return
+ *   -EINVAL for invalid parameters failure.
+ */
+__rte_experimental
+int
+rte_telemetry_shm_unregister(int block);
+
 /**
  * Get a pointer to a container with memory allocated. The container is to be
  * used embedded within an existing telemetry dict/array.
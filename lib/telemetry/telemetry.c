@@ -24,6 +24,7 @@
 #include "telemetry_json.h"
 #include "telemetry_data.h"
 #include "telemetry_internal.h"
+#include "telemetry_shm.h"
 
 #define MAX_CMD_LEN 56
 #define MAX_OUTPUT_LEN (1024 * 16)
@@ -647,6 +648,10 @@ telemetry_v2_init(void)
 	pthread_detach(t_new);
 	atexit(unlink_sockets);
 
+	/* shared memory counters are optional, readers use the socket suffix */
+	if (telemetry_shm_init(socket_dir, suffix) != 0)
+		TMTY_LOG_LINE(WARNING, "Telemetry shared memory not available");
+
 	return 0;
 }
 
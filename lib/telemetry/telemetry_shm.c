@@ -0,0 +1,312 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+/* we won't link against libbsd, so just always use DPDKs-specific strlcpy */
+#undef RTE_USE_LIBBSD
+#include <rte_string_fns.h>
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_seqcount.h>
+#include <rte_spinlock.h>
+#include <rte_stdatomic.h>
+
+#include "rte_telemetry.h"
+#include "telemetry_shm.h"
+
+/* Values of a block start on their own cache line, not shared with others */
+#define TEL_SHM_VALUES_ALIGN (RTE_CACHE_LINE_SIZE / sizeof(uint64_t))
+
+#define TEL_SHM_BLOCKS_OFFSET RTE_ALIGN_CEIL(sizeof(struct tel_shm_header), \
+		RTE_CACHE_LINE_SIZE)
+#define TEL_SHM_NAMES_OFFSET (TEL_SHM_BLOCKS_OFFSET + \
+		TEL_SHM_MAX_BLOCKS * sizeof(struct tel_shm_block))
+#define TEL_SHM_VALUES_OFFSET RTE_ALIGN_CEIL(TEL_SHM_NAMES_OFFSET + \
+		TEL_SHM_MAX_METRICS * RTE_TEL_SHM_NAME_LEN, RTE_CACHE_LINE_SIZE)
+#define TEL_SHM_SIZE (TEL_SHM_VALUES_OFFSET + \
+		TEL_SHM_MAX_METRICS * sizeof(uint64_t))
+
+RTE_LOG_REGISTER_SUFFIX(tel_shm_logtype, shm, WARNING);
+#define RTE_LOGTYPE_TELEMETRY_SHM tel_shm_logtype
+#define SHM_LOG_LINE(l, ...) RTE_LOG_LINE(l, TELEMETRY_SHM, "" __VA_ARGS__)
+
+/*
+ * Blocks registered before the telemetry initialization are kept in private
+ * memory, and copied to the shared memory file when it is created.
+ */
+static RTE_ATOMIC(void *) shm_base;
+static uint32_t shm_next_metric; /* first free counter index */
+/* Used when registering blocks or switching to the shared memory file */
+static rte_spinlock_t shm_sl = RTE_SPINLOCK_INITIALIZER;
+#ifndef RTE_EXEC_ENV_WINDOWS
+static char shm_path[PATH_MAX];
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+static inline struct tel_shm_header *
+shm_header(void *base)
+{
+	return base;
+}
+
+static inline struct tel_shm_block *
+shm_block(void *base, int id)
+{
+	return RTE_PTR_ADD(base, TEL_SHM_BLOCKS_OFFSET +
+			id * sizeof(struct tel_shm_block));
+}
+
+static inline char *
+shm_name(void *base, uint32_t idx)
+{
+	return RTE_PTR_ADD(base, TEL_SHM_NAMES_OFFSET +
+			idx * RTE_TEL_SHM_NAME_LEN);
+}
+
+static inline uint64_t *
+shm_values(void *base, uint32_t idx)
+{
+	return RTE_PTR_ADD(base, TEL_SHM_VALUES_OFFSET +
+			idx * sizeof(uint64_t));
+}
+
+static void
+shm_header_init(void *base)
+{
+	struct tel_shm_header *hdr = shm_header(base);
+
+	memcpy(hdr->magic, TEL_SHM_MAGIC, sizeof(hdr->magic));
+	hdr->version = TEL_SHM_VERSION;
+	hdr->max_blocks = TEL_SHM_MAX_BLOCKS;
+	hdr->max_metrics = TEL_SHM_MAX_METRICS;
+	hdr->blocks_offset = TEL_SHM_BLOCKS_OFFSET;
+	hdr->names_offset = TEL_SHM_NAMES_OFFSET;
+	hdr->values_offset = TEL_SHM_VALUES_OFFSET;
+}
+
+/* Set the descriptor, counter names and zero values of a block */
+static void
+shm_block_set(void *base, struct tel_shm_block *b, const char *name,
+		const char * const names[], unsigned int num)
+{
+	unsigned int i;
+
+	strlcpy(b->name, name, sizeof(b->name));
+	b->num = num;
+	for (i = 0; i < num; i++) {
+		strlcpy(shm_name(base, b->first + i), names[i],
+				RTE_TEL_SHM_NAME_LEN);
+		*shm_values(base, b->first + i) = 0;
+	}
+}
+
+static bool
+valid_name(const char *name)
+{
+	return name != NULL && name[0] != '\0' &&
+			strnlen(name, RTE_TEL_SHM_NAME_LEN) < RTE_TEL_SHM_NAME_LEN;
+}
+
+int
+rte_telemetry_shm_register(const char *name, const char * const names[],
+		unsigned int num)
+{
+	struct tel_shm_header *hdr;
+	struct tel_shm_block *b;
+	uint32_t first, id, nb_blocks;
+	unsigned int i;
+	void *base;
+
+	if (!valid_name(name) || names == NULL || num == 0 ||
+			num > TEL_SHM_MAX_METRICS)
+		return -EINVAL;
+	for (i = 0; i < num; i++)
+		if (!valid_name(names[i]))
+			return -EINVAL;
+
+	rte_spinlock_lock(&shm_sl);
+	base = rte_atomic_load_explicit(&shm_base, rte_memory_order_relaxed);
+	if (base == NULL) {
+		base = calloc(1, TEL_SHM_SIZE);
+		if (base == NULL) {
+			rte_spinlock_unlock(&shm_sl);
+			return -ENOMEM;
+		}
+		shm_header_init(base);
+		rte_atomic_store_explicit(&shm_base, base, rte_memory_order_release);
+	}
+
+	hdr = shm_header(base);
+	nb_blocks = rte_atomic_load_explicit(&hdr->num_blocks,
+			rte_memory_order_relaxed);
+
+	/* reuse a removed block large enough, readers may still see it */
+	for (id = 0; id < nb_blocks; id++) {
+		b = shm_block(base, id);
+		if (b->name[0] == '\0' && b->size >= num) {
+			rte_seqcount_write_begin(&b->seqcount);
+			shm_block_set(base, b, name, names, num);
+			rte_seqcount_write_end(&b->seqcount);
+			rte_spinlock_unlock(&shm_sl);
+			return id;
+		}
+	}
+
+	first = RTE_ALIGN_CEIL(shm_next_metric, TEL_SHM_VALUES_ALIGN);
+	if (id >= TEL_SHM_MAX_BLOCKS || first + num > TEL_SHM_MAX_METRICS) {
+		rte_spinlock_unlock(&shm_sl);
+		return -ENOSPC;
+	}
+
+	b = shm_block(base, id);
+	rte_seqcount_init(&b->seqcount);
+	b->first = first;
+	b->size = num;
+	shm_block_set(base, b, name, names, num);
+	shm_next_metric = first + num;
+
+	/* publish the block to the readers */
+	rte_atomic_store_explicit(&hdr->num_blocks, id + 1,
+			rte_memory_order_release);
+	rte_spinlock_unlock(&shm_sl);
+
+	return id;
+}
+
+int
+rte_telemetry_shm_unregister(int block)
+{
+	struct tel_shm_block *b;
+	void *base;
+
+	rte_spinlock_lock(&shm_sl);
+	base = rte_atomic_load_explicit(&shm_base, rte_memory_order_relaxed);
+	if (base == NULL || block < 0 ||
+			(uint32_t)block >= rte_atomic_load_explicit(
+				&shm_header(base)->num_blocks,
+				rte_memory_order_relaxed) ||
+			shm_block(base, block)->name[0] == '\0') {
+		rte_spinlock_unlock(&shm_sl);
+		return -EINVAL;
+	}
+
+	b = shm_block(base, block);
+	rte_seqcount_write_begin(&b->seqcount);
+	b->name[0] = '\0';
+	b->num = 0;
+	rte_seqcount_write_end(&b->seqcount);
+	rte_spinlock_unlock(&shm_sl);
+
+	return 0;
+}
+
+int
+rte_telemetry_shm_update(int block, const uint64_t values[], unsigned int num)
+{
+	struct tel_shm_block *b;
+	uint64_t *dst;
+	void *base;
+
+	base = rte_atomic_load_explicit(&shm_base, rte_memory_order_acquire);
+	if (base == NULL || block < 0 || values == NULL ||
+			(uint32_t)block >= rte_atomic_load_explicit(
+				&shm_header(base)->num_blocks,
+				rte_memory_order_acquire))
+		return -EINVAL;
+
+	b = shm_block(base, block);
+	if (num > b->num || b->name[0] == '\0')
+		return -EINVAL;
+
+	dst = shm_values(base, b->first);
+	rte_seqcount_write_begin(&b->seqcount);
+	memcpy(dst, values, num * sizeof(*dst));
+	rte_seqcount_write_end(&b->seqcount);
+
+	return 0;
+}
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+
+static void
+unlink_shm(void)
+{
+	if (shm_path[0])
+		unlink(shm_path);
+}
+
+int
+telemetry_shm_init(const char *runtime_dir, int instance)
+{
+	struct timespec ts;
+	void *base, *old;
+	int fd, len;
+
+	if (instance > 0)
+		len = snprintf(shm_path, sizeof(shm_path), "%s/dpdk_telemetry_shm:%d",
+				runtime_dir, instance);
+	else
+		len = snprintf(shm_path, sizeof(shm_path), "%s/dpdk_telemetry_shm",
+				runtime_dir);
+	if (len < 0 || (size_t)len >= sizeof(shm_path)) {
+		SHM_LOG_LINE(ERR, "Error with shared memory file, path too long");
+		shm_path[0] = '\0';
+		return -1;
+	}
+
+	/* readers still mapping the file of a previous run keep their pages */
+	unlink(shm_path);
+	fd = open(shm_path, O_RDWR | O_CREAT | O_EXCL, 0640);
+	if (fd < 0) {
+		SHM_LOG_LINE(ERR, "Error creating %s: %s", shm_path, strerror(errno));
+		shm_path[0] = '\0';
+		return -1;
+	}
+	if (ftruncate(fd, TEL_SHM_SIZE) < 0) {
+		SHM_LOG_LINE(ERR, "Error sizing %s: %s", shm_path, strerror(errno));
+		goto error;
+	}
+	base = mmap(NULL, TEL_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED) {
+		SHM_LOG_LINE(ERR, "Error mapping %s: %s", shm_path, strerror(errno));
+		goto error;
+	}
+	close(fd);
+
+	/*
+	 * Telemetry is initialized before the application threads are started,
+	 * so no update can be running on the private memory while freeing it.
+	 */
+	rte_spinlock_lock(&shm_sl);
+	old = rte_atomic_load_explicit(&shm_base, rte_memory_order_relaxed);
+	if (old != NULL)
+		memcpy(base, old, TEL_SHM_SIZE);
+	else
+		shm_header_init(base);
+	shm_header(base)->pid = getpid();
+	clock_gettime(CLOCK_REALTIME, &ts);
+	shm_header(base)->generation = ts.tv_sec ^ ts.tv_nsec;
+	rte_atomic_store_explicit(&shm_base, base, rte_memory_order_release);
+	rte_spinlock_unlock(&shm_sl);
+	free(old);
+
+	atexit(unlink_shm);
+	SHM_LOG_LINE(DEBUG, "Telemetry shared memory %s initialized ok", shm_path);
+	return 0;
+
+error:
+	close(fd);
+	unlink(shm_path);
+	shm_path[0] = '\0';
+	return -1;
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
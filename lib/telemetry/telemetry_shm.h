@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+#ifndef _TELEMETRY_SHM_H_
+#define _TELEMETRY_SHM_H_
+
+#include <stdint.h>
+
+#include <rte_seqcount.h>
+
+#include "rte_telemetry.h"
+
+/*
+ * Layout of the telemetry shared memory file.
+ * Readers rely on it, so any change must bump TEL_SHM_VERSION.
+ *
+ * The file starts with a header, followed by the block descriptors,
+ * the counter names and the counter values, at the offsets given
+ * in the header. A block is visible to readers once num_blocks covers it.
+ * The descriptor, counter names and values of a block are protected
+ * by its sequence counter. A removed block has an empty name, and its
+ * descriptor may be reused, with its counters, by a later block.
+ * A new file, with another generation, is created when the application
+ * restarts: readers must map it again.
+ */
+#define TEL_SHM_MAGIC "DPDKTSHM"
+#define TEL_SHM_VERSION 1
+#define TEL_SHM_MAX_BLOCKS 1024
+#define TEL_SHM_MAX_METRICS 8192
+
+struct tel_shm_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t max_blocks;
+	uint32_t max_metrics;
+	RTE_ATOMIC(uint32_t) num_blocks;
+	uint32_t pid;
+	uint32_t generation; /* changes each time the file is created */
+	uint64_t blocks_offset;
+	uint64_t names_offset;
+	uint64_t values_offset;
+};
+
+struct tel_shm_block {
+	char name[RTE_TEL_SHM_NAME_LEN];
+	rte_seqcount_t seqcount;
+	uint32_t first; /* index of the first counter */
+	uint32_t num;   /* number of counters */
+	uint32_t size;  /* number of counters reserved for the block */
+};
+
+/* Create the shared memory file of the telemetry instance */
+int
+telemetry_shm_init(const char *runtime_dir, int instance);
+
+#endif
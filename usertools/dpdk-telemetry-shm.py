@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+
+r'''
+Export the DPDK telemetry shared memory counters in the prometheus text format.
+
+The counters registered with rte_telemetry_shm_register() are read directly
+from the shared memory file of the DPDK process, without sending any request
+to it. Each counter is exported as dpdk_<counter name>, with the name of its
+block as the "block" label.
+
+By default, the counters are printed once on the standard output. With the
+--listen option, a local HTTP server answers GET requests with the current
+values of the counters.
+
+When the DPDK process restarts, it creates a new file, with another
+generation: the file is then mapped again. Removed blocks, which have an
+empty name, are skipped.
+'''
+
+import argparse
+import mmap
+import os
+import re
+import struct
+import sys
+import threading
+import time
+from http import HTTPStatus, server
+
+SHM_NAME = "dpdk_telemetry_shm"
+DEFAULT_PREFIX = "rte"
+MAGIC = b"DPDKTSHM"
+VERSION = 1
+# struct tel_shm_header
+HEADER = struct.Struct("<8sIIIIIIQQQ")
+# struct tel_shm_block
+BLOCK = struct.Struct("<64sIIII")
+NAME_LEN = 64
+SEQ = struct.Struct("<I")
+RETRIES = 1000
+
+
+def get_dpdk_runtime_dir(fp):
+    """Using the same logic as in DPDK's EAL, get the DPDK runtime directory
+    based on the file-prefix and user"""
+    run_dir = os.environ.get("RUNTIME_DIRECTORY")
+    if not run_dir:
+        if os.getuid() == 0:
+            run_dir = "/var/run"
+        else:
+            run_dir = os.environ.get("XDG_RUNTIME_DIR", "/tmp")
+    return os.path.join(run_dir, "dpdk", fp)
+
+
+def cstr(raw):
+    return raw.split(b"\0", 1)[0].decode(errors="replace")
+
+
+class TelemetryShm:
+    """Read-only mapping of the telemetry shared memory file."""
+
+    def __init__(self, path):
+        self.path = path
+        self.mem = None
+        self.lock = threading.Lock()
+        self.open()
+
+    def open(self):
+        with open(self.path, "rb") as f:
+            ino = os.fstat(f.fileno()).st_ino
+            mem = mmap.mmap(f.fileno(), 0, prot=mmap.PROT_READ)
+        (magic, version, max_blocks, max_metrics, _, pid, generation,
+         blocks_offset, names_offset,
+         values_offset) = HEADER.unpack_from(mem, 0)
+        if magic != MAGIC or version != VERSION:
+            mem.close()
+            raise ValueError(f"{self.path}: not a telemetry shared memory "
+                             f"file of version {VERSION}")
+        if self.mem is not None:
+            self.mem.close()
+        self.mem = mem
+        self.ino = ino
+        self.generation = generation
+        self.max_blocks = max_blocks
+        self.max_metrics = max_metrics
+        self.pid = pid
+        self.blocks_offset = blocks_offset
+        self.names_offset = names_offset
+        self.values_offset = values_offset
+        self.names = {}
+
+    def changed(self):
+        """Check whether the DPDK process created a new file."""
+        try:
+            ino = os.stat(self.path).st_ino
+        except OSError:
+            return False
+        return ino != self.ino or \
+            struct.unpack_from("<I", self.mem, 28)[0] != self.generation
+
+    def refresh(self):
+        """Map the file again if its generation changed."""
+        if not self.changed():
+            return
+        try:
+            self.open()
+        except (OSError, ValueError) as e:
+            print(f"Error: {e}", file=sys.stderr)
+
+    def num_blocks(self):
+        # num_blocks is the fourth 32-bit field after the magic
+        return min(struct.unpack_from("<I", self.mem, 20)[0], self.max_blocks)
+
+    def counter_names(self, name, first, num):
+        # a removed block may be reused with other counter names
+        key = (name, first, num)
+        names = self.names.get(key)
+        if names is None:
+            names = [
+                cstr(self.mem[self.names_offset + i * NAME_LEN:
+                              self.names_offset + (i + 1) * NAME_LEN])
+                for i in range(first, first + num)
+            ]
+        return key, names
+
+    def block(self, idx):
+        """Read a consistent snapshot of the name, counters and values
+        of a block."""
+        off = self.blocks_offset + idx * BLOCK.size
+        seq_off = off + NAME_LEN
+        for _ in range(RETRIES):
+            begin = SEQ.unpack_from(self.mem, seq_off)[0]
+            if begin & 1:
+                continue
+            name, _, first, num, _ = BLOCK.unpack_from(self.mem, off)
+            if first + num > self.max_metrics:
+                continue
+            name = cstr(name)
+            key, names = self.counter_names(name, first, num)
+            values = struct.unpack_from(f"<{num}Q", self.mem,
+                                        self.values_offset + first * 8)
+            if SEQ.unpack_from(self.mem, seq_off)[0] == begin:
+                self.names[key] = names
+                return name, names, values
+        return None
+
+    def snapshot(self):
+        with self.lock:
+            self.refresh()
+            blocks = []
+            for i in range(self.num_blocks()):
+                block = self.block(i)
+                # removed block
+                if block is None or not block[0]:
+                    continue
+                name, names, values = block
+                blocks.append((name, zip(names, values)))
+        return blocks
+
+
+def metric_name(name):
+    return "dpdk_" + re.sub(r"[^a-zA-Z0-9_:]", "_", name)
+
+
+def escape(value):
+    return value.replace("\\", "\\\\").replace('"', '\\"').replace("\n", "\\n")
+
+
+def prometheus(shm):
+    # the samples of a metric must be grouped, whatever their block
+    metrics = {}
+    for block, counters in shm.snapshot():
+        for name, value in counters:
+            metrics.setdefault(metric_name(name), []).append(
+                f'{{block="{escape(block)}"}} {value}')
+    lines = []
+    for metric, samples in metrics.items():
+        lines.append(f"# TYPE {metric} untyped")
+        lines += [metric + sample for sample in samples]
+    return "\n".join(lines) + "\n"
+
+
+class PrometheusHandler(server.BaseHTTPRequestHandler):
+    shm = None
+
+    def do_GET(self):
+        body = prometheus(self.shm).encode()
+        self.send_response(HTTPStatus.OK)
+        self.send_header("Content-Type", "text/plain; version=0.0.4")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, fmt, *args):
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+    )
+    parser.add_argument(
+        "-f", "--file-prefix", default=DEFAULT_PREFIX,
+        help="Provide file-prefix for DPDK runtime directory",
+    )
+    parser.add_argument(
+        "-i", "--instance", default=0, type=int,
+        help="Provide instance number for DPDK application",
+    )
+    parser.add_argument(
+        "-l", "--listen", metavar="ADDRESS:PORT",
+        help="Serve the counters over HTTP on ADDRESS:PORT",
+    )
+    parser.add_argument(
+        "-t", "--interval", default=0, type=float,
+        help="Print the counters every INTERVAL seconds",
+    )
+    args = parser.parse_args()
+
+    path = os.path.join(get_dpdk_runtime_dir(args.file_prefix), SHM_NAME)
+    if args.instance > 0:
+        path += f":{args.instance}"
+    try:
+        shm = TelemetryShm(path)
+    except (OSError, ValueError) as e:
+        sys.exit(f"Error: {e}")
+
+    if args.listen:
+        addr, _, port = args.listen.rpartition(":")
+        PrometheusHandler.shm = shm
+        httpd = server.ThreadingHTTPServer((addr, int(port)), PrometheusHandler)
+        try:
+            httpd.serve_forever()
+        except KeyboardInterrupt:
+            pass
+        return
+
+    while True:
+        sys.stdout.write(prometheus(shm))
+        sys.stdout.flush()
+        if args.interval <= 0:
+            break
+        time.sleep(args.interval)
+
+
+if __name__ == "__main__":
+    main()